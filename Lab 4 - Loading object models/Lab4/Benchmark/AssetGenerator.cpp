@@ -0,0 +1,294 @@
+//
+//  AssetGenerator.cpp
+//
+
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <fstream>
+
+#include "../Lab4/ObjLibrary/TextureBmp.h"
+#include "AssetGenerator.h"
+
+using namespace std;
+using namespace ObjLibrary;
+using namespace AssetGenerator;
+namespace
+{
+	const char* COMMENT_TEXT = "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod";
+
+	//
+	//  Random
+	//
+	//  A tiny deterministic pseudorandom number generator
+	//    (xorshift32).  The standard rand() function is not
+	//    used so that the same seed generates the same files
+	//    on every platform.
+	//
+	class Random
+	{
+	public:
+		Random (unsigned int seed)
+		{
+			m_state = (seed == 0) ? 0x9E3779B9u : seed;
+		}
+
+		unsigned int next ()
+		{
+			m_state ^= m_state << 13;
+			m_state ^= m_state >> 17;
+			m_state ^= m_state << 5;
+			return m_state;
+		}
+
+		unsigned int next (unsigned int max)
+		{
+			assert(max > 0);
+			return next() % max;
+		}
+
+		double nextDouble ()
+		{
+			return (next() & 0xFFFFFF) / (double)(0x1000000);
+		}
+
+		double nextDouble (double min, double max)
+		{
+			return min + (max - min) * nextDouble();
+		}
+
+	private:
+		unsigned int m_state;
+	};
+
+	void writeIndex (ofstream& r_output,
+	                 unsigned int index,
+	                 unsigned int count,
+	                 bool is_negative)
+	{
+		assert(index < count);
+
+		if(is_negative)
+			r_output << ((long long)(index) - (long long)(count));
+		else
+			r_output << (index + 1);
+	}
+}
+
+
+
+AssetGenerator :: ObjSettings :: ObjSettings ()
+		: m_vertex_count(1000),
+		  m_face_count(2000),
+		  m_ngon_fraction(0.25),
+		  m_ngon_max_vertexes(6),
+		  m_is_negative_indexes(false),
+		  m_is_texture_coordinates(true),
+		  m_is_normals(true),
+		  m_material_count(1),
+		  m_material_switch_count(0),
+		  m_comment_block_count(0),
+		  m_comment_block_lines(0),
+		  m_seed(1)
+{
+}
+
+
+
+size_t AssetGenerator :: generateObj (const string& filename,
+                                      const string& mtl_filename,
+                                      const ObjSettings& settings)
+{
+	assert(filename != "");
+	assert(settings.m_vertex_count >= 3);
+	assert(settings.m_ngon_max_vertexes >= 3);
+	assert(settings.m_material_count >= 1);
+
+	ofstream output(filename.c_str());
+	if(!output.is_open())
+		return 0;
+
+	Random random(settings.m_seed);
+	unsigned int vertex_count = settings.m_vertex_count;
+
+	output << "# Generated by AssetGenerator::generateObj" << '\n';
+	if(mtl_filename != "")
+		output << "mtllib " << mtl_filename << '\n';
+	output << '\n';
+
+	output.precision(6);
+	output << fixed;
+	for(unsigned int v = 0; v < vertex_count; v++)
+	{
+		output << "v " << random.nextDouble(-1.0, 1.0)
+		       << " "  << random.nextDouble(-1.0, 1.0)
+		       << " "  << random.nextDouble(-1.0, 1.0) << '\n';
+	}
+	if(settings.m_is_texture_coordinates)
+		for(unsigned int t = 0; t < vertex_count; t++)
+			output << "vt " << random.nextDouble() << " " << random.nextDouble() << '\n';
+	if(settings.m_is_normals)
+		for(unsigned int n = 0; n < vertex_count; n++)
+		{
+			// never generate a zero normal
+			output << "vn " << random.nextDouble(0.1, 1.0)
+			       << " "   << random.nextDouble(-1.0, 1.0)
+			       << " "   << random.nextDouble(-1.0, 1.0) << '\n';
+		}
+	output << '\n';
+
+	unsigned int face_count     = settings.m_face_count;
+	unsigned int switch_count   = (mtl_filename == "") ? 0 : settings.m_material_switch_count + 1;
+	unsigned int comment_count  = settings.m_comment_block_count;
+	unsigned int next_switch    = 0;
+	unsigned int next_comment   = 0;
+	unsigned int ngon_threshold = (unsigned int)(settings.m_ngon_fraction * 1000.0);
+
+	for(unsigned int f = 0; f <= face_count; f++)
+	{
+		// material switches and comments are spread evenly
+		while(next_switch < switch_count &&
+		      (unsigned long long)(next_switch) * face_count / switch_count <= f)
+		{
+			output << "usemtl material_" << (next_switch % settings.m_material_count) << '\n';
+			next_switch++;
+		}
+		while(next_comment < comment_count &&
+		      (unsigned long long)(next_comment) * face_count / comment_count <= f)
+		{
+			for(unsigned int c = 0; c < settings.m_comment_block_lines; c++)
+				output << "# " << COMMENT_TEXT << '\n';
+			next_comment++;
+		}
+
+		if(f == face_count)
+			break;
+
+		unsigned int corners = 3;
+		if(settings.m_ngon_max_vertexes > 3 && random.next(1000) < ngon_threshold)
+			corners = 4 + random.next(settings.m_ngon_max_vertexes - 3);
+		bool is_negative = settings.m_is_negative_indexes && (f % 2 == 1);
+
+		output << "f";
+		for(unsigned int c = 0; c < corners; c++)
+		{
+			unsigned int index = random.next(vertex_count);
+
+			output << " ";
+			writeIndex(output, index, vertex_count, is_negative);
+			if(settings.m_is_texture_coordinates)
+			{
+				output << "/";
+				writeIndex(output, index, vertex_count, is_negative);
+			}
+			if(settings.m_is_normals)
+			{
+				output << (settings.m_is_texture_coordinates ? "/" : "//");
+				writeIndex(output, index, vertex_count, is_negative);
+			}
+		}
+		output << '\n';
+	}
+
+	output.close();
+	return getFileSize(filename);
+}
+
+size_t AssetGenerator :: generateMtl (const string& filename,
+                                      unsigned int material_count,
+                                      const string& texture_filename,
+                                      unsigned int seed)
+{
+	assert(filename != "");
+
+	ofstream output(filename.c_str());
+	if(!output.is_open())
+		return 0;
+
+	Random random(seed);
+
+	output << "# Generated by AssetGenerator::generateMtl" << '\n';
+	output.precision(4);
+	output << fixed;
+	for(unsigned int m = 0; m < material_count; m++)
+	{
+		output << '\n';
+		output << "newmtl material_" << m << '\n';
+		output << "Ka " << random.nextDouble() << " " << random.nextDouble() << " " << random.nextDouble() << '\n';
+		output << "Kd " << random.nextDouble() << " " << random.nextDouble() << " " << random.nextDouble() << '\n';
+		output << "Ks " << random.nextDouble() << " " << random.nextDouble() << " " << random.nextDouble() << '\n';
+		output << "Ns " << random.nextDouble(1.0, 100.0) << '\n';
+		output << "d 1.0" << '\n';
+		output << "illum 2" << '\n';
+		if(texture_filename != "")
+			output << "map_Kd " << texture_filename << '\n';
+	}
+
+	output.close();
+	return getFileSize(filename);
+}
+
+size_t AssetGenerator :: generateBmp (const string& filename,
+                                      unsigned int width,
+                                      unsigned int height,
+                                      unsigned int seed)
+{
+	assert(filename != "");
+	assert(width > 0);
+	assert(height > 0);
+
+	static const unsigned int CHECKER_SIZE = 8;
+
+	Random random(seed);
+	unsigned int colour0 = random.next() & 0xFFFFFF;
+	unsigned int colour1 = random.next() & 0xFFFFFF;
+
+	TextureBmp image(width, height, false);
+	for(unsigned int y = 0; y < height; y++)
+		for(unsigned int x = 0; x < width; x++)
+		{
+			if(((x / CHECKER_SIZE) + (y / CHECKER_SIZE)) % 2 == 0)
+				image.setPixel(x, y, colour0);
+			else
+				image.setPixel(x, y, colour1);
+		}
+	image.save(filename);
+
+	return getFileSize(filename);
+}
+
+size_t AssetGenerator :: generateFontBmp (const string& filename,
+                                          unsigned int width)
+{
+	assert(filename != "");
+	assert(width >= 16);
+	assert((width & (width - 1)) == 0);
+
+	static const unsigned int CHARACTERS_PER_ROW = 16;
+
+	unsigned int cell = width / CHARACTERS_PER_ROW;
+
+	TextureBmp image(width, width, false);
+	for(unsigned int y = 0; y < width; y++)
+		for(unsigned int x = 0; x < width; x++)
+		{
+			unsigned int character = (y / cell) * CHARACTERS_PER_ROW + (x / cell);
+			unsigned int glyph_width = 1 + character % cell;
+
+			if(x % cell < glyph_width && (y % cell) > 0 && (y % cell) + 1 < cell)
+				image.setPixel(x, y, 0xFF, 0xFF, 0xFF);
+			else
+				image.setPixel(x, y, 0xFF, 0x00, 0xFF);
+		}
+	image.save(filename);
+
+	return getFileSize(filename);
+}
+
+size_t AssetGenerator :: getFileSize (const string& filename)
+{
+	ifstream input(filename.c_str(), ios::in | ios::binary | ios::ate);
+	if(!input.is_open())
+		return 0;
+	return (size_t)(input.tellg());
+}
@@ -0,0 +1,156 @@
+//
+//  AssetGenerator.h
+//
+//  Functions to generate procedural OBJ, MTL, and BMP files
+//    for benchmarking the ObjLibrary loaders at scale.
+//
+
+#ifndef __ASSET_GENERATOR_H__
+#define __ASSET_GENERATOR_H__
+
+#include <string>
+
+
+
+namespace AssetGenerator
+{
+
+//
+//  ObjSettings
+//
+//  A record to describe the shape of a generated OBJ file.
+//    The faces are divided into runs, each started by a
+//    "usemtl" line, and comment blocks are spread evenly
+//    between the faces.
+//
+//  m_ngon_fraction is the fraction of faces that have more
+//    than 3 vertexes.  These faces have between 4 and
+//    m_ngon_max_vertexes vertexes.  If m_is_negative_indexes
+//    is set, every second face is written with relative
+//    (negative) indexes instead of absolute ones.
+//
+struct ObjSettings
+{
+	ObjSettings ();
+
+	unsigned int m_vertex_count;
+	unsigned int m_face_count;
+	double m_ngon_fraction;
+	unsigned int m_ngon_max_vertexes;
+	bool m_is_negative_indexes;
+	bool m_is_texture_coordinates;
+	bool m_is_normals;
+	unsigned int m_material_count;
+	unsigned int m_material_switch_count;
+	unsigned int m_comment_block_count;
+	unsigned int m_comment_block_lines;
+	unsigned int m_seed;
+};
+
+
+
+//
+//  generateObj
+//
+//  Purpose: To write a procedural OBJ file.
+//  Parameter(s):
+//    <1> filename: The name of the OBJ file to write
+//    <2> mtl_filename: The name of the MTL file to reference,
+//                      or "" for none
+//    <3> settings: The shape of the model to generate
+//  Precondition(s):
+//    <1> filename != ""
+//    <2> settings.m_vertex_count >= 3
+//    <3> settings.m_ngon_max_vertexes >= 3
+//    <4> settings.m_material_count >= 1
+//  Returns: The size of the file written in bytes.  If the file
+//           could not be opened, 0 is returned.
+//  Side Effect: File filename is created or overwritten.
+//
+size_t generateObj (const std::string& filename,
+                    const std::string& mtl_filename,
+                    const ObjSettings& settings);
+
+//
+//  generateMtl
+//
+//  Purpose: To write a procedural MTL file.  The materials are
+//           named "material_0", "material_1", etc., matching
+//           the names used by generateObj.
+//  Parameter(s):
+//    <1> filename: The name of the MTL file to write
+//    <2> material_count: The number of materials
+//    <3> texture_filename: The name of the texture to use for
+//                          the diffuse map, or "" for none
+//    <4> seed: The seed for the material colours
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: The size of the file written in bytes.  If the file
+//           could not be opened, 0 is returned.
+//  Side Effect: File filename is created or overwritten.
+//
+size_t generateMtl (const std::string& filename,
+                    unsigned int material_count,
+                    const std::string& texture_filename,
+                    unsigned int seed);
+
+//
+//  generateBmp
+//
+//  Purpose: To write a 24-bit BMP file with a procedural
+//           checker pattern.
+//  Parameter(s):
+//    <1> filename: The name of the BMP file to write
+//    <2> width
+//    <3> height: The dimensions of the image
+//    <4> seed: The seed for the pattern colours
+//  Precondition(s):
+//    <1> filename != ""
+//    <2> width > 0
+//    <3> height > 0
+//  Returns: The size of the file written in bytes.
+//  Side Effect: File filename is created or overwritten.
+//
+size_t generateBmp (const std::string& filename,
+                    unsigned int width,
+                    unsigned int height,
+                    unsigned int seed);
+
+//
+//  generateFontBmp
+//
+//  Purpose: To write a 24-bit BMP file in the layout expected
+//           by SpriteFont::load.  The characters are 16x16
+//           blocks of varying width on a magenta background.
+//  Parameter(s):
+//    <1> filename: The name of the BMP file to write
+//    <2> width: The width of the image
+//  Precondition(s):
+//    <1> filename != ""
+//    <2> width >= 16
+//    <3> width is a power of 2
+//  Returns: The size of the file written in bytes.
+//  Side Effect: File filename is created or overwritten.  The
+//               image is width x width pixels.
+//
+size_t generateFontBmp (const std::string& filename,
+                        unsigned int width);
+
+//
+//  getFileSize
+//
+//  Purpose: To determine the size of the specified file.
+//  Parameter(s):
+//    <1> filename: The name of the file
+//  Precondition(s): N/A
+//  Returns: The size of file filename in bytes.  If the file
+//           does not exist, 0 is returned.
+//  Side Effect: N/A
+//
+size_t getFileSize (const std::string& filename);
+
+}  // end of namespace AssetGenerator
+
+
+
+#endif
@@ -0,0 +1,1748 @@
+//
+//  mainBenchmark.cpp
+//
+//  Generates procedural OBJ, MTL, and BMP files and measures
+//    the throughput of the ObjLibrary loaders and savers.
+//
+//  Usage: Benchmark [--no-gl | --gl] [--keep] [scale]
+//    --no-gl: Skip the benchmarks that need an OpenGL context
+//    --gl:    Only run the OpenGL self-tests, then exit
+//    --keep:  Do not delete the generated files afterwards
+//    scale:   Multiplier for the vertex and face counts
+//
+//  Some benchmarks also check their results.  If any check
+//    fails, it is reported and the exit status is 1.
+//
+//  If BENCHMARK_EGL is defined, the --gl self-tests render into
+//    a headless EGL pbuffer, so they can run without a display
+//    (for example, with EGL_PLATFORM=surfaceless on Mesa).  The
+//    program must then also be linked with the EGL library.
+//    Otherwise, they render into a small GLUT window.
+//
+
+#include <cassert>
+#include <cstddef>	// for offsetof
+#include <cstdio>	// for remove
+#include <cstdlib>	// for atof
+#include <climits>	// for UINT_MAX
+#include <cmath>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+
+#include "../Lab4/GetGlut.h"
+#ifdef BENCHMARK_EGL
+	#include <EGL/egl.h>
+#endif
+#include "../Lab4/ObjLibrary/DisplayList.h"
+#include "../Lab4/ObjLibrary/ObjModel.h"
+#include "../Lab4/ObjLibrary/MtlLibrary.h"
+#include "../Lab4/ObjLibrary/Material.h"
+#include "../Lab4/ObjLibrary/TextureBmp.h"
+#include "../Lab4/ObjLibrary/SpriteFont.h"
+#include "../Lab4/ObjLibrary/SimdKernels.h"
+#include "../Lab4/ObjLibrary/Vector3Array.h"
+#include "../Lab4/ObjLibrary/Quaternion.h"
+#include "../Lab4/ObjLibrary/AnimationPlayer.h"
+#include "../Lab4/ObjLibrary/MorphModel.h"
+#include "../Lab4/ObjLibrary/SplinePath.h"
+#include "../Lab4/ObjLibrary/Script.h"
+#include "../Lab4/ObjLibrary/ScriptScheduler.h"
+#include "../Lab4/ObjLibrary/SceneGraph.h"
+#include "../Lab4/ObjLibrary/EntityRegistry.h"
+#include "../Lab4/ObjLibrary/SystemScheduler.h"
+#include "../Lab4/ObjLibrary/EntitySystems.h"
+#include "../Lab4/ObjLibrary/JobSystem.h"
+#include "../Lab4/ObjLibrary/MtlLibraryManager.h"
+#include "../Lab4/ObjLibrary/AssetLoader.h"
+#include "../Lab4/ObjLibrary/AssetWatcher.h"
+#include "../Lab4/ObjLibrary/ObjModelManager.h"
+#include "../Lab4/ObjLibrary/OcclusionCuller.h"
+#include "../Lab4/ObjLibrary/LodSelector.h"
+#include "../Lab4/ObjLibrary/AssetArchive.h"
+#include "../Lab4/ObjLibrary/AssetFileSystem.h"
+#include "../Lab4/ObjLibrary/ObjStream.h"
+#include "../Lab4/ObjLibrary/Matrix44.h"
+#include "../Lab4/ObjLibrary/ProgressiveModel.h"
+#include "AssetGenerator.h"
+
+using namespace std;
+using namespace ObjLibrary;
+using namespace AssetGenerator;
+
+//
+//  Scenario
+//
+//  A record to represent one generated OBJ file to benchmark.
+//
+struct Scenario
+{
+	string m_name;
+	ObjSettings m_settings;
+};
+
+vector<Scenario> createScenarios (double scale);
+double getTime ();
+void printHeader ();
+void printResult (const string& benchmark,
+                  const string& scenario,
+                  size_t bytes,
+                  const vector<double>& seconds);
+void checkResult (bool is_correct, const string& description);
+bool writeFile (const string& filename, const string& contents);
+#ifdef BENCHMARK_EGL
+bool createHeadlessContext ();
+#endif
+vector<unsigned char> renderSelfTest (const ObjModel& model,
+                                      bool is_immediate);
+void checkDrawCache ();
+void benchmarkObjModel (const Scenario& scenario);
+void benchmarkMtlLibrary ();
+void benchmarkTextureBmp ();
+void benchmarkSpriteFont ();
+template <typename T>
+void benchmarkVector3Array (const string& name, double scale);
+void benchmarkAnimationPlayer (double scale);
+void benchmarkMorphModel (const Scenario& scenario);
+void benchmarkDrawCache (const Scenario& scenario);
+void benchmarkSplinePath (double scale);
+void benchmarkScriptScheduler (double scale);
+void benchmarkSceneGraph (double scale);
+void benchmarkEntitySystems (double scale);
+void benchmarkJobSystem (double scale);
+void benchmarkAssetLoader (double scale);
+void benchmarkAssetWatcher ();
+void benchmarkObjModelManager (double scale);
+void benchmarkOcclusionCuller (double scale);
+void benchmarkLodSelector (double scale);
+void benchmarkAssetArchive (double scale);
+void benchmarkObjStream (const Scenario& scenario);
+void benchmarkProgressiveModel (double scale);
+
+const unsigned int ITERATIONS = 3;
+const char* MTL_FILENAME        = "benchmark_materials.mtl";
+const char* MTL_PACK_FILENAME   = "benchmark_materials.pack";
+const char* TEXTURE_FILENAME    = "benchmark_texture.bmp";
+const char* FONT_FILENAME       = "benchmark_font.bmp";
+const char* SAVE_FILENAME       = "benchmark_saved.obj";
+const unsigned int MTL_MATERIAL_COUNT = 5000;
+const unsigned int VECTOR3_ARRAY_SIZE  = 1000000;
+const unsigned int ANIMATION_TRACK_COUNT = 100000;
+const unsigned int ANIMATION_KEY_COUNT   = 16;
+const unsigned int SPLINE_QUERY_COUNT    = 1000000;
+const unsigned int SCRIPT_COUNT          = 100000;
+const unsigned int SCRIPT_FRAME_COUNT    = 60;
+const unsigned int SCENE_NODE_COUNT      = 100000;
+const unsigned int SCENE_CHILD_COUNT     = 8;
+const unsigned int ENTITY_COUNT          = 100000;
+const unsigned int EMITTER_COUNT         = 100;
+const unsigned int JOB_ARRAY_SIZE        = 4000000;
+const unsigned int JOB_CHAIN_COUNT       = 1000;
+const unsigned int JOB_CHAIN_LENGTH      = 10;
+const unsigned int LEVEL_MODEL_COUNT     = 200;
+const unsigned int LEVEL_LIBRARY_COUNT   = 20;
+const unsigned int PROP_INSTANCE_COUNT   = 1000;
+const char* PROP_FILENAME       = "benchmark_prop.obj";
+const unsigned int DEFORM_VERTEX_COUNT   = 100;
+const unsigned int DEFORM_FRAME_COUNT    = 10;
+const unsigned int CULL_BOX_COUNT        = 100000;
+const unsigned int CULL_WALL_COUNT       = 40;
+const unsigned int CULL_CHECK_SIZE       = 64;
+const unsigned int LOD_INSTANCE_COUNT    = 100000;
+const unsigned int ARCHIVE_FILE_COUNT    = 2000;
+const char* ARCHIVE_FILENAME    = "benchmark_assets.pak";
+const char* BINARY_FILENAME     = "benchmark_binary.olbm";
+const char* SPILL_PREFIX        = "benchmark_spill";
+const unsigned int PROGRESSIVE_GRID_SIDE       = 300;
+const unsigned int PROGRESSIVE_BASE_FACE_COUNT = 1000;
+const char* PROGRESSIVE_FILENAME = "benchmark_progressive.olpm";
+const char* WATCH_OBJ_FILENAME  = "benchmark_watch.obj";
+const char* WATCH_MTL_FILENAME  = "benchmark_watch.mtl";
+const unsigned int WATCH_MATERIAL_COUNT = 16;
+const char* SELF_TEST_FILENAME  = "benchmark_self_test.obj";
+const int SELF_TEST_SIZE = 64;
+
+vector<string> g_generated_files;
+unsigned int g_failure_count = 0;
+
+
+
+int main (int argc, char* argv[])
+{
+	bool is_gl = true;
+	bool is_self_test = false;
+	bool is_keep = false;
+	double scale = 1.0;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--no-gl") == 0)
+			is_gl = false;
+		else if(strcmp(argv[i], "--gl") == 0)
+			is_self_test = true;
+		else if(strcmp(argv[i], "--keep") == 0)
+			is_keep = true;
+		else if(atof(argv[i]) > 0.0)
+			scale = atof(argv[i]);
+		else
+		{
+			cerr << "Usage: " << argv[0] << " [--no-gl | --gl] [--keep] [scale]" << endl;
+			return 1;
+		}
+	}
+
+	if(is_self_test)
+	{
+#ifdef BENCHMARK_EGL
+		if(!createHeadlessContext())
+		{
+			cerr << "Could not create a headless OpenGL context" << endl;
+			return 1;
+		}
+#else
+		glutInit(&argc, argv);
+		glutInitDisplayMode(GLUT_SINGLE | GLUT_DEPTH | GLUT_RGB);
+		glutInitWindowSize(SELF_TEST_SIZE, SELF_TEST_SIZE);
+		glutCreateWindow("ObjLibrary Self-Test");
+#endif
+
+		checkDrawCache();
+
+		if(!is_keep)
+			for(unsigned int i = 0; i < g_generated_files.size(); i++)
+				remove(g_generated_files[i].c_str());
+
+		if(g_failure_count > 0)
+		{
+			cerr << g_failure_count << " check(s) failed" << endl;
+			return 1;
+		}
+		cout << "OpenGL self-tests passed" << endl;
+		return 0;
+	}
+
+	if(is_gl)
+	{
+		// SpriteFont needs an OpenGL context to load into
+		glutInit(&argc, argv);
+		glutInitDisplayMode(GLUT_DOUBLE | GLUT_DEPTH | GLUT_RGB);
+		glutCreateWindow("ObjLibrary Benchmark");
+	}
+
+	cout << "Generating assets (scale " << scale << ")..." << endl;
+	generateMtl(MTL_FILENAME, MTL_MATERIAL_COUNT, TEXTURE_FILENAME, 1);
+	generateBmp(TEXTURE_FILENAME, 2048, 2048, 1);
+	generateFontBmp(FONT_FILENAME, 512);
+	g_generated_files.push_back(MTL_FILENAME);
+	g_generated_files.push_back(MTL_PACK_FILENAME);
+	g_generated_files.push_back(TEXTURE_FILENAME);
+	g_generated_files.push_back(FONT_FILENAME);
+	g_generated_files.push_back(SAVE_FILENAME);
+
+	vector<Scenario> scenarios = createScenarios(scale);
+	for(unsigned int s = 0; s < scenarios.size(); s++)
+		g_generated_files.push_back(scenarios[s].m_name + ".obj");
+
+	printHeader();
+	for(unsigned int s = 0; s < scenarios.size(); s++)
+		benchmarkObjModel(scenarios[s]);
+	benchmarkMtlLibrary();
+	benchmarkTextureBmp();
+	if(is_gl)
+		benchmarkSpriteFont();
+	benchmarkVector3Array<float>("Vector3Array<float>", scale);
+	benchmarkVector3Array<double>("Vector3Array<double>", scale);
+	benchmarkAnimationPlayer(scale);
+	benchmarkMorphModel(scenarios[0]);
+	if(is_gl)
+		benchmarkDrawCache(scenarios[0]);
+	benchmarkSplinePath(scale);
+	benchmarkScriptScheduler(scale);
+	benchmarkSceneGraph(scale);
+	benchmarkEntitySystems(scale);
+	benchmarkJobSystem(scale);
+	benchmarkAssetLoader(scale);
+	benchmarkAssetWatcher();
+	benchmarkObjModelManager(scale);
+	benchmarkOcclusionCuller(scale);
+	benchmarkLodSelector(scale);
+	benchmarkAssetArchive(scale);
+	benchmarkObjStream(scenarios[1]);
+	benchmarkProgressiveModel(scale);
+
+	if(!is_keep)
+		for(unsigned int i = 0; i < g_generated_files.size(); i++)
+			remove(g_generated_files[i].c_str());
+
+	if(g_failure_count > 0)
+	{
+		cerr << g_failure_count << " check(s) failed" << endl;
+		return 1;
+	}
+	return 0;
+}
+
+vector<Scenario> createScenarios (double scale)
+{
+	vector<Scenario> scenarios;
+	Scenario scenario;
+
+	scenario.m_name = "benchmark_triangles";
+	scenario.m_settings = ObjSettings();
+	scenario.m_settings.m_vertex_count = (unsigned int)(100000 * scale);
+	scenario.m_settings.m_face_count   = (unsigned int)(200000 * scale);
+	scenario.m_settings.m_ngon_fraction = 0.0;
+	scenarios.push_back(scenario);
+
+	scenario.m_name = "benchmark_ngons";
+	scenario.m_settings = ObjSettings();
+	scenario.m_settings.m_vertex_count = (unsigned int)(100000 * scale);
+	scenario.m_settings.m_face_count   = (unsigned int)(100000 * scale);
+	scenario.m_settings.m_ngon_fraction = 0.75;
+	scenario.m_settings.m_ngon_max_vertexes = 8;
+	scenarios.push_back(scenario);
+
+	scenario.m_name = "benchmark_negative";
+	scenario.m_settings = ObjSettings();
+	scenario.m_settings.m_vertex_count = (unsigned int)(100000 * scale);
+	scenario.m_settings.m_face_count   = (unsigned int)(200000 * scale);
+	scenario.m_settings.m_is_negative_indexes = true;
+	scenarios.push_back(scenario);
+
+	scenario.m_name = "benchmark_usemtl";
+	scenario.m_settings = ObjSettings();
+	scenario.m_settings.m_vertex_count = (unsigned int)(50000 * scale);
+	scenario.m_settings.m_face_count   = (unsigned int)(100000 * scale);
+	scenario.m_settings.m_material_count = 64;
+	scenario.m_settings.m_material_switch_count = (unsigned int)(5000 * scale);
+	scenarios.push_back(scenario);
+
+	scenario.m_name = "benchmark_comments";
+	scenario.m_settings = ObjSettings();
+	scenario.m_settings.m_vertex_count = (unsigned int)(10000 * scale);
+	scenario.m_settings.m_face_count   = (unsigned int)(20000 * scale);
+	scenario.m_settings.m_comment_block_count = 200;
+	scenario.m_settings.m_comment_block_lines = (unsigned int)(500 * scale);
+	scenarios.push_back(scenario);
+
+	for(unsigned int s = 0; s < scenarios.size(); s++)
+	{
+		if(scenarios[s].m_settings.m_vertex_count < 3)
+			scenarios[s].m_settings.m_vertex_count = 3;
+		scenarios[s].m_settings.m_seed = s + 1;
+	}
+
+	return scenarios;
+}
+
+double getTime ()
+{
+	return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void printHeader ()
+{
+	cout << left  << setw(24) << "Benchmark"
+	              << setw(24) << "Scenario"
+	     << right << setw(10) << "MB"
+	              << setw(12) << "best (s)"
+	              << setw(12) << "MB/s" << endl;
+	cout << string(82, '-') << endl;
+}
+
+void printResult (const string& benchmark,
+                  const string& scenario,
+                  size_t bytes,
+                  const vector<double>& seconds)
+{
+	assert(!seconds.empty());
+
+	double best = seconds[0];
+	for(unsigned int i = 1; i < seconds.size(); i++)
+		if(seconds[i] < best)
+			best = seconds[i];
+
+	double megabytes = bytes / 1.0e6;
+
+	cout << left  << setw(24) << benchmark
+	              << setw(24) << scenario
+	     << right << fixed
+	              << setw(10) << setprecision(2) << megabytes
+	              << setw(12) << setprecision(4) << best
+	              << setw(12) << setprecision(1) << (best > 0.0 ? megabytes / best : 0.0) << endl;
+}
+
+void checkResult (bool is_correct, const string& description)
+{
+	if(is_correct)
+		return;
+
+	cerr << "Check failed: " << description << endl;
+	g_failure_count++;
+}
+
+bool writeFile (const string& filename, const string& contents)
+{
+	ofstream output_file(filename.c_str(), ios::out | ios::binary);
+	if(!output_file.is_open())
+		return false;
+	output_file.write(contents.data(), contents.size());
+	return output_file.good();
+}
+
+#ifdef BENCHMARK_EGL
+bool createHeadlessContext ()
+{
+	// no window is needed, so this works without a display
+	EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	if(display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL))
+		return false;
+
+	const EGLint CONFIG_ATTRIBUTES[] =
+	{
+		EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE,   8,
+		EGL_GREEN_SIZE, 8,
+		EGL_BLUE_SIZE,  8,
+		EGL_DEPTH_SIZE, 16,
+		EGL_NONE
+	};
+	const EGLint SURFACE_ATTRIBUTES[] =
+	{
+		EGL_WIDTH,  SELF_TEST_SIZE,
+		EGL_HEIGHT, SELF_TEST_SIZE,
+		EGL_NONE
+	};
+
+	EGLConfig config;
+	EGLint config_count = 0;
+	if(!eglChooseConfig(display, CONFIG_ATTRIBUTES, &config, 1, &config_count) || config_count < 1)
+		return false;
+	if(!eglBindAPI(EGL_OPENGL_API))
+		return false;
+
+	EGLSurface surface = eglCreatePbufferSurface(display, config, SURFACE_ATTRIBUTES);
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, NULL);
+	if(surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT)
+		return false;
+	return eglMakeCurrent(display, surface, surface, context) == EGL_TRUE;
+}
+#endif
+
+vector<unsigned char> renderSelfTest (const ObjModel& model,
+                                      bool is_immediate)
+{
+	glViewport(0, 0, SELF_TEST_SIZE, SELF_TEST_SIZE);
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	glOrtho(-1.5, 1.5, -1.5, 1.5, -2.0, 2.0);
+	glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+	glRotated(30.0, 1.0, 1.0, 0.0);
+
+	// lighting makes the normals affect the pixels too
+	glEnable(GL_DEPTH_TEST);
+	glEnable(GL_LIGHTING);
+	glEnable(GL_LIGHT0);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	if(is_immediate)
+	{
+		// draw() does not use its cache inside a display list
+		DisplayList list;
+		list.begin();
+			model.draw();
+		list.end();
+		list.draw();
+	}
+	else
+		model.draw();
+	glFinish();
+
+	vector<unsigned char> pixels(SELF_TEST_SIZE * SELF_TEST_SIZE * 4);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, SELF_TEST_SIZE, SELF_TEST_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, &(pixels[0]));
+	return pixels;
+}
+
+//
+//  checkDrawCache
+//
+//  Checks that draw() builds its cache, that changing a vertex
+//    makes the cache out of date, and that the pixels drawn
+//    from the cache are the same as those drawn immediately,
+//    both from the DisplayList and from the vertex arrays used
+//    after a vertex is changed.  A model changed before its
+//    first draw must also build its cache and draw the same
+//    pixels.
+//
+void checkDrawCache ()
+{
+	ObjSettings settings;
+	settings.m_vertex_count = 200;
+	settings.m_face_count   = 100;
+	generateObj(SELF_TEST_FILENAME, "", settings);
+	g_generated_files.push_back(SELF_TEST_FILENAME);
+
+	ostringstream log;
+	ObjModel model(SELF_TEST_FILENAME, log);
+	checkResult(model.isValid(), "self-test model is valid");
+	if(!model.isValid())
+		return;
+
+	vector<unsigned char> immediate = renderSelfTest(model, true);
+	checkResult(!model.isDrawCacheReady(), "drawing inside a display list does not build the draw cache");
+
+	unsigned int lit_count = 0;
+	for(unsigned int i = 0; i < immediate.size(); i += 4)
+		if(immediate[i] != 0 || immediate[i + 1] != 0 || immediate[i + 2] != 0)
+			lit_count++;
+	checkResult(lit_count > 0, "self-test model covers some pixels");
+
+	// the first draw builds the cache and the second uses it
+	renderSelfTest(model, false);
+	checkResult(model.isDrawCacheReady(), "draw builds the draw cache");
+	checkResult(renderSelfTest(model, false) == immediate, "cached draw matches immediate mode");
+
+	for(unsigned int v = 0; v < model.getVertexCount(); v += 10)
+		model.setVertexY(v, model.getVertexY(v) * 0.5);
+	checkResult(!model.isDrawCacheReady(), "changing a vertex clears the draw cache");
+
+	immediate = renderSelfTest(model, true);
+	renderSelfTest(model, false);
+	checkResult(model.isDrawCacheReady(), "draw updates the vertex arrays");
+	checkResult(renderSelfTest(model, false) == immediate, "vertex array draw matches immediate mode");
+
+	// a model changed before it is ever drawn still builds the
+	//  DisplayList on its first draw
+	ObjModel edited(SELF_TEST_FILENAME, log);
+	for(unsigned int v = 0; v < edited.getVertexCount(); v += 10)
+		edited.setVertexY(v, edited.getVertexY(v) * 0.5);
+	checkResult(!edited.isDrawCacheReady(), "a new model has no draw cache");
+	renderSelfTest(edited, false);
+	checkResult(edited.isDrawCacheReady(), "draw builds the draw cache after an edit");
+	checkResult(renderSelfTest(edited, false) == immediate, "edited model draw matches immediate mode");
+}
+
+void benchmarkObjModel (const Scenario& scenario)
+{
+	string filename = scenario.m_name + ".obj";
+	size_t bytes = generateObj(filename, MTL_FILENAME, scenario.m_settings);
+	if(bytes == 0)
+	{
+		cerr << "Could not write \"" << filename << "\"" << endl;
+		return;
+	}
+
+	ObjModel model;
+	vector<double> load_seconds;
+	vector<double> validate_seconds;
+	vector<double> save_seconds;
+
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		ostringstream log;
+
+		double start = getTime();
+		model.load(filename, log);
+		load_seconds.push_back(getTime() - start);
+
+		start = getTime();
+		model.validate();
+		validate_seconds.push_back(getTime() - start);
+
+		start = getTime();
+		model.save(SAVE_FILENAME, log);
+		save_seconds.push_back(getTime() - start);
+	}
+
+	printResult("ObjModel::load",     scenario.m_name, bytes,                       load_seconds);
+	printResult("ObjModel::validate", scenario.m_name, bytes,                       validate_seconds);
+	printResult("ObjModel::save",     scenario.m_name, getFileSize(SAVE_FILENAME), save_seconds);
+}
+
+void benchmarkMtlLibrary ()
+{
+	size_t bytes = getFileSize(MTL_FILENAME);
+	MtlLibrary library;
+	vector<double> seconds;
+
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		ostringstream log;
+
+		double start = getTime();
+		library.load(MTL_FILENAME, log);
+		seconds.push_back(getTime() - start);
+	}
+
+	printResult("MtlLibrary::load", MTL_FILENAME, bytes, seconds);
+
+	library.savePack(MTL_PACK_FILENAME);
+	size_t pack_bytes = getFileSize(MTL_PACK_FILENAME);
+	seconds.clear();
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		double start = getTime();
+		library.loadPack(MTL_PACK_FILENAME);
+		seconds.push_back(getTime() - start);
+	}
+
+	printResult("MtlLibrary::loadPack", MTL_PACK_FILENAME, pack_bytes, seconds);
+	checkResult(library.getMaterialCount() > 0, "MtlLibrary::loadPack reads the materials");
+	if(library.getMaterialCount() == 0)
+		return;
+
+	// the material count comes just before the first material,
+	//  which starts with the length of its name
+	string pack;
+	AssetFileSystem::readFile(MTL_PACK_FILENAME, pack);
+	const string& first_name = library.getMaterial(0)->getName();
+	unsigned int name_length = (unsigned int)(first_name.size());
+	string first_record = string((const char*)(&name_length), sizeof(name_length)) + first_name;
+	size_t first_record_offset = pack.find(first_record);
+	checkResult(first_record_offset != string::npos && first_record_offset >= sizeof(unsigned int),
+	            "MtlLibrary pack has the first material");
+	if(first_record_offset == string::npos || first_record_offset < sizeof(unsigned int))
+		return;
+
+	unsigned int material_count = library.getMaterialCount();
+	unsigned int bad_count = UINT_MAX;
+	memcpy(&(pack[first_record_offset - sizeof(unsigned int)]), &bad_count, sizeof(bad_count));
+	writeFile(MTL_PACK_FILENAME, pack);
+	checkResult(!library.loadPack(MTL_PACK_FILENAME), "MtlLibrary::loadPack rejects a bad material count");
+	checkResult(library.getMaterialCount() == material_count, "MtlLibrary::loadPack keeps the old materials on failure");
+}
+
+void benchmarkTextureBmp ()
+{
+	size_t bytes = getFileSize(TEXTURE_FILENAME);
+	TextureBmp texture;
+	vector<double> seconds;
+
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		ostringstream log;
+
+		double start = getTime();
+		texture.load(TEXTURE_FILENAME, log);
+		seconds.push_back(getTime() - start);
+	}
+
+	printResult("TextureBmp::load", TEXTURE_FILENAME, bytes, seconds);
+}
+
+void benchmarkSpriteFont ()
+{
+	size_t bytes = getFileSize(FONT_FILENAME);
+	vector<double> seconds;
+
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		// SpriteFonts cannot be reloaded, so make a new one each time
+		SpriteFont* p_font = new SpriteFont();
+
+		double start = getTime();
+		p_font->load(FONT_FILENAME);
+		seconds.push_back(getTime() - start);
+
+		delete p_font;
+	}
+
+	printResult("SpriteFont::load", FONT_FILENAME, bytes, seconds);
+}
+
+//
+//  benchmarkVector3Array
+//
+//  Runs a typical particle update (integrate, rotate,
+//    normalize, bounding box) at every supported SIMD level.
+//    The MB column is the size of the position and velocity
+//    arrays.
+//
+template <typename T>
+void benchmarkVector3Array (const string& name, double scale)
+{
+	unsigned int size = (unsigned int)(VECTOR3_ARRAY_SIZE * scale);
+	if(size < 1)
+		size = 1;
+
+	Vector3Array<T> positions(size);
+	Vector3Array<T> velocities(size);
+	for(unsigned int i = 0; i < size; i++)
+	{
+		positions .set(i, Vector3(i % 101, i % 103, i % 107));
+		velocities.set(i, Vector3(1.0, -0.5, 0.25));
+	}
+	size_t bytes = size * 6 * sizeof(T);
+
+	unsigned int original_level = SimdKernels::getLevel();
+	for(unsigned int level = 0; level <= SimdKernels::getSupportedLevel(); level++)
+	{
+		SimdKernels::setLevel(level);
+		vector<double> seconds;
+
+		for(unsigned int i = 0; i < ITERATIONS; i++)
+		{
+			Vector3 min_corner;
+			Vector3 max_corner;
+
+			double start = getTime();
+			positions.addScaled(velocities, 0.01);
+			velocities.rotateArbitraryNormal(Vector3::UNIT_Y_PLUS, 0.01);
+			velocities.normalize();
+			positions.getMinMaxComponents(min_corner, max_corner);
+			seconds.push_back(getTime() - start);
+		}
+
+		printResult(name, SimdKernels::getLevelName(level), bytes, seconds);
+	}
+	SimdKernels::setLevel(original_level);
+}
+
+//
+//  benchmarkAnimationPlayer
+//
+//  Evaluates ANIMATION_TRACK_COUNT Vector3 tracks and the same
+//    number of nlerp rotation tracks at every supported SIMD
+//    level.  The time advances a little each iteration, as it
+//    would from frame to frame.  The MB column is the size of
+//    the results.
+//
+void benchmarkAnimationPlayer (double scale)
+{
+	unsigned int track_count = (unsigned int)(ANIMATION_TRACK_COUNT * scale);
+	if(track_count < 1)
+		track_count = 1;
+
+	AnimationPlayer player;
+	vector<double> times(ANIMATION_KEY_COUNT);
+	vector<Vector3> positions(ANIMATION_KEY_COUNT);
+	vector<Quaternion> rotations(ANIMATION_KEY_COUNT);
+	for(unsigned int t = 0; t < track_count; t++)
+	{
+		for(unsigned int k = 0; k < ANIMATION_KEY_COUNT; k++)
+		{
+			times[k] = k * 0.5 + (t % 7) * 0.01;
+			positions[k] = Vector3(k, (t + k) % 13, t % 17);
+			rotations[k] = Quaternion::getRotationArbitrary(Vector3(1.0, (t % 5) + 1.0, 0.5),
+			                                                k * 0.4 + t * 0.001);
+		}
+		player.addVector3Track(times, positions, true);
+		player.addRotationTrack(times, rotations, AnimationPlayer::ROTATION_NLERP, true);
+	}
+	size_t bytes = track_count * 7 * sizeof(float);
+
+	unsigned int original_level = SimdKernels::getLevel();
+	for(unsigned int level = 0; level <= SimdKernels::getSupportedLevel(); level++)
+	{
+		SimdKernels::setLevel(level);
+		vector<double> seconds;
+
+		for(unsigned int i = 0; i < ITERATIONS; i++)
+		{
+			double start = getTime();
+			player.update(level + i * 0.0166);
+			seconds.push_back(getTime() - start);
+		}
+
+		printResult("AnimationPlayer::update", SimdKernels::getLevelName(level), bytes, seconds);
+	}
+	SimdKernels::setLevel(original_level);
+}
+
+//
+//  benchmarkMorphModel
+//
+//  Blends the model from a scenario with two morph targets at
+//    every supported SIMD level.  The scenario file must
+//    already have been generated.  The MB column is the size
+//    of the blended positions and normals.
+//
+void benchmarkMorphModel (const Scenario& scenario)
+{
+	ostringstream log;
+	ObjModel base(scenario.m_name + ".obj", log);
+	if(!base.isValid())
+	{
+		cerr << "Could not load \"" << scenario.m_name << ".obj\"" << endl;
+		return;
+	}
+
+	ObjModel raised = base;
+	ObjModel twisted = base;
+	for(unsigned int v = 0; v < base.getVertexCount(); v++)
+	{
+		const Vector3& position = base.getVertexPosition(v);
+		raised .setVertexPosition(v, position + Vector3(0.0, 1.0, 0.0));
+		twisted.setVertexPosition(v, position.getRotatedY(position.y * 0.1));
+	}
+
+	MorphModel morph(base);
+	morph.addTarget(raised);
+	morph.addTarget(twisted);
+	size_t bytes = (morph.getVertexCount() + morph.getNormalCount()) * 3 * sizeof(float);
+
+	unsigned int original_level = SimdKernels::getLevel();
+	for(unsigned int level = 0; level <= SimdKernels::getSupportedLevel(); level++)
+	{
+		SimdKernels::setLevel(level);
+		vector<double> seconds;
+
+		for(unsigned int i = 0; i < ITERATIONS; i++)
+		{
+			morph.setWeight(0, 0.25f * i);
+			morph.setWeight(1, 1.0f - 0.25f * i);
+
+			double start = getTime();
+			morph.update();
+			seconds.push_back(getTime() - start);
+		}
+
+		printResult("MorphModel::update", SimdKernels::getLevelName(level), bytes, seconds);
+	}
+	SimdKernels::setLevel(original_level);
+}
+
+//
+//  benchmarkDrawCache
+//
+//  Moves DEFORM_VERTEX_COUNT vertexes of a model and draws it,
+//    for DEFORM_FRAME_COUNT frames, as for interactive editing.
+//    In the "full rebuild" scenario, the whole draw cache is
+//    recompiled each frame.  In the "dirty ranges" scenario,
+//    only the parts for the moved vertexes are updated.  The
+//    MB column is the size of the vertex positions.
+//
+void benchmarkDrawCache (const Scenario& scenario)
+{
+	ostringstream log;
+	ObjModel model(scenario.m_name + ".obj", log);
+	if(!model.isValid())
+	{
+		cerr << "Could not load \"" << scenario.m_name << ".obj\"" << endl;
+		return;
+	}
+
+	unsigned int vertex_count = (unsigned int)(model.getVertexCount());
+	size_t bytes = vertex_count * 3 * sizeof(float);
+
+	for(unsigned int is_dirty_ranges = 0; is_dirty_ranges < 2; is_dirty_ranges++)
+	{
+		vector<double> seconds;
+		for(unsigned int i = 0; i < ITERATIONS; i++)
+		{
+			model.invalidateDrawCache();
+			model.draw();
+			glFinish();
+
+			double start = getTime();
+			for(unsigned int f = 0; f < DEFORM_FRAME_COUNT; f++)
+			{
+				for(unsigned int d = 0; d < DEFORM_VERTEX_COUNT; d++)
+				{
+					unsigned int v = (f * DEFORM_VERTEX_COUNT + d * 7919) % vertex_count;
+					model.setVertexY(v, model.getVertexY(v) + 0.01);
+				}
+				if(!is_dirty_ranges)
+					model.invalidateDrawCache();
+				model.draw();
+			}
+			glFinish();
+			seconds.push_back(getTime() - start);
+		}
+
+		printResult("ObjModel::draw", (is_dirty_ranges ? "dirty ranges" : "full rebuild"), bytes, seconds);
+	}
+}
+
+//
+//  benchmarkSplinePath
+//
+//  Finds the positions of SPLINE_QUERY_COUNT objects spread
+//    along a closed Catmull-Rom path, as for moving many
+//    objects at constant speed.  The MB column is the size of
+//    the resulting positions.
+//
+void benchmarkSplinePath (double scale)
+{
+	unsigned int query_count = (unsigned int)(SPLINE_QUERY_COUNT * scale);
+	if(query_count < 1)
+		query_count = 1;
+
+	vector<Vector3> control_points;
+	for(unsigned int i = 0; i < 64; i++)
+		control_points.push_back(Vector3(100.0, 0.0, 0.0).getRotatedY(i * 0.1) * (1.0 + (i % 3) * 0.2) +
+		                         Vector3(0.0, i % 5, 0.0));
+	SplinePath path(control_points, SplinePath::TYPE_CATMULL_ROM, true);
+
+	vector<double> distances(query_count);
+	for(unsigned int i = 0; i < query_count; i++)
+		distances[i] = path.getLength() * i / query_count;
+
+	Vector3Array<float> positions;
+	size_t bytes = query_count * 3 * sizeof(float);
+	vector<double> seconds;
+
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		double start = getTime();
+		path.getPointsAtDistances(distances, positions);
+		seconds.push_back(getTime() - start);
+
+		for(unsigned int d = 0; d < query_count; d++)
+			distances[d] += 0.5;
+	}
+
+	printResult("SplinePath::getPoints", "closed_catmull_rom", bytes, seconds);
+}
+
+//
+//  benchmarkScriptScheduler
+//
+//  Runs SCRIPT_COUNT repeating Scripts for SCRIPT_FRAME_COUNT
+//    frames.  Each Script spends most of its time waiting, as
+//    scripted scene objects do.  The MB column is the size of
+//    the tweened values.
+//
+void benchmarkScriptScheduler (double scale)
+{
+	unsigned int script_count = (unsigned int)(SCRIPT_COUNT * scale);
+	if(script_count < 1)
+		script_count = 1;
+
+	vector<double> values(script_count, 0.0);
+	size_t bytes = script_count * sizeof(double);
+	vector<double> seconds;
+
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		ScriptScheduler scheduler;
+		for(unsigned int s = 0; s < script_count; s++)
+		{
+			Script script;
+			script.wait((s % 97) * 0.01)
+			      .tween(&(values[s]), 1.0, 0.25, Script::EASE_IN_OUT)
+			      .wait(2.0)
+			      .tween(&(values[s]), 0.0, 0.25)
+			      .repeat();
+			scheduler.start(script);
+		}
+
+		double start = getTime();
+		for(unsigned int f = 0; f < SCRIPT_FRAME_COUNT; f++)
+			scheduler.update(1.0 / 60.0);
+		seconds.push_back(getTime() - start);
+	}
+
+	printResult("ScriptScheduler::update", "60 frames", bytes, seconds);
+}
+
+//
+//  benchmarkSceneGraph
+//
+//  Updates a SceneGraph of SCENE_NODE_COUNT nodes, each with up
+//    to SCENE_CHILD_COUNT children, for SCRIPT_FRAME_COUNT
+//    frames.  In the "root" scenario, the root node moves every
+//    frame, so every world transform is recalculated.  In the
+//    "1% nodes" scenario, one node in 100 moves every frame.  In
+//    the "static" scenario, nothing moves.  The MB column is the
+//    size of the world transforms.
+//
+void benchmarkSceneGraph (double scale)
+{
+	unsigned int node_count = (unsigned int)(SCENE_NODE_COUNT * scale);
+	if(node_count < 1)
+		node_count = 1;
+
+	SceneGraph scene;
+	vector<unsigned int> nodes;
+	nodes.push_back(scene.addNode(SceneGraph::NO_NODE, Matrix44()));
+	for(unsigned int n = 1; n < node_count; n++)
+	{
+		Matrix44 local = Matrix44::getTranslation(Vector3(1.0, 0.0, 0.0)) *
+		                 Matrix44::getRotationArbitrary(Vector3::UNIT_Y_PLUS, n * 0.01);
+		nodes.push_back(scene.addNode(nodes[(n - 1) / SCENE_CHILD_COUNT], local));
+	}
+	scene.update();
+
+	size_t bytes = node_count * sizeof(Matrix44);
+	const char* a_scenarios[3] = { "root", "1% nodes", "static" };
+	for(unsigned int c = 0; c < 3; c++)
+	{
+		vector<double> seconds;
+		for(unsigned int i = 0; i < ITERATIONS; i++)
+		{
+			double start = getTime();
+			for(unsigned int f = 0; f < SCRIPT_FRAME_COUNT; f++)
+			{
+				Matrix44 local = Matrix44::getTranslation(Vector3(0.0, f * 0.01, 0.0));
+				if(c == 0)
+					scene.setLocalTransform(nodes[0], local);
+				else if(c == 1)
+				{
+					for(unsigned int n = f % 100; n < node_count; n += 100)
+						scene.setLocalTransform(nodes[n], local);
+				}
+				scene.update();
+			}
+			seconds.push_back(getTime() - start);
+		}
+
+		printResult("SceneGraph::update", a_scenarios[c], bytes, seconds);
+	}
+}
+
+//
+//  benchmarkEntitySystems
+//
+//  Runs the standard update systems on ENTITY_COUNT entities
+//    for SCRIPT_FRAME_COUNT frames.  A quarter of the entities
+//    are animated, and EMITTER_COUNT of them are particle
+//    emitters.  An extra system that only reads renderables
+//    runs in parallel with the others.  The scheduler is run
+//    with 1 thread and with as many as the hardware supports.
+//    The MB column is the size of the transforms.
+//
+void benchmarkEntitySystems (double scale)
+{
+	unsigned int entity_count = (unsigned int)(ENTITY_COUNT * scale);
+	if(entity_count < EMITTER_COUNT)
+		entity_count = EMITTER_COUNT;
+
+	AnimationPlayer player;
+	vector<double> times;
+	vector<Vector3> positions;
+	vector<Quaternion> rotations;
+	for(unsigned int k = 0; k < ANIMATION_KEY_COUNT; k++)
+	{
+		times.push_back(k * 0.25);
+		positions.push_back(Vector3(k, k * 0.5, 0.0));
+		rotations.push_back(Quaternion::getRotationArbitrary(Vector3::UNIT_Y_PLUS, k * 0.3));
+	}
+	unsigned int position_track = player.addVector3Track(times, positions, true);
+	unsigned int rotation_track = player.addRotationTrack(times, rotations, AnimationPlayer::ROTATION_NLERP, true);
+
+	EntityRegistry registry;
+	for(unsigned int e = 0; e < entity_count; e++)
+	{
+		unsigned int entity = registry.createEntity();
+		registry.add(entity, TransformComponent(Vector3(e * 0.01, 0.0, 0.0)));
+		registry.add(entity, RenderableComponent());
+		if(e % 4 == 0)
+			registry.add(entity, AnimationComponent(&player, position_track, rotation_track));
+		if(e % (entity_count / EMITTER_COUNT) == 0)
+			registry.add(entity, ParticleEmitterComponent());
+	}
+
+	SystemScheduler scheduler;
+	EntitySystems::addUpdateSystems(scheduler);
+	unsigned int visible_count = 0;
+	scheduler.addSystem("countRenderables",
+	                    EntityRegistry::COMPONENT_RENDERABLE,
+	                    0,
+	                    [&visible_count] (EntityRegistry& r_registry, double /* seconds */)
+	{
+		const ComponentPool<RenderableComponent>& renderables = r_registry.getPool<RenderableComponent>();
+		for(unsigned int r = 0; r < renderables.getCount(); r++)
+			if(renderables.getDense(r).mp_model == NULL)
+				visible_count++;
+	});
+
+	size_t bytes = entity_count * sizeof(TransformComponent);
+	vector<unsigned int> thread_counts(1, 1);
+	if(scheduler.getThreadCount() > 1)
+		thread_counts.push_back(scheduler.getThreadCount());
+	for(unsigned int c = 0; c < thread_counts.size(); c++)
+	{
+		unsigned int threads = thread_counts[c];
+		scheduler.setThreadCount(threads);
+		vector<double> seconds;
+		for(unsigned int i = 0; i < ITERATIONS; i++)
+		{
+			double start = getTime();
+			for(unsigned int f = 0; f < SCRIPT_FRAME_COUNT; f++)
+			{
+				player.update((i * SCRIPT_FRAME_COUNT + f) / 60.0);
+				scheduler.run(registry, 1.0 / 60.0);
+			}
+			seconds.push_back(getTime() - start);
+		}
+
+		stringstream scenario;
+		scenario << threads << (threads == 1 ? " thread" : " threads");
+		printResult("SystemScheduler::run", scenario.str(), bytes, seconds);
+	}
+}
+
+//
+//  benchmarkJobSystem
+//
+//  Runs two workloads on the shared JobSystem.  In the
+//    "parallelFor" scenario, a square root is taken of each
+//    element of a JOB_ARRAY_SIZE array.  In the "chains"
+//    scenario, JOB_CHAIN_COUNT chains of JOB_CHAIN_LENGTH small
+//    jobs are added, each job depending on the one before it.
+//    The number of steals is printed after each scenario.  The
+//    MB column is the size of the data touched.
+//
+void benchmarkJobSystem (double scale)
+{
+	unsigned int size = (unsigned int)(JOB_ARRAY_SIZE * scale);
+	if(size < 1)
+		size = 1;
+	unsigned int chain_count = (unsigned int)(JOB_CHAIN_COUNT * scale);
+	if(chain_count < 1)
+		chain_count = 1;
+
+	JobSystem& r_jobs = JobSystem::getShared();
+	vector<float> values(size);
+	for(unsigned int i = 0; i < size; i++)
+		values[i] = (float)(i % 1000);
+
+	vector<double> seconds;
+	r_jobs.resetStatistics();
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		double start = getTime();
+		r_jobs.parallelFor(size, 4096, r_jobs.getWorkerCount() * 4 + 1,
+		                   [&values] (unsigned int begin, unsigned int end)
+		{
+			for(unsigned int v = begin; v < end; v++)
+				values[v] = sqrt(values[v] + 1.0f);
+		});
+		seconds.push_back(getTime() - start);
+	}
+	printResult("JobSystem::parallelFor", "sqrt", size * sizeof(float), seconds);
+	cout << "  " << r_jobs.getJobsRunCount() << " jobs, "
+	     << r_jobs.getStealCount() << " steals" << endl;
+
+	vector<double> totals(chain_count);
+	seconds.clear();
+	r_jobs.resetStatistics();
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		double start = getTime();
+		for(unsigned int c = 0; c < chain_count; c++)
+		{
+			double* p_total = &(totals[c]);
+			unsigned int previous = JobSystem::NO_JOB;
+			for(unsigned int j = 0; j < JOB_CHAIN_LENGTH; j++)
+			{
+				vector<unsigned int> dependencies;
+				if(previous != JobSystem::NO_JOB)
+					dependencies.push_back(previous);
+				previous = r_jobs.add([p_total, j] () { *p_total += sqrt(j + 1.0); },
+				                      dependencies,
+				                      JobSystem::PRIORITY_NORMAL);
+			}
+		}
+		r_jobs.waitAll();
+		seconds.push_back(getTime() - start);
+	}
+	printResult("JobSystem::add", "chains", chain_count * sizeof(double), seconds);
+	cout << "  " << r_jobs.getJobsRunCount() << " jobs, "
+	     << r_jobs.getStealCount() << " steals" << endl;
+}
+
+//
+//  benchmarkAssetLoader
+//
+//  Loads a level of LEVEL_MODEL_COUNT small models that share
+//    LEVEL_LIBRARY_COUNT material libraries, each with its own
+//    texture.  In the "serial" scenario, the models are loaded
+//    one after another and then each texture is read, as
+//    happens when they are drawn for the first time.  In the
+//    "parallel" scenario, an AssetLoader is used.  The textures
+//    are only read into memory, not uploaded.  The MB column is
+//    the total size of the files.
+//
+void benchmarkAssetLoader (double scale)
+{
+	unsigned int model_count = (unsigned int)(LEVEL_MODEL_COUNT * scale);
+	if(model_count < LEVEL_LIBRARY_COUNT)
+		model_count = LEVEL_LIBRARY_COUNT;
+
+	size_t bytes = 0;
+	vector<string> texture_names;
+	for(unsigned int l = 0; l < LEVEL_LIBRARY_COUNT; l++)
+	{
+		stringstream mtl_name;
+		stringstream texture_name;
+		mtl_name     << "benchmark_level_" << l << ".mtl";
+		texture_name << "benchmark_level_" << l << ".bmp";
+		bytes += generateMtl(mtl_name.str(), 4, texture_name.str(), l + 1);
+		bytes += generateBmp(texture_name.str(), 256, 256, l + 1);
+		g_generated_files.push_back(mtl_name.str());
+		g_generated_files.push_back(texture_name.str());
+		texture_names.push_back(texture_name.str());
+	}
+
+	vector<string> model_names;
+	ObjSettings settings;
+	settings.m_vertex_count = 2000;
+	settings.m_face_count   = 4000;
+	settings.m_material_count = 4;
+	settings.m_material_switch_count = 4;
+	for(unsigned int m = 0; m < model_count; m++)
+	{
+		stringstream model_name;
+		stringstream mtl_name;
+		model_name << "benchmark_level_" << m << ".obj";
+		mtl_name   << "benchmark_level_" << (m % LEVEL_LIBRARY_COUNT) << ".mtl";
+		settings.m_seed = m + 1;
+		bytes += generateObj(model_name.str(), mtl_name.str(), settings);
+		g_generated_files.push_back(model_name.str());
+		model_names.push_back(model_name.str());
+	}
+
+	vector<double> seconds;
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		double start = getTime();
+		{
+			vector<ObjModel> models(model_count);
+			for(unsigned int m = 0; m < model_count; m++)
+			{
+				ostringstream log;
+				models[m].load(model_names[m], log);
+			}
+			for(unsigned int t = 0; t < texture_names.size(); t++)
+			{
+				ostringstream log;
+				TextureBmp texture(texture_names[t], log);
+			}
+		}
+		seconds.push_back(getTime() - start);
+		MtlLibraryManager::unloadAll();
+	}
+	printResult("AssetLoader", "serial", bytes, seconds);
+
+	seconds.clear();
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		double start = getTime();
+		{
+			AssetLoader loader;
+			for(unsigned int m = 0; m < model_count; m++)
+				loader.addModel(model_names[m]);
+			JobSystem::getShared().waitAll();
+			assert(loader.getPendingUploadCount() == LEVEL_LIBRARY_COUNT);
+		}
+		seconds.push_back(getTime() - start);
+		MtlLibraryManager::unloadAll();
+	}
+	printResult("AssetLoader", "parallel", bytes, seconds);
+}
+
+//
+//  benchmarkAssetWatcher
+//
+//  Loads a model, watches it with an AssetWatcher, and then
+//    rewrites its material library ITERATIONS times.  Each time
+//    is measured from the check until the reloaded library has
+//    replaced the old one.  Afterwards, the watched model, a
+//    copy of it that shares its geometry, and a model that is
+//    not watched must all refer to the Materials in the library
+//    with the new values.  The MB column is the size of the
+//    material library.
+//
+void benchmarkAssetWatcher ()
+{
+	ObjSettings settings;
+	settings.m_vertex_count = 2000;
+	settings.m_face_count   = 4000;
+	settings.m_material_count = WATCH_MATERIAL_COUNT;
+	settings.m_material_switch_count = WATCH_MATERIAL_COUNT;
+	generateObj(WATCH_OBJ_FILENAME, WATCH_MTL_FILENAME, settings);
+	size_t bytes = generateMtl(WATCH_MTL_FILENAME, WATCH_MATERIAL_COUNT, "", 1);
+	g_generated_files.push_back(WATCH_OBJ_FILENAME);
+	g_generated_files.push_back(WATCH_MTL_FILENAME);
+
+	vector<double> seconds;
+	{
+		ostringstream log;
+		ObjModel model(WATCH_OBJ_FILENAME, log);
+		checkResult(model.getMaterialLibraryCount() == 1 && model.getMaterialLibrary(0) != NULL,
+		            "AssetWatcher model has its material library");
+
+		ObjModel copy = model;
+		ObjModel unwatched(WATCH_OBJ_FILENAME, log);
+		const ObjModel* ap_models[3] = { &model, &copy, &unwatched };
+
+		AssetWatcher watcher;
+		watcher.watchModel(model, WATCH_OBJ_FILENAME);
+
+		for(unsigned int i = 0; i < ITERATIONS; i++)
+		{
+			// an extra material changes the size, so the change
+			//  is seen even within the same second
+			generateMtl(WATCH_MTL_FILENAME, WATCH_MATERIAL_COUNT + i + 1, "", i + 2);
+
+			double start = getTime();
+			unsigned int replaced = 0;
+			for(unsigned int tries = 0; tries < 100 && replaced == 0; tries++)
+			{
+				watcher.check();
+				JobSystem::getShared().waitAll();
+				replaced = watcher.update(0.0);
+			}
+			seconds.push_back(getTime() - start);
+			checkResult(replaced == 1, "AssetWatcher reloads the changed material library");
+
+			// every model must use the Materials in the library,
+			//  and they must have the new values
+			const MtlLibrary* p_library = model.getMaterialLibrary(0);
+			checkResult(p_library != NULL && p_library->getMaterialCount() == WATCH_MATERIAL_COUNT + i + 1,
+			            "AssetWatcher replaces the material library in place");
+			if(p_library == NULL)
+				break;
+			MtlLibrary expected(WATCH_MTL_FILENAME, log);
+			for(unsigned int j = 0; j < 3; j++)
+			{
+				const ObjModel& r_model = *(ap_models[j]);
+				for(unsigned int m = 0; m < r_model.getMeshCount(); m++)
+				{
+					if(!r_model.isMeshMaterial(m))
+						continue;
+					const string& name = r_model.getMeshMaterialName(m);
+					checkResult(r_model.getMeshMaterial(m) == p_library->getMaterial(name),
+					            "AssetWatcher keeps the Material for " + name);
+					checkResult(r_model.getMeshMaterial(m)->getDiffuse() == expected.getMaterial(name)->getDiffuse(),
+					            "AssetWatcher updates the Material for " + name);
+				}
+			}
+		}
+	}
+	MtlLibraryManager::unloadAll();
+	printResult("AssetWatcher::update", "material library", bytes, seconds);
+}
+
+//
+//  benchmarkObjModelManager
+//
+//  Places the same prop PROP_INSTANCE_COUNT times.  In the
+//    "load each" scenario, every instance loads the file
+//    itself.  In the "shared" scenario, the prop is loaded once
+//    through the ObjModelManager and every instance is a copy
+//    of it.  In the "first change" scenario, one vertex of each
+//    shared instance is moved, which makes each one copy the
+//    geometry.  The MB column is the size of the file times the
+//    number of instances.
+//
+void benchmarkObjModelManager (double scale)
+{
+	unsigned int instance_count = (unsigned int)(PROP_INSTANCE_COUNT * scale);
+	if(instance_count < 1)
+		instance_count = 1;
+
+	ObjSettings settings;
+	settings.m_vertex_count = 2000;
+	settings.m_face_count   = 4000;
+	size_t bytes = generateObj(PROP_FILENAME, MTL_FILENAME, settings) * instance_count;
+	g_generated_files.push_back(PROP_FILENAME);
+
+	vector<double> seconds;
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		double start = getTime();
+		{
+			vector<ObjModel> instances(instance_count);
+			for(unsigned int m = 0; m < instance_count; m++)
+			{
+				ostringstream log;
+				instances[m].load(PROP_FILENAME, log);
+			}
+		}
+		seconds.push_back(getTime() - start);
+	}
+	printResult("ObjModelManager", "load each", bytes, seconds);
+
+	vector<double> change_seconds;
+	seconds.clear();
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		double start = getTime();
+		ostringstream log;
+		const ObjModel& prop = ObjModelManager::get(PROP_FILENAME, log);
+		vector<ObjModel> instances(instance_count, prop);
+		seconds.push_back(getTime() - start);
+
+		start = getTime();
+		for(unsigned int m = 0; m < instance_count; m++)
+			instances[m].setVertexX(0, m);
+		change_seconds.push_back(getTime() - start);
+
+		ObjModelManager::unloadAll();
+	}
+	printResult("ObjModelManager", "shared",       bytes, seconds);
+	printResult("ObjModelManager", "first change", bytes, change_seconds);
+	MtlLibraryManager::unloadAll();
+}
+
+//
+//  benchmarkOcclusionCuller
+//
+//  Tests CULL_BOX_COUNT small bounding boxes scattered along a
+//    street lined with CULL_WALL_COUNT walls, as seen from one
+//    end of it.  The "rasterize" scenario draws the walls into
+//    the depth buffer and builds the Hi-Z pyramid.  The "test"
+//    scenario tests all the bounding boxes in one batch.  The
+//    MB column is the size of the depth buffer or of the
+//    bounding boxes.  Afterwards, a box behind a wall that
+//    fills the screen must be reported as hidden, which needs
+//    the pixels on the edge between the wall's triangles to be
+//    drawn.
+//
+void benchmarkOcclusionCuller (double scale)
+{
+	unsigned int box_count = (unsigned int)(CULL_BOX_COUNT * scale);
+	if(box_count < 1)
+		box_count = 1;
+
+	Vector3Array<float> box_mins(box_count);
+	Vector3Array<float> box_maxes(box_count);
+	for(unsigned int b = 0; b < box_count; b++)
+	{
+		// spread out in a repeatable pattern
+		double x = fmod(b * 7.31, 60.0) - 30.0;
+		double y = fmod(b * 0.37, 3.0);
+		double z = -2.0 - fmod(b * 13.17, 150.0);
+		box_mins .set(b, Vector3(x, y, z));
+		box_maxes.set(b, Vector3(x + 1.0, y + 1.0, z + 1.0));
+	}
+
+	Matrix44 view = Matrix44::getLookAt(Vector3(0.0, 1.5, 0.0),
+	                                    Vector3(0.0, 1.5, -1.0),
+	                                    Vector3::UNIT_Y_PLUS);
+	Matrix44 projection = Matrix44::getPerspective(60.0, 2.0, 0.5, 200.0);
+	OcclusionCuller culler;
+
+	vector<double> seconds;
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		double start = getTime();
+		for(unsigned int f = 0; f < SCRIPT_FRAME_COUNT; f++)
+		{
+			culler.beginFrame(projection * view);
+			for(unsigned int w = 0; w < CULL_WALL_COUNT; w++)
+			{
+				// walls on alternate sides, some across the street
+				double z = -5.0 - w * 3.5;
+				double x = (w % 2 == 0) ? -12.0 : 2.0;
+				if(w % 5 == 4)
+					x = -5.0;
+				culler.addOccluderBox(Vector3(x,        0.0, z),
+				                      Vector3(x + 10.0, 8.0, z + 0.5));
+			}
+			culler.rasterize();
+		}
+		seconds.push_back(getTime() - start);
+	}
+	size_t depth_bytes = culler.getWidth() * culler.getHeight() * sizeof(float);
+	printResult("OcclusionCuller", "rasterize", depth_bytes * SCRIPT_FRAME_COUNT, seconds);
+
+	vector<unsigned char> visible;
+	seconds.clear();
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		culler.resetStatistics();
+		double start = getTime();
+		culler.testBoxes(box_mins, box_maxes, visible);
+		seconds.push_back(getTime() - start);
+	}
+	printResult("OcclusionCuller", "test", box_count * 6 * sizeof(float), seconds);
+	cout << "  " << culler.getOccludedCount() << " occluded, "
+	     << culler.getOutsideCount() << " outside of "
+	     << box_count << " boxes" << endl;
+
+	// with a square depth buffer, the diagonal of the wall
+	//  passes through pixel centres
+	OcclusionCuller square(CULL_CHECK_SIZE, CULL_CHECK_SIZE);
+	square.beginFrame(Matrix44());
+	square.addOccluderBox(Vector3(-1.0, -1.0, -0.5), Vector3(1.0, 1.0, 0.0));
+	square.rasterize();
+	checkResult(!square.isVisible(Vector3(-0.5, -0.5, 0.5), Vector3(0.5, 0.5, 0.6)),
+	            "OcclusionCuller hides a box behind a full-screen wall");
+}
+
+//
+//  benchmarkLodSelector
+//
+//  Chooses levels of detail for LOD_INSTANCE_COUNT instances of
+//    a model with 4 levels, spread over a square grid, for
+//    SCRIPT_FRAME_COUNT frames.  In the "moving" scenario, the
+//    camera moves across the grid, so some instances change
+//    level every frame.  In the "static" scenario, the camera
+//    does not move.  The MB column is the size of the instance
+//    positions.
+//
+void benchmarkLodSelector (double scale)
+{
+	unsigned int instance_count = (unsigned int)(LOD_INSTANCE_COUNT * scale);
+	if(instance_count < 1)
+		instance_count = 1;
+
+	ObjSettings settings;
+	settings.m_vertex_count = 200;
+	settings.m_face_count   = 400;
+	generateObj(PROP_FILENAME, MTL_FILENAME, settings);
+	g_generated_files.push_back(PROP_FILENAME);
+	ObjModel prop;
+	ostringstream log;
+	prop.load(PROP_FILENAME, log);
+
+	LodSelector selector;
+	unsigned int model = selector.addModel(&prop);
+	selector.addLevel(model, &prop, 200.0);
+	selector.addLevel(model, &prop, 50.0);
+	selector.addLevel(model, NULL, 4.0);
+	unsigned int side = (unsigned int)(sqrt((double)(instance_count))) + 1;
+	for(unsigned int i = 0; i < instance_count; i++)
+	{
+		Vector3 position((i % side) * 10.0, 0.0, (i / side) * 10.0);
+		selector.addInstance(model, Matrix44::getTranslation(position));
+	}
+	selector.update(Vector3::ZERO);
+
+	size_t bytes = instance_count * 3 * sizeof(float);
+	const char* a_scenarios[2] = { "moving", "static" };
+	for(unsigned int c = 0; c < 2; c++)
+	{
+		vector<double> seconds;
+		unsigned int change_count = 0;
+		for(unsigned int i = 0; i < ITERATIONS; i++)
+		{
+			change_count = 0;
+			double start = getTime();
+			for(unsigned int f = 0; f < SCRIPT_FRAME_COUNT; f++)
+			{
+				double offset = (c == 0) ? (i * SCRIPT_FRAME_COUNT + f) * 2.0 : 0.0;
+				selector.update(Vector3(offset, 2.0, offset));
+				change_count += selector.getChangeCount();
+			}
+			seconds.push_back(getTime() - start);
+		}
+		printResult("LodSelector::update", a_scenarios[c], bytes * SCRIPT_FRAME_COUNT, seconds);
+		cout << "  " << change_count << " level changes, "
+		     << selector.getLevelInstanceCount(0) << "/"
+		     << selector.getLevelInstanceCount(1) << "/"
+		     << selector.getLevelInstanceCount(2) << "/"
+		     << selector.getLevelInstanceCount(3) << " per level" << endl;
+	}
+}
+
+void benchmarkAssetArchive (double scale)
+{
+	unsigned int file_count = (unsigned int)(ARCHIVE_FILE_COUNT * scale);
+	if(file_count < 1)
+		file_count = 1;
+
+	// many small files, where opening them costs more than parsing
+	vector<string> v_names;
+	size_t bytes = 0;
+	for(unsigned int i = 0; i < file_count; i++)
+	{
+		stringstream name;
+		name << "benchmark_small_" << i << ".mtl";
+		bytes += generateMtl(name.str(), 2, "", i);
+		v_names.push_back(name.str());
+		g_generated_files.push_back(name.str());
+	}
+
+	ostringstream log;
+	AssetArchive::build("", v_names, ARCHIVE_FILENAME, log);
+	g_generated_files.push_back(ARCHIVE_FILENAME);
+
+	const char* a_scenarios[2] = { "small files", "small archived" };
+	for(unsigned int c = 0; c < 2; c++)
+	{
+		vector<double> seconds;
+		for(unsigned int i = 0; i < ITERATIONS; i++)
+		{
+			double start = getTime();
+			if(c == 1)
+				AssetFileSystem::mount(ARCHIVE_FILENAME);
+			for(unsigned int f = 0; f < file_count; f++)
+			{
+				MtlLibrary library;
+				library.load(v_names[f], log);
+			}
+			if(c == 1)
+				AssetFileSystem::unmountAll();
+			seconds.push_back(getTime() - start);
+		}
+		printResult("MtlLibrary::load", a_scenarios[c], bytes, seconds);
+	}
+}
+
+void benchmarkObjStream (const Scenario& scenario)
+{
+	// the scenario file was generated by benchmarkObjModel
+	string filename = scenario.m_name + ".obj";
+	size_t bytes = getFileSize(filename);
+	g_generated_files.push_back(BINARY_FILENAME);
+
+	Matrix44 matrix = Matrix44::getRotationArbitrary(Vector3(1.0, 2.0, 3.0).getNormalized(), 0.5);
+	vector<double> open_seconds;
+	vector<double> transform_seconds;
+	vector<double> save_seconds;
+	vector<double> load_seconds;
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		ostringstream log;
+		ObjStream stream;
+
+		double start = getTime();
+		stream.open(filename, SPILL_PREFIX, log);
+		open_seconds.push_back(getTime() - start);
+
+		start = getTime();
+		stream.transform(matrix);
+		transform_seconds.push_back(getTime() - start);
+
+		start = getTime();
+		stream.saveBinary(BINARY_FILENAME);
+		save_seconds.push_back(getTime() - start);
+
+		ObjModel model;
+		start = getTime();
+		model.loadBinary(BINARY_FILENAME, log);
+		load_seconds.push_back(getTime() - start);
+	}
+
+	size_t binary_bytes = getFileSize(BINARY_FILENAME);
+	printResult("ObjStream::open",       scenario.m_name, bytes,        open_seconds);
+	printResult("ObjStream::transform",  scenario.m_name, binary_bytes, transform_seconds);
+	printResult("ObjStream::saveBinary", scenario.m_name, binary_bytes, save_seconds);
+	printResult("ObjModel::loadBinary",  scenario.m_name, binary_bytes, load_seconds);
+
+	// a truncated file with huge counts must fail cleanly
+	//  instead of allocating for them
+	string contents;
+	AssetFileSystem::readFile(BINARY_FILENAME, contents);
+	checkResult(contents.size() >= 200, "ObjStream::saveBinary writes the model");
+	if(contents.size() < 200)
+		return;
+	contents.resize(200);
+
+	ostringstream log;
+	ObjModel model;
+	unsigned long long vertex_count = 3000000000ull;
+	memcpy(&(contents[offsetof(ObjStream::BinaryHeader, m_vertex_count)]), &vertex_count, sizeof(vertex_count));
+	writeFile(BINARY_FILENAME, contents);
+	model.loadBinary(BINARY_FILENAME, log);
+	checkResult(!model.isLoadedSuccessfully(), "ObjModel::loadBinary rejects a truncated file");
+
+	unsigned int library_count = UINT_MAX;
+	memcpy(&(contents[offsetof(ObjStream::BinaryHeader, m_material_library_count)]), &library_count, sizeof(library_count));
+	writeFile(BINARY_FILENAME, contents);
+	model.loadBinary(BINARY_FILENAME, log);
+	checkResult(!model.isLoadedSuccessfully(), "ObjModel::loadBinary rejects a bad library count");
+}
+
+//
+//  benchmarkProgressiveModel
+//
+//  Builds a progressive model file from a rolling terrain grid
+//    of PROGRESSIVE_GRID_SIDE squares on a side, simplified to
+//    PROGRESSIVE_BASE_FACE_COUNT faces.  Then times how long
+//    opening the file takes before the base mesh can be
+//    displayed, and how long it takes to read and apply all
+//    the vertex splits.  The build is only timed once.  The MB
+//    column is the size of the file.
+//
+void benchmarkProgressiveModel (double scale)
+{
+	unsigned int side = (unsigned int)(PROGRESSIVE_GRID_SIDE * sqrt(scale));
+	if(side < 2)
+		side = 2;
+
+	ObjModel terrain;
+	for(unsigned int z = 0; z <= side; z++)
+		for(unsigned int x = 0; x <= side; x++)
+			terrain.addVertex(x, sin(x * 0.05) * cos(z * 0.07) * 10.0, z);
+	unsigned int mesh = terrain.addMesh();
+	for(unsigned int z = 0; z < side; z++)
+		for(unsigned int x = 0; x < side; x++)
+		{
+			ObjModel::Index corner = z * (side + 1) + x;
+			unsigned int face = terrain.addFace(mesh);
+			terrain.addFaceVertex(mesh, face, corner,            ObjModel::NO_TEXTURE_COORDINATES, ObjModel::NO_NORMAL);
+			terrain.addFaceVertex(mesh, face, corner + side + 1, ObjModel::NO_TEXTURE_COORDINATES, ObjModel::NO_NORMAL);
+			terrain.addFaceVertex(mesh, face, corner + side + 2, ObjModel::NO_TEXTURE_COORDINATES, ObjModel::NO_NORMAL);
+			terrain.addFaceVertex(mesh, face, corner + 1,        ObjModel::NO_TEXTURE_COORDINATES, ObjModel::NO_NORMAL);
+		}
+
+	ostringstream log;
+	double start = getTime();
+	ProgressiveModel::build(terrain, PROGRESSIVE_FILENAME, PROGRESSIVE_BASE_FACE_COUNT, log);
+	vector<double> build_seconds(1, getTime() - start);
+	g_generated_files.push_back(PROGRESSIVE_FILENAME);
+	size_t bytes = getFileSize(PROGRESSIVE_FILENAME);
+
+	vector<double> open_seconds;
+	vector<double> update_seconds;
+	unsigned int base_face_count = 0;
+	unsigned int full_face_count = 0;
+	for(unsigned int i = 0; i < ITERATIONS; i++)
+	{
+		ProgressiveModel progressive;
+
+		start = getTime();
+		progressive.open(PROGRESSIVE_FILENAME, log);
+		open_seconds.push_back(getTime() - start);
+		base_face_count = progressive.getModel().getFaceCountTotal();
+
+		start = getTime();
+		while(!progressive.isFullyLoaded() && !progressive.isFailed())
+			progressive.update(UINT_MAX);
+		update_seconds.push_back(getTime() - start);
+		full_face_count = progressive.getModel().getFaceCountTotal();
+	}
+
+	printResult("Progressive::build",  "terrain",     bytes, build_seconds);
+	printResult("Progressive::open",   "base mesh",   bytes, open_seconds);
+	printResult("Progressive::update", "full detail", bytes, update_seconds);
+	cout << "  " << base_face_count << " base faces, "
+	     << full_face_count << " full faces" << endl;
+
+	// a file cut off in the vertex splits opens, but then
+	//  fails while reading them
+	string contents;
+	AssetFileSystem::readFile(PROGRESSIVE_FILENAME, contents);
+	checkResult(contents.size() >= 200, "ProgressiveModel::build writes the file");
+	if(contents.size() < 200)
+		return;
+	writeFile(PROGRESSIVE_FILENAME, contents.substr(0, contents.size() - 1));
+	{
+		ProgressiveModel progressive;
+		checkResult(progressive.open(PROGRESSIVE_FILENAME, log), "Progressive::open reads the base mesh");
+		while(!progressive.isFullyLoaded() && !progressive.isFailed())
+			progressive.update(UINT_MAX);
+		checkResult(progressive.isFailed(), "Progressive::update fails on truncated splits");
+	}
+
+	// a truncated file with huge counts must fail cleanly
+	//  instead of allocating for them; the material library
+	//  and mesh counts follow the magic number and version
+	contents.resize(200);
+	const size_t LIBRARY_COUNT_OFFSET = 8;
+	const size_t MESH_COUNT_OFFSET    = 12;
+	unsigned int huge_count = UINT_MAX;
+	for(unsigned int i = 0; i < 2; i++)
+	{
+		string corrupt = contents;
+		memcpy(&(corrupt[i == 0 ? LIBRARY_COUNT_OFFSET : MESH_COUNT_OFFSET]), &huge_count, sizeof(huge_count));
+		writeFile(PROGRESSIVE_FILENAME, corrupt);
+		ProgressiveModel progressive;
+		checkResult(!progressive.open(PROGRESSIVE_FILENAME, log), "Progressive::open rejects a bad count");
+	}
+}
@@ -0,0 +1,376 @@
+//
+//  AnimationPlayer.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#include "Vector3.h"
+#include "Vector3Array.h"
+#include "Quaternion.h"
+#include "SimdKernels.h"
+#include "AnimationPlayer.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	float* getPointer (vector<float>& rv_values)
+	{
+		return rv_values.empty() ? NULL : &(rv_values[0]);
+	}
+}
+
+
+
+const unsigned int AnimationPlayer :: ROTATION_NLERP;
+const unsigned int AnimationPlayer :: ROTATION_SLERP;
+
+
+
+AnimationPlayer :: AnimationPlayer ()
+		: m_time(0.0)
+{
+}
+
+
+
+Vector3 AnimationPlayer :: getVector3 (unsigned int track) const
+{
+	assert(track < getVector3TrackCount());
+
+	return m_vector3_results.get(track);
+}
+
+Quaternion AnimationPlayer :: getRotation (unsigned int track) const
+{
+	assert(track < getRotationTrackCount());
+
+	return Quaternion(mv_rotation_results_w[track],
+	                  mv_rotation_results_x[track],
+	                  mv_rotation_results_y[track],
+	                  mv_rotation_results_z[track]);
+}
+
+double AnimationPlayer :: getVector3TrackDuration (unsigned int track) const
+{
+	assert(track < getVector3TrackCount());
+
+	const Track& info = mv_vector3_tracks[track];
+	return mv_vector3_times[info.m_first_key + info.m_key_count - 1] -
+	       mv_vector3_times[info.m_first_key];
+}
+
+double AnimationPlayer :: getRotationTrackDuration (unsigned int track) const
+{
+	assert(track < getRotationTrackCount());
+
+	const Track& info = mv_rotation_tracks[track];
+	return mv_rotation_times[info.m_first_key + info.m_key_count - 1] -
+	       mv_rotation_times[info.m_first_key];
+}
+
+
+
+unsigned int AnimationPlayer :: addVector3Track (const vector<double>& times,
+                                                 const vector<Vector3>& values,
+                                                 bool is_looping)
+{
+	assert(!times.empty());
+	assert(values.size() == times.size());
+
+	Track track;
+	track.m_first_key     = (unsigned int)(mv_vector3_times.size());
+	track.m_key_count     = (unsigned int)(times.size());
+	track.m_last_key      = 0;
+	track.m_interpolation = ROTATION_NLERP;  // not used
+	track.m_is_looping    = is_looping;
+
+	for(unsigned int i = 0; i < times.size(); i++)
+	{
+		assert(i == 0 || times[i] > times[i - 1]);
+		mv_vector3_times.push_back(times[i]);
+		m_vector3_keys.pushBack(values[i]);
+	}
+
+	mv_vector3_tracks.push_back(track);
+	m_vector3_results.pushBack(values[0]);
+	return (unsigned int)(mv_vector3_tracks.size() - 1);
+}
+
+unsigned int AnimationPlayer :: addRotationTrack (const vector<double>& times,
+                                                  const vector<Quaternion>& values,
+                                                  unsigned int interpolation,
+                                                  bool is_looping)
+{
+	assert(!times.empty());
+	assert(values.size() == times.size());
+	assert(interpolation == ROTATION_NLERP || interpolation == ROTATION_SLERP);
+
+	Track track;
+	track.m_first_key     = (unsigned int)(mv_rotation_times.size());
+	track.m_key_count     = (unsigned int)(times.size());
+	track.m_last_key      = 0;
+	track.m_interpolation = interpolation;
+	track.m_is_looping    = is_looping;
+
+	for(unsigned int i = 0; i < times.size(); i++)
+	{
+		assert(i == 0 || times[i] > times[i - 1]);
+		assert(values[i].isNormal());
+		mv_rotation_times.push_back(times[i]);
+		mv_rotation_keys_w.push_back((float)(values[i].w));
+		mv_rotation_keys_x.push_back((float)(values[i].x));
+		mv_rotation_keys_y.push_back((float)(values[i].y));
+		mv_rotation_keys_z.push_back((float)(values[i].z));
+	}
+
+	mv_rotation_tracks.push_back(track);
+	mv_rotation_results_w.push_back((float)(values[0].w));
+	mv_rotation_results_x.push_back((float)(values[0].x));
+	mv_rotation_results_y.push_back((float)(values[0].y));
+	mv_rotation_results_z.push_back((float)(values[0].z));
+	return (unsigned int)(mv_rotation_tracks.size() - 1);
+}
+
+void AnimationPlayer :: clear ()
+{
+	m_time = 0.0;
+
+	mv_vector3_tracks.clear();
+	mv_vector3_times.clear();
+	m_vector3_keys.clear();
+	m_vector3_results.clear();
+
+	mv_rotation_tracks.clear();
+	mv_rotation_times.clear();
+	mv_rotation_keys_w.clear();
+	mv_rotation_keys_x.clear();
+	mv_rotation_keys_y.clear();
+	mv_rotation_keys_z.clear();
+	mv_rotation_results_w.clear();
+	mv_rotation_results_x.clear();
+	mv_rotation_results_y.clear();
+	mv_rotation_results_z.clear();
+}
+
+void AnimationPlayer :: update (double time)
+{
+	const SimdKernels::Table<float>& table = SimdKernels::getTable<float>();
+
+	m_time = time;
+
+	//
+	//  Each update has two passes.  First, the keys for every
+	//    track are found and copied into the scratch arrays.
+	//    Then all the tracks are interpolated together.
+	//
+
+	unsigned int vector3_count = getVector3TrackCount();
+	if(vector3_count > 0)
+	{
+		m_scratch_from.resize(vector3_count);
+		m_scratch_to.resize(vector3_count);
+		mv_scratch_fractions.resize(vector3_count);
+
+		const float* a_key_x = m_vector3_keys.getArrayX();
+		const float* a_key_y = m_vector3_keys.getArrayY();
+		const float* a_key_z = m_vector3_keys.getArrayZ();
+		float* a_from_x = m_scratch_from.getArrayX();
+		float* a_from_y = m_scratch_from.getArrayY();
+		float* a_from_z = m_scratch_from.getArrayZ();
+		float* a_to_x = m_scratch_to.getArrayX();
+		float* a_to_y = m_scratch_to.getArrayY();
+		float* a_to_z = m_scratch_to.getArrayZ();
+		float* a_fractions = getPointer(mv_scratch_fractions);
+
+		for(unsigned int i = 0; i < vector3_count; i++)
+		{
+			Track& r_track = mv_vector3_tracks[i];
+			unsigned int from = r_track.m_first_key +
+			                    findKey(&(mv_vector3_times[0]), r_track, time, a_fractions[i]);
+			unsigned int to = (r_track.m_key_count > 1) ? from + 1 : from;
+
+			a_from_x[i] = a_key_x[from];
+			a_from_y[i] = a_key_y[from];
+			a_from_z[i] = a_key_z[from];
+			a_to_x[i] = a_key_x[to];
+			a_to_y[i] = a_key_y[to];
+			a_to_z[i] = a_key_z[to];
+		}
+
+		table.lerp(vector3_count, a_from_x, a_to_x, a_fractions, m_vector3_results.getArrayX());
+		table.lerp(vector3_count, a_from_y, a_to_y, a_fractions, m_vector3_results.getArrayY());
+		table.lerp(vector3_count, a_from_z, a_to_z, a_fractions, m_vector3_results.getArrayZ());
+	}
+
+	unsigned int rotation_count = getRotationTrackCount();
+	if(rotation_count > 0)
+	{
+		m_scratch_from.resize(rotation_count);
+		m_scratch_to.resize(rotation_count);
+		mv_scratch_from_w.resize(rotation_count);
+		mv_scratch_to_w.resize(rotation_count);
+		mv_scratch_fractions.resize(rotation_count);
+
+		const float* a_key_w = getPointer(mv_rotation_keys_w);
+		const float* a_key_x = getPointer(mv_rotation_keys_x);
+		const float* a_key_y = getPointer(mv_rotation_keys_y);
+		const float* a_key_z = getPointer(mv_rotation_keys_z);
+		float* a_from_w = getPointer(mv_scratch_from_w);
+		float* a_from_x = m_scratch_from.getArrayX();
+		float* a_from_y = m_scratch_from.getArrayY();
+		float* a_from_z = m_scratch_from.getArrayZ();
+		float* a_to_w = getPointer(mv_scratch_to_w);
+		float* a_to_x = m_scratch_to.getArrayX();
+		float* a_to_y = m_scratch_to.getArrayY();
+		float* a_to_z = m_scratch_to.getArrayZ();
+		float* a_fractions = getPointer(mv_scratch_fractions);
+		float* a_result_w = getPointer(mv_rotation_results_w);
+		float* a_result_x = getPointer(mv_rotation_results_x);
+		float* a_result_y = getPointer(mv_rotation_results_y);
+		float* a_result_z = getPointer(mv_rotation_results_z);
+		bool is_any_slerp = false;
+
+		for(unsigned int i = 0; i < rotation_count; i++)
+		{
+			Track& r_track = mv_rotation_tracks[i];
+			unsigned int from = r_track.m_first_key +
+			                    findKey(&(mv_rotation_times[0]), r_track, time, a_fractions[i]);
+			unsigned int to = (r_track.m_key_count > 1) ? from + 1 : from;
+
+			// use -to if it is closer, to take the shortest path
+			float sign = 1.0f;
+			if(a_key_w[from] * a_key_w[to] + a_key_x[from] * a_key_x[to] +
+			   a_key_y[from] * a_key_y[to] + a_key_z[from] * a_key_z[to] < 0.0f)
+			{
+				sign = -1.0f;
+			}
+
+			a_from_w[i] = a_key_w[from];
+			a_from_x[i] = a_key_x[from];
+			a_from_y[i] = a_key_y[from];
+			a_from_z[i] = a_key_z[from];
+			a_to_w[i] = a_key_w[to] * sign;
+			a_to_x[i] = a_key_x[to] * sign;
+			a_to_y[i] = a_key_y[to] * sign;
+			a_to_z[i] = a_key_z[to] * sign;
+
+			if(r_track.m_interpolation == ROTATION_SLERP)
+				is_any_slerp = true;
+		}
+
+		// nlerp every track in one batch
+		table.lerp(rotation_count, a_from_w, a_to_w, a_fractions, a_result_w);
+		table.lerp(rotation_count, a_from_x, a_to_x, a_fractions, a_result_x);
+		table.lerp(rotation_count, a_from_y, a_to_y, a_fractions, a_result_y);
+		table.lerp(rotation_count, a_from_z, a_to_z, a_fractions, a_result_z);
+		table.normalize4(rotation_count,
+		                 a_result_w, a_result_x, a_result_y, a_result_z,
+		                 a_result_w, a_result_x, a_result_y, a_result_z);
+
+		// then replace the results for the slerp tracks
+		if(is_any_slerp)
+		{
+			for(unsigned int i = 0; i < rotation_count; i++)
+			{
+				if(mv_rotation_tracks[i].m_interpolation != ROTATION_SLERP)
+					continue;
+
+				Quaternion from(a_from_w[i], a_from_x[i], a_from_y[i], a_from_z[i]);
+				Quaternion to  (a_to_w[i],   a_to_x[i],   a_to_y[i],   a_to_z[i]);
+				Quaternion result = Quaternion::getSlerp(from.getNormalized(),
+				                                         to.getNormalized(),
+				                                         a_fractions[i]);
+				a_result_w[i] = (float)(result.w);
+				a_result_x[i] = (float)(result.x);
+				a_result_y[i] = (float)(result.y);
+				a_result_z[i] = (float)(result.z);
+			}
+		}
+	}
+}
+
+
+
+unsigned int AnimationPlayer :: findKey (const double* a_times,
+                                         Track& r_track,
+                                         double time,
+                                         float& r_fraction)
+{
+	assert(a_times != NULL);
+	assert(r_track.m_key_count >= 1);
+
+	if(r_track.m_key_count == 1)
+	{
+		r_track.m_last_key = 0;
+		r_fraction = 0.0f;
+		return 0;
+	}
+
+	const double* a_track_times = a_times + r_track.m_first_key;
+	unsigned int last = r_track.m_key_count - 1;
+	double start = a_track_times[0];
+	double end   = a_track_times[last];
+
+	if(r_track.m_is_looping)
+	{
+		double duration = end - start;
+		time = start + fmod(time - start, duration);
+		if(time < start)
+			time += duration;
+	}
+
+	// written this way so NaN uses the first key
+	if(!(time > start))
+	{
+		r_track.m_last_key = 0;
+		r_fraction = 0.0f;
+		return 0;
+	}
+	if(time >= end)
+	{
+		r_track.m_last_key = last - 1;
+		r_fraction = 1.0f;
+		return last - 1;
+	}
+
+	// try the previous key, then the one after it, then search
+	unsigned int key = r_track.m_last_key;
+	assert(key < last);
+	if(time >= a_track_times[key] && time < a_track_times[key + 1])
+		;  // same key as last time
+	else if(key + 2 <= last &&
+	        time >= a_track_times[key + 1] && time < a_track_times[key + 2])
+	{
+		key++;
+	}
+	else
+	{
+		key = (unsigned int)(upper_bound(a_track_times, a_track_times + last + 1, time) -
+		                     a_track_times) - 1;
+	}
+	assert(key < last);
+
+	r_track.m_last_key = key;
+	r_fraction = (float)((time - a_track_times[key]) /
+	                     (a_track_times[key + 1] - a_track_times[key]));
+	return key;
+}
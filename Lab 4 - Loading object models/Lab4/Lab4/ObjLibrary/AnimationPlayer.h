@@ -0,0 +1,345 @@
+//
+//  AnimationPlayer.h
+//
+//  A module to evaluate many keyframe animation tracks at
+//    once.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_ANIMATION_PLAYER_H
+#define OBJ_LIBRARY_ANIMATION_PLAYER_H
+
+#include <vector>
+
+#include "Vector3.h"
+#include "Vector3Array.h"
+#include "Quaternion.h"
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  AnimationPlayer
+//
+//  A class to store and evaluate keyframe animation tracks.
+//    There are two kinds of track:
+//      <1> Vector3 tracks, used for positions, scales, and
+//          colours.  These are linearly interpolated.
+//      <2> Rotation tracks of Quaternions.  These are
+//          interpolated with either nlerp or slerp.
+//    Each track has its own list of key times and values.
+//
+//  All the tracks are evaluated together by calling update.
+//    The tracks are stored as structures of arrays, and the
+//    interpolation is done in batches with the kernels from
+//    SimdKernels.h.  Finding the current key for each track is
+//    usually O(1): the key found last time is remembered, and
+//    the following key is checked next.  A binary search is
+//    only needed when the time jumps.  The results are stored
+//    as floats.
+//
+//  Tracks are identified by the index returned when they are
+//    added.  Vector3 tracks and rotation tracks are numbered
+//    seperately, both starting at 0.
+//
+class AnimationPlayer
+{
+public:
+//
+//  ROTATION_NLERP
+//
+//  A constant indicating that a rotation track is to be
+//    interpolated with normalized linear interpolation.  This
+//    is fast and close to slerp for closely-spaced keys.
+//
+	static const unsigned int ROTATION_NLERP = 0;
+
+//
+//  ROTATION_SLERP
+//
+//  A constant indicating that a rotation track is to be
+//    interpolated with spherical linear interpolation.  This
+//    gives a constant rotation speed between keys, but it is
+//    calculated one track at a time.
+//
+	static const unsigned int ROTATION_SLERP = 1;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new AnimationPlayer with no tracks.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new AnimationPlayer is created.  The time is
+//               set to 0.0.
+//
+	AnimationPlayer ();
+
+//
+//  getTime
+//
+//  Purpose: To determine the time the tracks were last
+//           evaluated at.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The time passed to the last call to update, or 0.0
+//           if update has not been called.
+//  Side Effect: N/A
+//
+	double getTime () const
+	{ return m_time; }
+
+//
+//  getVector3TrackCount
+//
+//  Purpose: To determine the number of Vector3 tracks.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of Vector3 tracks.
+//  Side Effect: N/A
+//
+	unsigned int getVector3TrackCount () const
+	{ return (unsigned int)(mv_vector3_tracks.size()); }
+
+//
+//  getRotationTrackCount
+//
+//  Purpose: To determine the number of rotation tracks.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of rotation tracks.
+//  Side Effect: N/A
+//
+	unsigned int getRotationTrackCount () const
+	{ return (unsigned int)(mv_rotation_tracks.size()); }
+
+//
+//  getVector3
+//
+//  Purpose: To retrieve the current value of a Vector3 track.
+//  Parameter(s):
+//    <1> track: Which track
+//  Precondition(s):
+//    <1> track < getVector3TrackCount()
+//  Returns: The value of track track at the time of the last
+//           call to update.  If update has not been called
+//           since the track was added, the first key value is
+//           returned.
+//  Side Effect: N/A
+//
+	Vector3 getVector3 (unsigned int track) const;
+
+//
+//  getVector3Results
+//
+//  Purpose: To retrieve the current values of all Vector3
+//           tracks.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: A Vector3Array containing one element for each
+//           Vector3 track.  Element i is the value of track i,
+//           as returned by getVector3.
+//  Side Effect: N/A
+//
+	const Vector3Array<float>& getVector3Results () const
+	{ return m_vector3_results; }
+
+//
+//  getRotation
+//
+//  Purpose: To retrieve the current value of a rotation track.
+//  Parameter(s):
+//    <1> track: Which track
+//  Precondition(s):
+//    <1> track < getRotationTrackCount()
+//  Returns: The value of track track at the time of the last
+//           call to update.  If update has not been called
+//           since the track was added, the first key value is
+//           returned.
+//  Side Effect: N/A
+//
+	Quaternion getRotation (unsigned int track) const;
+
+//
+//  getVector3TrackDuration
+//  getRotationTrackDuration
+//
+//  Purpose: To determine the length of time covered by the
+//           keys of a track.
+//  Parameter(s):
+//    <1> track: Which track
+//  Precondition(s):
+//    <1> track < getVector3TrackCount() /
+//        track < getRotationTrackCount()
+//  Returns: The time of the last key minus the time of the
+//           first key.
+//  Side Effect: N/A
+//
+	double getVector3TrackDuration (unsigned int track) const;
+	double getRotationTrackDuration (unsigned int track) const;
+
+//
+//  addVector3Track
+//
+//  Purpose: To add a linearly-interpolated Vector3 track.
+//  Parameter(s):
+//    <1> times: The times of the keys
+//    <2> values: The values of the keys
+//    <3> is_looping: Whether the track repeats after its last
+//                    key.  Otherwise, it holds its first value
+//                    before the first key and its last value
+//                    after the last key.
+//  Precondition(s):
+//    <1> !times.empty()
+//    <2> values.size() == times.size()
+//    <3> times is strictly increasing
+//  Returns: The index of the new track.
+//  Side Effect: A new Vector3 track is added.
+//
+	unsigned int addVector3Track (const std::vector<double>& times,
+	                              const std::vector<Vector3>& values,
+	                              bool is_looping);
+
+//
+//  addRotationTrack
+//
+//  Purpose: To add a rotation track.
+//  Parameter(s):
+//    <1> times: The times of the keys
+//    <2> values: The values of the keys
+//    <3> interpolation: How to interpolate between the keys
+//    <4> is_looping: Whether the track repeats after its last
+//                    key
+//  Precondition(s):
+//    <1> !times.empty()
+//    <2> values.size() == times.size()
+//    <3> times is strictly increasing
+//    <4> values[i].isNormal() for all i
+//    <5> interpolation == ROTATION_NLERP ||
+//        interpolation == ROTATION_SLERP
+//  Returns: The index of the new track.
+//  Side Effect: A new rotation track is added.
+//
+	unsigned int addRotationTrack (const std::vector<double>& times,
+	                               const std::vector<Quaternion>& values,
+	                               unsigned int interpolation,
+	                               bool is_looping);
+
+//
+//  clear
+//
+//  Purpose: To remove all tracks.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All tracks are removed and the time is reset
+//               to 0.0.
+//
+	void clear ();
+
+//
+//  update
+//
+//  Purpose: To evaluate all tracks at the specified time.
+//  Parameter(s):
+//    <1> time: The time to evaluate at
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The current value of every track is set to its
+//               value at time time.
+//
+	void update (double time);
+
+private:
+//
+//  Track
+//
+//  A record to describe where the keys for a track are stored
+//    and the state used to find the current key quickly.
+//
+	struct Track
+	{
+		unsigned int m_first_key;
+		unsigned int m_key_count;
+		unsigned int m_last_key;
+		unsigned int m_interpolation;
+		bool m_is_looping;
+	};
+
+//
+//  findKey
+//
+//  Purpose: To determine which pair of keys to interpolate
+//           between.
+//  Parameter(s):
+//    <1> a_times: The key times for all tracks of this type
+//    <2> r_track: The track
+//    <3> time: The time to evaluate at
+//    <4> r_fraction: A reference to set to the interpolation
+//                    fraction
+//  Precondition(s):
+//    <1> a_times != NULL
+//    <2> r_track.m_key_count >= 1
+//  Returns: The index of the first key to interpolate from,
+//           relative to r_track.m_first_key.  The second key is
+//           the next one.  If the track has only one key, 0 is
+//           returned and r_fraction is set to 0.0.
+//  Side Effect: r_track.m_last_key is set to the key returned
+//               and r_fraction is set to how far to
+//               interpolate, in the range [0, 1].
+//
+	static unsigned int findKey (const double* a_times,
+	                             Track& r_track,
+	                             double time,
+	                             float& r_fraction);
+
+private:
+	double m_time;
+
+	std::vector<Track> mv_vector3_tracks;
+	std::vector<double> mv_vector3_times;
+	Vector3Array<float> m_vector3_keys;
+	Vector3Array<float> m_vector3_results;
+
+	std::vector<Track> mv_rotation_tracks;
+	std::vector<double> mv_rotation_times;
+	std::vector<float> mv_rotation_keys_w;
+	std::vector<float> mv_rotation_keys_x;
+	std::vector<float> mv_rotation_keys_y;
+	std::vector<float> mv_rotation_keys_z;
+	std::vector<float> mv_rotation_results_w;
+	std::vector<float> mv_rotation_results_x;
+	std::vector<float> mv_rotation_results_y;
+	std::vector<float> mv_rotation_results_z;
+
+	// reused between updates to avoid allocating memory
+	Vector3Array<float> m_scratch_from;
+	Vector3Array<float> m_scratch_to;
+	std::vector<float> mv_scratch_from_w;
+	std::vector<float> mv_scratch_to_w;
+	std::vector<float> mv_scratch_fractions;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -0,0 +1,808 @@
+//
+//  AssetArchive.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cstdio>	// for remove
+#include <cstring>	// for memcmp
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#elif __WIN32__
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else	// Posix
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <dirent.h>
+#endif
+
+#include "ObjStringParsing.h"
+#include "AssetArchive.h"
+
+using namespace std;
+using namespace ObjLibrary;
+using namespace ObjLibrary::ObjStringParsing;
+namespace
+{
+	//
+	//  ARCHIVE_MAGIC
+	//  ARCHIVE_VERSION
+	//
+	//  The first values in every archive file.  The version
+	//    must be changed whenever the layout changes.
+	//
+	const char ARCHIVE_MAGIC[4] = { 'O', 'L', 'A', 'R' };
+	const unsigned int ARCHIVE_VERSION = 1;
+
+	//
+	//  DATA_ALIGNMENT
+	//
+	//  The number of bytes each file and the index in an archive
+	//    are aligned to.
+	//
+	const unsigned int DATA_ALIGNMENT = 16;
+
+	//
+	//  FNV_OFFSET_BASIS
+	//  FNV_PRIME
+	//
+	//  The constants for the 64-bit FNV-1a hash function.
+	//
+	const unsigned long long FNV_OFFSET_BASIS = 14695981039346656037ull;
+	const unsigned long long FNV_PRIME        = 1099511628211ull;
+
+	//
+	//  ArchiveHeader
+	//
+	//  A record to store the values at the start of an archive
+	//    file.  The file data follows the header, then the
+	//    index entries, and then the paths they refer to.
+	//
+	struct ArchiveHeader
+	{
+		char ma_magic[4];
+		unsigned int m_version;
+		unsigned int m_file_count;
+		unsigned int m_path_bytes;
+		unsigned long long m_index_offset;
+		unsigned long long m_paths_offset;
+	};
+
+	//
+	//  BuildEntry
+	//
+	//  A record to store a file to be archived.
+	//
+	struct BuildEntry
+	{
+		string m_normalized;
+		string m_filename;
+		unsigned long long m_hash;
+		unsigned long long m_data_offset;
+		unsigned long long m_data_size;
+
+		bool operator< (const BuildEntry& other) const
+		{
+			if(m_hash != other.m_hash)
+				return m_hash < other.m_hash;
+			return m_normalized < other.m_normalized;
+		}
+	};
+
+	//
+	//  joinPath
+	//
+	//  Purpose: To combine a folder and a path relative to it.
+	//  Parameter(s):
+	//    <1> folder: The folder, or "" for the current folder
+	//    <2> path: The relative path
+	//  Precondition(s): N/A
+	//  Returns: path inside folder folder.
+	//  Side Effect: N/A
+	//
+	string joinPath (const string& folder, const string& path)
+	{
+		if(folder == "")
+			return path;
+		char last = folder[folder.size() - 1];
+		if(last == '/' || last == '\\')
+			return folder + path;
+		return folder + "/" + path;
+	}
+
+	//
+	//  listFolder
+	//
+	//  Purpose: To find the files and folders in a folder.
+	//  Parameter(s):
+	//    <1> folder: The folder, or "" for the current folder
+	//    <2> rv_files: The vector to add the file names to
+	//    <3> rv_folders: The vector to add the folder names to
+	//  Precondition(s): N/A
+	//  Returns: Whether folder folder could be read.
+	//  Side Effect: The names of the files and folders in
+	//               folder folder, not including "." and "..",
+	//               are added to rv_files and rv_folders.
+	//
+#if defined(_WIN32) || defined(__WIN32__)
+	bool listFolder (const string& folder,
+	                 vector<string>& rv_files,
+	                 vector<string>& rv_folders)
+	{
+		WIN32_FIND_DATAA data;
+		HANDLE find = FindFirstFileA(joinPath(folder, "*").c_str(), &data);
+		if(find == INVALID_HANDLE_VALUE)
+			return false;
+
+		do
+		{
+			string name = data.cFileName;
+			if(name == "." || name == "..")
+				continue;
+			if((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+				rv_folders.push_back(name);
+			else
+				rv_files.push_back(name);
+		}
+		while(FindNextFileA(find, &data));
+
+		FindClose(find);
+		return true;
+	}
+#else	// Posix
+	bool listFolder (const string& folder,
+	                 vector<string>& rv_files,
+	                 vector<string>& rv_folders)
+	{
+		DIR* p_dir = opendir(folder == "" ? "." : folder.c_str());
+		if(p_dir == NULL)
+			return false;
+
+		for(dirent* p_entry = readdir(p_dir); p_entry != NULL; p_entry = readdir(p_dir))
+		{
+			string name = p_entry->d_name;
+			if(name == "." || name == "..")
+				continue;
+
+			struct stat status;
+			if(stat(joinPath(folder, name).c_str(), &status) != 0)
+				continue;
+			if(S_ISDIR(status.st_mode))
+				rv_folders.push_back(name);
+			else if(S_ISREG(status.st_mode))
+				rv_files.push_back(name);
+		}
+
+		closedir(p_dir);
+		return true;
+	}
+#endif
+
+	//
+	//  listFilesRecursive
+	//
+	//  Purpose: To find the files in a folder and all the folders
+	//           in it.
+	//  Parameter(s):
+	//    <1> folder: The folder to search
+	//    <2> prefix: The path of folder relative to the folder
+	//                the search started in
+	//    <3> rv_paths: The vector to add the paths to
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The paths of the files found, relative to
+	//               the folder the search started in, are added
+	//               to rv_paths in sorted order.
+	//
+	void listFilesRecursive (const string& folder,
+	                         const string& prefix,
+	                         vector<string>& rv_paths)
+	{
+		vector<string> v_files;
+		vector<string> v_folders;
+		if(!listFolder(folder, v_files, v_folders))
+			return;
+
+		sort(v_files.begin(), v_files.end());
+		sort(v_folders.begin(), v_folders.end());
+		for(unsigned int i = 0; i < v_files.size(); i++)
+			rv_paths.push_back(prefix + v_files[i]);
+		for(unsigned int i = 0; i < v_folders.size(); i++)
+			listFilesRecursive(joinPath(folder, v_folders[i]),
+			                   prefix + v_folders[i] + "/",
+			                   rv_paths);
+	}
+
+	//
+	//  mapFile
+	//  unmapFile
+	//
+	//  Purpose: To map a file into memory for reading, or to
+	//           unmap it.
+	//  Parameter(s):
+	//    <1> filename: The name of the file
+	//    <2> rp_data: A pointer to set to the mapped memory
+	//    <3> r_size: The size of the file
+	//    <1> p_data: The mapped memory
+	//    <2> size: The size of the mapped memory
+	//  Precondition(s):
+	//    <1> p_data was returned by mapFile with size size
+	//  Returns: mapFile returns whether file filename could be
+	//           mapped.  An empty file cannot be mapped.
+	//  Side Effect: mapFile sets rp_data and r_size.  No file
+	//               handles are left open.  unmapFile unmaps
+	//               the memory.
+	//
+#if defined(_WIN32) || defined(__WIN32__)
+	bool mapFile (const string& filename,
+	              const char*& rp_data,
+	              size_t& r_size)
+	{
+		HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+		                          NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if(file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size;
+		if(!GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		// the view keeps the mapping open after the handles
+		//   are closed
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		CloseHandle(file);
+		if(mapping == NULL)
+			return false;
+		void* p_view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if(p_view == NULL)
+			return false;
+
+		rp_data = (const char*)(p_view);
+		r_size  = (size_t)(size.QuadPart);
+		return true;
+	}
+
+	void unmapFile (const char* p_data, size_t size)
+	{
+		assert(p_data != NULL);
+
+		UnmapViewOfFile(p_data);
+	}
+#else	// Posix
+	bool mapFile (const string& filename,
+	              const char*& rp_data,
+	              size_t& r_size)
+	{
+		int file = ::open(filename.c_str(), O_RDONLY);
+		if(file < 0)
+			return false;
+
+		struct stat status;
+		if(fstat(file, &status) != 0 || status.st_size <= 0)
+		{
+			::close(file);
+			return false;
+		}
+
+		// the mapping stays valid after the file is closed
+		void* p_map = mmap(NULL, (size_t)(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		::close(file);
+		if(p_map == MAP_FAILED)
+			return false;
+
+		rp_data = (const char*)(p_map);
+		r_size  = (size_t)(status.st_size);
+		return true;
+	}
+
+	void unmapFile (const char* p_data, size_t size)
+	{
+		assert(p_data != NULL);
+
+		munmap((void*)(p_data), size);
+	}
+#endif
+
+	//
+	//  writePadding
+	//
+	//  Purpose: To write zeros to a file until its position is a
+	//           multiple of DATA_ALIGNMENT.
+	//  Parameter(s):
+	//    <1> r_output: The file to write to
+	//    <2> r_position: The current position in the file
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: Zeros are written to r_output and
+	//               r_position is advanced past them.
+	//
+	void writePadding (ofstream& r_output,
+	                   unsigned long long& r_position)
+	{
+		static const char A_ZEROS[DATA_ALIGNMENT] = { 0 };
+
+		unsigned int padding = (unsigned int)((DATA_ALIGNMENT - r_position % DATA_ALIGNMENT) % DATA_ALIGNMENT);
+		r_output.write(A_ZEROS, padding);
+		r_position += padding;
+	}
+
+}  // end of anonymous namespace
+
+
+
+const unsigned int AssetArchive :: NO_SUCH_FILE = ~0u;
+
+
+
+string AssetArchive :: getNormalizedPath (const string& path)
+{
+	string lower = toLowercase(path);
+	string normalized;
+	normalized.reserve(lower.size());
+
+	size_t start = 0;
+	while(start <= lower.size())
+	{
+		size_t end = lower.find_first_of("/\\", start);
+		if(end == string::npos)
+			end = lower.size();
+
+		size_t length = end - start;
+		if(length == 0 || (length == 1 && lower[start] == '.'))
+			;	// skip empty and "." folders
+		else if(length == 2 && lower.compare(start, 2, "..") == 0 &&
+		        normalized != "" && normalized != ".." &&
+		        !endsWith(normalized, "/.."))
+		{
+			size_t last_slash = normalized.find_last_of('/');
+			if(last_slash == string::npos)
+				normalized.clear();
+			else
+				normalized.erase(last_slash);
+		}
+		else
+		{
+			if(normalized != "")
+				normalized += '/';
+			normalized.append(lower, start, length);
+		}
+
+		start = end + 1;
+	}
+
+	return normalized;
+}
+
+unsigned long long AssetArchive :: getPathHash (const string& normalized)
+{
+	assert(normalized == getNormalizedPath(normalized));
+
+	unsigned long long hash = FNV_OFFSET_BASIS;
+	for(size_t i = 0; i < normalized.size(); i++)
+	{
+		hash ^= (unsigned char)(normalized[i]);
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+unsigned int AssetArchive :: build (const string& folder,
+                                    const string& archive_filename,
+                                    ostream& r_logstream)
+{
+	assert(archive_filename != "");
+
+	vector<string> v_paths;
+	listFilesRecursive(folder, "", v_paths);
+
+	// don't archive the archive
+	string archive_normalized = getNormalizedPath(archive_filename);
+	string folder_normalized  = getNormalizedPath(folder);
+	if(folder_normalized != "")
+	{
+		if(startsWith(archive_normalized, folder_normalized + "/"))
+			archive_normalized.erase(0, folder_normalized.size() + 1);
+		else
+			archive_normalized = "";
+	}
+	for(unsigned int i = 0; i < v_paths.size(); i++)
+		if(getNormalizedPath(v_paths[i]) == archive_normalized)
+		{
+			v_paths.erase(v_paths.begin() + i);
+			break;
+		}
+
+	return build(folder, v_paths, archive_filename, r_logstream);
+}
+
+unsigned int AssetArchive :: build (const string& folder,
+                                    const vector<string>& v_paths,
+                                    const string& archive_filename,
+                                    ostream& r_logstream)
+{
+	assert(archive_filename != "");
+
+	//
+	//  Format of file:
+	//
+	//  Header
+	//    -> magic number and version
+	//    -> how many files
+	//    -> where the index and paths are
+	//  File data, each aligned to DATA_ALIGNMENT
+	//  Index entries, sorted by hash
+	//  Paths, in the same order as the index entries
+	//
+
+	ofstream output(archive_filename.c_str(), ios::out | ios::binary);
+	if(!output.is_open())
+	{
+		r_logstream << "Error: cannot write to file \"" << archive_filename << "\"" << endl;
+		return 0;
+	}
+
+	ArchiveHeader header;
+	memset(&header, 0, sizeof(header));
+	output.write((const char*)(&header), sizeof(header));
+	unsigned long long position = sizeof(header);
+
+	vector<BuildEntry> v_entries;
+	unordered_set<string> normalized_paths;
+	vector<char> v_buffer;
+	for(unsigned int i = 0; i < v_paths.size(); i++)
+	{
+		BuildEntry entry;
+		entry.m_normalized = getNormalizedPath(v_paths[i]);
+		entry.m_filename   = joinPath(folder, v_paths[i]);
+		if(entry.m_normalized == "")
+			continue;
+		if(normalized_paths.find(entry.m_normalized) != normalized_paths.end())
+		{
+			r_logstream << "Skipping \"" << entry.m_filename << "\": same path as an earlier file" << endl;
+			continue;
+		}
+
+		ifstream input(entry.m_filename.c_str(), ios::in | ios::binary);
+		if(!input.is_open())
+		{
+			r_logstream << "Skipping \"" << entry.m_filename << "\": cannot be read" << endl;
+			continue;
+		}
+		input.seekg(0, ios::end);
+		streamoff size = input.tellg();
+		input.seekg(0, ios::beg);
+		if(size < 0)
+		{
+			r_logstream << "Skipping \"" << entry.m_filename << "\": cannot be read" << endl;
+			continue;
+		}
+		v_buffer.resize((size_t)(size) + 1);
+		input.read(v_buffer.data(), size);
+		if(input.gcount() != size)
+		{
+			r_logstream << "Skipping \"" << entry.m_filename << "\": cannot be read" << endl;
+			continue;
+		}
+
+		writePadding(output, position);
+		entry.m_hash        = getPathHash(entry.m_normalized);
+		entry.m_data_offset = position;
+		entry.m_data_size   = (unsigned long long)(size);
+		output.write(v_buffer.data(), size);
+		position += entry.m_data_size;
+
+		r_logstream << entry.m_normalized << " (" << entry.m_data_size << " bytes)" << endl;
+		normalized_paths.insert(entry.m_normalized);
+		v_entries.push_back(entry);
+	}
+
+	if(v_entries.empty())
+	{
+		r_logstream << "Error: no files to archive in \"" << folder << "\"" << endl;
+		output.close();
+		remove(archive_filename.c_str());
+		return 0;
+	}
+
+	// the index is sorted so files can be found by binary search
+	sort(v_entries.begin(), v_entries.end());
+
+	writePadding(output, position);
+	header.m_index_offset = position;
+	unsigned int path_offset = 0;
+	for(unsigned int i = 0; i < v_entries.size(); i++)
+	{
+		Entry entry;
+		memset(&entry, 0, sizeof(entry));
+		entry.m_hash        = v_entries[i].m_hash;
+		entry.m_data_offset = v_entries[i].m_data_offset;
+		entry.m_data_size   = v_entries[i].m_data_size;
+		entry.m_path_offset = path_offset;
+		entry.m_path_length = (unsigned int)(v_entries[i].m_normalized.size());
+		output.write((const char*)(&entry), sizeof(entry));
+		path_offset += entry.m_path_length;
+	}
+	position += sizeof(Entry) * v_entries.size();
+
+	header.m_paths_offset = position;
+	for(unsigned int i = 0; i < v_entries.size(); i++)
+		output.write(v_entries[i].m_normalized.data(), v_entries[i].m_normalized.size());
+
+	memcpy(header.ma_magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+	header.m_version    = ARCHIVE_VERSION;
+	header.m_file_count = (unsigned int)(v_entries.size());
+	header.m_path_bytes = path_offset;
+	output.seekp(0, ios::beg);
+	output.write((const char*)(&header), sizeof(header));
+
+	if(!output.good())
+	{
+		r_logstream << "Error: cannot write to file \"" << archive_filename << "\"" << endl;
+		output.close();
+		remove(archive_filename.c_str());
+		return 0;
+	}
+	return (unsigned int)(v_entries.size());
+}
+
+
+
+AssetArchive :: AssetArchive ()
+		: m_file_name(),
+		  mp_data(NULL),
+		  m_size(0),
+		  mp_entries(NULL),
+		  mp_paths(NULL),
+		  m_file_count(0)
+{
+	assert(invariant());
+}
+
+AssetArchive :: AssetArchive (const string& filename)
+		: m_file_name(),
+		  mp_data(NULL),
+		  m_size(0),
+		  mp_entries(NULL),
+		  mp_paths(NULL),
+		  m_file_count(0)
+{
+	assert(filename != "");
+
+	open(filename);
+
+	assert(invariant());
+}
+
+AssetArchive :: ~AssetArchive ()
+{
+	close();
+}
+
+
+
+bool AssetArchive :: isOpen () const
+{
+	return mp_data != NULL;
+}
+
+const string& AssetArchive :: getFileName () const
+{
+	assert(isOpen());
+
+	return m_file_name;
+}
+
+unsigned int AssetArchive :: getFileCount () const
+{
+	return m_file_count;
+}
+
+unsigned int AssetArchive :: getFileIndex (const string& path) const
+{
+	if(!isOpen())
+		return NO_SUCH_FILE;
+
+	string normalized = getNormalizedPath(path);
+	unsigned long long hash = getPathHash(normalized);
+
+	// find the first entry with this hash
+	unsigned int low  = 0;
+	unsigned int high = m_file_count;
+	while(low < high)
+	{
+		unsigned int middle = low + (high - low) / 2;
+		if(mp_entries[middle].m_hash < hash)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	// different paths may have the same hash
+	for(unsigned int i = low; i < m_file_count && mp_entries[i].m_hash == hash; i++)
+	{
+		const Entry& entry = mp_entries[i];
+		if(entry.m_path_length == normalized.size() &&
+		   memcmp(mp_paths + entry.m_path_offset, normalized.data(), normalized.size()) == 0)
+		{
+			return i;
+		}
+	}
+	return NO_SUCH_FILE;
+}
+
+bool AssetArchive :: isFile (const string& path) const
+{
+	return getFileIndex(path) != NO_SUCH_FILE;
+}
+
+string AssetArchive :: getFilePath (unsigned int index) const
+{
+	assert(index < getFileCount());
+
+	const Entry& entry = getEntry(index);
+	return string(mp_paths + entry.m_path_offset, entry.m_path_length);
+}
+
+const char* AssetArchive :: getFileData (unsigned int index) const
+{
+	assert(index < getFileCount());
+
+	return mp_data + getEntry(index).m_data_offset;
+}
+
+size_t AssetArchive :: getFileSize (unsigned int index) const
+{
+	assert(index < getFileCount());
+
+	return (size_t)(getEntry(index).m_data_size);
+}
+
+
+
+bool AssetArchive :: open (const string& filename)
+{
+	assert(filename != "");
+
+	close();
+
+	const char* p_data;
+	size_t size;
+	if(!mapFile(filename, p_data, size))
+	{
+		assert(invariant());
+		return false;
+	}
+
+	ArchiveHeader header;
+	bool is_valid = size >= sizeof(header);
+	if(is_valid)
+	{
+		memcpy(&header, p_data, sizeof(header));
+		if(memcmp(header.ma_magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 ||
+		   header.m_version != ARCHIVE_VERSION ||
+		   header.m_index_offset % DATA_ALIGNMENT != 0 ||
+		   header.m_index_offset > size ||
+		   (size - header.m_index_offset) / sizeof(Entry) < header.m_file_count ||
+		   header.m_paths_offset != header.m_index_offset + sizeof(Entry) * header.m_file_count ||
+		   size - header.m_paths_offset < header.m_path_bytes)
+		{
+			is_valid = false;
+		}
+	}
+	if(!is_valid)
+	{
+		unmapFile(p_data, size);
+
+		assert(invariant());
+		return false;
+	}
+
+	m_file_name  = filename;
+	mp_data      = p_data;
+	m_size       = size;
+	mp_entries   = (const Entry*)(p_data + header.m_index_offset);
+	mp_paths     = p_data + header.m_paths_offset;
+	m_file_count = header.m_file_count;
+
+	if(!isValidIndex())
+	{
+		close();
+		return false;
+	}
+
+	assert(invariant());
+	return true;
+}
+
+void AssetArchive :: close ()
+{
+	if(mp_data != NULL)
+		unmapFile(mp_data, m_size);
+
+	m_file_name.clear();
+	mp_data      = NULL;
+	m_size       = 0;
+	mp_entries   = NULL;
+	mp_paths     = NULL;
+	m_file_count = 0;
+
+	assert(invariant());
+}
+
+
+
+const AssetArchive::Entry& AssetArchive :: getEntry (unsigned int index) const
+{
+	assert(index < getFileCount());
+
+	return mp_entries[index];
+}
+
+bool AssetArchive :: isValidIndex () const
+{
+	assert(mp_data != NULL);
+
+	ArchiveHeader header;
+	memcpy(&header, mp_data, sizeof(header));
+
+	for(unsigned int i = 0; i < m_file_count; i++)
+	{
+		const Entry& entry = mp_entries[i];
+		if(entry.m_data_offset > header.m_index_offset) return false;
+		if(header.m_index_offset - entry.m_data_offset < entry.m_data_size) return false;
+		if(entry.m_path_offset > header.m_path_bytes) return false;
+		if(header.m_path_bytes - entry.m_path_offset < entry.m_path_length) return false;
+		if(i > 0 && mp_entries[i - 1].m_hash > entry.m_hash) return false;
+	}
+	return true;
+}
+
+bool AssetArchive :: invariant () const
+{
+	if(mp_data == NULL)
+	{
+		if(m_size != 0) return false;
+		if(mp_entries != NULL) return false;
+		if(mp_paths != NULL) return false;
+		if(m_file_count != 0) return false;
+	}
+	else
+	{
+		if(m_file_name == "") return false;
+		if(mp_entries == NULL) return false;
+		if(mp_paths == NULL) return false;
+	}
+	return true;
+}
@@ -0,0 +1,396 @@
+//
+//  AssetArchive.h
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_ASSET_ARCHIVE_H
+#define OBJ_LIBRARY_ASSET_ARCHIVE_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  AssetArchive
+//
+//  A class to represent a single file that contains many asset
+//    files, such as OBJ, MTL, and BMP files and material packs.
+//    An archive is opened by mapping it into memory, so the
+//    contents of every file in it can be used directly without
+//    opening or reading anything else.
+//
+//  Each file in an archive is identified by its path relative
+//    to the folder the archive was built from.  Paths are
+//    compared in a normalized form (see getNormalizedPath), so
+//    "Models\Spiky.obj" and "./models/spiky.obj" refer to the
+//    same file.  The archive ends with an index of the files,
+//    sorted by a 64-bit hash of their normalized paths, so a
+//    file can be found with a binary search and no string
+//    allocations.
+//
+//  Archives are built with the build function, normally from
+//    the PackTool program.  The values in an archive are stored
+//    as they are in memory, so an archive can only be read on a
+//    computer with the same byte order as the one that built it.
+//
+//  An open AssetArchive can be used from any number of threads
+//    at once, as long as it is not opened or closed at the same
+//    time.
+//
+class AssetArchive
+{
+public:
+//
+//  NO_SUCH_FILE
+//
+//  A constant indicating that there is no file with the
+//    specified path in the archive.
+//
+	static const unsigned int NO_SUCH_FILE;
+
+public:
+//
+//  getNormalizedPath
+//
+//  Purpose: To determine the form of a path that is used to
+//           identify a file in an archive.
+//  Parameter(s):
+//    <1> path: The path
+//  Precondition(s): N/A
+//  Returns: path converted to lowercase, with '\' replaced by
+//           '/', empty and "." folders removed, and each ".."
+//           folder removed with the folder before it.
+//  Side Effect: N/A
+//
+	static std::string getNormalizedPath (const std::string& path);
+
+//
+//  getPathHash
+//
+//  Purpose: To calculate the hash used to find a file in an
+//           archive.
+//  Parameter(s):
+//    <1> normalized: The normalized path of the file
+//  Precondition(s):
+//    <1> normalized == getNormalizedPath(normalized)
+//  Returns: The 64-bit FNV-1a hash of normalized.
+//  Side Effect: N/A
+//
+	static unsigned long long getPathHash (
+	                              const std::string& normalized);
+
+//
+//  build
+//
+//  Purpose: To create an archive file containing the files in
+//           a folder.
+//  Parameter(s):
+//    <1> folder: The folder to archive
+//    <2> archive_filename: The name of the archive file
+//    <3> r_logstream: The stream to write errors and the names
+//                     of the archived files to
+//  Precondition(s):
+//    <1> archive_filename != ""
+//  Returns: The number of files archived, or 0 if the archive
+//           could not be built.
+//  Side Effect: Every file in folder folder and all the folders
+//               in it is written to file archive_filename,
+//               identified by its path relative to folder.  If
+//               folder is "", the current folder is used.  If
+//               file archive_filename is inside folder, it is
+//               not included.
+//
+	static unsigned int build (const std::string& folder,
+	                           const std::string& archive_filename,
+	                           std::ostream& r_logstream);
+
+//
+//  build
+//
+//  Purpose: To create an archive file containing the specified
+//           files.
+//  Parameter(s):
+//    <1> folder: The folder the files are in
+//    <2> v_paths: The paths of the files relative to folder
+//    <3> archive_filename: The name of the archive file
+//    <4> r_logstream: The stream to write errors and the names
+//                     of the archived files to
+//  Precondition(s):
+//    <1> archive_filename != ""
+//  Returns: The number of files archived, or 0 if the archive
+//           could not be built.
+//  Side Effect: The files in v_paths are written to file
+//               archive_filename, identified by their paths.
+//               If more than one path has the same normalized
+//               form, only the first is archived.  Files that
+//               cannot be read are skipped.
+//
+	static unsigned int build (const std::string& folder,
+	                           const std::vector<std::string>& v_paths,
+	                           const std::string& archive_filename,
+	                           std::ostream& r_logstream);
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new AssetArchive that is not open.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new AssetArchive is created.
+//
+	AssetArchive ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a new AssetArchive for the specified
+//           archive file.
+//  Parameter(s):
+//    <1> filename: The name of the archive file
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: N/A
+//  Side Effect: A new AssetArchive is created and opened as by
+//               open.
+//
+	AssetArchive (const std::string& filename);
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy this AssetArchive.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If this AssetArchive is open, it is closed.
+//
+	~AssetArchive ();
+
+//
+//  isOpen
+//
+//  Purpose: To determine if this AssetArchive is open.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this AssetArchive is open.
+//  Side Effect: N/A
+//
+	bool isOpen () const;
+
+//
+//  getFileName
+//
+//  Purpose: To determine the name of the archive file this
+//           AssetArchive was opened from.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isOpen()
+//  Returns: The name of the archive file.
+//  Side Effect: N/A
+//
+	const std::string& getFileName () const;
+
+//
+//  getFileCount
+//
+//  Purpose: To determine the number of files in this
+//           AssetArchive.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of files.  If this AssetArchive is not
+//           open, 0 is returned.
+//  Side Effect: N/A
+//
+	unsigned int getFileCount () const;
+
+//
+//  getFileIndex
+//
+//  Purpose: To find the file with the specified path in this
+//           AssetArchive.
+//  Parameter(s):
+//    <1> path: The path of the file
+//  Precondition(s): N/A
+//  Returns: The index of the file with path path, or
+//           NO_SUCH_FILE if there is none.  The path is
+//           normalized before it is compared.
+//  Side Effect: N/A
+//
+	unsigned int getFileIndex (const std::string& path) const;
+
+//
+//  isFile
+//
+//  Purpose: To determine if this AssetArchive contains a file
+//           with the specified path.
+//  Parameter(s):
+//    <1> path: The path of the file
+//  Precondition(s): N/A
+//  Returns: Whether there is a file with path path.
+//  Side Effect: N/A
+//
+	bool isFile (const std::string& path) const;
+
+//
+//  getFilePath
+//
+//  Purpose: To determine the path of the file with the
+//           specified index.
+//  Parameter(s):
+//    <1> index: The index of the file
+//  Precondition(s):
+//    <1> index < getFileCount()
+//  Returns: The normalized path of file index.
+//  Side Effect: N/A
+//
+	std::string getFilePath (unsigned int index) const;
+
+//
+//  getFileData
+//  getFileSize
+//
+//  Purpose: To retrieve the contents of the file with the
+//           specified index.
+//  Parameter(s):
+//    <1> index: The index of the file
+//  Precondition(s):
+//    <1> index < getFileCount()
+//  Returns: A pointer to the first byte of file index in
+//           memory, or the number of bytes in it.  The pointer
+//           remains valid until this AssetArchive is closed.
+//  Side Effect: N/A
+//
+	const char* getFileData (unsigned int index) const;
+	size_t getFileSize (unsigned int index) const;
+
+//
+//  open
+//
+//  Purpose: To open an archive file.
+//  Parameter(s):
+//    <1> filename: The name of the archive file
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: Whether the archive file could be opened.  This is
+//           false if the file does not exist, cannot be mapped
+//           into memory, is not an archive, or was built by a
+//           different version of this library.
+//  Side Effect: If this AssetArchive is open, it is closed.
+//               Then file filename is mapped into memory.
+//
+	bool open (const std::string& filename);
+
+//
+//  close
+//
+//  Purpose: To close this AssetArchive.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If this AssetArchive is open, the archive file
+//               is unmapped from memory.  Any pointers returned
+//               by getFileData become invalid.
+//
+	void close ();
+
+private:
+//
+//  Entry
+//
+//  A record to store the location of one file in the index of
+//    an archive file.
+//
+	struct Entry
+	{
+		unsigned long long m_hash;
+		unsigned long long m_data_offset;
+		unsigned long long m_data_size;
+		unsigned int m_path_offset;
+		unsigned int m_path_length;
+	};
+
+//
+//  Copy Constructor
+//  Assignment Operator
+//
+//  These functions have intentionally not been implemented
+//    because the mapped memory can only be unmapped once.
+//
+	AssetArchive (const AssetArchive& original);
+	AssetArchive& operator= (const AssetArchive& original);
+
+//
+//  getEntry
+//
+//  Purpose: To retrieve the index entry for the file with the
+//           specified index.
+//  Parameter(s):
+//    <1> index: The index of the file
+//  Precondition(s):
+//    <1> index < getFileCount()
+//  Returns: A reference to the Entry for file index.
+//  Side Effect: N/A
+//
+	const Entry& getEntry (unsigned int index) const;
+
+//
+//  isValidIndex
+//
+//  Purpose: To determine if the index of the mapped archive
+//           file refers only to memory inside it.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> mp_data != NULL
+//  Returns: Whether every Entry refers to data and a path in
+//           the archive file and the entries are sorted by
+//           hash.
+//  Side Effect: N/A
+//
+	bool isValidIndex () const;
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	std::string m_file_name;
+	const char* mp_data;
+	size_t m_size;
+	const Entry* mp_entries;
+	const char* mp_paths;
+	unsigned int m_file_count;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
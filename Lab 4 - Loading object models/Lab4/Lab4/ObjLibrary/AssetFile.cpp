@@ -0,0 +1,117 @@
+//
+//  AssetFile.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <streambuf>
+
+#include "AssetFileSystem.h"
+#include "AssetFile.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+AssetFile :: MemoryBuffer :: MemoryBuffer ()
+		: streambuf()
+{
+}
+
+void AssetFile :: MemoryBuffer :: setData (const char* p_data, size_t size)
+{
+	assert(p_data != NULL);
+
+	// the buffer is only read from, so the cast is safe
+	char* p_begin = const_cast<char*>(p_data);
+	setg(p_begin, p_begin, p_begin + size);
+}
+
+AssetFile::MemoryBuffer::pos_type AssetFile :: MemoryBuffer :: seekoff (off_type offset,
+                                                                       ios_base::seekdir direction,
+                                                                       ios_base::openmode mode)
+{
+	if((mode & ios_base::in) == 0)
+		return pos_type(off_type(-1));
+
+	off_type position;
+	if(direction == ios_base::beg)
+		position = offset;
+	else if(direction == ios_base::cur)
+		position = (gptr() - eback()) + offset;
+	else
+		position = (egptr() - eback()) + offset;
+
+	if(position < 0 || position > egptr() - eback())
+		return pos_type(off_type(-1));
+
+	setg(eback(), eback() + position, egptr());
+	return pos_type(position);
+}
+
+AssetFile::MemoryBuffer::pos_type AssetFile :: MemoryBuffer :: seekpos (pos_type position,
+                                                                       ios_base::openmode mode)
+{
+	return seekoff(off_type(position), ios_base::beg, mode);
+}
+
+
+
+AssetFile :: AssetFile (const string& filename, bool is_binary)
+		: m_is_archived(false),
+		  m_file(),
+		  m_buffer(),
+		  m_archive_stream(&m_buffer)
+{
+	assert(filename != "");
+
+	const char* p_data;
+	size_t size;
+	if(AssetFileSystem::getArchivedFile(filename, p_data, size))
+	{
+		m_buffer.setData(p_data, size);
+		m_is_archived = true;
+	}
+	else if(is_binary)
+		m_file.open(filename.c_str(), ios::in | ios::binary);
+	else
+		m_file.open(filename.c_str(), ios::in);
+}
+
+bool AssetFile :: isOpen () const
+{
+	return m_is_archived || m_file.is_open();
+}
+
+bool AssetFile :: isArchived () const
+{
+	return m_is_archived;
+}
+
+istream& AssetFile :: getStream ()
+{
+	assert(isOpen());
+
+	if(m_is_archived)
+		return m_archive_stream;
+	else
+		return m_file;
+}
@@ -0,0 +1,141 @@
+//
+//  AssetFile.h
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_ASSET_FILE_H
+#define OBJ_LIBRARY_ASSET_FILE_H
+
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <streambuf>
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  AssetFile
+//
+//  A class to open a file for reading through the
+//    AssetFileSystem.  If the file is in a mounted AssetArchive,
+//    it is read directly from the mapped archive with no copy.
+//    Otherwise, it is opened on disk.  Either way, the contents
+//    are read through an input stream.
+//
+class AssetFile
+{
+public:
+//
+//  Constructor
+//
+//  Purpose: To open the specified file.
+//  Parameter(s):
+//    <1> filename: The name of the file
+//    <2> is_binary: Whether the file should be opened in
+//                   binary mode if it is on disk
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: N/A
+//  Side Effect: A new AssetFile is created.  If file filename
+//               is in a mounted archive, it is opened there.
+//               Otherwise, it is opened on disk.  Files in
+//               archives are always read unchanged, as if in
+//               binary mode.
+//
+	AssetFile (const std::string& filename, bool is_binary);
+
+//
+//  isOpen
+//
+//  Purpose: To determine if the file was opened.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the file exists and could be opened.
+//  Side Effect: N/A
+//
+	bool isOpen () const;
+
+//
+//  isArchived
+//
+//  Purpose: To determine if the file was opened from a mounted
+//           archive.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the file is in a mounted archive.
+//  Side Effect: N/A
+//
+	bool isArchived () const;
+
+//
+//  getStream
+//
+//  Purpose: To retrieve the stream to read the file from.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isOpen()
+//  Returns: A reference to the input stream for the file.
+//  Side Effect: N/A
+//
+	std::istream& getStream ();
+
+private:
+//
+//  MemoryBuffer
+//
+//  A stream buffer to read from a block of memory that does
+//    not belong to it.
+//
+	class MemoryBuffer : public std::streambuf
+	{
+	public:
+		MemoryBuffer ();
+		void setData (const char* p_data, size_t size);
+
+	protected:
+		virtual pos_type seekoff (off_type offset,
+		                          std::ios_base::seekdir direction,
+		                          std::ios_base::openmode mode);
+		virtual pos_type seekpos (pos_type position,
+		                          std::ios_base::openmode mode);
+	};
+
+//
+//  Copy Constructor
+//  Assignment Operator
+//
+//  These functions have intentionally not been implemented
+//    because streams cannot be copied.
+//
+	AssetFile (const AssetFile& original);
+	AssetFile& operator= (const AssetFile& original);
+
+private:
+	bool m_is_archived;
+	std::ifstream m_file;
+	MemoryBuffer m_buffer;
+	std::istream m_archive_stream;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -0,0 +1,162 @@
+//
+//  AssetFileSystem.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "AssetArchive.h"
+#include "AssetFileSystem.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+namespace
+{
+	// most recently mounted last
+	std::vector<AssetArchive*> gvp_archives;
+
+	// lookups are very short, so they all share one mutex
+	std::mutex g_mutex;
+
+}  // end of anonymous namespace
+
+
+
+bool AssetFileSystem :: mount (const string& archive_filename)
+{
+	assert(archive_filename != "");
+
+	AssetArchive* p_archive = new AssetArchive;
+	if(!p_archive->open(archive_filename))
+	{
+		delete p_archive;
+		return false;
+	}
+
+	lock_guard<mutex> lock(g_mutex);
+	gvp_archives.push_back(p_archive);
+	return true;
+}
+
+void AssetFileSystem :: unmountAll ()
+{
+	lock_guard<mutex> lock(g_mutex);
+	for(unsigned int i = 0; i < gvp_archives.size(); i++)
+		delete gvp_archives[i];
+	gvp_archives.clear();
+}
+
+unsigned int AssetFileSystem :: getMountCount ()
+{
+	lock_guard<mutex> lock(g_mutex);
+	return (unsigned int)(gvp_archives.size());
+}
+
+bool AssetFileSystem :: getArchivedFile (const string& filename,
+                                         const char*& rp_data,
+                                         size_t& r_size)
+{
+	lock_guard<mutex> lock(g_mutex);
+	for(unsigned int i = (unsigned int)(gvp_archives.size()); i > 0; i--)
+	{
+		const AssetArchive& archive = *(gvp_archives[i - 1]);
+		unsigned int index = archive.getFileIndex(filename);
+		if(index != AssetArchive::NO_SUCH_FILE)
+		{
+			rp_data = archive.getFileData(index);
+			r_size  = archive.getFileSize(index);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool AssetFileSystem :: isFile (const string& filename)
+{
+	const char* p_data;
+	size_t size;
+	if(getArchivedFile(filename, p_data, size))
+		return true;
+
+	ifstream input_file(filename.c_str(), ios::in | ios::binary);
+	return input_file.is_open();
+}
+
+bool AssetFileSystem :: getFileStatus (const string& filename,
+                                       long long& r_modified,
+                                       long long& r_size)
+{
+	const char* p_data;
+	size_t size;
+	if(getArchivedFile(filename, p_data, size))
+	{
+		r_modified = 0;
+		r_size     = (long long)(size);
+		return true;
+	}
+
+	struct stat status;
+	if(stat(filename.c_str(), &status) != 0)
+		return false;
+
+	r_modified = (long long)(status.st_mtime);
+	r_size     = (long long)(status.st_size);
+	return true;
+}
+
+bool AssetFileSystem :: readFile (const string& filename,
+                                  string& r_contents)
+{
+	const char* p_data;
+	size_t size;
+	if(getArchivedFile(filename, p_data, size))
+	{
+		r_contents.assign(p_data, size);
+		return true;
+	}
+
+	r_contents.clear();
+
+	ifstream input_file(filename.c_str(), ios::in | ios::binary);
+	if(!input_file.is_open())
+		return false;
+
+	input_file.seekg(0, ios::end);
+	streamoff file_size = input_file.tellg();
+	if(file_size < 0)
+		return false;
+	input_file.seekg(0, ios::beg);
+
+	r_contents.resize((size_t)(file_size));
+	if(file_size > 0)
+		input_file.read(&(r_contents[0]), file_size);
+	if(input_file.gcount() != file_size)
+	{
+		r_contents.clear();
+		return false;
+	}
+	return true;
+}
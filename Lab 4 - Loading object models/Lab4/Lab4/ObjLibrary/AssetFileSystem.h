@@ -0,0 +1,167 @@
+//
+//  AssetFileSystem.h
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_ASSET_FILE_SYSTEM_H
+#define OBJ_LIBRARY_ASSET_FILE_SYSTEM_H
+
+#include <string>
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  AssetFileSystem
+//
+//  A global service to find asset files in mounted
+//    AssetArchives before looking for them on disk.  ObjModel,
+//    MtlLibrary, and TextureBmp load all their files through
+//    it (see AssetFile), so once an archive is mounted,
+//    ObjModel::load("Spiky.obj") reads "spiky.obj" from the
+//    archive if it is there.  Files that are not in any
+//    mounted archive are read from disk as usual.
+//
+//  Archives are searched from the most recently mounted to the
+//    least, so a later archive can override files in an
+//    earlier one.  Archives should be mounted and unmounted
+//    when no assets are being loaded.
+//
+namespace AssetFileSystem
+{
+
+//
+//  mount
+//
+//  Purpose: To add an archive file to the files searched.
+//  Parameter(s):
+//    <1> archive_filename: The name of the archive file
+//  Precondition(s):
+//    <1> archive_filename != ""
+//  Returns: Whether file archive_filename could be opened as
+//           an archive.
+//  Side Effect: If file archive_filename is a valid archive, it
+//               is mapped into memory and searched before any
+//               previously-mounted archives.  Otherwise, there
+//               is no effect.
+//
+bool mount (const std::string& archive_filename);
+
+//
+//  unmountAll
+//
+//  Purpose: To remove all archives from the files searched.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All mounted archives are closed.  Any pointers
+//               returned by getArchivedFile become invalid.
+//
+void unmountAll ();
+
+//
+//  getMountCount
+//
+//  Purpose: To determine the number of archives mounted.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of archives mounted.
+//  Side Effect: N/A
+//
+unsigned int getMountCount ();
+
+//
+//  getArchivedFile
+//
+//  Purpose: To find a file in the mounted archives.
+//  Parameter(s):
+//    <1> filename: The name of the file
+//    <2> rp_data: A pointer to set to the file contents
+//    <3> r_size: The size of the file
+//  Precondition(s): N/A
+//  Returns: Whether a mounted archive contains a file with
+//           path filename.
+//  Side Effect: If the file was found, rp_data is set to point
+//               to its contents in the mapped archive and
+//               r_size is set to its size.  The pointer remains
+//               valid until unmountAll is called.  Otherwise,
+//               rp_data and r_size are not changed.
+//
+bool getArchivedFile (const std::string& filename,
+                      const char*& rp_data,
+                      size_t& r_size);
+
+//
+//  isFile
+//
+//  Purpose: To determine if a file exists in a mounted archive
+//           or on disk.
+//  Parameter(s):
+//    <1> filename: The name of the file
+//  Precondition(s): N/A
+//  Returns: Whether file filename can be read.
+//  Side Effect: N/A
+//
+bool isFile (const std::string& filename);
+
+//
+//  getFileStatus
+//
+//  Purpose: To determine when a file in a mounted archive or
+//           on disk was last modified and how big it is.
+//  Parameter(s):
+//    <1> filename: The name of the file
+//    <2> r_modified: The modification time
+//    <3> r_size: The size of the file in bytes
+//  Precondition(s): N/A
+//  Returns: Whether file filename exists.
+//  Side Effect: If file filename exists, r_modified and r_size
+//               are set.  Archives do not store modification
+//               times, so r_modified is set to 0 for a file in
+//               a mounted archive.  If the file does not
+//               exist, r_modified and r_size are not changed.
+//
+bool getFileStatus (const std::string& filename,
+                    long long& r_modified,
+                    long long& r_size);
+
+//
+//  readFile
+//
+//  Purpose: To read the entire contents of a file from a
+//           mounted archive or disk.
+//  Parameter(s):
+//    <1> filename: The name of the file
+//    <2> r_contents: The string to read into
+//  Precondition(s): N/A
+//  Returns: Whether file filename could be read.
+//  Side Effect: r_contents is set to the bytes in file
+//               filename, unchanged.  If the file cannot be
+//               read, r_contents is cleared.
+//
+bool readFile (const std::string& filename,
+               std::string& r_contents);
+
+}  // end of namespace AssetFileSystem
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -0,0 +1,321 @@
+//
+//  AssetLoader.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+
+#include "ObjStringParsing.h"
+#include "ObjModel.h"
+#include "MtlLibrary.h"
+#include "Material.h"
+#include "TextureBmp.h"
+#include "TextureManager.h"
+#include "JobSystem.h"
+#include "AssetLoader.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+AssetLoader :: AssetLoader ()
+		: m_job_count(0)
+{
+}
+
+AssetLoader :: ~AssetLoader ()
+{
+	unique_lock<mutex> lock(m_mutex);
+	while(m_job_count > 0)
+		m_changed_condition.wait(lock);
+
+	for(unsigned int i = 0; i < mvp_models.size(); i++)
+		delete mvp_models[i];
+	for(unsigned int i = 0; i < mvp_textures.size(); i++)
+		delete mvp_textures[i];
+}
+
+
+
+unsigned int AssetLoader :: getModelCount () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return (unsigned int)(mvp_models.size());
+}
+
+const string& AssetLoader :: getModelFilename (unsigned int model) const
+{
+	assert(model < getModelCount());
+
+	lock_guard<mutex> lock(m_mutex);
+	return mvp_models[model]->m_filename;
+}
+
+bool AssetLoader :: isDecoded (unsigned int model) const
+{
+	assert(model < getModelCount());
+
+	lock_guard<mutex> lock(m_mutex);
+	return mvp_models[model]->m_is_decoded;
+}
+
+bool AssetLoader :: isReady (unsigned int model) const
+{
+	assert(model < getModelCount());
+
+	lock_guard<mutex> lock(m_mutex);
+	return isReadyLocked(model);
+}
+
+bool AssetLoader :: isDone () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	for(unsigned int i = 0; i < mvp_models.size(); i++)
+		if(!isReadyLocked(i))
+			return false;
+	return true;
+}
+
+const ObjModel& AssetLoader :: getModel (unsigned int model) const
+{
+	assert(model < getModelCount());
+	assert(isDecoded(model));
+
+	lock_guard<mutex> lock(m_mutex);
+	return mvp_models[model]->m_model;
+}
+
+string AssetLoader :: getLog (unsigned int model) const
+{
+	assert(model < getModelCount());
+	assert(isDecoded(model));
+
+	lock_guard<mutex> lock(m_mutex);
+	return mvp_models[model]->m_log;
+}
+
+unsigned int AssetLoader :: getTextureCount () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return (unsigned int)(mvp_textures.size());
+}
+
+unsigned int AssetLoader :: getPendingUploadCount () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return (unsigned int)(mv_upload_queue.size());
+}
+
+
+
+unsigned int AssetLoader :: addModel (const string& filename)
+{
+	assert(filename != "");
+
+	unsigned int model;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		model = (unsigned int)(mvp_models.size());
+		Model* p_model = new Model;
+		p_model->m_filename = filename;
+		p_model->m_is_decoded = false;
+		mvp_models.push_back(p_model);
+		m_job_count++;
+	}
+
+	JobSystem::getShared().add([this, model] () { loadModel(model); },
+	                           JobSystem::PRIORITY_LOW);
+	return model;
+}
+
+unsigned int AssetLoader :: uploadTextures (unsigned int max_count)
+{
+	vector<TextureImage*> vp_textures;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		unsigned int count = max_count;
+		if(count > mv_upload_queue.size())
+			count = (unsigned int)(mv_upload_queue.size());
+		for(unsigned int i = 0; i < count; i++)
+			vp_textures.push_back(mvp_textures[mv_upload_queue[i]]);
+		mv_upload_queue.erase(mv_upload_queue.begin(), mv_upload_queue.begin() + count);
+	}
+
+	// the jobs do not change the images once they are queued
+	unsigned int uploaded = 0;
+	for(unsigned int i = 0; i < vp_textures.size(); i++)
+	{
+		TextureImage* p_texture = vp_textures[i];
+		if(!p_texture->m_image.isBad() &&
+		   !TextureManager::isLoaded(p_texture->m_name))
+		{
+			TextureManager::add(p_texture->m_image, p_texture->m_name);
+			uploaded++;
+		}
+		p_texture->m_image = TextureBmp();
+	}
+
+	if(!vp_textures.empty())
+	{
+		lock_guard<mutex> lock(m_mutex);
+		for(unsigned int i = 0; i < vp_textures.size(); i++)
+			vp_textures[i]->m_is_uploaded = true;
+	}
+	return uploaded;
+}
+
+void AssetLoader :: finish ()
+{
+	while(!isDone())
+	{
+		uploadTextures(~0u);
+
+		unique_lock<mutex> lock(m_mutex);
+		if(mv_upload_queue.empty() && m_job_count > 0)
+			m_changed_condition.wait_for(lock, chrono::milliseconds(1));
+	}
+}
+
+
+
+void AssetLoader :: loadModel (unsigned int model)
+{
+	assert(model < getModelCount());
+
+	Model* p_model;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		p_model = mvp_models[model];
+	}
+
+	// no other thread uses the model until it is decoded
+	stringstream log;
+	p_model->m_model.load(p_model->m_filename, log);
+
+	vector<string> v_names;
+	for(unsigned int l = 0; l < p_model->m_model.getMaterialLibraryCount(); l++)
+	{
+		const MtlLibrary* p_library = p_model->m_model.getMaterialLibrary(l);
+		if(p_library == NULL)
+			continue;
+		for(unsigned int m = 0; m < p_library->getMaterialCount(); m++)
+		{
+			string name = p_library->getMaterial(m)->getDisplayTextureFilename();
+			if(ObjStringParsing::endsWith(ObjStringParsing::toLowercase(name), ".bmp"))
+				v_names.push_back(name);
+		}
+	}
+
+	vector<unsigned int> v_jobs;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		p_model->m_log = log.str();
+		for(unsigned int n = 0; n < v_names.size(); n++)
+		{
+			unsigned int texture = requestTexture(v_names[n], model);
+			if(find(p_model->mv_textures.begin(), p_model->mv_textures.end(), texture) != p_model->mv_textures.end())
+				continue;
+			p_model->mv_textures.push_back(texture);
+			v_jobs.push_back(mvp_textures[texture]->m_job);
+		}
+		m_job_count++;
+	}
+
+	JobSystem::getShared().add([this, p_model] ()
+	{
+		{
+			lock_guard<mutex> lock(m_mutex);
+			p_model->m_is_decoded = true;
+		}
+		endJob();
+	}, v_jobs, JobSystem::PRIORITY_LOW);
+	endJob();
+}
+
+unsigned int AssetLoader :: requestTexture (const string& name,
+                                            unsigned int model)
+{
+	assert(model < mvp_models.size());
+
+	string lower = ObjStringParsing::toLowercase(name);
+	unordered_map<string, unsigned int>::const_iterator it = m_texture_indexes.find(lower);
+	if(it != m_texture_indexes.end())
+		return it->second;
+
+	unsigned int texture = (unsigned int)(mvp_textures.size());
+	TextureImage* p_texture = new TextureImage;
+	p_texture->m_name = name;
+	p_texture->m_model = model;
+	p_texture->m_is_uploaded = false;
+	mvp_textures.push_back(p_texture);
+	m_texture_indexes[lower] = texture;
+	m_job_count++;
+
+	// m_mutex is held, so the job cannot run before m_job is set
+	p_texture->m_job = JobSystem::getShared().add([this, texture] () { loadTexture(texture); },
+	                                              JobSystem::PRIORITY_LOW);
+	return texture;
+}
+
+void AssetLoader :: loadTexture (unsigned int texture)
+{
+	TextureImage* p_texture;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		assert(texture < mvp_textures.size());
+		p_texture = mvp_textures[texture];
+	}
+
+	stringstream log;
+	p_texture->m_image.load(p_texture->m_name, log);
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		mvp_models[p_texture->m_model]->m_log += log.str();
+		mv_upload_queue.push_back(texture);
+	}
+	endJob();
+}
+
+void AssetLoader :: endJob ()
+{
+	lock_guard<mutex> lock(m_mutex);
+	assert(m_job_count > 0);
+	m_job_count--;
+	m_changed_condition.notify_all();
+}
+
+bool AssetLoader :: isReadyLocked (unsigned int model) const
+{
+	assert(model < mvp_models.size());
+
+	const Model* p_model = mvp_models[model];
+	if(!p_model->m_is_decoded)
+		return false;
+	for(unsigned int i = 0; i < p_model->mv_textures.size(); i++)
+		if(!mvp_textures[p_model->mv_textures[i]]->m_is_uploaded)
+			return false;
+	return true;
+}
@@ -0,0 +1,398 @@
+//
+//  AssetLoader.h
+//
+//  A module to load many ObjModels and their materials and
+//    textures in parallel.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_ASSET_LOADER_H
+#define OBJ_LIBRARY_ASSET_LOADER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+
+#include "ObjModel.h"
+#include "TextureBmp.h"
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  AssetLoader
+//
+//  A class to load a set of ObjModels, along with the
+//    MtlLibraries and textures they use, on the shared
+//    JobSystem.  Each model is loaded by its own job.  The
+//    material libraries are loaded by the job for the first
+//    model that refers to them, through the
+//    MtlLibraryManager.  As soon as a model is loaded, a job is
+//    added to load each texture its materials display that is
+//    not already being loaded.  A last job for the model
+//    depends on its texture jobs, and marks the model as
+//    decoded when they are all done.
+//
+//  OpenGL can only be used on the thread with the context, so
+//    the loaded textures are held until uploadTextures is
+//    called from that thread.  uploadTextures adds them to the
+//    TextureManager, where the Materials will find them when
+//    they are first displayed.  A model is ready to draw once
+//    it has been decoded and all its textures have been
+//    uploaded.
+//
+//  Only textures in .bmp files are loaded in advance.  Other
+//    textures are loaded when they are first needed, as
+//    before.  Jobs are added with PRIORITY_LOW, so loading
+//    does not delay the work for the current frame.
+//
+//  All functions except uploadTextures and finish may be called
+//    from any thread, but an AssetLoader must not be destroyed
+//    while another thread is using it.
+//
+class AssetLoader
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new AssetLoader with no models.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new AssetLoader is created.
+//
+	AssetLoader ();
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy this AssetLoader.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This function waits for any loading jobs to
+//               finish.  Then all dynamically allocated memory
+//               is freed.  Textures that have not been uploaded
+//               are discarded.
+//
+	~AssetLoader ();
+
+//
+//  getModelCount
+//
+//  Purpose: To determine the number of models added.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of models.
+//  Side Effect: N/A
+//
+	unsigned int getModelCount () const;
+
+//
+//  getModelFilename
+//
+//  Purpose: To determine the file a model is loaded from.
+//  Parameter(s):
+//    <1> model: Which model
+//  Precondition(s):
+//    <1> model < getModelCount()
+//  Returns: The filename model model was added with.
+//  Side Effect: N/A
+//
+	const std::string& getModelFilename (unsigned int model) const;
+
+//
+//  isDecoded
+//
+//  Purpose: To determine if all the files for a model have been
+//           read.
+//  Parameter(s):
+//    <1> model: Which model
+//  Precondition(s):
+//    <1> model < getModelCount()
+//  Returns: Whether model model and all the textures it uses
+//           have been loaded into memory.
+//  Side Effect: N/A
+//
+	bool isDecoded (unsigned int model) const;
+
+//
+//  isReady
+//
+//  Purpose: To determine if a model can be drawn.
+//  Parameter(s):
+//    <1> model: Which model
+//  Precondition(s):
+//    <1> model < getModelCount()
+//  Returns: Whether model model has been decoded and all the
+//           textures it uses have been uploaded.
+//  Side Effect: N/A
+//
+	bool isReady (unsigned int model) const;
+
+//
+//  isDone
+//
+//  Purpose: To determine if every model is ready.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether isReady is true for every model.
+//  Side Effect: N/A
+//
+	bool isDone () const;
+
+//
+//  getModel
+//
+//  Purpose: To retrieve a loaded model.
+//  Parameter(s):
+//    <1> model: Which model
+//  Precondition(s):
+//    <1> model < getModelCount()
+//    <2> isDecoded(model)
+//  Returns: A reference to the ObjModel for model model.
+//  Side Effect: N/A
+//
+	const ObjModel& getModel (unsigned int model) const;
+
+//
+//  getLog
+//
+//  Purpose: To retrieve the loading errors for a model.
+//  Parameter(s):
+//    <1> model: Which model
+//  Precondition(s):
+//    <1> model < getModelCount()
+//    <2> isDecoded(model)
+//  Returns: The error messages generated while loading model
+//           model, its material libraries, and the textures
+//           that were first requested by it.
+//  Side Effect: N/A
+//
+	std::string getLog (unsigned int model) const;
+
+//
+//  getTextureCount
+//
+//  Purpose: To determine the number of textures requested.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of different textures requested by the
+//           models so far.
+//  Side Effect: N/A
+//
+	unsigned int getTextureCount () const;
+
+//
+//  getPendingUploadCount
+//
+//  Purpose: To determine the number of textures waiting to be
+//           uploaded.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of textures that have been loaded into
+//           memory but not uploaded.
+//  Side Effect: N/A
+//
+	unsigned int getPendingUploadCount () const;
+
+//
+//  addModel
+//
+//  Purpose: To start loading a model.
+//  Parameter(s):
+//    <1> filename: The name of the OBJ file
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: The index of the new model.
+//  Side Effect: A new model is added and a job is added to the
+//               shared JobSystem to load it.
+//
+	unsigned int addModel (const std::string& filename);
+
+//
+//  uploadTextures
+//
+//  Purpose: To add loaded textures to video memory.
+//  Parameter(s):
+//    <1> max_count: The most textures to upload
+//  Precondition(s):
+//    <1> This function is called from the thread with the
+//        OpenGL context
+//  Returns: The number of textures uploaded.
+//  Side Effect: Up to max_count textures that are waiting are
+//               added to the TextureManager, unless a texture
+//               with the same name has already been added.
+//               Their images are then discarded.  Textures that
+//               could not be loaded are skipped.
+//
+	unsigned int uploadTextures (unsigned int max_count);
+
+//
+//  finish
+//
+//  Purpose: To wait for every model to be ready.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> This function is called from the thread with the
+//        OpenGL context
+//    <2> This function is not called from a job
+//  Returns: N/A
+//  Side Effect: This function uploads textures as they are
+//               loaded until every model is ready.
+//
+	void finish ();
+
+private:
+//
+//  Model
+//
+//  A record to store a model and what is known about it.
+//
+	struct Model
+	{
+		std::string m_filename;
+		ObjModel m_model;
+		std::string m_log;
+		std::vector<unsigned int> mv_textures;
+		bool m_is_decoded;
+	};
+
+//
+//  TextureImage
+//
+//  A record to store a texture between when it is loaded and
+//    when it is uploaded.
+//
+	struct TextureImage
+	{
+		std::string m_name;
+		unsigned int m_model;
+		TextureBmp m_image;
+		unsigned int m_job;
+		bool m_is_uploaded;
+	};
+
+//
+//  Helper Function: loadModel
+//
+//  Purpose: To load a model and request its textures.
+//  Parameter(s):
+//    <1> model: Which model
+//  Precondition(s):
+//    <1> model < getModelCount()
+//  Returns: N/A
+//  Side Effect: Model model is loaded, along with any material
+//               libraries it uses that are not already loaded.
+//               A job is added to load each texture it uses
+//               that has not been requested.  Then a job is
+//               added to mark model model as decoded once all
+//               its textures are loaded.
+//
+	void loadModel (unsigned int model);
+
+//
+//  Helper Function: requestTexture
+//
+//  Purpose: To start loading a texture if it has not been
+//           requested yet.
+//  Parameter(s):
+//    <1> name: The name of the texture file
+//    <2> model: The model that uses the texture
+//  Precondition(s):
+//    <1> m_mutex is locked by the calling thread
+//    <2> model < mvp_models.size()
+//  Returns: The index of the texture.
+//  Side Effect: If there is no texture with name name, a new
+//               texture is added and a job is added to load it.
+//
+	unsigned int requestTexture (const std::string& name,
+	                             unsigned int model);
+
+//
+//  Helper Function: loadTexture
+//
+//  Purpose: To load a texture into memory.
+//  Parameter(s):
+//    <1> texture: Which texture
+//  Precondition(s):
+//    <1> texture < mvp_textures.size()
+//  Returns: N/A
+//  Side Effect: Texture texture is loaded and queued to be
+//               uploaded.  Any loading errors are added to the
+//               log for the model that requested it.
+//
+	void loadTexture (unsigned int texture);
+
+//
+//  Helper Function: endJob
+//
+//  Purpose: To record that a job for this AssetLoader has
+//           finished.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The number of running jobs is decreased and any
+//               thread waiting for a change is woken.
+//
+	void endJob ();
+
+//
+//  Helper Function: isReadyLocked
+//
+//  Purpose: To determine if a model can be drawn.
+//  Parameter(s):
+//    <1> model: Which model
+//  Precondition(s):
+//    <1> m_mutex is locked by the calling thread
+//    <2> model < mvp_models.size()
+//  Returns: Whether model model has been decoded and all the
+//           textures it uses have been uploaded.
+//  Side Effect: N/A
+//
+	bool isReadyLocked (unsigned int model) const;
+
+//
+//  Copy Constructor
+//  Assignment Operator
+//
+//  These functions have intentionally not been implemented
+//    because the jobs refer to the AssetLoader that added them.
+//
+	AssetLoader (const AssetLoader& original);
+	AssetLoader& operator= (const AssetLoader& original);
+
+private:
+	mutable std::mutex m_mutex;
+	std::condition_variable m_changed_condition;
+	std::vector<Model*> mvp_models;
+	std::vector<TextureImage*> mvp_textures;
+	std::unordered_map<std::string, unsigned int> m_texture_indexes;
+	std::vector<unsigned int> mv_upload_queue;
+	unsigned int m_job_count;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
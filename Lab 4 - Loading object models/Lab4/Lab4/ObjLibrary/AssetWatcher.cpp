@@ -0,0 +1,475 @@
+//
+//  AssetWatcher.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <string>
+#include <vector>
+#include <utility>	// for move
+#include <sstream>
+#include <iostream>
+#include <mutex>
+#include <condition_variable>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "ObjStringParsing.h"
+#include "ObjModel.h"
+#include "MtlLibrary.h"
+#include "MtlLibraryManager.h"
+#include "Material.h"
+#include "TextureBmp.h"
+#include "TextureManager.h"
+#include "DisplayList.h"
+#include "JobSystem.h"
+#include "AssetWatcher.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const double DEFAULT_CHECK_INTERVAL = 0.5;
+
+	//
+	//  getFileStatus
+	//
+	//  Purpose: To determine when a file was last modified and
+	//           how big it is.
+	//  Parameter(s):
+	//    <1> filename: The name of the file
+	//    <2> r_modified: The modification time
+	//    <3> r_size: The size of the file in bytes
+	//  Precondition(s): N/A
+	//  Returns: Whether file filename exists.
+	//  Side Effect: If file filename exists, r_modified and
+	//               r_size are set.  Otherwise they are not
+	//               changed.
+	//
+	bool getFileStatus (const string& filename,
+	                    long long& r_modified,
+	                    long long& r_size)
+	{
+		struct stat status;
+		if(stat(filename.c_str(), &status) != 0)
+			return false;
+
+		r_modified = (long long)(status.st_mtime);
+		r_size     = (long long)(status.st_size);
+		return true;
+	}
+
+	//
+	//  isBmpFile
+	//
+	//  Purpose: To determine if a file is a .bmp file.
+	//  Parameter(s):
+	//    <1> filename: The name of the file
+	//  Precondition(s): N/A
+	//  Returns: Whether filename ends in ".bmp"
+	//           (case-insensitive).
+	//  Side Effect: N/A
+	//
+	bool isBmpFile (const string& filename)
+	{
+		return ObjStringParsing::endsWith(ObjStringParsing::toLowercase(filename), ".bmp");
+	}
+}
+
+
+
+AssetWatcher :: AssetWatcher ()
+		: m_job_count(0),
+		  m_is_checking(false),
+		  m_check_interval(DEFAULT_CHECK_INTERVAL),
+		  m_since_check(0.0),
+		  m_reload_count(0)
+{
+}
+
+AssetWatcher :: ~AssetWatcher ()
+{
+	unique_lock<mutex> lock(m_mutex);
+	while(m_job_count > 0)
+		m_jobs_condition.wait(lock);
+
+	for(unsigned int i = 0; i < mv_reloads.size(); i++)
+	{
+		delete mv_reloads[i].mp_model;
+		delete mv_reloads[i].mp_library;
+		delete mv_reloads[i].mp_image;
+	}
+}
+
+
+
+unsigned int AssetWatcher :: getWatchCount () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return (unsigned int)(mv_watches.size());
+}
+
+unsigned int AssetWatcher :: getReloadCount () const
+{
+	return m_reload_count;
+}
+
+unsigned int AssetWatcher :: getPendingCount () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return (unsigned int)(mv_reloads.size());
+}
+
+void AssetWatcher :: setCheckInterval (double seconds)
+{
+	assert(seconds >= 0.0);
+
+	m_check_interval = seconds;
+}
+
+
+
+void AssetWatcher :: watchModel (ObjModel& r_model,
+                                 const string& filename)
+{
+	assert(filename != "");
+
+	addWatch(TYPE_MODEL, filename, &r_model, NULL);
+	watchDependencies(r_model);
+}
+
+void AssetWatcher :: watchModel (ObjModel& r_model,
+                                 DisplayList& r_display_list,
+                                 const string& filename)
+{
+	assert(filename != "");
+
+	addWatch(TYPE_MODEL, filename, &r_model, &r_display_list);
+	watchDependencies(r_model);
+}
+
+void AssetWatcher :: watchMtlLibrary (const string& name)
+{
+	assert(name != "");
+
+	addWatch(TYPE_MTL_LIBRARY, name, NULL, NULL);
+}
+
+void AssetWatcher :: watchTexture (const string& name)
+{
+	assert(name != "");
+
+	addWatch(TYPE_TEXTURE, name, NULL, NULL);
+}
+
+void AssetWatcher :: check ()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		if(m_is_checking)
+			return;
+		m_is_checking = true;
+		m_job_count++;
+	}
+
+	JobSystem::getShared().add([this] () { checkFiles(); },
+	                           JobSystem::PRIORITY_LOW);
+}
+
+unsigned int AssetWatcher :: update (double seconds)
+{
+	assert(seconds >= 0.0);
+
+	m_since_check += seconds;
+	if(m_since_check >= m_check_interval)
+	{
+		m_since_check = 0.0;
+		check();
+	}
+
+	vector<Reload> v_reloads;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		if(mv_reloads.empty())
+			return 0;
+		v_reloads.swap(mv_reloads);
+	}
+
+	// everything is replaced here, between frames
+	unsigned int replaced = 0;
+	for(unsigned int i = 0; i < v_reloads.size(); i++)
+	{
+		cerr << v_reloads[i].m_log;
+		if(applyReload(v_reloads[i]))
+			replaced++;
+		delete v_reloads[i].mp_model;
+		delete v_reloads[i].mp_library;
+		delete v_reloads[i].mp_image;
+	}
+	m_reload_count += replaced;
+	return replaced;
+}
+
+
+
+bool AssetWatcher :: addWatch (unsigned int type,
+                               const string& filename,
+                               ObjModel* p_model,
+                               DisplayList* p_display_list)
+{
+	assert(type == TYPE_MODEL || type == TYPE_MTL_LIBRARY || type == TYPE_TEXTURE);
+	assert(filename != "");
+
+	Watch watch;
+	watch.m_type = type;
+	watch.m_filename = filename;
+	watch.mp_model = p_model;
+	watch.mp_display_list = p_display_list;
+	watch.m_modified = 0;
+	watch.m_size = -1;
+	watch.m_change_count = 0;
+	getFileStatus(filename, watch.m_modified, watch.m_size);
+
+	// the same model file may be watched for different ObjModels
+	string key = (char)('0' + type) + ObjStringParsing::toLowercase(filename);
+	lock_guard<mutex> lock(m_mutex);
+	if(type != TYPE_MODEL && m_watch_indexes.find(key) != m_watch_indexes.end())
+		return false;
+
+	m_watch_indexes[key] = (unsigned int)(mv_watches.size());
+	mv_watches.push_back(watch);
+	return true;
+}
+
+void AssetWatcher :: watchDependencies (const ObjModel& model)
+{
+	for(unsigned int l = 0; l < model.getMaterialLibraryCount(); l++)
+	{
+		const MtlLibrary* p_library = model.getMaterialLibrary(l);
+		if(p_library == NULL || !p_library->isLoadedSuccessfully())
+			continue;
+
+		addWatch(TYPE_MTL_LIBRARY, p_library->getFileNameWithPath(), NULL, NULL);
+		watchTextures(*p_library);
+	}
+}
+
+void AssetWatcher :: watchTextures (const MtlLibrary& library)
+{
+	for(unsigned int m = 0; m < library.getMaterialCount(); m++)
+	{
+		string texture = library.getMaterial(m)->getDisplayTextureFilename();
+		if(isBmpFile(texture))
+			addWatch(TYPE_TEXTURE, texture, NULL, NULL);
+	}
+}
+
+void AssetWatcher :: checkFiles ()
+{
+	vector<Watch> v_watches;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		v_watches = mv_watches;
+	}
+
+	// only this job changes the file statuses
+	for(unsigned int i = 0; i < v_watches.size(); i++)
+	{
+		long long modified = v_watches[i].m_modified;
+		long long size     = v_watches[i].m_size;
+		if(!getFileStatus(v_watches[i].m_filename, modified, size))
+			continue;
+		if(modified == v_watches[i].m_modified && size == v_watches[i].m_size)
+			continue;
+
+		unsigned int type = v_watches[i].m_type;
+		string filename = v_watches[i].m_filename;
+		unsigned int change_count;
+		{
+			lock_guard<mutex> lock(m_mutex);
+			Watch& r_watch = mv_watches[i];
+			r_watch.m_modified = modified;
+			r_watch.m_size = size;
+			r_watch.m_change_count++;
+			change_count = r_watch.m_change_count;
+			m_job_count++;
+		}
+
+		JobSystem::getShared().add([this, i, type, filename, change_count] ()
+		                           { reloadFile(i, type, filename, change_count); },
+		                           JobSystem::PRIORITY_LOW);
+	}
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_is_checking = false;
+	}
+	endJob();
+}
+
+void AssetWatcher :: reloadFile (unsigned int watch,
+                                 unsigned int type,
+                                 const string& filename,
+                                 unsigned int change_count)
+{
+	assert(type == TYPE_MODEL || type == TYPE_MTL_LIBRARY || type == TYPE_TEXTURE);
+
+	Reload reload;
+	reload.m_watch = watch;
+	reload.m_change_count = change_count;
+	reload.mp_model = NULL;
+	reload.mp_library = NULL;
+	reload.mp_image = NULL;
+
+	stringstream log;
+	switch(type)
+	{
+	case TYPE_MODEL:
+		reload.mp_model = new ObjModel();
+		reload.mp_model->load(filename, log);
+		break;
+	case TYPE_MTL_LIBRARY:
+		reload.mp_library = new MtlLibrary(filename, log);
+		break;
+	case TYPE_TEXTURE:
+		if(isBmpFile(filename))
+			reload.mp_image = new TextureBmp(filename, log);
+		else
+			log << "Warning: Only .bmp textures can be reloaded: " << filename << endl;
+		break;
+	}
+	reload.m_log = log.str();
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		mv_reloads.push_back(reload);
+	}
+	endJob();
+}
+
+bool AssetWatcher :: applyReload (const Reload& reload)
+{
+	assert(reload.m_watch < mv_watches.size());
+
+	Watch watch;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		watch = mv_watches[reload.m_watch];
+	}
+
+	// a newer reload is coming
+	if(reload.m_change_count != watch.m_change_count)
+		return false;
+
+	switch(watch.m_type)
+	{
+	case TYPE_MODEL:
+		assert(reload.mp_model != NULL);
+		assert(watch.mp_model != NULL);
+		*(watch.mp_model) = move(*(reload.mp_model));
+		if(watch.mp_display_list != NULL)
+			*(watch.mp_display_list) = watch.mp_model->getDisplayList();
+		watchDependencies(*(watch.mp_model));
+		return true;
+
+	case TYPE_MTL_LIBRARY:
+		{
+			assert(reload.mp_library != NULL);
+			if(!reload.mp_library->isLoadedSuccessfully())
+				return false;
+
+			// the models refer to the MtlLibrary in the manager
+			//  and to its Materials, so neither can move
+			MtlLibrary* p_library;
+			if(MtlLibraryManager::isLoaded(watch.m_filename))
+			{
+				p_library = &(MtlLibraryManager::get(watch.m_filename));
+				p_library->updateMaterials(move(*(reload.mp_library)));
+			}
+			else
+				p_library = &(MtlLibraryManager::add(*(reload.mp_library)));
+			recordDisplayLists(p_library, "");
+			watchTextures(*p_library);
+		}
+		return true;
+
+	case TYPE_TEXTURE:
+		if(reload.mp_image == NULL || reload.mp_image->isBad())
+			return false;
+
+		if(TextureManager::isLoaded(watch.m_filename))
+			TextureManager::replace(*(reload.mp_image), watch.m_filename);
+		else
+			TextureManager::add(*(reload.mp_image), watch.m_filename);
+		recordDisplayLists(NULL, ObjStringParsing::toLowercase(watch.m_filename));
+		return true;
+	}
+
+	assert(false);
+	return false;
+}
+
+void AssetWatcher :: recordDisplayLists (const MtlLibrary* p_library,
+                                         const string& texture)
+{
+	vector<Watch> v_watches;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		v_watches = mv_watches;
+	}
+
+	for(unsigned int i = 0; i < v_watches.size(); i++)
+	{
+		if(v_watches[i].m_type != TYPE_MODEL)
+			continue;
+
+		const ObjModel& model = *(v_watches[i].mp_model);
+		bool is_using = false;
+		for(unsigned int l = 0; l < model.getMaterialLibraryCount() && !is_using; l++)
+		{
+			const MtlLibrary* p_model_library = model.getMaterialLibrary(l);
+			if(p_model_library == NULL)
+				continue;
+			if(p_model_library == p_library)
+				is_using = true;
+			else if(texture != "")
+			{
+				for(unsigned int m = 0; m < p_model_library->getMaterialCount() && !is_using; m++)
+				{
+					string name = p_model_library->getMaterial(m)->getDisplayTextureFilename();
+					if(ObjStringParsing::toLowercase(name) == texture)
+						is_using = true;
+				}
+			}
+		}
+
+		if(is_using)
+		{
+			model.invalidateDrawCache();
+			if(v_watches[i].mp_display_list != NULL)
+				*(v_watches[i].mp_display_list) = model.getDisplayList();
+		}
+	}
+}
+
+void AssetWatcher :: endJob ()
+{
+	lock_guard<mutex> lock(m_mutex);
+	assert(m_job_count > 0);
+	m_job_count--;
+	m_jobs_condition.notify_all();
+}
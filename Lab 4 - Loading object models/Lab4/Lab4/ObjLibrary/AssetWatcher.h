@@ -0,0 +1,476 @@
+//
+//  AssetWatcher.h
+//
+//  A module to reload ObjModels, MtlLibraries, and textures
+//    when their files change.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_ASSET_WATCHER_H
+#define OBJ_LIBRARY_ASSET_WATCHER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+
+
+
+namespace ObjLibrary
+{
+
+class ObjModel;
+class MtlLibrary;
+class TextureBmp;
+class DisplayList;
+
+
+
+//
+//  AssetWatcher
+//
+//  A class to watch the files for loaded assets and reload
+//    them when they change, so that models can be edited while
+//    a program is running.  Models, material libraries, and
+//    textures in .bmp files can be watched.
+//
+//  The files are checked by a job on the shared JobSystem every
+//    so often.  A file has changed if its modification time or
+//    size is different.  Each changed file is then loaded again
+//    by its own job.  The reloaded assets are not used until
+//    update is called on the thread with the OpenGL context.
+//    update then replaces the old assets between frames:
+//    -> A watched ObjModel is assigned the reloaded model, and
+//       its DisplayList, if any, is recorded again
+//    -> The Materials in the MtlLibrary in the MtlLibraryManager
+//       are assigned the reloaded values with
+//       MtlLibrary::updateMaterials, so every ObjModel that
+//       uses them, watched or not, sees the new values
+//    -> The texture in the TextureManager is replaced with
+//       TextureManager::replace
+//    Whenever a material library or texture is replaced, the
+//    DisplayLists for the watched models that use it are also
+//    recorded again.
+//
+//  If a file changes again before its reload is used, the older
+//    reload is discarded.  If a file is removed, it is not
+//    reloaded until it exists again.
+//
+//  An AssetWatcher must only be used from one thread, normally
+//    the one with the OpenGL context.  The watched ObjModels
+//    and DisplayLists must not be destroyed before the
+//    AssetWatcher.
+//
+class AssetWatcher
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new AssetWatcher that is not watching
+//           any files.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new AssetWatcher is created.  The files will
+//               be checked every half second.
+//
+	AssetWatcher ();
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy this AssetWatcher.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This function waits for any checking or
+//               reloading jobs to finish.  Then all dynamically
+//               allocated memory is freed.  Reloads that have
+//               not been used are discarded.
+//
+	~AssetWatcher ();
+
+//
+//  getWatchCount
+//
+//  Purpose: To determine the number of files being watched.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of files being watched.
+//  Side Effect: N/A
+//
+	unsigned int getWatchCount () const;
+
+//
+//  getReloadCount
+//
+//  Purpose: To determine how many times a reloaded asset has
+//           been used.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of assets that have been replaced by
+//           update.
+//  Side Effect: N/A
+//
+	unsigned int getReloadCount () const;
+
+//
+//  getPendingCount
+//
+//  Purpose: To determine how many reloaded assets are waiting
+//           to be used.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of reloads that update has not used yet.
+//  Side Effect: N/A
+//
+	unsigned int getPendingCount () const;
+
+//
+//  getCheckInterval
+//
+//  Purpose: To determine how often the files are checked.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The time between checks, in seconds.
+//  Side Effect: N/A
+//
+	double getCheckInterval () const
+	{ return m_check_interval; }
+
+//
+//  setCheckInterval
+//
+//  Purpose: To change how often the files are checked.
+//  Parameter(s):
+//    <1> seconds: The time between checks
+//  Precondition(s):
+//    <1> seconds >= 0.0
+//  Returns: N/A
+//  Side Effect: The files will be checked about every seconds
+//               seconds.
+//
+	void setCheckInterval (double seconds);
+
+//
+//  watchModel
+//
+//  Purpose: To start watching the file for a model.
+//  Parameter(s):
+//    <1> r_model: The ObjModel to update
+//    <2> r_display_list: The DisplayList to record again when
+//                        r_model changes
+//    <3> filename: The name of the file r_model was loaded
+//                  from
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: N/A
+//  Side Effect: File filename is watched.  When it changes, it
+//               is loaded again and r_model is assigned the new
+//               model.  If r_display_list is specified, it is
+//               then set to r_model.getDisplayList().  The
+//               material libraries r_model uses and the .bmp
+//               textures they display are also watched, if
+//               they are not already.
+//
+	void watchModel (ObjModel& r_model,
+	                 const std::string& filename);
+	void watchModel (ObjModel& r_model,
+	                 DisplayList& r_display_list,
+	                 const std::string& filename);
+
+//
+//  watchMtlLibrary
+//
+//  Purpose: To start watching the file for a material library.
+//  Parameter(s):
+//    <1> name: The name of the material library, as used by
+//              the MtlLibraryManager
+//  Precondition(s):
+//    <1> name != ""
+//  Returns: N/A
+//  Side Effect: If file name is not already watched, it is
+//               watched.  When it changes, it is loaded again
+//               and replaces the MtlLibrary with the same name
+//               in the MtlLibraryManager.
+//
+	void watchMtlLibrary (const std::string& name);
+
+//
+//  watchTexture
+//
+//  Purpose: To start watching the file for a texture.
+//  Parameter(s):
+//    <1> name: The name of the texture, as used by the
+//              TextureManager
+//  Precondition(s):
+//    <1> name != ""
+//  Returns: N/A
+//  Side Effect: If file name is not already watched, it is
+//               watched.  When it changes, it is loaded again
+//               and replaces the texture with the same name in
+//               the TextureManager.  Only .bmp files can be
+//               reloaded.
+//
+	void watchTexture (const std::string& name);
+
+//
+//  check
+//
+//  Purpose: To check the watched files now.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If the files are not already being checked, a
+//               job is added to check them.  A job is added to
+//               reload each file that has changed.
+//
+	void check ();
+
+//
+//  update
+//
+//  Purpose: To check the files if it is time to, and to use
+//           any assets that have been reloaded.
+//  Parameter(s):
+//    <1> seconds: The time since the last call to update
+//  Precondition(s):
+//    <1> seconds >= 0.0
+//    <2> This function is called from the thread with the
+//        OpenGL context
+//  Returns: The number of assets replaced.
+//  Side Effect: If getCheckInterval() seconds have passed since
+//               the files were last checked, check is called.
+//               Each asset that has finished reloading replaces
+//               the one it was loaded for, and any DisplayLists
+//               that depend on it are recorded again.  Any
+//               loading errors are written to the standard
+//               error stream.
+//
+	unsigned int update (double seconds);
+
+private:
+//
+//  Type constants
+//
+//  The types of file that can be watched.
+//
+	static const unsigned int TYPE_MODEL       = 0;
+	static const unsigned int TYPE_MTL_LIBRARY = 1;
+	static const unsigned int TYPE_TEXTURE     = 2;
+
+//
+//  Watch
+//
+//  A record to store a watched file.  m_change_count is
+//    increased each time the file changes, so that a reload
+//    for an older change can be recognized.
+//
+	struct Watch
+	{
+		unsigned int m_type;
+		std::string m_filename;
+		ObjModel* mp_model;
+		DisplayList* mp_display_list;
+		long long m_modified;
+		long long m_size;
+		unsigned int m_change_count;
+	};
+
+//
+//  Reload
+//
+//  A record to store an asset that has been loaded again.
+//    Only the pointer for the type of the watch is used.
+//
+	struct Reload
+	{
+		unsigned int m_watch;
+		unsigned int m_change_count;
+		ObjModel* mp_model;
+		MtlLibrary* mp_library;
+		TextureBmp* mp_image;
+		std::string m_log;
+	};
+
+//
+//  Helper Function: addWatch
+//
+//  Purpose: To start watching a file.
+//  Parameter(s):
+//    <1> type: The type of the file
+//    <2> filename: The name of the file
+//    <3> p_model: The ObjModel to update, or NULL
+//    <4> p_display_list: The DisplayList to record again, or
+//                        NULL
+//  Precondition(s):
+//    <1> type is a TYPE_* constant
+//    <2> filename != ""
+//  Returns: Whether a new watch was added.
+//  Side Effect: If type is not TYPE_MODEL and filename is
+//               already watched, nothing happens.  Otherwise,
+//               file filename is watched.
+//
+	bool addWatch (unsigned int type,
+	               const std::string& filename,
+	               ObjModel* p_model,
+	               DisplayList* p_display_list);
+
+//
+//  Helper Function: watchDependencies
+//
+//  Purpose: To watch the material libraries and textures used
+//           by a model.
+//  Parameter(s):
+//    <1> model: The ObjModel
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Each material library model uses, and each
+//               .bmp texture they display, is watched if it is
+//               not already.
+//
+	void watchDependencies (const ObjModel& model);
+
+//
+//  Helper Function: watchTextures
+//
+//  Purpose: To watch the textures displayed by a material
+//           library.
+//  Parameter(s):
+//    <1> library: The MtlLibrary
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Each .bmp texture displayed by a Material in
+//               library is watched if it is not already.
+//
+	void watchTextures (const MtlLibrary& library);
+
+//
+//  Helper Function: checkFiles
+//
+//  Purpose: To check all watched files for changes.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A job is added to reload each watched file that
+//               has changed since it was last checked.
+//
+	void checkFiles ();
+
+//
+//  Helper Function: reloadFile
+//
+//  Purpose: To load a watched file again.
+//  Parameter(s):
+//    <1> watch: Which watch
+//    <2> type: The type of the file
+//    <3> filename: The name of the file
+//    <4> change_count: The change the file is being reloaded
+//                      for
+//  Precondition(s):
+//    <1> type is a TYPE_* constant
+//  Returns: N/A
+//  Side Effect: File filename is loaded and the result is
+//               queued for update.
+//
+	void reloadFile (unsigned int watch,
+	                 unsigned int type,
+	                 const std::string& filename,
+	                 unsigned int change_count);
+
+//
+//  Helper Function: applyReload
+//
+//  Purpose: To replace an asset with the version that was
+//           loaded again.
+//  Parameter(s):
+//    <1> reload: The reloaded asset
+//  Precondition(s):
+//    <1> reload.m_watch < mv_watches.size()
+//    <2> This function is called from the thread with the
+//        OpenGL context
+//  Returns: Whether the asset was replaced.
+//  Side Effect: The asset for watch reload.m_watch is replaced,
+//               and the DisplayLists that depend on it are
+//               recorded again.  The reloaded model or
+//               material library is moved out of reload.
+//
+	bool applyReload (const Reload& reload);
+
+//
+//  Helper Function: recordDisplayLists
+//
+//  Purpose: To record the DisplayLists for models that use a
+//           material library or texture again.
+//  Parameter(s):
+//    <1> p_library: The MtlLibrary, or NULL
+//    <2> texture: The name of the texture, or ""
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The draw cache of each watched model that uses
+//               p_library or displays texture texture is
+//               invalidated.  If that model has a watched
+//               DisplayList, it is set to its model's display
+//               list.
+//
+	void recordDisplayLists (const MtlLibrary* p_library,
+	                         const std::string& texture);
+
+//
+//  Helper Function: endJob
+//
+//  Purpose: To record that a job for this AssetWatcher has
+//           finished.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The number of running jobs is decreased and any
+//               thread waiting for the jobs is woken.
+//
+	void endJob ();
+
+//
+//  Copy Constructor
+//  Assignment Operator
+//
+//  These functions have intentionally not been implemented
+//    because the jobs refer to the AssetWatcher that added
+//    them.
+//
+	AssetWatcher (const AssetWatcher& original);
+	AssetWatcher& operator= (const AssetWatcher& original);
+
+private:
+	mutable std::mutex m_mutex;
+	std::condition_variable m_jobs_condition;
+	std::vector<Watch> mv_watches;
+	std::unordered_map<std::string, unsigned int> m_watch_indexes;
+	std::vector<Reload> mv_reloads;
+	unsigned int m_job_count;
+	bool m_is_checking;
+	double m_check_interval;
+	double m_since_check;
+	unsigned int m_reload_count;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -0,0 +1,259 @@
+//
+//  ComponentPool.h
+//
+//  A module to store one type of component for many entities.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_COMPONENT_POOL_H
+#define OBJ_LIBRARY_COMPONENT_POOL_H
+
+#include <cassert>
+#include <vector>
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  ComponentPool
+//
+//  A class template to store components of type T as a sparse
+//    set.  The components are kept in one contiguous (dense)
+//    array with no gaps, so a system can loop over all of them
+//    directly.  A second (sparse) array maps each entity index
+//    to the position of its component in the dense array.
+//    Adding, removing, and finding a component all take
+//    constant time.  Removing a component moves the last
+//    component into its place, so the order of the dense array
+//    is not stable.
+//
+//  Entities are identified by an index (used to look up the
+//    sparse array) and a handle (stored with the component, so
+//    a system can find the other components of the entity).
+//    The EntityRegistry supplies both.
+//
+template <typename T>
+class ComponentPool
+{
+public:
+//
+//  NO_COMPONENT
+//
+//  A dense index that does not refer to any component.
+//
+	static const unsigned int NO_COMPONENT = 0xFFFFFFFF;
+
+public:
+//
+//  getCount
+//
+//  Purpose: To determine the number of components.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of components in this ComponentPool.
+//  Side Effect: N/A
+//
+	unsigned int getCount () const
+	{ return (unsigned int)(mv_components.size()); }
+
+//
+//  isComponent
+//
+//  Purpose: To determine if an entity has a component.
+//  Parameter(s):
+//    <1> index: The entity index
+//  Precondition(s): N/A
+//  Returns: Whether the entity with index index has a component
+//           in this ComponentPool.
+//  Side Effect: N/A
+//
+	bool isComponent (unsigned int index) const
+	{
+		return index < mv_sparse.size() &&
+		       mv_sparse[index] != NO_COMPONENT;
+	}
+
+//
+//  getDenseIndex
+//
+//  Purpose: To determine where the component for an entity is
+//           stored.
+//  Parameter(s):
+//    <1> index: The entity index
+//  Precondition(s):
+//    <1> isComponent(index)
+//  Returns: The index in the dense array of the component for
+//           the entity with index index.
+//  Side Effect: N/A
+//
+	unsigned int getDenseIndex (unsigned int index) const
+	{
+		assert(isComponent(index));
+		return mv_sparse[index];
+	}
+
+//
+//  get
+//
+//  Purpose: To retrieve the component for an entity.
+//  Parameter(s):
+//    <1> index: The entity index
+//  Precondition(s):
+//    <1> isComponent(index)
+//  Returns: The component for the entity with index index.
+//  Side Effect: N/A
+//
+	const T& get (unsigned int index) const
+	{ return mv_components[getDenseIndex(index)]; }
+	T& get (unsigned int index)
+	{ return mv_components[getDenseIndex(index)]; }
+
+//
+//  getDense
+//
+//  Purpose: To retrieve a component by its position in the
+//           dense array.
+//  Parameter(s):
+//    <1> dense: The index in the dense array
+//  Precondition(s):
+//    <1> dense < getCount()
+//  Returns: Component dense in the dense array.
+//  Side Effect: N/A
+//
+	const T& getDense (unsigned int dense) const
+	{
+		assert(dense < getCount());
+		return mv_components[dense];
+	}
+	T& getDense (unsigned int dense)
+	{
+		assert(dense < getCount());
+		return mv_components[dense];
+	}
+
+//
+//  getEntity
+//
+//  Purpose: To determine which entity a component belongs to.
+//  Parameter(s):
+//    <1> dense: The index in the dense array
+//  Precondition(s):
+//    <1> dense < getCount()
+//  Returns: The handle of the entity for component dense in the
+//           dense array.
+//  Side Effect: N/A
+//
+	unsigned int getEntity (unsigned int dense) const
+	{
+		assert(dense < getCount());
+		return mv_entities[dense];
+	}
+
+//
+//  add
+//
+//  Purpose: To add a component for an entity.
+//  Parameter(s):
+//    <1> index: The entity index
+//    <2> entity: The entity handle
+//    <3> component: The component to add
+//  Precondition(s):
+//    <1> !isComponent(index)
+//  Returns: The new component.
+//  Side Effect: A copy of component is added for the entity
+//               with index index.
+//
+	T& add (unsigned int index,
+	        unsigned int entity,
+	        const T& component)
+	{
+		assert(!isComponent(index));
+
+		if(index >= mv_sparse.size())
+			mv_sparse.resize(index + 1, NO_COMPONENT);
+		mv_sparse[index] = getCount();
+		mv_indexes.push_back(index);
+		mv_entities.push_back(entity);
+		mv_components.push_back(component);
+		return mv_components.back();
+	}
+
+//
+//  remove
+//
+//  Purpose: To remove the component for an entity.
+//  Parameter(s):
+//    <1> index: The entity index
+//  Precondition(s):
+//    <1> isComponent(index)
+//  Returns: N/A
+//  Side Effect: The component for the entity with index index
+//               is removed.  The last component is moved into
+//               its place in the dense array.
+//
+	void remove (unsigned int index)
+	{
+		assert(isComponent(index));
+
+		unsigned int dense = mv_sparse[index];
+		if(dense != getCount() - 1)
+		{
+			mv_indexes   [dense] = mv_indexes.back();
+			mv_entities  [dense] = mv_entities.back();
+			mv_components[dense] = mv_components.back();
+			mv_sparse[mv_indexes[dense]] = dense;
+		}
+		mv_sparse[index] = NO_COMPONENT;
+		mv_indexes.pop_back();
+		mv_entities.pop_back();
+		mv_components.pop_back();
+	}
+
+//
+//  clear
+//
+//  Purpose: To remove all components.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All components are removed.
+//
+	void clear ()
+	{
+		mv_sparse.clear();
+		mv_indexes.clear();
+		mv_entities.clear();
+		mv_components.clear();
+	}
+
+private:
+	std::vector<unsigned int> mv_sparse;
+	std::vector<unsigned int> mv_indexes;
+	std::vector<unsigned int> mv_entities;
+	std::vector<T> mv_components;
+};
+
+template <typename T>
+const unsigned int ComponentPool<T> :: NO_COMPONENT;
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
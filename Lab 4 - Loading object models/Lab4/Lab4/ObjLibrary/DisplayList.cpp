@@ -27,6 +27,22 @@ using namespace ObjLibrary;
 
 
 
+namespace
+{
+	// OpenGL contexts are current on one thread at a time, so
+	//  each thread tracks its own list
+	thread_local bool t_is_compiling = false;
+}
+
+
+
+bool DisplayList :: isCompiling ()
+{
+	return t_is_compiling;
+}
+
+
+
 DisplayList :: DisplayList ()
 {
 	mp_data = NULL;
@@ -130,6 +146,7 @@ void DisplayList :: begin ()
 	mp_data->m_list_id = glGenLists(1);
 
 	glNewList(mp_data->m_list_id, GL_COMPILE);
+	t_is_compiling = true;
 
 	assert(getState() == PARTIAL);
 }
@@ -139,6 +156,7 @@ void DisplayList :: end ()
 	assert(isPartial());
 
 	glEndList();
+	t_is_compiling = false;
 
 	assert(mp_data->m_usages == 0);
 	mp_data->m_usages = 1;
@@ -94,6 +94,25 @@ public:
 //
 	static const unsigned int READY = 2;
 
+public:
+//
+//  isCompiling
+//
+//  Purpose: To determine if a DisplayList is being specified
+//           on the calling thread.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether begin() has been called on a DisplayList
+//           on this thread and end() has not been called on it
+//           yet.  OpenGL display lists cannot be nested, so
+//           code that would build its own list should draw
+//           directly instead.  This is much faster than asking
+//           OpenGL for GL_LIST_INDEX.  Display lists started
+//           with glNewList directly are not counted.
+//  Side Effect: N/A
+//
+	static bool isCompiling ();
+
 public:
 //
 //  Default Constructor
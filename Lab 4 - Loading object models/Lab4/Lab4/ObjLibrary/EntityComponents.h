@@ -0,0 +1,180 @@
+//
+//  EntityComponents.h
+//
+//  A module to declare the component types used by
+//    EntityRegistry.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_ENTITY_COMPONENTS_H
+#define OBJ_LIBRARY_ENTITY_COMPONENTS_H
+
+#include <vector>
+
+#include "Vector3.h"
+#include "Vector3Array.h"
+#include "Quaternion.h"
+#include "Matrix44.h"
+#include "DisplayList.h"
+
+
+
+namespace ObjLibrary
+{
+
+class ObjModel;
+class AnimationPlayer;
+
+
+
+//
+//  TransformComponent
+//
+//  A record to store where an entity is.  The world matrix is
+//    calculated from the position, rotation, and scale by
+//    updateTransforms in EntitySystems.h.
+//
+struct TransformComponent
+{
+	Vector3 m_position;
+	Quaternion m_rotation;
+	Vector3 m_scale;
+	Matrix44 m_world;
+
+	TransformComponent ()
+			: m_position(),
+			  m_rotation(),
+			  m_scale(1.0, 1.0, 1.0),
+			  m_world()
+	{ }
+
+	TransformComponent (const Vector3& position)
+			: m_position(position),
+			  m_rotation(),
+			  m_scale(1.0, 1.0, 1.0),
+			  m_world(Matrix44::getTranslation(position))
+	{ }
+};
+
+//
+//  RenderableComponent
+//
+//  A record to store what to draw for an entity.  If the
+//    DisplayList is ready, it is drawn.  Otherwise, the
+//    ObjModel is drawn if it is not NULL.  The ObjModel is not
+//    owned by the component.
+//
+struct RenderableComponent
+{
+	const ObjModel* mp_model;
+	DisplayList m_display_list;
+
+	RenderableComponent ()
+			: mp_model(NULL),
+			  m_display_list()
+	{ }
+
+	RenderableComponent (const ObjModel* p_model)
+			: mp_model(p_model),
+			  m_display_list()
+	{ }
+
+	RenderableComponent (const DisplayList& display_list)
+			: mp_model(NULL),
+			  m_display_list(display_list)
+	{ }
+};
+
+//
+//  ParticleEmitterComponent
+//
+//  A record to store a particle emitter and its particles.  New
+//    particles start at the emitter's world position, moving at
+//    m_speed in direction m_direction scattered randomly by up
+//    to m_spread in each axis, and then fall under m_gravity
+//    until they are m_lifetime seconds old.  The particles are
+//    stored as a structure of arrays so they can be moved in
+//    batches.
+//
+struct ParticleEmitterComponent
+{
+	double m_rate;
+	double m_speed;
+	double m_spread;
+	double m_lifetime;
+	Vector3 m_direction;
+	Vector3 m_gravity;
+	unsigned int m_max_particles;
+
+	double m_to_emit;
+	unsigned int m_random;
+	Vector3Array<float> m_positions;
+	Vector3Array<float> m_velocities;
+	std::vector<float> mv_ages;
+
+	ParticleEmitterComponent ()
+			: m_rate(100.0),
+			  m_speed(1.0),
+			  m_spread(0.5),
+			  m_lifetime(2.0),
+			  m_direction(0.0, 1.0, 0.0),
+			  m_gravity(0.0, -1.0, 0.0),
+			  m_max_particles(1000),
+			  m_to_emit(0.0),
+			  m_random(1),
+			  m_positions(),
+			  m_velocities(),
+			  mv_ages()
+	{ }
+};
+
+//
+//  AnimationComponent
+//
+//  A record to connect an entity to tracks in an
+//    AnimationPlayer.  The AnimationPlayer is not owned by the
+//    component, and may be shared by many entities.  Either
+//    track may be NO_TRACK.
+//
+struct AnimationComponent
+{
+	static const unsigned int NO_TRACK = 0xFFFFFFFF;
+
+	const AnimationPlayer* mp_player;
+	unsigned int m_position_track;
+	unsigned int m_rotation_track;
+
+	AnimationComponent ()
+			: mp_player(NULL),
+			  m_position_track(NO_TRACK),
+			  m_rotation_track(NO_TRACK)
+	{ }
+
+	AnimationComponent (const AnimationPlayer* p_player,
+	                    unsigned int position_track,
+	                    unsigned int rotation_track)
+			: mp_player(p_player),
+			  m_position_track(position_track),
+			  m_rotation_track(rotation_track)
+	{ }
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
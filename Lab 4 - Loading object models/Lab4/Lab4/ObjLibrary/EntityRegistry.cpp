@@ -0,0 +1,173 @@
+//
+//  EntityRegistry.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <vector>
+
+#include "ComponentPool.h"
+#include "EntityComponents.h"
+#include "EntityRegistry.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+const unsigned int AnimationComponent :: NO_TRACK;
+
+const unsigned int EntityRegistry :: NO_ENTITY;
+const unsigned int EntityRegistry :: MAX_ENTITY_COUNT;
+const unsigned int EntityRegistry :: COMPONENT_TRANSFORM;
+const unsigned int EntityRegistry :: COMPONENT_RENDERABLE;
+const unsigned int EntityRegistry :: COMPONENT_PARTICLE_EMITTER;
+const unsigned int EntityRegistry :: COMPONENT_ANIMATION;
+const unsigned int EntityRegistry :: INDEX_MASK;
+const unsigned int EntityRegistry :: GENERATION_SHIFT;
+
+
+
+EntityRegistry :: EntityRegistry ()
+		: m_entity_count(0)
+{
+}
+
+
+
+bool EntityRegistry :: isEntity (unsigned int entity) const
+{
+	unsigned int index = getIndex(entity);
+	return index < mv_generations.size() &&
+	       mv_is_alive[index] &&
+	       mv_generations[index] == (entity >> GENERATION_SHIFT);
+}
+
+template <>
+const ComponentPool<TransformComponent>& EntityRegistry :: getPool<TransformComponent> () const
+{
+	return m_transforms;
+}
+
+template <>
+const ComponentPool<RenderableComponent>& EntityRegistry :: getPool<RenderableComponent> () const
+{
+	return m_renderables;
+}
+
+template <>
+const ComponentPool<ParticleEmitterComponent>& EntityRegistry :: getPool<ParticleEmitterComponent> () const
+{
+	return m_particle_emitters;
+}
+
+template <>
+const ComponentPool<AnimationComponent>& EntityRegistry :: getPool<AnimationComponent> () const
+{
+	return m_animations;
+}
+
+template <>
+ComponentPool<TransformComponent>& EntityRegistry :: getPool<TransformComponent> ()
+{
+	return m_transforms;
+}
+
+template <>
+ComponentPool<RenderableComponent>& EntityRegistry :: getPool<RenderableComponent> ()
+{
+	return m_renderables;
+}
+
+template <>
+ComponentPool<ParticleEmitterComponent>& EntityRegistry :: getPool<ParticleEmitterComponent> ()
+{
+	return m_particle_emitters;
+}
+
+template <>
+ComponentPool<AnimationComponent>& EntityRegistry :: getPool<AnimationComponent> ()
+{
+	return m_animations;
+}
+
+
+
+unsigned int EntityRegistry :: createEntity ()
+{
+	assert(getEntityCount() < MAX_ENTITY_COUNT);
+
+	unsigned int index;
+	if(mv_free_indexes.empty())
+	{
+		index = (unsigned int)(mv_generations.size());
+		mv_generations.push_back(0);
+		mv_is_alive.push_back(0);
+	}
+	else
+	{
+		index = mv_free_indexes.back();
+		mv_free_indexes.pop_back();
+	}
+
+	assert(!mv_is_alive[index]);
+	mv_is_alive[index] = 1;
+	m_entity_count++;
+	return (mv_generations[index] << GENERATION_SHIFT) | index;
+}
+
+void EntityRegistry :: destroyEntity (unsigned int entity)
+{
+	assert(isEntity(entity));
+
+	unsigned int index = getIndex(entity);
+	if(m_transforms.isComponent(index))
+		m_transforms.remove(index);
+	if(m_renderables.isComponent(index))
+		m_renderables.remove(index);
+	if(m_particle_emitters.isComponent(index))
+		m_particle_emitters.remove(index);
+	if(m_animations.isComponent(index))
+		m_animations.remove(index);
+
+	// the generation wraps around after 256 reuses
+	mv_generations[index] = (mv_generations[index] + 1) & (0xFFFFFFFF >> GENERATION_SHIFT);
+	mv_is_alive[index] = 0;
+	mv_free_indexes.push_back(index);
+	assert(m_entity_count > 0);
+	m_entity_count--;
+}
+
+void EntityRegistry :: clear ()
+{
+	// keep the generations so old handles stay invalid
+	for(unsigned int i = 0; i < mv_generations.size(); i++)
+	{
+		if(mv_is_alive[i])
+		{
+			mv_generations[i] = (mv_generations[i] + 1) & (0xFFFFFFFF >> GENERATION_SHIFT);
+			mv_is_alive[i] = 0;
+			mv_free_indexes.push_back(i);
+		}
+	}
+	m_entity_count = 0;
+
+	m_transforms.clear();
+	m_renderables.clear();
+	m_particle_emitters.clear();
+	m_animations.clear();
+}
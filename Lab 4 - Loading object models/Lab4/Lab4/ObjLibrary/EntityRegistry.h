@@ -0,0 +1,310 @@
+//
+//  EntityRegistry.h
+//
+//  A module to store entities and their components.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_ENTITY_REGISTRY_H
+#define OBJ_LIBRARY_ENTITY_REGISTRY_H
+
+#include <cassert>
+#include <vector>
+
+#include "ComponentPool.h"
+#include "EntityComponents.h"
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  EntityRegistry
+//
+//  A class to store the entities in a scene.  An entity is
+//    just a handle; all its data is in components.  Each type
+//    of component is stored in its own ComponentPool, so the
+//    systems in EntitySystems.h loop over contiguous arrays
+//    instead of over objects.  An entity may have at most one
+//    component of each type.
+//
+//  The component types are:
+//    <1> TransformComponent
+//    <2> RenderableComponent
+//    <3> ParticleEmitterComponent
+//    <4> AnimationComponent
+//    Each has a COMPONENT_* bit, which is used by
+//    SystemScheduler to describe which components a system
+//    reads and writes.
+//
+//  An entity handle contains an index and a generation.  When
+//    an entity is destroyed, its index is reused, but with a
+//    new generation, so old handles no longer refer to an
+//    entity.  There can be at most MAX_ENTITY_COUNT entities at
+//    once.
+//
+class EntityRegistry
+{
+public:
+//
+//  NO_ENTITY
+//
+//  A handle value that never refers to an entity.
+//
+	static const unsigned int NO_ENTITY = 0xFFFFFFFF;
+
+//
+//  MAX_ENTITY_COUNT
+//
+//  The maximum number of entities that can exist at once.
+//
+	static const unsigned int MAX_ENTITY_COUNT = 0x00FFFFFF;
+
+//
+//  COMPONENT_*
+//
+//  The bits identifying each component type.
+//
+	static const unsigned int COMPONENT_TRANSFORM        = 0x1;
+	static const unsigned int COMPONENT_RENDERABLE       = 0x2;
+	static const unsigned int COMPONENT_PARTICLE_EMITTER = 0x4;
+	static const unsigned int COMPONENT_ANIMATION        = 0x8;
+
+public:
+//
+//  getIndex
+//
+//  Purpose: To determine the index part of an entity handle.
+//  Parameter(s):
+//    <1> entity: The entity handle
+//  Precondition(s): N/A
+//  Returns: The index for entity.  This can be used to look up
+//           components in a ComponentPool.
+//  Side Effect: N/A
+//
+	static unsigned int getIndex (unsigned int entity)
+	{ return entity & INDEX_MASK; }
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new EntityRegistry with no entities.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new, empty EntityRegistry is created.
+//
+	EntityRegistry ();
+
+//
+//  getEntityCount
+//
+//  Purpose: To determine the number of entities.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of entities that exist.
+//  Side Effect: N/A
+//
+	unsigned int getEntityCount () const
+	{ return m_entity_count; }
+
+//
+//  isEntity
+//
+//  Purpose: To determine if a handle refers to an entity.
+//  Parameter(s):
+//    <1> entity: The entity handle
+//  Precondition(s): N/A
+//  Returns: Whether entity refers to an entity that has not
+//           been destroyed.
+//  Side Effect: N/A
+//
+	bool isEntity (unsigned int entity) const;
+
+//
+//  has
+//
+//  Purpose: To determine if an entity has a component.
+//  Parameter(s):
+//    <1> entity: The entity
+//  Precondition(s):
+//    <1> isEntity(entity)
+//  Returns: Whether entity entity has a component of type T.
+//  Side Effect: N/A
+//
+	template <typename T>
+	bool has (unsigned int entity) const
+	{
+		assert(isEntity(entity));
+		return getPool<T>().isComponent(getIndex(entity));
+	}
+
+//
+//  get
+//
+//  Purpose: To retrieve a component of an entity.
+//  Parameter(s):
+//    <1> entity: The entity
+//  Precondition(s):
+//    <1> isEntity(entity)
+//    <2> has<T>(entity)
+//  Returns: The component of type T for entity entity.
+//  Side Effect: N/A
+//
+	template <typename T>
+	const T& get (unsigned int entity) const
+	{
+		assert(isEntity(entity));
+		assert(has<T>(entity));
+		return getPool<T>().get(getIndex(entity));
+	}
+	template <typename T>
+	T& get (unsigned int entity)
+	{
+		assert(isEntity(entity));
+		assert(has<T>(entity));
+		return getPool<T>().get(getIndex(entity));
+	}
+
+//
+//  getPool
+//
+//  Purpose: To retrieve all the components of one type.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> T is one of the component types listed above
+//  Returns: The ComponentPool for components of type T.
+//  Side Effect: N/A
+//
+	template <typename T>
+	const ComponentPool<T>& getPool () const;
+	template <typename T>
+	ComponentPool<T>& getPool ();
+
+//
+//  createEntity
+//
+//  Purpose: To create a new entity.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> getEntityCount() < MAX_ENTITY_COUNT
+//  Returns: The handle for the new entity.
+//  Side Effect: A new entity is created with no components.
+//
+	unsigned int createEntity ();
+
+//
+//  destroyEntity
+//
+//  Purpose: To destroy an entity.
+//  Parameter(s):
+//    <1> entity: The entity
+//  Precondition(s):
+//    <1> isEntity(entity)
+//  Returns: N/A
+//  Side Effect: Entity entity and all its components are
+//               removed.  entity is no longer a valid handle.
+//
+	void destroyEntity (unsigned int entity);
+
+//
+//  add
+//
+//  Purpose: To add a component to an entity.
+//  Parameter(s):
+//    <1> entity: The entity
+//    <2> component: The component to add
+//  Precondition(s):
+//    <1> isEntity(entity)
+//    <2> !has<T>(entity)
+//  Returns: The new component.
+//  Side Effect: A copy of component is added to entity entity.
+//
+	template <typename T>
+	T& add (unsigned int entity, const T& component)
+	{
+		assert(isEntity(entity));
+		assert(!has<T>(entity));
+		return getPool<T>().add(getIndex(entity), entity, component);
+	}
+
+//
+//  remove
+//
+//  Purpose: To remove a component from an entity.
+//  Parameter(s):
+//    <1> entity: The entity
+//  Precondition(s):
+//    <1> isEntity(entity)
+//    <2> has<T>(entity)
+//  Returns: N/A
+//  Side Effect: The component of type T is removed from entity
+//               entity.
+//
+	template <typename T>
+	void remove (unsigned int entity)
+	{
+		assert(isEntity(entity));
+		assert(has<T>(entity));
+		getPool<T>().remove(getIndex(entity));
+	}
+
+//
+//  clear
+//
+//  Purpose: To remove all entities.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All entities and components are removed.  All
+//               existing handles become invalid.
+//
+	void clear ();
+
+private:
+	static const unsigned int INDEX_MASK       = 0x00FFFFFF;
+	static const unsigned int GENERATION_SHIFT = 24;
+
+private:
+	// generation for each index, or of the next entity if free
+	std::vector<unsigned int> mv_generations;
+	std::vector<unsigned char> mv_is_alive;
+	std::vector<unsigned int> mv_free_indexes;
+	unsigned int m_entity_count;
+
+	ComponentPool<TransformComponent>       m_transforms;
+	ComponentPool<RenderableComponent>      m_renderables;
+	ComponentPool<ParticleEmitterComponent> m_particle_emitters;
+	ComponentPool<AnimationComponent>       m_animations;
+};
+
+template <> const ComponentPool<TransformComponent>&       EntityRegistry :: getPool<TransformComponent> () const;
+template <> const ComponentPool<RenderableComponent>&      EntityRegistry :: getPool<RenderableComponent> () const;
+template <> const ComponentPool<ParticleEmitterComponent>& EntityRegistry :: getPool<ParticleEmitterComponent> () const;
+template <> const ComponentPool<AnimationComponent>&       EntityRegistry :: getPool<AnimationComponent> () const;
+template <> ComponentPool<TransformComponent>&       EntityRegistry :: getPool<TransformComponent> ();
+template <> ComponentPool<RenderableComponent>&      EntityRegistry :: getPool<RenderableComponent> ();
+template <> ComponentPool<ParticleEmitterComponent>& EntityRegistry :: getPool<ParticleEmitterComponent> ();
+template <> ComponentPool<AnimationComponent>&       EntityRegistry :: getPool<AnimationComponent> ();
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
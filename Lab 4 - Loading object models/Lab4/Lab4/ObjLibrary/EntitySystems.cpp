@@ -0,0 +1,256 @@
+//
+//  EntitySystems.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "../GetGlut.h"
+#include "Vector3.h"
+#include "Vector3Array.h"
+#include "Quaternion.h"
+#include "Matrix44.h"
+#include "DisplayList.h"
+#include "ObjModel.h"
+#include "AnimationPlayer.h"
+#include "ComponentPool.h"
+#include "EntityComponents.h"
+#include "EntityRegistry.h"
+#include "SystemScheduler.h"
+#include "EntitySystems.h"
+
+using namespace std;
+using namespace ObjLibrary;
+using namespace ObjLibrary::EntitySystems;
+namespace
+{
+	//
+	//  getNextRandom
+	//
+	//  Purpose: To generate a psuedorandom number for a particle
+	//           emitter.
+	//  Parameter(s):
+	//    <1> r_state: The random state for the emitter
+	//  Precondition(s): N/A
+	//  Returns: A pseudorandom number in the range [0, 1).
+	//  Side Effect: r_state is advanced.
+	//  Note: rand() is not used because emitters may be updated
+	//        on other threads.
+	//
+	inline double getNextRandom (unsigned int& r_state)
+	{
+		r_state = r_state * 1664525u + 1013904223u;
+		return (r_state >> 8) / 16777216.0;
+	}
+
+	//
+	//  removeParticle
+	//
+	//  Purpose: To remove a particle from an emitter.
+	//  Parameter(s):
+	//    <1> r_emitter: The emitter
+	//    <2> particle: The particle to remove
+	//  Precondition(s):
+	//    <1> particle < r_emitter.mv_ages.size()
+	//  Returns: N/A
+	//  Side Effect: The last particle is moved into the place of
+	//               particle particle and the arrays are
+	//               shortened by 1.
+	//
+	void removeParticle (ParticleEmitterComponent& r_emitter,
+	                     unsigned int particle)
+	{
+		assert(particle < r_emitter.mv_ages.size());
+
+		unsigned int last = (unsigned int)(r_emitter.mv_ages.size() - 1);
+		if(particle != last)
+		{
+			r_emitter.mv_ages[particle] = r_emitter.mv_ages[last];
+			r_emitter.m_positions .set(particle, r_emitter.m_positions .get(last));
+			r_emitter.m_velocities.set(particle, r_emitter.m_velocities.get(last));
+		}
+		r_emitter.mv_ages.pop_back();
+		r_emitter.m_positions .resize(last);
+		r_emitter.m_velocities.resize(last);
+	}
+}
+
+
+
+void EntitySystems :: applyAnimations (EntityRegistry& r_registry,
+                                       double /* seconds */)
+{
+	const ComponentPool<AnimationComponent>& animations = r_registry.getPool<AnimationComponent>();
+	ComponentPool<TransformComponent>& transforms = r_registry.getPool<TransformComponent>();
+
+	for(unsigned int a = 0; a < animations.getCount(); a++)
+	{
+		unsigned int index = EntityRegistry::getIndex(animations.getEntity(a));
+		if(!transforms.isComponent(index))
+			continue;
+
+		const AnimationComponent& animation = animations.getDense(a);
+		assert(animation.mp_player != NULL);
+		TransformComponent& r_transform = transforms.get(index);
+		if(animation.m_position_track != AnimationComponent::NO_TRACK)
+			r_transform.m_position = animation.mp_player->getVector3(animation.m_position_track);
+		// the results are stored as floats, so normalize again
+		if(animation.m_rotation_track != AnimationComponent::NO_TRACK)
+			r_transform.m_rotation = animation.mp_player->getRotation(animation.m_rotation_track).getNormalized();
+	}
+}
+
+void EntitySystems :: updateTransforms (EntityRegistry& r_registry,
+                                        double /* seconds */)
+{
+	ComponentPool<TransformComponent>& transforms = r_registry.getPool<TransformComponent>();
+
+	for(unsigned int t = 0; t < transforms.getCount(); t++)
+	{
+		TransformComponent& r_transform = transforms.getDense(t);
+		const Quaternion& rotation = r_transform.m_rotation;
+		const Vector3& scale = r_transform.m_scale;
+
+		r_transform.m_world = Matrix44(rotation.getRotated(Vector3(scale.x, 0.0, 0.0)),
+		                               rotation.getRotated(Vector3(0.0, scale.y, 0.0)),
+		                               rotation.getRotated(Vector3(0.0, 0.0, scale.z)),
+		                               r_transform.m_position);
+	}
+}
+
+void EntitySystems :: updateParticleEmitters (EntityRegistry& r_registry,
+                                              double seconds)
+{
+	assert(seconds >= 0.0);
+
+	const ComponentPool<TransformComponent>& transforms = r_registry.getPool<TransformComponent>();
+	ComponentPool<ParticleEmitterComponent>& emitters = r_registry.getPool<ParticleEmitterComponent>();
+
+	for(unsigned int e = 0; e < emitters.getCount(); e++)
+	{
+		ParticleEmitterComponent& r_emitter = emitters.getDense(e);
+		unsigned int index = EntityRegistry::getIndex(emitters.getEntity(e));
+
+		// remove old particles
+		unsigned int p = 0;
+		while(p < r_emitter.mv_ages.size())
+		{
+			r_emitter.mv_ages[p] += (float)(seconds);
+			if(r_emitter.mv_ages[p] >= r_emitter.m_lifetime)
+				removeParticle(r_emitter, p);
+			else
+				p++;
+		}
+
+		// move the rest in batches
+		r_emitter.m_velocities.add(r_emitter.m_gravity * seconds);
+		r_emitter.m_positions.addScaled(r_emitter.m_velocities, seconds);
+
+		// emit new particles
+		Vector3 origin = Vector3::ZERO;
+		if(transforms.isComponent(index))
+			origin = transforms.get(index).m_world.getTransformedPoint(Vector3::ZERO);
+		Vector3 direction = r_emitter.m_direction.getNormalizedSafe();
+
+		r_emitter.m_to_emit += r_emitter.m_rate * seconds;
+		while(r_emitter.m_to_emit >= 1.0 &&
+		      r_emitter.mv_ages.size() < r_emitter.m_max_particles)
+		{
+			Vector3 scatter(getNextRandom(r_emitter.m_random) * 2.0 - 1.0,
+			                getNextRandom(r_emitter.m_random) * 2.0 - 1.0,
+			                getNextRandom(r_emitter.m_random) * 2.0 - 1.0);
+			Vector3 velocity = (direction + scatter * r_emitter.m_spread).getNormalizedSafe() *
+			                   r_emitter.m_speed;
+
+			r_emitter.m_positions.pushBack(origin);
+			r_emitter.m_velocities.pushBack(velocity);
+			r_emitter.mv_ages.push_back(0.0f);
+			r_emitter.m_to_emit -= 1.0;
+		}
+
+		// do not save up particles while the emitter is full
+		if(r_emitter.m_to_emit >= 1.0)
+			r_emitter.m_to_emit -= floor(r_emitter.m_to_emit);
+	}
+}
+
+void EntitySystems :: addUpdateSystems (SystemScheduler& r_scheduler)
+{
+	r_scheduler.addSystem("applyAnimations",
+	                      EntityRegistry::COMPONENT_ANIMATION,
+	                      EntityRegistry::COMPONENT_TRANSFORM,
+	                      applyAnimations);
+	r_scheduler.addSystem("updateTransforms",
+	                      EntityRegistry::COMPONENT_TRANSFORM,
+	                      EntityRegistry::COMPONENT_TRANSFORM,
+	                      updateTransforms);
+	r_scheduler.addSystem("updateParticleEmitters",
+	                      EntityRegistry::COMPONENT_TRANSFORM,
+	                      EntityRegistry::COMPONENT_PARTICLE_EMITTER,
+	                      updateParticleEmitters);
+}
+
+
+
+void EntitySystems :: drawRenderables (const EntityRegistry& registry,
+                                       const Matrix44& view)
+{
+	const ComponentPool<TransformComponent>& transforms = registry.getPool<TransformComponent>();
+	const ComponentPool<RenderableComponent>& renderables = registry.getPool<RenderableComponent>();
+
+	for(unsigned int r = 0; r < renderables.getCount(); r++)
+	{
+		unsigned int index = EntityRegistry::getIndex(renderables.getEntity(r));
+		if(!transforms.isComponent(index))
+			continue;
+
+		const RenderableComponent& renderable = renderables.getDense(r);
+		if(renderable.m_display_list.isReady())
+		{
+			(view * transforms.get(index).m_world).loadToOpenGL();
+			renderable.m_display_list.draw();
+		}
+		else if(renderable.mp_model != NULL)
+		{
+			(view * transforms.get(index).m_world).loadToOpenGL();
+			renderable.mp_model->draw();
+		}
+	}
+
+	view.loadToOpenGL();
+}
+
+void EntitySystems :: drawParticles (const EntityRegistry& registry,
+                                     const Matrix44& view)
+{
+	const ComponentPool<ParticleEmitterComponent>& emitters = registry.getPool<ParticleEmitterComponent>();
+
+	view.loadToOpenGL();
+	glBegin(GL_POINTS);
+	for(unsigned int e = 0; e < emitters.getCount(); e++)
+	{
+		const Vector3Array<float>& positions = emitters.getDense(e).m_positions;
+		const float* a_x = positions.getArrayX();
+		const float* a_y = positions.getArrayY();
+		const float* a_z = positions.getArrayZ();
+		for(unsigned int p = 0; p < positions.getSize(); p++)
+			glVertex3f(a_x[p], a_y[p], a_z[p]);
+	}
+	glEnd();
+}
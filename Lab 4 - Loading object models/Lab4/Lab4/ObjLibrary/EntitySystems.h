@@ -0,0 +1,166 @@
+//
+//  EntitySystems.h
+//
+//  A module to update and draw the components in an
+//    EntityRegistry.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_ENTITY_SYSTEMS_H
+#define OBJ_LIBRARY_ENTITY_SYSTEMS_H
+
+
+
+namespace ObjLibrary
+{
+
+class Matrix44;
+class EntityRegistry;
+class SystemScheduler;
+
+
+
+//
+//  EntitySystems
+//
+//  A namespace containing the standard systems for the
+//    component types in EntityComponents.h.  The update systems
+//    can be run by a SystemScheduler; addUpdateSystems adds
+//    them with the correct access sets.  The draw functions
+//    use OpenGL, so they must be called on the thread with the
+//    OpenGL context, after the SystemScheduler has finished.
+//
+namespace EntitySystems
+{
+//
+//  applyAnimations
+//
+//  Purpose: To copy animated values into the transforms.
+//  Parameter(s):
+//    <1> r_registry: The EntityRegistry
+//    <2> seconds: The time since the last frame (unused)
+//  Precondition(s):
+//    <1> The AnimationPlayers referred to by the
+//        AnimationComponents exist
+//  Returns: N/A
+//  Side Effect: For each entity with an AnimationComponent and
+//               a TransformComponent, the position and rotation
+//               of the transform are set from the current values
+//               of its tracks.  The AnimationPlayers are not
+//               updated.
+//  Reads: COMPONENT_ANIMATION
+//  Writes: COMPONENT_TRANSFORM
+//
+void applyAnimations (EntityRegistry& r_registry, double seconds);
+
+//
+//  updateTransforms
+//
+//  Purpose: To calculate the world matrices of the transforms.
+//  Parameter(s):
+//    <1> r_registry: The EntityRegistry
+//    <2> seconds: The time since the last frame (unused)
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The world matrix of each TransformComponent is
+//               set to translate, rotate, and scale by its
+//               position, rotation, and scale.
+//  Reads: COMPONENT_TRANSFORM
+//  Writes: COMPONENT_TRANSFORM
+//
+void updateTransforms (EntityRegistry& r_registry, double seconds);
+
+//
+//  updateParticleEmitters
+//
+//  Purpose: To advance the particles for all emitters.
+//  Parameter(s):
+//    <1> r_registry: The EntityRegistry
+//    <2> seconds: The time since the last frame
+//  Precondition(s):
+//    <1> seconds >= 0.0
+//  Returns: N/A
+//  Side Effect: Particles older than their lifetime are
+//               removed, the rest are moved, and new particles
+//               are emitted.  Emitters on entities with a
+//               TransformComponent emit from the world
+//               position of the transform.  Others emit from
+//               the origin.
+//  Reads: COMPONENT_TRANSFORM
+//  Writes: COMPONENT_PARTICLE_EMITTER
+//
+void updateParticleEmitters (EntityRegistry& r_registry,
+                             double seconds);
+
+//
+//  addUpdateSystems
+//
+//  Purpose: To add the update systems above to a
+//           SystemScheduler.
+//  Parameter(s):
+//    <1> r_scheduler: The SystemScheduler
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: applyAnimations, updateTransforms, and
+//               updateParticleEmitters are added to
+//               r_scheduler in that order.
+//
+void addUpdateSystems (SystemScheduler& r_scheduler);
+
+//
+//  drawRenderables
+//
+//  Purpose: To display all the entities that can be drawn.
+//  Parameter(s):
+//    <1> registry: The EntityRegistry
+//    <2> view: The camera (view) transform
+//  Precondition(s):
+//    <1> The ObjModels referred to by the
+//        RenderableComponents are valid
+//  Returns: N/A
+//  Side Effect: Each entity with a RenderableComponent and a
+//               TransformComponent is drawn with the OpenGL
+//               modelview matrix set to view times its world
+//               matrix.  Afterwards, the modelview matrix is set
+//               to view.
+//
+void drawRenderables (const EntityRegistry& registry,
+                      const Matrix44& view);
+
+//
+//  drawParticles
+//
+//  Purpose: To display the particles for all emitters.
+//  Parameter(s):
+//    <1> registry: The EntityRegistry
+//    <2> view: The camera (view) transform
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The OpenGL modelview matrix is set to view and
+//               each particle is drawn as a point in the current
+//               colour.
+//
+void drawParticles (const EntityRegistry& registry,
+                    const Matrix44& view);
+
+}  // end of namespace EntitySystems
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -0,0 +1,511 @@
+//
+//  JobSystem.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "JobSystem.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  tp_current_system
+	//  t_current_worker
+	//
+	//  The JobSystem and worker index for the calling thread, if
+	//    it is a worker thread.
+	//
+	thread_local const JobSystem* tp_current_system = NULL;
+	thread_local unsigned int t_current_worker = 0;
+}
+
+
+
+const unsigned int JobSystem :: NO_JOB;
+const unsigned int JobSystem :: PRIORITY_HIGH;
+const unsigned int JobSystem :: PRIORITY_NORMAL;
+const unsigned int JobSystem :: PRIORITY_LOW;
+const unsigned int JobSystem :: PRIORITY_COUNT;
+
+
+
+JobSystem& JobSystem :: getShared ()
+{
+	// one worker is always kept free of low-priority jobs
+	static JobSystem shared(thread::hardware_concurrency() > 3 ?
+	                        thread::hardware_concurrency() - 1 : 2);
+	return shared;
+}
+
+
+
+JobSystem :: JobSystem (unsigned int worker_count)
+		: m_max_low_running(worker_count - 1),
+		  m_next_job(NO_JOB + 1),
+		  m_is_stopping(false),
+		  m_low_running(0),
+		  m_next_worker(0),
+		  m_jobs_run_count(0),
+		  m_steal_count(0)
+{
+	assert(worker_count >= 1);
+
+	for(unsigned int p = 0; p < PRIORITY_COUNT; p++)
+		ma_queue_depths[p] = 0;
+
+	for(unsigned int i = 0; i < worker_count; i++)
+		mvp_workers.push_back(unique_ptr<Worker>(new Worker));
+
+	// start the threads after the vector is complete
+	for(unsigned int i = 0; i < worker_count; i++)
+		mvp_workers[i]->m_thread = thread(&JobSystem::workerMain, this, i);
+}
+
+JobSystem :: ~JobSystem ()
+{
+	waitAll();
+
+	{
+		lock_guard<mutex> lock(m_records_mutex);
+		m_is_stopping = true;
+	}
+	m_work_condition.notify_all();
+
+	for(unsigned int i = 0; i < mvp_workers.size(); i++)
+		mvp_workers[i]->m_thread.join();
+}
+
+
+
+bool JobSystem :: isDone (unsigned int job) const
+{
+	lock_guard<mutex> lock(m_records_mutex);
+	return m_records.find(job) == m_records.end();
+}
+
+unsigned int JobSystem :: getQueueDepth (unsigned int priority) const
+{
+	assert(priority < PRIORITY_COUNT);
+
+	return ma_queue_depths[priority];
+}
+
+unsigned int JobSystem :: getUnfinishedCount () const
+{
+	lock_guard<mutex> lock(m_records_mutex);
+	return (unsigned int)(m_records.size());
+}
+
+void JobSystem :: resetStatistics ()
+{
+	m_jobs_run_count = 0;
+	m_steal_count = 0;
+}
+
+
+
+unsigned int JobSystem :: add (const JobFunction& function,
+                               unsigned int priority)
+{
+	return add(function, vector<unsigned int>(), priority);
+}
+
+unsigned int JobSystem :: add (const JobFunction& function,
+                               const vector<unsigned int>& dependencies,
+                               unsigned int priority)
+{
+	assert(function);
+	assert(priority < PRIORITY_COUNT);
+
+	unsigned int job;
+	bool is_ready;
+	{
+		lock_guard<mutex> lock(m_records_mutex);
+		assert(!m_is_stopping);
+
+		do
+		{
+			job = m_next_job;
+			m_next_job++;
+		}
+		while(job == NO_JOB || m_records.find(job) != m_records.end());
+
+		Record& r_record = m_records[job];
+		r_record.m_function = function;
+		r_record.m_priority = priority;
+		r_record.m_dependency_count = 0;
+
+		// dependencies that are not in the table have finished
+		for(unsigned int i = 0; i < dependencies.size(); i++)
+		{
+			if(dependencies[i] == NO_JOB || dependencies[i] == job)
+				continue;
+			unordered_map<unsigned int, Record>::iterator it = m_records.find(dependencies[i]);
+			if(it != m_records.end())
+			{
+				it->second.mv_dependents.push_back(job);
+				r_record.m_dependency_count++;
+			}
+		}
+		is_ready = (r_record.m_dependency_count == 0);
+	}
+
+	if(is_ready)
+		enqueue(job, priority);
+	return job;
+}
+
+void JobSystem :: wait (unsigned int job)
+{
+	if(job == NO_JOB)
+		return;
+
+	unsigned int priority;
+	{
+		lock_guard<mutex> lock(m_records_mutex);
+		unordered_map<unsigned int, Record>::const_iterator it = m_records.find(job);
+		if(it == m_records.end())
+			return;
+		priority = it->second.m_priority;
+	}
+
+	unsigned int worker = getCurrentWorker();
+	for(;;)
+	{
+		// a waiting thread never lets the limit on low-priority
+		//  jobs keep it from running the job it needs
+		if(takeQueuedJob(job, priority))
+		{
+			runJob(job);
+			return;
+		}
+
+		unsigned int other;
+		if(takeJob(worker, priority, other))
+		{
+			runJob(other);
+			continue;
+		}
+
+		unique_lock<mutex> lock(m_records_mutex);
+		m_done_condition.wait(lock, [this, job, worker, priority] ()
+		{
+			return m_records.find(job) == m_records.end() ||
+			       isQueued(job) ||
+			       isWorkAvailable(worker, priority);
+		});
+		if(m_records.find(job) == m_records.end())
+			return;
+	}
+}
+
+void JobSystem :: waitAll ()
+{
+	unsigned int worker = getCurrentWorker();
+	for(;;)
+	{
+		unsigned int job;
+		if(takeJob(worker, PRIORITY_LOW, job))
+		{
+			runJob(job);
+			continue;
+		}
+
+		unique_lock<mutex> lock(m_records_mutex);
+		m_done_condition.wait(lock, [this, worker] ()
+		{
+			return m_records.empty() || isWorkAvailable(worker, PRIORITY_LOW);
+		});
+		if(m_records.empty())
+			return;
+	}
+}
+
+void JobSystem :: parallelFor (unsigned int count,
+                               unsigned int min_per_part,
+                               unsigned int max_parts,
+                               const RangeFunction& function,
+                               unsigned int priority)
+{
+	assert(min_per_part >= 1);
+	assert(max_parts >= 1);
+	assert(function);
+	assert(priority < PRIORITY_COUNT);
+
+	unsigned int part_count = count / min_per_part;
+	if(part_count > max_parts)
+		part_count = max_parts;
+	if(part_count > getWorkerCount() + 1)
+		part_count = getWorkerCount() + 1;
+	if(part_count < 1)
+		part_count = 1;
+
+	vector<unsigned int> v_jobs;
+	for(unsigned int i = 0; i + 1 < part_count; i++)
+	{
+		unsigned int begin = (unsigned int)((unsigned long long)(count) *  i      / part_count);
+		unsigned int end   = (unsigned int)((unsigned long long)(count) * (i + 1) / part_count);
+		v_jobs.push_back(add([&function, begin, end] () { function(begin, end); }, priority));
+	}
+
+	function((unsigned int)((unsigned long long)(count) * (part_count - 1) / part_count), count);
+
+	for(unsigned int i = 0; i < v_jobs.size(); i++)
+		wait(v_jobs[i]);
+}
+
+
+
+void JobSystem :: workerMain (unsigned int worker)
+{
+	assert(worker < getWorkerCount());
+
+	tp_current_system = this;
+	t_current_worker  = worker;
+
+	for(;;)
+	{
+		unsigned int job;
+		if(takeJob(worker, PRIORITY_LOW, job))
+		{
+			runJob(job);
+			continue;
+		}
+
+		unique_lock<mutex> lock(m_records_mutex);
+		m_work_condition.wait(lock, [this, worker] () { return m_is_stopping || isWorkAvailable(worker, PRIORITY_LOW); });
+		if(m_is_stopping)
+			return;
+	}
+}
+
+bool JobSystem :: isWorkAvailable (unsigned int worker,
+                                   unsigned int lowest_priority) const
+{
+	assert(worker <= getWorkerCount());
+	assert(lowest_priority < PRIORITY_COUNT);
+
+	for(unsigned int p = 0; p <= lowest_priority && p < PRIORITY_LOW; p++)
+		if(ma_queue_depths[p] > 0)
+			return true;
+	if(lowest_priority < PRIORITY_LOW || ma_queue_depths[PRIORITY_LOW] == 0)
+		return false;
+	return worker >= getWorkerCount() || m_low_running < m_max_low_running;
+}
+
+bool JobSystem :: isQueued (unsigned int job) const
+{
+	// a job is removed from the records when it finishes and
+	//  its function is moved out when it starts
+	unordered_map<unsigned int, Record>::const_iterator it = m_records.find(job);
+	if(it == m_records.end())
+		return false;
+	return it->second.m_dependency_count == 0 && it->second.m_function;
+}
+
+void JobSystem :: enqueue (unsigned int job, unsigned int priority)
+{
+	assert(priority < PRIORITY_COUNT);
+
+	unsigned int worker = getCurrentWorker();
+	if(worker >= getWorkerCount())
+		worker = m_next_worker++ % getWorkerCount();
+
+	{
+		lock_guard<mutex> lock(mvp_workers[worker]->m_mutex);
+		mvp_workers[worker]->ma_queues[priority].push_back(job);
+		ma_queue_depths[priority]++;
+	}
+
+	// lock so a worker cannot miss the wake-up between checking
+	//  for work and going to sleep
+	{
+		lock_guard<mutex> lock(m_records_mutex);
+	}
+	m_work_condition.notify_one();
+	m_done_condition.notify_all();
+}
+
+bool JobSystem :: takeJob (unsigned int worker,
+                           unsigned int lowest_priority,
+                           unsigned int& r_job)
+{
+	assert(worker <= getWorkerCount());
+	assert(lowest_priority < PRIORITY_COUNT);
+
+	unsigned int worker_count = getWorkerCount();
+	for(unsigned int p = 0; p <= lowest_priority; p++)
+	{
+		if(ma_queue_depths[p] == 0)
+			continue;
+
+		if(p == PRIORITY_LOW)
+		{
+			// reserve a place to run a low-priority job, which
+			//  only workers are limited to
+			unsigned int running = m_low_running;
+			do
+			{
+				if(worker < worker_count && running >= m_max_low_running)
+					return false;
+			}
+			while(!m_low_running.compare_exchange_weak(running, running + 1));
+		}
+
+		// newest job from own queue
+		if(worker < worker_count)
+		{
+			Worker& r_worker = *(mvp_workers[worker]);
+			lock_guard<mutex> lock(r_worker.m_mutex);
+			if(!r_worker.ma_queues[p].empty())
+			{
+				r_job = r_worker.ma_queues[p].back();
+				r_worker.ma_queues[p].pop_back();
+				ma_queue_depths[p]--;
+				return true;
+			}
+		}
+
+		// oldest job from another queue
+		for(unsigned int i = 1; i <= worker_count; i++)
+		{
+			unsigned int victim = (worker + i) % worker_count;
+			if(victim == worker)
+				continue;
+
+			Worker& r_victim = *(mvp_workers[victim]);
+			lock_guard<mutex> lock(r_victim.m_mutex);
+			if(!r_victim.ma_queues[p].empty())
+			{
+				r_job = r_victim.ma_queues[p].front();
+				r_victim.ma_queues[p].pop_front();
+				ma_queue_depths[p]--;
+				m_steal_count++;
+				return true;
+			}
+		}
+
+		// give the place back under the mutex the waiters use,
+		//  so a worker cannot check the limit and then miss
+		//  this wake-up
+		if(p == PRIORITY_LOW)
+		{
+			lock_guard<mutex> lock(m_records_mutex);
+			assert(m_low_running > 0);
+			m_low_running--;
+			m_work_condition.notify_one();
+			m_done_condition.notify_all();
+		}
+	}
+	return false;
+}
+
+bool JobSystem :: takeQueuedJob (unsigned int job, unsigned int priority)
+{
+	assert(priority < PRIORITY_COUNT);
+
+	for(unsigned int i = 0; i < mvp_workers.size(); i++)
+	{
+		Worker& r_worker = *(mvp_workers[i]);
+		lock_guard<mutex> lock(r_worker.m_mutex);
+		deque<unsigned int>& r_queue = r_worker.ma_queues[priority];
+		for(deque<unsigned int>::iterator it = r_queue.begin(); it != r_queue.end(); ++it)
+			if(*it == job)
+			{
+				r_queue.erase(it);
+				ma_queue_depths[priority]--;
+
+				// runJob releases the place when it finishes
+				if(priority == PRIORITY_LOW)
+					m_low_running++;
+				return true;
+			}
+	}
+	return false;
+}
+
+void JobSystem :: runJob (unsigned int job)
+{
+	JobFunction function;
+	unsigned int priority;
+	{
+		lock_guard<mutex> lock(m_records_mutex);
+		Record& r_record = m_records[job];
+		function.swap(r_record.m_function);
+		priority = r_record.m_priority;
+	}
+
+	function();
+
+	vector<unsigned int> v_ready;
+	vector<unsigned int> v_ready_priorities;
+	{
+		lock_guard<mutex> lock(m_records_mutex);
+		unordered_map<unsigned int, Record>::iterator it = m_records.find(job);
+		assert(it != m_records.end());
+
+		const vector<unsigned int>& v_dependents = it->second.mv_dependents;
+		for(unsigned int i = 0; i < v_dependents.size(); i++)
+		{
+			Record& r_dependent = m_records[v_dependents[i]];
+			assert(r_dependent.m_dependency_count > 0);
+			r_dependent.m_dependency_count--;
+			if(r_dependent.m_dependency_count == 0)
+			{
+				v_ready.push_back(v_dependents[i]);
+				v_ready_priorities.push_back(r_dependent.m_priority);
+			}
+		}
+		m_records.erase(it);
+
+		// inside the lock so sleeping workers see the change
+		if(priority == PRIORITY_LOW)
+		{
+			assert(m_low_running > 0);
+			m_low_running--;
+		}
+	}
+	m_jobs_run_count++;
+
+	for(unsigned int i = 0; i < v_ready.size(); i++)
+		enqueue(v_ready[i], v_ready_priorities[i]);
+
+	// wake waiting threads and any worker held back by the
+	//  low-priority limit
+	m_done_condition.notify_all();
+	if(priority == PRIORITY_LOW)
+		m_work_condition.notify_one();
+}
+
+unsigned int JobSystem :: getCurrentWorker () const
+{
+	if(tp_current_system == this)
+		return t_current_worker;
+	return getWorkerCount();
+}
@@ -0,0 +1,531 @@
+//
+//  JobSystem.h
+//
+//  A module to run jobs on a shared pool of worker threads.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_JOB_SYSTEM_H
+#define OBJ_LIBRARY_JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  JobSystem
+//
+//  A class to run jobs (functions) on a fixed set of worker
+//    threads.  Parts of the ObjLibrary that work in parallel
+//    should use the shared JobSystem returned by getShared
+//    instead of starting their own threads, so the number of
+//    threads stays the same no matter how many are busy.
+//
+//  Each worker has its own queues.  A worker runs the newest
+//    job in its own queue first, and when that is empty, it
+//    steals the oldest job from another worker.  Jobs added by
+//    a thread that is not a worker are shared out between the
+//    workers in turn.
+//
+//  Each job has a priority:
+//    <1> PRIORITY_HIGH: Work the current frame is waiting for
+//    <2> PRIORITY_NORMAL: Other work
+//    <3> PRIORITY_LOW: Background work, such as loading assets
+//    Higher-priority jobs are always taken first.  At most
+//    getWorkerCount() - 1 workers run low-priority jobs at
+//    once, so a long background job can never leave
+//    high-priority jobs with no workers.  A JobSystem with only
+//    one worker therefore runs low-priority jobs only on
+//    threads that are waiting in wait or waitAll.  Threads that
+//    are not workers are not limited.
+//
+//  A job can depend on other jobs.  It is not started until all
+//    of them are done.
+//
+//  A thread waiting for a job helps run other jobs of the same
+//    or higher priority while it waits, and runs the job it is
+//    waiting for itself if it has not started, even if that
+//    job is low-priority and the limit has been reached.  Thus
+//    waiting from inside a job does not deadlock.  Job functions
+//    must not throw exceptions.
+//
+//  Jobs are identified by handles.  A handle is never NO_JOB,
+//    and is not reused until 2^32 more jobs have been added.
+//
+class JobSystem
+{
+public:
+//
+//  NO_JOB
+//
+//  A handle value that never refers to a job.
+//
+	static const unsigned int NO_JOB = 0;
+
+//
+//  PRIORITY_*
+//
+//  The priority levels, from highest to lowest.
+//
+	static const unsigned int PRIORITY_HIGH   = 0;
+	static const unsigned int PRIORITY_NORMAL = 1;
+	static const unsigned int PRIORITY_LOW    = 2;
+	static const unsigned int PRIORITY_COUNT  = 3;
+
+//
+//  JobFunction
+//
+//  The type of a job.
+//
+	typedef std::function<void ()> JobFunction;
+
+//
+//  RangeFunction
+//
+//  The type of the function for parallelFor.  The parameters
+//    are the beginning and end of the part of the range.
+//
+	typedef std::function<void (unsigned int, unsigned int)> RangeFunction;
+
+public:
+//
+//  getShared
+//
+//  Purpose: To retrieve the JobSystem shared by the whole
+//           program.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The shared JobSystem.  It is created the first time
+//           this function is called, with one worker for each
+//           hardware thread after the first.  It always has at
+//           least two workers, so low-priority jobs can run
+//           without a thread waiting for them.
+//  Side Effect: N/A
+//
+	static JobSystem& getShared ();
+
+public:
+//
+//  Constructor
+//
+//  Purpose: To create a new JobSystem.
+//  Parameter(s):
+//    <1> worker_count: The number of worker threads
+//  Precondition(s):
+//    <1> worker_count >= 1
+//  Returns: N/A
+//  Side Effect: A new JobSystem is created and worker_count
+//               worker threads are started.
+//
+	explicit JobSystem (unsigned int worker_count);
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy this JobSystem.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All jobs are finished and the worker threads
+//               are stopped.
+//
+	~JobSystem ();
+
+//
+//  getWorkerCount
+//
+//  Purpose: To determine the number of worker threads.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of worker threads.
+//  Side Effect: N/A
+//
+	unsigned int getWorkerCount () const
+	{ return (unsigned int)(mvp_workers.size()); }
+
+//
+//  isDone
+//
+//  Purpose: To determine if a job has finished.
+//  Parameter(s):
+//    <1> job: The handle for the job
+//  Precondition(s):
+//    <1> job was returned by add
+//  Returns: Whether job job has finished running.
+//  Side Effect: N/A
+//
+	bool isDone (unsigned int job) const;
+
+//
+//  getQueueDepth
+//
+//  Purpose: To determine how many jobs are ready to run.
+//  Parameter(s):
+//    <1> priority: The priority
+//  Precondition(s):
+//    <1> priority < PRIORITY_COUNT
+//  Returns: The number of jobs with priority priority that are
+//           queued and not yet started.  Jobs waiting for
+//           other jobs are not included.
+//  Side Effect: N/A
+//
+	unsigned int getQueueDepth (unsigned int priority) const;
+
+//
+//  getUnfinishedCount
+//
+//  Purpose: To determine how many jobs have not finished.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of jobs that are waiting, queued, or
+//           running.
+//  Side Effect: N/A
+//
+	unsigned int getUnfinishedCount () const;
+
+//
+//  getJobsRunCount
+//
+//  Purpose: To determine how many jobs have been run.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of jobs finished since the JobSystem was
+//           created or resetStatistics was last called.
+//  Side Effect: N/A
+//
+	unsigned long long getJobsRunCount () const
+	{ return m_jobs_run_count; }
+
+//
+//  getStealCount
+//
+//  Purpose: To determine how many jobs have been stolen.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of jobs taken from the queue of a worker
+//           by another thread since the JobSystem was created
+//           or resetStatistics was last called.
+//  Side Effect: N/A
+//
+	unsigned long long getStealCount () const
+	{ return m_steal_count; }
+
+//
+//  resetStatistics
+//
+//  Purpose: To reset the job and steal counts.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The job and steal counts are set to 0.
+//
+	void resetStatistics ();
+
+//
+//  add
+//
+//  Purpose: To add a job.
+//  Parameter(s):
+//    <1> function: The function to run
+//    <2> dependencies: The jobs that must finish first
+//    <3> priority: The priority of the job
+//  Precondition(s):
+//    <1> function
+//    <2> Every element of dependencies is NO_JOB or was
+//        returned by add
+//    <3> priority < PRIORITY_COUNT
+//  Returns: The handle for the new job.
+//  Side Effect: A new job is added to run function.  It is
+//               queued once all its dependencies have
+//               finished.  NO_JOB elements of dependencies are
+//               ignored.
+//
+	unsigned int add (const JobFunction& function,
+	                  unsigned int priority = PRIORITY_NORMAL);
+	unsigned int add (const JobFunction& function,
+	                  const std::vector<unsigned int>& dependencies,
+	                  unsigned int priority = PRIORITY_NORMAL);
+
+//
+//  wait
+//
+//  Purpose: To wait for a job to finish.
+//  Parameter(s):
+//    <1> job: The handle for the job
+//  Precondition(s):
+//    <1> job == NO_JOB || job was returned by add
+//  Returns: N/A
+//  Side Effect: This function returns once job job has
+//               finished.  While waiting, the calling thread
+//               runs job job if it is queued and other jobs
+//               with the same or higher priority.  Otherwise,
+//               it sleeps until a job finishes or more work is
+//               queued.  If job is NO_JOB, there is no effect.
+//
+	void wait (unsigned int job);
+
+//
+//  waitAll
+//
+//  Purpose: To wait for all jobs to finish.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> This is not called from a job
+//  Returns: N/A
+//  Side Effect: This function returns once there are no
+//               unfinished jobs.  The calling thread helps run
+//               jobs of any priority, and sleeps while there are
+//               none it can run.
+//
+	void waitAll ();
+
+//
+//  parallelFor
+//
+//  Purpose: To split a range of elements between the workers.
+//  Parameter(s):
+//    <1> count: The number of elements
+//    <2> min_per_part: The smallest number of elements worth
+//                      making into a separate job
+//    <3> max_parts: The maximum number of parts
+//    <4> function: The function to call for each part
+//    <5> priority: The priority of the jobs
+//  Precondition(s):
+//    <1> min_per_part >= 1
+//    <2> max_parts >= 1
+//    <3> function
+//    <4> priority < PRIORITY_COUNT
+//  Returns: N/A
+//  Side Effect: function(begin, end) is called for a set of
+//               ranges that cover [0, count) without
+//               overlapping.  The last range is handled by the
+//               calling thread.  This function returns once
+//               all the ranges are done.
+//
+	void parallelFor (unsigned int count,
+	                  unsigned int min_per_part,
+	                  unsigned int max_parts,
+	                  const RangeFunction& function,
+	                  unsigned int priority = PRIORITY_HIGH);
+
+private:
+//
+//  Record
+//
+//  A record to store a job that has not finished.
+//
+	struct Record
+	{
+		JobFunction m_function;
+		unsigned int m_priority;
+		unsigned int m_dependency_count;
+		std::vector<unsigned int> mv_dependents;
+	};
+
+//
+//  Worker
+//
+//  A record to store a worker thread and its queues, one for
+//    each priority.
+//
+	struct Worker
+	{
+		std::mutex m_mutex;
+		std::deque<unsigned int> ma_queues[PRIORITY_COUNT];
+		std::thread m_thread;
+	};
+
+//
+//  Copy Constructor
+//  Assignment Operator
+//
+//  These functions have intentionally not been implemented
+//    because threads cannot be copied.
+//
+	JobSystem (const JobSystem& original);
+	JobSystem& operator= (const JobSystem& original);
+
+//
+//  workerMain
+//
+//  Purpose: To run jobs on a worker thread until the JobSystem
+//           is destroyed.
+//  Parameter(s):
+//    <1> worker: The index of the worker
+//  Precondition(s):
+//    <1> worker < getWorkerCount()
+//  Returns: N/A
+//  Side Effect: Jobs are run.  The thread sleeps when there are
+//               no jobs it can run.
+//
+	void workerMain (unsigned int worker);
+
+//
+//  isWorkAvailable
+//
+//  Purpose: To determine if a thread could take a job.
+//  Parameter(s):
+//    <1> worker: The index of the worker, or getWorkerCount()
+//                if it is not a worker
+//    <2> lowest_priority: The lowest priority to count
+//  Precondition(s):
+//    <1> worker <= getWorkerCount()
+//    <2> lowest_priority < PRIORITY_COUNT
+//  Returns: Whether there are any queued jobs with priority
+//           lowest_priority or higher.  Low-priority jobs are
+//           not counted for a worker if the maximum number of
+//           workers are already running low-priority jobs.
+//  Side Effect: N/A
+//
+	bool isWorkAvailable (unsigned int worker,
+	                      unsigned int lowest_priority) const;
+
+//
+//  isQueued
+//
+//  Purpose: To determine if a job is ready to run but has not
+//           been started.
+//  Parameter(s):
+//    <1> job: The job
+//  Precondition(s):
+//    <1> m_records_mutex is locked by this thread
+//  Returns: Whether job job is in a queue or about to be run.
+//  Side Effect: N/A
+//
+	bool isQueued (unsigned int job) const;
+
+//
+//  enqueue
+//
+//  Purpose: To queue a job that is ready to run.
+//  Parameter(s):
+//    <1> job: The job
+//    <2> priority: The priority of the job
+//  Precondition(s):
+//    <1> priority < PRIORITY_COUNT
+//  Returns: N/A
+//  Side Effect: job is added to the queue for the current
+//               worker, or for the next worker in turn if this
+//               is not a worker thread.  A worker is woken up.
+//
+	void enqueue (unsigned int job, unsigned int priority);
+
+//
+//  takeJob
+//
+//  Purpose: To remove a job from the queues to run it.
+//  Parameter(s):
+//    <1> worker: The index of the calling worker, or
+//                getWorkerCount() if it is not a worker
+//    <2> lowest_priority: The lowest priority to take
+//    <3> r_job: A reference to a variable to store the job in
+//  Precondition(s):
+//    <1> worker <= getWorkerCount()
+//    <2> lowest_priority < PRIORITY_COUNT
+//  Returns: Whether a job was taken.
+//  Side Effect: If a job was taken, it is removed from its
+//               queue and r_job is set to it.  The highest
+//               priority available is taken: first from the
+//               worker's own queue, then stolen from another
+//               worker.  A worker does not take a low-priority
+//               job if the maximum number of workers are
+//               already running them.
+//
+	bool takeJob (unsigned int worker,
+	              unsigned int lowest_priority,
+	              unsigned int& r_job);
+
+//
+//  takeQueuedJob
+//
+//  Purpose: To remove a specific job from the queues to run
+//           it.
+//  Parameter(s):
+//    <1> job: The job
+//    <2> priority: The priority of the job
+//  Precondition(s):
+//    <1> priority < PRIORITY_COUNT
+//  Returns: Whether job job was found in a queue.
+//  Side Effect: If job job is in a queue, it is removed.  This
+//               ignores the limit on low-priority jobs, so a
+//               thread waiting for a job can always run it.
+//
+	bool takeQueuedJob (unsigned int job, unsigned int priority);
+
+//
+//  runJob
+//
+//  Purpose: To run a job that has been taken.
+//  Parameter(s):
+//    <1> job: The job
+//  Precondition(s):
+//    <1> job was returned by takeJob
+//  Returns: N/A
+//  Side Effect: The job is run and then marked as finished.
+//               Any jobs that were only waiting for it are
+//               queued.
+//
+	void runJob (unsigned int job);
+
+//
+//  getCurrentWorker
+//
+//  Purpose: To determine which worker is the calling thread.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The index of the worker running on the calling
+//           thread, or getWorkerCount() if it is not one of
+//           the workers for this JobSystem.
+//  Side Effect: N/A
+//
+	unsigned int getCurrentWorker () const;
+
+private:
+	std::vector<std::unique_ptr<Worker>> mvp_workers;
+	unsigned int m_max_low_running;
+
+	// guards m_records, m_next_job, and m_is_stopping
+	mutable std::mutex m_records_mutex;
+	std::unordered_map<unsigned int, Record> m_records;
+	unsigned int m_next_job;
+	bool m_is_stopping;
+	std::condition_variable m_work_condition;
+	std::condition_variable m_done_condition;
+
+	std::atomic<unsigned int> ma_queue_depths[PRIORITY_COUNT];
+	std::atomic<unsigned int> m_low_running;
+	std::atomic<unsigned int> m_next_worker;
+	std::atomic<unsigned long long> m_jobs_run_count;
+	std::atomic<unsigned long long> m_steal_count;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
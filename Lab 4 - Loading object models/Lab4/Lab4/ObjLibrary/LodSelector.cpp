@@ -0,0 +1,413 @@
+//
+//  LodSelector.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include <vector>
+
+#include "Vector3.h"
+#include "Vector3Array.h"
+#include "Matrix44.h"
+#include "SimdKernels.h"
+#include "ObjModel.h"
+#include "LodSelector.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  PI
+	//
+	//  The ratio of a circle's circumference to its diameter.
+	//
+	const double PI = 3.14159265358979323846;
+
+	//
+	//  calculatePixelsPerUnit
+	//
+	//  Purpose: To calculate the scale of a perspective
+	//           projection.
+	//  Parameter(s):
+	//    <1> fovy_degrees: The vertical field of view in degrees
+	//    <2> viewport_height: The height of the viewport in
+	//                         pixels
+	//  Precondition(s):
+	//    <1> fovy_degrees > 0.0
+	//    <2> fovy_degrees < 180.0
+	//    <3> viewport_height > 0.0
+	//  Returns: The size in pixels of an object 1 unit across at
+	//           a distance of 1 unit.
+	//  Side Effect: N/A
+	//
+	double calculatePixelsPerUnit (double fovy_degrees,
+	                               double viewport_height)
+	{
+		assert(fovy_degrees > 0.0);
+		assert(fovy_degrees < 180.0);
+		assert(viewport_height > 0.0);
+
+		return viewport_height * 0.5 / tan(fovy_degrees * PI / 360.0);
+	}
+
+	//
+	//  getScaleFactor
+	//
+	//  Purpose: To determine how much a transform enlarges a
+	//           sphere.
+	//  Parameter(s):
+	//    <1> transform: The transform
+	//  Precondition(s): N/A
+	//  Returns: The length of the longest transformed axis.
+	//  Side Effect: N/A
+	//
+	double getScaleFactor (const Matrix44& transform)
+	{
+		double x = transform.getColumn(0).getNormSquared();
+		double y = transform.getColumn(1).getNormSquared();
+		double z = transform.getColumn(2).getNormSquared();
+		return sqrt(max(max(x, y), z));
+	}
+
+}  // end of anonymous namespace
+
+
+
+const double LodSelector :: DEFAULT_HYSTERESIS = 0.1;
+
+
+
+LodSelector :: LodSelector ()
+		: m_pixels_per_unit(calculatePixelsPerUnit(60.0, 600.0)),
+		  m_hysteresis(DEFAULT_HYSTERESIS),
+		  m_is_thresholds_current(true),
+		  m_change_count(0),
+		  mvv_levels(),
+		  mv_bounds(),
+		  mv_instance_models(),
+		  mv_instance_transforms(),
+		  mv_instance_levels(),
+		  mv_instance_radii(),
+		  m_instance_centres(),
+		  mv_finer_distances(),
+		  mv_coarser_distances(),
+		  mv_steps()
+{
+	assert(invariant());
+}
+
+
+
+unsigned int LodSelector :: getLevelCount (unsigned int model) const
+{
+	assert(model < getModelCount());
+
+	return (unsigned int)(mvv_levels[model].size());
+}
+
+const ObjModel* LodSelector :: getLevelModel (unsigned int model,
+                                              unsigned int level) const
+{
+	assert(model < getModelCount());
+	assert(level < getLevelCount(model));
+
+	return mvv_levels[model][level].mp_model;
+}
+
+double LodSelector :: getLevelScreenSize (unsigned int model,
+                                          unsigned int level) const
+{
+	assert(model < getModelCount());
+	assert(level < getLevelCount(model));
+	assert(level >= 1);
+
+	return mvv_levels[model][level].m_screen_size;
+}
+
+unsigned int LodSelector :: getInstanceModel (unsigned int instance) const
+{
+	assert(instance < getInstanceCount());
+
+	return mv_instance_models[instance];
+}
+
+const Matrix44& LodSelector :: getInstanceTransform (unsigned int instance) const
+{
+	assert(instance < getInstanceCount());
+
+	return mv_instance_transforms[instance];
+}
+
+unsigned int LodSelector :: getInstanceLevel (unsigned int instance) const
+{
+	assert(instance < getInstanceCount());
+
+	return mv_instance_levels[instance];
+}
+
+double LodSelector :: getInstanceScreenSize (unsigned int instance,
+                                             const Vector3& eye) const
+{
+	assert(instance < getInstanceCount());
+
+	double radius   = mv_instance_radii[instance];
+	double distance = m_instance_centres.get(instance).getDistance(eye);
+	if(distance <= radius)
+		return DBL_MAX;
+	return radius * 2.0 * m_pixels_per_unit / distance;
+}
+
+unsigned int LodSelector :: getLevelInstanceCount (unsigned int level) const
+{
+	return (unsigned int)(count(mv_instance_levels.begin(),
+	                            mv_instance_levels.end(), level));
+}
+
+void LodSelector :: draw (const Matrix44& view) const
+{
+	for(unsigned int i = 0; i < getInstanceCount(); i++)
+	{
+		const ObjModel* p_model = mvv_levels[mv_instance_models[i]]
+		                                    [mv_instance_levels[i]].mp_model;
+		if(p_model == NULL)
+			continue;
+
+		(view * mv_instance_transforms[i]).loadToOpenGL();
+		p_model->draw();
+	}
+
+	view.loadToOpenGL();
+}
+
+
+
+unsigned int LodSelector :: addModel (const ObjModel* p_level0)
+{
+	assert(p_level0 != NULL);
+	assert(p_level0->isValid());
+
+	Level level0;
+	level0.mp_model      = p_level0;
+	level0.m_screen_size = DBL_MAX;
+	mvv_levels.push_back(vector<Level>(1, level0));
+
+	Vector3 box_min = p_level0->getBoundingBoxMin();
+	Vector3 box_max = p_level0->getBoundingBoxMax();
+	Bounds bounds;
+	bounds.m_centre = (box_min + box_max) * 0.5;
+	bounds.m_radius = box_min.getDistance(box_max) * 0.5;
+	mv_bounds.push_back(bounds);
+
+	assert(invariant());
+	return getModelCount() - 1;
+}
+
+void LodSelector :: addLevel (unsigned int model,
+                              const ObjModel* p_level,
+                              double screen_size)
+{
+	assert(model < getModelCount());
+	assert(p_level == NULL || p_level->isValid());
+	assert(screen_size > 0.0);
+	assert(getLevelCount(model) == 1 ||
+	       screen_size < getLevelScreenSize(model, getLevelCount(model) - 1));
+	assert(mvv_levels[model].back().mp_model != NULL);
+
+	Level level;
+	level.mp_model      = p_level;
+	level.m_screen_size = screen_size;
+	mvv_levels[model].push_back(level);
+	m_is_thresholds_current = false;
+
+	assert(invariant());
+}
+
+unsigned int LodSelector :: addInstance (unsigned int model,
+                                         const Matrix44& transform)
+{
+	assert(model < getModelCount());
+
+	mv_instance_models.push_back(model);
+	mv_instance_transforms.push_back(transform);
+	mv_instance_levels.push_back(0);
+	mv_instance_radii.push_back(0.0f);
+	m_instance_centres.pushBack(Vector3::ZERO);
+	mv_finer_distances.push_back(0.0f);
+	mv_coarser_distances.push_back(0.0f);
+
+	unsigned int instance = getInstanceCount() - 1;
+	setInstanceTransform(instance, transform);
+
+	assert(invariant());
+	return instance;
+}
+
+void LodSelector :: setInstanceTransform (unsigned int instance,
+                                          const Matrix44& transform)
+{
+	assert(instance < getInstanceCount());
+
+	const Bounds& bounds = mv_bounds[mv_instance_models[instance]];
+	mv_instance_transforms[instance] = transform;
+	m_instance_centres.set(instance, transform.getTransformedPoint(bounds.m_centre));
+	mv_instance_radii[instance] = (float)(bounds.m_radius * getScaleFactor(transform));
+	updateThresholds(instance);
+
+	assert(invariant());
+}
+
+void LodSelector :: removeAllInstances ()
+{
+	mv_instance_models.clear();
+	mv_instance_transforms.clear();
+	mv_instance_levels.clear();
+	mv_instance_radii.clear();
+	m_instance_centres.clear();
+	mv_finer_distances.clear();
+	mv_coarser_distances.clear();
+	mv_steps.clear();
+	m_change_count = 0;
+
+	assert(invariant());
+}
+
+void LodSelector :: setProjection (double fovy_degrees,
+                                   double viewport_height)
+{
+	assert(fovy_degrees > 0.0);
+	assert(fovy_degrees < 180.0);
+	assert(viewport_height > 0.0);
+
+	m_pixels_per_unit = calculatePixelsPerUnit(fovy_degrees, viewport_height);
+	m_is_thresholds_current = false;
+
+	assert(invariant());
+}
+
+void LodSelector :: setHysteresis (double hysteresis)
+{
+	assert(hysteresis >= 0.0);
+	assert(hysteresis < 1.0);
+
+	m_hysteresis = hysteresis;
+	m_is_thresholds_current = false;
+
+	assert(invariant());
+}
+
+void LodSelector :: update (const Vector3& eye)
+{
+	assert(eye.isFinite());
+
+	unsigned int instance_count = getInstanceCount();
+	if(!m_is_thresholds_current)
+	{
+		for(unsigned int i = 0; i < instance_count; i++)
+			updateThresholds(i);
+		m_is_thresholds_current = true;
+	}
+
+	// find the instances that must change level in one pass
+	float a_eye[3] = { (float)(eye.x), (float)(eye.y), (float)(eye.z) };
+	mv_steps.resize(instance_count);
+	SimdKernels::getTable<float>().distanceStep3(instance_count, a_eye,
+	                                             m_instance_centres.getArrayX(),
+	                                             m_instance_centres.getArrayY(),
+	                                             m_instance_centres.getArrayZ(),
+	                                             mv_finer_distances.data(),
+	                                             mv_coarser_distances.data(),
+	                                             mv_steps.data());
+
+	m_change_count = 0;
+	for(unsigned int i = 0; i < instance_count; i++)
+	{
+		if(mv_steps[i] == 0.0f)
+			continue;
+
+		// an instance may have to move more than one level
+		unsigned int level_count = (unsigned int)(mvv_levels[mv_instance_models[i]].size());
+		float distance_squared = (float)(m_instance_centres.get(i).getDistanceSquared(eye));
+		while(mv_instance_levels[i] + 1 < level_count &&
+		      distance_squared > mv_coarser_distances[i])
+		{
+			mv_instance_levels[i]++;
+			updateThresholds(i);
+			m_change_count++;
+		}
+		while(mv_instance_levels[i] > 0 &&
+		      distance_squared < mv_finer_distances[i])
+		{
+			mv_instance_levels[i]--;
+			updateThresholds(i);
+			m_change_count++;
+		}
+	}
+
+	assert(invariant());
+}
+
+
+
+void LodSelector :: updateThresholds (unsigned int instance)
+{
+	assert(instance < getInstanceCount());
+
+	const vector<Level>& v_levels = mvv_levels[mv_instance_models[instance]];
+	unsigned int level = mv_instance_levels[instance];
+	double diameter = mv_instance_radii[instance] * 2.0 * m_pixels_per_unit;
+
+	// the instance is screen_size pixels across at a distance
+	//   of diameter / screen_size
+	if(level + 1 < v_levels.size())
+	{
+		double distance = diameter / (v_levels[level + 1].m_screen_size * (1.0 - m_hysteresis));
+		mv_coarser_distances[instance] = (float)(distance * distance);
+	}
+	else
+		mv_coarser_distances[instance] = FLT_MAX;
+
+	if(level > 0)
+	{
+		double distance = diameter / (v_levels[level].m_screen_size * (1.0 + m_hysteresis));
+		mv_finer_distances[instance] = (float)(distance * distance);
+	}
+	else
+		mv_finer_distances[instance] = -1.0f;
+}
+
+bool LodSelector :: invariant () const
+{
+	if(m_pixels_per_unit <= 0.0) return false;
+	if(m_hysteresis < 0.0) return false;
+	if(m_hysteresis >= 1.0) return false;
+	if(mv_bounds.size() != mvv_levels.size()) return false;
+	for(unsigned int m = 0; m < mvv_levels.size(); m++)
+		if(mvv_levels[m].empty()) return false;
+
+	unsigned int instance_count = getInstanceCount();
+	if(mv_instance_transforms.size() != instance_count) return false;
+	if(mv_instance_levels.size() != instance_count) return false;
+	if(mv_instance_radii.size() != instance_count) return false;
+	if(m_instance_centres.getSize() != instance_count) return false;
+	if(mv_finer_distances.size() != instance_count) return false;
+	if(mv_coarser_distances.size() != instance_count) return false;
+	return true;
+}
@@ -0,0 +1,528 @@
+//
+//  LodSelector.h
+//
+//  A module to choose a level of detail for many instances of
+//    models based on their size on the screen.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_LOD_SELECTOR_H
+#define OBJ_LIBRARY_LOD_SELECTOR_H
+
+#include <cassert>
+#include <vector>
+
+#include "Vector3.h"
+#include "Vector3Array.h"
+#include "Matrix44.h"
+
+
+
+namespace ObjLibrary
+{
+
+class ObjModel;
+
+
+
+//
+//  LodSelector
+//
+//  A class to choose which level of detail (LOD) to draw for
+//    each of many instances of models.  Each model has one or
+//    more levels, from the most detailed (level 0) to the
+//    least.  Every level after the first has a screen size in
+//    pixels.  An instance uses that level once the bounding
+//    sphere of the model, as seen by the camera, is less than
+//    that many pixels across.  The bounding sphere is
+//    calculated from the bounding box of level 0.  The last
+//    level may have no ObjModel, in which case the instance is
+//    not drawn at all when it is that small.
+//
+//  To avoid flickering between levels when an instance is near
+//    a boundary, an instance only moves to a less detailed
+//    level once it is smaller than the screen size by the
+//    hysteresis fraction, and only moves back once it is larger
+//    by the same fraction.
+//
+//  Levels are chosen for all instances in one batch by update.
+//    The screen sizes are converted to squared distances from
+//    the camera for each instance when its level changes, so
+//    update only has to compare the squared distance of each
+//    instance to two values.  That is done for all instances
+//    at once by the distanceStep3 kernel from SimdKernels.h.
+//    Only the instances that have to change level are then
+//    handled one at a time.
+//
+//  The LodSelector does not own the ObjModels.  They must not
+//    be destroyed while it refers to them.
+//
+class LodSelector
+{
+public:
+//
+//  DEFAULT_HYSTERESIS
+//
+//  The default hysteresis fraction.
+//
+	static const double DEFAULT_HYSTERESIS;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new LodSelector with no models.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new LodSelector is created with no models or
+//               instances.  The projection is a 60 degree
+//               vertical field of view on a viewport 600
+//               pixels high.  The hysteresis is
+//               DEFAULT_HYSTERESIS.
+//
+	LodSelector ();
+
+//
+//  getModelCount
+//
+//  Purpose: To determine the number of models.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of models.
+//  Side Effect: N/A
+//
+	unsigned int getModelCount () const
+	{ return (unsigned int)(mvv_levels.size()); }
+
+//
+//  getLevelCount
+//
+//  Purpose: To determine the number of levels of detail for a
+//           model.
+//  Parameter(s):
+//    <1> model: Which model
+//  Precondition(s):
+//    <1> model < getModelCount()
+//  Returns: The number of levels for model model.  This is
+//           always at least 1.
+//  Side Effect: N/A
+//
+	unsigned int getLevelCount (unsigned int model) const;
+
+//
+//  getLevelModel
+//
+//  Purpose: To retrieve the ObjModel for a level of detail.
+//  Parameter(s):
+//    <1> model: Which model
+//    <2> level: Which level
+//  Precondition(s):
+//    <1> model < getModelCount()
+//    <2> level < getLevelCount(model)
+//  Returns: The ObjModel drawn for level level of model model,
+//           or NULL if nothing is drawn.
+//  Side Effect: N/A
+//
+	const ObjModel* getLevelModel (unsigned int model,
+	                               unsigned int level) const;
+
+//
+//  getLevelScreenSize
+//
+//  Purpose: To determine the screen size of a level of detail.
+//  Parameter(s):
+//    <1> model: Which model
+//    <2> level: Which level
+//  Precondition(s):
+//    <1> model < getModelCount()
+//    <2> level < getLevelCount(model)
+//    <3> level >= 1
+//  Returns: The size in pixels below which an instance of
+//           model model uses level level.
+//  Side Effect: N/A
+//
+	double getLevelScreenSize (unsigned int model,
+	                           unsigned int level) const;
+
+//
+//  getInstanceCount
+//
+//  Purpose: To determine the number of instances.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of instances.
+//  Side Effect: N/A
+//
+	unsigned int getInstanceCount () const
+	{ return (unsigned int)(mv_instance_models.size()); }
+
+//
+//  getInstanceModel
+//
+//  Purpose: To determine which model an instance is of.
+//  Parameter(s):
+//    <1> instance: Which instance
+//  Precondition(s):
+//    <1> instance < getInstanceCount()
+//  Returns: The model for instance instance.
+//  Side Effect: N/A
+//
+	unsigned int getInstanceModel (unsigned int instance) const;
+
+//
+//  getInstanceTransform
+//
+//  Purpose: To retrieve the world transform of an instance.
+//  Parameter(s):
+//    <1> instance: Which instance
+//  Precondition(s):
+//    <1> instance < getInstanceCount()
+//  Returns: The world transform for instance instance.
+//  Side Effect: N/A
+//
+	const Matrix44& getInstanceTransform (unsigned int instance) const;
+
+//
+//  getInstanceLevel
+//
+//  Purpose: To determine the level of detail chosen for an
+//           instance.
+//  Parameter(s):
+//    <1> instance: Which instance
+//  Precondition(s):
+//    <1> instance < getInstanceCount()
+//  Returns: The level chosen for instance instance by the last
+//           call to update.  Before update is first called, this
+//           is level 0.
+//  Side Effect: N/A
+//
+	unsigned int getInstanceLevel (unsigned int instance) const;
+
+//
+//  getInstanceScreenSize
+//
+//  Purpose: To calculate how large an instance appears.
+//  Parameter(s):
+//    <1> instance: Which instance
+//    <2> eye: The camera position
+//  Precondition(s):
+//    <1> instance < getInstanceCount()
+//  Returns: The size in pixels of the bounding sphere for
+//           instance instance as seen from eye.  If eye is
+//           inside the bounding sphere, a very large value is
+//           returned.
+//  Side Effect: N/A
+//
+	double getInstanceScreenSize (unsigned int instance,
+	                              const Vector3& eye) const;
+
+//
+//  getHysteresis
+//
+//  Purpose: To determine the hysteresis fraction.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The fraction by which the size of an instance must
+//           pass a screen size before it changes level.
+//  Side Effect: N/A
+//
+	double getHysteresis () const
+	{ return m_hysteresis; }
+
+//
+//  getPixelsPerUnit
+//
+//  Purpose: To determine the scale of the projection.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The size in pixels of an object 1 unit across at a
+//           distance of 1 unit.
+//  Side Effect: N/A
+//
+	double getPixelsPerUnit () const
+	{ return m_pixels_per_unit; }
+
+//
+//  getChangeCount
+//
+//  Purpose: To determine how many level changes the last update
+//           made.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of times an instance moved one level
+//           in the last call to update.  An instance that moved
+//           several levels is counted once for each.
+//  Side Effect: N/A
+//
+	unsigned int getChangeCount () const
+	{ return m_change_count; }
+
+//
+//  getLevelInstanceCount
+//
+//  Purpose: To determine how many instances use a level.
+//  Parameter(s):
+//    <1> level: Which level
+//  Precondition(s): N/A
+//  Returns: The number of instances that are using level level
+//           of their model.
+//  Side Effect: N/A
+//
+	unsigned int getLevelInstanceCount (unsigned int level) const;
+
+//
+//  draw
+//
+//  Purpose: To display every instance at its chosen level of
+//           detail.
+//  Parameter(s):
+//    <1> view: The camera (view) transform
+//  Precondition(s):
+//    <1> The ObjModels are valid
+//  Returns: N/A
+//  Side Effect: The ObjModel for the chosen level of each
+//               instance is drawn with the OpenGL modelview
+//               matrix set to view times the transform for the
+//               instance.  Instances at a level with no
+//               ObjModel are skipped.  Afterwards, the
+//               modelview matrix is set to view.
+//
+	void draw (const Matrix44& view) const;
+
+//
+//  addModel
+//
+//  Purpose: To add a model with a single level of detail.
+//  Parameter(s):
+//    <1> p_level0: The ObjModel for level 0
+//  Precondition(s):
+//    <1> p_level0 != NULL
+//    <2> p_level0->isValid()
+//  Returns: The index of the new model.
+//  Side Effect: A new model is added with level 0 drawn as
+//               p_level0.  Its bounding sphere is calculated
+//               from the bounding box of p_level0.
+//
+	unsigned int addModel (const ObjModel* p_level0);
+
+//
+//  addLevel
+//
+//  Purpose: To add a less detailed level to a model.
+//  Parameter(s):
+//    <1> model: Which model
+//    <2> p_level: The ObjModel for the new level, or NULL to
+//                 draw nothing
+//    <3> screen_size: The size in pixels below which the new
+//                     level is used
+//  Precondition(s):
+//    <1> model < getModelCount()
+//    <2> p_level == NULL || p_level->isValid()
+//    <3> screen_size > 0.0
+//    <4> getLevelCount(model) == 1 ||
+//        screen_size < getLevelScreenSize(model,
+//                                 getLevelCount(model) - 1)
+//    <5> The last level for model model has an ObjModel
+//  Returns: N/A
+//  Side Effect: A new level is added after the existing levels
+//               for model model.  Existing instances may move
+//               to it at the next call to update.
+//
+	void addLevel (unsigned int model,
+	               const ObjModel* p_level,
+	               double screen_size);
+
+//
+//  addInstance
+//
+//  Purpose: To add an instance of a model.
+//  Parameter(s):
+//    <1> model: Which model
+//    <2> transform: The world transform for the instance
+//  Precondition(s):
+//    <1> model < getModelCount()
+//  Returns: The index of the new instance.
+//  Side Effect: A new instance of model model is added at
+//               level 0.  Its level will be chosen by the next
+//               call to update.
+//
+	unsigned int addInstance (unsigned int model,
+	                          const Matrix44& transform);
+
+//
+//  setInstanceTransform
+//
+//  Purpose: To move an instance.
+//  Parameter(s):
+//    <1> instance: Which instance
+//    <2> transform: The new world transform
+//  Precondition(s):
+//    <1> instance < getInstanceCount()
+//  Returns: N/A
+//  Side Effect: Instance instance is moved to transform.  The
+//               bounding sphere is moved and scaled with it.
+//
+	void setInstanceTransform (unsigned int instance,
+	                           const Matrix44& transform);
+
+//
+//  removeAllInstances
+//
+//  Purpose: To remove all instances.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All instances are removed.  The models are
+//               kept.
+//
+	void removeAllInstances ();
+
+//
+//  setProjection
+//
+//  Purpose: To change the projection used to calculate screen
+//           sizes.
+//  Parameter(s):
+//    <1> fovy_degrees: The vertical field of view in degrees
+//    <2> viewport_height: The height of the viewport in pixels
+//  Precondition(s):
+//    <1> fovy_degrees > 0.0
+//    <2> fovy_degrees < 180.0
+//    <3> viewport_height > 0.0
+//  Returns: N/A
+//  Side Effect: The projection is changed to match a
+//               perspective projection with field of view
+//               fovy_degrees in a viewport viewport_height
+//               pixels high.  This takes effect at the next
+//               call to update.
+//
+	void setProjection (double fovy_degrees,
+	                    double viewport_height);
+
+//
+//  setHysteresis
+//
+//  Purpose: To change the hysteresis fraction.
+//  Parameter(s):
+//    <1> hysteresis: The new hysteresis fraction
+//  Precondition(s):
+//    <1> hysteresis >= 0.0
+//    <2> hysteresis < 1.0
+//  Returns: N/A
+//  Side Effect: An instance will only move to a less detailed
+//               level once its size is less than the screen
+//               size times 1 - hysteresis, and back once it is
+//               larger than the screen size times
+//               1 + hysteresis.  This takes effect at the next
+//               call to update.
+//
+	void setHysteresis (double hysteresis);
+
+//
+//  update
+//
+//  Purpose: To choose the level of detail for every instance.
+//  Parameter(s):
+//    <1> eye: The camera position
+//  Precondition(s):
+//    <1> eye.isFinite()
+//  Returns: N/A
+//  Side Effect: Each instance is moved to a less or more
+//               detailed level as described above, based on
+//               its size as seen from eye.  The change count is
+//               set to the number of level changes made.
+//
+	void update (const Vector3& eye);
+
+private:
+//
+//  Level
+//
+//  A record to store one level of detail for a model.
+//
+	struct Level
+	{
+		const ObjModel* mp_model;
+		double m_screen_size;
+	};
+
+//
+//  Bounds
+//
+//  A record to store the bounding sphere for a model in its
+//    own coordinates.
+//
+	struct Bounds
+	{
+		Vector3 m_centre;
+		double m_radius;
+	};
+
+//
+//  updateThresholds
+//
+//  Purpose: To recalculate the squared distances at which an
+//           instance changes level.
+//  Parameter(s):
+//    <1> instance: Which instance
+//  Precondition(s):
+//    <1> instance < getInstanceCount()
+//  Returns: N/A
+//  Side Effect: The squared distances at which instance
+//               instance moves from its current level to the
+//               next less and more detailed levels are
+//               recalculated.
+//
+	void updateThresholds (unsigned int instance);
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	double m_pixels_per_unit;
+	double m_hysteresis;
+	bool m_is_thresholds_current;
+	unsigned int m_change_count;
+
+	std::vector<std::vector<Level> > mvv_levels;
+	std::vector<Bounds> mv_bounds;
+
+	// instance data, stored as a structure of arrays
+	std::vector<unsigned int> mv_instance_models;
+	std::vector<Matrix44> mv_instance_transforms;
+	std::vector<unsigned int> mv_instance_levels;
+	std::vector<float> mv_instance_radii;
+	Vector3Array<float> m_instance_centres;
+	std::vector<float> mv_finer_distances;    // squared
+	std::vector<float> mv_coarser_distances;  // squared
+	std::vector<float> mv_steps;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -19,6 +19,7 @@
 
 #include <cassert>
 #include <string>
+#include <utility>	// for move
 #include <fstream>
 #include <iostream>
 
@@ -299,6 +300,28 @@ Material :: Material (const Material& original)
 	assert(invariant());
 }
 
+Material :: Material (Material&& original) noexcept
+		: m_emission_colour    (original.m_emission_colour),
+		  m_ambient_colour     (original.m_ambient_colour),
+		  m_diffuse_colour     (original.m_diffuse_colour),
+		  m_specular_colour    (original.m_specular_colour),
+		  m_transmission_filter(original.m_transmission_filter)
+{
+	mp_emission_map          = NULL;
+	mp_ambient_map           = NULL;
+	mp_diffuse_map           = NULL;
+	mp_specular_map          = NULL;
+	mp_specular_exponent_map = NULL;
+	mp_transparency_map      = NULL;
+	mp_decal_map             = NULL;
+	mp_displacement_map      = NULL;
+	mp_bump_map              = NULL;
+
+	take(original);
+
+	assert(invariant());
+}
+
 Material& Material :: operator= (const Material& original)
 {
 	if(&original != this)
@@ -317,6 +340,24 @@ Material& Material :: operator= (const Material& original)
 	return *this;
 }
 
+Material& Material :: operator= (Material&& original) noexcept
+{
+	if(&original != this)
+	{
+		destroy();
+
+		m_emission_colour     = original.m_emission_colour;
+		m_ambient_colour      = original.m_ambient_colour;
+		m_diffuse_colour      = original.m_diffuse_colour;
+		m_specular_colour     = original.m_specular_colour;
+		m_transmission_filter = original.m_transmission_filter;
+		take(original);
+	}
+
+	assert(invariant());
+	return *this;
+}
+
 Material :: ~Material ()
 {
 	destroy();
@@ -334,6 +375,21 @@ const string& Material :: getTexturePath () const
 	return m_texture_path;
 }
 
+string Material :: getDisplayTextureFilename () const
+{
+	// same order as loadDisplayTextures
+	if(m_diffuse_filename != "")
+		return m_texture_path + m_diffuse_filename;
+	else if(m_ambient_filename != "")
+		return m_texture_path + m_ambient_filename;
+	else if(m_specular_filename != "")
+		return m_texture_path + m_specular_filename;
+	else if(m_emission_filename != "")
+		return m_texture_path + m_emission_filename;
+	else
+		return "";
+}
+
 unsigned int Material :: getIlluminationMode () const
 {
 	return m_illumination_mode;
@@ -2378,6 +2434,66 @@ void Material :: copy (const Material& original)
 	assert(invariant());
 }
 
+void Material :: take (Material& r_original) noexcept
+{
+	assert(mp_emission_map == NULL);
+	assert(mp_ambient_map == NULL);
+	assert(mp_diffuse_map == NULL);
+	assert(mp_specular_map == NULL);
+	assert(mp_specular_exponent_map == NULL);
+	assert(mp_transparency_map == NULL);
+	assert(mp_decal_map == NULL);
+	assert(mp_displacement_map == NULL);
+	assert(mp_bump_map == NULL);
+
+	// the strings are moved, everything else is copied
+	m_name         = move(r_original.m_name);
+	m_texture_path = move(r_original.m_texture_path);
+
+	m_illumination_mode    = r_original.m_illumination_mode;
+	m_texture_type_display = r_original.m_texture_type_display;
+
+	m_emission_filename = move(r_original.m_emission_filename);
+	mp_emission_map     = r_original.mp_emission_map;
+
+	m_ambient_filename = move(r_original.m_ambient_filename);
+	mp_ambient_map     = r_original.mp_ambient_map;
+
+	m_diffuse_filename = move(r_original.m_diffuse_filename);
+	mp_diffuse_map     = r_original.mp_diffuse_map;
+
+	m_specular_filename = move(r_original.m_specular_filename);
+	mp_specular_map     = r_original.mp_specular_map;
+
+	m_specular_exponent          = r_original.m_specular_exponent;
+	m_specular_exponent_filename = move(r_original.m_specular_exponent_filename);
+	mp_specular_exponent_map     = r_original.mp_specular_exponent_map;
+	m_specular_exponent_channel  = r_original.m_specular_exponent_channel;
+
+	m_transparency          = r_original.m_transparency;
+	m_transparency_filename = move(r_original.m_transparency_filename);
+	mp_transparency_map     = r_original.mp_transparency_map;
+	m_transparency_channel  = r_original.m_transparency_channel;
+
+	m_decal_filename = move(r_original.m_decal_filename);
+	mp_decal_map     = r_original.mp_decal_map;
+	m_decal_channel  = r_original.m_decal_channel;
+
+	m_displacement_filename = move(r_original.m_displacement_filename);
+	mp_displacement_map     = r_original.mp_displacement_map;
+	m_displacement_channel  = r_original.m_displacement_channel;
+
+	m_bump_filename   = move(r_original.m_bump_filename);
+	mp_bump_map       = r_original.mp_bump_map;
+	m_bump_channel    = r_original.m_bump_channel;
+	m_bump_multiplier = r_original.m_bump_multiplier;
+
+	// the default name is short enough not to allocate memory
+	r_original.makeDefault();
+
+	assert(invariant());
+}
+
 bool Material :: invariant () const
 {
 	if(m_name == "") return false;
@@ -502,6 +502,21 @@ public:
 //
 	Material (const Material& original);
 
+//
+//  Move Constructor
+//
+//  Purpose: To create a new Material by taking the values of
+//           another.
+//  Parameter(s):
+//    <1> original: The Material to move
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new Material is created with the values
+//               original had.  original is reset to the
+//               default values.
+//
+	Material (Material&& original) noexcept;
+
 //
 //  Destructor
 //
@@ -528,6 +543,22 @@ public:
 //
 	Material& operator= (const Material& original);
 
+//
+//  Move Assignment Operator
+//
+//  Purpose: To modify this Material to take the values of
+//           another.
+//  Parameter(s):
+//    <1> original: The Material to move
+//  Precondition(s): N/A
+//  Returns: A reference to this Material.
+//  Side Effect: This Material is changed to have the values
+//               original had.  The existing contents of this
+//               Material are lost.  original is reset to the
+//               default values.
+//
+	Material& operator= (Material&& original) noexcept;
+
 //
 //  getName
 //
@@ -551,6 +582,22 @@ public:
 //
 	const std::string& getTexturePath () const;
 
+//
+//  getDisplayTextureFilename
+//
+//  Purpose: To determine which texture file will be tried first
+//           when this Material is displayed.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The name of the texture file, including the texture
+//           path, that loadDisplayTextures tries first.  This
+//           is the diffuse, ambient, specular, or emission map,
+//           in that order.  If this Material does not have any
+//           of these maps, "" is returned.
+//  Side Effect: N/A
+//
+	std::string getDisplayTextureFilename () const;
+
 //
 //  getIlluminationMode
 //
@@ -2513,6 +2560,31 @@ private:
 //
 	void copy (const Material& original);
 
+//
+//  take
+//
+//  Purpose: To move the values from another Material to this
+//           Material.
+//  Parameter(s):
+//    <1> r_original: The Material to move from
+//  Precondition(s):
+//    <1> mp_emission_map == NULL
+//    <2> mp_ambient_map == NULL
+//    <3> mp_diffuse_map == NULL
+//    <4> mp_specular_map == NULL
+//    <5> mp_specular_exponent_map == NULL
+//    <6> mp_transparency_map == NULL
+//    <7> mp_decal_map == NULL
+//    <8> mp_displacement_map == NULL
+//    <9> mp_bump_map == NULL
+//  Returns: N/A
+//  Side Effect: The values from r_original are moved to this
+//               Material, except the colours, which are copied
+//               elsewhere.  Any existing values are lost.
+//               r_original is reset to the default values.
+//
+	void take (Material& r_original) noexcept;
+
 //
 //  invariant
 //
@@ -0,0 +1,524 @@
+//
+//  Matrix44.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cmath>
+#include <cfloat>	// for DBL_MAX
+#include <iostream>
+#include <vector>
+
+#include "../GetGlut.h"
+#include "Vector3.h"
+#include "Vector3Array.h"
+#include "SimdKernels.h"
+#include "Matrix44.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const double PI = 3.1415926535897932384626433832795;
+
+	const double A_IDENTITY[16] =
+	{
+		1.0, 0.0, 0.0, 0.0,
+		0.0, 1.0, 0.0, 0.0,
+		0.0, 0.0, 1.0, 0.0,
+		0.0, 0.0, 0.0, 1.0,
+	};
+
+	//
+	//  DETERMINANT_TOLERANCE
+	//
+	//  The smallest determinant magnitude for which a matrix is
+	//    considered to be invertible.
+	//
+	const double DETERMINANT_TOLERANCE = 1.0e-12;
+}
+
+
+
+Matrix44 :: Matrix44 ()
+{
+	for(unsigned int i = 0; i < 16; i++)
+		ma_elements[i] = A_IDENTITY[i];
+}
+
+Matrix44 :: Matrix44 (const double a_elements[16])
+{
+	assert(a_elements != NULL);
+
+	for(unsigned int i = 0; i < 16; i++)
+		ma_elements[i] = a_elements[i];
+}
+
+Matrix44 :: Matrix44 (const Vector3& axis_x,
+                      const Vector3& axis_y,
+                      const Vector3& axis_z,
+                      const Vector3& origin)
+{
+	assert(axis_x.isFinite());
+	assert(axis_y.isFinite());
+	assert(axis_z.isFinite());
+	assert(origin.isFinite());
+
+	ma_elements[ 0] = axis_x.x;
+	ma_elements[ 1] = axis_x.y;
+	ma_elements[ 2] = axis_x.z;
+	ma_elements[ 3] = 0.0;
+	ma_elements[ 4] = axis_y.x;
+	ma_elements[ 5] = axis_y.y;
+	ma_elements[ 6] = axis_y.z;
+	ma_elements[ 7] = 0.0;
+	ma_elements[ 8] = axis_z.x;
+	ma_elements[ 9] = axis_z.y;
+	ma_elements[10] = axis_z.z;
+	ma_elements[11] = 0.0;
+	ma_elements[12] = origin.x;
+	ma_elements[13] = origin.y;
+	ma_elements[14] = origin.z;
+	ma_elements[15] = 1.0;
+}
+
+
+
+Matrix44 Matrix44 :: getTranslation (const Vector3& offset)
+{
+	assert(offset.isFinite());
+
+	return Matrix44(Vector3::UNIT_X_PLUS,
+	                Vector3::UNIT_Y_PLUS,
+	                Vector3::UNIT_Z_PLUS,
+	                offset);
+}
+
+Matrix44 Matrix44 :: getScale (double factor)
+{
+	return getScale(Vector3(factor, factor, factor));
+}
+
+Matrix44 Matrix44 :: getScale (const Vector3& factors)
+{
+	assert(factors.isFinite());
+
+	return Matrix44(Vector3(factors.x, 0.0, 0.0),
+	                Vector3(0.0, factors.y, 0.0),
+	                Vector3(0.0, 0.0, factors.z),
+	                Vector3::ZERO);
+}
+
+Matrix44 Matrix44 :: getRotationArbitrary (const Vector3& axis,
+                                           double radians)
+{
+	assert(axis.isFinite());
+	assert(!axis.isZero());
+
+	// rotating each axis gives the columns of the rotation matrix
+	Vector3 normal_axis = axis.getNormalized();
+	return Matrix44(Vector3::UNIT_X_PLUS.getRotatedArbitraryNormal(normal_axis, radians),
+	                Vector3::UNIT_Y_PLUS.getRotatedArbitraryNormal(normal_axis, radians),
+	                Vector3::UNIT_Z_PLUS.getRotatedArbitraryNormal(normal_axis, radians),
+	                Vector3::ZERO);
+}
+
+Matrix44 Matrix44 :: getLookAt (const Vector3& eye,
+                                const Vector3& look_at,
+                                const Vector3& up)
+{
+	assert(eye.isFinite());
+	assert(look_at.isFinite());
+	assert(up.isFinite());
+	assert(eye != look_at);
+	assert(!(look_at - eye).crossProduct(up).isZero());
+
+	Vector3 forward = (look_at - eye).getNormalized();
+	Vector3 side    = forward.crossProduct(up).getNormalized();
+	Vector3 true_up = side.crossProduct(forward);
+
+	// the rows are the camera axes, so the columns are transposed
+	Matrix44 result(Vector3(side.x, true_up.x, -forward.x),
+	                Vector3(side.y, true_up.y, -forward.y),
+	                Vector3(side.z, true_up.z, -forward.z),
+	                Vector3::ZERO);
+	result.ma_elements[12] = -side   .dotProduct(eye);
+	result.ma_elements[13] = -true_up.dotProduct(eye);
+	result.ma_elements[14] =  forward.dotProduct(eye);
+	return result;
+}
+
+Matrix44 Matrix44 :: getPerspective (double fovy_degrees,
+                                     double aspect_ratio,
+                                     double near_distance,
+                                     double far_distance)
+{
+	assert(fovy_degrees > 0.0);
+	assert(fovy_degrees < 180.0);
+	assert(aspect_ratio > 0.0);
+	assert(near_distance > 0.0);
+	assert(far_distance > near_distance);
+
+	double f     = 1.0 / tan(fovy_degrees * PI / 360.0);
+	double depth = near_distance - far_distance;
+
+	double a_elements[16] =
+	{
+		f / aspect_ratio, 0.0, 0.0, 0.0,
+		0.0, f, 0.0, 0.0,
+		0.0, 0.0, (far_distance + near_distance) / depth, -1.0,
+		0.0, 0.0, 2.0 * far_distance * near_distance / depth, 0.0,
+	};
+	return Matrix44(a_elements);
+}
+
+Matrix44 Matrix44 :: getOpenGLModelView ()
+{
+	double a_elements[16];
+	glGetDoublev(GL_MODELVIEW_MATRIX, a_elements);
+	return Matrix44(a_elements);
+}
+
+Matrix44 Matrix44 :: getOpenGLProjection ()
+{
+	double a_elements[16];
+	glGetDoublev(GL_PROJECTION_MATRIX, a_elements);
+	return Matrix44(a_elements);
+}
+
+
+
+bool Matrix44 :: isFinite () const
+{
+	for(unsigned int i = 0; i < 16; i++)
+		if(!(ma_elements[i] <= DBL_MAX && ma_elements[i] >= -DBL_MAX))
+			return false;
+	return true;
+}
+
+double Matrix44 :: getDeterminant () const
+{
+	const double* m = ma_elements;
+
+	// cofactor expansion along the first column
+	double c0 =  m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] +
+	             m[9] * m[7]  * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+	double c1 = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] -
+	             m[8] * m[7]  * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+	double c2 =  m[4] * m[9]  * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] +
+	             m[8] * m[7]  * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+	double c3 = -m[4] * m[9]  * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] -
+	             m[8] * m[6]  * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+
+	return m[0] * c0 + m[1] * c1 + m[2] * c2 + m[3] * c3;
+}
+
+bool Matrix44 :: isInvertible () const
+{
+	return fabs(getDeterminant()) > DETERMINANT_TOLERANCE;
+}
+
+Matrix44 Matrix44 :: getInverse () const
+{
+	assert(isInvertible());
+
+	// adjugate divided by determinant, as in the MESA gluInvertMatrix
+
+	const double* m = ma_elements;
+	double inv[16];
+
+	inv[ 0] =  m[5]  * m[10] * m[15] - m[5]  * m[11] * m[14] - m[9]  * m[6]  * m[15] +
+	           m[9]  * m[7]  * m[14] + m[13] * m[6]  * m[11] - m[13] * m[7]  * m[10];
+	inv[ 4] = -m[4]  * m[10] * m[15] + m[4]  * m[11] * m[14] + m[8]  * m[6]  * m[15] -
+	           m[8]  * m[7]  * m[14] - m[12] * m[6]  * m[11] + m[12] * m[7]  * m[10];
+	inv[ 8] =  m[4]  * m[9]  * m[15] - m[4]  * m[11] * m[13] - m[8]  * m[5]  * m[15] +
+	           m[8]  * m[7]  * m[13] + m[12] * m[5]  * m[11] - m[12] * m[7]  * m[9];
+	inv[12] = -m[4]  * m[9]  * m[14] + m[4]  * m[10] * m[13] + m[8]  * m[5]  * m[14] -
+	           m[8]  * m[6]  * m[13] - m[12] * m[5]  * m[10] + m[12] * m[6]  * m[9];
+	inv[ 1] = -m[1]  * m[10] * m[15] + m[1]  * m[11] * m[14] + m[9]  * m[2]  * m[15] -
+	           m[9]  * m[3]  * m[14] - m[13] * m[2]  * m[11] + m[13] * m[3]  * m[10];
+	inv[ 5] =  m[0]  * m[10] * m[15] - m[0]  * m[11] * m[14] - m[8]  * m[2]  * m[15] +
+	           m[8]  * m[3]  * m[14] + m[12] * m[2]  * m[11] - m[12] * m[3]  * m[10];
+	inv[ 9] = -m[0]  * m[9]  * m[15] + m[0]  * m[11] * m[13] + m[8]  * m[1]  * m[15] -
+	           m[8]  * m[3]  * m[13] - m[12] * m[1]  * m[11] + m[12] * m[3]  * m[9];
+	inv[13] =  m[0]  * m[9]  * m[14] - m[0]  * m[10] * m[13] - m[8]  * m[1]  * m[14] +
+	           m[8]  * m[2]  * m[13] + m[12] * m[1]  * m[10] - m[12] * m[2]  * m[9];
+	inv[ 2] =  m[1]  * m[6]  * m[15] - m[1]  * m[7]  * m[14] - m[5]  * m[2]  * m[15] +
+	           m[5]  * m[3]  * m[14] + m[13] * m[2]  * m[7]  - m[13] * m[3]  * m[6];
+	inv[ 6] = -m[0]  * m[6]  * m[15] + m[0]  * m[7]  * m[14] + m[4]  * m[2]  * m[15] -
+	           m[4]  * m[3]  * m[14] - m[12] * m[2]  * m[7]  + m[12] * m[3]  * m[6];
+	inv[10] =  m[0]  * m[5]  * m[15] - m[0]  * m[7]  * m[13] - m[4]  * m[1]  * m[15] +
+	           m[4]  * m[3]  * m[13] + m[12] * m[1]  * m[7]  - m[12] * m[3]  * m[5];
+	inv[14] = -m[0]  * m[5]  * m[14] + m[0]  * m[6]  * m[13] + m[4]  * m[1]  * m[14] -
+	           m[4]  * m[2]  * m[13] - m[12] * m[1]  * m[6]  + m[12] * m[2]  * m[5];
+	inv[ 3] = -m[1]  * m[6]  * m[11] + m[1]  * m[7]  * m[10] + m[5]  * m[2]  * m[11] -
+	           m[5]  * m[3]  * m[10] - m[9]  * m[2]  * m[7]  + m[9]  * m[3]  * m[6];
+	inv[ 7] =  m[0]  * m[6]  * m[11] - m[0]  * m[7]  * m[10] - m[4]  * m[2]  * m[11] +
+	           m[4]  * m[3]  * m[10] + m[8]  * m[2]  * m[7]  - m[8]  * m[3]  * m[6];
+	inv[11] = -m[0]  * m[5]  * m[11] + m[0]  * m[7]  * m[9]  + m[4]  * m[1]  * m[11] -
+	           m[4]  * m[3]  * m[9]  - m[8]  * m[1]  * m[7]  + m[8]  * m[3]  * m[5];
+	inv[15] =  m[0]  * m[5]  * m[10] - m[0]  * m[6]  * m[9]  - m[4]  * m[1]  * m[10] +
+	           m[4]  * m[2]  * m[9]  + m[8]  * m[1]  * m[6]  - m[8]  * m[2]  * m[5];
+
+	double determinant = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+	assert(determinant != 0.0);
+	double factor = 1.0 / determinant;
+
+	Matrix44 result;
+	for(unsigned int i = 0; i < 16; i++)
+		result.ma_elements[i] = inv[i] * factor;
+	return result;
+}
+
+Matrix44 Matrix44 :: getTranspose () const
+{
+	Matrix44 result;
+	for(unsigned int r = 0; r < 4; r++)
+		for(unsigned int c = 0; c < 4; c++)
+			result.ma_elements[r * 4 + c] = ma_elements[c * 4 + r];
+	return result;
+}
+
+Vector3 Matrix44 :: getTransformedPoint (const Vector3& point) const
+{
+	assert(point.isFinite());
+
+	const double* m = ma_elements;
+	return Vector3(m[0] * point.x + m[4] * point.y + m[ 8] * point.z + m[12],
+	               m[1] * point.x + m[5] * point.y + m[ 9] * point.z + m[13],
+	               m[2] * point.x + m[6] * point.y + m[10] * point.z + m[14]);
+}
+
+Vector3 Matrix44 :: getTransformedVector (const Vector3& vector) const
+{
+	assert(vector.isFinite());
+
+	const double* m = ma_elements;
+	return Vector3(m[0] * vector.x + m[4] * vector.y + m[ 8] * vector.z,
+	               m[1] * vector.x + m[5] * vector.y + m[ 9] * vector.z,
+	               m[2] * vector.x + m[6] * vector.y + m[10] * vector.z);
+}
+
+Vector3 Matrix44 :: getTransformedNormal (const Vector3& normal) const
+{
+	assert(normal.isFinite());
+
+	double a_rows[9];
+	getNormalRows(a_rows);
+
+	Vector3 result(a_rows[0] * normal.x + a_rows[1] * normal.y + a_rows[2] * normal.z,
+	               a_rows[3] * normal.x + a_rows[4] * normal.y + a_rows[5] * normal.z,
+	               a_rows[6] * normal.x + a_rows[7] * normal.y + a_rows[8] * normal.z);
+	return result.getNormalizedSafe();
+}
+
+Vector3 Matrix44 :: getProjectedPoint (const Vector3& point) const
+{
+	assert(point.isFinite());
+
+	const double* m = ma_elements;
+	double w = m[3] * point.x + m[7] * point.y + m[11] * point.z + m[15];
+	return getTransformedPoint(point) / w;
+}
+
+template <typename T>
+void Matrix44 :: transformPoints (const Vector3Array<T>& points,
+                                  Vector3Array<T>& r_results) const
+{
+	unsigned int size = points.getSize();
+	r_results.resize(size);
+	if(size == 0)
+		return;
+
+	T a_rows[12];
+	getAffineRows(a_rows);
+	SimdKernels::getTable<T>().affineProduct3(size, a_rows,
+	                                          points.getArrayX(), points.getArrayY(), points.getArrayZ(),
+	                                          r_results.getArrayX(), r_results.getArrayY(), r_results.getArrayZ());
+}
+
+template <typename T>
+void Matrix44 :: transformVectors (const Vector3Array<T>& vectors,
+                                   Vector3Array<T>& r_results) const
+{
+	unsigned int size = vectors.getSize();
+	r_results.resize(size);
+	if(size == 0)
+		return;
+
+	T a_rows[12];
+	getAffineRows(a_rows);
+	T a_matrix[9] =
+	{
+		a_rows[0], a_rows[1], a_rows[ 2],
+		a_rows[4], a_rows[5], a_rows[ 6],
+		a_rows[8], a_rows[9], a_rows[10],
+	};
+	SimdKernels::getTable<T>().matrixProduct3(size, a_matrix,
+	                                          vectors.getArrayX(), vectors.getArrayY(), vectors.getArrayZ(),
+	                                          r_results.getArrayX(), r_results.getArrayY(), r_results.getArrayZ());
+}
+
+template <typename T>
+void Matrix44 :: transformNormals (const Vector3Array<T>& normals,
+                                   Vector3Array<T>& r_results) const
+{
+	unsigned int size = normals.getSize();
+	r_results.resize(size);
+	if(size == 0)
+		return;
+
+	T a_rows[9];
+	getNormalRows(a_rows);
+
+	const SimdKernels::Table<T>& kernels = SimdKernels::getTable<T>();
+	kernels.matrixProduct3(size, a_rows,
+	                       normals.getArrayX(), normals.getArrayY(), normals.getArrayZ(),
+	                       r_results.getArrayX(), r_results.getArrayY(), r_results.getArrayZ());
+	kernels.normalize3(size,
+	                   r_results.getArrayX(), r_results.getArrayY(), r_results.getArrayZ(),
+	                   r_results.getArrayX(), r_results.getArrayY(), r_results.getArrayZ());
+}
+
+template <typename T>
+void Matrix44 :: projectPoints (const Vector3Array<T>& points,
+                                Vector3Array<T>& r_results,
+                                vector<T>& rv_w) const
+{
+	unsigned int size = points.getSize();
+	r_results.resize(size);
+	rv_w.resize(size);
+	if(size == 0)
+		return;
+
+	T a_rows[16];
+	for(unsigned int r = 0; r < 4; r++)
+		for(unsigned int c = 0; c < 4; c++)
+			a_rows[r * 4 + c] = (T)(ma_elements[c * 4 + r]);
+	SimdKernels::getTable<T>().projectiveProduct3(size, a_rows,
+	                                              points.getArrayX(), points.getArrayY(), points.getArrayZ(),
+	                                              r_results.getArrayX(), r_results.getArrayY(), r_results.getArrayZ(),
+	                                              &(rv_w[0]));
+}
+
+void Matrix44 :: applyToOpenGL () const
+{
+	glMultMatrixd(ma_elements);
+}
+
+void Matrix44 :: loadToOpenGL () const
+{
+	glLoadMatrixd(ma_elements);
+}
+
+Matrix44 Matrix44 :: operator* (const Matrix44& right) const
+{
+	Matrix44 result;
+	SimdKernels::getTable<double>().matrixMultiply4(ma_elements,
+	                                                right.ma_elements,
+	                                                result.ma_elements);
+	return result;
+}
+
+
+
+void Matrix44 :: setIdentity ()
+{
+	for(unsigned int i = 0; i < 16; i++)
+		ma_elements[i] = A_IDENTITY[i];
+}
+
+
+
+template <typename T>
+void Matrix44 :: getAffineRows (T a_rows[12]) const
+{
+	assert(a_rows != NULL);
+
+	for(unsigned int r = 0; r < 3; r++)
+		for(unsigned int c = 0; c < 4; c++)
+			a_rows[r * 4 + c] = (T)(ma_elements[c * 4 + r]);
+}
+
+template <typename T>
+void Matrix44 :: getNormalRows (T a_rows[9]) const
+{
+	assert(a_rows != NULL);
+
+	const double* m = ma_elements;
+
+	// the cofactor matrix is the inverse transpose times the determinant
+	double c00 = m[5] * m[10] - m[9] * m[6];
+	double c01 = m[9] * m[2]  - m[1] * m[10];
+	double c02 = m[1] * m[6]  - m[5] * m[2];
+	double c10 = m[8] * m[6]  - m[4] * m[10];
+	double c11 = m[0] * m[10] - m[8] * m[2];
+	double c12 = m[4] * m[2]  - m[0] * m[6];
+	double c20 = m[4] * m[9]  - m[8] * m[5];
+	double c21 = m[8] * m[1]  - m[0] * m[9];
+	double c22 = m[0] * m[5]  - m[4] * m[1];
+
+	// a negative determinant would flip the normals
+	double determinant = m[0] * c00 + m[4] * c01 + m[8] * c02;
+	double sign = (determinant < 0.0) ? -1.0 : 1.0;
+
+	a_rows[0] = (T)(c00 * sign);
+	a_rows[1] = (T)(c01 * sign);
+	a_rows[2] = (T)(c02 * sign);
+	a_rows[3] = (T)(c10 * sign);
+	a_rows[4] = (T)(c11 * sign);
+	a_rows[5] = (T)(c12 * sign);
+	a_rows[6] = (T)(c20 * sign);
+	a_rows[7] = (T)(c21 * sign);
+	a_rows[8] = (T)(c22 * sign);
+}
+
+
+
+ostream& ObjLibrary :: operator<< (ostream& r_os, const Matrix44& matrix)
+{
+	for(unsigned int r = 0; r < 4; r++)
+	{
+		r_os << "[";
+		for(unsigned int c = 0; c < 4; c++)
+		{
+			if(c > 0)
+				r_os << ", ";
+			r_os << matrix.get(r, c);
+		}
+		r_os << "]";
+		if(r < 3)
+			r_os << endl;
+	}
+	return r_os;
+}
+
+
+
+//
+//  The batch transform functions are only available for the
+//    same types as Vector3Array.
+//
+
+template void Matrix44 :: transformPoints<float>  (const Vector3Array<float>&,  Vector3Array<float>&)  const;
+template void Matrix44 :: transformPoints<double> (const Vector3Array<double>&, Vector3Array<double>&) const;
+template void Matrix44 :: transformVectors<float>  (const Vector3Array<float>&,  Vector3Array<float>&)  const;
+template void Matrix44 :: transformVectors<double> (const Vector3Array<double>&, Vector3Array<double>&) const;
+template void Matrix44 :: transformNormals<float>  (const Vector3Array<float>&,  Vector3Array<float>&)  const;
+template void Matrix44 :: transformNormals<double> (const Vector3Array<double>&, Vector3Array<double>&) const;
+template void Matrix44 :: projectPoints<float>  (const Vector3Array<float>&,  Vector3Array<float>&,  vector<float>&)  const;
+template void Matrix44 :: projectPoints<double> (const Vector3Array<double>&, Vector3Array<double>&, vector<double>&) const;
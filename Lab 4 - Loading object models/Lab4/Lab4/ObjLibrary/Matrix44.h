@@ -0,0 +1,718 @@
+//
+//  Matrix44.h
+//
+//  A module to store and manipulate 4x4 transformation
+//    matrices on the CPU.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_MATRIX44_H
+#define OBJ_LIBRARY_MATRIX44_H
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "Vector3.h"
+#include "Vector3Array.h"
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  Matrix44
+//
+//  A class to represent a 4x4 transformation matrix, such as
+//    the ones used by the OpenGL matrix stack.  The elements
+//    are stored as doubles in column-major order, which is the
+//    order used by OpenGL.  This means that getArray() can be
+//    passed directly to glMultMatrixd or glLoadMatrixd.
+//
+//  Matrix44s are combined in the same order as the OpenGL
+//    matrix functions.  The code:
+//      glTranslated(...);
+//      glRotated(...);
+//      glScaled(...);
+//    is equivilent to:
+//      Matrix44 m = Matrix44::getTranslation(...) *
+//                   Matrix44::getRotationArbitrary(...) *
+//                   Matrix44::getScale(...);
+//      m.applyToOpenGL();
+//    Note that the rotation functions take angles in radians,
+//    like the Vector3 class, and not degrees, like glRotated.
+//
+//  Matrix multiplication and the batch transform functions
+//    use the kernels in SimdKernels.h.
+//
+class Matrix44
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new Matrix44 that is the identity
+//           matrix.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new identity Matrix44 is created.
+//
+	Matrix44 ();
+
+//
+//  Array Constructor
+//
+//  Purpose: To create a new Matrix44 with the specified
+//           elements.
+//  Parameter(s):
+//    <1> a_elements: The 16 elements in column-major order
+//  Precondition(s):
+//    <1> a_elements != NULL
+//  Returns: N/A
+//  Side Effect: A new Matrix44 is created with elements
+//               a_elements.
+//
+	explicit Matrix44 (const double a_elements[16]);
+
+//
+//  Basis Constructor
+//
+//  Purpose: To create a new Matrix44 that transforms into the
+//           coordinate system with the specified axes and
+//           origin.
+//  Parameter(s):
+//    <1> axis_x
+//    <2> axis_y
+//    <3> axis_z: The axes of the coordinate system
+//    <4> origin: The origin of the coordinate system
+//  Precondition(s):
+//    <1> axis_x.isFinite()
+//    <2> axis_y.isFinite()
+//    <3> axis_z.isFinite()
+//    <4> origin.isFinite()
+//  Returns: N/A
+//  Side Effect: A new Matrix44 is created with columns axis_x,
+//               axis_y, axis_z, and origin.  The bottom row is
+//               (0, 0, 0, 1).
+//
+	Matrix44 (const Vector3& axis_x,
+	          const Vector3& axis_y,
+	          const Vector3& axis_z,
+	          const Vector3& origin);
+
+//
+//  getTranslation
+//
+//  Purpose: To create a Matrix44 that translates by the
+//           specified offset.
+//  Parameter(s):
+//    <1> offset: The offset
+//  Precondition(s):
+//    <1> offset.isFinite()
+//  Returns: A translation Matrix44.  This is the same matrix
+//           as produced by glTranslated.
+//  Side Effect: N/A
+//
+	static Matrix44 getTranslation (const Vector3& offset);
+
+//
+//  getScale
+//
+//  Purpose: To create a Matrix44 that scales uniformly by the
+//           specified factor.
+//  Parameter(s):
+//    <1> factor: The scaling factor
+//  Precondition(s): N/A
+//  Returns: A scaling Matrix44.
+//  Side Effect: N/A
+//
+	static Matrix44 getScale (double factor);
+
+//
+//  getScale
+//
+//  Purpose: To create a Matrix44 that scales by a different
+//           factor along each axis.
+//  Parameter(s):
+//    <1> factors: The scaling factors for each axis
+//  Precondition(s):
+//    <1> factors.isFinite()
+//  Returns: A scaling Matrix44.  This is the same matrix as
+//           produced by glScaled.
+//  Side Effect: N/A
+//
+	static Matrix44 getScale (const Vector3& factors);
+
+//
+//  getRotationArbitrary
+//
+//  Purpose: To create a Matrix44 that rotates around the
+//           specified axis.
+//  Parameter(s):
+//    <1> axis: The axis to rotate around
+//    <2> radians: The angle to rotate by
+//  Precondition(s):
+//    <1> axis.isFinite()
+//    <2> !axis.isZero()
+//  Returns: A rotation Matrix44.  This is the same matrix as
+//           produced by glRotated, except that the angle is in
+//           radians.
+//  Side Effect: N/A
+//
+	static Matrix44 getRotationArbitrary (const Vector3& axis,
+	                                      double radians);
+
+//
+//  getLookAt
+//
+//  Purpose: To create a Matrix44 for a camera looking at a
+//           specified point.
+//  Parameter(s):
+//    <1> eye: The camera position
+//    <2> look_at: The point to look at
+//    <3> up: The approximate up direction
+//  Precondition(s):
+//    <1> eye.isFinite()
+//    <2> look_at.isFinite()
+//    <3> up.isFinite()
+//    <4> eye != look_at
+//    <5> up is not parallel to look_at - eye
+//  Returns: A view Matrix44.  This is the same matrix as
+//           produced by gluLookAt.
+//  Side Effect: N/A
+//
+	static Matrix44 getLookAt (const Vector3& eye,
+	                           const Vector3& look_at,
+	                           const Vector3& up);
+
+//
+//  getPerspective
+//
+//  Purpose: To create a perspective projection Matrix44.
+//  Parameter(s):
+//    <1> fovy_degrees: The vertical field of view in degrees
+//    <2> aspect_ratio: The width of the view divided by its
+//                      height
+//    <3> near_distance: The distance to the near clipping
+//                       plane
+//    <4> far_distance: The distance to the far clipping plane
+//  Precondition(s):
+//    <1> fovy_degrees > 0.0
+//    <2> fovy_degrees < 180.0
+//    <3> aspect_ratio > 0.0
+//    <4> near_distance > 0.0
+//    <5> far_distance > near_distance
+//  Returns: A projection Matrix44.  This is the same matrix as
+//           produced by gluPerspective.
+//  Side Effect: N/A
+//
+	static Matrix44 getPerspective (double fovy_degrees,
+	                                double aspect_ratio,
+	                                double near_distance,
+	                                double far_distance);
+
+//
+//  getOpenGLModelView
+//  getOpenGLProjection
+//
+//  Purpose: To retrieve the current OpenGL modelview or
+//           projection matrix.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> An OpenGL context is active
+//  Returns: The current matrix on top of the OpenGL modelview
+//           or projection matrix stack.
+//  Side Effect: N/A
+//
+	static Matrix44 getOpenGLModelView ();
+	static Matrix44 getOpenGLProjection ();
+
+//
+//  get
+//
+//  Purpose: To retrieve the specified element.
+//  Parameter(s):
+//    <1> row: The row of the element
+//    <2> column: The column of the element
+//  Precondition(s):
+//    <1> row < 4
+//    <2> column < 4
+//  Returns: The element in row row and column column.
+//  Side Effect: N/A
+//
+	double get (unsigned int row, unsigned int column) const
+	{
+		assert(row < 4);
+		assert(column < 4);
+
+		return ma_elements[column * 4 + row];
+	}
+
+//
+//  getArray
+//
+//  Purpose: To retrieve the elements of this Matrix44 as an
+//           array.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: A pointer to the 16 elements in column-major
+//           order.
+//  Side Effect: N/A
+//
+	const double* getArray () const
+	{ return ma_elements; }
+
+//
+//  getColumn
+//
+//  Purpose: To retrieve the first three elements of the
+//           specified column.
+//  Parameter(s):
+//    <1> column: Which column
+//  Precondition(s):
+//    <1> column < 4
+//  Returns: The top 3 elements of column column.  For an
+//           affine transformation, columns 0 to 2 are the
+//           transformed axes and column 3 is the transformed
+//           origin.
+//  Side Effect: N/A
+//
+	Vector3 getColumn (unsigned int column) const
+	{
+		assert(column < 4);
+
+		return Vector3(ma_elements[column * 4 + 0],
+		               ma_elements[column * 4 + 1],
+		               ma_elements[column * 4 + 2]);
+	}
+
+//
+//  isFinite
+//
+//  Purpose: To determine if all elements of this Matrix44 are
+//           finite numbers.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether all 16 elements are finite.
+//  Side Effect: N/A
+//
+	bool isFinite () const;
+
+//
+//  isAffine
+//
+//  Purpose: To determine if this Matrix44 is an affine
+//           transformation.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the bottom row is (0, 0, 0, 1).  Matrices
+//           built from translations, rotations, and scales are
+//           always affine.  Projection matrices are not.
+//  Side Effect: N/A
+//
+	bool isAffine () const
+	{
+		return ma_elements[3]  == 0.0 &&
+		       ma_elements[7]  == 0.0 &&
+		       ma_elements[11] == 0.0 &&
+		       ma_elements[15] == 1.0;
+	}
+
+//
+//  getDeterminant
+//
+//  Purpose: To calculate the determinant of this Matrix44.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The determinant.
+//  Side Effect: N/A
+//
+	double getDeterminant () const;
+
+//
+//  isInvertible
+//
+//  Purpose: To determine if this Matrix44 has an inverse.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the determinant of this Matrix44 is
+//           significantly different from 0.0.
+//  Side Effect: N/A
+//
+	bool isInvertible () const;
+
+//
+//  getInverse
+//
+//  Purpose: To calculate the inverse of this Matrix44.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInvertible()
+//  Returns: The inverse of this Matrix44.
+//  Side Effect: N/A
+//
+	Matrix44 getInverse () const;
+
+//
+//  getTranspose
+//
+//  Purpose: To calculate the transpose of this Matrix44.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: This Matrix44 with the rows and columns swapped.
+//  Side Effect: N/A
+//
+	Matrix44 getTranspose () const;
+
+//
+//  getTransformedPoint
+//
+//  Purpose: To transform a point by this Matrix44.
+//  Parameter(s):
+//    <1> point: The point to transform
+//  Precondition(s):
+//    <1> point.isFinite()
+//  Returns: The result of multiplying (point, 1) by this
+//           Matrix44.  The bottom row of this Matrix44 is
+//           ignored, so it should be affine.
+//  Side Effect: N/A
+//
+	Vector3 getTransformedPoint (const Vector3& point) const;
+
+//
+//  getTransformedVector
+//
+//  Purpose: To transform a direction vector by this Matrix44.
+//  Parameter(s):
+//    <1> vector: The vector to transform
+//  Precondition(s):
+//    <1> vector.isFinite()
+//  Returns: The result of multiplying (vector, 0) by this
+//           Matrix44.  The translation is not applied.
+//  Side Effect: N/A
+//
+	Vector3 getTransformedVector (const Vector3& vector) const;
+
+//
+//  getTransformedNormal
+//
+//  Purpose: To transform a surface normal by this Matrix44.
+//  Parameter(s):
+//    <1> normal: The normal to transform
+//  Precondition(s):
+//    <1> normal.isFinite()
+//  Returns: normal transformed by the inverse transpose of
+//           the top-left 3x3 part of this Matrix44 and
+//           normalized.  This keeps normals perpendicular to
+//           their surfaces under non-uniform scaling.  If the
+//           result is the zero vector, the zero vector is
+//           returned.
+//  Side Effect: N/A
+//  Note: For many normals, transformNormals is much faster.
+//
+	Vector3 getTransformedNormal (const Vector3& normal) const;
+
+//
+//  getProjectedPoint
+//
+//  Purpose: To transform a point by this Matrix44 including
+//           the perspective divide.
+//  Parameter(s):
+//    <1> point: The point to transform
+//  Precondition(s):
+//    <1> point.isFinite()
+//  Returns: The result of multiplying (point, 1) by this
+//           Matrix44, divided by the resulting W component.
+//           If W is 0.0, the result is not finite.
+//  Side Effect: N/A
+//
+	Vector3 getProjectedPoint (const Vector3& point) const;
+
+//
+//  transformPoints
+//
+//  Purpose: To transform many points by this Matrix44.
+//  Parameter(s):
+//    <1> points: The points to transform
+//    <2> r_results: The Vector3Array to fill
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: r_results is resized to points.getSize() and
+//               each element is set to the corresponding
+//               element of points transformed as by
+//               getTransformedPoint.  r_results may be points.
+//
+	template <typename T>
+	void transformPoints (const Vector3Array<T>& points,
+	                      Vector3Array<T>& r_results) const;
+
+//
+//  transformVectors
+//
+//  Purpose: To transform many direction vectors by this
+//           Matrix44.
+//  Parameter(s):
+//    <1> vectors: The vectors to transform
+//    <2> r_results: The Vector3Array to fill
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: r_results is resized to vectors.getSize() and
+//               each element is set to the corresponding
+//               element of vectors transformed as by
+//               getTransformedVector.  r_results may be
+//               vectors.
+//
+	template <typename T>
+	void transformVectors (const Vector3Array<T>& vectors,
+	                       Vector3Array<T>& r_results) const;
+
+//
+//  transformNormals
+//
+//  Purpose: To transform many surface normals by this
+//           Matrix44.
+//  Parameter(s):
+//    <1> normals: The normals to transform
+//    <2> r_results: The Vector3Array to fill
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: r_results is resized to normals.getSize() and
+//               each element is set to the corresponding
+//               element of normals transformed as by
+//               getTransformedNormal.  r_results may be
+//               normals.
+//
+	template <typename T>
+	void transformNormals (const Vector3Array<T>& normals,
+	                       Vector3Array<T>& r_results) const;
+
+//
+//  projectPoints
+//
+//  Purpose: To transform many points by this Matrix44 without
+//           the perspective divide.
+//  Parameter(s):
+//    <1> points: The points to transform
+//    <2> r_results: The Vector3Array to fill with the X, Y,
+//                   and Z components
+//    <3> rv_w: The vector to fill with the W components
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: r_results and rv_w are resized to
+//               points.getSize().  Each element is set to the
+//               corresponding element of points, as (x, y, z,
+//               1), multiplied by this Matrix44.  For a
+//               projection matrix, these are the clip
+//               coordinates.  r_results may be points.
+//
+	template <typename T>
+	void projectPoints (const Vector3Array<T>& points,
+	                    Vector3Array<T>& r_results,
+	                    std::vector<T>& rv_w) const;
+
+//
+//  applyToOpenGL
+//
+//  Purpose: To multiply the current OpenGL matrix by this
+//           Matrix44.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> An OpenGL context is active
+//  Returns: N/A
+//  Side Effect: The top of the current OpenGL matrix stack is
+//               multiplied by this Matrix44, as if by
+//               glMultMatrixd.
+//
+	void applyToOpenGL () const;
+
+//
+//  loadToOpenGL
+//
+//  Purpose: To replace the current OpenGL matrix with this
+//           Matrix44.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> An OpenGL context is active
+//  Returns: N/A
+//  Side Effect: The top of the current OpenGL matrix stack is
+//               replaced by this Matrix44, as if by
+//               glLoadMatrixd.
+//
+	void loadToOpenGL () const;
+
+//
+//  Multiplication Operator
+//
+//  Purpose: To multiply this Matrix44 by another.
+//  Parameter(s):
+//    <1> right: The Matrix44 to multiply by
+//  Precondition(s): N/A
+//  Returns: The product of this Matrix44 and right, with
+//           right applied first.
+//  Side Effect: N/A
+//
+	Matrix44 operator* (const Matrix44& right) const;
+
+//
+//  set
+//
+//  Purpose: To change the specified element.
+//  Parameter(s):
+//    <1> row: The row of the element
+//    <2> column: The column of the element
+//    <3> value: The new value
+//  Precondition(s):
+//    <1> row < 4
+//    <2> column < 4
+//  Returns: N/A
+//  Side Effect: The element in row row and column column is
+//               set to value.
+//
+	void set (unsigned int row, unsigned int column, double value)
+	{
+		assert(row < 4);
+		assert(column < 4);
+
+		ma_elements[column * 4 + row] = value;
+	}
+
+//
+//  setIdentity
+//
+//  Purpose: To change this Matrix44 into the identity matrix.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This Matrix44 is set to the identity matrix.
+//
+	void setIdentity ();
+
+//
+//  invert
+//
+//  Purpose: To replace this Matrix44 with its inverse.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInvertible()
+//  Returns: N/A
+//  Side Effect: This Matrix44 is set to its inverse.
+//
+	void invert ()
+	{
+		assert(isInvertible());
+
+		*this = getInverse();
+	}
+
+//
+//  transpose
+//
+//  Purpose: To replace this Matrix44 with its transpose.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The rows and columns of this Matrix44 are
+//               swapped.
+//
+	void transpose ()
+	{ *this = getTranspose(); }
+
+//
+//  Multiplication Assignment Operator
+//
+//  Purpose: To multiply this Matrix44 by another.
+//  Parameter(s):
+//    <1> right: The Matrix44 to multiply by
+//  Precondition(s): N/A
+//  Returns: A reference to this Matrix44.
+//  Side Effect: This Matrix44 is set to the product of this
+//               Matrix44 and right, with right applied first.
+//               This is the same as glMultMatrixd.
+//
+	Matrix44& operator*= (const Matrix44& right)
+	{
+		*this = *this * right;
+		return *this;
+	}
+
+private:
+//
+//  getAffineRows
+//
+//  Purpose: To copy the top 3 rows of this Matrix44 into an
+//           array in row-major order.
+//  Parameter(s):
+//    <1> a_rows: The array to fill
+//  Precondition(s):
+//    <1> a_rows != NULL
+//  Returns: N/A
+//  Side Effect: a_rows is set to contain the top 3 rows of
+//               this Matrix44, with 4 elements per row.
+//
+	template <typename T>
+	void getAffineRows (T a_rows[12]) const;
+
+//
+//  getNormalRows
+//
+//  Purpose: To calculate the matrix used to transform normals.
+//  Parameter(s):
+//    <1> a_rows: The array to fill
+//  Precondition(s):
+//    <1> a_rows != NULL
+//  Returns: N/A
+//  Side Effect: a_rows is set to contain a 3x3 matrix in
+//               row-major order.  This matrix is the inverse
+//               transpose of the top-left 3x3 part of this
+//               Matrix44, multiplied by the absolute value of
+//               its determinant.  The scaling does not matter
+//               because normals are normalized afterwards, and
+//               it allows this function to work for
+//               non-invertible matrices.
+//
+	template <typename T>
+	void getNormalRows (T a_rows[9]) const;
+
+private:
+	double ma_elements[16];
+};
+
+
+
+//
+//  Stream Insertion Operator
+//
+//  Purpose: To print the specified Matrix44 to the specified
+//           output stream.
+//  Parameter(s):
+//    <1> r_os: The output stream
+//    <2> matrix: The Matrix44
+//  Precondition(s): N/A
+//  Returns: A reference to r_os.
+//  Side Effect: matrix is printed to r_os as 4 rows of 4
+//               elements each.
+//
+std::ostream& operator<< (std::ostream& r_os,
+                          const Matrix44& matrix);
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
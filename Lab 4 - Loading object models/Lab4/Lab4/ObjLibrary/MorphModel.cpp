@@ -0,0 +1,546 @@
+//
+//  MorphModel.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <climits>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../GetGlut.h"
+#include "Vector3.h"
+#include "Vector2.h"
+#include "Vector3Array.h"
+#include "SimdKernels.h"
+#include "Material.h"
+#include "MtlLibrary.h"
+#include "ObjModel.h"
+#include "JobSystem.h"
+#include "MorphModel.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  MIN_PER_THREAD
+	//
+	//  The smallest number of elements worth giving to another
+	//    thread.  Smaller models are blended on the calling
+	//    thread only.
+	//
+	const unsigned int MIN_PER_THREAD = 8192;
+
+	//
+	//  NO_DRAW_NORMAL
+	//
+	//  The value stored for a draw vertex with no normal.  This
+	//    is ObjModel::NO_NORMAL narrowed to an unsigned int.
+	//
+	const unsigned int NO_DRAW_NORMAL = ~0u;
+
+	//
+	//  findMeshMaterial
+	//
+	//  Purpose: To find the Material for a mesh in an ObjModel.
+	//  Parameter(s):
+	//    <1> model: The ObjModel
+	//    <2> mesh: Which mesh
+	//  Precondition(s):
+	//    <1> mesh < model.getMeshCount()
+	//  Returns: The Material for mesh mesh, or NULL if it has no
+	//           material or the material could not be found.
+	//           This matches the material ObjModel::draw uses.
+	//  Side Effect: N/A
+	//
+	const Material* findMeshMaterial (const ObjModel& model,
+	                                  unsigned int mesh)
+	{
+		assert(mesh < model.getMeshCount());
+
+		if(!model.isMeshMaterial(mesh))
+			return NULL;
+
+		const string& name = model.getMeshMaterialName(mesh);
+		for(unsigned int i = 0; i < model.getMaterialLibraryCount(); i++)
+		{
+			const MtlLibrary* p_library = model.getMaterialLibrary(i);
+			if(p_library == NULL)
+				continue;
+
+			unsigned int index = p_library->getMaterialIndex(name);
+			if(index != MtlLibrary::NO_SUCH_MATERIAL)
+				return p_library->getMaterial(index);
+		}
+		return NULL;
+	}
+
+	float* getPointer (vector<float>& rv_values)
+	{
+		return rv_values.empty() ? NULL : &(rv_values[0]);
+	}
+}
+
+
+
+bool MorphModel :: isSameTopology (const ObjModel& a,
+                                   const ObjModel& b)
+{
+	assert(a.isValid());
+	assert(b.isValid());
+
+	vector<unsigned int> v_topology_a;
+	vector<unsigned int> v_topology_b;
+	getTopology(a, v_topology_a);
+	getTopology(b, v_topology_b);
+	return v_topology_a == v_topology_b;
+}
+
+
+
+MorphModel :: MorphModel ()
+		: m_is_initialized(false),
+		  m_thread_count(JobSystem::getShared().getWorkerCount() + 1)
+{
+}
+
+MorphModel :: MorphModel (const ObjModel& base)
+		: m_is_initialized(false),
+		  m_thread_count(JobSystem::getShared().getWorkerCount() + 1)
+{
+	assert(base.isValid());
+
+	init(base);
+}
+
+
+
+unsigned int MorphModel :: getVertexCount () const
+{
+	assert(isInitialized());
+
+	return m_base_positions.getSize();
+}
+
+unsigned int MorphModel :: getNormalCount () const
+{
+	assert(isInitialized());
+
+	return m_base_normals.getSize();
+}
+
+unsigned int MorphModel :: getTargetCount () const
+{
+	assert(isInitialized());
+
+	return (unsigned int)(mv_targets.size());
+}
+
+float MorphModel :: getWeight (unsigned int target) const
+{
+	assert(isInitialized());
+	assert(target < getTargetCount());
+
+	return mv_targets[target].m_weight;
+}
+
+const Vector3Array<float>& MorphModel :: getPositions () const
+{
+	assert(isInitialized());
+
+	return m_positions;
+}
+
+const Vector3Array<float>& MorphModel :: getNormals () const
+{
+	assert(isInitialized());
+
+	return m_normals;
+}
+
+void MorphModel :: draw () const
+{
+	assert(isInitialized());
+	assert(!Material::isMaterialActive());
+
+	for(unsigned int m = 0; m < mv_meshes.size(); m++)
+	{
+		const Material* p_material = mv_meshes[m].mp_material;
+
+		if(p_material == NULL)
+			drawMesh(m);
+		else
+		{
+			p_material->activate();
+			drawMesh(m);
+			Material::deactivate();
+
+			if(p_material->isSeperateSpecular())
+			{
+				p_material->activateSeperateSpecular();
+				drawMesh(m);
+				Material::deactivate();
+			}
+		}
+	}
+
+	assert(!Material::isMaterialActive());
+}
+
+void MorphModel :: drawMaterialNone () const
+{
+	assert(isInitialized());
+
+	for(unsigned int m = 0; m < mv_meshes.size(); m++)
+		drawMesh(m);
+}
+
+
+
+void MorphModel :: init (const ObjModel& base)
+{
+	assert(base.isValid());
+	assert(base.getVertexCount() <= UINT_MAX);
+	assert(base.getNormalCount() <= UINT_MAX);
+
+	getTopology(base, mv_topology);
+
+	unsigned int vertex_count = (unsigned int)(base.getVertexCount());
+	unsigned int normal_count = (unsigned int)(base.getNormalCount());
+
+	m_base_positions.resize(vertex_count);
+	for(unsigned int v = 0; v < vertex_count; v++)
+		m_base_positions.set(v, base.getVertexPosition(v));
+	m_base_normals.resize(normal_count);
+	for(unsigned int n = 0; n < normal_count; n++)
+		m_base_normals.set(n, base.getNormalVector(n));
+	mv_targets.clear();
+	m_positions = m_base_positions;
+	m_normals   = m_base_normals;
+
+	//
+	//  OpenGL vertex arrays need one index per vertex, so each
+	//    unique vertex/texture coordinate/normal combination
+	//    becomes a draw vertex.  Most vertexes only appear in
+	//    a few combinations, so we search a short list for each
+	//    vertex.
+	//
+
+	struct Combination
+	{
+		ObjModel::Index m_texture_coordinate;
+		ObjModel::Index m_normal;
+		unsigned int m_draw_vertex;
+	};
+	vector<vector<Combination> > vv_combinations(vertex_count);
+
+	mv_draw_vertexes.clear();
+	mv_draw_normals.clear();
+	mv_draw_texture_coordinate_data.clear();
+	mv_meshes.clear();
+	mv_meshes.resize(base.getMeshCount());
+
+	for(unsigned int m = 0; m < base.getMeshCount(); m++)
+	{
+		Mesh& r_mesh = mv_meshes[m];
+		r_mesh.mp_material              = findMeshMaterial(base, m);
+		r_mesh.m_is_normals             = base.isMeshNormalAny(m);
+		r_mesh.m_is_texture_coordinates = base.isMeshTextureCoordinatesAny(m);
+
+		for(unsigned int f = 0; f < base.getFaceCount(m); f++)
+		{
+			unsigned int face_vertex_count = base.getFaceVertexCount(m, f);
+			vector<unsigned int> v_face;
+
+			for(unsigned int v = 0; v < face_vertex_count; v++)
+			{
+				ObjModel::Index vertex             = base.getFaceVertexIndex(m, f, v);
+				ObjModel::Index texture_coordinate = base.getFaceVertexTextureCoordinates(m, f, v);
+				ObjModel::Index normal             = base.getFaceVertexNormal(m, f, v);
+				assert(vertex < vertex_count);
+
+				unsigned int draw_vertex = (unsigned int)(mv_draw_vertexes.size());
+				vector<Combination>& rv_list = vv_combinations[vertex];
+				for(unsigned int c = 0; c < rv_list.size(); c++)
+					if(rv_list[c].m_texture_coordinate == texture_coordinate &&
+					   rv_list[c].m_normal == normal)
+					{
+						draw_vertex = rv_list[c].m_draw_vertex;
+						break;
+					}
+
+				if(draw_vertex == mv_draw_vertexes.size())
+				{
+					Combination combination;
+					combination.m_texture_coordinate = texture_coordinate;
+					combination.m_normal             = normal;
+					combination.m_draw_vertex        = draw_vertex;
+					rv_list.push_back(combination);
+
+					mv_draw_vertexes.push_back((unsigned int)(vertex));
+					if(normal != ObjModel::NO_NORMAL)
+						mv_draw_normals.push_back((unsigned int)(normal));
+					else
+						mv_draw_normals.push_back(NO_DRAW_NORMAL);
+					if(texture_coordinate != ObjModel::NO_TEXTURE_COORDINATES)
+					{
+						// flip texture coordinates to match Maya <|>
+						const Vector2& tc = base.getTextureCoordinate(texture_coordinate);
+						mv_draw_texture_coordinate_data.push_back((float)(tc.x));
+						mv_draw_texture_coordinate_data.push_back((float)(1.0 - tc.y));
+					}
+					else
+					{
+						mv_draw_texture_coordinate_data.push_back(0.0f);
+						mv_draw_texture_coordinate_data.push_back(0.0f);
+					}
+				}
+				v_face.push_back(draw_vertex);
+			}
+
+			// split into a triangle fan
+			for(unsigned int v = 2; v < face_vertex_count; v++)
+			{
+				r_mesh.mv_indexes.push_back(v_face[0]);
+				r_mesh.mv_indexes.push_back(v_face[v - 1]);
+				r_mesh.mv_indexes.push_back(v_face[v]);
+			}
+		}
+	}
+
+	mv_draw_position_data.resize(mv_draw_vertexes.size() * 3);
+	mv_draw_normal_data.resize(mv_draw_vertexes.size() * 3);
+	m_is_initialized = true;
+	fillDrawVertexes(0, (unsigned int)(mv_draw_vertexes.size()));
+
+	assert(isInitialized());
+}
+
+unsigned int MorphModel :: addTarget (const ObjModel& target)
+{
+	assert(isInitialized());
+	assert(target.isValid());
+#ifndef NDEBUG
+	vector<unsigned int> v_topology;
+	getTopology(target, v_topology);
+	assert(v_topology == mv_topology);
+#endif
+
+	unsigned int vertex_count = getVertexCount();
+	unsigned int normal_count = getNormalCount();
+
+	mv_targets.push_back(Target());
+	Target& r_target = mv_targets.back();
+	r_target.m_weight = 0.0f;
+
+	r_target.m_position_offsets.resize(vertex_count);
+	for(unsigned int v = 0; v < vertex_count; v++)
+		r_target.m_position_offsets.set(v, target.getVertexPosition(v));
+	r_target.m_position_offsets.subtract(m_base_positions);
+
+	r_target.m_normal_offsets.resize(normal_count);
+	for(unsigned int n = 0; n < normal_count; n++)
+		r_target.m_normal_offsets.set(n, target.getNormalVector(n));
+	r_target.m_normal_offsets.subtract(m_base_normals);
+
+	return (unsigned int)(mv_targets.size() - 1);
+}
+
+void MorphModel :: setWeight (unsigned int target, float weight)
+{
+	assert(isInitialized());
+	assert(target < getTargetCount());
+
+	mv_targets[target].m_weight = weight;
+}
+
+void MorphModel :: setThreadCount (unsigned int count)
+{
+	assert(count >= 1);
+
+	m_thread_count = count;
+}
+
+void MorphModel :: update ()
+{
+	assert(isInitialized());
+
+	JobSystem& r_jobs = JobSystem::getShared();
+	r_jobs.parallelFor(getVertexCount(), MIN_PER_THREAD, m_thread_count,
+	                   [this] (unsigned int begin, unsigned int end)
+	                   { blendPositions(begin, end); });
+	r_jobs.parallelFor(getNormalCount(), MIN_PER_THREAD, m_thread_count,
+	                   [this] (unsigned int begin, unsigned int end)
+	                   { blendNormals(begin, end); });
+	r_jobs.parallelFor((unsigned int)(mv_draw_vertexes.size()), MIN_PER_THREAD, m_thread_count,
+	                   [this] (unsigned int begin, unsigned int end)
+	                   { fillDrawVertexes(begin, end); });
+}
+
+
+
+void MorphModel :: getTopology (const ObjModel& model,
+                                vector<unsigned int>& rv_topology)
+{
+	assert(model.isValid());
+
+	rv_topology.clear();
+	rv_topology.push_back((unsigned int)(model.getVertexCount()));
+	rv_topology.push_back((unsigned int)(model.getNormalCount()));
+	rv_topology.push_back(model.getMeshCount());
+	for(unsigned int m = 0; m < model.getMeshCount(); m++)
+	{
+		rv_topology.push_back(model.getFaceCount(m));
+		for(unsigned int f = 0; f < model.getFaceCount(m); f++)
+		{
+			rv_topology.push_back(model.getFaceVertexCount(m, f));
+			for(unsigned int v = 0; v < model.getFaceVertexCount(m, f); v++)
+			{
+				rv_topology.push_back((unsigned int)(model.getFaceVertexIndex(m, f, v)));
+				rv_topology.push_back((unsigned int)(model.getFaceVertexNormal(m, f, v)));
+			}
+		}
+	}
+}
+
+void MorphModel :: drawMesh (unsigned int mesh) const
+{
+	assert(isInitialized());
+	assert(mesh < mv_meshes.size());
+
+	const Mesh& mesh_data = mv_meshes[mesh];
+	if(mesh_data.mv_indexes.empty())
+		return;
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(3, GL_FLOAT, 0, &(mv_draw_position_data[0]));
+	if(mesh_data.m_is_normals)
+	{
+		glEnableClientState(GL_NORMAL_ARRAY);
+		glNormalPointer(GL_FLOAT, 0, &(mv_draw_normal_data[0]));
+	}
+	if(mesh_data.m_is_texture_coordinates)
+	{
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(2, GL_FLOAT, 0, &(mv_draw_texture_coordinate_data[0]));
+	}
+
+	glDrawElements(GL_TRIANGLES, (GLsizei)(mesh_data.mv_indexes.size()),
+	               GL_UNSIGNED_INT, &(mesh_data.mv_indexes[0]));
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_NORMAL_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+}
+
+void MorphModel :: blendPositions (unsigned int begin, unsigned int end)
+{
+	assert(begin <= end);
+	assert(end <= getVertexCount());
+
+	const SimdKernels::Table<float>& table = SimdKernels::getTable<float>();
+	unsigned int count = end - begin;
+	float* a_x = m_positions.getArrayX() + begin;
+	float* a_y = m_positions.getArrayY() + begin;
+	float* a_z = m_positions.getArrayZ() + begin;
+
+	copy(m_base_positions.getArrayX() + begin, m_base_positions.getArrayX() + end, a_x);
+	copy(m_base_positions.getArrayY() + begin, m_base_positions.getArrayY() + end, a_y);
+	copy(m_base_positions.getArrayZ() + begin, m_base_positions.getArrayZ() + end, a_z);
+
+	for(unsigned int t = 0; t < mv_targets.size(); t++)
+	{
+		const Target& target = mv_targets[t];
+		if(target.m_weight == 0.0f)
+			continue;
+
+		table.multiplyAdd(count, a_x, target.m_position_offsets.getArrayX() + begin, target.m_weight, a_x);
+		table.multiplyAdd(count, a_y, target.m_position_offsets.getArrayY() + begin, target.m_weight, a_y);
+		table.multiplyAdd(count, a_z, target.m_position_offsets.getArrayZ() + begin, target.m_weight, a_z);
+	}
+}
+
+void MorphModel :: blendNormals (unsigned int begin, unsigned int end)
+{
+	assert(begin <= end);
+	assert(end <= getNormalCount());
+
+	const SimdKernels::Table<float>& table = SimdKernels::getTable<float>();
+	unsigned int count = end - begin;
+	float* a_x = m_normals.getArrayX() + begin;
+	float* a_y = m_normals.getArrayY() + begin;
+	float* a_z = m_normals.getArrayZ() + begin;
+
+	copy(m_base_normals.getArrayX() + begin, m_base_normals.getArrayX() + end, a_x);
+	copy(m_base_normals.getArrayY() + begin, m_base_normals.getArrayY() + end, a_y);
+	copy(m_base_normals.getArrayZ() + begin, m_base_normals.getArrayZ() + end, a_z);
+
+	bool is_changed = false;
+	for(unsigned int t = 0; t < mv_targets.size(); t++)
+	{
+		const Target& target = mv_targets[t];
+		if(target.m_weight == 0.0f)
+			continue;
+
+		table.multiplyAdd(count, a_x, target.m_normal_offsets.getArrayX() + begin, target.m_weight, a_x);
+		table.multiplyAdd(count, a_y, target.m_normal_offsets.getArrayY() + begin, target.m_weight, a_y);
+		table.multiplyAdd(count, a_z, target.m_normal_offsets.getArrayZ() + begin, target.m_weight, a_z);
+		is_changed = true;
+	}
+
+	if(is_changed)
+		table.normalize3(count, a_x, a_y, a_z, a_x, a_y, a_z);
+}
+
+void MorphModel :: fillDrawVertexes (unsigned int begin, unsigned int end)
+{
+	assert(begin <= end);
+	assert(end <= mv_draw_vertexes.size());
+
+	const float* a_position_x = m_positions.getArrayX();
+	const float* a_position_y = m_positions.getArrayY();
+	const float* a_position_z = m_positions.getArrayZ();
+	const float* a_normal_x = m_normals.getArrayX();
+	const float* a_normal_y = m_normals.getArrayY();
+	const float* a_normal_z = m_normals.getArrayZ();
+	float* a_position_data = getPointer(mv_draw_position_data);
+	float* a_normal_data   = getPointer(mv_draw_normal_data);
+
+	for(unsigned int i = begin; i < end; i++)
+	{
+		unsigned int vertex = mv_draw_vertexes[i];
+		a_position_data[i * 3 + 0] = a_position_x[vertex];
+		a_position_data[i * 3 + 1] = a_position_y[vertex];
+		a_position_data[i * 3 + 2] = a_position_z[vertex];
+
+		unsigned int normal = mv_draw_normals[i];
+		if(normal != NO_DRAW_NORMAL)
+		{
+			a_normal_data[i * 3 + 0] = a_normal_x[normal];
+			a_normal_data[i * 3 + 1] = a_normal_y[normal];
+			a_normal_data[i * 3 + 2] = a_normal_z[normal];
+		}
+		else
+		{
+			a_normal_data[i * 3 + 0] = 0.0f;
+			a_normal_data[i * 3 + 1] = 0.0f;
+			a_normal_data[i * 3 + 2] = 0.0f;
+		}
+	}
+}
@@ -0,0 +1,443 @@
+//
+//  MorphModel.h
+//
+//  A module to blend between several ObjModels with the same
+//    topology.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_MORPH_MODEL_H
+#define OBJ_LIBRARY_MORPH_MODEL_H
+
+#include <vector>
+
+#include "Vector3.h"
+#include "Vector3Array.h"
+
+
+
+namespace ObjLibrary
+{
+
+class Material;
+class ObjModel;
+
+
+
+//
+//  MorphModel
+//
+//  A class to animate a mesh by blending between several
+//    ObjModels that share a face topology (morph targets).
+//    The first ObjModel is the base.  The other ObjModels are
+//    the targets, each with a weight.  The blended shape is
+//
+//      base + sum(weight[i] * (target[i] - base))
+//
+//    for both vertex positions and normals.  The normals are
+//    renormalized after blending.  Targets with a weight of 0
+//    cost nothing to blend.
+//
+//  Blending is done by calling update.  It uses the kernels
+//    from SimdKernels.h and is split across the workers of the
+//    shared JobSystem for large models.
+//
+//  The blended faces are drawn with OpenGL vertex arrays.
+//    Unlike an ObjModel, nothing has to be recompiled into a
+//    DisplayList when the shape changes; the new positions are
+//    simply used the next time draw is called.  Point sets and
+//    polylines are not drawn.  Texture coordinates are taken
+//    from the base.  A face vertex without a normal in a mesh
+//    with normals uses the zero vector.
+//
+//  Two ObjModels have the same topology if they have the same
+//    number of vertexes and normals, the same meshes, and
+//    every face refers to the same vertexes and normals.  The
+//    materials and texture coordinates may differ.
+//
+class MorphModel
+{
+public:
+//
+//  isSameTopology
+//
+//  Purpose: To determine if two ObjModels can be blended.
+//  Parameter(s):
+//    <1> a
+//    <2> b: The ObjModels to compare
+//  Precondition(s):
+//    <1> a.isValid()
+//    <2> b.isValid()
+//  Returns: Whether a and b have the same topology, as
+//           described above.
+//  Side Effect: N/A
+//
+	static bool isSameTopology (const ObjModel& a,
+	                            const ObjModel& b);
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new MorphModel with no base.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new, uninitialized MorphModel is created.
+//
+	MorphModel ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a new MorphModel with the specified
+//           base.
+//  Parameter(s):
+//    <1> base: The ObjModel to use as the base
+//  Precondition(s):
+//    <1> base.isValid()
+//    <2> base.getVertexCount() <= UINT_MAX
+//    <3> base.getNormalCount() <= UINT_MAX
+//  Returns: N/A
+//  Side Effect: A new MorphModel is created with base base
+//               and no targets.  The blended shape is the same
+//               as base.
+//
+	MorphModel (const ObjModel& base);
+
+//
+//  isInitialized
+//
+//  Purpose: To determine if this MorphModel has a base.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this MorphModel has been initialized.
+//  Side Effect: N/A
+//
+	bool isInitialized () const
+	{ return m_is_initialized; }
+
+//
+//  getVertexCount
+//  getNormalCount
+//
+//  Purpose: To determine the number of vertexes or normals in
+//           the blended shape.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: The number of vertexes or normals in the base.
+//  Side Effect: N/A
+//
+	unsigned int getVertexCount () const;
+	unsigned int getNormalCount () const;
+
+//
+//  getTargetCount
+//
+//  Purpose: To determine the number of morph targets.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: The number of targets, not counting the base.
+//  Side Effect: N/A
+//
+	unsigned int getTargetCount () const;
+
+//
+//  getWeight
+//
+//  Purpose: To determine the weight of a morph target.
+//  Parameter(s):
+//    <1> target: Which target
+//  Precondition(s):
+//    <1> isInitialized()
+//    <2> target < getTargetCount()
+//  Returns: The weight of target target.
+//  Side Effect: N/A
+//
+	float getWeight (unsigned int target) const;
+
+//
+//  getThreadCount
+//
+//  Purpose: To determine the maximum number of threads used by
+//           update.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The maximum number of threads.
+//  Side Effect: N/A
+//
+	unsigned int getThreadCount () const
+	{ return m_thread_count; }
+
+//
+//  getPositions
+//  getNormals
+//
+//  Purpose: To retrieve the blended vertex positions or
+//           normals.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: The vertex positions or normals as of the last
+//           call to update.  They are in the same order as in
+//           the base.
+//  Side Effect: N/A
+//
+	const Vector3Array<float>& getPositions () const;
+	const Vector3Array<float>& getNormals () const;
+
+//
+//  draw
+//
+//  Purpose: To display the blended shape with the base
+//           materials.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//    <2> !Material::isMaterialActive()
+//  Returns: N/A
+//  Side Effect: The faces of the blended shape are displayed
+//               as of the last call to update.
+//
+	void draw () const;
+
+//
+//  drawMaterialNone
+//
+//  Purpose: To display the blended shape without changing the
+//           current material.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: The faces of the blended shape are displayed
+//               with the current OpenGL state.
+//
+	void drawMaterialNone () const;
+
+//
+//  init
+//
+//  Purpose: To set the base for this MorphModel.
+//  Parameter(s):
+//    <1> base: The ObjModel to use as the base
+//  Precondition(s):
+//    <1> base.isValid()
+//    <2> base.getVertexCount() <= UINT_MAX
+//    <3> base.getNormalCount() <= UINT_MAX
+//  Returns: N/A
+//  Side Effect: This MorphModel is set to have base base and no
+//               targets.  The blended shape is the same as
+//               base.  base is not referenced after this
+//               function returns.
+//
+	void init (const ObjModel& base);
+
+//
+//  addTarget
+//
+//  Purpose: To add a morph target.
+//  Parameter(s):
+//    <1> target: The ObjModel to blend towards
+//  Precondition(s):
+//    <1> isInitialized()
+//    <2> target.isValid()
+//    <3> target has the same topology as the base
+//  Returns: The index of the new target.
+//  Side Effect: target is added as a morph target with a weight
+//               of 0.0.  target is not referenced after this
+//               function returns.
+//
+	unsigned int addTarget (const ObjModel& target);
+
+//
+//  setWeight
+//
+//  Purpose: To change the weight of a morph target.
+//  Parameter(s):
+//    <1> target: Which target
+//    <2> weight: The new weight
+//  Precondition(s):
+//    <1> isInitialized()
+//    <2> target < getTargetCount()
+//  Returns: N/A
+//  Side Effect: Target target is set to have weight weight.
+//               The blended shape is not changed until update
+//               is called.
+//
+	void setWeight (unsigned int target, float weight);
+
+//
+//  setThreadCount
+//
+//  Purpose: To change the maximum number of threads used by
+//           update.
+//  Parameter(s):
+//    <1> count: The maximum number of threads
+//  Precondition(s):
+//    <1> count >= 1
+//  Returns: N/A
+//  Side Effect: update will use at most count threads,
+//               including the calling thread.  The default is
+//               the number of workers in the shared JobSystem
+//               plus 1.
+//
+	void setThreadCount (unsigned int count);
+
+//
+//  update
+//
+//  Purpose: To recalculate the blended shape.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: The blended vertex positions and normals are
+//               recalculated from the current weights.
+//
+	void update ();
+
+private:
+//
+//  Target
+//
+//  A record to store one morph target as offsets from the
+//    base.
+//
+	struct Target
+	{
+		Vector3Array<float> m_position_offsets;
+		Vector3Array<float> m_normal_offsets;
+		float m_weight;
+	};
+
+//
+//  Mesh
+//
+//  A record to store the faces from one mesh of the base as a
+//    list of triangles.  The indexes refer to the draw
+//    vertexes.
+//
+	struct Mesh
+	{
+		const Material* mp_material;
+		std::vector<unsigned int> mv_indexes;
+		bool m_is_normals;
+		bool m_is_texture_coordinates;
+	};
+
+//
+//  getTopology
+//
+//  Purpose: To create a list of values describing the topology
+//           of an ObjModel.
+//  Parameter(s):
+//    <1> model: The ObjModel
+//    <2> rv_topology: A vector to fill with the topology
+//  Precondition(s):
+//    <1> model.isValid()
+//  Returns: N/A
+//  Side Effect: rv_topology is set to contain the vertex and
+//               normal counts, followed by the vertex and
+//               normal indexes of every face.  Two ObjModels
+//               have the same topology if and only if their
+//               lists are equal.
+//
+	static void getTopology (const ObjModel& model,
+	                         std::vector<unsigned int>& rv_topology);
+
+//
+//  drawMesh
+//
+//  Purpose: To display the faces of one mesh.
+//  Parameter(s):
+//    <1> mesh: The mesh to display
+//  Precondition(s):
+//    <1> isInitialized()
+//    <2> mesh < mv_meshes.size()
+//  Returns: N/A
+//  Side Effect: The faces of mesh mesh are displayed with the
+//               current OpenGL state.
+//
+	void drawMesh (unsigned int mesh) const;
+
+//
+//  blendPositions
+//  blendNormals
+//
+//  Purpose: To calculate part of the blended shape.
+//  Parameter(s):
+//    <1> begin: The first vertex or normal to calculate
+//    <2> end: The vertex or normal after the last to
+//             calculate
+//  Precondition(s):
+//    <1> begin <= end
+//    <2> end <= getVertexCount() / end <= getNormalCount()
+//  Returns: N/A
+//  Side Effect: The blended vertex positions or normals from
+//               begin to end are calculated.  Each thread
+//               calls these functions for a different range.
+//
+	void blendPositions (unsigned int begin, unsigned int end);
+	void blendNormals (unsigned int begin, unsigned int end);
+
+//
+//  fillDrawVertexes
+//
+//  Purpose: To copy part of the blended shape to the arrays
+//           used for drawing.
+//  Parameter(s):
+//    <1> begin: The first draw vertex to fill
+//    <2> end: The draw vertex after the last to fill
+//  Precondition(s):
+//    <1> begin <= end
+//    <2> end <= mv_draw_vertexes.size()
+//  Returns: N/A
+//  Side Effect: The positions and normals for draw vertexes
+//               begin to end are copied from the blended
+//               shape.
+//
+	void fillDrawVertexes (unsigned int begin, unsigned int end);
+
+private:
+	bool m_is_initialized;
+	unsigned int m_thread_count;
+	std::vector<unsigned int> mv_topology;
+
+	Vector3Array<float> m_base_positions;
+	Vector3Array<float> m_base_normals;
+	std::vector<Target> mv_targets;
+	Vector3Array<float> m_positions;
+	Vector3Array<float> m_normals;
+
+	// vertexes as sent to OpenGL, one for each unique
+	//   vertex/texture coordinate/normal combination
+	std::vector<unsigned int> mv_draw_vertexes;
+	std::vector<unsigned int> mv_draw_normals;
+	std::vector<float> mv_draw_position_data;
+	std::vector<float> mv_draw_normal_data;
+	std::vector<float> mv_draw_texture_coordinate_data;
+	std::vector<Mesh> mv_meshes;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -24,10 +24,16 @@
 #include <fstream>
 #include <cctype>
 #include <cstdlib>
+#include <cmath>	// for isfinite
+#include <cstring>	// for memchr, memcpy
 #include <vector>
+#include <unordered_set>
+#include <utility>	// for move
 
 #include "ObjSettings.h"
 #include "ObjStringParsing.h"
+#include "AssetFileSystem.h"
+#include "Vector3.h"
 #include "Material.h"
 #include "MtlLibrary.h"
 
@@ -59,6 +65,537 @@ namespace
 	const unsigned int CHANNEL_TARGET_DISPLACEMENT      = 3;
 	const unsigned int CHANNEL_TARGET_BUMP              = 4;
 
+	//
+	//  PACK_MAGIC
+	//  PACK_VERSION
+	//
+	//  The first values in every material pack file.  The
+	//    version must be changed whenever the layout changes.
+	//
+	const char PACK_MAGIC[4] = { 'O', 'L', 'M', 'P' };
+	const unsigned int PACK_VERSION = 2;
+
+	//
+	//  FNV_OFFSET_BASIS
+	//  FNV_PRIME
+	//
+	//  The constants for the 64-bit FNV-1a hash function.
+	//
+	const unsigned long long FNV_OFFSET_BASIS = 14695981039346656037ull;
+	const unsigned long long FNV_PRIME        = 1099511628211ull;
+
+	//
+	//  PackHeader
+	//
+	//  A record to store the values at the start of a material
+	//    pack file.
+	//
+	struct PackHeader
+	{
+		string m_file_name_with_path;
+		long long m_source_modified;
+		long long m_source_size;
+		unsigned long long m_source_hash;
+		unsigned int m_material_count;
+	};
+
+	//
+	//  getContentHash
+	//
+	//  Purpose: To calculate a hash of the contents of a file.
+	//  Parameter(s):
+	//    <1> contents: The contents of the file
+	//  Precondition(s): N/A
+	//  Returns: The 64-bit FNV-1a hash of contents.
+	//  Side Effect: N/A
+	//
+	unsigned long long getContentHash (const string& contents)
+	{
+		unsigned long long hash = FNV_OFFSET_BASIS;
+		for(size_t i = 0; i < contents.size(); i++)
+		{
+			hash ^= (unsigned char)(contents[i]);
+			hash *= FNV_PRIME;
+		}
+		return hash;
+	}
+
+	//
+	//  appendPackValue
+	//  appendPackString
+	//
+	//  Purpose: To append a value to a material pack.
+	//  Parameter(s):
+	//    <1> r_pack: The material pack being built
+	//    <2> value: The value to append
+	//    <2> str: The string to append
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The bytes of value are appended to r_pack.
+	//               A string is stored as its length followed
+	//               by its characters.
+	//
+	template <typename T>
+	void appendPackValue (string& r_pack, const T& value)
+	{
+		r_pack.append((const char*)(&value), sizeof(T));
+	}
+	void appendPackString (string& r_pack, const string& str)
+	{
+		appendPackValue(r_pack, (unsigned int)(str.size()));
+		r_pack += str;
+	}
+
+	//
+	//  readPackValue
+	//  readPackString
+	//
+	//  Purpose: To read a value from a material pack.
+	//  Parameter(s):
+	//    <1> rp_current: A pointer to the next unread byte
+	//    <2> p_end: A pointer to just past the end of the pack
+	//    <3> r_value: The value to read into
+	//    <3> r_str: The string to read into
+	//  Precondition(s):
+	//    <1> rp_current <= p_end
+	//  Returns: Whether there were enough bytes left.
+	//  Side Effect: If there are enough bytes left, the value
+	//               is read into r_value or r_str and
+	//               rp_current is advanced past it.  Otherwise,
+	//               there is no effect.
+	//
+	template <typename T>
+	bool readPackValue  (const char*& rp_current,
+	                    const char* p_end,
+	                    T& r_value)
+	{
+		assert(rp_current <= p_end);
+
+		if((size_t)(p_end - rp_current) < sizeof(T))
+			return false;
+		memcpy(&r_value, rp_current, sizeof(T));
+		rp_current += sizeof(T);
+		return true;
+	}
+	bool readPackString (const char*& rp_current,
+	                     const char* p_end,
+	                     string& r_str)
+	{
+		assert(rp_current <= p_end);
+
+		const char* p_start = rp_current;
+		unsigned int length;
+		if(!readPackValue(rp_current, p_end, length) ||
+		   (size_t)(p_end - rp_current) < length)
+		{
+			rp_current = p_start;
+			return false;
+		}
+		r_str.assign(rp_current, length);
+		rp_current += length;
+		return true;
+	}
+
+	//
+	//  appendPackVector3
+	//  appendPackMap
+	//
+	//  Purpose: To append a Vector3, or the filename and channel
+	//           for a texture map, to a material pack.
+	//  Parameter(s):
+	//    <1> r_pack: The material pack being built
+	//    <2> vector: The Vector3 to append
+	//    <2> filename: The texture map filename, or "" if there
+	//                  is no texture map
+	//    <3> channel: The texture map channel
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The values are appended to r_pack.
+	//
+	void appendPackVector3 (string& r_pack, const Vector3& vector)
+	{
+		appendPackValue(r_pack, vector.x);
+		appendPackValue(r_pack, vector.y);
+		appendPackValue(r_pack, vector.z);
+	}
+	void appendPackMap (string& r_pack,
+	                    const string& filename,
+	                    char channel)
+	{
+		appendPackString(r_pack, filename);
+		appendPackValue(r_pack, channel);
+	}
+
+	//
+	//  readPackVector3
+	//  readPackMap
+	//
+	//  Purpose: To read a Vector3, or the filename and channel
+	//           for a texture map, from a material pack.
+	//  Parameter(s):
+	//    <1> rp_current: A pointer to the next unread byte
+	//    <2> p_end: A pointer to just past the end of the pack
+	//    <3> r_vector: The Vector3 to read into
+	//    <3> r_filename: The filename to read into
+	//    <4> r_channel: The channel to read into
+	//  Precondition(s):
+	//    <1> rp_current <= p_end
+	//  Returns: Whether the values could be read.  For a
+	//           texture map, this also requires the channel to
+	//           be valid.
+	//  Side Effect: The values are read and rp_current is
+	//               advanced past them.
+	//
+	bool readPackVector3 (const char*& rp_current,
+	                      const char* p_end,
+	                      Vector3& r_vector)
+	{
+		assert(rp_current <= p_end);
+
+		return readPackValue(rp_current, p_end, r_vector.x) &&
+		       readPackValue(rp_current, p_end, r_vector.y) &&
+		       readPackValue(rp_current, p_end, r_vector.z);
+	}
+	bool readPackMap (const char*& rp_current,
+	                  const char* p_end,
+	                  string& r_filename,
+	                  char& r_channel)
+	{
+		assert(rp_current <= p_end);
+
+		if(!readPackString(rp_current, p_end, r_filename))
+			return false;
+		if(!readPackValue(rp_current, p_end, r_channel))
+			return false;
+		return Material::isValidChannel(r_channel);
+	}
+
+	//
+	//  appendPackMaterial
+	//
+	//  Purpose: To append a Material to a material pack.
+	//  Parameter(s):
+	//    <1> r_pack: The material pack being built
+	//    <2> material: The Material to append
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: Everything that MtlLibrary::load can set
+	//               for material is appended to r_pack.
+	//               Textures that have been loaded are not
+	//               stored.
+	//
+	void appendPackMaterial (string& r_pack, const Material& material)
+	{
+		const string NONE;
+
+		appendPackString(r_pack, material.getName());
+		appendPackString(r_pack, material.getTexturePath());
+		appendPackValue(r_pack, material.getIlluminationMode());
+
+		appendPackVector3(r_pack, material.getEmission());
+		appendPackString(r_pack, material.isEmissionMap() ? material.getEmissionMapFilename() : NONE);
+		appendPackVector3(r_pack, material.getAmbient());
+		appendPackString(r_pack, material.isAmbientMap() ? material.getAmbientMapFilename() : NONE);
+		appendPackVector3(r_pack, material.getDiffuse());
+		appendPackString(r_pack, material.isDiffuseMap() ? material.getDiffuseMapFilename() : NONE);
+		appendPackVector3(r_pack, material.getSpecular());
+		appendPackString(r_pack, material.isSpecularMap() ? material.getSpecularMapFilename() : NONE);
+
+		appendPackValue(r_pack, material.getSpecularExponent());
+		if(material.isSpecularExponentMap())
+			appendPackMap(r_pack, material.getSpecularExponentMapFilename(), material.getSpecularExponentMapChannel());
+		else
+			appendPackMap(r_pack, NONE, Material::CHANNEL_UNSPECIFIED);
+
+		appendPackValue(r_pack, material.getTransparency());
+		if(material.isTransparencyMap())
+			appendPackMap(r_pack, material.getTransparencyMapFilename(), material.getTransparencyMapChannel());
+		else
+			appendPackMap(r_pack, NONE, Material::CHANNEL_UNSPECIFIED);
+
+		appendPackValue(r_pack, material.getOpticalDensity());
+		appendPackVector3(r_pack, material.getTransmissionFilter());
+
+		if(material.isDecalMap())
+			appendPackMap(r_pack, material.getDecalMapFilename(), material.getDecalMapChannel());
+		else
+			appendPackMap(r_pack, NONE, Material::CHANNEL_UNSPECIFIED);
+		if(material.isDisplacementMap())
+			appendPackMap(r_pack, material.getDisplacementMapFilename(), material.getDisplacementMapChannel());
+		else
+			appendPackMap(r_pack, NONE, Material::CHANNEL_UNSPECIFIED);
+		if(material.isBumpMap())
+		{
+			appendPackMap(r_pack, material.getBumpMapFilename(), material.getBumpMapChannel());
+			appendPackValue(r_pack, material.getBumpMapMultiplier());
+		}
+		else
+		{
+			appendPackMap(r_pack, NONE, Material::CHANNEL_UNSPECIFIED);
+			appendPackValue(r_pack, 1.0);
+		}
+	}
+
+	//
+	//  isPackNumber
+	//  isPackFraction
+	//  isPackColour
+	//
+	//  Purpose: To determine if a value read from a material
+	//           pack is in range.
+	//  Parameter(s):
+	//    <1> value: The value
+	//    <1> colour: The colour
+	//  Precondition(s): N/A
+	//  Returns: Whether value is finite, whether value is in
+	//           [0, 1], or whether each component of colour is
+	//           in [0, 1].  NaN is never in range.
+	//  Side Effect: N/A
+	//
+	bool isPackNumber (double value)
+	{
+		return std::isfinite(value);
+	}
+	bool isPackFraction (double value)
+	{
+		return value >= 0.0 && value <= 1.0;
+	}
+	bool isPackColour (const Vector3& colour)
+	{
+		return isPackFraction(colour.x) &&
+		       isPackFraction(colour.y) &&
+		       isPackFraction(colour.z);
+	}
+
+	//
+	//  readPackMaterial
+	//
+	//  Purpose: To read a Material from a material pack.
+	//  Parameter(s):
+	//    <1> rp_current: A pointer to the next unread byte
+	//    <2> p_end: A pointer to just past the end of the pack
+	//  Precondition(s):
+	//    <1> rp_current <= p_end
+	//  Returns: A pointer to a new Material with the values
+	//           read, or NULL if the pack is invalid.  Every
+	//           value is checked before it is used, so a
+	//           corrupt pack cannot produce a Material with
+	//           colours outside [0, 1], a negative or infinite
+	//           specular exponent, or a transparency outside
+	//           [0, 1].
+	//  Side Effect: rp_current is advanced past the Material.
+	//               The new Material is dynamically allocated
+	//               and must be deleted by the caller.
+	//
+	Material* readPackMaterial (const char*& rp_current,
+	                            const char* p_end)
+	{
+		assert(rp_current <= p_end);
+
+		string name;
+		string texture_path;
+		unsigned int illumination_mode;
+		Vector3 emission;
+		Vector3 ambient;
+		Vector3 diffuse;
+		Vector3 specular;
+		string emission_filename;
+		string ambient_filename;
+		string diffuse_filename;
+		string specular_filename;
+		double specular_exponent;
+		string specular_exponent_filename;
+		char specular_exponent_channel;
+		double transparency;
+		string transparency_filename;
+		char transparency_channel;
+		double optical_density;
+		Vector3 transmission_filter;
+		string decal_filename;
+		char decal_channel;
+		string displacement_filename;
+		char displacement_channel;
+		string bump_filename;
+		char bump_channel;
+		double bump_multiplier;
+
+		if(!readPackString (rp_current, p_end, name) ||
+		   !readPackString (rp_current, p_end, texture_path) ||
+		   !readPackValue  (rp_current, p_end, illumination_mode) ||
+		   !readPackVector3(rp_current, p_end, emission) ||
+		   !readPackString (rp_current, p_end, emission_filename) ||
+		   !readPackVector3(rp_current, p_end, ambient) ||
+		   !readPackString (rp_current, p_end, ambient_filename) ||
+		   !readPackVector3(rp_current, p_end, diffuse) ||
+		   !readPackString (rp_current, p_end, diffuse_filename) ||
+		   !readPackVector3(rp_current, p_end, specular) ||
+		   !readPackString (rp_current, p_end, specular_filename) ||
+		   !readPackValue  (rp_current, p_end, specular_exponent) ||
+		   !readPackMap    (rp_current, p_end, specular_exponent_filename, specular_exponent_channel) ||
+		   !readPackValue  (rp_current, p_end, transparency) ||
+		   !readPackMap    (rp_current, p_end, transparency_filename, transparency_channel) ||
+		   !readPackValue  (rp_current, p_end, optical_density) ||
+		   !readPackVector3(rp_current, p_end, transmission_filter) ||
+		   !readPackMap    (rp_current, p_end, decal_filename, decal_channel) ||
+		   !readPackMap    (rp_current, p_end, displacement_filename, displacement_channel) ||
+		   !readPackMap    (rp_current, p_end, bump_filename, bump_channel) ||
+		   !readPackValue  (rp_current, p_end, bump_multiplier))
+		{
+			return NULL;
+		}
+
+		if(name == "" ||
+		   !ObjStringParsing::isValidPath(texture_path) ||
+		   !Material::isValidIlluminationMode(illumination_mode))
+		{
+			return NULL;
+		}
+
+		// a library with values out of range is parsed again
+		if(!isPackColour(emission) ||
+		   !isPackColour(ambient) ||
+		   !isPackColour(diffuse) ||
+		   !isPackColour(specular) ||
+		   !isPackNumber(specular_exponent) || specular_exponent < 0.0 ||
+		   !isPackFraction(transparency) ||
+		   !isPackNumber(optical_density) ||
+		   !isPackColour(transmission_filter) ||
+		   !isPackNumber(bump_multiplier))
+		{
+			return NULL;
+		}
+
+		Material* p_material = new Material(name, texture_path);
+		p_material->setIlluminationMode(illumination_mode);
+		p_material->setEmissionColour(emission);
+		if(emission_filename != "")
+			p_material->setEmissionMap(emission_filename);
+		p_material->setAmbientColour(ambient);
+		if(ambient_filename != "")
+			p_material->setAmbientMap(ambient_filename);
+		p_material->setDiffuseColour(diffuse);
+		if(diffuse_filename != "")
+			p_material->setDiffuseMap(diffuse_filename);
+		p_material->setSpecularColour(specular);
+		if(specular_filename != "")
+			p_material->setSpecularMap(specular_filename);
+		p_material->setSpecularExponent(specular_exponent);
+		if(specular_exponent_filename != "")
+			p_material->setSpecularExponentMap(specular_exponent_filename, specular_exponent_channel);
+		p_material->setTransparency(transparency);
+		if(transparency_filename != "")
+			p_material->setTransparencyMap(transparency_filename, transparency_channel);
+		p_material->setOpticalDensity(optical_density);
+		p_material->setTransmissionFilter(transmission_filter);
+		if(decal_filename != "")
+			p_material->setDecalMap(decal_filename, decal_channel);
+		if(displacement_filename != "")
+			p_material->setDisplacementMap(displacement_filename, displacement_channel);
+		if(bump_filename != "")
+			p_material->setBumpMap(bump_filename, bump_channel, bump_multiplier);
+		return p_material;
+	}
+
+	//
+	//  readPackHeader
+	//
+	//  Purpose: To read the header of a material pack.
+	//  Parameter(s):
+	//    <1> rp_current: A pointer to the start of the pack
+	//    <2> p_end: A pointer to just past the end of the pack
+	//    <3> r_header: The header to read into
+	//  Precondition(s):
+	//    <1> rp_current <= p_end
+	//  Returns: Whether the pack starts with a valid header for
+	//           this version.
+	//  Side Effect: r_header is set and rp_current is advanced
+	//               past the header.
+	//
+	bool readPackHeader (const char*& rp_current,
+	                     const char* p_end,
+	                     PackHeader& r_header)
+	{
+		assert(rp_current <= p_end);
+
+		char a_magic[sizeof(PACK_MAGIC)];
+		unsigned int version;
+		if(!readPackValue(rp_current, p_end, a_magic) ||
+		   memcmp(a_magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0)
+		{
+			return false;
+		}
+		if(!readPackValue(rp_current, p_end, version) ||
+		   version != PACK_VERSION)
+		{
+			return false;
+		}
+
+		return readPackString(rp_current, p_end, r_header.m_file_name_with_path) &&
+		       r_header.m_file_name_with_path != "" &&
+		       readPackValue(rp_current, p_end, r_header.m_source_modified) &&
+		       readPackValue(rp_current, p_end, r_header.m_source_size) &&
+		       readPackValue(rp_current, p_end, r_header.m_source_hash) &&
+		       readPackValue(rp_current, p_end, r_header.m_material_count);
+	}
+
+	//
+	//  readPackMaterials
+	//
+	//  Purpose: To read all the Materials from a material pack.
+	//  Parameter(s):
+	//    <1> rp_current: A pointer to the first Material
+	//    <2> p_end: A pointer to just past the end of the pack
+	//    <3> count: The number of Materials in the pack
+	//    <4> rvp_materials: The vector to read into
+	//  Precondition(s):
+	//    <1> rp_current <= p_end
+	//    <2> rvp_materials.empty()
+	//  Returns: Whether all the Materials could be read and
+	//           the pack ends after the last one.
+	//  Side Effect: If all the Materials could be read, they
+	//               are added to rvp_materials.  Otherwise,
+	//               rvp_materials is left empty.
+	//
+	bool readPackMaterials (const char*& rp_current,
+	                        const char* p_end,
+	                        unsigned int count,
+	                        vector<Material*>& rvp_materials)
+	{
+		assert(rp_current <= p_end);
+		assert(rvp_materials.empty());
+
+		unordered_set<string> names;
+		bool is_valid = true;
+		// every Material starts with the length of its name, so
+		//  a count that cannot fit in the pack is rejected
+		//  before anything is allocated
+		if(count > (size_t)(p_end - rp_current) / sizeof(unsigned int))
+			return false;
+		rvp_materials.reserve(count);
+		for(unsigned int i = 0; i < count && is_valid; i++)
+		{
+			Material* p_material = readPackMaterial(rp_current, p_end);
+			if(p_material == NULL)
+				is_valid = false;
+			else
+			{
+				rvp_materials.push_back(p_material);
+				if(!names.insert(p_material->getName()).second)
+					is_valid = false;
+			}
+		}
+		if(rp_current != p_end)
+			is_valid = false;
+
+		if(!is_valid)
+		{
+			for(unsigned int i = 0; i < rvp_materials.size(); i++)
+				delete rvp_materials[i];
+			rvp_materials.clear();
+		}
+		return is_valid;
+	}
+
 }  // end of anonymous namespace
 
 
@@ -163,6 +700,20 @@ MtlLibrary :: MtlLibrary (const MtlLibrary& original)
 	assert(invariant());
 }
 
+MtlLibrary :: MtlLibrary (MtlLibrary&& original) noexcept
+		: m_file_name          (move(original.m_file_name)),
+		  m_file_name_lowercase(move(original.m_file_name_lowercase)),
+		  m_file_path          (move(original.m_file_path)),
+		  m_file_path_lowercase(move(original.m_file_path_lowercase)),
+		  m_is_loaded_successfully(original.m_is_loaded_successfully),
+		  mvp_materials (move(original.mvp_materials))
+{
+	// original has no Materials left to delete
+	original.makeEmpty();
+
+	assert(invariant());
+}
+
 MtlLibrary& MtlLibrary :: operator= (const MtlLibrary& original)
 {
 	if(&original != this)
@@ -182,6 +733,26 @@ MtlLibrary& MtlLibrary :: operator= (const MtlLibrary& original)
 	return *this;
 }
 
+MtlLibrary& MtlLibrary :: operator= (MtlLibrary&& original) noexcept
+{
+	if(&original != this)
+	{
+		removeAll();
+
+		m_file_name           = move(original.m_file_name);
+		m_file_name_lowercase = move(original.m_file_name_lowercase);
+		m_file_path           = move(original.m_file_path);
+		m_file_path_lowercase = move(original.m_file_path_lowercase);
+		m_is_loaded_successfully = original.m_is_loaded_successfully;
+		mvp_materials.swap(original.mvp_materials);
+
+		original.makeEmpty();
+	}
+
+	assert(invariant());
+	return *this;
+}
+
 MtlLibrary :: ~MtlLibrary ()
 {
 	removeAll();
@@ -476,7 +1047,9 @@ void MtlLibrary :: load (const string& filename, ostream& r_logstream)
 	assert(filename.find_last_of("/\\") == string::npos ||
 	       filename.find_last_of("/\\") + 1 < filename.size());
 
-	ifstream input_file;
+	string contents;
+	const char* p_contents;
+	size_t contents_size;
 	unsigned int line_count;
 
 	removeAll();
@@ -484,15 +1057,19 @@ void MtlLibrary :: load (const string& filename, ostream& r_logstream)
 	m_is_loaded_successfully = true;
 	setFileNameWithPath(filename);
 
-	input_file.open(filename.c_str());
-	if(!input_file.is_open())
+	// files in a mounted archive are tokenized where they are mapped
+	if(!AssetFileSystem::getArchivedFile(filename, p_contents, contents_size))
 	{
-		r_logstream << "Error: File \"" << filename << "\" does not exist" << endl;
-		input_file.close();
-		m_is_loaded_successfully = false;
+		if(!AssetFileSystem::readFile(filename, contents))
+		{
+			r_logstream << "Error: File \"" << filename << "\" does not exist" << endl;
+			m_is_loaded_successfully = false;
 
-		assert(invariant());
-		return;
+			assert(invariant());
+			return;
+		}
+		p_contents = contents.data();
+		contents_size = contents.size();
 	}
 
 	//
@@ -500,90 +1077,227 @@ void MtlLibrary :: load (const string& filename, ostream& r_logstream)
 	//
 	//  http://paulbourke.net/dataformats/mtl/
 	//
+	//  The whole file is read at once and each line is split
+	//    into tokens in place.  Nothing is copied unless it is
+	//    stored in a Material or the line is invalid.
+	//
+
+	unordered_set<string> names;
+	const char* p_next = p_contents;
+	const char* p_file_end = p_next + contents_size;
 
 	line_count = 0;
-	while(true)	// drops out at EOF below
+	while(p_next < p_file_end)
 	{
-		string line;
-		size_t length;
+		const char* p_line = p_next;
+		const char* p_line_end = (const char*)(memchr(p_line, '\n', p_file_end - p_line));
+		if(p_line_end == NULL)
+		{
+			p_line_end = p_file_end;
+			p_next = p_file_end;
+		}
+		else
+			p_next = p_line_end + 1;
+		line_count++;
+
+		const char* p_keyword = skipWhitespace(p_line, p_line_end);
+		if(p_keyword == p_line_end || *p_keyword == '#')
+			continue;	// skip blank lines and comments
+		const char* p_keyword_end = skipToken(p_keyword, p_line_end);
+
 		bool valid;
+		if(isTokenEqual(p_keyword, p_keyword_end, "newmtl"))
+			valid = readMaterialStart(p_keyword_end, p_line_end, names, r_logstream);
+		else if(mvp_materials.empty())
+			valid = false;	// everything else needs a material
+		else if(isTokenEqual(p_keyword, p_keyword_end, "illum"))
+			valid = readIlluminationMode(p_keyword_end, p_line_end, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "Ke"))
+			valid = readColour(p_keyword_end, p_line_end, COLOUR_TARGET_EMISSION, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "Ka"))
+			valid = readColour(p_keyword_end, p_line_end, COLOUR_TARGET_AMBIENT, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "Kd"))
+			valid = readColour(p_keyword_end, p_line_end, COLOUR_TARGET_DIFFUSE, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "Ks"))
+			valid = readColour(p_keyword_end, p_line_end, COLOUR_TARGET_SPECULAR, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "Ns"))
+			valid = readSpecularExponent(p_keyword_end, p_line_end, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "d"))
+			valid = readTransparency(p_keyword_end, p_line_end, r_logstream, false);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "Tr"))
+			valid = readTransparency(p_keyword_end, p_line_end, r_logstream, true);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "Ni"))
+			valid = readOpticalDensity(p_keyword_end, p_line_end, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "Tf"))
+			valid = readTransmissionFilter(p_keyword_end, p_line_end, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "map_Ke"))
+			valid = readMapColour(p_keyword_end, p_line_end, names, COLOUR_TARGET_EMISSION, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "map_Ka"))
+			valid = readMapColour(p_keyword_end, p_line_end, names, COLOUR_TARGET_AMBIENT, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "map_Kd"))
+			valid = readMapColour(p_keyword_end, p_line_end, names, COLOUR_TARGET_DIFFUSE, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "map_Ks"))
+			valid = readMapColour(p_keyword_end, p_line_end, names, COLOUR_TARGET_SPECULAR, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "map_Ns"))
+			valid = readMapChannel(p_keyword_end, p_line_end, names, CHANNEL_TARGET_SPECULAR_EXPONENT, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "map_d"))
+			valid = readMapChannel(p_keyword_end, p_line_end, names, CHANNEL_TARGET_TRANSPARENCY, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "map_Tr"))
+			valid = readMapChannel(p_keyword_end, p_line_end, names, CHANNEL_TARGET_TRANSPARENCY, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "decal"))
+			valid = readMapChannel(p_keyword_end, p_line_end, names, CHANNEL_TARGET_DECAL, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "disp"))
+			valid = readMapChannel(p_keyword_end, p_line_end, names, CHANNEL_TARGET_DISPLACEMENT, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "bump"))
+			valid = readMapChannel(p_keyword_end, p_line_end, names, CHANNEL_TARGET_BUMP, r_logstream);
+		else if(isTokenEqual(p_keyword, p_keyword_end, "Km"))	// non-standard - is this what it does?
+			valid = readBumpMapMultiplier(p_keyword_end, p_line_end, r_logstream);
+		else
+			valid = false;
 
-		getline(input_file, line);
-		if(input_file.eof())
-			break;	// drop out after last line
+		if(!valid)
+		{
+			const char* p_print_end = p_line_end;
+			while(p_print_end > p_keyword && isspace((unsigned char)(p_print_end[-1])))
+				p_print_end--;
+			r_logstream << "Line " << setw(6) << line_count << " of file \"" << filename << "\" is invalid: \"" << string(p_keyword, p_print_end) << "\"" << endl;
+		}
+	}
 
-		length = line.length();
-		line_count++;
+	warnIfLastMaterialIsInvisible(r_logstream);
 
-		if(length < 1 || line[0] == '#' || line[0] == '\r')
-			continue;	// skip blank lines and comments
+	assert(invariant());
+}
 
-		if(isspace(line[0]))
-			line = line.substr(nextToken(line, 0));
+void MtlLibrary :: loadCached (const string& filename,
+                               const string& pack_filename)
+{
+	assert(filename != "");
+	assert(filename.find_last_of("/\\") == string::npos ||
+	       filename.find_last_of("/\\") + 1 < filename.size());
+	assert(pack_filename != "");
 
-		valid = true;
-		if(length < 3)
-			valid = false;
-		else
+	loadCached(filename, pack_filename, cerr);
+
+	assert(invariant());
+}
+
+void MtlLibrary :: loadCached (const string& filename,
+                               const string& pack_filename,
+                               ostream& r_logstream)
+{
+	assert(filename != "");
+	assert(filename.find_last_of("/\\") == string::npos ||
+	       filename.find_last_of("/\\") + 1 < filename.size());
+	assert(pack_filename != "");
+
+	// the modification time is only to the second, so the
+	//  contents are compared too, but only once the cheap
+	//  checks have passed
+	long long source_modified;
+	long long source_size;
+	string contents;
+	if(AssetFileSystem::getFileStatus(filename, source_modified, source_size) &&
+	   AssetFileSystem::readFile(pack_filename, contents))
+	{
+		const char* p_current = contents.data();
+		const char* p_end = p_current + contents.size();
+		PackHeader header;
+		string source;
+		vector<Material*> vp_materials;
+		if(readPackHeader(p_current, p_end, header) &&
+		   header.m_file_name_with_path == filename &&
+		   header.m_source_modified == source_modified &&
+		   header.m_source_size == source_size &&
+		   AssetFileSystem::readFile(filename, source) &&
+		   header.m_source_hash == getContentHash(source) &&
+		   readPackMaterials(p_current, p_end, header.m_material_count, vp_materials))
 		{
-			line = whitespaceToSpaces(line);
-
-			if(startsWith(line, "newmtl "))
-				valid = readMaterialStart(line.substr(7), r_logstream);
-			else if(startsWith(line, "illum "))
-				valid = readIlluminationMode(line.substr(6), r_logstream);
-			else if(startsWith(line, "Ke "))
-				valid = readColour(line.substr(3), COLOUR_TARGET_EMISSION, r_logstream);
-			else if(startsWith(line, "Ka "))
-				valid = readColour(line.substr(3), COLOUR_TARGET_AMBIENT, r_logstream);
-			else if(startsWith(line, "Kd "))
-				valid = readColour(line.substr(3), COLOUR_TARGET_DIFFUSE, r_logstream);
-			else if(startsWith(line, "Ks "))
-				valid = readColour(line.substr(3), COLOUR_TARGET_SPECULAR, r_logstream);
-			else if(startsWith(line, "Ns "))
-				valid = readSpecularExponent(line.substr(3), r_logstream);
-			else if(startsWith(line, "d "))
-				valid = readTransparency(line.substr(2), r_logstream, false);
-			else if(startsWith(line, "Tr "))
-				valid = readTransparency(line.substr(3), r_logstream, true);
-			else if(startsWith(line, "Ni "))
-				valid = readOpticalDensity(line.substr(3), r_logstream);
-			else if(startsWith(line, "Tf "))
-				valid = readTransmissionFilter(line.substr(3), r_logstream);
-			else if(startsWith(line, "map_Ke "))
-				valid = readMapColour(line.substr(7), COLOUR_TARGET_EMISSION, r_logstream);
-			else if(startsWith(line, "map_Ka "))
-				valid = readMapColour(line.substr(7), COLOUR_TARGET_AMBIENT, r_logstream);
-			else if(startsWith(line, "map_Kd "))
-				valid = readMapColour(line.substr(7), COLOUR_TARGET_DIFFUSE, r_logstream);
-			else if(startsWith(line, "map_Ks "))
-				valid = readMapColour(line.substr(7), COLOUR_TARGET_SPECULAR, r_logstream);
-			else if(startsWith(line, "map_Ns "))
-				valid = readMapChannel(line.substr(7), CHANNEL_TARGET_SPECULAR_EXPONENT, r_logstream);
-			else if(startsWith(line, "map_d "))
-				valid = readMapChannel(line.substr(6), CHANNEL_TARGET_TRANSPARENCY, r_logstream);
-			else if(startsWith(line, "map_Tr "))
-				valid = readMapChannel(line.substr(7), CHANNEL_TARGET_TRANSPARENCY, r_logstream);
-			else if(startsWith(line, "decal "))
-				valid = readMapChannel(line.substr(6), CHANNEL_TARGET_DECAL, r_logstream);
-			else if(startsWith(line, "disp "))
-				valid = readMapChannel(line.substr(5), CHANNEL_TARGET_DISPLACEMENT, r_logstream);
-			else if(startsWith(line, "bump "))
-				valid = readMapChannel(line.substr(5), CHANNEL_TARGET_BUMP, r_logstream);
-			else if(startsWith(line, "Km "))	// non-standard - is this what it does?
-				valid = readBumpMapMultiplier(line.substr(3), r_logstream);
-			else
-				valid = false;
+			removeAll();
+			m_is_loaded_successfully = true;
+			setFileNameWithPath(filename);
+			mvp_materials.swap(vp_materials);
+
+			assert(invariant());
+			return;
 		}
+	}
 
-		if(!valid)
-			r_logstream << "Line " << setw(6) << line_count << " of file \"" << filename << "\" is invalid: \"" << line << "\"" << endl;
+	// the pack is missing or out of date
+	load(filename, r_logstream);
+	if(m_is_loaded_successfully && !savePack(pack_filename))
+		r_logstream << "Error: cannot write to file \"" << pack_filename << "\"" << endl;
+
+	assert(invariant());
+}
+
+bool MtlLibrary :: loadPack (const string& pack_filename)
+{
+	assert(pack_filename != "");
+
+	string contents;
+	if(!AssetFileSystem::readFile(pack_filename, contents))
+		return false;
+
+	const char* p_current = contents.data();
+	const char* p_end = p_current + contents.size();
+	PackHeader header;
+	vector<Material*> vp_materials;
+	if(!readPackHeader(p_current, p_end, header) ||
+	   header.m_file_name_with_path.find_last_of("/\\") + 1 >= header.m_file_name_with_path.size() ||
+	   !readPackMaterials(p_current, p_end, header.m_material_count, vp_materials))
+	{
+		return false;
 	}
 
-	warnIfLastMaterialIsInvisible(r_logstream);
-	input_file.close();
+	removeAll();
+	m_is_loaded_successfully = true;
+	setFileNameWithPath(header.m_file_name_with_path);
+	mvp_materials.swap(vp_materials);
 
 	assert(invariant());
+	return true;
+}
+
+bool MtlLibrary :: savePack (const string& pack_filename) const
+{
+	assert(pack_filename != "");
+
+	//
+	//  Format of file:
+	//
+	//  Header
+	//    -> magic number and version
+	//    -> MTL file name, modification time, size, and
+	//       content hash
+	//    -> how many materials
+	//  Materials
+	//
+
+	long long source_modified = -1;
+	long long source_size     = -1;
+	unsigned long long source_hash = 0;
+	AssetFileSystem::getFileStatus(getFileNameWithPath(), source_modified, source_size);
+	string source;
+	if(AssetFileSystem::readFile(getFileNameWithPath(), source))
+		source_hash = getContentHash(source);
+
+	string pack;
+	pack.append(PACK_MAGIC, sizeof(PACK_MAGIC));
+	appendPackValue(pack, PACK_VERSION);
+	appendPackString(pack, getFileNameWithPath());
+	appendPackValue(pack, source_modified);
+	appendPackValue(pack, source_size);
+	appendPackValue(pack, source_hash);
+	appendPackValue(pack, (unsigned int)(mvp_materials.size()));
+	for(unsigned int i = 0; i < mvp_materials.size(); i++)
+		appendPackMaterial(pack, *(mvp_materials[i]));
+
+	ofstream output_file(pack_filename.c_str(), ios::out | ios::binary);
+	if(!output_file.is_open())
+		return false;
+	output_file.write(pack.data(), pack.size());
+	return output_file.good();
 }
 
 void MtlLibrary :: setFileName (const string& file_name)
@@ -645,6 +1359,29 @@ unsigned int MtlLibrary :: add (Material* p_material)
 	return index;
 }
 
+void MtlLibrary :: updateMaterials (MtlLibrary&& original)
+{
+	if(&original == this)
+		return;
+
+	for(unsigned int i = 0; i < original.mvp_materials.size(); i++)
+	{
+		Material* p_material = original.mvp_materials[i];
+		unsigned int index = getMaterialIndex(p_material->getName());
+		if(index == NO_SUCH_MATERIAL)
+			mvp_materials.push_back(p_material);
+		else
+		{
+			*(mvp_materials[index]) = move(*p_material);
+			delete p_material;
+		}
+	}
+	original.mvp_materials.clear();
+	original.makeEmpty();
+
+	assert(invariant());
+}
+
 void MtlLibrary :: removeAll ()
 {
 	for(unsigned int i = 0; i < mvp_materials.size(); i++)
@@ -702,50 +1439,50 @@ void MtlLibrary :: warnIfLastMaterialIsInvisible (ostream& r_outstream) const
 	}
 }
 
-bool MtlLibrary :: readMaterialStart (const string& str, ostream& r_logstream)
+bool MtlLibrary :: readMaterialStart (const char* p_begin,
+                                      const char* p_end,
+                                      unordered_set<string>& r_names,
+                                      ostream& r_logstream)
 {
-	size_t start;
-	size_t length;
-	string name;
+	assert(p_begin <= p_end);
 
 	warnIfLastMaterialIsInvisible(r_logstream);
 
-	if(isspace(str[0]))
-		start = nextToken(str, 0);
-	else
-		start = 0;
-
-	length = getTokenLength(str, start);
-	name = str.substr(start, length);
-
-	if(name == "" || isMaterial(name))
+	const char* p_name = skipWhitespace(p_begin, p_end);
+	const char* p_name_end = skipToken(p_name, p_end);
+	if(p_name == p_name_end)
 		return false;
 
+	string name = toLowercase(string(p_name, p_name_end));
+	if(!r_names.insert(name).second)
+		return false;	// already used
+
 #ifdef OBJ_LIBRARY_PATH_PROPAGATION
 	string propagated_path = m_file_path;
 #else
 	string propagated_path = "";
 #endif
 
-	add(new Material(toLowercase(name), propagated_path));
+	add(new Material(name, propagated_path));
 	return true;
 }
 
-bool MtlLibrary :: readIlluminationMode (const string& str, ostream& r_logstream)
+bool MtlLibrary :: readIlluminationMode (const char* p_begin,
+                                         const char* p_end,
+                                         ostream& r_logstream)
 {
-	size_t index;
+	assert(p_begin <= p_end);
 
 	unsigned int illumination_mode;
 	unsigned int current_material;
 
 	current_material = mvp_materials.size() - 1;
 
-	if(isspace(str[0]))
-		index = nextToken(str, 0);
-	else
-		index = 0;
+	const char* p_token = skipWhitespace(p_begin, p_end);
+	if(p_token == p_end)
+		return false;
 
-	switch(atoi(str.c_str() + index))
+	switch(parseInt(p_token, skipToken(p_token, p_end)))
 	{
 	case 0:  illumination_mode = Material::ILLUMINATION_CONSTANT; break;
 	case 1:  illumination_mode = Material::ILLUMINATION_PHONG_NO_SPECULAR; break;
@@ -765,58 +1502,49 @@ bool MtlLibrary :: readIlluminationMode (const string& str, ostream& r_logstream
 	return true;
 }
 
-bool MtlLibrary :: readColour (const string& str, unsigned int target, ostream& r_logstream)
+bool MtlLibrary :: readColour (const char* p_begin,
+                               const char* p_end,
+                               unsigned int target,
+                               ostream& r_logstream)
 {
+	assert(p_begin <= p_end);
 	assert(target < COLOUR_TARGET_TYPES);
 
 	double red;
 	double green;
 	double blue;
 
-	size_t index;
+	const char* p_token;
+	const char* p_token_end;
 	unsigned int current_material;
 
 	current_material = mvp_materials.size() - 1;
 
-	if(isspace(str[0]))
-		index = nextToken(str, 0);
-	else
-		index = 0;
-
-	red = atof(str.c_str() + index);
+	p_token = skipWhitespace(p_begin, p_end);
+	if(p_token == p_end)
+		return false;
+	p_token_end = skipToken(p_token, p_end);
+	red = parseDouble(p_token, p_token_end);
 
-	index = nextToken(str, index);
-	if(index == string::npos)
+	p_token = skipWhitespace(p_token_end, p_end);
+	if(p_token == p_end)
 	{
 		//  Providing only one value for a colour is legal.
 		//    Greyscale is assumed.
 
-		switch(target)
-		{
-		case COLOUR_TARGET_EMISSION:
-			mvp_materials[current_material]->setEmissionColour(red, red, red);
-			break;
-		case COLOUR_TARGET_AMBIENT:
-			mvp_materials[current_material]->setAmbientColour(red, red, red);
-			break;
-		case COLOUR_TARGET_DIFFUSE:
-			mvp_materials[current_material]->setDiffuseColour(red, red, red);
-			break;
-		case COLOUR_TARGET_SPECULAR:
-			mvp_materials[current_material]->setSpecularColour(red, red, red);
-			break;
-		}
-
-		return true;
+		green = red;
+		blue  = red;
 	}
+	else
+	{
+		p_token_end = skipToken(p_token, p_end);
+		green = parseDouble(p_token, p_token_end);
 
-	green = atof(str.c_str() + index);
-
-	index = nextToken(str, index);
-	if(index == string::npos)
-		return false;
-
-	blue = atof(str.c_str() + index);
+		p_token = skipWhitespace(p_token_end, p_end);
+		if(p_token == p_end)
+			return false;
+		blue = parseDouble(p_token, skipToken(p_token, p_end));
+	}
 
 	switch(target)
 	{
@@ -837,41 +1565,42 @@ bool MtlLibrary :: readColour (const string& str, unsigned int target, ostream&
 	return true;
 }
 
-bool MtlLibrary :: readSpecularExponent (const string& str, ostream& r_logstream)
+bool MtlLibrary :: readSpecularExponent (const char* p_begin,
+                                         const char* p_end,
+                                         ostream& r_logstream)
 {
-	double exponent;
+	assert(p_begin <= p_end);
 
-	size_t index;
+	double exponent;
 	unsigned int current_material;
 
 	current_material = mvp_materials.size() - 1;
 
-	if(isspace(str[0]))
-		index = nextToken(str, 0);
-	else
-		index = 0;
-
-	exponent = atof(str.c_str() + index);
+	const char* p_token = skipWhitespace(p_begin, p_end);
+	if(p_token == p_end)
+		return false;
+	exponent = parseDouble(p_token, skipToken(p_token, p_end));
 
 	mvp_materials[current_material]->setSpecularExponent(exponent);
 	return true;
 }
 
-bool MtlLibrary :: readTransparency (const string& str, ostream& r_logstream, bool is_tr_line)
+bool MtlLibrary :: readTransparency (const char* p_begin,
+                                     const char* p_end,
+                                     ostream& r_logstream,
+                                     bool is_tr_line)
 {
-	double transparency;
+	assert(p_begin <= p_end);
 
-	size_t index;
+	double transparency;
 	unsigned int current_material;
 
 	current_material = mvp_materials.size() - 1;
 
-	if(isspace(str[0]))
-		index = nextToken(str, 0);
-	else
-		index = 0;
-
-	transparency = atof(str.c_str() + index);
+	const char* p_token = skipWhitespace(p_begin, p_end);
+	if(p_token == p_end)
+		return false;
+	transparency = parseDouble(p_token, skipToken(p_token, p_end));
 	if(transparency < 0.0)
 		return false;
 	if(transparency > 1.0)
@@ -886,46 +1615,50 @@ bool MtlLibrary :: readTransparency (const string& str, ostream& r_logstream, bo
 	return true;
 }
 
-bool MtlLibrary :: readOpticalDensity (const std::string& str, std::ostream& r_logstream)
+bool MtlLibrary :: readOpticalDensity (const char* p_begin,
+                                       const char* p_end,
+                                       ostream& r_logstream)
 {
-	double optical_density;
+	assert(p_begin <= p_end);
 
-	size_t index;
+	double optical_density;
 	unsigned int current_material;
 
 	current_material = mvp_materials.size() - 1;
 
-	if(isspace(str[0]))
-		index = nextToken(str, 0);
-	else
-		index = 0;
-
-	optical_density = atof(str.c_str() + index);
+	const char* p_token = skipWhitespace(p_begin, p_end);
+	if(p_token == p_end)
+		return false;
+	optical_density = parseDouble(p_token, skipToken(p_token, p_end));
 
 	mvp_materials[current_material]->setOpticalDensity(optical_density);
 	return true;
 }
 
-bool MtlLibrary :: readTransmissionFilter (const string& str, ostream& r_logstream)
+bool MtlLibrary :: readTransmissionFilter (const char* p_begin,
+                                           const char* p_end,
+                                           ostream& r_logstream)
 {
+	assert(p_begin <= p_end);
+
 	double red;
 	double green;
 	double blue;
 
-	size_t index;
+	const char* p_token;
+	const char* p_token_end;
 	unsigned int current_material;
 
 	current_material = mvp_materials.size() - 1;
 
-	if(isspace(str[0]))
-		index = nextToken(str, 0);
-	else
-		index = 0;
-
-	red = atof(str.c_str() + index);
+	p_token = skipWhitespace(p_begin, p_end);
+	if(p_token == p_end)
+		return false;
+	p_token_end = skipToken(p_token, p_end);
+	red = parseDouble(p_token, p_token_end);
 
-	index = nextToken(str, index);
-	if(index == string::npos)
+	p_token = skipWhitespace(p_token_end, p_end);
+	if(p_token == p_end)
 	{
 		//  Providing only one value for a colour is legal.
 		//    Greyscale is assumed.
@@ -934,33 +1667,33 @@ bool MtlLibrary :: readTransmissionFilter (const string& str, ostream& r_logstre
 		return true;
 	}
 
-	green = atof(str.c_str() + index);
+	p_token_end = skipToken(p_token, p_end);
+	green = parseDouble(p_token, p_token_end);
 
-	index = nextToken(str, index);
-	if(index == string::npos)
+	p_token = skipWhitespace(p_token_end, p_end);
+	if(p_token == p_end)
 		return false;
-
-	blue = atof(str.c_str() + index);
+	blue = parseDouble(p_token, skipToken(p_token, p_end));
 
 	mvp_materials[current_material]->setTransmissionFilter(red, green, blue);
 	return true;
 }
 
-bool MtlLibrary :: readBumpMapMultiplier (const std::string& str, std::ostream& r_logstream)
+bool MtlLibrary :: readBumpMapMultiplier (const char* p_begin,
+                                          const char* p_end,
+                                          ostream& r_logstream)
 {
-	double multiplier;
+	assert(p_begin <= p_end);
 
-	size_t index;
+	double multiplier;
 	unsigned int current_material;
 
 	current_material = mvp_materials.size() - 1;
 
-	if(isspace(str[0]))
-		index = nextToken(str, 0);
-	else
-		index = 0;
-
-	multiplier = atof(str.c_str() + index);
+	const char* p_token = skipWhitespace(p_begin, p_end);
+	if(p_token == p_end)
+		return false;
+	multiplier = parseDouble(p_token, skipToken(p_token, p_end));
 
 	mvp_materials[current_material]->setBumpMapMultiplier(multiplier);
 	return true;
@@ -968,24 +1701,26 @@ bool MtlLibrary :: readBumpMapMultiplier (const std::string& str, std::ostream&
 
 
 
-bool MtlLibrary :: readMapColour (const string& str, unsigned int target, ostream& r_logstream)
+bool MtlLibrary :: readMapColour (const char* p_begin,
+                                  const char* p_end,
+                                  const unordered_set<string>& names,
+                                  unsigned int target,
+                                  ostream& r_logstream)
 {
+	assert(p_begin <= p_end);
 	assert(target < COLOUR_TARGET_TYPES);
 
-	string filename;
-
-	size_t index;
 	unsigned int current_material;
 
 	current_material = mvp_materials.size() - 1;
 
-	if(isspace(str[0]))
-		index = nextToken(str, 0);
-	else
-		index = 0;
+	const char* p_token = skipWhitespace(p_begin, p_end);
+	const char* p_token_end = skipToken(p_token, p_end);
+	if(p_token == p_token_end)
+		return false;
 
-	filename = str.substr(index, getTokenLength(str, index));
-	if(filename == "" || isMaterial(filename))
+	string filename(p_token, p_token_end);
+	if(names.find(toLowercase(filename)) != names.end())
 		return false;
 
 	switch(target)
@@ -1007,15 +1742,18 @@ bool MtlLibrary :: readMapColour (const string& str, unsigned int target, ostrea
 	return true;
 }
 
-bool MtlLibrary :: readMapChannel (const string& str, unsigned int target, ostream& r_logstream)
+bool MtlLibrary :: readMapChannel (const char* p_begin,
+                                   const char* p_end,
+                                   const unordered_set<string>& names,
+                                   unsigned int target,
+                                   ostream& r_logstream)
 {
+	assert(p_begin <= p_end);
 	assert(target < CHANNEL_TARGET_TYPES);
 
-	string filename;
 	unsigned char channel;
 	double bump_multiplier = 1.0;
 
-	size_t index;
 	unsigned int current_material;
 
 	current_material = mvp_materials.size() - 1;
@@ -1025,56 +1763,55 @@ bool MtlLibrary :: readMapChannel (const string& str, unsigned int target, ostre
 	else
 		channel = Material::CHANNEL_LUMINANCE;
 
-	if(isspace(str[0]))
-		index = nextToken(str, 0);
-	else
-		index = 0;
+	const char* p_token = skipWhitespace(p_begin, p_end);
+	const char* p_token_end = skipToken(p_token, p_end);
+	if(p_token == p_token_end)
+		return false;
 
-	filename = str.substr(index, getTokenLength(str, index));
-	if(filename == "" || isMaterial(filename))
+	string filename(p_token, p_token_end);
+	if(names.find(toLowercase(filename)) != names.end())
 		return false;
 
-	index = nextToken(str, index);
-	while(index != string::npos)
+	p_token = skipWhitespace(p_token_end, p_end);
+	while(p_token != p_end)
 	{
-		string token;
-
-		token = str.substr(index, getTokenLength(str, index));
-		if(token == "-imfchan")
+		p_token_end = skipToken(p_token, p_end);
+		if(isTokenEqual(p_token, p_token_end, "-imfchan"))
 		{
-			index = nextToken(str, index);
-			if(index == string::npos)
+			p_token = skipWhitespace(p_token_end, p_end);
+			if(p_token == p_end)
 				return false;
+			p_token_end = skipToken(p_token, p_end);
 
-			token = str.substr(index, getTokenLength(str, index));
-			if(token == "r")
+			if(isTokenEqual(p_token, p_token_end, "r"))
 				channel = Material::CHANNEL_RED;
-			else if(token == "g")
+			else if(isTokenEqual(p_token, p_token_end, "g"))
 				channel = Material::CHANNEL_GREEN;
-			else if(token == "b")
+			else if(isTokenEqual(p_token, p_token_end, "b"))
 				channel = Material::CHANNEL_BLUE;
-			else if(token == "m")
+			else if(isTokenEqual(p_token, p_token_end, "m"))
 				channel = Material::CHANNEL_MATTE;
-			else if(token == "l")
+			else if(isTokenEqual(p_token, p_token_end, "l"))
 				channel = Material::CHANNEL_LUMINANCE;
-			else if(token == "z")
+			else if(isTokenEqual(p_token, p_token_end, "z"))
 				channel = Material::CHANNEL_Z_DEPTH;
 			else
 				return false;
 		}
-		else if(token == "-bm")
+		else if(isTokenEqual(p_token, p_token_end, "-bm"))
 		{
-			if(channel != CHANNEL_TARGET_BUMP)
+			if(target != CHANNEL_TARGET_BUMP)
 				return false;
 
-			index = nextToken(str, index);
-			if(index == string::npos)
+			p_token = skipWhitespace(p_token_end, p_end);
+			if(p_token == p_end)
 				return false;
+			p_token_end = skipToken(p_token, p_end);
 
-			bump_multiplier = atof(str.c_str() + index);
+			bump_multiplier = parseDouble(p_token, p_token_end);
 		}
 
-		index = nextToken(str, index);
+		p_token = skipWhitespace(p_token_end, p_end);
 	}
 
 	switch(target)
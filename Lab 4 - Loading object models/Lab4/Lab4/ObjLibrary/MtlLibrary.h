@@ -24,6 +24,7 @@
 
 #include <string>
 #include <vector>
+#include <unordered_set>
 #include <iostream>
 
 
@@ -148,6 +149,22 @@ public:
 //
 	MtlLibrary (const MtlLibrary& original);
 
+//
+//  Move Constructor
+//
+//  Purpose: To create a new MtlLibrary by taking the Materials
+//           of another MtlLibrary.
+//  Parameter(s):
+//    <1> original: The MtlLibrary to move
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new MtlLibrary is created with the name and
+//               Materials original had.  The Materials are not
+//               copied, so pointers to them remain valid.
+//               original is made empty.
+//
+	MtlLibrary (MtlLibrary&& original) noexcept;
+
 //
 //  Assignment Operator
 //
@@ -163,6 +180,23 @@ public:
 //
 	MtlLibrary& operator= (const MtlLibrary& original);
 
+//
+//  Move Assignment Operator
+//
+//  Purpose: To replace the Materials in this MtlLibrary with
+//           the Materials taken from another MtlLibrary.
+//  Parameter(s):
+//    <1> original: The MtlLibrary to move
+//  Precondition(s): N/A
+//  Returns: A reference to this MtlLibrary.
+//  Side Effect: All Materials in this MtlLibrary are removed.
+//               This MtlLibrary is given the name and Materials
+//               original had.  The Materials are not copied, so
+//               pointers to them remain valid.  original is
+//               made empty.
+//
+	MtlLibrary& operator= (MtlLibrary&& original) noexcept;
+
 //
 //  Destructor
 //
@@ -523,6 +557,82 @@ public:
 	void load (const std::string& filename,
 	           std::ostream& r_logstream);
 
+//
+//  loadCached
+//
+//  Purpose: To load the contents of this MtlLibrary from a
+//           material pack file if it is up to date, and from
+//           the MTL file otherwise.
+//  Parameter(s):
+//    <1> filename: The name of the MTL file
+//    <2> pack_filename: The name of the material pack file
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> filename != ""
+//    <2> filename.find_last_of("/\\") == string::npos ||
+//        filename.find_last_of("/\\") + 1 < filename.size()
+//    <3> pack_filename != ""
+//  Returns: N/A
+//  Side Effect: This MtlLibrary is replaced with the
+//               MtlLibrary specified in file filename.  If file
+//               pack_filename was saved from file filename as
+//               it is now (the same size, modification time,
+//               and content hash), and all the values in it
+//               are in range, the Materials are read from it
+//               without parsing any text.  Otherwise, file filename is
+//               loaded as by load and, if it loaded
+//               successfully, is saved to file pack_filename
+//               for next time.  Any loading errors are written
+//               to the standard error stream or r_logstream.
+//
+	void loadCached (const std::string& filename,
+	                 const std::string& pack_filename);
+	void loadCached (const std::string& filename,
+	                 const std::string& pack_filename,
+	                 std::ostream& r_logstream);
+
+//
+//  loadPack
+//
+//  Purpose: To load the contents of this MtlLibrary from a
+//           material pack file.
+//  Parameter(s):
+//    <1> pack_filename: The name of the material pack file
+//  Precondition(s):
+//    <1> pack_filename != ""
+//  Returns: Whether file pack_filename could be read.  This is
+//           false if the file does not exist, is not a
+//           material pack, was saved by a different version
+//           of this library, or contains a value that is out
+//           of range, such as a colour outside [0, 1].
+//  Side Effect: If file pack_filename is a valid material
+//               pack, this MtlLibrary is replaced with the
+//               MtlLibrary stored in it, including the file
+//               name and path.  Otherwise, there is no effect.
+//               No textures are loaded.
+//
+	bool loadPack (const std::string& pack_filename);
+
+//
+//  savePack
+//
+//  Purpose: To write this MtlLibrary to a material pack file.
+//  Parameter(s):
+//    <1> pack_filename: The name of the material pack file
+//  Precondition(s):
+//    <1> pack_filename != ""
+//  Returns: Whether file pack_filename could be written.
+//  Side Effect: This MtlLibrary is written to file
+//               pack_filename in a binary format that loadPack
+//               can read without parsing any text.  The size,
+//               modification time, and a hash of the contents
+//               of the MTL file named by getFileNameWithPath()
+//               are stored with it, for use by loadCached.  Material packs store values
+//               as they are in memory, and so can only be read
+//               on a computer with the same byte order.
+//
+	bool savePack (const std::string& pack_filename) const;
+
 //
 //  setFileName
 //
@@ -588,6 +698,27 @@ public:
 //
 	unsigned int add (Material* p_material);
 
+//
+//  updateMaterials
+//
+//  Purpose: To change the Materials in this MtlLibrary to
+//           match another MtlLibrary without moving them, such
+//           as when a library is loaded again.
+//  Parameter(s):
+//    <1> original: The MtlLibrary with the new Materials
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Each Material in this MtlLibrary with the same
+//               name as a Material in original is assigned that
+//               Material's values, so pointers to it remain
+//               valid.  The Materials in original with other
+//               names are moved to this MtlLibrary.  Materials
+//               that are not in original are not changed or
+//               removed, because something may still point to
+//               them.  original is made empty.
+//
+	void updateMaterials (MtlLibrary&& original);
+
 //
 //  removeAll
 //
@@ -650,61 +781,74 @@ private:
 //  readMaterialStart
 //
 //  Purpose: To begin a adding new Material to this MtlLibrary
-//           corresponding to the information in a string.
+//           corresponding to the information in a line.
 //  Parameter(s):
-//    <1> str: The string containing the material name
-//    <2> r_logstream: The stream to write loading errors to
-//  Precondition(s): N/A
-//  Returns: Whether the string specifies a legal material name.
-//  Side Effect: If string str specifies a valid, unused
+//    <1> p_begin: A pointer to the start of the material name
+//    <2> p_end: A pointer to just past the end of the line
+//    <3> r_names: The lowercase names of the Materials in
+//                 this MtlLibrary
+//    <4> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> p_begin <= p_end
+//  Returns: Whether the line specifies a legal material name.
+//  Side Effect: If the line specifies a valid, unused
 //               material name, a new Material with that name is
-//               added to this MtlLibrary.  The new Material is
-//               considered to be the one being read in, so
-//               future read commands (except readMaterialStart)
-//               will affect that Material.  If str does not
+//               added to this MtlLibrary and to r_names.  The
+//               new Material is considered to be the one being
+//               read in, so future read commands (except
+//               readMaterialStart) will affect that Material.  If the line does not
 //               specify a valid name for a new Material, there
 //               is no effect.
 //
-	bool readMaterialStart (const std::string& str,
+	bool readMaterialStart (const char* p_begin,
+	                        const char* p_end,
+	                        std::unordered_set<std::string>& r_names,
 	                        std::ostream& r_logstream);
 
 //
 //  readIlluminationMode
 //
 //  Purpose: To read the illumination mode corresponding to the
-//           information in a string to the current Material.
+//           information in a line to the current Material.
 //  Parameter(s):
-//    <1> str: The string containing the illumination mode
-//    <2> r_logstream: The stream to write loading errors to
-//  Precondition(s): N/A
-//  Returns: Whether the string specifies a valid illumination
+//    <1> p_begin: A pointer to the start of the illumination
+//                 mode
+//    <2> p_end: A pointer to just past the end of the line
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> p_begin <= p_end
+//  Returns: Whether the line specifies a valid illumination
 //           mode.
-//  Side Effect: If string str specifies a valid illumination
+//  Side Effect: If the line specifies a valid illumination
 //               mode, the current Material is set to have that
 //               illumination mode.  Otherwise, there is no
 //               effect.
 //
-	bool readIlluminationMode (const std::string& str,
+	bool readIlluminationMode (const char* p_begin,
+	                           const char* p_end,
 	                           std::ostream& r_logstream);
 
 //
 //  readColour
 //
 //  Purpose: To read the colour corresponding to the information
-//           in a string to the current Material.
+//           in a line to the current Material.
 //  Parameter(s):
-//    <1> str: The string containing the colour
-//    <2> target: Where this colour should be stored
-//    <3> r_logstream: The stream to write loading errors to
+//    <1> p_begin: A pointer to the start of the colour
+//    <2> p_end: A pointer to just past the end of the line
+//    <3> target: Where this colour should be stored
+//    <4> r_logstream: The stream to write loading errors to
 //  Precondition(s):
-//    <1> target < COLOUR_TARGET_TYPES
-//  Returns: Whether the string specifies a valid colour.
-//  Side Effect: If string str specifies a valid colour, the
+//    <1> p_begin <= p_end
+//    <2> target < COLOUR_TARGET_TYPES
+//  Returns: Whether the line specifies a valid colour.
+//  Side Effect: If the line specifies a valid colour, the
 //               current Material is set to have that colour
 //               for the location specified by target.
 //               Otherwise, there is no effect.
 //
-	bool readColour (const std::string& str,
+	bool readColour (const char* p_begin,
+	                 const char* p_end,
 	                 unsigned int target,
 	                 std::ostream& r_logstream);
 
@@ -712,41 +856,48 @@ private:
 //  readSpecularExponent
 //
 //  Purpose: To read the specular exponent corresponding to the
-//           information in a string to the current Material.
+//           information in a line to the current Material.
 //  Parameter(s):
-//    <1> str: The string containing the specular exponent
-//    <2> r_logstream: The stream to write loading errors to
-//  Precondition(s): N/A
-//  Returns: Whether the string specifies a valid specular
+//    <1> p_begin: A pointer to the start of the specular
+//                 exponent
+//    <2> p_end: A pointer to just past the end of the line
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> p_begin <= p_end
+//  Returns: Whether the line specifies a valid specular
 //           exponent.
-//  Side Effect: If string str specifies a valid specular
+//  Side Effect: If the line specifies a valid specular
 //               exponent, the current Material is set to have
 //               that transparency.  Otherwise, there is no
 //               effect.
 //
-	bool readSpecularExponent (const std::string& str,
+	bool readSpecularExponent (const char* p_begin,
+	                           const char* p_end,
 	                           std::ostream& r_logstream);
 
 //
 //  readTransparency
 //
 //  Purpose: To read the transparency corresponding to the
-//           information in a string to the current Material.
+//           information in a line to the current Material.
 //  Parameter(s):
-//    <1> str: The string containing the transparency
-//    <2> r_logstream: The stream to write loading errors to
-//    <3> is_tr_line: Whether the lines began with with "Tr "
+//    <1> p_begin: A pointer to the start of the transparency
+//    <2> p_end: A pointer to just past the end of the line
+//    <3> r_logstream: The stream to write loading errors to
+//    <4> is_tr_line: Whether the lines began with with "Tr "
 //                    instead of "d "
-//  Precondition(s): N/A
-//  Returns: Whether the string specifies a valid transparency.
-//  Side Effect: If string str specifies a valid transparency,
+//  Precondition(s):
+//    <1> p_begin <= p_end
+//  Returns: Whether the line specifies a valid transparency.
+//  Side Effect: If the line specifies a valid transparency,
 //               the current Material is set to have that
 //               transparency.  Otherwise, there is no effect.
 //               If is_tr_line is true and the
 //               OBJ_LIBRARY_TR_0_IS_OPAQUE macro is defined,
 //               the transparency will be reversed.
 //
-	bool readTransparency (const std::string& str,
+	bool readTransparency (const char* p_begin,
+	                       const char* p_end,
 	                       std::ostream& r_logstream,
 	                       bool is_tr_line);
 
@@ -754,80 +905,96 @@ private:
 //  readOpticalDensity
 //
 //  Purpose: To read the optical density corresponding to the
-//           information in a string to the current Material.
+//           information in a line to the current Material.
 //  Parameter(s):
-//    <1> str: The string containing the optical density
-//    <2> r_logstream: The stream to write loading errors to
-//  Precondition(s): N/A
-//  Returns: Whether the string specifies a valid optical
+//    <1> p_begin: A pointer to the start of the optical density
+//    <2> p_end: A pointer to just past the end of the line
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> p_begin <= p_end
+//  Returns: Whether the line specifies a valid optical
 //           density.
-//  Side Effect: If string str specifies a valid optical
+//  Side Effect: If the line specifies a valid optical
 //               density, the current Material is set to have
 //               that optical density.  Otherwise, there is no
 //               effect.
 //
-	bool readOpticalDensity (const std::string& str,
+	bool readOpticalDensity (const char* p_begin,
+	                         const char* p_end,
 	                         std::ostream& r_logstream);
 
 //
 //  readTransmissionFilter
 //
 //  Purpose: To read the transmission filter corresponding to
-//           the information in a string to the current
+//           the information in a line to the current
 //           Material.
 //  Parameter(s):
-//    <1> str: The string containing the colour
-//    <2> r_logstream: The stream to write loading errors to
-//  Precondition(s): N/A
-//  Returns: Whether the string specifies a valid transmission
+//    <1> p_begin: A pointer to the start of the colour
+//    <2> p_end: A pointer to just past the end of the line
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> p_begin <= p_end
+//  Returns: Whether the line specifies a valid transmission
 //           filter.
-//  Side Effect: If string str specifies a valid transmission
+//  Side Effect: If the line specifies a valid transmission
 //               filter, the current Material is set to have
 //               that transmission filter.  Otherwise, there is
 //               no effect.
 //
-	bool readTransmissionFilter (const std::string& str,
+	bool readTransmissionFilter (const char* p_begin,
+	                             const char* p_end,
 	                             std::ostream& r_logstream);
 
 //
 //  readBumpMapMultiplier
 //
 //  Purpose: To read the bump map multiplier corresponding to
-//           the information in a string to the current
+//           the information in a line to the current
 //           Material.
 //  Parameter(s):
-//    <1> str: The string containing the value
-//    <2> r_logstream: The stream to write loading errors to
-//  Precondition(s): N/A
-//  Returns: Whether the string specifies a valid bump
+//    <1> p_begin: A pointer to the start of the value
+//    <2> p_end: A pointer to just past the end of the line
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> p_begin <= p_end
+//  Returns: Whether the line specifies a valid bump
 //           multiplier.
-//  Side Effect: If string str specifies a valid bump
+//  Side Effect: If the line specifies a valid bump
 //               multiplier, the current Material is set to have
 //               that bump map multiplier.  Otherwise, there is no
 //               effect.
 //
-	bool readBumpMapMultiplier (const std::string& str,
+	bool readBumpMapMultiplier (const char* p_begin,
+	                            const char* p_end,
 	                            std::ostream& r_logstream);
 
 //
 //  readMapColour
 //
 //  Purpose: To read the texture map filename corresponding to
-//           the information in a string to the current
+//           the information in a line to the current
 //           Material.
 //  Parameter(s):
-//    <1> str: The string containing the texture map filename
-//    <2> target: Where this texture map should be stored
-//    <3> r_logstream: The stream to write loading errors to
+//    <1> p_begin: A pointer to the start of the texture map
+//                 filename
+//    <2> p_end: A pointer to just past the end of the line
+//    <3> names: The lowercase names of the Materials in
+//               this MtlLibrary
+//    <4> target: Where this texture map should be stored
+//    <5> r_logstream: The stream to write loading errors to
 //  Precondition(s):
-//    <1> target < COLOUR_TARGET_TYPES
-//  Returns: Whether the string specifies a valid filename.
-//  Side Effect: If string str specifies a valid texture map,
+//    <1> p_begin <= p_end
+//    <2> target < COLOUR_TARGET_TYPES
+//  Returns: Whether the line specifies a valid filename.
+//  Side Effect: If the line specifies a valid texture map,
 //               the current Material is set to have that
 //               texture map for the location specified by
 //               target.  Otherwise, there is no effect.
 //
-	bool readMapColour (const std::string& str,
+	bool readMapColour (const char* p_begin,
+	                    const char* p_end,
+	                    const std::unordered_set<std::string>& names,
 	                    unsigned int target,
 	                    std::ostream& r_logstream);
 
@@ -835,23 +1002,29 @@ private:
 //  readMapChannel
 //
 //  Purpose: To read the texture map filename and colour channel
-//           to use corresponding to the information in a string
+//           to use corresponding to the information in a line
 //           to the current Material.
 //  Parameter(s):
-//    <1> str: The string containing the information
-//    <2> target: Where this texture map should be stored
-//    <3> r_logstream: The stream to write loading errors to
+//    <1> p_begin: A pointer to the start of the information
+//    <2> p_end: A pointer to just past the end of the line
+//    <3> names: The lowercase names of the Materials in
+//               this MtlLibrary
+//    <4> target: Where this texture map should be stored
+//    <5> r_logstream: The stream to write loading errors to
 //  Precondition(s):
-//    <1> target < CHANNEL_TARGET_TYPES
-//  Returns: Whether the string specifies a valid filename and
+//    <1> p_begin <= p_end
+//    <2> target < CHANNEL_TARGET_TYPES
+//  Returns: Whether the line specifies a valid filename and
 //           channel.
-//  Side Effect: If string str specifies a valid texture map
+//  Side Effect: If the line specifies a valid texture map
 //               and channel, the current Material is set to
 //               have that texture map and colour channel for
 //               the location specified by target.  Otherwise,
 //               there is no effect.
 //
-	bool readMapChannel (const std::string& str,
+	bool readMapChannel (const char* p_begin,
+	                     const char* p_end,
+	                     const std::unordered_set<std::string>& names,
 	                     unsigned int target,
 	                     std::ostream& r_logstream);
 
@@ -22,6 +22,8 @@
 #include <vector>
 #include <iostream>
 #include <fstream>
+#include <mutex>
+#include <condition_variable>
 
 #include "ObjStringParsing.h"
 #include "MtlLibrary.h"
@@ -35,19 +37,70 @@ namespace
 {
 	std::vector<MtlLibrary*> g_mtl_libraries;
 	MtlLibrary g_empty;
+
+	// libraries are loaded without holding the mutex, so
+	//  different libraries can load at the same time
+	std::mutex g_mutex;
+	std::condition_variable g_loaded_condition;
+	std::vector<std::string> gv_loading;
+
+	//
+	//  findLoaded
+	//
+	//  Purpose: To find the material library with the specified
+	//           name.
+	//  Parameter(s):
+	//    <1> lower: The name of the material library in
+	//               lowercase
+	//  Precondition(s):
+	//    <1> g_mutex is locked by the calling thread
+	//  Returns: A pointer to the MtlLibrary with name lower, or
+	//           NULL if there is none.
+	//  Side Effect: N/A
+	//
+	MtlLibrary* findLoaded (const std::string& lower)
+	{
+		for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
+			if(g_mtl_libraries[i]->getFileNameWithPathLowercase() == lower)
+				return g_mtl_libraries[i];
+		return NULL;
+	}
+
+	//
+	//  findLoading
+	//
+	//  Purpose: To find the material library with the specified
+	//           name in the list of libraries being loaded.
+	//  Parameter(s):
+	//    <1> lower: The name of the material library in
+	//               lowercase
+	//  Precondition(s):
+	//    <1> g_mutex is locked by the calling thread
+	//  Returns: The index of lower in gv_loading, or
+	//           gv_loading.size() if it is not there.
+	//  Side Effect: N/A
+	//
+	unsigned int findLoading (const std::string& lower)
+	{
+		for(unsigned int i = 0; i < gv_loading.size(); i++)
+			if(gv_loading[i] == lower)
+				return i;
+		return (unsigned int)(gv_loading.size());
+	}
 }
 
 
 
 unsigned int MtlLibraryManager :: getCount ()
 {
+	lock_guard<mutex> lock(g_mutex);
 	return g_mtl_libraries.size();
 }
 
 MtlLibrary& MtlLibraryManager :: get (unsigned int index)
 {
-	assert(index < getCount());
-
+	lock_guard<mutex> lock(g_mutex);
+	assert(index < g_mtl_libraries.size());
 	return *(g_mtl_libraries[index]);
 }
 
@@ -62,10 +115,8 @@ bool MtlLibraryManager :: isLoaded (const std::string& name)
 {
 	string lower = toLowercase(name);
 
-	for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
-		if(g_mtl_libraries[i]->getFileNameWithPathLowercase() == lower)
-			return true;
-	return false;
+	lock_guard<mutex> lock(g_mutex);
+	return findLoaded(lower) != NULL;
 }
 
 MtlLibrary& MtlLibraryManager :: get (const char* a_name)
@@ -114,14 +165,29 @@ MtlLibrary& MtlLibraryManager :: get (const string& name, ostream& r_logstream)
 {
 	string lower = toLowercase(name);
 
-	for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
-		if(g_mtl_libraries[i]->getFileNameWithPathLowercase() == lower)
-			return *(g_mtl_libraries[i]);
-
-	if(endsWith(lower, ".mtl"))
-		return add(MtlLibrary(name, r_logstream));
-	else
+	unique_lock<mutex> lock(g_mutex);
+	MtlLibrary* p_library = findLoaded(lower);
+	while(p_library == NULL && findLoading(lower) < gv_loading.size())
+	{
+		// another thread is loading this library
+		g_loaded_condition.wait(lock);
+		p_library = findLoaded(lower);
+	}
+	if(p_library != NULL)
+		return *p_library;
+
+	if(!endsWith(lower, ".mtl"))
 		return g_empty;
+
+	gv_loading.push_back(lower);
+	lock.unlock();
+	p_library = new MtlLibrary(name, r_logstream);
+	lock.lock();
+
+	gv_loading.erase(gv_loading.begin() + findLoading(lower));
+	g_mtl_libraries.push_back(p_library);
+	g_loaded_condition.notify_all();
+	return *p_library;
 }
 
 bool MtlLibraryManager :: isMaterial (const char* a_name, const char* a_material)
@@ -228,7 +294,12 @@ Material* MtlLibraryManager :: getMaterial (const string& name, const string& ma
 
 MtlLibrary& MtlLibraryManager :: add (const MtlLibrary& mtl_library)
 {
-	assert(!isLoaded(mtl_library.getFileNameWithPathLowercase()));
+	lock_guard<mutex> lock(g_mutex);
+
+	// check under the same lock, so no other thread can load
+	//  this library between the check and the addition
+	assert(findLoaded(mtl_library.getFileNameWithPathLowercase()) == NULL);
+	assert(findLoading(mtl_library.getFileNameWithPathLowercase()) >= gv_loading.size());
 
 	unsigned int index = g_mtl_libraries.size();
 	g_mtl_libraries.push_back(new MtlLibrary(mtl_library));
@@ -238,6 +309,7 @@ MtlLibrary& MtlLibraryManager :: add (const MtlLibrary& mtl_library)
 
 void MtlLibraryManager :: unloadAll ()
 {
+	lock_guard<mutex> lock(g_mutex);
 	for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
 		delete g_mtl_libraries[i];
 	g_mtl_libraries.clear();
@@ -247,6 +319,7 @@ void MtlLibraryManager :: loadDisplayTextures ()
 {
 	// such simple code for such a powerful command...
 
+	lock_guard<mutex> lock(g_mutex);
 	for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
 		g_mtl_libraries[i]->loadDisplayTextures();
 }
@@ -255,6 +328,7 @@ void MtlLibraryManager :: loadAllTextures ()
 {
 	// such simple code for such a powerful command...
 
+	lock_guard<mutex> lock(g_mutex);
 	for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
 		g_mtl_libraries[i]->loadAllTextures();
 }
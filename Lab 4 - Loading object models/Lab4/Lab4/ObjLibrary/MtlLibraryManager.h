@@ -3,6 +3,24 @@
 //
 //  A global service to handle MtlLibraries.
 //
+//  The functions in this module may be called from any thread.
+//    Different material libraries can be loaded at the same
+//    time.  If two threads request the same library at once,
+//    it is only loaded once.  The functions that load textures
+//    must still only be called from the thread with the OpenGL
+//    context.
+//
+//  The references returned by the get functions are not
+//    protected by the manager's lock.  A MtlLibrary is never
+//    moved or destroyed until unloadAll is called, so the
+//    references remain valid until then.  However, the contents
+//    of a MtlLibrary may only be changed (for example, by
+//    AssetWatcher::update or by loading its textures) on the
+//    thread that owns it, normally the one with the OpenGL
+//    context.  Other threads may read a MtlLibrary only while
+//    the owning thread is not changing it, such as while the
+//    owning thread waits for their jobs.
+//
 //  This file is part of the ObjLibrary, by Richard Hamilton,
 //    which is copyright Hamilton 2009-2016.
 //
@@ -312,7 +330,10 @@ Material* getMaterial (const std::string& name,
 //    <1> !isLoaded(mtl_library.getName())
 //  Returns: A reference to the MtlLibrary added.
 //  Side Effect: MtlLibrary mtl_library is added to the material
-//               library manager.
+//               library manager.  The precondition is checked
+//               under the same lock as the addition, so another
+//               thread cannot add or load the same library in
+//               between.
 //
 MtlLibrary& add (const MtlLibrary& mtl_library);
 
@@ -19,12 +19,22 @@
 
 #include <cassert>
 #include <cctype>
-#include <cstdlib>	// for atoi
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdlib>	// for atoll
+#include <cstring>	// for memcmp
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <string>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <utility>	// for move
 
 #include "ObjSettings.h"
 
@@ -35,11 +45,14 @@
 #endif
 
 #include "ObjStringParsing.h"
+#include "AssetFile.h"
 #include "DisplayList.h"
 #include "Material.h"
 #include "MtlLibrary.h"
 #include "MtlLibraryManager.h"
+#include "JobSystem.h"
 #include "ObjModel.h"
+#include "ObjStream.h"
 
 #ifdef OBJ_LIBRARY_SHADER_DISPLAY
 	#include "VertexDataFormat.h"
@@ -75,12 +88,387 @@ namespace
 	const bool DEBUGGING_VALIDATE      = false || DEBUGGING_LOAD;
 	const bool DEBUGGING_VERTEX_BUFFER = false;
 	const bool DEBUGGING_FACE_SHADERS  = false;
+
+	// a normal this close to a length of 1 is not normalized
+	//   again, so saved normals load back exactly the same
+	const double NORMALIZED_TOLERANCE = 4.0 * DBL_EPSILON;
+
+	// more dirty ranges than this are merged into one
+	const unsigned int DIRTY_RANGE_COUNT_MAX = 16;
+
+	// OpenGL cannot draw more vertexes or indexes than this
+	//   from vertex arrays
+	const unsigned int DRAW_ARRAYS_COUNT_MAX = INT_MAX;
+
+	// elements with fewer vertexes than this are invalid
+	const unsigned int POINT_SET_MINIMUM_VERTEXES = 1;
+	const unsigned int POLYLINE_MINIMUM_VERTEXES  = 2;
+	const unsigned int FACE_MINIMUM_VERTEXES      = 3;
+
+	//
+	//  VALIDATE_CHUNK_SIZE
+	//
+	//  The number of faces checked together by one job when
+	//    validating a model.
+	//
+	const unsigned int VALIDATE_CHUNK_SIZE = 16384;
+
+	//
+	//  addDirtyIndex
+	//
+	//  Purpose: To add an index to a list of dirty ranges.
+	//  Parameter(s):
+	//    <1> rv_ranges: The dirty ranges, stored as pairs of a
+	//                   first index and one past the last index
+	//    <2> index: The index to add
+	//  Precondition(s):
+	//    <1> rv_ranges.size() % 2 == 0
+	//  Returns: N/A
+	//  Side Effect: Index index is added to rv_ranges.  If it is
+	//               in or next to a range, that range is
+	//               extended.  Otherwise, a new range is added.
+	//               If there would be too many ranges, they are
+	//               all replaced with one range containing them
+	//               and index.
+	//
+	void addDirtyIndex (vector<ObjModel::Index>& rv_ranges,
+	                    ObjModel::Index index)
+	{
+		assert(rv_ranges.size() % 2 == 0);
+
+		for(unsigned int r = 0; r < rv_ranges.size(); r += 2)
+			if(index + 1 >= rv_ranges[r] && index <= rv_ranges[r + 1])
+			{
+				if(index < rv_ranges[r])
+					rv_ranges[r] = index;
+				if(index + 1 > rv_ranges[r + 1])
+					rv_ranges[r + 1] = index + 1;
+				return;
+			}
+
+		if(rv_ranges.size() / 2 < DIRTY_RANGE_COUNT_MAX)
+		{
+			rv_ranges.push_back(index);
+			rv_ranges.push_back(index + 1);
+			return;
+		}
+
+		ObjModel::Index begin = index;
+		ObjModel::Index end   = index + 1;
+		for(unsigned int r = 0; r < rv_ranges.size(); r += 2)
+		{
+			if(rv_ranges[r] < begin)
+				begin = rv_ranges[r];
+			if(rv_ranges[r + 1] > end)
+				end = rv_ranges[r + 1];
+		}
+		rv_ranges.resize(2);
+		rv_ranges[0] = begin;
+		rv_ranges[1] = end;
+	}
+
+	//
+	//  readIndex
+	//
+	//  Purpose: To read a vertex, texture coordinate, or normal
+	//           index from a line of an OBJ file.
+	//  Parameter(s):
+	//    <1> a_str: The text to read from
+	//    <2> count: The number of elements the index can refer
+	//               to
+	//    <3> r_index: The index to set
+	//  Precondition(s):
+	//    <1> a_str != NULL
+	//  Returns: Whether a_str starts with an index that can be
+	//           stored in an ObjModel::Index.  Indexes past the
+	//           end of the list are allowed and make the model
+	//           invalid, but 0 and negative indexes before the
+	//           start of the list are not.
+	//  Side Effect: If a_str starts with a valid index, r_index
+	//               is set to it, reduced to start at 0 instead
+	//               of 1.  Negative indexes count back from the
+	//               end of the list, so -1 is the last element.
+	//               Otherwise, r_index is not changed.
+	//
+	bool readIndex (const char* a_str,
+	                ObjModel::Index count,
+	                ObjModel::Index& r_index)
+	{
+		assert(a_str != NULL);
+
+		// stops at the first non-digit, such as a slash
+		long long value = atoll(a_str);
+		if(value < 0)
+		{
+			// written this way so LLONG_MIN does not overflow
+			unsigned long long back = (unsigned long long)(-(value + 1)) + 1;
+			if(back > count)
+				return false;
+			r_index = (ObjModel::Index)(count - back);
+			return true;
+		}
+		else if(value > 0)
+		{
+			// the largest index is reserved for NO_NORMAL and
+			//   NO_TEXTURE_COORDINATES
+			if((unsigned long long)(value - 1) >= ObjModel::NO_NORMAL)
+				return false;
+			r_index = (ObjModel::Index)(value - 1);
+			return true;
+		}
+		else
+			return false;
+	}
+
+	//
+	//  BINARY_BLOCK_SIZE
+	//
+	//  The number of elements read together from a binary model
+	//    file.
+	//
+	const unsigned int BINARY_BLOCK_SIZE = 65536;
+
+	//
+	//  readBinaryValue
+	//  readBinaryString
+	//
+	//  Purpose: To read a value from a binary model file.
+	//  Parameter(s):
+	//    <1> r_input: The file to read from
+	//    <2> r_value: The value to read into
+	//    <2> remaining: The number of bytes left in r_input
+	//    <3> r_str: The string to read into
+	//  Precondition(s): N/A
+	//  Returns: Whether there were enough bytes left.
+	//  Side Effect: The value is read from r_input.  A string is
+	//               read as its length followed by its
+	//               characters.  The length is checked against
+	//               remaining before the string is resized, so
+	//               a corrupt length does not allocate memory.
+	//
+	template <typename T>
+	bool readBinaryValue (istream& r_input, T& r_value)
+	{
+		r_input.read((char*)(&r_value), sizeof(T));
+		return r_input.gcount() == (streamsize)(sizeof(T));
+	}
+	bool readBinaryString (istream& r_input,
+	                       unsigned long long remaining,
+	                       string& r_str)
+	{
+		unsigned int length;
+		if(remaining < sizeof(length) ||
+		   !readBinaryValue(r_input, length) ||
+		   length > remaining - sizeof(length))
+		{
+			return false;
+		}
+		r_str.resize(length);
+		if(length == 0)
+			return true;
+		r_input.read(&(r_str[0]), length);
+		return r_input.gcount() == (streamsize)(length);
+	}
+
+	//
+	//  readBinaryArray
+	//
+	//  Purpose: To read an array of elements from a binary model
+	//           file.
+	//  Parameter(s):
+	//    <1> r_input: The file to read from
+	//    <2> count: The number of elements
+	//    <3> rv_buffer: The buffer to read each block into
+	//    <4> add: The function to call for each element
+	//  Precondition(s):
+	//    <1> add
+	//  Returns: Whether all the elements could be read.
+	//  Side Effect: The elements are read in blocks of
+	//               BINARY_BLOCK_SIZE and add is called for each
+	//               one in order.
+	//
+	template <typename T>
+	bool readBinaryArray (istream& r_input,
+	                      unsigned long long count,
+	                      vector<T>& rv_buffer,
+	                      const function<void (const T&)>& add)
+	{
+		assert(add);
+
+		for(unsigned long long done = 0; done < count; )
+		{
+			size_t block = (size_t)(min<unsigned long long>(count - done, BINARY_BLOCK_SIZE));
+			rv_buffer.resize(block);
+			r_input.read((char*)(rv_buffer.data()), block * sizeof(T));
+			if(r_input.gcount() != (streamsize)(block * sizeof(T)))
+				return false;
+			for(size_t i = 0; i < block; i++)
+				add(rv_buffer[i]);
+			done += block;
+		}
+		return true;
+	}
+
+	//
+	//  getRemainingSize
+	//
+	//  Purpose: To determine how many bytes are left in a
+	//           binary model file.
+	//  Parameter(s):
+	//    <1> r_input: The file
+	//    <2> r_remaining: The number of bytes left
+	//  Precondition(s): N/A
+	//  Returns: Whether the size could be determined.
+	//  Side Effect: If the size could be determined, r_remaining
+	//               is set to it.  The read position of r_input
+	//               is not changed.
+	//
+	bool getRemainingSize (istream& r_input,
+	                       unsigned long long& r_remaining)
+	{
+		streamoff start = r_input.tellg();
+		if(start < 0 || !r_input.seekg(0, ios::end))
+			return false;
+		streamoff end = r_input.tellg();
+		if(end < start || !r_input.seekg(start, ios::beg))
+			return false;
+
+		r_remaining = (unsigned long long)(end - start);
+		return true;
+	}
+
+	//
+	//  isBinaryArrayPresent
+	//
+	//  Purpose: To determine if an array of elements fits in the
+	//           rest of a binary model file.
+	//  Parameter(s):
+	//    <1> count: The number of elements
+	//    <2> element_size: The size of each element in bytes
+	//    <3> r_remaining: The number of bytes left
+	//  Precondition(s):
+	//    <1> element_size > 0
+	//  Returns: Whether count elements of element_size bytes fit
+	//           in r_remaining bytes.
+	//  Side Effect: If the elements fit, their size is
+	//               subtracted from r_remaining.  Otherwise,
+	//               r_remaining is not changed.
+	//
+	bool isBinaryArrayPresent (unsigned long long count,
+	                           size_t element_size,
+	                           unsigned long long& r_remaining)
+	{
+		assert(element_size > 0);
+
+		// written this way so the multiplication cannot overflow
+		if(count > r_remaining / element_size)
+			return false;
+		r_remaining -= count * element_size;
+		return true;
+	}
+
+	//
+	//  BinaryVertex
+	//  BinaryTextureCoordinate
+	//
+	//  Records with the layout of a vertex or normal and a
+	//    texture coordinate pair in a binary model file.
+	//
+	struct BinaryVertex
+	{
+		double ma_values[3];
+	};
+	struct BinaryTextureCoordinate
+	{
+		double ma_values[2];
+	};
+
+	//
+	//  SAVE_CHUNK_SIZE
+	//
+	//  The number of elements formatted together into one
+	//    buffer and written with a single call when saving.
+	//
+	const unsigned int SAVE_CHUNK_SIZE = 16384;
+
+	//
+	//  SAVE_CHUNKS_PER_THREAD
+	//
+	//  The number of chunks formatted by each thread before
+	//    they are written.  More than one balances the load.
+	//
+	const unsigned int SAVE_CHUNKS_PER_THREAD = 2;
+
+	//
+	//  g_save_thread_count
+	//
+	//  The maximum number of threads used to save, or 0 to use
+	//    the default.
+	//
+	atomic<unsigned int> g_save_thread_count(0);
+
+	//
+	//  writeChunks
+	//
+	//  Purpose: To format a list of elements as text and write
+	//           it to a file.
+	//  Parameter(s):
+	//    <1> r_output: The file to write to
+	//    <2> count: The number of elements
+	//    <3> thread_count: The maximum number of threads to
+	//                      format the elements with
+	//    <4> rv_chunks: The buffers to format into
+	//    <5> format: The function to append the text for
+	//                elements [begin, end) to a string
+	//  Precondition(s):
+	//    <1> r_output.is_open()
+	//    <2> thread_count >= 1
+	//    <3> !rv_chunks.empty()
+	//    <4> format
+	//  Returns: N/A
+	//  Side Effect: The elements are formatted in chunks of
+	//               SAVE_CHUNK_SIZE, in batches of
+	//               rv_chunks.size() chunks split across the
+	//               shared JobSystem.  Each chunk is then written
+	//               to r_output with a single call, in order.
+	//
+	void writeChunks (ofstream& r_output,
+	                  ObjModel::Index count,
+	                  unsigned int thread_count,
+	                  vector<string>& rv_chunks,
+	                  const function<void (string&, ObjModel::Index, ObjModel::Index)>& format)
+	{
+		assert(r_output.is_open());
+		assert(thread_count >= 1);
+		assert(!rv_chunks.empty());
+		assert(format);
+
+		ObjModel::Index batch_size = rv_chunks.size() * SAVE_CHUNK_SIZE;
+		for(ObjModel::Index batch = 0; batch < count; batch += batch_size)
+		{
+			ObjModel::Index batch_end = min(count, batch + batch_size);
+			unsigned int chunk_count = (unsigned int)((batch_end - batch + SAVE_CHUNK_SIZE - 1) / SAVE_CHUNK_SIZE);
+			JobSystem::getShared().parallelFor(chunk_count, 1, thread_count,
+				[&rv_chunks, &format, batch, batch_end] (unsigned int begin, unsigned int end)
+				{
+					for(unsigned int c = begin; c < end; c++)
+					{
+						ObjModel::Index first = batch + (ObjModel::Index)(c) * SAVE_CHUNK_SIZE;
+						rv_chunks[c].clear();
+						format(rv_chunks[c], first, min(batch_end, first + SAVE_CHUNK_SIZE));
+					}
+				});
+
+			for(unsigned int c = 0; c < chunk_count; c++)
+				r_output.write(rv_chunks[c].data(), rv_chunks[c].size());
+		}
+	}
 }
 
 
 
-const unsigned int ObjModel :: NO_TEXTURE_COORDINATES = 0xFFFFFFFF;
-const unsigned int ObjModel :: NO_NORMAL = 0xFFFFFFFF;
+const ObjModel::Index ObjModel :: NO_TEXTURE_COORDINATES = ~ObjModel::Index(0);
+const ObjModel::Index ObjModel :: NO_NORMAL = ~ObjModel::Index(0);
 
 
 
@@ -97,36 +485,30 @@ void ObjModel :: loadAllTextures ()
 
 
 ObjModel :: ObjModel ()
-		: mv_material_libraries(),
-		  mv_vertexes(),
-		  mv_texture_coordinates(),
-		  mv_normals(),
-		  mv_meshes()
+		: mp_geometry(getEmptyGeometry())
 {
-	m_file_name         = DEFAULT_FILE_NAME;
-	m_file_path         = DEFAULT_FILE_PATH;
-	m_file_load_success = true;
-	m_valid             = true;
+	m_file_name           = DEFAULT_FILE_NAME;
+	m_file_path           = DEFAULT_FILE_PATH;
+	m_file_load_success   = true;
+	m_is_references_valid = true;
+	m_short_element_count = 0;
 
 	assert(isEmpty());
 	assert(invariant());
 }
 
 ObjModel :: ObjModel (const string& filename)
-		: mv_material_libraries(),
-		  mv_vertexes(),
-		  mv_texture_coordinates(),
-		  mv_normals(),
-		  mv_meshes()
+		: mp_geometry(make_shared<Geometry>())
 {
 	assert(filename != "");
 	assert(filename.find_last_of("/\\") == string::npos ||
 	       filename.find_last_of("/\\") + 1 < filename.size());
 
-	m_file_name         = DEFAULT_FILE_NAME;
-	m_file_path         = DEFAULT_FILE_PATH;
-	m_file_load_success = true;
-	m_valid             = true;
+	m_file_name           = DEFAULT_FILE_NAME;
+	m_file_path           = DEFAULT_FILE_PATH;
+	m_file_load_success   = true;
+	m_is_references_valid = true;
+	m_short_element_count = 0;
 
 	load(filename);
 	// load calls validate()
@@ -135,11 +517,7 @@ ObjModel :: ObjModel (const string& filename)
 }
 
 ObjModel :: ObjModel (const string& filename, const string& logfile)
-		: mv_material_libraries(),
-		  mv_vertexes(),
-		  mv_texture_coordinates(),
-		  mv_normals(),
-		  mv_meshes()
+		: mp_geometry(make_shared<Geometry>())
 {
 	assert(filename != "");
 	assert(filename.find_last_of("/\\") == string::npos ||
@@ -148,10 +526,11 @@ ObjModel :: ObjModel (const string& filename, const string& logfile)
 	assert(logfile.find_last_of("/\\") == string::npos ||
 	       logfile.find_last_of("/\\") + 1 < logfile.size());
 
-	m_file_name         = DEFAULT_FILE_NAME;
-	m_file_path         = DEFAULT_FILE_PATH;
-	m_file_load_success = true;
-	m_valid             = true;
+	m_file_name           = DEFAULT_FILE_NAME;
+	m_file_path           = DEFAULT_FILE_PATH;
+	m_file_load_success   = true;
+	m_is_references_valid = true;
+	m_short_element_count = 0;
 
 	load(filename, logfile);
 	// load calls validate()
@@ -160,20 +539,17 @@ ObjModel :: ObjModel (const string& filename, const string& logfile)
 }
 
 ObjModel :: ObjModel (const string& filename, ostream& r_logstream)
-		: mv_material_libraries(),
-		  mv_vertexes(),
-		  mv_texture_coordinates(),
-		  mv_normals(),
-		  mv_meshes()
+		: mp_geometry(make_shared<Geometry>())
 {
 	assert(filename != "");
 	assert(filename.find_last_of("/\\") == string::npos ||
 	       filename.find_last_of("/\\") + 1 < filename.size());
 
-	m_file_name         = DEFAULT_FILE_NAME;
-	m_file_path         = DEFAULT_FILE_PATH;
-	m_file_load_success = true;
-	m_valid             = true;
+	m_file_name           = DEFAULT_FILE_NAME;
+	m_file_path           = DEFAULT_FILE_PATH;
+	m_file_load_success   = true;
+	m_is_references_valid = true;
+	m_short_element_count = 0;
 
 	load(filename, r_logstream);
 	// load calls validate()
@@ -182,16 +558,27 @@ ObjModel :: ObjModel (const string& filename, ostream& r_logstream)
 }
 
 ObjModel :: ObjModel (const ObjModel& original)
-		: mv_material_libraries(original.mv_material_libraries),
-		  mv_vertexes(original.mv_vertexes),
-		  mv_texture_coordinates(original.mv_texture_coordinates),
-		  mv_normals(original.mv_normals),
-		  mv_meshes(original.mv_meshes)
+		: mp_geometry(original.mp_geometry)
 {
-	m_file_name         = original.m_file_name;
-	m_file_path         = original.m_file_path;
-	m_file_load_success = original.m_file_load_success;
-	m_valid             = original.m_valid;
+	m_file_name           = original.m_file_name;
+	m_file_path           = original.m_file_path;
+	m_file_load_success   = original.m_file_load_success;
+	m_is_references_valid = original.m_is_references_valid;
+	m_short_element_count = original.m_short_element_count;
+
+	assert(invariant());
+}
+
+ObjModel :: ObjModel (ObjModel&& original) noexcept
+		: mp_geometry(move(original.mp_geometry)),
+		  m_file_name(move(original.m_file_name)),
+		  m_file_path(move(original.m_file_path))
+{
+	m_file_load_success   = original.m_file_load_success;
+	m_is_references_valid = original.m_is_references_valid;
+	m_short_element_count = original.m_short_element_count;
+
+	original.makeEmpty();
 
 	assert(invariant());
 }
@@ -200,16 +587,32 @@ ObjModel& ObjModel :: operator= (const ObjModel& original)
 {
 	if(&original != this)
 	{
-		mv_material_libraries = original.mv_material_libraries;
-		mv_vertexes = original.mv_vertexes;
-		mv_texture_coordinates = original.mv_texture_coordinates;
-		mv_normals = original.mv_normals;
-		mv_meshes = original.mv_meshes;
+		mp_geometry = original.mp_geometry;
+
+		m_file_name           = original.m_file_name;
+		m_file_path           = original.m_file_path;
+		m_file_load_success   = original.m_file_load_success;
+		m_is_references_valid = original.m_is_references_valid;
+		m_short_element_count = original.m_short_element_count;
+	}
+
+	assert(invariant());
+	return *this;
+}
+
+ObjModel& ObjModel :: operator= (ObjModel&& original) noexcept
+{
+	if(&original != this)
+	{
+		mp_geometry = move(original.mp_geometry);
 
-		m_file_name         = original.m_file_name;
-		m_file_path         = original.m_file_path;
-		m_file_load_success = original.m_file_load_success;
-		m_valid             = original.m_valid;
+		m_file_name           = move(original.m_file_name);
+		m_file_path           = move(original.m_file_path);
+		m_file_load_success   = original.m_file_load_success;
+		m_is_references_valid = original.m_is_references_valid;
+		m_short_element_count = original.m_short_element_count;
+
+		original.makeEmpty();
 	}
 
 	assert(invariant());
@@ -244,221 +647,232 @@ bool ObjModel :: isLoadedSuccessfully () const
 
 bool ObjModel :: isEmpty () const
 {
-	if(!mv_material_libraries.empty()) return false;
-	if(!mv_vertexes.empty()) return false;
-	if(!mv_texture_coordinates.empty()) return false;
-	if(!mv_normals.empty()) return false;
-	if(!mv_meshes.empty()) return false;
+	if(!mp_geometry->mv_material_libraries.empty()) return false;
+	if(!mp_geometry->mv_vertexes.empty()) return false;
+	if(!mp_geometry->mv_texture_coordinates.empty()) return false;
+	if(!mp_geometry->mv_normals.empty()) return false;
+	if(!mp_geometry->mv_meshes.empty()) return false;
 	return true;
 }
 
 unsigned int ObjModel :: getMaterialLibraryCount () const
 {
-	return mv_material_libraries.size();
+	return mp_geometry->mv_material_libraries.size();
 }
 
 bool ObjModel :: isSingleMaterialLibrary () const
 {
-	return (mv_material_libraries.size() == 1);
+	return (mp_geometry->mv_material_libraries.size() == 1);
 }
 
 const string& ObjModel :: getMaterialLibraryName (unsigned int library) const
 {
 	assert(library < getMaterialLibraryCount());
 
-	assert(library < mv_material_libraries.size());
-	return mv_material_libraries[library].m_file_name;
+	assert(library < mp_geometry->mv_material_libraries.size());
+	return mp_geometry->mv_material_libraries[library].m_file_name;
 }
 
 string ObjModel :: getMaterialLibraryPath (unsigned int library) const
 {
 	assert(library < getMaterialLibraryCount());
 
-	assert(library < mv_material_libraries.size());
-	if(mv_material_libraries[library].mp_mtl_library == NULL)
+	assert(library < mp_geometry->mv_material_libraries.size());
+	if(mp_geometry->mv_material_libraries[library].mp_mtl_library == NULL)
 	{
 		//  CAN THIS HAPPEN?  <|>
 		return "";
 	}
 
-	assert(mv_material_libraries[library].mp_mtl_library != NULL);
-	return mv_material_libraries[library].mp_mtl_library->getFileNameWithPath();
+	assert(mp_geometry->mv_material_libraries[library].mp_mtl_library != NULL);
+	return mp_geometry->mv_material_libraries[library].mp_mtl_library->getFileNameWithPath();
 }
 
 string ObjModel :: getMaterialLibraryNameWithPath (unsigned int library) const
 {
 	assert(library < getMaterialLibraryCount());
 
-	assert(library < mv_material_libraries.size());
-	if(mv_material_libraries[library].mp_mtl_library == NULL)
+	assert(library < mp_geometry->mv_material_libraries.size());
+	if(mp_geometry->mv_material_libraries[library].mp_mtl_library == NULL)
 	{
 		//  CAN THIS HAPPEN?  <|>
-		return mv_material_libraries[library].m_file_name;
+		return mp_geometry->mv_material_libraries[library].m_file_name;
 	}
 
-	assert(mv_material_libraries[library].mp_mtl_library != NULL);
-	return mv_material_libraries[library].mp_mtl_library->getFileNameWithPath();
+	assert(mp_geometry->mv_material_libraries[library].mp_mtl_library != NULL);
+	return mp_geometry->mv_material_libraries[library].mp_mtl_library->getFileNameWithPath();
 }
 
 const MtlLibrary* ObjModel :: getMaterialLibrary (unsigned int library) const
 {
 	assert(library < getMaterialLibraryCount());
 
-	assert(library < mv_material_libraries.size());
-	assert(mv_material_libraries[library].mp_mtl_library != NULL);  //  CAN THIS HAPPEN?  <|>
-	return mv_material_libraries[library].mp_mtl_library;
+	assert(library < mp_geometry->mv_material_libraries.size());
+	assert(mp_geometry->mv_material_libraries[library].mp_mtl_library != NULL);  //  CAN THIS HAPPEN?  <|>
+	return mp_geometry->mv_material_libraries[library].mp_mtl_library;
 }
 
 const string& ObjModel :: getSingleMaterialLibraryName () const
 {
 	assert(isSingleMaterialLibrary());
 
-	assert(mv_material_libraries.size() >= 1);
-	return mv_material_libraries[0].m_file_name;
+	assert(mp_geometry->mv_material_libraries.size() >= 1);
+	return mp_geometry->mv_material_libraries[0].m_file_name;
 }
 
 string ObjModel :: getSingleMaterialLibraryPath () const
 {
 	assert(isSingleMaterialLibrary());
 
-	assert(mv_material_libraries.size() >= 1);
-	if(mv_material_libraries[0].mp_mtl_library == NULL)
+	assert(mp_geometry->mv_material_libraries.size() >= 1);
+	if(mp_geometry->mv_material_libraries[0].mp_mtl_library == NULL)
 	{
 		//  CAN THIS HAPPEN?  <|>
 		return "";
 	}
 
-	assert(mv_material_libraries[0].mp_mtl_library != NULL);
-	return mv_material_libraries[0].m_file_name;
+	assert(mp_geometry->mv_material_libraries[0].mp_mtl_library != NULL);
+	return mp_geometry->mv_material_libraries[0].m_file_name;
 }
 
 string ObjModel :: getSingleMaterialLibraryNameWithPath () const
 {
 	assert(isSingleMaterialLibrary());
 
-	assert(mv_material_libraries.size() >= 1);
-	if(mv_material_libraries[0].mp_mtl_library == NULL)
+	assert(mp_geometry->mv_material_libraries.size() >= 1);
+	if(mp_geometry->mv_material_libraries[0].mp_mtl_library == NULL)
 	{
 		//  CAN THIS HAPPEN?  <|>
-		return mv_material_libraries[0].m_file_name;
+		return mp_geometry->mv_material_libraries[0].m_file_name;
 	}
 
-	assert(mv_material_libraries[0].mp_mtl_library != NULL);
-	return mv_material_libraries[0].mp_mtl_library->getFileNameWithPath();
+	assert(mp_geometry->mv_material_libraries[0].mp_mtl_library != NULL);
+	return mp_geometry->mv_material_libraries[0].mp_mtl_library->getFileNameWithPath();
 }
 
 const MtlLibrary* ObjModel :: getSingleMaterialLibrary () const
 {
 	assert(isSingleMaterialLibrary());
 
-	assert(mv_material_libraries.size() >= 1);
-	assert(mv_material_libraries[0].mp_mtl_library != NULL);  //  CAN THIS HAPPEN?  <|>
-	return mv_material_libraries[0].mp_mtl_library;
+	assert(mp_geometry->mv_material_libraries.size() >= 1);
+	assert(mp_geometry->mv_material_libraries[0].mp_mtl_library != NULL);  //  CAN THIS HAPPEN?  <|>
+	return mp_geometry->mv_material_libraries[0].mp_mtl_library;
 }
 
-unsigned int ObjModel :: getVertexCount () const
+ObjModel::Index ObjModel :: getVertexCount () const
 {
-	return mv_vertexes.size();
+	return mp_geometry->mv_vertexes.size();
 }
 
-double ObjModel :: getVertexX (unsigned int vertex) const
+double ObjModel :: getVertexX (Index vertex) const
 {
 	assert(vertex < getVertexCount());
 
-	return mv_vertexes[vertex].x;
+	return mp_geometry->mv_vertexes[vertex].x;
 }
 
-double ObjModel :: getVertexY (unsigned int vertex) const
+double ObjModel :: getVertexY (Index vertex) const
 {
 	assert(vertex < getVertexCount());
 
-	return mv_vertexes[vertex].y;
+	return mp_geometry->mv_vertexes[vertex].y;
 }
 
-double ObjModel :: getVertexZ (unsigned int vertex) const
+double ObjModel :: getVertexZ (Index vertex) const
 {
 	assert(vertex < getVertexCount());
 
-	return mv_vertexes[vertex].z;
+	return mp_geometry->mv_vertexes[vertex].z;
 }
 
-const Vector3& ObjModel :: getVertexPosition (unsigned int vertex) const
+const Vector3& ObjModel :: getVertexPosition (Index vertex) const
 {
 	assert(vertex < getVertexCount());
 
-	return mv_vertexes[vertex];
+	return mp_geometry->mv_vertexes[vertex];
+}
+
+Vector3 ObjModel :: getBoundingBoxMin () const
+{
+	updateBoundingBox();
+	return mp_geometry->m_bounding_box_min;
 }
 
+Vector3 ObjModel :: getBoundingBoxMax () const
+{
+	updateBoundingBox();
+	return mp_geometry->m_bounding_box_max;
+}
 
-unsigned int ObjModel :: getTextureCoordinateCount () const
+ObjModel::Index ObjModel :: getTextureCoordinateCount () const
 {
-	return mv_texture_coordinates.size();
+	return mp_geometry->mv_texture_coordinates.size();
 }
 
-double ObjModel :: getTextureCoordinateU (unsigned int texture_coordinate) const
+double ObjModel :: getTextureCoordinateU (Index texture_coordinate) const
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	return mv_texture_coordinates[texture_coordinate].x;
+	return mp_geometry->mv_texture_coordinates[texture_coordinate].x;
 }
 
-double ObjModel :: getTextureCoordinateV (unsigned int texture_coordinate) const
+double ObjModel :: getTextureCoordinateV (Index texture_coordinate) const
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	return mv_texture_coordinates[texture_coordinate].y;
+	return mp_geometry->mv_texture_coordinates[texture_coordinate].y;
 }
 
-const Vector2& ObjModel :: getTextureCoordinate (unsigned int texture_coordinate) const
+const Vector2& ObjModel :: getTextureCoordinate (Index texture_coordinate) const
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	return mv_texture_coordinates[texture_coordinate];
+	return mp_geometry->mv_texture_coordinates[texture_coordinate];
 }
 
-unsigned int ObjModel :: getNormalCount () const
+ObjModel::Index ObjModel :: getNormalCount () const
 {
-	return mv_normals.size();
+	return mp_geometry->mv_normals.size();
 }
 
-double ObjModel :: getNormalX (unsigned int normal) const
+double ObjModel :: getNormalX (Index normal) const
 {
 	assert(normal < getNormalCount());
 
-	return mv_normals[normal].x;
+	return mp_geometry->mv_normals[normal].x;
 }
 
-double ObjModel :: getNormalY (unsigned int normal) const
+double ObjModel :: getNormalY (Index normal) const
 {
 	assert(normal < getNormalCount());
 
-	return mv_normals[normal].y;
+	return mp_geometry->mv_normals[normal].y;
 }
 
-double ObjModel :: getNormalZ (unsigned int normal) const
+double ObjModel :: getNormalZ (Index normal) const
 {
 	assert(normal < getNormalCount());
 
-	return mv_normals[normal].z;
+	return mp_geometry->mv_normals[normal].z;
 }
 
-const Vector3& ObjModel :: getNormalVector (unsigned int normal) const
+const Vector3& ObjModel :: getNormalVector (Index normal) const
 {
 	assert(normal < getNormalCount());
 
-	return mv_normals[normal];
+	return mp_geometry->mv_normals[normal];
 }
 
 unsigned int ObjModel :: getMeshCount () const
 {
-	return mv_meshes.size();
+	return mp_geometry->mv_meshes.size();
 }
 
 bool ObjModel :: isMeshMaterial (unsigned int mesh) const
 {
 	assert(mesh < getMeshCount());
 
-	if(mv_meshes[mesh].m_material_name != "")
+	if(mp_geometry->mv_meshes[mesh].m_material_name != "")
 		return true;
 	else
 		return false;
@@ -469,8 +883,8 @@ const string& ObjModel :: getMeshMaterialName (unsigned int mesh) const
 	assert(mesh < getMeshCount());
 	assert(isMeshMaterial(mesh));
 
-	assert(mv_meshes[mesh].m_material_name != "");
-	return mv_meshes[mesh].m_material_name;
+	assert(mp_geometry->mv_meshes[mesh].m_material_name != "");
+	return mp_geometry->mv_meshes[mesh].m_material_name;
 }
 
 const Material* ObjModel :: getMeshMaterial (unsigned int mesh) const
@@ -478,15 +892,15 @@ const Material* ObjModel :: getMeshMaterial (unsigned int mesh) const
 	assert(mesh < getMeshCount());
 	assert(isMeshMaterial(mesh));
 
-	assert(mv_meshes[mesh].mp_material != NULL);  //  CAN THIS HAPPEN?  <|>
-	return mv_meshes[mesh].mp_material;
+	assert(mp_geometry->mv_meshes[mesh].mp_material != NULL);  //  CAN THIS HAPPEN?  <|>
+	return mp_geometry->mv_meshes[mesh].mp_material;
 }
 
 unsigned int ObjModel :: getPointSetCount (unsigned int mesh) const
 {
 	assert(mesh < getMeshCount());
 
-	return mv_meshes[mesh].mv_point_sets.size();
+	return mp_geometry->mv_meshes[mesh].mv_point_sets.size();
 }
 
 unsigned int ObjModel :: getPointSetVertexCount (unsigned int mesh, unsigned int point_set) const
@@ -494,23 +908,23 @@ unsigned int ObjModel :: getPointSetVertexCount (unsigned int mesh, unsigned int
 	assert(mesh < getMeshCount());
 	assert(point_set < getPointSetCount(mesh));
 
-	return mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes.size();
+	return mp_geometry->mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes.size();
 }
 
-unsigned int ObjModel :: getPointSetVertexIndex (unsigned int mesh, unsigned int point_set, unsigned int vertex) const
+ObjModel::Index ObjModel :: getPointSetVertexIndex (unsigned int mesh, unsigned int point_set, unsigned int vertex) const
 {
 	assert(mesh < getMeshCount());
 	assert(point_set < getPointSetCount(mesh));
 	assert(vertex < getPointSetVertexCount(mesh, point_set));
 
-	return mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes[vertex];
+	return mp_geometry->mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes[vertex];
 }
 
 unsigned int ObjModel :: getPolylineCount (unsigned int mesh) const
 {
 	assert(mesh < getMeshCount());
 
-	return mv_meshes[mesh].mv_polylines.size();
+	return mp_geometry->mv_meshes[mesh].mv_polylines.size();
 }
 
 unsigned int ObjModel :: getPolylineVertexCount (unsigned int mesh, unsigned int polyline) const
@@ -518,25 +932,25 @@ unsigned int ObjModel :: getPolylineVertexCount (unsigned int mesh, unsigned int
 	assert(mesh < getMeshCount());
 	assert(polyline < getPolylineCount(mesh));
 
-	return mv_meshes[mesh].mv_polylines[polyline].mv_vertexes.size();
+	return mp_geometry->mv_meshes[mesh].mv_polylines[polyline].mv_vertexes.size();
 }
 
-unsigned int ObjModel :: getPolylineVertexIndex (unsigned int mesh, unsigned int polyline, unsigned int vertex) const
+ObjModel::Index ObjModel :: getPolylineVertexIndex (unsigned int mesh, unsigned int polyline, unsigned int vertex) const
 {
 	assert(mesh < getMeshCount());
 	assert(polyline < getPolylineCount(mesh));
 	assert(vertex < getPolylineVertexCount(mesh, polyline));
 
-	return mv_meshes[mesh].mv_polylines[polyline].mv_vertexes[vertex].m_vertex;
+	return mp_geometry->mv_meshes[mesh].mv_polylines[polyline].mv_vertexes[vertex].m_vertex;
 }
 
-unsigned int ObjModel :: getPolylineVertexTextureCoordinates (unsigned int mesh, unsigned int polyline, unsigned int vertex) const
+ObjModel::Index ObjModel :: getPolylineVertexTextureCoordinates (unsigned int mesh, unsigned int polyline, unsigned int vertex) const
 {
 	assert(mesh < getMeshCount());
 	assert(polyline < getPolylineCount(mesh));
 	assert(vertex < getPolylineVertexCount(mesh, polyline));
 
-	return mv_meshes[mesh].mv_polylines[polyline].mv_vertexes[vertex].m_texture_coordinate;
+	return mp_geometry->mv_meshes[mesh].mv_polylines[polyline].mv_vertexes[vertex].m_texture_coordinate;
 }
 
 bool ObjModel :: isPolylineTextureCoordinatesAny (unsigned int mesh, unsigned int polyline) const
@@ -544,7 +958,7 @@ bool ObjModel :: isPolylineTextureCoordinatesAny (unsigned int mesh, unsigned in
 	assert(mesh < getMeshCount());
 	assert(polyline < getPolylineCount(mesh));
 
-	const vector<PolylineVertex>& v_vertexes = mv_meshes[mesh].mv_polylines[polyline].mv_vertexes;
+	const vector<PolylineVertex>& v_vertexes = mp_geometry->mv_meshes[mesh].mv_polylines[polyline].mv_vertexes;
 	for(unsigned int i = 0; i < v_vertexes.size(); i++)
 		if(v_vertexes[i].m_texture_coordinate != NO_TEXTURE_COORDINATES)
 			return true;
@@ -555,7 +969,7 @@ unsigned int ObjModel :: getFaceCount (unsigned int mesh) const
 {
 	assert(mesh < getMeshCount());
 
-	return mv_meshes[mesh].mv_faces.size();
+	return mp_geometry->mv_meshes[mesh].mv_faces.size();
 }
 
 unsigned int ObjModel :: getFaceVertexCount (unsigned int mesh, unsigned int face) const
@@ -563,34 +977,34 @@ unsigned int ObjModel :: getFaceVertexCount (unsigned int mesh, unsigned int fac
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 
-	return mv_meshes[mesh].mv_faces[face].mv_vertexes.size();
+	return mp_geometry->mv_meshes[mesh].mv_faces[face].mv_vertexes.size();
 }
 
-unsigned int ObjModel :: getFaceVertexIndex (unsigned int mesh, unsigned int face, unsigned int vertex) const
+ObjModel::Index ObjModel :: getFaceVertexIndex (unsigned int mesh, unsigned int face, unsigned int vertex) const
 {
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	return mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_vertex;
+	return mp_geometry->mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_vertex;
 }
 
-unsigned int ObjModel :: getFaceVertexTextureCoordinates (unsigned int mesh, unsigned int face, unsigned int vertex) const
+ObjModel::Index ObjModel :: getFaceVertexTextureCoordinates (unsigned int mesh, unsigned int face, unsigned int vertex) const
 {
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	return mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_texture_coordinate;
+	return mp_geometry->mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_texture_coordinate;
 }
 
-unsigned int ObjModel :: getFaceVertexNormal (unsigned int mesh, unsigned int face, unsigned int vertex) const
+ObjModel::Index ObjModel :: getFaceVertexNormal (unsigned int mesh, unsigned int face, unsigned int vertex) const
 {
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	return mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_normal;
+	return mp_geometry->mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_normal;
 }
 
 bool ObjModel :: isFaceTextureCoordinatesAny (unsigned int mesh, unsigned int face) const
@@ -598,7 +1012,7 @@ bool ObjModel :: isFaceTextureCoordinatesAny (unsigned int mesh, unsigned int fa
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 
-	const vector<FaceVertex>& v_vertexes = mv_meshes[mesh].mv_faces[face].mv_vertexes;
+	const vector<FaceVertex>& v_vertexes = mp_geometry->mv_meshes[mesh].mv_faces[face].mv_vertexes;
 	for(unsigned int i = 0; i < v_vertexes.size(); i++)
 		if(v_vertexes[i].m_texture_coordinate != NO_TEXTURE_COORDINATES)
 			return true;
@@ -610,7 +1024,7 @@ bool ObjModel :: isFaceNormalAny (unsigned int mesh, unsigned int face) const
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 
-	const vector<FaceVertex>& v_vertexes = mv_meshes[mesh].mv_faces[face].mv_vertexes;
+	const vector<FaceVertex>& v_vertexes = mp_geometry->mv_meshes[mesh].mv_faces[face].mv_vertexes;
 	for(unsigned int i = 0; i < v_vertexes.size(); i++)
 		if(v_vertexes[i].m_normal != NO_NORMAL)
 			return true;
@@ -621,14 +1035,14 @@ bool ObjModel :: isMeshAllTriangles (unsigned int mesh) const
 {
 	assert(mesh < getMeshCount());
 
-	return mv_meshes[mesh].m_all_triangles;
+	return mp_geometry->mv_meshes[mesh].m_all_triangles;
 }
 
 bool ObjModel :: isMeshTextureCoordinatesAny (unsigned int mesh) const
 {
 	assert(mesh < getMeshCount());
 
-	const vector<Face>& v_faces = mv_meshes[mesh].mv_faces;
+	const vector<Face>& v_faces = mp_geometry->mv_meshes[mesh].mv_faces;
 	for(unsigned int f = 0; f < v_faces.size(); f++)
 	{
 		const vector<FaceVertex>& v_vertexes = v_faces[f].mv_vertexes;
@@ -643,7 +1057,7 @@ bool ObjModel :: isMeshNormalAny (unsigned int mesh) const
 {
 	assert(mesh < getMeshCount());
 
-	const vector<Face>& v_faces = mv_meshes[mesh].mv_faces;
+	const vector<Face>& v_faces = mp_geometry->mv_meshes[mesh].mv_faces;
 	for(unsigned int f = 0; f < v_faces.size(); f++)
 	{
 		const vector<FaceVertex>& v_vertexes = v_faces[f].mv_vertexes;
@@ -660,7 +1074,7 @@ unsigned int ObjModel :: getMeshPointCountTotal (unsigned int mesh) const
 
 	unsigned int total = 0;
 
-	const vector<PointSet>& v_point_sets = mv_meshes[mesh].mv_point_sets;
+	const vector<PointSet>& v_point_sets = mp_geometry->mv_meshes[mesh].mv_point_sets;
 	for(unsigned int i = 0; i < v_point_sets.size(); i++)
 		total += v_point_sets[i].mv_vertexes.size();
 	return total;
@@ -670,8 +1084,8 @@ unsigned int ObjModel :: getPointSetCountTotal () const
 {
 	unsigned int total = 0;
 
-	for(unsigned int i = 0; i < mv_meshes.size(); i++)
-		total += mv_meshes[i].mv_point_sets.size();
+	for(unsigned int i = 0; i < mp_geometry->mv_meshes.size(); i++)
+		total += mp_geometry->mv_meshes[i].mv_point_sets.size();
 	return total;
 }
 
@@ -679,8 +1093,8 @@ unsigned int ObjModel :: getPolylineCountTotal () const
 {
 	unsigned int total = 0;
 
-	for(unsigned int i = 0; i < mv_meshes.size(); i++)
-		total += mv_meshes[i].mv_polylines.size();
+	for(unsigned int i = 0; i < mp_geometry->mv_meshes.size(); i++)
+		total += mp_geometry->mv_meshes[i].mv_polylines.size();
 	return total;
 }
 
@@ -688,31 +1102,31 @@ unsigned int ObjModel :: getFaceCountTotal () const
 {
 	unsigned int total = 0;
 
-	for(unsigned int i = 0; i < mv_meshes.size(); i++)
-		total += mv_meshes[i].mv_faces.size();
+	for(unsigned int i = 0; i < mp_geometry->mv_meshes.size(); i++)
+		total += mp_geometry->mv_meshes[i].mv_faces.size();
 	return total;
 }
 
 bool ObjModel :: isAllTriangles () const
 {
-	for(unsigned int m = 0; m < mv_meshes.size(); m++)
-		if(!mv_meshes[m].m_all_triangles)
+	for(unsigned int m = 0; m < mp_geometry->mv_meshes.size(); m++)
+		if(!mp_geometry->mv_meshes[m].m_all_triangles)
 			return false;
 	return true;
 }
 
 bool ObjModel :: isSingleMaterial () const
 {
-	if(mv_meshes.empty())
+	if(mp_geometry->mv_meshes.empty())
 		return false;
 
-	assert(mv_meshes.size() > 0);
-	const string& material_name = mv_meshes[0].m_material_name;
+	assert(mp_geometry->mv_meshes.size() > 0);
+	const string& material_name = mp_geometry->mv_meshes[0].m_material_name;
 	if(material_name == "")
 		return false;
 
-	for(unsigned int i = 1; i < mv_meshes.size(); i++)
-		if(mv_meshes[i].m_material_name != material_name)
+	for(unsigned int i = 1; i < mp_geometry->mv_meshes.size(); i++)
+		if(mp_geometry->mv_meshes[i].m_material_name != material_name)
 			return false;
 	return true;
 }
@@ -721,23 +1135,23 @@ const string& ObjModel :: getSingleMaterialName () const
 {
 	assert(isSingleMaterial());
 
-	assert(mv_meshes.size() > 0);
-	assert(mv_meshes[0].m_material_name != "");  //  CAN THIS HAPPEN?  <|>
-	return mv_meshes[0].m_material_name;
+	assert(mp_geometry->mv_meshes.size() > 0);
+	assert(mp_geometry->mv_meshes[0].m_material_name != "");  //  CAN THIS HAPPEN?  <|>
+	return mp_geometry->mv_meshes[0].m_material_name;
 }
 
 const Material* ObjModel :: getSingleMaterial () const
 {
 	assert(isSingleMaterial());
 
-	assert(mv_meshes.size() > 0);
-	assert(mv_meshes[0].mp_material != NULL);  //  CAN THIS HAPPEN?  <|>
-	return mv_meshes[0].mp_material;
+	assert(mp_geometry->mv_meshes.size() > 0);
+	assert(mp_geometry->mv_meshes[0].mp_material != NULL);  //  CAN THIS HAPPEN?  <|>
+	return mp_geometry->mv_meshes[0].mp_material;
 }
 
 vector<string> ObjModel :: getAllMaterialNames () const
 {
-	unsigned int mesh_count = mv_meshes.size();
+	unsigned int mesh_count = mp_geometry->mv_meshes.size();
 	vector<string> v_names(mesh_count, "");
 
 	for(unsigned int m = 0; m < mesh_count; m++)
@@ -749,7 +1163,7 @@ vector<string> ObjModel :: getAllMaterialNames () const
 
 bool ObjModel :: isValid () const
 {
-	return m_valid;
+	return m_is_references_valid && m_short_element_count == 0;
 }
 
 
@@ -772,29 +1186,29 @@ void ObjModel :: print (const string& logfile) const
 
 void ObjModel :: print (ostream& r_logstream) const
 {
-	if(m_valid)
+	if(isValid())
 		r_logstream << m_file_path << m_file_name << " (valid)" << endl;
 	else
 		r_logstream << m_file_path << m_file_name << " (invalid)" << endl;
 
-	if(mv_material_libraries.size() > 0)
+	if(mp_geometry->mv_material_libraries.size() > 0)
 	{
-		r_logstream << "    " << mv_material_libraries.size() << " material libraries" << endl;
-		for(unsigned int m = 0; m < mv_material_libraries.size(); m++)
-			r_logstream << "        " << mv_material_libraries[m].m_file_name << endl;
+		r_logstream << "    " << mp_geometry->mv_material_libraries.size() << " material libraries" << endl;
+		for(unsigned int m = 0; m < mp_geometry->mv_material_libraries.size(); m++)
+			r_logstream << "        " << mp_geometry->mv_material_libraries[m].m_file_name << endl;
 	}
 
 	r_logstream << "  Vertices: " << getVertexCount() << endl;
-	for(unsigned int v = 0; v < getVertexCount(); v++)
-		r_logstream << "    " << setw(6) << v << ": " << mv_vertexes[v] << endl;
+	for(Index v = 0; v < getVertexCount(); v++)
+		r_logstream << "    " << setw(6) << v << ": " << mp_geometry->mv_vertexes[v] << endl;
 
 	r_logstream << "  Texture Coordinate Pairs: " << getTextureCoordinateCount() << endl;
-	for(unsigned int t = 0; t < getTextureCoordinateCount(); t++)
-		r_logstream << "    " << setw(6) << t << ": (" << mv_texture_coordinates[t].x << ", " << mv_texture_coordinates[t].y << ")" << endl;
+	for(Index t = 0; t < getTextureCoordinateCount(); t++)
+		r_logstream << "    " << setw(6) << t << ": (" << mp_geometry->mv_texture_coordinates[t].x << ", " << mp_geometry->mv_texture_coordinates[t].y << ")" << endl;
 
 	r_logstream << "  Normals: " << getNormalCount() << endl;
-	for(unsigned int n = 0; n < getNormalCount(); n++)
-		r_logstream << "    " << setw(6) << n << ": " << mv_normals[n] << endl;
+	for(Index n = 0; n < getNormalCount(); n++)
+		r_logstream << "    " << setw(6) << n << ": " << mp_geometry->mv_normals[n] << endl;
 
 	r_logstream << "  Meshes: " << getMeshCount() << endl;
 	for(unsigned int m = 0; m < getMeshCount(); m++)
@@ -874,8 +1288,8 @@ void ObjModel :: printMtlLibraries (const string& logfile) const
 void ObjModel :: printMtlLibraries (ostream& r_logstream) const
 {
 	r_logstream << "Libraries referenced by \"" << m_file_path << m_file_name << "\":" << endl;
-	for(unsigned int m = 0; m < mv_material_libraries.size(); m++)
-		r_logstream << "\t\"" << mv_material_libraries[m].m_file_name << "\"" << endl;
+	for(unsigned int m = 0; m < mp_geometry->mv_material_libraries.size(); m++)
+		r_logstream << "\t\"" << mp_geometry->mv_material_libraries[m].m_file_name << "\"" << endl;
 }
 
 void ObjModel :: printBadMaterials () const
@@ -897,10 +1311,10 @@ void ObjModel :: printBadMaterials (const string& logfile) const
 void ObjModel :: printBadMaterials (ostream& r_logstream) const
 {
 	for(unsigned int m = 0; m < getMeshCount(); m++)
-		if(mv_meshes[m].m_material_name != "" && mv_meshes[m].mp_material == NULL)
+		if(mp_geometry->mv_meshes[m].m_material_name != "" && mp_geometry->mv_meshes[m].mp_material == NULL)
 		{
 			r_logstream << "Invalid material referenced in \"" << m_file_path << m_file_name << "\": "
-			     << "\"" << mv_meshes[m].m_material_name << "\"" << endl;
+			     << "\"" << mp_geometry->mv_meshes[m].m_material_name << "\"" << endl;
 		}
 }
 
@@ -913,12 +1327,65 @@ void ObjModel :: draw () const
 	assert(isValid());
 	assert(!Material::isMaterialActive());
 
-	for(unsigned int m = 0; m < getMeshCount(); m++)
-		drawMeshMaterial(m, mv_meshes[m].mp_material);
+	// display lists cannot be nested
+	if(DisplayList::isCompiling())
+	{
+		drawImmediate();
+		return;
+	}
+
+	// the empty geometry is never changed or freed
+	if(mp_geometry == getEmptyGeometry())
+		return;
+
+	if(mp_geometry->m_is_draw_arrays_used)
+	{
+		// the DisplayList is out of date and will not be used
+		if(!mp_geometry->m_draw_list.isEmpty())
+			mp_geometry->m_draw_list.makeEmpty();
+		drawWithArrays();
+		return;
+	}
+
+	if(!mp_geometry->m_is_draw_list_current)
+	{
+		// load textures first so they are not compiled into the list
+		for(unsigned int i = 0; i < mp_geometry->mv_meshes.size(); i++)
+			if(mp_geometry->mv_meshes[i].mp_material != NULL)
+				mp_geometry->mv_meshes[i].mp_material->loadDisplayTextures();
+
+		mp_geometry->m_draw_list.begin();
+			drawImmediate();
+		mp_geometry->m_draw_list.end();
+		mp_geometry->m_is_draw_list_current = true;
+	}
+
+	assert(mp_geometry->m_draw_list.isReady());
+	mp_geometry->m_draw_list.draw();
 
 	assert(!Material::isMaterialActive());
 }
 
+bool ObjModel :: isDrawCacheReady () const
+{
+	if(mp_geometry->m_is_draw_arrays_used)
+	{
+		const DrawArrays& arrays = mp_geometry->m_draw_arrays;
+		return arrays.m_is_built &&
+		       arrays.mv_dirty_vertex_ranges.empty() &&
+		       arrays.mv_dirty_normal_ranges.empty();
+	}
+	else
+		return mp_geometry->m_is_draw_list_current;
+}
+
+void ObjModel :: invalidateDrawCache () const
+{
+	mp_geometry->m_is_draw_list_current = false;
+	mp_geometry->m_is_draw_arrays_used  = false;
+	mp_geometry->m_draw_arrays = DrawArrays();
+}
+
 void ObjModel :: drawMaterialNone () const
 {
 	assert(isValid());
@@ -1060,10 +1527,10 @@ void ObjModel :: drawMtlLibrary (const MtlLibrary& library) const
 	{
 		const Material* p_material = NULL;
 
-		if(mv_meshes[m].m_material_name != "")
-			p_material = library.getMaterial(mv_meshes[m].m_material_name);
+		if(mp_geometry->mv_meshes[m].m_material_name != "")
+			p_material = library.getMaterial(mp_geometry->mv_meshes[m].m_material_name);
 		if(p_material == NULL)
-			p_material = mv_meshes[m].mp_material;
+			p_material = mp_geometry->mv_meshes[m].mp_material;
 
 		drawMeshMaterial(m, p_material);
 	}
@@ -1130,8 +1597,8 @@ void ObjModel :: drawVertices (double red, double green, double blue) const
 	material.activate();
 
 	glBegin(GL_POINTS);
-		for(unsigned int v = 0; v < getVertexCount(); v++)
-			glVertex3dv(mv_vertexes[v].getAsArray());
+		for(Index v = 0; v < getVertexCount(); v++)
+			glVertex3dv(mp_geometry->mv_vertexes[v].getAsArray());
 	glEnd();
 
 	material.deactivate();
@@ -1192,8 +1659,8 @@ void ObjModel :: drawWireframe (double red, double green, double blue) const
 			glBegin(GL_LINE_LOOP);
 				for(unsigned int v = 0; v < getFaceVertexCount(m, f); v++)
 				{
-					unsigned int vertex = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_vertex;
-					glVertex3dv(mv_vertexes[vertex].getAsArray());
+					Index vertex = mp_geometry->mv_meshes[m].mv_faces[f].mv_vertexes[v].m_vertex;
+					glVertex3dv(mp_geometry->mv_vertexes[vertex].getAsArray());
 				}
 			glEnd();
 		}
@@ -1306,17 +1773,17 @@ void ObjModel :: drawVertexNormals (double length, double red, double green, dou
 			for(unsigned int f = 0; f < getFaceCount(m); f++)
 				for(unsigned int v = 0; v < getFaceVertexCount(m, f); v++)
 				{
-					unsigned int vertex = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_vertex;
-					unsigned int normal = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_normal;
+					Index vertex = mp_geometry->mv_meshes[m].mv_faces[f].mv_vertexes[v].m_vertex;
+					Index normal = mp_geometry->mv_meshes[m].mv_faces[f].mv_vertexes[v].m_normal;
 
 					if(normal != NO_NORMAL)
 					{
 						assert(vertex < getVertexCount());
 						assert(normal < getNormalCount());
 
-						Vector3 normal_end = mv_vertexes[vertex] + mv_normals[normal] * length;
+						Vector3 normal_end = mp_geometry->mv_vertexes[vertex] + mp_geometry->mv_normals[normal] * length;
 
-						glVertex3dv(mv_vertexes[vertex].getAsArray());
+						glVertex3dv(mp_geometry->mv_vertexes[vertex].getAsArray());
 						glVertex3dv(normal_end.getAsArray());
 					}
 				}
@@ -1382,16 +1849,16 @@ void ObjModel :: drawFaceNormals (double length, double red, double green, doubl
 
 				for(unsigned int v = 0; v < getFaceVertexCount(m, f); v++)
 				{
-					unsigned int vertex = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_vertex;
-					unsigned int normal = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_normal;
+					Index vertex = mp_geometry->mv_meshes[m].mv_faces[f].mv_vertexes[v].m_vertex;
+					Index normal = mp_geometry->mv_meshes[m].mv_faces[f].mv_vertexes[v].m_normal;
 
 					assert(vertex < getVertexCount());
-					center += mv_vertexes[vertex];
+					center += mp_geometry->mv_vertexes[vertex];
 
 					if(normal != NO_NORMAL)
 					{
 						assert(normal < getNormalCount());
-						face_normal += mv_normals[normal];
+						face_normal += mp_geometry->mv_normals[normal];
 					}
 				}
 
@@ -1432,13 +1899,13 @@ DisplayList ObjModel :: getDisplayList () const
 	//    use.
 	//
 
-	for(unsigned int i = 0; i < mv_meshes.size(); i++)
-		if(mv_meshes[i].mp_material != NULL)
-			mv_meshes[i].mp_material->loadDisplayTextures();
+	for(unsigned int i = 0; i < mp_geometry->mv_meshes.size(); i++)
+		if(mp_geometry->mv_meshes[i].mp_material != NULL)
+			mp_geometry->mv_meshes[i].mp_material->loadDisplayTextures();
 
 	DisplayList list;
 	list.begin();
-		draw();
+		drawImmediate();
 	list.end();
 
 	assert(!Material::isMaterialActive());
@@ -1567,7 +2034,7 @@ ModelWithShader ObjModel :: getModelWithShader (bool is_texture_coordinates,
 
 	ModelWithShader result;
 
-	for(unsigned int m = 0; m < mv_meshes.size(); m++)
+	for(unsigned int m = 0; m < mp_geometry->mv_meshes.size(); m++)
 	{
 		if(getPointSetCount(m) == 0 &&
 		   getPolylineCount(m) == 0 &&
@@ -1579,20 +2046,20 @@ ModelWithShader ObjModel :: getModelWithShader (bool is_texture_coordinates,
 
 		unsigned int material_index;
 
-		if(mv_meshes[m].mp_material == NULL)
+		if(mp_geometry->mv_meshes[m].mp_material == NULL)
 			material_index = result.addMaterial(MATERIAL_FALLBACK.getForShader());
 		else
-			material_index = result.addMaterial(mv_meshes[m].mp_material->getForShader());
+			material_index = result.addMaterial(mp_geometry->mv_meshes[m].mp_material->getForShader());
 
 		// add point sets
 		if(getPointSetCount(m) > 0)
 		{
-			assert(!mv_meshes[m].mv_point_sets.empty());
+			assert(!mp_geometry->mv_meshes[m].mv_point_sets.empty());
 			result.addMesh(material_index, getPointSetMeshWithShader(m));
 		}
 
 		// add polylines
-		for(unsigned int l = 0; l < mv_meshes[m].mv_polylines.size(); l++)
+		for(unsigned int l = 0; l < mp_geometry->mv_meshes[m].mv_polylines.size(); l++)
 		{
 			bool is_polyline_texture_coordinates = is_texture_coordinates;
 			if(!isPolylineTextureCoordinatesAny(m, l))
@@ -1604,7 +2071,7 @@ ModelWithShader ObjModel :: getModelWithShader (bool is_texture_coordinates,
 		// add faces
 		if(getFaceCount(m) > 0)
 		{
-			assert(!mv_meshes[m].mv_faces.empty());
+			assert(!mp_geometry->mv_meshes[m].mv_faces.empty());
 
 			bool is_mesh_texture_coordinates = is_texture_coordinates;
 			if(!isMeshTextureCoordinatesAny(m))
@@ -1626,6 +2093,22 @@ ModelWithShader ObjModel :: getModelWithShader (bool is_texture_coordinates,
 
 
 
+unsigned int ObjModel :: getSaveThreadCount ()
+{
+	unsigned int count = g_save_thread_count;
+	if(count == 0)
+		return JobSystem::getShared().getWorkerCount() + 1;
+	else
+		return count;
+}
+
+void ObjModel :: setSaveThreadCount (unsigned int count)
+{
+	assert(count >= 1);
+
+	g_save_thread_count = count;
+}
+
 void ObjModel :: save (const string& filename) const
 {
 	assert(filename != "");
@@ -1693,13 +2176,13 @@ void ObjModel :: save (const string& filename, ostream& r_logstream) const
 	output_file << "#" << endl;
 	output_file << "# " << getFileNameWithPath() << endl;
 	output_file << "#" << endl;
-	if(mv_vertexes.size() > 0)
+	if(mp_geometry->mv_vertexes.size() > 0)
 		output_file << "# " << getVertexCount() << " vertexes" << endl;
-	if(mv_texture_coordinates.size() > 0)
+	if(mp_geometry->mv_texture_coordinates.size() > 0)
 		output_file << "# " << getTextureCoordinateCount() << " texture coordinate pairs" << endl;
-	if(mv_normals.size() > 0)
+	if(mp_geometry->mv_normals.size() > 0)
 		output_file << "# " << getNormalCount() << " vertex normals" << endl;
-	if(mv_meshes.size() > 0)
+	if(mp_geometry->mv_meshes.size() > 0)
 	{
 		output_file << "# " << getMeshCount() << " meshes" << endl;
 		if(getPointSetCountTotal() > 0)
@@ -1717,12 +2200,12 @@ void ObjModel :: save (const string& filename, ostream& r_logstream) const
 	if(DEBUGGING_SAVE)
 		cout << "Wrote file header" << endl;
 
-	if(mv_material_libraries.size() > 0)
+	if(mp_geometry->mv_material_libraries.size() > 0)
 	{
-		output_file << "# " << mv_material_libraries.size() << " material libraries" << endl;
+		output_file << "# " << mp_geometry->mv_material_libraries.size() << " material libraries" << endl;
 		output_file << "mtllib";
-		for(unsigned int m = 0; m < mv_material_libraries.size(); m++)
-			output_file << " " << mv_material_libraries[m].m_file_name;
+		for(unsigned int m = 0; m < mp_geometry->mv_material_libraries.size(); m++)
+			output_file << " " << mp_geometry->mv_material_libraries[m].m_file_name;
 		output_file << endl;
 		output_file << endl;
 		output_file << endl;
@@ -1732,11 +2215,28 @@ void ObjModel :: save (const string& filename, ostream& r_logstream) const
 			cout << "Wrote material libraries" << endl;
 	}
 
-	if(mv_vertexes.size() > 0)
+	// the elements are formatted in chunks, possibly in parallel
+	unsigned int thread_count = getSaveThreadCount();
+	vector<string> v_chunks(thread_count * SAVE_CHUNKS_PER_THREAD);
+
+	if(mp_geometry->mv_vertexes.size() > 0)
 	{
 		output_file << "# " << getVertexCount() << " vertexes" << endl;
-		for(unsigned int v = 0; v < mv_vertexes.size(); v++)
-			output_file << "v " << mv_vertexes[v].x << " " << mv_vertexes[v].y << " " << mv_vertexes[v].z << endl;
+		writeChunks(output_file, getVertexCount(), thread_count, v_chunks,
+		            [this] (string& r_text, Index begin, Index end)
+		{
+			for(Index v = begin; v < end; v++)
+			{
+				const Vector3& vertex = mp_geometry->mv_vertexes[v];
+				r_text += "v ";
+				appendDouble(r_text, vertex.x);
+				r_text += ' ';
+				appendDouble(r_text, vertex.y);
+				r_text += ' ';
+				appendDouble(r_text, vertex.z);
+				r_text += '\n';
+			}
+		});
 		output_file << endl;
 		output_file << endl;
 		output_file << endl;
@@ -1745,11 +2245,22 @@ void ObjModel :: save (const string& filename, ostream& r_logstream) const
 			cout << "Wrote vertexes" << endl;
 	}
 
-	if(mv_texture_coordinates.size() > 0)
+	if(mp_geometry->mv_texture_coordinates.size() > 0)
 	{
 		output_file << "# " << getTextureCoordinateCount() << " texture coordinate pairs" << endl;
-		for(unsigned int t = 0; t < mv_texture_coordinates.size(); t++)
-			output_file << "vt " << mv_texture_coordinates[t].x << " " << mv_texture_coordinates[t].y << endl;
+		writeChunks(output_file, getTextureCoordinateCount(), thread_count, v_chunks,
+		            [this] (string& r_text, Index begin, Index end)
+		{
+			for(Index t = begin; t < end; t++)
+			{
+				const Vector2& texture_coordinate = mp_geometry->mv_texture_coordinates[t];
+				r_text += "vt ";
+				appendDouble(r_text, texture_coordinate.x);
+				r_text += ' ';
+				appendDouble(r_text, texture_coordinate.y);
+				r_text += '\n';
+			}
+		});
 		output_file << endl;
 		output_file << endl;
 		output_file << endl;
@@ -1758,11 +2269,24 @@ void ObjModel :: save (const string& filename, ostream& r_logstream) const
 			cout << "Wrote texture coordinates" << endl;
 	}
 
-	if(mv_normals.size() > 0)
+	if(mp_geometry->mv_normals.size() > 0)
 	{
 		output_file << "# " << getNormalCount() << " vertex normals" << endl;
-		for(unsigned int n = 0; n < mv_normals.size(); n++)
-			output_file << "vn " << mv_normals[n].x << " " << mv_normals[n].y << " " << mv_normals[n].z << endl;
+		writeChunks(output_file, getNormalCount(), thread_count, v_chunks,
+		            [this] (string& r_text, Index begin, Index end)
+		{
+			for(Index n = begin; n < end; n++)
+			{
+				const Vector3& normal = mp_geometry->mv_normals[n];
+				r_text += "vn ";
+				appendDouble(r_text, normal.x);
+				r_text += ' ';
+				appendDouble(r_text, normal.y);
+				r_text += ' ';
+				appendDouble(r_text, normal.z);
+				r_text += '\n';
+			}
+		});
 		output_file << endl;
 		output_file << endl;
 		output_file << endl;
@@ -1771,76 +2295,107 @@ void ObjModel :: save (const string& filename, ostream& r_logstream) const
 			cout << "Wrote normals" << endl;
 	}
 
-	if(mv_meshes.size() > 0)
+	if(mp_geometry->mv_meshes.size() > 0)
 	{
 		output_file << "# " << getMeshCount() << " meshes" << endl;
 		output_file << endl;
 
-		for(unsigned int m = 0; m < mv_meshes.size(); m++)
+		for(unsigned int m = 0; m < mp_geometry->mv_meshes.size(); m++)
 		{
+			const Mesh& mesh = mp_geometry->mv_meshes[m];
+
 			if(isMeshMaterial(m))
-				output_file << "usemtl " << mv_meshes[m].m_material_name << endl;
+				output_file << "usemtl " << mesh.m_material_name << endl;
 
-			if(mv_meshes[m].mv_point_sets.size() > 0)
+			if(mesh.mv_point_sets.size() > 0)
 			{
 				output_file << "# " << getPointSetCount(m) << " faces" << endl;
-				for(unsigned int p = 0; p < mv_meshes[m].mv_point_sets.size(); p++)
+				writeChunks(output_file, getPointSetCount(m), thread_count, v_chunks,
+				            [&mesh] (string& r_text, Index begin, Index end)
 				{
-					output_file << "p";
-					for(unsigned int i = 0; i < mv_meshes[m].mv_point_sets[p].mv_vertexes.size(); i++)
-						output_file << " " << (mv_meshes[m].mv_point_sets[p].mv_vertexes[i] + 1);
-					output_file << endl;
-				}
+					for(Index p = begin; p < end; p++)
+					{
+						const vector<Index>& v_vertexes = mesh.mv_point_sets[p].mv_vertexes;
+						r_text += 'p';
+						for(unsigned int i = 0; i < v_vertexes.size(); i++)
+						{
+							r_text += ' ';
+							appendUnsigned(r_text, v_vertexes[i] + 1);
+						}
+						r_text += '\n';
+					}
+				});
 				output_file << endl;
 
 				if(DEBUGGING_SAVE)
 					cout << "Wrote point sets for mesh " << m << endl;
 			}
 
-			if(mv_meshes[m].mv_polylines.size() > 0)
+			if(mesh.mv_polylines.size() > 0)
 			{
 				output_file << "# " << getPolylineCount(m) << " faces" << endl;
-				for(unsigned int l = 0; l < mv_meshes[m].mv_polylines.size(); l++)
+				writeChunks(output_file, getPolylineCount(m), thread_count, v_chunks,
+				            [&mesh] (string& r_text, Index begin, Index end)
 				{
-					output_file << "l";
-					for(unsigned int i = 0; i < mv_meshes[m].mv_polylines[l].mv_vertexes.size(); i++)
+					for(Index l = begin; l < end; l++)
 					{
-						output_file << " " << (mv_meshes[m].mv_polylines[l].mv_vertexes[i].m_vertex + 1);
-
-						if(mv_meshes[m].mv_polylines[l].mv_vertexes[i].m_texture_coordinate != NO_TEXTURE_COORDINATES)
-							output_file << "/" << (mv_meshes[m].mv_polylines[l].mv_vertexes[i].m_texture_coordinate + 1);
+						const vector<PolylineVertex>& v_vertexes = mesh.mv_polylines[l].mv_vertexes;
+						r_text += 'l';
+						for(unsigned int i = 0; i < v_vertexes.size(); i++)
+						{
+							r_text += ' ';
+							appendUnsigned(r_text, v_vertexes[i].m_vertex + 1);
+
+							if(v_vertexes[i].m_texture_coordinate != NO_TEXTURE_COORDINATES)
+							{
+								r_text += '/';
+								appendUnsigned(r_text, v_vertexes[i].m_texture_coordinate + 1);
+							}
+						}
+						r_text += '\n';
 					}
-					output_file << endl;
-				}
+				});
 				output_file << endl;
 
 				if(DEBUGGING_SAVE)
 					cout << "Wrote polylines for mesh " << m << endl;
 			}
 
-			if(mv_meshes[m].mv_faces.size() > 0)
+			if(mesh.mv_faces.size() > 0)
 			{
 				output_file << "# " << getFaceCount(m) << " faces" << endl;
-				for(unsigned int f = 0; f < mv_meshes[m].mv_faces.size(); f++)
+				writeChunks(output_file, getFaceCount(m), thread_count, v_chunks,
+				            [&mesh] (string& r_text, Index begin, Index end)
 				{
-					output_file << "f";
-					for(unsigned int i = 0; i < mv_meshes[m].mv_faces[f].mv_vertexes.size(); i++)
+					for(Index f = begin; f < end; f++)
 					{
-						output_file << " " << (mv_meshes[m].mv_faces[f].mv_vertexes[i].m_vertex + 1);
-
-						if(mv_meshes[m].mv_faces[f].mv_vertexes[i].m_texture_coordinate != NO_TEXTURE_COORDINATES)
+						const vector<FaceVertex>& v_vertexes = mesh.mv_faces[f].mv_vertexes;
+						r_text += 'f';
+						for(unsigned int i = 0; i < v_vertexes.size(); i++)
 						{
-							output_file << "/" << (mv_meshes[m].mv_faces[f].mv_vertexes[i].m_texture_coordinate + 1);
-
-							if(mv_meshes[m].mv_faces[f].mv_vertexes[i].m_normal != NO_NORMAL)
-								output_file << "/" << (mv_meshes[m].mv_faces[f].mv_vertexes[i].m_normal + 1);
+							r_text += ' ';
+							appendUnsigned(r_text, v_vertexes[i].m_vertex + 1);
+
+							if(v_vertexes[i].m_texture_coordinate != NO_TEXTURE_COORDINATES)
+							{
+								r_text += '/';
+								appendUnsigned(r_text, v_vertexes[i].m_texture_coordinate + 1);
+
+								if(v_vertexes[i].m_normal != NO_NORMAL)
+								{
+									r_text += '/';
+									appendUnsigned(r_text, v_vertexes[i].m_normal + 1);
+								}
+							}
+							else if(v_vertexes[i].m_normal != NO_NORMAL)
+							{
+								r_text += "//";
+								appendUnsigned(r_text, v_vertexes[i].m_normal + 1);
+							}
 						}
-						else if(mv_meshes[m].mv_faces[f].mv_vertexes[i].m_normal != NO_NORMAL)
-							output_file << "//" << (mv_meshes[m].mv_faces[f].mv_vertexes[i].m_normal + 1);
-
+						r_text += '\n';
 					}
-					output_file << endl;
-				}
+				});
 				output_file << endl;
 
 				if(DEBUGGING_SAVE)
@@ -1868,16 +2423,14 @@ void ObjModel :: save (const string& filename, ostream& r_logstream) const
 
 void ObjModel :: makeEmpty ()
 {
-	mv_material_libraries.clear();
-	mv_vertexes.clear();
-	mv_texture_coordinates.clear();
-	mv_normals.clear();
-	mv_meshes.clear();
+	// do not clear geometry that other copies share
+	mp_geometry = getEmptyGeometry();
 
-	m_file_name         = DEFAULT_FILE_NAME;
-	m_file_path         = DEFAULT_FILE_PATH;
-	m_file_load_success = true;
-	m_valid             = true;
+	m_file_name           = DEFAULT_FILE_NAME;
+	m_file_path           = DEFAULT_FILE_PATH;
+	m_file_load_success   = true;
+	m_is_references_valid = true;
+	m_short_element_count = 0;
 
 	assert(isEmpty());
 	assert(invariant());
@@ -1916,7 +2469,6 @@ void ObjModel :: load (const string& filename, ostream& r_logstream)
 	assert(filename.find_last_of("/\\") == string::npos ||
 	       filename.find_last_of("/\\") + 1 < filename.size());
 
-	ifstream input_file;
 	unsigned int line_count;
 
 	if(DEBUGGING_LOAD)
@@ -1929,11 +2481,10 @@ void ObjModel :: load (const string& filename, ostream& r_logstream)
 
 	setFileNameWithPath(filename);
 
-	input_file.open(filename.c_str(), ios::in);
-	if(!input_file.is_open())
+	AssetFile asset_file(filename, false);
+	if(!asset_file.isOpen())
 	{
 		r_logstream << "Error: File \"" << filename << "\" does not exist" << endl;
-		input_file.close();
 
 		m_file_load_success = false;
 
@@ -1947,6 +2498,8 @@ void ObjModel :: load (const string& filename, ostream& r_logstream)
 	//  http://www.martinreddy.net/gfx/3d/OBJ.spec
 	//
 
+	istream& input_file = asset_file.getStream();
+
 	line_count = 0;
 	while(true)	// drops out at EOF below
 	{
@@ -2010,8 +2563,6 @@ void ObjModel :: load (const string& filename, ostream& r_logstream)
 			r_logstream << "Line " << setw(6) << line_count << " of file \"" << filename << "\" is invalid: \"" << line << "\"" << endl;
 	}
 
-	input_file.close();
-
 	validate();
 	printBadMaterials();
 
@@ -2019,6 +2570,53 @@ void ObjModel :: load (const string& filename, ostream& r_logstream)
 }
 
 
+void ObjModel :: loadBinary (const string& filename)
+{
+	assert(filename != "");
+	assert(filename.find_last_of("/\\") == string::npos ||
+	       filename.find_last_of("/\\") + 1 < filename.size());
+
+	loadBinary(filename, cerr);
+
+	assert(invariant());
+}
+
+void ObjModel :: loadBinary (const string& filename, ostream& r_logstream)
+{
+	assert(filename != "");
+	assert(filename.find_last_of("/\\") == string::npos ||
+	       filename.find_last_of("/\\") + 1 < filename.size());
+
+	makeEmpty();
+	setFileNameWithPath(filename);
+
+	AssetFile asset_file(filename, true);
+	if(!asset_file.isOpen())
+	{
+		r_logstream << "Error: File \"" << filename << "\" does not exist" << endl;
+
+		m_file_load_success = false;
+
+		assert(invariant());
+		return;
+	}
+
+	if(!readBinary(asset_file.getStream(), filename, r_logstream))
+	{
+		makeEmpty();
+		setFileNameWithPath(filename);
+		m_file_load_success = false;
+
+		assert(invariant());
+		return;
+	}
+
+	validate();
+	printBadMaterials();
+
+	assert(invariant());
+}
+
 
 void ObjModel :: setFileName (const string& file_name)
 {
@@ -2062,180 +2660,214 @@ void ObjModel :: setFileNameWithPath (const string& filename)
 	assert(invariant());
 }
 
-void ObjModel :: setVertexCount (unsigned int count)
+void ObjModel :: setVertexCount (Index count)
 {
+	beginGeometryChange();
+
 	if(count < getVertexCount())
 	{
-		m_valid = false;
-		mv_vertexes.resize(count);
+		m_is_references_valid = false;
+		mp_geometry->mv_vertexes.resize(count);
 	}
 	else if(count > getVertexCount())
-		mv_vertexes.resize(count, Vector3::ZERO);
+		mp_geometry->mv_vertexes.resize(count, Vector3::ZERO);
 
 	assert(invariant());
 }
 
-void ObjModel :: setVertexX (unsigned int vertex, double x)
+void ObjModel :: setVertexX (Index vertex, double x)
 {
 	assert(vertex < getVertexCount());
 
-	mv_vertexes[vertex].x = x;
+	beginVertexChange(vertex);
+
+	mp_geometry->mv_vertexes[vertex].x = x;
 
 	assert(invariant());
 }
 
-void ObjModel :: setVertexY (unsigned int vertex, double y)
+void ObjModel :: setVertexY (Index vertex, double y)
 {
 	assert(vertex < getVertexCount());
 
-	mv_vertexes[vertex].y = y;
+	beginVertexChange(vertex);
+
+	mp_geometry->mv_vertexes[vertex].y = y;
 
 	assert(invariant());
 }
 
-void ObjModel :: setVertexZ (unsigned int vertex, double z)
+void ObjModel :: setVertexZ (Index vertex, double z)
 {
 	assert(vertex < getVertexCount());
 
-	mv_vertexes[vertex].z = z;
+	beginVertexChange(vertex);
+
+	mp_geometry->mv_vertexes[vertex].z = z;
 
 	assert(invariant());
 }
 
-void ObjModel :: setVertexPosition (unsigned int vertex, double x, double y, double z)
+void ObjModel :: setVertexPosition (Index vertex, double x, double y, double z)
 {
 	assert(vertex < getVertexCount());
 
-	mv_vertexes[vertex].set(x, y, z);
+	beginVertexChange(vertex);
+
+	mp_geometry->mv_vertexes[vertex].set(x, y, z);
 
 	assert(invariant());
 }
 
-void ObjModel :: setVertexPosition (unsigned int vertex, const Vector3& position)
+void ObjModel :: setVertexPosition (Index vertex, const Vector3& position)
 {
 	assert(vertex < getVertexCount());
 
-	mv_vertexes[vertex] = position;
+	beginVertexChange(vertex);
+
+	mp_geometry->mv_vertexes[vertex] = position;
 
 	assert(invariant());
 }
 
-void ObjModel :: setTextureCoordinateCount (unsigned int count)
+void ObjModel :: setTextureCoordinateCount (Index count)
 {
+	beginGeometryChange();
+
 	if(count < getTextureCoordinateCount())
 	{
-		m_valid = false;
-		mv_texture_coordinates.resize(count);
+		m_is_references_valid = false;
+		mp_geometry->mv_texture_coordinates.resize(count);
 	}
 	else if(count > getTextureCoordinateCount())
-		mv_texture_coordinates.resize(count, Vector2::ZERO);
+		mp_geometry->mv_texture_coordinates.resize(count, Vector2::ZERO);
 
 	assert(invariant());
 }
 
-void ObjModel :: setTextureCoordinateU (unsigned int texture_coordinate, double u)
+void ObjModel :: setTextureCoordinateU (Index texture_coordinate, double u)
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	mv_texture_coordinates[texture_coordinate].x = u;
+	beginGeometryChange();
+
+	mp_geometry->mv_texture_coordinates[texture_coordinate].x = u;
 
 	assert(invariant());
 }
-void ObjModel :: setTextureCoordinateV (unsigned int texture_coordinate, double v)
+void ObjModel :: setTextureCoordinateV (Index texture_coordinate, double v)
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	mv_texture_coordinates[texture_coordinate].y = v;
+	beginGeometryChange();
+
+	mp_geometry->mv_texture_coordinates[texture_coordinate].y = v;
 
 	assert(invariant());
 }
 
-void ObjModel :: setTextureCoordinate (unsigned int texture_coordinate, double u, double v)
+void ObjModel :: setTextureCoordinate (Index texture_coordinate, double u, double v)
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	mv_texture_coordinates[texture_coordinate].x = u;
-	mv_texture_coordinates[texture_coordinate].y = v;
+	beginGeometryChange();
+
+	mp_geometry->mv_texture_coordinates[texture_coordinate].x = u;
+	mp_geometry->mv_texture_coordinates[texture_coordinate].y = v;
 
 	assert(invariant());
 }
 
-void ObjModel :: setTextureCoordinate (unsigned int texture_coordinate, const Vector2& coordinates)
+void ObjModel :: setTextureCoordinate (Index texture_coordinate, const Vector2& coordinates)
 {
 	assert(texture_coordinate < getTextureCoordinateCount());
 
-	mv_texture_coordinates[texture_coordinate] = coordinates;
+	beginGeometryChange();
+
+	mp_geometry->mv_texture_coordinates[texture_coordinate] = coordinates;
 
 	assert(invariant());
 }
 
-void ObjModel :: setNormalCount (unsigned int count)
+void ObjModel :: setNormalCount (Index count)
 {
+	beginGeometryChange();
+
 	if(count < getNormalCount())
 	{
-		m_valid = false;
-		mv_normals.resize(count);
+		m_is_references_valid = false;
+		mp_geometry->mv_normals.resize(count);
 	}
 	else if(count > getNormalCount())
-		mv_normals.resize(count, Vector3::UNIT_Z_PLUS);
+		mp_geometry->mv_normals.resize(count, Vector3::UNIT_Z_PLUS);
 
 	assert(invariant());
 }
 
-void ObjModel :: setNormalX (unsigned int normal, double x)
+void ObjModel :: setNormalX (Index normal, double x)
 {
 	assert(normal < getNormalCount());
 	assert(x != 0.0 || getNormalY(normal) != 0.0 || getNormalZ(normal) != 0.0);
 
-	mv_normals[normal].x = x;
-	assert(!mv_normals[normal].isZero());
-	mv_normals[normal].normalize();
+	beginNormalChange(normal);
+
+	mp_geometry->mv_normals[normal].x = x;
+	assert(!mp_geometry->mv_normals[normal].isZero());
+	mp_geometry->mv_normals[normal].normalize();
 
 	assert(invariant());
 }
 
-void ObjModel :: setNormalY (unsigned int normal, double y)
+void ObjModel :: setNormalY (Index normal, double y)
 {
 	assert(normal < getNormalCount());
 	assert(getNormalX(normal) != 0.0 || y != 0.0 || getNormalZ(normal) != 0.0);
 
-	mv_normals[normal].y = y;
-	assert(!mv_normals[normal].isZero());
-	mv_normals[normal].normalize();
+	beginNormalChange(normal);
+
+	mp_geometry->mv_normals[normal].y = y;
+	assert(!mp_geometry->mv_normals[normal].isZero());
+	mp_geometry->mv_normals[normal].normalize();
 
 	assert(invariant());
 }
 
-void ObjModel :: setNormalZ (unsigned int normal, double z)
+void ObjModel :: setNormalZ (Index normal, double z)
 {
 	assert(normal < getNormalCount());
 	assert(getNormalX(normal) != 0.0 || getNormalY(normal) != 0.0 || z != 0.0);
 
-	mv_normals[normal].z = z;
-	assert(!mv_normals[normal].isZero());
-	mv_normals[normal].normalize();
+	beginNormalChange(normal);
+
+	mp_geometry->mv_normals[normal].z = z;
+	assert(!mp_geometry->mv_normals[normal].isZero());
+	mp_geometry->mv_normals[normal].normalize();
 
 	assert(invariant());
 }
 
-void ObjModel :: setNormalVector (unsigned int normal, double x, double y, double z)
+void ObjModel :: setNormalVector (Index normal, double x, double y, double z)
 {
 	assert(normal < getNormalCount());
 	assert(x != 0.0 || y != 0.0 || z != 0.0);
 
-	mv_normals[normal].set(x, y, z);
-	assert(!mv_normals[normal].isZero());
-	mv_normals[normal].normalize();
+	beginNormalChange(normal);
+
+	mp_geometry->mv_normals[normal].set(x, y, z);
+	assert(!mp_geometry->mv_normals[normal].isZero());
+	mp_geometry->mv_normals[normal].normalize();
 
 	assert(invariant());
 }
 
-void ObjModel :: setNormalVector (unsigned int normal, const Vector3& vector)
+void ObjModel :: setNormalVector (Index normal, const Vector3& vector)
 {
 	assert(normal < getNormalCount());
 	assert(!vector.isZero());
 
-	mv_normals[normal] = vector.getNormalized();
+	beginNormalChange(normal);
+
+	mp_geometry->mv_normals[normal] = vector.getNormalized();
 
 	assert(invariant());
 }
@@ -2245,23 +2877,25 @@ void ObjModel :: setMeshMaterial (unsigned int mesh, const string& material)
 	assert(mesh < getMeshCount());
 	assert(material != "");
 
+	beginGeometryChange();
+
 	if(DEBUGGING_LOAD)
 		cout << "    Setting mesh " << mesh << " to use material " << material << endl;
 
-	mv_meshes[mesh].m_material_name = material;
+	mp_geometry->mv_meshes[mesh].m_material_name = material;
 
-	mv_meshes[mesh].mp_material = NULL;
-	for(unsigned int i = 0; i < mv_material_libraries.size(); i++)
+	mp_geometry->mv_meshes[mesh].mp_material = NULL;
+	for(unsigned int i = 0; i < mp_geometry->mv_material_libraries.size(); i++)
 	{
-		if(mv_material_libraries[i].mp_mtl_library == NULL)
+		if(mp_geometry->mv_material_libraries[i].mp_mtl_library == NULL)
 			continue;
 
-		unsigned int index = mv_material_libraries[i].mp_mtl_library->getMaterialIndex(material);
+		unsigned int index = mp_geometry->mv_material_libraries[i].mp_mtl_library->getMaterialIndex(material);
 
 		if(index == MtlLibrary::NO_SUCH_MATERIAL)
 			continue;
 
-		mv_meshes[mesh].mp_material = mv_material_libraries[i].mp_mtl_library->getMaterial(index);
+		mp_geometry->mv_meshes[mesh].mp_material = mp_geometry->mv_material_libraries[i].mp_mtl_library->getMaterial(index);
 	}
 
 	assert(invariant());
@@ -2271,86 +2905,100 @@ void ObjModel :: setMeshMaterialNone (unsigned int mesh)
 {
 	assert(mesh < getMeshCount());
 
-	mv_meshes[mesh].m_material_name = "";
-	mv_meshes[mesh].mp_material = NULL;
+	beginGeometryChange();
+
+	mp_geometry->mv_meshes[mesh].m_material_name = "";
+	mp_geometry->mv_meshes[mesh].mp_material = NULL;
 
 	assert(invariant());
 }
 
-void ObjModel :: setPointSetVertexIndex (unsigned int mesh, unsigned int point_set, unsigned int vertex, unsigned int index)
+void ObjModel :: setPointSetVertexIndex (unsigned int mesh, unsigned int point_set, unsigned int vertex, Index index)
 {
 	assert(mesh < getMeshCount());
 	assert(point_set < getPointSetCount(mesh));
 	assert(vertex < getPointSetVertexCount(mesh, point_set));
 
-	mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes[vertex] = index;
+	beginGeometryChange();
+
+	mp_geometry->mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes[vertex] = index;
 	if(index >= getVertexCount())
-		m_valid = false;
+		m_is_references_valid = false;
 
 	assert(invariant());
 }
 
-void ObjModel :: setPolylineVertexIndex (unsigned int mesh, unsigned int polyline, unsigned int vertex, unsigned int index)
+void ObjModel :: setPolylineVertexIndex (unsigned int mesh, unsigned int polyline, unsigned int vertex, Index index)
 {
 	assert(mesh < getMeshCount());
 	assert(polyline < getPolylineCount(mesh));
 	assert(vertex < getPolylineVertexCount(mesh, polyline));
 
-	mv_meshes[mesh].mv_polylines[polyline].mv_vertexes[vertex].m_vertex = index;
+	beginGeometryChange();
+
+	mp_geometry->mv_meshes[mesh].mv_polylines[polyline].mv_vertexes[vertex].m_vertex = index;
 	if(index >= getVertexCount())
-		m_valid = false;
+		m_is_references_valid = false;
 
 	assert(invariant());
 }
 
-void ObjModel :: setPolylineVertexTextureCoordinates (unsigned int mesh, unsigned int polyline, unsigned int vertex, unsigned int index)
+void ObjModel :: setPolylineVertexTextureCoordinates (unsigned int mesh, unsigned int polyline, unsigned int vertex, Index index)
 {
 	assert(mesh < getMeshCount());
 	assert(polyline < getPolylineCount(mesh));
 	assert(vertex < getPolylineVertexCount(mesh, polyline));
 
-	mv_meshes[mesh].mv_polylines[polyline].mv_vertexes[vertex].m_texture_coordinate = index;
+	beginGeometryChange();
+
+	mp_geometry->mv_meshes[mesh].mv_polylines[polyline].mv_vertexes[vertex].m_texture_coordinate = index;
 	if(index >= getTextureCoordinateCount() && index != NO_TEXTURE_COORDINATES)
-		m_valid = false;
+		m_is_references_valid = false;
 
 	assert(invariant());
 }
 
-void ObjModel :: setFaceVertexIndex (unsigned int mesh, unsigned int face, unsigned int vertex, unsigned int index)
+void ObjModel :: setFaceVertexIndex (unsigned int mesh, unsigned int face, unsigned int vertex, Index index)
 {
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_vertex = index;
+	beginGeometryChange();
+
+	mp_geometry->mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_vertex = index;
 	if(index >= getVertexCount())
-		m_valid = false;
+		m_is_references_valid = false;
 
 	assert(invariant());
 }
 
-void ObjModel :: setFaceVertexTextureCoordinates (unsigned int mesh, unsigned int face, unsigned int vertex, unsigned int index)
+void ObjModel :: setFaceVertexTextureCoordinates (unsigned int mesh, unsigned int face, unsigned int vertex, Index index)
 {
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_texture_coordinate = index;
+	beginGeometryChange();
+
+	mp_geometry->mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_texture_coordinate = index;
 	if(index >= getTextureCoordinateCount() && index != NO_TEXTURE_COORDINATES)
-		m_valid = false;
+		m_is_references_valid = false;
 
 	assert(invariant());
 }
 
-void ObjModel :: setFaceVertexNormal (unsigned int mesh, unsigned int face, unsigned int vertex, unsigned int index)
+void ObjModel :: setFaceVertexNormal (unsigned int mesh, unsigned int face, unsigned int vertex, Index index)
 {
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_normal = index;
-	if(index >= getVertexCount() && index != NO_NORMAL)
-		m_valid = false;
+	beginGeometryChange();
+
+	mp_geometry->mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_normal = index;
+	if(index >= getNormalCount() && index != NO_NORMAL)
+		m_is_references_valid = false;
 
 	assert(invariant());
 }
@@ -2390,32 +3038,36 @@ void ObjModel :: addMaterialLibrary (const string& library, ostream& r_logstream
 	assert(library.find_last_of("/\\") == string::npos ||
 	       library.find_last_of("/\\") + 1 < library.size());
 
+	beginGeometryChange();
+
 #ifdef OBJ_LIBRARY_PATH_PROPAGATION
-	mv_material_libraries.push_back(MaterialLibrary(m_file_path, library, r_logstream));
+	mp_geometry->mv_material_libraries.push_back(MaterialLibrary(m_file_path, library, r_logstream));
 #else
-	mv_material_libraries.push_back(MaterialLibrary("", library, r_logstream));
+	mp_geometry->mv_material_libraries.push_back(MaterialLibrary("", library, r_logstream));
 #endif
 
 	if(DEBUGGING_EDITING)
 	{
-		unsigned int index = mv_material_libraries.size() - 1;
-		cout << "Added Material Libary \"" << mv_material_libraries[index].m_file_name << "\"" << endl;
-		if(mv_material_libraries[index].mp_mtl_library == NULL)
+		unsigned int index = mp_geometry->mv_material_libraries.size() - 1;
+		cout << "Added Material Libary \"" << mp_geometry->mv_material_libraries[index].m_file_name << "\"" << endl;
+		if(mp_geometry->mv_material_libraries[index].mp_mtl_library == NULL)
 			cout << "But couldn't load it" << endl;
 	}
 
 	assert(invariant());
 }
 
-unsigned int ObjModel :: addVertex (double x, double y, double z)
+ObjModel::Index ObjModel :: addVertex (double x, double y, double z)
 {
 	return addVertex(Vector3(x, y, z));
 }
 
-unsigned int ObjModel :: addVertex (const Vector3& position)
+ObjModel::Index ObjModel :: addVertex (const Vector3& position)
 {
-	unsigned int id = mv_vertexes.size();
-	mv_vertexes.push_back(position);
+	beginGeometryChange();
+
+	Index id = mp_geometry->mv_vertexes.size();
+	mp_geometry->mv_vertexes.push_back(position);
 
 	if(DEBUGGING_EDITING)
 		cout << "Added Vertex #" << (id + 1) << " " << position << endl;
@@ -2424,15 +3076,17 @@ unsigned int ObjModel :: addVertex (const Vector3& position)
 	return id;
 }
 
-unsigned int ObjModel :: addTextureCoordinate (double u, double v)
+ObjModel::Index ObjModel :: addTextureCoordinate (double u, double v)
 {
 	return addTextureCoordinate(Vector2(u, v));
 }
 
-unsigned int ObjModel :: addTextureCoordinate (const Vector2& texture_coordinates)
+ObjModel::Index ObjModel :: addTextureCoordinate (const Vector2& texture_coordinates)
 {
-	unsigned int id = mv_texture_coordinates.size();
-	mv_texture_coordinates.push_back(texture_coordinates);
+	beginGeometryChange();
+
+	Index id = mp_geometry->mv_texture_coordinates.size();
+	mp_geometry->mv_texture_coordinates.push_back(texture_coordinates);
 
 	if(DEBUGGING_EDITING)
 		cout << "Added Texture Coordinate #" << (id + 1) << " " << texture_coordinates << endl;
@@ -2441,19 +3095,24 @@ unsigned int ObjModel :: addTextureCoordinate (const Vector2& texture_coordinate
 	return id;
 }
 
-unsigned int ObjModel :: addNormal (double x, double y, double z)
+ObjModel::Index ObjModel :: addNormal (double x, double y, double z)
 {
 	assert(x != 0.0 || y != 0.0 || z != 0.0);
 
 	return addNormal(Vector3(x, y, z));
 }
 
-unsigned int ObjModel :: addNormal (const Vector3& normal)
+ObjModel::Index ObjModel :: addNormal (const Vector3& normal)
 {
 	assert(!normal.isZero());
 
-	unsigned int id = mv_normals.size();
-	mv_normals.push_back(normal.getNormalized());
+	beginGeometryChange();
+
+	Index id = mp_geometry->mv_normals.size();
+	if(fabs(normal.getNormSquared() - 1.0) <= NORMALIZED_TOLERANCE)
+		mp_geometry->mv_normals.push_back(normal);
+	else
+		mp_geometry->mv_normals.push_back(normal.getNormalized());
 
 	if(DEBUGGING_EDITING)
 		cout << "Added Normal #" << (id + 1) << " " << normal << endl;
@@ -2464,8 +3123,10 @@ unsigned int ObjModel :: addNormal (const Vector3& normal)
 
 unsigned int ObjModel :: addMesh ()
 {
-	unsigned int id = mv_meshes.size();
-	mv_meshes.push_back(Mesh());
+	beginGeometryChange();
+
+	unsigned int id = mp_geometry->mv_meshes.size();
+	mp_geometry->mv_meshes.push_back(Mesh());
 
 	if(DEBUGGING_EDITING)
 		cout << "Added mesh #" << (id + 1) << endl;
@@ -2478,9 +3139,11 @@ unsigned int ObjModel :: addPointSet (unsigned int mesh)
 {
 	assert(mesh < getMeshCount());
 
-	unsigned int id = mv_meshes[mesh].mv_point_sets.size();
-	mv_meshes[mesh].mv_point_sets.push_back(PointSet());
-	m_valid = false;
+	beginGeometryChange();
+
+	unsigned int id = mp_geometry->mv_meshes[mesh].mv_point_sets.size();
+	mp_geometry->mv_meshes[mesh].mv_point_sets.push_back(PointSet());
+	changeElementVertexCount(POINT_SET_MINIMUM_VERTEXES, 0, POINT_SET_MINIMUM_VERTEXES);
 
 	if(DEBUGGING_EDITING)
 		cout << "    Added Point Set #" << (id + 1) << endl;
@@ -2489,16 +3152,19 @@ unsigned int ObjModel :: addPointSet (unsigned int mesh)
 	return id;
 }
 
-unsigned int ObjModel :: addPointSetVertex (unsigned int mesh, unsigned int point_set, unsigned int vertex)
+unsigned int ObjModel :: addPointSetVertex (unsigned int mesh, unsigned int point_set, Index vertex)
 {
 	assert(mesh < getMeshCount());
 	assert(point_set < getPointSetCount(mesh));
 
-	unsigned int id = mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes.size();
-	mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes.push_back(vertex);
+	beginGeometryChange();
+
+	unsigned int id = mp_geometry->mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes.size();
+	mp_geometry->mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes.push_back(vertex);
+	changeElementVertexCount(id, id + 1, POINT_SET_MINIMUM_VERTEXES);
 
 	if(vertex >= getVertexCount())
-		m_valid = false;
+		m_is_references_valid = false;
 
 	if(DEBUGGING_EDITING)
 		cout << "        Added vertex #" << (id + 1) << " (" << (vertex + 1) << ")" << endl;
@@ -2511,9 +3177,11 @@ unsigned int ObjModel :: addPolyline (unsigned int mesh)
 {
 	assert(mesh < getMeshCount());
 
-	unsigned int id = mv_meshes[mesh].mv_polylines.size();
-	mv_meshes[mesh].mv_polylines.push_back(Polyline());
-	m_valid = false;
+	beginGeometryChange();
+
+	unsigned int id = mp_geometry->mv_meshes[mesh].mv_polylines.size();
+	mp_geometry->mv_meshes[mesh].mv_polylines.push_back(Polyline());
+	changeElementVertexCount(POLYLINE_MINIMUM_VERTEXES, 0, POLYLINE_MINIMUM_VERTEXES);
 
 	if(DEBUGGING_EDITING)
 		cout << "    Added Polyline #" << (id + 1) << endl;
@@ -2522,18 +3190,21 @@ unsigned int ObjModel :: addPolyline (unsigned int mesh)
 	return id;
 }
 
-unsigned int ObjModel :: addPolylineVertex (unsigned int mesh, unsigned int polyline, unsigned int vertex, unsigned int texture_coordinates)
+unsigned int ObjModel :: addPolylineVertex (unsigned int mesh, unsigned int polyline, Index vertex, Index texture_coordinates)
 {
 	assert(mesh < getMeshCount());
 	assert(polyline < getPolylineCount(mesh));
 
-	unsigned int id = mv_meshes[mesh].mv_polylines[polyline].mv_vertexes.size();
-	mv_meshes[mesh].mv_polylines[polyline].mv_vertexes.push_back(PolylineVertex(vertex, texture_coordinates));
+	beginGeometryChange();
+
+	unsigned int id = mp_geometry->mv_meshes[mesh].mv_polylines[polyline].mv_vertexes.size();
+	mp_geometry->mv_meshes[mesh].mv_polylines[polyline].mv_vertexes.push_back(PolylineVertex(vertex, texture_coordinates));
+	changeElementVertexCount(id, id + 1, POLYLINE_MINIMUM_VERTEXES);
 
 	if(vertex >= getVertexCount())
-		m_valid = false;
+		m_is_references_valid = false;
 	if(texture_coordinates != NO_TEXTURE_COORDINATES && texture_coordinates >= getTextureCoordinateCount())
-		m_valid = false;
+		m_is_references_valid = false;
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2553,9 +3224,11 @@ unsigned int ObjModel :: addFace (unsigned int mesh)
 {
 	assert(mesh < getMeshCount());
 
-	unsigned int id = mv_meshes[mesh].mv_faces.size();
-	mv_meshes[mesh].mv_faces.push_back(Face());
-	m_valid = false;
+	beginGeometryChange();
+
+	unsigned int id = mp_geometry->mv_meshes[mesh].mv_faces.size();
+	mp_geometry->mv_meshes[mesh].mv_faces.push_back(Face());
+	changeElementVertexCount(FACE_MINIMUM_VERTEXES, 0, FACE_MINIMUM_VERTEXES);
 
 	if(DEBUGGING_EDITING)
 		cout << "    Added face #" << (id + 1) << endl;
@@ -2564,22 +3237,25 @@ unsigned int ObjModel :: addFace (unsigned int mesh)
 	return id;
 }
 
-unsigned int ObjModel :: addFaceVertex (unsigned int mesh, unsigned int face, unsigned int vertex, unsigned int texture_coordinates, unsigned int normal)
+unsigned int ObjModel :: addFaceVertex (unsigned int mesh, unsigned int face, Index vertex, Index texture_coordinates, Index normal)
 {
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 
-	unsigned int id = mv_meshes[mesh].mv_faces[face].mv_vertexes.size();
-	mv_meshes[mesh].mv_faces[face].mv_vertexes.push_back(FaceVertex(vertex, texture_coordinates, normal));
+	beginGeometryChange();
+
+	unsigned int id = mp_geometry->mv_meshes[mesh].mv_faces[face].mv_vertexes.size();
+	mp_geometry->mv_meshes[mesh].mv_faces[face].mv_vertexes.push_back(FaceVertex(vertex, texture_coordinates, normal));
+	changeElementVertexCount(id, id + 1, FACE_MINIMUM_VERTEXES);
 
 	if(vertex >= getVertexCount())
-		m_valid = false;
+		m_is_references_valid = false;
 	if(texture_coordinates != NO_TEXTURE_COORDINATES && texture_coordinates >= getTextureCoordinateCount())
-		m_valid = false;
+		m_is_references_valid = false;
 	if(normal != NO_NORMAL && normal >= getNormalCount())
-		m_valid = false;
-	if(id > 3)
-		mv_meshes[mesh].m_all_triangles = false;
+		m_is_references_valid = false;
+	if(id >= 3)
+		mp_geometry->mv_meshes[mesh].m_all_triangles = false;
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2602,9 +3278,11 @@ unsigned int ObjModel :: addFaceVertex (unsigned int mesh, unsigned int face, un
 
 void ObjModel :: removeMaterialLibaryAll ()
 {
-	mv_material_libraries.clear();
+	beginGeometryChange();
 
-	unsigned int mesh_count = mv_meshes.size();
+	mp_geometry->mv_material_libraries.clear();
+
+	unsigned int mesh_count = mp_geometry->mv_meshes.size();
 	for(unsigned int m = 0; m < mesh_count; m++)
 		setMeshMaterialNone(m);
 
@@ -2618,14 +3296,17 @@ void ObjModel :: removeMesh (unsigned int mesh)
 {
 	assert(mesh < getMeshCount());
 
-	unsigned int mesh_count = mv_meshes.size();
+	beginGeometryChange();
+
+	removeMeshElements(mesh, true, true, true);
+	unsigned int mesh_count = mp_geometry->mv_meshes.size();
 	for(unsigned int i = mesh + 1; i < mesh_count; i++)
 	{
 		assert(i >= 1);
-		mv_meshes[i - 1] = mv_meshes[i];
+		mp_geometry->mv_meshes[i - 1] = mp_geometry->mv_meshes[i];
 	}
 
-	mv_meshes.pop_back();
+	mp_geometry->mv_meshes.pop_back();
 
 	if(DEBUGGING_EDITING)
 		cout << "    Removed mesh #" << (mesh + 1) << endl;
@@ -2635,7 +3316,10 @@ void ObjModel :: removeMesh (unsigned int mesh)
 
 void ObjModel :: removeMeshAll ()
 {
-	mv_meshes.clear();
+	beginGeometryChange();
+
+	mp_geometry->mv_meshes.clear();
+	m_short_element_count = 0;
 
 	if(DEBUGGING_EDITING)
 		cout << "    Removed all meshes" << endl;
@@ -2649,13 +3333,16 @@ void ObjModel :: removePointSet (unsigned int mesh,
 	assert(mesh < getMeshCount());
 	assert(point_set < getPointSetCount(mesh));
 
-	unsigned int point_set_count = mv_meshes[mesh].mv_point_sets.size();
+	beginGeometryChange();
+
+	changeElementVertexCount(getPointSetVertexCount(mesh, point_set), POINT_SET_MINIMUM_VERTEXES, POINT_SET_MINIMUM_VERTEXES);
+	unsigned int point_set_count = mp_geometry->mv_meshes[mesh].mv_point_sets.size();
 	for(unsigned int i = point_set + 1; i < point_set_count; i++)
 	{
 		assert(i >= 1);
-		mv_meshes[mesh].mv_point_sets[i - 1] = mv_meshes[mesh].mv_point_sets[i];
+		mp_geometry->mv_meshes[mesh].mv_point_sets[i - 1] = mp_geometry->mv_meshes[mesh].mv_point_sets[i];
 	}
-	mv_meshes[mesh].mv_point_sets.pop_back();
+	mp_geometry->mv_meshes[mesh].mv_point_sets.pop_back();
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2670,7 +3357,10 @@ void ObjModel :: removePointSetAll (unsigned int mesh)
 {
 	assert(mesh < getMeshCount());
 
-	mv_meshes[mesh].mv_point_sets.clear();
+	beginGeometryChange();
+
+	removeMeshElements(mesh, true, false, false);
+	mp_geometry->mv_meshes[mesh].mv_point_sets.clear();
 
 	if(DEBUGGING_EDITING)
 		cout << "    Removed mesh #" << (mesh + 1) << ", all point sets" << endl;
@@ -2684,9 +3374,11 @@ void ObjModel :: removePointSetVertex (unsigned int mesh,
 {
 	assert(mesh < getMeshCount());
 	assert(point_set < getPointSetCount(mesh));
-	assert(vertex < getPolylineVertexCount(mesh, point_set));
+	assert(vertex < getPointSetVertexCount(mesh, point_set));
 
-	vector<unsigned int>& rv_vertexes = mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes;
+	beginGeometryChange();
+
+	vector<Index>& rv_vertexes = mp_geometry->mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes;
 	unsigned int vertex_count = rv_vertexes.size();
 	for(unsigned int i = vertex + 1; i < vertex_count; i++)
 	{
@@ -2694,6 +3386,7 @@ void ObjModel :: removePointSetVertex (unsigned int mesh,
 		rv_vertexes[i - 1] = rv_vertexes[i];
 	}
 	rv_vertexes.pop_back();
+	changeElementVertexCount(vertex_count, vertex_count - 1, POINT_SET_MINIMUM_VERTEXES);
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2711,7 +3404,10 @@ void ObjModel :: removePointSetVertexAll (unsigned int mesh,
 	assert(mesh < getMeshCount());
 	assert(point_set < getPointSetCount(mesh));
 
-	mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes.clear();
+	beginGeometryChange();
+
+	changeElementVertexCount(getPointSetVertexCount(mesh, point_set), 0, POINT_SET_MINIMUM_VERTEXES);
+	mp_geometry->mv_meshes[mesh].mv_point_sets[point_set].mv_vertexes.clear();
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2728,13 +3424,16 @@ void ObjModel :: removePolyline (unsigned int mesh,
 	assert(mesh < getMeshCount());
 	assert(polyline < getPolylineCount(mesh));
 
-	unsigned int polyline_count = mv_meshes[mesh].mv_polylines.size();
+	beginGeometryChange();
+
+	changeElementVertexCount(getPolylineVertexCount(mesh, polyline), POLYLINE_MINIMUM_VERTEXES, POLYLINE_MINIMUM_VERTEXES);
+	unsigned int polyline_count = mp_geometry->mv_meshes[mesh].mv_polylines.size();
 	for(unsigned int i = polyline + 1; i < polyline_count; i++)
 	{
 		assert(i >= 1);
-		mv_meshes[mesh].mv_polylines[i - 1] = mv_meshes[mesh].mv_polylines[i];
+		mp_geometry->mv_meshes[mesh].mv_polylines[i - 1] = mp_geometry->mv_meshes[mesh].mv_polylines[i];
 	}
-	mv_meshes[mesh].mv_polylines.pop_back();
+	mp_geometry->mv_meshes[mesh].mv_polylines.pop_back();
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2749,7 +3448,10 @@ void ObjModel :: removePolylineAll (unsigned int mesh)
 {
 	assert(mesh < getMeshCount());
 
-	mv_meshes[mesh].mv_polylines.clear();
+	beginGeometryChange();
+
+	removeMeshElements(mesh, false, true, false);
+	mp_geometry->mv_meshes[mesh].mv_polylines.clear();
 
 	if(DEBUGGING_EDITING)
 		cout << "    Removed mesh #" << (mesh + 1) << ", all polylines" << endl;
@@ -2765,7 +3467,9 @@ void ObjModel :: removePolylineVertex (unsigned int mesh,
 	assert(polyline < getPolylineCount(mesh));
 	assert(vertex < getPolylineVertexCount(mesh, polyline));
 
-	vector<PolylineVertex>& rv_vertexes = mv_meshes[mesh].mv_polylines[polyline].mv_vertexes;
+	beginGeometryChange();
+
+	vector<PolylineVertex>& rv_vertexes = mp_geometry->mv_meshes[mesh].mv_polylines[polyline].mv_vertexes;
 	unsigned int vertex_count = rv_vertexes.size();
 	for(unsigned int i = vertex + 1; i < vertex_count; i++)
 	{
@@ -2773,6 +3477,7 @@ void ObjModel :: removePolylineVertex (unsigned int mesh,
 		rv_vertexes[i - 1] = rv_vertexes[i];
 	}
 	rv_vertexes.pop_back();
+	changeElementVertexCount(vertex_count, vertex_count - 1, POLYLINE_MINIMUM_VERTEXES);
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2790,7 +3495,10 @@ void ObjModel :: removePolylineVertexAll (unsigned int mesh,
 	assert(mesh < getMeshCount());
 	assert(polyline < getPolylineCount(mesh));
 
-	mv_meshes[mesh].mv_polylines[polyline].mv_vertexes.clear();
+	beginGeometryChange();
+
+	changeElementVertexCount(getPolylineVertexCount(mesh, polyline), 0, POLYLINE_MINIMUM_VERTEXES);
+	mp_geometry->mv_meshes[mesh].mv_polylines[polyline].mv_vertexes.clear();
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2807,7 +3515,10 @@ void ObjModel :: removeFace (unsigned int mesh,
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 
-	vector<Face>& rv_faces = mv_meshes[mesh].mv_faces;
+	beginGeometryChange();
+
+	changeElementVertexCount(getFaceVertexCount(mesh, face), FACE_MINIMUM_VERTEXES, FACE_MINIMUM_VERTEXES);
+	vector<Face>& rv_faces = mp_geometry->mv_meshes[mesh].mv_faces;
 	unsigned int face_count = rv_faces.size();
 	for(unsigned int i = face + 1; i < face_count; i++)
 	{
@@ -2829,8 +3540,11 @@ void ObjModel :: removeFaceAll (unsigned int mesh)
 {
 	assert(mesh < getMeshCount());
 
-	mv_meshes[mesh].mv_faces.clear();
-	mv_meshes[mesh].m_all_triangles = true;
+	beginGeometryChange();
+
+	removeMeshElements(mesh, false, false, true);
+	mp_geometry->mv_meshes[mesh].mv_faces.clear();
+	mp_geometry->mv_meshes[mesh].m_all_triangles = true;
 
 	if(DEBUGGING_EDITING)
 		cout << "    Removed mesh #" << (mesh + 1) << ", all faces" << endl;
@@ -2846,7 +3560,9 @@ void ObjModel :: removeFaceVertex (unsigned int mesh,
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	vector<FaceVertex>& rv_vertexes = mv_meshes[mesh].mv_faces[face].mv_vertexes;
+	beginGeometryChange();
+
+	vector<FaceVertex>& rv_vertexes = mp_geometry->mv_meshes[mesh].mv_faces[face].mv_vertexes;
 	unsigned int vertex_count = rv_vertexes.size();
 	for(unsigned int i = vertex + 1; i < vertex_count; i++)
 	{
@@ -2854,7 +3570,7 @@ void ObjModel :: removeFaceVertex (unsigned int mesh,
 		rv_vertexes[i - 1] = rv_vertexes[i];
 	}
 	rv_vertexes.pop_back();
-	m_valid = false;
+	changeElementVertexCount(vertex_count, vertex_count - 1, FACE_MINIMUM_VERTEXES);
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2872,8 +3588,10 @@ void ObjModel :: removeFaceVertexAll (unsigned int mesh,
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 
-	mv_meshes[mesh].mv_faces[face].mv_vertexes.clear();
-	m_valid = false;
+	beginGeometryChange();
+
+	changeElementVertexCount(getFaceVertexCount(mesh, face), 0, FACE_MINIMUM_VERTEXES);
+	mp_geometry->mv_meshes[mesh].mv_faces[face].mv_vertexes.clear();
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2888,9 +3606,8 @@ void ObjModel :: removeFaceVertexAll (unsigned int mesh,
 
 void ObjModel :: validate ()
 {
-	bool old_valid = m_valid;
-
-	m_valid = true;
+	bool old_references_valid = m_is_references_valid;
+	unsigned int old_short_element_count = m_short_element_count;
 
 	if(DEBUGGING_VALIDATE)
 	{
@@ -2898,162 +3615,88 @@ void ObjModel :: validate ()
 		cout << "Texture Coordinates: " << getTextureCoordinateCount() << endl;
 		cout << "Vertex Normals: " << getNormalCount() << endl;
 
-		if(mv_material_libraries.size() > 0)
+		if(mp_geometry->mv_material_libraries.size() > 0)
 		{
 			cout << "Material Libraries:" << endl;
-			for(unsigned int i = 0; i < mv_material_libraries.size(); i++)
-				cout << "    " << mv_material_libraries[i].m_file_name << endl;
+			for(unsigned int i = 0; i < mp_geometry->mv_material_libraries.size(); i++)
+				cout << "    " << mp_geometry->mv_material_libraries[i].m_file_name << endl;
 		}
 	}
 
-	for(unsigned int m = 0; m < mv_meshes.size(); m++)
+	//
+	//  Split the faces of each mesh into ranges so that one
+	//    big mesh is checked by several threads.  Every mesh
+	//    gets at least one range for its point sets and
+	//    polylines.
+	//
+
+	vector<ValidationRange> v_ranges;
+	for(unsigned int m = 0; m < getMeshCount(); m++)
 	{
-/*
-		// bad materials cause too many crashes
-		if(mv_meshes[m].m_material_name != "" && mv_meshes[m].mp_material == NULL)
+		unsigned int face_count = getFaceCount(m);
+		unsigned int begin = 0;
+		do
 		{
-			if(DEBUGGING_VALIDATE)
-				cout << "Invalid material: Mesh " << s << " has non-existant material \"" << mv_meshes[m].m_material_name << "\"" << endl;
-			m_valid = false;
-
-			assert(old_valid == false);
-			assert(invariant());
-			return;
+			unsigned int end = min(face_count, begin + VALIDATE_CHUNK_SIZE);
+			v_ranges.push_back(ValidationRange(m, begin, end));
+			begin = end;
 		}
-*/
-		for(unsigned int p = 0; p < mv_meshes[m].mv_point_sets.size(); p++)
-		{
-			unsigned int point_set_vertex_count = mv_meshes[m].mv_point_sets[p].mv_vertexes.size();
-			if(point_set_vertex_count < 1)
-			{
-				m_valid = false;
-
-				assert(old_valid == false);
-				assert(invariant());
-				return;
-			}
-
-			for(unsigned int v = 0; v < point_set_vertex_count; v++)
-			{
-				unsigned int vertex = mv_meshes[m].mv_point_sets[p].mv_vertexes[v];
-
-				if(vertex >= getVertexCount())
-				{
-					if(DEBUGGING_VALIDATE)
-						cout << "Invalid vertex: Point Set " << p << ", vertex " << v << " has vertex " << (vertex + 1) << endl;
-					m_valid = false;
+		while(begin < face_count);
+	}
 
-					assert(old_valid == false);
-					assert(invariant());
-					return;
-				}
-			}
-		}
+	// debugging output would be interleaved between threads
+	unsigned int thread_count = JobSystem::getShared().getWorkerCount() + 1;
+	if(DEBUGGING_VALIDATE)
+		thread_count = 1;
 
-		for(unsigned int l = 0; l < mv_meshes[m].mv_polylines.size(); l++)
+	JobSystem::getShared().parallelFor((unsigned int)(v_ranges.size()), 1, thread_count,
+		[this, &v_ranges] (unsigned int begin, unsigned int end)
 		{
-			unsigned int polyline_vertex_count = mv_meshes[m].mv_polylines[l].mv_vertexes.size();
-			if(polyline_vertex_count < 2)
-			{
-				m_valid = false;
+			for(unsigned int r = begin; r < end; r++)
+				validateRange(v_ranges[r]);
+		});
 
-				assert(old_valid == false);
-				assert(invariant());
-				return;
-			}
-
-			for(unsigned int v = 0; v < polyline_vertex_count; v++)
-			{
-				unsigned int vertex = mv_meshes[m].mv_polylines[l].mv_vertexes[v].m_vertex;
-				unsigned int texture_coordinates = mv_meshes[m].mv_polylines[l].mv_vertexes[v].m_texture_coordinate;
-
-				if(vertex >= getVertexCount())
-				{
-					if(DEBUGGING_VALIDATE)
-						cout << "Invalid vertex: Polyline " << l << ", vertex " << v << " has vertex " << (vertex + 1) << endl;
-					m_valid = false;
-
-					assert(old_valid == false);
-					assert(invariant());
-					return;
-				}
-
-				if(texture_coordinates >= getTextureCoordinateCount() && texture_coordinates != NO_TEXTURE_COORDINATES)
-				{
-					if(DEBUGGING_VALIDATE)
-						cout << "Invalid texture coordinates: Polyline " << l << ", vertex " << v << " has texture coordinates " << (texture_coordinates + 1) << endl;
-					m_valid = false;
-
-					assert(old_valid == false);
-					assert(invariant());
-					return;
-				}
-			}
+	m_is_references_valid = true;
+	m_short_element_count = 0;
+	unsigned int r = 0;
+	for(unsigned int m = 0; m < getMeshCount(); m++)
+	{
+		bool all_triangles = true;
+		for( ; r < v_ranges.size() && v_ranges[r].m_mesh == m; r++)
+		{
+			if(!v_ranges[r].m_is_references_valid)
+				m_is_references_valid = false;
+			if(!v_ranges[r].m_is_all_triangles)
+				all_triangles = false;
+			m_short_element_count += v_ranges[r].m_short_element_count;
 		}
 
-		mv_meshes[m].m_all_triangles = true;
-		for(unsigned int f = 0; f < mv_meshes[m].mv_faces.size(); f++)
+		// only copy shared geometry if the flag really changes
+		if(mp_geometry->mv_meshes[m].m_all_triangles != all_triangles)
 		{
-			unsigned int face_vertex_count = mv_meshes[m].mv_faces[f].mv_vertexes.size();
-			if(face_vertex_count < 3)
-			{
-				m_valid = false;
-
-				assert(old_valid == false);
-				assert(invariant());
-				return;
-			}
-			else if(face_vertex_count > 3)
-				mv_meshes[m].m_all_triangles = false;
-
-			for(unsigned int v = 0; v < face_vertex_count; v++)
-			{
-				unsigned int vertex              = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_vertex;
-				unsigned int texture_coordinates = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_texture_coordinate;
-				unsigned int normal              = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_normal;
-
-				if(vertex >= getVertexCount())
-				{
-					if(DEBUGGING_VALIDATE)
-						cout << "Invalid vertex: Mesh " << m << ", face " << f << ", vertex " << v << " has vertex " << (vertex + 1) << endl;
-					m_valid = false;
-
-					assert(old_valid == false);
-					assert(invariant());
-					return;
-				}
-
-				if(texture_coordinates >= getTextureCoordinateCount() && texture_coordinates != NO_TEXTURE_COORDINATES)
-				{
-					if(DEBUGGING_VALIDATE)
-						cout << "Invalid texture coordinates: Mesh " << m << ", face " << f << ", vertex " << v << " has texture coordinates " << (texture_coordinates + 1) << endl;
-					m_valid = false;
-
-					assert(old_valid == false);
-					assert(invariant());
-					return;
-				}
-
-				if(normal >= getNormalCount() && normal != NO_NORMAL)
-				{
-					if(DEBUGGING_VALIDATE)
-						cout << "Invalid normal: Mesh " << m << ", face " << f << ", vertex " << v << " has normal " << (normal + 1) << endl;
-					m_valid = false;
-
-					assert(old_valid == false);
-					assert(invariant());
-					return;
-				}
-			}
+			beginGeometryChange();
+			mp_geometry->mv_meshes[m].m_all_triangles = all_triangles;
 		}
 	}
+	assert(r == v_ranges.size());
 
+	assert(m_is_references_valid || !old_references_valid);
+	assert(m_short_element_count == old_short_element_count);
 	assert(invariant());
 }
 
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
 
+void ObjModel :: drawImmediate () const
+{
+	assert(isValid());
+	assert(!Material::isMaterialActive());
 
-#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+	for(unsigned int m = 0; m < getMeshCount(); m++)
+		drawMeshMaterial(m, mp_geometry->mv_meshes[m].mp_material);
+
+	assert(!Material::isMaterialActive());
+}
 
 void ObjModel :: drawMeshMaterial (unsigned int mesh, const Material* p_material) const
 {
@@ -3084,14 +3727,14 @@ const Material* ObjModel :: getMaterialByName (const string& name) const
 {
 	assert(isValid());
 
-	for(unsigned int i = 0; i < mv_material_libraries.size(); i++)
+	for(unsigned int i = 0; i < mp_geometry->mv_material_libraries.size(); i++)
 	{
-		if(mv_material_libraries[i].mp_mtl_library == NULL)
+		if(mp_geometry->mv_material_libraries[i].mp_mtl_library == NULL)
 			continue;
 
-		unsigned int index = mv_material_libraries[i].mp_mtl_library->getMaterialIndex(name);
+		unsigned int index = mp_geometry->mv_material_libraries[i].mp_mtl_library->getMaterialIndex(name);
 		if(index != MtlLibrary::NO_SUCH_MATERIAL)
-			return mv_material_libraries[i].mp_mtl_library->getMaterial(index);
+			return mp_geometry->mv_material_libraries[i].mp_mtl_library->getMaterial(index);
 	}
 
 	return NULL;
@@ -3118,9 +3761,9 @@ void ObjModel :: drawPointSets (unsigned int mesh) const
 			for(unsigned int p = 0; p < getPointSetCount(mesh); p++)
 				for(unsigned int v = 0; v < getPointSetVertexCount(mesh, p); v++)
 				{
-					unsigned int vertex = mv_meshes[mesh].mv_point_sets[p].mv_vertexes[v];
+					Index vertex = mp_geometry->mv_meshes[mesh].mv_point_sets[p].mv_vertexes[v];
 
-					glVertex3dv(mv_vertexes[vertex].getAsArray());
+					glVertex3dv(mp_geometry->mv_vertexes[vertex].getAsArray());
 				}
 		glEnd();
 	}
@@ -3136,17 +3779,17 @@ void ObjModel :: drawPolylines (unsigned int mesh) const
 		glBegin(GL_LINE_STRIP);
 			for(unsigned int v = 0; v < getPolylineVertexCount(mesh, l); v++)
 			{
-				unsigned int vertex              = mv_meshes[mesh].mv_polylines[l].mv_vertexes[v].m_vertex;
-				unsigned int texture_coordinates = mv_meshes[mesh].mv_polylines[l].mv_vertexes[v].m_texture_coordinate;
+				Index vertex              = mp_geometry->mv_meshes[mesh].mv_polylines[l].mv_vertexes[v].m_vertex;
+				Index texture_coordinates = mp_geometry->mv_meshes[mesh].mv_polylines[l].mv_vertexes[v].m_texture_coordinate;
 
 				if(texture_coordinates != NO_TEXTURE_COORDINATES)
 				{
 					// flip texture coordinates to match Maya <|>
-					glTexCoord2d(      mv_texture_coordinates[texture_coordinates].x,
-					             1.0 - mv_texture_coordinates[texture_coordinates].y);
+					glTexCoord2d(      mp_geometry->mv_texture_coordinates[texture_coordinates].x,
+					             1.0 - mp_geometry->mv_texture_coordinates[texture_coordinates].y);
 				}
 
-				glVertex3dv(mv_vertexes[vertex].getAsArray());
+				glVertex3dv(mp_geometry->mv_vertexes[vertex].getAsArray());
 			}
 		glEnd();
 	}
@@ -3157,7 +3800,7 @@ void ObjModel :: drawFaces (unsigned int mesh) const
 	assert(isValid());
 	assert(mesh < getMeshCount());
 
-	bool is_all_triangles = mv_meshes[mesh].m_all_triangles;
+	bool is_all_triangles = mp_geometry->mv_meshes[mesh].m_all_triangles;
 
 	// if everything is triangles, draw everything as one triangle group
 	if(is_all_triangles)
@@ -3171,21 +3814,21 @@ void ObjModel :: drawFaces (unsigned int mesh) const
 
 		for(unsigned int v = 0; v < getFaceVertexCount(mesh, f); v++)
 		{
-			unsigned int vertex              = mv_meshes[mesh].mv_faces[f].mv_vertexes[v].m_vertex;
-			unsigned int texture_coordinates = mv_meshes[mesh].mv_faces[f].mv_vertexes[v].m_texture_coordinate;
-			unsigned int normal              = mv_meshes[mesh].mv_faces[f].mv_vertexes[v].m_normal;
+			Index vertex              = mp_geometry->mv_meshes[mesh].mv_faces[f].mv_vertexes[v].m_vertex;
+			Index texture_coordinates = mp_geometry->mv_meshes[mesh].mv_faces[f].mv_vertexes[v].m_texture_coordinate;
+			Index normal              = mp_geometry->mv_meshes[mesh].mv_faces[f].mv_vertexes[v].m_normal;
 
 			if(normal != NO_NORMAL)
-				glNormal3dv(mv_normals[normal].getAsArray());
+				glNormal3dv(mp_geometry->mv_normals[normal].getAsArray());
 
 			if(texture_coordinates != NO_TEXTURE_COORDINATES)
 			{
 				// flip texture coordinates to match Maya <|>
-				glTexCoord2d(      mv_texture_coordinates[texture_coordinates].x,
-				             1.0 - mv_texture_coordinates[texture_coordinates].y);
+				glTexCoord2d(      mp_geometry->mv_texture_coordinates[texture_coordinates].x,
+				             1.0 - mp_geometry->mv_texture_coordinates[texture_coordinates].y);
 			}
 
-			glVertex3dv(mv_vertexes[vertex].getAsArray());
+			glVertex3dv(mp_geometry->mv_vertexes[vertex].getAsArray());
 		}
 
 		// end of current trinagle fan
@@ -3198,6 +3841,292 @@ void ObjModel :: drawFaces (unsigned int mesh) const
 		glEnd();
 }
 
+void ObjModel :: drawWithArrays () const
+{
+	assert(isValid());
+	assert(!Material::isMaterialActive());
+
+	if(!mp_geometry->m_draw_arrays.m_is_built)
+	{
+		if(!buildDrawArrays())
+		{
+			// too big for vertex arrays, so use the DisplayList
+			mp_geometry->m_is_draw_arrays_used = false;
+			drawImmediate();
+			return;
+		}
+	}
+	else
+		updateDrawArrays();
+
+	for(unsigned int m = 0; m < getMeshCount(); m++)
+	{
+		const Material* p_material = mp_geometry->mv_meshes[m].mp_material;
+
+		if(p_material != NULL)
+			p_material->activate();
+		drawPointSets(m);
+		drawPolylines(m);
+		drawFacesArrays(m);
+
+		if(p_material != NULL)
+		{
+			Material::deactivate();
+
+			if(p_material->isSeperateSpecular())
+			{
+				p_material->activateSeperateSpecular();
+				drawPointSets(m);
+				drawPolylines(m);
+				drawFacesArrays(m);
+				Material::deactivate();
+			}
+		}
+	}
+
+	assert(!Material::isMaterialActive());
+}
+
+void ObjModel :: drawFacesArrays (unsigned int mesh) const
+{
+	assert(isValid());
+	assert(mesh < getMeshCount());
+	assert(mp_geometry->m_draw_arrays.m_is_built);
+
+	const DrawArrays& arrays = mp_geometry->m_draw_arrays;
+	const vector<unsigned int>& v_indexes = arrays.mvv_mesh_indexes[mesh];
+	if(v_indexes.empty())
+		return;
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(3, GL_FLOAT, 0, &(arrays.mv_position_data[0]));
+	if(arrays.mv_mesh_is_normals[mesh])
+	{
+		glEnableClientState(GL_NORMAL_ARRAY);
+		glNormalPointer(GL_FLOAT, 0, &(arrays.mv_normal_data[0]));
+	}
+	if(arrays.mv_mesh_is_texture_coordinates[mesh])
+	{
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(2, GL_FLOAT, 0, &(arrays.mv_texture_coordinate_data[0]));
+	}
+
+	glDrawElements(GL_TRIANGLES, (GLsizei)(v_indexes.size()),
+	               GL_UNSIGNED_INT, &(v_indexes[0]));
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_NORMAL_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+}
+
+bool ObjModel :: buildDrawArrays () const
+{
+	assert(isValid());
+
+	DrawArrays& r_arrays = mp_geometry->m_draw_arrays;
+	Index vertex_count = getVertexCount();
+	Index normal_count = getNormalCount();
+
+	//
+	//  As in MorphModel, each unique vertex/texture
+	//    coordinate/normal combination becomes a draw vertex.
+	//    Most vertexes only appear in a few combinations, so we
+	//    search a short list for each vertex.
+	//
+
+	struct Combination
+	{
+		Index m_texture_coordinate;
+		Index m_normal;
+		unsigned int m_draw_vertex;
+	};
+	vector<vector<Combination> > vv_combinations(vertex_count);
+
+	r_arrays.mv_vertexes.clear();
+	r_arrays.mv_normals.clear();
+	r_arrays.mv_texture_coordinate_data.clear();
+	r_arrays.mvv_mesh_indexes.clear();
+	r_arrays.mvv_mesh_indexes.resize(getMeshCount());
+	r_arrays.mv_mesh_is_normals.assign(getMeshCount(), false);
+	r_arrays.mv_mesh_is_texture_coordinates.assign(getMeshCount(), false);
+
+	for(unsigned int m = 0; m < getMeshCount(); m++)
+	{
+		const Mesh& mesh = mp_geometry->mv_meshes[m];
+		vector<unsigned int>& rv_indexes = r_arrays.mvv_mesh_indexes[m];
+
+		for(unsigned int f = 0; f < mesh.mv_faces.size(); f++)
+		{
+			const vector<FaceVertex>& v_face_vertexes = mesh.mv_faces[f].mv_vertexes;
+			unsigned int first_draw_vertex    = 0;
+			unsigned int previous_draw_vertex = 0;
+
+			for(unsigned int v = 0; v < v_face_vertexes.size(); v++)
+			{
+				Index vertex             = v_face_vertexes[v].m_vertex;
+				Index texture_coordinate = v_face_vertexes[v].m_texture_coordinate;
+				Index normal             = v_face_vertexes[v].m_normal;
+				assert(vertex < vertex_count);
+				if(normal != NO_NORMAL)
+					r_arrays.mv_mesh_is_normals[m] = true;
+				if(texture_coordinate != NO_TEXTURE_COORDINATES)
+					r_arrays.mv_mesh_is_texture_coordinates[m] = true;
+
+				unsigned int draw_vertex = (unsigned int)(r_arrays.mv_vertexes.size());
+				vector<Combination>& rv_list = vv_combinations[vertex];
+				for(unsigned int c = 0; c < rv_list.size(); c++)
+					if(rv_list[c].m_texture_coordinate == texture_coordinate &&
+					   rv_list[c].m_normal == normal)
+					{
+						draw_vertex = rv_list[c].m_draw_vertex;
+						break;
+					}
+
+				if(draw_vertex == r_arrays.mv_vertexes.size())
+				{
+					if(draw_vertex >= DRAW_ARRAYS_COUNT_MAX)
+					{
+						r_arrays = DrawArrays();
+						return false;
+					}
+
+					Combination combination;
+					combination.m_texture_coordinate = texture_coordinate;
+					combination.m_normal             = normal;
+					combination.m_draw_vertex        = draw_vertex;
+					rv_list.push_back(combination);
+
+					r_arrays.mv_vertexes.push_back(vertex);
+					r_arrays.mv_normals.push_back(normal);
+					if(texture_coordinate != NO_TEXTURE_COORDINATES)
+					{
+						// flip texture coordinates to match Maya <|>
+						const Vector2& tc = mp_geometry->mv_texture_coordinates[texture_coordinate];
+						r_arrays.mv_texture_coordinate_data.push_back((float)(tc.x));
+						r_arrays.mv_texture_coordinate_data.push_back((float)(1.0 - tc.y));
+					}
+					else
+					{
+						r_arrays.mv_texture_coordinate_data.push_back(0.0f);
+						r_arrays.mv_texture_coordinate_data.push_back(0.0f);
+					}
+				}
+
+				// split into a triangle fan
+				if(v == 0)
+					first_draw_vertex = draw_vertex;
+				else if(v >= 2)
+				{
+					if(rv_indexes.size() >= DRAW_ARRAYS_COUNT_MAX - 3)
+					{
+						r_arrays = DrawArrays();
+						return false;
+					}
+
+					rv_indexes.push_back(first_draw_vertex);
+					rv_indexes.push_back(previous_draw_vertex);
+					rv_indexes.push_back(draw_vertex);
+				}
+				previous_draw_vertex = draw_vertex;
+			}
+		}
+	}
+
+	// list the draw vertexes that use each vertex and normal
+	unsigned int draw_vertex_count = (unsigned int)(r_arrays.mv_vertexes.size());
+	r_arrays.mv_vertex_use_starts.assign(vertex_count + 1, 0);
+	r_arrays.mv_normal_use_starts.assign(normal_count + 1, 0);
+	for(unsigned int i = 0; i < draw_vertex_count; i++)
+	{
+		r_arrays.mv_vertex_use_starts[r_arrays.mv_vertexes[i] + 1]++;
+		if(r_arrays.mv_normals[i] != NO_NORMAL)
+			r_arrays.mv_normal_use_starts[r_arrays.mv_normals[i] + 1]++;
+	}
+	for(Index v = 0; v < vertex_count; v++)
+		r_arrays.mv_vertex_use_starts[v + 1] += r_arrays.mv_vertex_use_starts[v];
+	for(Index n = 0; n < normal_count; n++)
+		r_arrays.mv_normal_use_starts[n + 1] += r_arrays.mv_normal_use_starts[n];
+
+	r_arrays.mv_vertex_uses.resize(r_arrays.mv_vertex_use_starts[vertex_count]);
+	r_arrays.mv_normal_uses.resize(r_arrays.mv_normal_use_starts[normal_count]);
+	vector<unsigned int> v_vertex_next(r_arrays.mv_vertex_use_starts.begin(),
+	                                   r_arrays.mv_vertex_use_starts.end() - 1);
+	vector<unsigned int> v_normal_next(r_arrays.mv_normal_use_starts.begin(),
+	                                   r_arrays.mv_normal_use_starts.end() - 1);
+	for(unsigned int i = 0; i < draw_vertex_count; i++)
+	{
+		r_arrays.mv_vertex_uses[v_vertex_next[r_arrays.mv_vertexes[i]]++] = i;
+		if(r_arrays.mv_normals[i] != NO_NORMAL)
+			r_arrays.mv_normal_uses[v_normal_next[r_arrays.mv_normals[i]]++] = i;
+	}
+
+	// fill in everything as if it had all changed
+	r_arrays.mv_position_data.assign(draw_vertex_count * 3, 0.0f);
+	r_arrays.mv_normal_data  .assign(draw_vertex_count * 3, 0.0f);
+	r_arrays.mv_dirty_vertex_ranges.clear();
+	r_arrays.mv_dirty_normal_ranges.clear();
+	if(vertex_count > 0)
+	{
+		r_arrays.mv_dirty_vertex_ranges.push_back(0);
+		r_arrays.mv_dirty_vertex_ranges.push_back(vertex_count);
+	}
+	if(normal_count > 0)
+	{
+		r_arrays.mv_dirty_normal_ranges.push_back(0);
+		r_arrays.mv_dirty_normal_ranges.push_back(normal_count);
+	}
+	r_arrays.m_is_built = true;
+	updateDrawArrays();
+	return true;
+}
+
+void ObjModel :: updateDrawArrays () const
+{
+	assert(isValid());
+	assert(mp_geometry->m_draw_arrays.m_is_built);
+
+	DrawArrays& r_arrays = mp_geometry->m_draw_arrays;
+
+	for(unsigned int r = 0; r < r_arrays.mv_dirty_vertex_ranges.size(); r += 2)
+	{
+		Index end = r_arrays.mv_dirty_vertex_ranges[r + 1];
+		assert(end <= getVertexCount());
+
+		for(Index v = r_arrays.mv_dirty_vertex_ranges[r]; v < end; v++)
+		{
+			const Vector3& position = mp_geometry->mv_vertexes[v];
+			for(unsigned int u = r_arrays.mv_vertex_use_starts[v]; u < r_arrays.mv_vertex_use_starts[v + 1]; u++)
+			{
+				float* a_data = &(r_arrays.mv_position_data[r_arrays.mv_vertex_uses[u] * 3]);
+				a_data[0] = (float)(position.x);
+				a_data[1] = (float)(position.y);
+				a_data[2] = (float)(position.z);
+			}
+		}
+	}
+
+	for(unsigned int r = 0; r < r_arrays.mv_dirty_normal_ranges.size(); r += 2)
+	{
+		Index end = r_arrays.mv_dirty_normal_ranges[r + 1];
+		assert(end <= getNormalCount());
+
+		for(Index n = r_arrays.mv_dirty_normal_ranges[r]; n < end; n++)
+		{
+			const Vector3& normal = mp_geometry->mv_normals[n];
+			for(unsigned int u = r_arrays.mv_normal_use_starts[n]; u < r_arrays.mv_normal_use_starts[n + 1]; u++)
+			{
+				float* a_data = &(r_arrays.mv_normal_data[r_arrays.mv_normal_uses[u] * 3]);
+				a_data[0] = (float)(normal.x);
+				a_data[1] = (float)(normal.y);
+				a_data[2] = (float)(normal.z);
+			}
+		}
+	}
+
+	r_arrays.mv_dirty_vertex_ranges.clear();
+	r_arrays.mv_dirty_normal_ranges.clear();
+}
+
 #endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
 
 
@@ -3330,14 +4259,14 @@ ObjVbo<float> ObjModel :: createPointSetVboVertexOnly (unsigned int mesh) const
 	PositionOnly* d_vertexes        = new PositionOnly[point_count_total];
 
 	unsigned int next_point = 0;
-	for(unsigned int p = 0; p < mv_meshes[mesh].mv_point_sets.size(); p++)
+	for(unsigned int p = 0; p < mp_geometry->mv_meshes[mesh].mv_point_sets.size(); p++)
 	{
-		const vector<unsigned int>& v_vertex_ids = mv_meshes[mesh].mv_point_sets[p].mv_vertexes;
+		const vector<unsigned int>& v_vertex_ids = mp_geometry->mv_meshes[mesh].mv_point_sets[p].mv_vertexes;
 		for(unsigned int i = 0; i < v_vertex_ids.size(); i++)
 		{
 			assert(i < v_vertex_ids.size());
-			assert(v_vertex_ids[i] < mv_vertexes.size());
-			const Vector3& vertex = mv_vertexes[v_vertex_ids[i]];
+			assert(v_vertex_ids[i] < mp_geometry->mv_vertexes.size());
+			const Vector3& vertex = mp_geometry->mv_vertexes[v_vertex_ids[i]];
 
 			assert(next_point < point_count_total);
 			d_vertexes[next_point].m_x = (float)(vertex.x);
@@ -3369,15 +4298,15 @@ ObjVbo<float> ObjModel :: createPolylineVboVertexOnly (unsigned int mesh,
 
 	using namespace VertexDataFormat;
 
-	const vector<PolylineVertex>& v_vertex_ids = mv_meshes[mesh].mv_polylines[polyline].mv_vertexes;
+	const vector<PolylineVertex>& v_vertex_ids = mp_geometry->mv_meshes[mesh].mv_polylines[polyline].mv_vertexes;
 	unsigned int                  vertex_count = v_vertex_ids.size();
 	PositionOnly*                 d_vertexes   = new PositionOnly[vertex_count];
 
 	for(unsigned int i = 0; i < v_vertex_ids.size(); i++)
 	{
 		assert(i < v_vertex_ids.size());
-		assert(v_vertex_ids[i].m_vertex < mv_vertexes.size());
-		const Vector3& vertex = mv_vertexes[v_vertex_ids[i].m_vertex];
+		assert(v_vertex_ids[i].m_vertex < mp_geometry->mv_vertexes.size());
+		const Vector3& vertex = mp_geometry->mv_vertexes[v_vertex_ids[i].m_vertex];
 
 		d_vertexes[i].m_x = (float)(vertex.x);
 		d_vertexes[i].m_y = (float)(vertex.y);
@@ -3402,23 +4331,23 @@ ObjVbo<float> ObjModel :: createPolylineVboVertexTextureCoordinate (unsigned int
 
 	using namespace VertexDataFormat;
 
-	const vector<PolylineVertex>& v_vertex_ids = mv_meshes[mesh].mv_polylines[polyline].mv_vertexes;
+	const vector<PolylineVertex>& v_vertex_ids = mp_geometry->mv_meshes[mesh].mv_polylines[polyline].mv_vertexes;
 	unsigned int                  vertex_count = v_vertex_ids.size();
 	PositionTextureCoordinate*    d_vertexes   = new PositionTextureCoordinate[vertex_count];
 
 	for(unsigned int i = 0; i < v_vertex_ids.size(); i++)
 	{
 		assert(i < v_vertex_ids.size());
-		assert(v_vertex_ids[i].m_vertex < mv_vertexes.size());
-		const Vector3& vertex             = mv_vertexes[v_vertex_ids[i].m_vertex];
+		assert(v_vertex_ids[i].m_vertex < mp_geometry->mv_vertexes.size());
+		const Vector3& vertex             = mp_geometry->mv_vertexes[v_vertex_ids[i].m_vertex];
 
 		d_vertexes[i].m_x = (float)(vertex.x);
 		d_vertexes[i].m_y = (float)(vertex.y);
 		d_vertexes[i].m_z = (float)(vertex.z);
 
-		if(v_vertex_ids[i].m_texture_coordinate < mv_texture_coordinates.size())
+		if(v_vertex_ids[i].m_texture_coordinate < mp_geometry->mv_texture_coordinates.size())
 		{
-			const Vector2& texture_coordinate = mv_texture_coordinates[v_vertex_ids[i].m_texture_coordinate];
+			const Vector2& texture_coordinate = mp_geometry->mv_texture_coordinates[v_vertex_ids[i].m_texture_coordinate];
 
 			// flip texture coordinates to match Maya <|>
 			d_vertexes[i].m_s =        (float)(texture_coordinate.x);
@@ -3461,8 +4390,8 @@ ObjVbo<float> ObjModel :: createFaceVboVertexOnly (unsigned int mesh,
 		{
 			assert(vv_arrangement[i].size() == 1); // cannot be more because all the same
 
-			assert(i < mv_vertexes.size());
-			const Vector3& vertex = mv_vertexes[i];
+			assert(i < mp_geometry->mv_vertexes.size());
+			const Vector3& vertex = mp_geometry->mv_vertexes[i];
 
 			d_vertexes[next_vertex].m_x = (float)(vertex.x);
 			d_vertexes[next_vertex].m_y = (float)(vertex.y);
@@ -3517,16 +4446,16 @@ ObjVbo<float> ObjModel :: createFaceVboVertexTextureCoordinate (unsigned int mes
 		{
 			const TextureCoordinateAndNormal& element = vv_arrangement[i][j];
 
-			assert(i < mv_vertexes.size());
-			const Vector3& vertex = mv_vertexes[i];
+			assert(i < mp_geometry->mv_vertexes.size());
+			const Vector3& vertex = mp_geometry->mv_vertexes[i];
 
 			d_vertexes[next_vertex].m_x = (float)(vertex.x);
 			d_vertexes[next_vertex].m_y = (float)(vertex.y);
 			d_vertexes[next_vertex].m_z = (float)(vertex.z);
 
-			if(element.m_texture_coordinate < mv_texture_coordinates.size())
+			if(element.m_texture_coordinate < mp_geometry->mv_texture_coordinates.size())
 			{
-				const Vector2& texture_coordinate = mv_texture_coordinates[element.m_texture_coordinate];
+				const Vector2& texture_coordinate = mp_geometry->mv_texture_coordinates[element.m_texture_coordinate];
 
 				// flip texture coordinates to match Maya <|>
 				d_vertexes[next_vertex].m_s =        (float)(texture_coordinate.x);
@@ -3575,16 +4504,16 @@ ObjVbo<float> ObjModel :: createFaceVboVertexNormal (unsigned int mesh,
 		{
 			const TextureCoordinateAndNormal& element = vv_arrangement[i][j];
 
-			assert(i < mv_vertexes.size());
-			const Vector3& vertex = mv_vertexes[i];
+			assert(i < mp_geometry->mv_vertexes.size());
+			const Vector3& vertex = mp_geometry->mv_vertexes[i];
 
 			d_vertexes[next_vertex].m_x = (float)(vertex.x);
 			d_vertexes[next_vertex].m_y = (float)(vertex.y);
 			d_vertexes[next_vertex].m_z = (float)(vertex.z);
 
-			if(element.m_normal < mv_normals.size())
+			if(element.m_normal < mp_geometry->mv_normals.size())
 			{
-				const Vector3& normal = mv_normals[element.m_normal];
+				const Vector3& normal = mp_geometry->mv_normals[element.m_normal];
 
 				d_vertexes[next_vertex].m_nx = (float)(normal.x);
 				d_vertexes[next_vertex].m_ny = (float)(normal.y);
@@ -3634,16 +4563,16 @@ ObjVbo<float> ObjModel :: createFaceVboVertexTextureCoordinateNormal (unsigned i
 		{
 			const TextureCoordinateAndNormal& element = vv_arrangement[i][j];
 
-			assert(i < mv_vertexes.size());
-			const Vector3& vertex = mv_vertexes[i];
+			assert(i < mp_geometry->mv_vertexes.size());
+			const Vector3& vertex = mp_geometry->mv_vertexes[i];
 
 			d_vertexes[next_vertex].m_x = (float)(vertex.x);
 			d_vertexes[next_vertex].m_y = (float)(vertex.y);
 			d_vertexes[next_vertex].m_z = (float)(vertex.z);
 
-			if(element.m_texture_coordinate < mv_texture_coordinates.size())
+			if(element.m_texture_coordinate < mp_geometry->mv_texture_coordinates.size())
 			{
-				const Vector2& texture_coordinate = mv_texture_coordinates[element.m_texture_coordinate];
+				const Vector2& texture_coordinate = mp_geometry->mv_texture_coordinates[element.m_texture_coordinate];
 
 				// flip texture coordinates to match Maya <|>
 				d_vertexes[next_vertex].m_s =        (float)(texture_coordinate.x);
@@ -3656,9 +4585,9 @@ ObjVbo<float> ObjModel :: createFaceVboVertexTextureCoordinateNormal (unsigned i
 				d_vertexes[next_vertex].m_t = (float)(FALLBACK_TEXTURE_COORDINATE.y);
 			}
 
-			if(element.m_normal < mv_normals.size())
+			if(element.m_normal < mp_geometry->mv_normals.size())
 			{
-				const Vector3& normal = mv_normals[element.m_normal];
+				const Vector3& normal = mp_geometry->mv_normals[element.m_normal];
 
 				d_vertexes[next_vertex].m_nx = (float)(normal.x);
 				d_vertexes[next_vertex].m_ny = (float)(normal.y);
@@ -3711,8 +4640,8 @@ ObjVbo<unsigned int> ObjModel :: createIndexVboForFaces (unsigned int mesh,
 	assert(getFaceCount(mesh) > 0);
 	assert(vv_arrangement.size() == getVertexCount());
 
-	assert(mesh < mv_meshes.size());
-	const vector<Face>& v_faces = mv_meshes[mesh].mv_faces;
+	assert(mesh < mp_geometry->mv_meshes.size());
+	const vector<Face>& v_faces = mp_geometry->mv_meshes[mesh].mv_faces;
 
 	// number all the vertex-with-datas, based on where they will be in the VBO
 	vector<unsigned int> v_start;
@@ -3855,9 +4784,9 @@ void ObjModel :: calculateVertexArrangement (unsigned int mesh,
 	//    mesh.
 	//
 
-	rvv_arrangement.resize(mv_vertexes.size());
+	rvv_arrangement.resize(mp_geometry->mv_vertexes.size());
 
-	const vector<Face>& v_faces = mv_meshes[mesh].mv_faces;
+	const vector<Face>& v_faces = mp_geometry->mv_meshes[mesh].mv_faces;
 	for(unsigned int f = 0; f < v_faces.size(); f++)
 	{
 		const vector<FaceVertex>& v_vertex_ids = v_faces[f].mv_vertexes;
@@ -3922,7 +4851,7 @@ void ObjModel :: calculateVertexArrangement (unsigned int mesh,
 			cout << "\t" << v << ":";
 			if(!rvv_arrangement[v].empty())
 			{
-				cout << "\t" << mv_vertexes[v] << endl;
+				cout << "\t" << mp_geometry->mv_vertexes[v] << endl;
 				for(unsigned int i = 0; i < rvv_arrangement[v].size(); i++)
 				{
 					cout << "\t\t\t(" << rvv_arrangement[v][i].m_texture_coordinate
@@ -4114,6 +5043,8 @@ bool ObjModel :: readNormal (const string& str, ostream& r_logstream)
 
 bool ObjModel :: readPointSet (const string& str, ostream& r_logstream)
 {
+	beginGeometryChange();
+
 	const unsigned int NO_POINT_SET = ~0u;
 
 	unsigned int point_set_index = NO_POINT_SET;
@@ -4126,19 +5057,16 @@ bool ObjModel :: readPointSet (const string& str, ostream& r_logstream)
 	else
 		start_index = 0;
 
-	if(mv_meshes.empty())
+	if(mp_geometry->mv_meshes.empty())
 		mesh_index = addMesh();
 	else
-		mesh_index = mv_meshes.size() - 1;
+		mesh_index = mp_geometry->mv_meshes.size() - 1;
 
 	for(string::size_type token_index = start_index; token_index != string::npos; token_index = nextToken(str, token_index))
 	{
-		int vertex;
+		Index vertex;
 
-		vertex = atoi(str.c_str() + token_index);
-		if(vertex < 0)
-			vertex += getVertexCount() + 1;
-		if(vertex <= 0)
+		if(!readIndex(str.c_str() + token_index, getVertexCount(), vertex))
 		{
 			if(point_set_index != NO_POINT_SET)
 				removeLastPointSet(mesh_index);
@@ -4148,10 +5076,6 @@ bool ObjModel :: readPointSet (const string& str, ostream& r_logstream)
 		if(point_set_index == NO_POINT_SET)
 			point_set_index = addPointSet(mesh_index);
 
-		// reduce indexes to start at 0 instead of 1
-		assert(vertex >= 1);
-		vertex--;
-
 		addPointSetVertex(mesh_index, point_set_index, vertex);
 	}
 
@@ -4161,6 +5085,8 @@ bool ObjModel :: readPointSet (const string& str, ostream& r_logstream)
 
 bool ObjModel :: readPolyline (const string& str, ostream& r_logstream)
 {
+	beginGeometryChange();
+
 	//
 	//  This function reads a polyline of vertexes in the
 	//    model, not a line of the input file.
@@ -4178,24 +5104,21 @@ bool ObjModel :: readPolyline (const string& str, ostream& r_logstream)
 	else
 		start_index = 0;
 
-	if(mv_meshes.empty())
+	if(mp_geometry->mv_meshes.empty())
 		mesh_index = addMesh();
 	else
-		mesh_index = mv_meshes.size() - 1;
+		mesh_index = mp_geometry->mv_meshes.size() - 1;
 
 	for(string::size_type token_index = start_index; token_index != string::npos; token_index = nextToken(str, token_index))
 	{
 		size_t number_index;
 
-		int vertex;
-		int texture_coordinates;
+		Index vertex;
+		Index texture_coordinates;
 
 		number_index = token_index;
 
-		vertex = atoi(str.c_str() + number_index);
-		if(vertex < 0)
-			vertex += getVertexCount() + 1;
-		if(vertex <= 0)
+		if(!readIndex(str.c_str() + number_index, getVertexCount(), vertex))
 		{
 			if(polyline_index != NO_LINE)
 				removeLastPolyline(mesh_index);
@@ -4213,29 +5136,17 @@ bool ObjModel :: readPolyline (const string& str, ostream& r_logstream)
 
 			if(isspace(str[number_index]))
 				texture_coordinates = NO_TEXTURE_COORDINATES;
-			else
+			else if(!readIndex(str.c_str() + number_index, getTextureCoordinateCount(), texture_coordinates))
 			{
-				texture_coordinates = atoi(str.c_str() + number_index);
-				if(texture_coordinates < 0)
-					texture_coordinates += getTextureCoordinateCount() + 1;
-				if(texture_coordinates <= 0)
-					return false;
+				if(polyline_index != NO_LINE)
+					removeLastPolyline(mesh_index);
+				return false;
 			}
 		}
 
 		if(polyline_index == NO_LINE)
 			polyline_index = addPolyline(mesh_index);
 
-		// reduce indexes to start at 0 instead of 1
-		assert(vertex >= 1);
-		vertex--;
-
-		if(texture_coordinates != NO_TEXTURE_COORDINATES)
-		{
-			assert(texture_coordinates >= 1);
-			texture_coordinates--;
-		}
-
 		addPolylineVertex(mesh_index, polyline_index, vertex, texture_coordinates);
 	}
 
@@ -4245,6 +5156,8 @@ bool ObjModel :: readPolyline (const string& str, ostream& r_logstream)
 
 bool ObjModel :: readFace (const string& str, ostream& r_logstream)
 {
+	beginGeometryChange();
+
 	const unsigned int NO_FACE = ~0u;
 
 	unsigned int face_index = NO_FACE;
@@ -4257,25 +5170,22 @@ bool ObjModel :: readFace (const string& str, ostream& r_logstream)
 	else
 		start_index = 0;
 
-	if(mv_meshes.empty())
+	if(mp_geometry->mv_meshes.empty())
 		mesh_index = addMesh();
 	else
-		mesh_index = mv_meshes.size() - 1;
+		mesh_index = mp_geometry->mv_meshes.size() - 1;
 
 	for(string::size_type token_index = start_index; token_index != string::npos; token_index = nextToken(str, token_index))
 	{
 		size_t number_index;
 
-		int vertex;
-		int texture_coordinates;
-		int normal;
+		Index vertex;
+		Index texture_coordinates;
+		Index normal;
 
 		number_index = token_index;
 
-		vertex = atoi(str.c_str() + number_index);
-		if(vertex < 0)
-			vertex += getVertexCount() + 1;
-		if(vertex <= 0)
+		if(!readIndex(str.c_str() + number_index, getVertexCount(), vertex))
 		{
 			if(face_index != NO_FACE)
 				removeLastFace(mesh_index);
@@ -4294,13 +5204,11 @@ bool ObjModel :: readFace (const string& str, ostream& r_logstream)
 
 			if(str[number_index] == '/')
 				texture_coordinates = NO_TEXTURE_COORDINATES;
-			else
+			else if(!readIndex(str.c_str() + number_index, getTextureCoordinateCount(), texture_coordinates))
 			{
-				texture_coordinates = atoi(str.c_str() + number_index);
-				if(texture_coordinates < 0)
-					texture_coordinates += getTextureCoordinateCount() + 1;
-				if(texture_coordinates <= 0)
-					return false;
+				if(face_index != NO_FACE)
+					removeLastFace(mesh_index);
+				return false;
 			}
 
 			number_index = nextSlashInToken(str, number_index);
@@ -4312,13 +5220,11 @@ bool ObjModel :: readFace (const string& str, ostream& r_logstream)
 
 				if(isspace(str[number_index]))
 					normal = NO_NORMAL;
-				else
+				else if(!readIndex(str.c_str() + number_index, getNormalCount(), normal))
 				{
-					normal = atoi(str.c_str() + number_index);
-					if(normal < 0)
-						normal += getNormalCount() + 1;
-					if(normal <= 0)
-						return false;
+					if(face_index != NO_FACE)
+						removeLastFace(mesh_index);
+					return false;
 				}
 			}
 		}
@@ -4326,26 +5232,208 @@ bool ObjModel :: readFace (const string& str, ostream& r_logstream)
 		if(face_index == NO_FACE)
 			face_index = addFace(mesh_index);
 
-		// reduce indexes to start at 0 instead of 1
-		assert(vertex >= 1);
-		vertex--;
+		addFaceVertex(mesh_index, face_index, vertex, texture_coordinates, normal);
+	}
+
+	// if we get here, all tokens were valid
+	return true;
+}
+
+bool ObjModel :: readBinary (istream& r_input,
+                             const string& filename,
+                             ostream& r_logstream)
+{
+	//
+	//  Format of file (see ObjStream.h):
+	//
+	//  Header
+	//  Material library names
+	//  Mesh records
+	//  Padding
+	//  Vertexes
+	//  Texture coordinates
+	//  Normals
+	//  Triangles
+	//
+
+	// every count in the header is checked against the file
+	//  size before anything is allocated for it
+	unsigned long long file_size;
+	if(!getRemainingSize(r_input, file_size))
+	{
+		r_logstream << "Error: File \"" << filename << "\" cannot be read" << endl;
+		return false;
+	}
+
+	ObjStream::BinaryHeader header;
+	if(!readBinaryValue(r_input, header) ||
+	   memcmp(header.ma_magic, ObjStream::BINARY_MAGIC, sizeof(ObjStream::BINARY_MAGIC)) != 0 ||
+	   header.m_version != ObjStream::BINARY_VERSION)
+	{
+		r_logstream << "Error: File \"" << filename << "\" is not a binary model file" << endl;
+		return false;
+	}
+
+	// the largest index is reserved for NO_NORMAL and
+	//   NO_TEXTURE_COORDINATES
+	if(header.m_vertex_count             >= NO_NORMAL ||
+	   header.m_texture_coordinate_count >= NO_NORMAL ||
+	   header.m_normal_count             >= NO_NORMAL)
+	{
+		r_logstream << "Error: File \"" << filename << "\" has too many elements for ObjModel::Index" << endl;
+		return false;
+	}
 
-		if(texture_coordinates != NO_TEXTURE_COORDINATES)
+	unsigned long long header_size = sizeof(header);
+	unsigned long long remaining = file_size - header_size;
+	if(!isBinaryArrayPresent(header.m_material_library_count, sizeof(unsigned int), remaining))
+	{
+		r_logstream << "Error: File \"" << filename << "\" is truncated" << endl;
+		return false;
+	}
+	vector<string> v_libraries(header.m_material_library_count);
+	for(unsigned int i = 0; i < header.m_material_library_count; i++)
+	{
+		if(!readBinaryString(r_input, file_size - header_size, v_libraries[i]))
 		{
-			assert(texture_coordinates >= 1);
-			texture_coordinates--;
+			r_logstream << "Error: File \"" << filename << "\" is truncated" << endl;
+			return false;
 		}
+		header_size += sizeof(unsigned int) + v_libraries[i].size();
+	}
 
-		if(normal != NO_NORMAL)
+	remaining = file_size - header_size;
+	if(!isBinaryArrayPresent(header.m_mesh_count, sizeof(unsigned int) + 2 * sizeof(unsigned long long), remaining))
+	{
+		r_logstream << "Error: File \"" << filename << "\" is truncated" << endl;
+		return false;
+	}
+	vector<string> v_mesh_materials(header.m_mesh_count);
+	vector<unsigned long long> v_mesh_triangle_counts(header.m_mesh_count);
+	unsigned long long triangle_total = 0;
+	for(unsigned int m = 0; m < header.m_mesh_count; m++)
+	{
+		unsigned long long first_triangle;
+		if(!readBinaryString(r_input, file_size - header_size, v_mesh_materials[m]) ||
+		   !readBinaryValue(r_input, first_triangle) ||
+		   !readBinaryValue(r_input, v_mesh_triangle_counts[m]))
 		{
-			assert(normal >= 1);
-			normal--;
+			r_logstream << "Error: File \"" << filename << "\" is truncated" << endl;
+			return false;
+		}
+		if(first_triangle != triangle_total ||
+		   v_mesh_triangle_counts[m] > UINT_MAX ||
+		   header.m_triangle_count - triangle_total < v_mesh_triangle_counts[m])
+		{
+			r_logstream << "Error: File \"" << filename << "\" has an invalid mesh" << endl;
+			return false;
 		}
+		triangle_total += v_mesh_triangle_counts[m];
+		header_size += sizeof(unsigned int) + v_mesh_materials[m].size() + 2 * sizeof(unsigned long long);
+	}
+	if(triangle_total != header.m_triangle_count)
+	{
+		r_logstream << "Error: File \"" << filename << "\" has an invalid mesh" << endl;
+		return false;
+	}
+	unsigned long long padding = (ObjStream::BINARY_ALIGNMENT - header_size % ObjStream::BINARY_ALIGNMENT) % ObjStream::BINARY_ALIGNMENT;
+	r_input.ignore((streamsize)(padding));
+
+	remaining = file_size - header_size;
+	if(!isBinaryArrayPresent(padding,                           1,                               remaining) ||
+	   !isBinaryArrayPresent(header.m_vertex_count,             sizeof(BinaryVertex),            remaining) ||
+	   !isBinaryArrayPresent(header.m_texture_coordinate_count, sizeof(BinaryTextureCoordinate), remaining) ||
+	   !isBinaryArrayPresent(header.m_normal_count,             sizeof(BinaryVertex),            remaining) ||
+	   !isBinaryArrayPresent(header.m_triangle_count,           sizeof(ObjStream::Triangle),     remaining))
+	{
+		r_logstream << "Error: File \"" << filename << "\" is truncated" << endl;
+		return false;
+	}
 
-		addFaceVertex(mesh_index, face_index, vertex, texture_coordinates, normal);
+	for(unsigned int i = 0; i < v_libraries.size(); i++)
+		if(v_libraries[i] != "")
+			addMaterialLibrary(v_libraries[i], r_logstream);
+
+	mp_geometry->mv_vertexes.reserve((size_t)(header.m_vertex_count));
+	mp_geometry->mv_texture_coordinates.reserve((size_t)(header.m_texture_coordinate_count));
+	mp_geometry->mv_normals.reserve((size_t)(header.m_normal_count));
+
+	// the elements are read in blocks, but added one at a time
+	vector<BinaryVertex> v_vertex_buffer;
+	vector<BinaryTextureCoordinate> v_texture_coordinate_buffer;
+	vector<ObjStream::Triangle> v_triangle_buffer;
+	bool is_complete = true;
+
+	is_complete = is_complete &&
+	              readBinaryArray<BinaryVertex>(r_input, header.m_vertex_count, v_vertex_buffer,
+	                                            [this] (const BinaryVertex& vertex)
+	{
+		addVertex(vertex.ma_values[0], vertex.ma_values[1], vertex.ma_values[2]);
+	});
+
+	is_complete = is_complete &&
+	              readBinaryArray<BinaryTextureCoordinate>(r_input, header.m_texture_coordinate_count, v_texture_coordinate_buffer,
+	                                                       [this] (const BinaryTextureCoordinate& texture_coordinate)
+	{
+		addTextureCoordinate(texture_coordinate.ma_values[0], texture_coordinate.ma_values[1]);
+	});
+
+	is_complete = is_complete &&
+	              readBinaryArray<BinaryVertex>(r_input, header.m_normal_count, v_vertex_buffer,
+	                                            [this, &r_logstream] (const BinaryVertex& normal)
+	{
+		const double* a = normal.ma_values;
+		if(a[0] == 0.0 && a[1] == 0.0 && a[2] == 0.0)
+		{
+			r_logstream << "Found a bad normal: #" << getNormalCount() << ", using " << FALLBACK_NORMAL << endl;
+			addNormal(FALLBACK_NORMAL_MACRO);
+		}
+		else
+			addNormal(a[0], a[1], a[2]);
+	});
+
+	bool is_index_valid = true;
+	for(unsigned int m = 0; m < header.m_mesh_count && is_complete; m++)
+	{
+		unsigned int mesh = addMesh();
+		if(v_mesh_materials[m] != "")
+			setMeshMaterial(mesh, v_mesh_materials[m]);
+		mp_geometry->mv_meshes[mesh].mv_faces.reserve((size_t)(v_mesh_triangle_counts[m]));
+
+		is_complete = readBinaryArray<ObjStream::Triangle>(r_input, v_mesh_triangle_counts[m], v_triangle_buffer,
+		                                                   [this, mesh, &is_index_valid] (const ObjStream::Triangle& triangle)
+		{
+			unsigned int face = addFace(mesh);
+			for(unsigned int c = 0; c < 3; c++)
+			{
+				unsigned long long vertex              = triangle.ma_vertexes[c];
+				unsigned long long texture_coordinates = triangle.ma_texture_coordinates[c];
+				unsigned long long normal              = triangle.ma_normals[c];
+
+				// ObjStream::NO_ELEMENT becomes NO_NORMAL or
+				//   NO_TEXTURE_COORDINATES
+				if(vertex >= NO_NORMAL ||
+				   (texture_coordinates != ObjStream::NO_ELEMENT && texture_coordinates >= NO_TEXTURE_COORDINATES) ||
+				   (normal != ObjStream::NO_ELEMENT && normal >= NO_NORMAL))
+				{
+					is_index_valid = false;
+				}
+				addFaceVertex(mesh, face, (Index)(vertex), (Index)(texture_coordinates), (Index)(normal));
+			}
+		});
+	}
+
+	if(!is_complete)
+	{
+		r_logstream << "Error: File \"" << filename << "\" is truncated" << endl;
+		return false;
+	}
+	if(!is_index_valid)
+	{
+		r_logstream << "Error: File \"" << filename << "\" has an index too large for ObjModel::Index" << endl;
+		return false;
 	}
 
-	// if we get here, all tokens were valid
 	return true;
 }
 
@@ -4354,8 +5442,10 @@ void ObjModel :: removeLastPointSet (unsigned int mesh)
 	assert(mesh < getMeshCount());
 	assert(getPointSetCount(mesh) >= 1);
 
-	mv_meshes[mesh].mv_point_sets.pop_back();
-	m_valid = false;
+	beginGeometryChange();
+
+	changeElementVertexCount(getPointSetVertexCount(mesh, getPointSetCount(mesh) - 1), POINT_SET_MINIMUM_VERTEXES, POINT_SET_MINIMUM_VERTEXES);
+	mp_geometry->mv_meshes[mesh].mv_point_sets.pop_back();
 }
 
 void ObjModel :: removeLastPolyline (unsigned int mesh)
@@ -4363,8 +5453,10 @@ void ObjModel :: removeLastPolyline (unsigned int mesh)
 	assert(mesh < getMeshCount());
 	assert(getPolylineCount(mesh) >= 1);
 
-	mv_meshes[mesh].mv_polylines.pop_back();
-	m_valid = false;
+	beginGeometryChange();
+
+	changeElementVertexCount(getPolylineVertexCount(mesh, getPolylineCount(mesh) - 1), POLYLINE_MINIMUM_VERTEXES, POLYLINE_MINIMUM_VERTEXES);
+	mp_geometry->mv_meshes[mesh].mv_polylines.pop_back();
 }
 
 void ObjModel :: removeLastFace (unsigned int mesh)
@@ -4372,12 +5464,248 @@ void ObjModel :: removeLastFace (unsigned int mesh)
 	assert(mesh < getMeshCount());
 	assert(getFaceCount(mesh) >= 1);
 
-	mv_meshes[mesh].mv_faces.pop_back();
-	m_valid = false;
+	beginGeometryChange();
+
+	changeElementVertexCount(getFaceVertexCount(mesh, getFaceCount(mesh) - 1), FACE_MINIMUM_VERTEXES, FACE_MINIMUM_VERTEXES);
+	mp_geometry->mv_meshes[mesh].mv_faces.pop_back();
+}
+
+void ObjModel :: beginGeometryChange ()
+{
+	assert(mp_geometry != NULL);
+
+	if(mp_geometry.use_count() > 1)
+		mp_geometry = make_shared<Geometry>(*mp_geometry);
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+	mp_geometry->m_is_draw_list_current   = false;
+	mp_geometry->m_draw_arrays.m_is_built = false;
+#endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
+	mp_geometry->m_is_bounding_box_current = false;
+
+	assert(mp_geometry.use_count() == 1);
+}
+
+void ObjModel :: beginVertexChange (Index vertex)
+{
+	assert(vertex < getVertexCount());
+	assert(mp_geometry != NULL);
+
+	if(mp_geometry.use_count() > 1)
+		mp_geometry = make_shared<Geometry>(*mp_geometry);
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+	// a model that has not been drawn yet keeps using the
+	//  DisplayList, so only models that are drawn between
+	//  changes are switched to vertex arrays
+	if(!mp_geometry->m_draw_list.isEmpty() || mp_geometry->m_draw_arrays.m_is_built)
+		mp_geometry->m_is_draw_arrays_used = true;
+	mp_geometry->m_is_draw_list_current = false;
+	if(mp_geometry->m_draw_arrays.m_is_built)
+		addDirtyIndex(mp_geometry->m_draw_arrays.mv_dirty_vertex_ranges, vertex);
+#endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
+	mp_geometry->m_is_bounding_box_current = false;
+
+	assert(mp_geometry.use_count() == 1);
+}
+
+void ObjModel :: updateBoundingBox () const
+{
+	Geometry& r_geometry = *mp_geometry;
+	lock_guard<mutex> lock(r_geometry.m_bounding_box_mutex);
+	if(r_geometry.m_is_bounding_box_current)
+		return;
+
+	const vector<Vector3>& v_vertexes = r_geometry.mv_vertexes;
+	Vector3 min_corner;
+	Vector3 max_corner;
+	if(!v_vertexes.empty())
+	{
+		min_corner = v_vertexes[0];
+		max_corner = v_vertexes[0];
+	}
+	for(Index v = 1; v < v_vertexes.size(); v++)
+	{
+		const Vector3& position = v_vertexes[v];
+		if(position.x < min_corner.x) min_corner.x = position.x;
+		if(position.y < min_corner.y) min_corner.y = position.y;
+		if(position.z < min_corner.z) min_corner.z = position.z;
+		if(position.x > max_corner.x) max_corner.x = position.x;
+		if(position.y > max_corner.y) max_corner.y = position.y;
+		if(position.z > max_corner.z) max_corner.z = position.z;
+	}
+
+	r_geometry.m_bounding_box_min = min_corner;
+	r_geometry.m_bounding_box_max = max_corner;
+	r_geometry.m_is_bounding_box_current = true;
+}
+
+void ObjModel :: beginNormalChange (Index normal)
+{
+	assert(normal < getNormalCount());
+	assert(mp_geometry != NULL);
+
+	if(mp_geometry.use_count() > 1)
+		mp_geometry = make_shared<Geometry>(*mp_geometry);
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+	if(!mp_geometry->m_draw_list.isEmpty() || mp_geometry->m_draw_arrays.m_is_built)
+		mp_geometry->m_is_draw_arrays_used = true;
+	mp_geometry->m_is_draw_list_current = false;
+	if(mp_geometry->m_draw_arrays.m_is_built)
+		addDirtyIndex(mp_geometry->m_draw_arrays.mv_dirty_normal_ranges, normal);
+#endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
+
+	assert(mp_geometry.use_count() == 1);
+}
+
+void ObjModel :: changeElementVertexCount (unsigned int old_count,
+                                           unsigned int new_count,
+                                           unsigned int minimum)
+{
+	bool was_short = old_count < minimum;
+	bool is_short  = new_count < minimum;
+
+	if(is_short && !was_short)
+		m_short_element_count++;
+	else if(was_short && !is_short)
+	{
+		assert(m_short_element_count > 0);
+		m_short_element_count--;
+	}
+}
+
+void ObjModel :: removeMeshElements (unsigned int mesh,
+                                     bool is_point_sets,
+                                     bool is_polylines,
+                                     bool is_faces)
+{
+	assert(mesh < getMeshCount());
+
+	// nothing to find if every element is long enough
+	if(m_short_element_count == 0)
+		return;
+
+	const Mesh& mesh_data = mp_geometry->mv_meshes[mesh];
+	if(is_point_sets)
+		for(unsigned int p = 0; p < mesh_data.mv_point_sets.size(); p++)
+			changeElementVertexCount(mesh_data.mv_point_sets[p].mv_vertexes.size(), POINT_SET_MINIMUM_VERTEXES, POINT_SET_MINIMUM_VERTEXES);
+	if(is_polylines)
+		for(unsigned int l = 0; l < mesh_data.mv_polylines.size(); l++)
+			changeElementVertexCount(mesh_data.mv_polylines[l].mv_vertexes.size(), POLYLINE_MINIMUM_VERTEXES, POLYLINE_MINIMUM_VERTEXES);
+	if(is_faces)
+		for(unsigned int f = 0; f < mesh_data.mv_faces.size(); f++)
+			changeElementVertexCount(mesh_data.mv_faces[f].mv_vertexes.size(), FACE_MINIMUM_VERTEXES, FACE_MINIMUM_VERTEXES);
+}
+
+const shared_ptr<ObjModel :: Geometry>& ObjModel :: getEmptyGeometry ()
+{
+	// never changed, because this reference keeps it shared
+	static const shared_ptr<Geometry> EMPTY = make_shared<Geometry>();
+	return EMPTY;
+}
+
+void ObjModel :: validateRange (ValidationRange& r_range) const
+{
+	assert(r_range.m_mesh < getMeshCount());
+	assert(r_range.m_face_begin <= r_range.m_face_end);
+	assert(r_range.m_face_end <= getFaceCount(r_range.m_mesh));
+
+	const Mesh& mesh_data = mp_geometry->mv_meshes[r_range.m_mesh];
+	Index vertex_count             = getVertexCount();
+	Index texture_coordinate_count = getTextureCoordinateCount();
+	Index normal_count             = getNormalCount();
+
+	r_range.m_short_element_count = 0;
+	r_range.m_is_references_valid = true;
+	r_range.m_is_all_triangles    = true;
+
+	// the first range in each mesh also checks the point sets and polylines
+	if(r_range.m_face_begin == 0)
+	{
+		for(unsigned int p = 0; p < mesh_data.mv_point_sets.size(); p++)
+		{
+			const vector<Index>& v_vertexes = mesh_data.mv_point_sets[p].mv_vertexes;
+			if(v_vertexes.size() < POINT_SET_MINIMUM_VERTEXES)
+				r_range.m_short_element_count++;
+
+			for(unsigned int v = 0; v < v_vertexes.size(); v++)
+			{
+				if(v_vertexes[v] >= vertex_count)
+				{
+					if(DEBUGGING_VALIDATE)
+						cout << "Invalid vertex: Point Set " << p << ", vertex " << v << " has vertex " << (v_vertexes[v] + 1) << endl;
+					r_range.m_is_references_valid = false;
+				}
+			}
+		}
+
+		for(unsigned int l = 0; l < mesh_data.mv_polylines.size(); l++)
+		{
+			const vector<PolylineVertex>& v_vertexes = mesh_data.mv_polylines[l].mv_vertexes;
+			if(v_vertexes.size() < POLYLINE_MINIMUM_VERTEXES)
+				r_range.m_short_element_count++;
+
+			for(unsigned int v = 0; v < v_vertexes.size(); v++)
+			{
+				Index vertex              = v_vertexes[v].m_vertex;
+				Index texture_coordinates = v_vertexes[v].m_texture_coordinate;
+
+				if(vertex >= vertex_count)
+				{
+					if(DEBUGGING_VALIDATE)
+						cout << "Invalid vertex: Polyline " << l << ", vertex " << v << " has vertex " << (vertex + 1) << endl;
+					r_range.m_is_references_valid = false;
+				}
+
+				if(texture_coordinates >= texture_coordinate_count && texture_coordinates != NO_TEXTURE_COORDINATES)
+				{
+					if(DEBUGGING_VALIDATE)
+						cout << "Invalid texture coordinates: Polyline " << l << ", vertex " << v << " has texture coordinates " << (texture_coordinates + 1) << endl;
+					r_range.m_is_references_valid = false;
+				}
+			}
+		}
+	}
+
+	for(unsigned int f = r_range.m_face_begin; f < r_range.m_face_end; f++)
+	{
+		const vector<FaceVertex>& v_vertexes = mesh_data.mv_faces[f].mv_vertexes;
+		if(v_vertexes.size() < FACE_MINIMUM_VERTEXES)
+			r_range.m_short_element_count++;
+		else if(v_vertexes.size() > FACE_MINIMUM_VERTEXES)
+			r_range.m_is_all_triangles = false;
+
+		for(unsigned int v = 0; v < v_vertexes.size(); v++)
+		{
+			Index vertex              = v_vertexes[v].m_vertex;
+			Index texture_coordinates = v_vertexes[v].m_texture_coordinate;
+			Index normal              = v_vertexes[v].m_normal;
+
+			if(vertex >= vertex_count)
+			{
+				if(DEBUGGING_VALIDATE)
+					cout << "Invalid vertex: Mesh " << r_range.m_mesh << ", face " << f << ", vertex " << v << " has vertex " << (vertex + 1) << endl;
+				r_range.m_is_references_valid = false;
+			}
+
+			if(texture_coordinates >= texture_coordinate_count && texture_coordinates != NO_TEXTURE_COORDINATES)
+			{
+				if(DEBUGGING_VALIDATE)
+					cout << "Invalid texture coordinates: Mesh " << r_range.m_mesh << ", face " << f << ", vertex " << v << " has texture coordinates " << (texture_coordinates + 1) << endl;
+				r_range.m_is_references_valid = false;
+			}
+
+			if(normal >= normal_count && normal != NO_NORMAL)
+			{
+				if(DEBUGGING_VALIDATE)
+					cout << "Invalid normal: Mesh " << r_range.m_mesh << ", face " << f << ", vertex " << v << " has normal " << (normal + 1) << endl;
+				r_range.m_is_references_valid = false;
+			}
+		}
+	}
 }
 
 bool ObjModel :: invariant () const
 {
+	if(mp_geometry == NULL) return false;
 	if(m_file_name == "") return false;
 	if(!ObjStringParsing::isValidPath(m_file_path)) return false;
 	return true;
@@ -4402,13 +5730,13 @@ ObjModel :: TextureCoordinateAndNormal :: TextureCoordinateAndNormal (
 {
 }
 
-ObjModel :: TextureCoordinateAndNormal :: TextureCoordinateAndNormal (const TextureCoordinateAndNormal& original)
+ObjModel :: TextureCoordinateAndNormal :: TextureCoordinateAndNormal (const TextureCoordinateAndNormal& original) noexcept
 		: m_texture_coordinate(original.m_texture_coordinate),
 		  m_normal(original.m_normal)
 {
 }
 
-ObjModel :: TextureCoordinateAndNormal& ObjModel :: TextureCoordinateAndNormal :: operator= (const TextureCoordinateAndNormal& original)
+ObjModel :: TextureCoordinateAndNormal& ObjModel :: TextureCoordinateAndNormal :: operator= (const TextureCoordinateAndNormal& original) noexcept
 {
 	if(&original != this)
 	{
@@ -4444,6 +5772,12 @@ ObjModel :: MaterialLibrary :: MaterialLibrary (const ObjModel :: MaterialLibrar
 	mp_mtl_library = original.mp_mtl_library;
 }
 
+ObjModel :: MaterialLibrary :: MaterialLibrary (ObjModel :: MaterialLibrary&& original) noexcept
+		: m_file_name(move(original.m_file_name))
+{
+	mp_mtl_library = original.mp_mtl_library;
+}
+
 ObjModel :: MaterialLibrary& ObjModel :: MaterialLibrary :: operator= (const ObjModel :: MaterialLibrary& original)
 {
 	if(&original != this)
@@ -4455,6 +5789,17 @@ ObjModel :: MaterialLibrary& ObjModel :: MaterialLibrary :: operator= (const Obj
 	return *this;
 }
 
+ObjModel :: MaterialLibrary& ObjModel :: MaterialLibrary :: operator= (ObjModel :: MaterialLibrary&& original) noexcept
+{
+	if(&original != this)
+	{
+		m_file_name    = move(original.m_file_name);
+		mp_mtl_library = original.mp_mtl_library;
+	}
+
+	return *this;
+}
+
 
 
 
@@ -4465,19 +5810,19 @@ ObjModel :: PolylineVertex :: PolylineVertex ()
 	m_texture_coordinate = NO_TEXTURE_COORDINATES;
 }
 
-ObjModel :: PolylineVertex :: PolylineVertex (unsigned int vertex, unsigned int texture_coordinates)
+ObjModel :: PolylineVertex :: PolylineVertex (Index vertex, Index texture_coordinates)
 {
 	m_vertex             = vertex;
 	m_texture_coordinate = texture_coordinates;
 }
 
-ObjModel :: PolylineVertex :: PolylineVertex (const ObjModel :: PolylineVertex& original)
+ObjModel :: PolylineVertex :: PolylineVertex (const ObjModel :: PolylineVertex& original) noexcept
 {
 	m_vertex             = original.m_vertex;
 	m_texture_coordinate = original.m_texture_coordinate;
 }
 
-ObjModel :: PolylineVertex& ObjModel :: PolylineVertex :: operator= (const ObjModel :: PolylineVertex& original)
+ObjModel :: PolylineVertex& ObjModel :: PolylineVertex :: operator= (const ObjModel :: PolylineVertex& original) noexcept
 {
 	if(&original != this)
 	{
@@ -4499,21 +5844,21 @@ ObjModel :: FaceVertex :: FaceVertex ()
 	m_normal             = NO_NORMAL;
 }
 
-ObjModel :: FaceVertex :: FaceVertex (unsigned int vertex, unsigned int texture_coordinates, unsigned int normal)
+ObjModel :: FaceVertex :: FaceVertex (Index vertex, Index texture_coordinates, Index normal)
 {
 	m_vertex             = vertex;
 	m_texture_coordinate = texture_coordinates;
 	m_normal             = normal;
 }
 
-ObjModel :: FaceVertex :: FaceVertex (const ObjModel :: FaceVertex& original)
+ObjModel :: FaceVertex :: FaceVertex (const ObjModel :: FaceVertex& original) noexcept
 {
 	m_vertex             = original.m_vertex;
 	m_texture_coordinate = original.m_texture_coordinate;
 	m_normal             = original.m_normal;
 }
 
-ObjModel :: FaceVertex& ObjModel :: FaceVertex :: operator= (const ObjModel :: FaceVertex& original)
+ObjModel :: FaceVertex& ObjModel :: FaceVertex :: operator= (const ObjModel :: FaceVertex& original) noexcept
 {
 	if(&original != this)
 	{
@@ -4542,22 +5887,143 @@ ObjModel :: Mesh :: Mesh (const string& material_name, Material* p_material) : m
 	m_all_triangles = true;
 }
 
-ObjModel :: Mesh :: Mesh (const ObjModel :: Mesh& original) : mv_faces(original.mv_faces)
+ObjModel :: Mesh :: Mesh (const ObjModel :: Mesh& original)
+		: m_material_name(original.m_material_name),
+		  mv_point_sets(original.mv_point_sets),
+		  mv_polylines(original.mv_polylines),
+		  mv_faces(original.mv_faces)
+{
+	mp_material     = original.mp_material;
+	m_all_triangles = original.m_all_triangles;
+}
+
+ObjModel :: Mesh :: Mesh (ObjModel :: Mesh&& original) noexcept
+		: m_material_name(move(original.m_material_name)),
+		  mv_point_sets(move(original.mv_point_sets)),
+		  mv_polylines(move(original.mv_polylines)),
+		  mv_faces(move(original.mv_faces))
 {
-	m_material_name = original.m_material_name;
 	mp_material     = original.mp_material;
 	m_all_triangles = original.m_all_triangles;
 }
 
 ObjModel :: Mesh& ObjModel :: Mesh :: operator= (const ObjModel :: Mesh& original)
 {
-	if(&original != NULL)
+	if(&original != this)
 	{
 		m_material_name = original.m_material_name;
 		mp_material     = original.mp_material;
+		mv_point_sets   = original.mv_point_sets;
+		mv_polylines    = original.mv_polylines;
 		mv_faces        = original.mv_faces;
 		m_all_triangles = original.m_all_triangles;
 	}
 
 	return *this;
 }
+
+ObjModel :: Mesh& ObjModel :: Mesh :: operator= (ObjModel :: Mesh&& original) noexcept
+{
+	if(&original != this)
+	{
+		m_material_name = move(original.m_material_name);
+		mp_material     = original.mp_material;
+		mv_point_sets   = move(original.mv_point_sets);
+		mv_polylines    = move(original.mv_polylines);
+		mv_faces        = move(original.mv_faces);
+		m_all_triangles = original.m_all_triangles;
+	}
+
+	return *this;
+}
+
+
+
+ObjModel :: Geometry :: Geometry ()
+		: mv_material_libraries(),
+		  mv_vertexes(),
+		  mv_texture_coordinates(),
+		  mv_normals(),
+		  mv_meshes(),
+		  m_bounding_box_mutex(),
+		  m_bounding_box_min(),
+		  m_bounding_box_max()
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+		  , m_draw_list(),
+		  m_draw_arrays()
+#endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
+{
+	m_is_bounding_box_current = false;
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+	m_is_draw_list_current = false;
+	m_is_draw_arrays_used  = false;
+#endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
+}
+
+ObjModel :: Geometry :: Geometry (const ObjModel :: Geometry& original)
+		: mv_material_libraries(original.mv_material_libraries),
+		  mv_vertexes(original.mv_vertexes),
+		  mv_texture_coordinates(original.mv_texture_coordinates),
+		  mv_normals(original.mv_normals),
+		  mv_meshes(original.mv_meshes),
+		  m_bounding_box_mutex(),
+		  m_bounding_box_min(),
+		  m_bounding_box_max()
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+		  , m_draw_list(),
+		  m_draw_arrays()
+#endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
+{
+	// the draw cache is not copied; it belongs to the original
+	m_is_bounding_box_current = false;
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+	m_is_draw_list_current = false;
+	m_is_draw_arrays_used  = original.m_is_draw_arrays_used;
+#endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
+}
+
+ObjModel :: ValidationRange :: ValidationRange ()
+		: m_mesh(0),
+		  m_face_begin(0),
+		  m_face_end(0),
+		  m_short_element_count(0),
+		  m_is_references_valid(true),
+		  m_is_all_triangles(true)
+{
+}
+
+ObjModel :: ValidationRange :: ValidationRange (unsigned int mesh,
+                                                unsigned int face_begin,
+                                                unsigned int face_end)
+		: m_mesh(mesh),
+		  m_face_begin(face_begin),
+		  m_face_end(face_end),
+		  m_short_element_count(0),
+		  m_is_references_valid(true),
+		  m_is_all_triangles(true)
+{
+	assert(face_begin <= face_end);
+}
+
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+
+ObjModel :: DrawArrays :: DrawArrays ()
+		: mv_vertexes(),
+		  mv_normals(),
+		  mv_position_data(),
+		  mv_normal_data(),
+		  mv_texture_coordinate_data(),
+		  mvv_mesh_indexes(),
+		  mv_mesh_is_normals(),
+		  mv_mesh_is_texture_coordinates(),
+		  mv_vertex_use_starts(),
+		  mv_vertex_uses(),
+		  mv_normal_use_starts(),
+		  mv_normal_uses(),
+		  mv_dirty_vertex_ranges(),
+		  mv_dirty_normal_ranges()
+{
+	m_is_built = false;
+}
+
+#endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
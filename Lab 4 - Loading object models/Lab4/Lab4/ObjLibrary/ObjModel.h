@@ -25,6 +25,8 @@
 
 #include <string>
 #include <vector>
+#include <memory>
+#include <mutex>
 
 #include "ObjSettings.h"
 #include "MtlLibrary.h"
@@ -82,13 +84,71 @@ class Material;
 //    output.  Function arguments and return values, however,
 //    the numbering starts at 0.
 //
+//  Vertexes, texture coordinates, and normals are indexed with
+//    the Index type.  By default, this is a 32-bit integer.
+//    Models with more than about 4 billion of any of them can
+//    be loaded by defining OBJ_LIBRARY_64_BIT_INDEXES in
+//    ObjSettings.h.
+//
+//  The geometry of an ObjModel is shared between copies until
+//    one of them is changed.  Copying an ObjModel only copies a
+//    reference to the geometry, so many copies of the same
+//    model use little more memory than one.  Any function that
+//    changes the geometry first makes a private copy of it if
+//    it is shared.  This is invisible to the caller, except
+//    that the first change to a copy takes longer.  The
+//    geometry is not locked, so two threads must not change
+//    copies of the same model at the same time.
+//
+//  The draw() function compiles the ObjModel into a
+//    DisplayList the first time it is called, and uses that
+//    DisplayList until the ObjModel is changed.  The
+//    DisplayList is stored with the geometry, so copies that
+//    share geometry also share it.  An ObjModel that has been
+//    drawn should only be changed or destroyed on the thread
+//    with the OpenGL context.
+//
+//  A DisplayList cannot be partly changed, so once vertex
+//    positions or normals are changed with the setVertex* or
+//    setNormal* functions, draw() stops using the DisplayList
+//    and draws the faces from OpenGL vertex arrays instead.
+//    The arrays record which vertexes and normals have changed
+//    and only those parts are updated, so deforming a few
+//    vertexes of a large model every frame is cheap.  Any
+//    other change rebuilds the arrays.  Calling
+//    invalidateDrawCache() returns to using a DisplayList.
+//
+//  Whether the model is valid is kept up to date by the
+//    functions that change it, so it never has to be
+//    recalculated for each change.  The number of point sets,
+//    polylines, and faces with too few vertexes is counted
+//    exactly.  Element indexes are only checked when they are
+//    set, so removing vertexes, texture coordinates, or
+//    normals marks the model as invalid until validate() is
+//    called.
+//
 //  Class Invariant:
 //    <1> m_file_name != ""
 //    <2> ObjStringParsing::isValidPath(m_file_path)
+//    <3> mp_geometry != NULL
 //
 class ObjModel
 {
 public:
+//
+//  Index
+//
+//  The type used to index the vertexes, texture coordinates,
+//    and normals of an ObjModel.  It is a 64-bit integer if
+//    OBJ_LIBRARY_64_BIT_INDEXES is defined in ObjSettings.h
+//    and a 32-bit integer otherwise.
+//
+#ifdef OBJ_LIBRARY_64_BIT_INDEXES
+	typedef unsigned long long Index;
+#else
+	typedef unsigned int Index;
+#endif
+
 //
 //  NO_TEXTURE_COORDINATES
 //
@@ -96,7 +156,7 @@ public:
 //    coordinates associated with a vertex in a polyline or
 //    face.
 //
-	static const unsigned int NO_TEXTURE_COORDINATES;
+	static const Index NO_TEXTURE_COORDINATES;
 
 //
 //  NO_NORMAL
@@ -104,7 +164,7 @@ public:
 //  A constant used to indicate that there is no normal vector
 //    associated with a vertex in  face.
 //
-	static const unsigned int NO_NORMAL;
+	static const Index NO_NORMAL;
 
 //
 //  Class Function: loadDisplayTextures
@@ -195,10 +255,26 @@ public:
 //  Precondition(s): N/A
 //  Returns: N/A
 //  Side Effect: A new ObjModel is created representing the same
-//               model as original.
+//               model as original.  The geometry is shared
+//               with original until either is changed.
 //
 	ObjModel (const ObjModel& original);
 
+//
+//  Move Constructor
+//
+//  Purpose: To create a new ObjModel by taking the contents of
+//           another.
+//  Parameter(s):
+//    <1> original: The ObjModel to move
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new ObjModel is created representing the
+//               model original represented.  original is made
+//               empty.  No memory is allocated.
+//
+	ObjModel (ObjModel&& original) noexcept;
+
 
 //
 //  Assignment Operator
@@ -208,11 +284,27 @@ public:
 //    <1> original: The ObjModel to copy
 //  Precondition(s): N/A
 //  Returns: A reference to this ObjModel.
-//  Side Effect: This ObjModel is transformed into a deep copy
-//               of original.
+//  Side Effect: This ObjModel is transformed into a copy of
+//               original.  The geometry is shared with original
+//               until either is changed.
 //
 	ObjModel& operator= (const ObjModel& original);
 
+//
+//  Move Assignment Operator
+//
+//  Purpose: To modify this ObjModel to take the contents of
+//           another.
+//  Parameter(s):
+//    <1> original: The ObjModel to move
+//  Precondition(s): N/A
+//  Returns: A reference to this ObjModel.
+//  Side Effect: This ObjModel is transformed to represent the
+//               model original represented.  original is made
+//               empty.  No memory is allocated.
+//
+	ObjModel& operator= (ObjModel&& original) noexcept;
+
 //
 //  Destructor
 //
@@ -461,7 +553,7 @@ public:
 //  Returns: The number of vertexes in this ObjModel.
 //  Side Effect: N/A
 //
-	unsigned int getVertexCount () const;
+	Index getVertexCount () const;
 
 //
 //  getVertexX
@@ -478,9 +570,9 @@ public:
 //           ObjModel.
 //  Side Effect: N/A
 //
-	double getVertexX (unsigned int vertex) const;
-	double getVertexY (unsigned int vertex) const;
-	double getVertexZ (unsigned int vertex) const;
+	double getVertexX (Index vertex) const;
+	double getVertexY (Index vertex) const;
+	double getVertexZ (Index vertex) const;
 
 //
 //  getVertexPosition
@@ -495,7 +587,27 @@ public:
 //  Side Effect: N/A
 //
 	const Vector3& getVertexPosition (
-	                             unsigned int vertex) const;
+	                             Index vertex) const;
+
+//
+//  getBoundingBoxMin
+//  getBoundingBoxMax
+//
+//  Purpose: To determine the corners of the axis-aligned box
+//           containing all the vertexes in this ObjModel.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The minimum or maximum X, Y, and Z of the vertexes
+//           in this ObjModel.  If there are no vertexes, the
+//           zero vector is returned.
+//  Side Effect: The first time either function is called after
+//               the vertexes are changed, the bounding box is
+//               calculated and stored with the geometry.  These
+//               functions may be called from several threads at
+//               once.
+//
+	Vector3 getBoundingBoxMin () const;
+	Vector3 getBoundingBoxMax () const;
 
 //
 //  getTextureCoordinateCount
@@ -508,7 +620,7 @@ public:
 //           ObjModel.
 //  Side Effect: N/A
 //
-	unsigned int getTextureCoordinateCount () const;
+	Index getTextureCoordinateCount () const;
 
 //
 //  getTextureCoordinateU
@@ -525,9 +637,9 @@ public:
 //  Side Effect: N/A
 //
 	double getTextureCoordinateU (
-	                 unsigned int texture_coordinate) const;
+	                 Index texture_coordinate) const;
 	double getTextureCoordinateV (
-	                 unsigned int texture_coordinate) const;
+	                 Index texture_coordinate) const;
 
 //
 //  getTextureCoordinate
@@ -543,7 +655,7 @@ public:
 //  Side Effect: N/A
 //
 	const Vector2& getTextureCoordinate (
-	                 unsigned int texture_coordinate) const;
+	                 Index texture_coordinate) const;
 
 //
 //  getNormalCount
@@ -555,7 +667,7 @@ public:
 //  Returns: The number of normal vectors in this ObjModel.
 //  Side Effect: N/A
 //
-	unsigned int getNormalCount () const;
+	Index getNormalCount () const;
 
 //
 //  getNormalX
@@ -572,9 +684,9 @@ public:
 //           ObjModel.
 //  Side Effect: N/A
 //
-	double getNormalX (unsigned int normal) const;
-	double getNormalY (unsigned int normal) const;
-	double getNormalZ (unsigned int normal) const;
+	double getNormalX (Index normal) const;
+	double getNormalY (Index normal) const;
+	double getNormalZ (Index normal) const;
 
 //
 //  getNormalVector
@@ -589,7 +701,7 @@ public:
 //  Side Effect: N/A
 //
 	const Vector3& getNormalVector (
-	                             unsigned int normal) const;
+	                             Index normal) const;
 
 //
 //  getMeshCount
@@ -706,7 +818,7 @@ public:
 //           in mesh mesh of this ObjModel.
 //  Side Effect: N/A
 //
-	unsigned int getPointSetVertexIndex (
+	Index getPointSetVertexIndex (
 	                             unsigned int mesh,
 	                             unsigned int point_set,
 	                             unsigned int vertex) const;
@@ -764,7 +876,7 @@ public:
 //           mesh mesh of this ObjModel.
 //  Side Effect: N/A
 //
-	unsigned int getPolylineVertexIndex (
+	Index getPolylineVertexIndex (
 	                             unsigned int mesh,
 	                             unsigned int polyline,
 	                             unsigned int vertex) const;
@@ -789,7 +901,7 @@ public:
 //           mesh mesh of this ObjModel.
 //  Side Effect: N/A
 //
-	unsigned int getPolylineVertexTextureCoordinates (
+	Index getPolylineVertexTextureCoordinates (
 	                             unsigned int mesh,
 	                             unsigned int polyline,
 	                             unsigned int vertex) const;
@@ -867,9 +979,9 @@ public:
 //           mesh of this ObjModel.
 //  Side Effect: N/A
 //
-	unsigned int getFaceVertexIndex (unsigned int mesh,
-	                                 unsigned int face,
-	                                 unsigned int vertex)
+	Index getFaceVertexIndex (unsigned int mesh,
+	                          unsigned int face,
+	                          unsigned int vertex)
 	                                                  const;
 
 //
@@ -892,7 +1004,7 @@ public:
 //           mesh of this ObjModel.
 //  Side Effect: N/A
 //
-	unsigned int getFaceVertexTextureCoordinates (
+	Index getFaceVertexTextureCoordinates (
 	                             unsigned int mesh,
 	                             unsigned int face,
 	                             unsigned int vertex) const;
@@ -917,9 +1029,9 @@ public:
 //           of this ObjModel.
 //  Side Effect: N/A
 //
-	unsigned int getFaceVertexNormal (unsigned int mesh,
-	                                  unsigned int face,
-	                                  unsigned int vertex)
+	Index getFaceVertexNormal (unsigned int mesh,
+	                           unsigned int face,
+	                           unsigned int vertex)
 	                                                  const;
 
 //
@@ -1141,7 +1253,9 @@ public:
 //  Purpose: To determine if this ObjModel is valid.  An
 //           ObjModel is valid if no face references a
 //           nonexistant vertex, texture coordinate, or normal
-//           vector.
+//           vector, and every point set has at least 1 vertex,
+//           every polyline at least 2, and every face at least
+//           3.
 //  Parameter(s): N/A
 //  Precondition(s): N/A
 //  Returns: Whether this ObjModel is valid.
@@ -1223,15 +1337,67 @@ public:
 //  draw
 //
 //  Purpose: To display this ObjModel with OpenGL graphics.
+//           The first time this ObjModel is drawn, it is
+//           compiled into a DisplayList, which is reused
+//           until this ObjModel is changed.
 //  Parameter(s): N/A
 //  Precondition(s):
 //    <1> isValid()
+//    <2> !Material::isMaterialActive()
 //  Returns: N/A
 //  Side Effect: This ObjModel is displayed with OpenGL
-//               graphics.
+//               graphics.  If isDrawCacheReady() == false,
+//               the textures used by this ObjModel are loaded
+//               and a DisplayList is compiled for this
+//               ObjModel.  That DisplayList is shared with the
+//               copies of this ObjModel that share its
+//               geometry.  If a vertex position or normal has
+//               been changed since then, the faces are drawn
+//               from vertex arrays instead, and only the parts
+//               of the arrays for the changed vertexes and
+//               normals are updated.  If this function is
+//               called while another DisplayList is being
+//               specified, this ObjModel is drawn immediately
+//               instead and nothing is compiled.
 //
 	void draw () const;
 
+//
+//  isDrawCacheReady
+//
+//  Purpose: To determine if the DisplayList or vertex arrays
+//           used by draw() are ready for this ObjModel.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this ObjModel has been drawn with draw()
+//           since it was last changed or invalidateDrawCache()
+//           was last called.
+//  Side Effect: N/A
+//
+	bool isDrawCacheReady () const;
+
+//
+//  invalidateDrawCache
+//
+//  Purpose: To force the DisplayList used by draw() to be
+//           compiled again.  This function should be called
+//           if the materials or textures used by this
+//           ObjModel are changed, or when this ObjModel
+//           will no longer be deformed.  Changes made to
+//           this ObjModel itself invalidate the DisplayList
+//           automatically.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The DisplayList used by draw() is marked as
+//               out of date for this ObjModel and all the
+//               ObjModels that share its geometry.  It will
+//               be compiled again the next time one of them
+//               is drawn.  The vertex arrays used after
+//               vertexes or normals are changed are freed.
+//
+	void invalidateDrawCache () const;
+
 //
 //  drawMaterialNone
 //
@@ -1930,6 +2096,36 @@ public:
 	                                bool is_normals) const;
 #endif  // OBJ_LIBRARY_SHADER_DISPLAY is defined
 
+//
+//  getSaveThreadCount
+//
+//  Purpose: To determine the maximum number of threads used to
+//           save an ObjModel.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The maximum number of threads, including the
+//           calling thread.  The default is one more than the
+//           number of workers in the shared JobSystem.
+//  Side Effect: N/A
+//
+	static unsigned int getSaveThreadCount ();
+
+//
+//  setSaveThreadCount
+//
+//  Purpose: To change the maximum number of threads used to
+//           save an ObjModel.
+//  Parameter(s):
+//    <1> count: The maximum number of threads
+//  Precondition(s):
+//    <1> count >= 1
+//  Returns: N/A
+//  Side Effect: save will format the file in at most count
+//               threads, including the calling thread.  If
+//               count is 1, only the calling thread is used.
+//
+	static void setSaveThreadCount (unsigned int count);
+
 //
 //  save
 //
@@ -1951,9 +2147,14 @@ public:
 //  Side Effect: A file named filename is created.  If a file by
 //               that name already exists, its contantes are
 //               lost.  This ObjModel written to that file in
-//               OBJ format.  If a logfile or logging stream is
-//               specified, any saving errors are written to
-//               that file or stream.  Otherwise, any loading
+//               OBJ format.  Each coordinate is written with
+//               the fewest digits that load back as exactly the
+//               same value.  The elements are formatted into
+//               large buffers, in parallel for large models,
+//               and each buffer is written at once.  If a
+//               logfile or logging stream is specified, any
+//               saving errors are written to that file or
+//               stream.  Otherwise, any loading
 //               errors are written to the standard error
 //               stream.
 //
@@ -2007,6 +2208,34 @@ public:
 	void load (const std::string& filename,
 	           std::ostream& r_logstream);
 
+//
+//  loadBinary
+//
+//  Purpose: To replace this ObjModel with the model specified
+//           in the specified binary model file.  A logfile may
+//           be specified as an output stream.
+//  Parameter(s):
+//    <1> filename: The name of the binary model file
+//    <2> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> filename != ""
+//    <2> filename.find_last_of("/\\") == string::npos ||
+//        filename.find_last_of("/\\") + 1 < filename.size()
+//  Returns: N/A
+//  Side Effect: This ObjModel is set to represent the model in
+//               file filename, as written by
+//               ObjStream::saveBinary.  The existing model, if
+//               any, is lost.  Every face is a triangle.  If the
+//               file is not a binary model file, is truncated,
+//               or has more elements than can be indexed with
+//               an Index, an error is written to r_logstream,
+//               or to the standard error stream if it is not
+//               specified, and this ObjModel is left empty.
+//
+	void loadBinary (const std::string& filename);
+	void loadBinary (const std::string& filename,
+	                 std::ostream& r_logstream);
+
 //
 //  setFileName
 //
@@ -2069,7 +2298,7 @@ public:
 //               the highest indices are lost and this model is
 //               marked as invalid.
 //
-	void setVertexCount (unsigned int count);
+	void setVertexCount (Index count);
 
 //
 //  setVertexX
@@ -2089,9 +2318,9 @@ public:
 //  Side Effect: Vertex vertex in this ObjModel is set be at
 //               have a x/y/z-coordinate of x/y/z.
 //
-	void setVertexX (unsigned int vertex, double x);
-	void setVertexY (unsigned int vertex, double y);
-	void setVertexZ (unsigned int vertex, double z);
+	void setVertexX (Index vertex, double x);
+	void setVertexY (Index vertex, double y);
+	void setVertexZ (Index vertex, double z);
 
 //
 //  setVertexPosition
@@ -2109,7 +2338,7 @@ public:
 //  Side Effect: Vertex vertex in this ObjModel is set be at
 //               position (x, y, z).
 //
-	void setVertexPosition (unsigned int vertex,
+	void setVertexPosition (Index vertex,
 	                        double x, double y, double z);
 
 //
@@ -2126,7 +2355,7 @@ public:
 //  Side Effect: Vertex vertex in this ObjModel is set be at
 //               position position.
 //
-	void setVertexPosition (unsigned int vertex,
+	void setVertexPosition (Index vertex,
 	                        const Vector3& position);
 
 //
@@ -2148,7 +2377,7 @@ public:
 //               indices are lost and this model is marked as
 //               invalid.
 //
-	void setTextureCoordinateCount (unsigned int count);
+	void setTextureCoordinateCount (Index count);
 
 //
 //  setTextureCoordinateU
@@ -2168,10 +2397,10 @@ public:
 //               u/v-coordinate of u/v.
 //
 	void setTextureCoordinateU (
-	                        unsigned int texture_coordinate,
+	                        Index texture_coordinate,
 	                        double u);
 	void setTextureCoordinateV (
-	                        unsigned int texture_coordinate,
+	                        Index texture_coordinate,
 	                        double v);
 
 //
@@ -2192,7 +2421,7 @@ public:
 //               (u, v).
 //
 	void setTextureCoordinate (
-	                        unsigned int texture_coordinate,
+	                        Index texture_coordinate,
 	                        double u, double v);
 
 //
@@ -2212,7 +2441,7 @@ public:
 //               coordinates.
 //
 	void setTextureCoordinate (
-	                        unsigned int texture_coordinate,
+	                        Index texture_coordinate,
 	                        const Vector2& coordinates);
 
 //
@@ -2233,7 +2462,7 @@ public:
 //               highest indices are lost and this model is
 //               marked as invalid.
 //
-	void setNormalCount (unsigned int count);
+	void setNormalCount (Index count);
 
 //
 //  setNormalX
@@ -2253,7 +2482,7 @@ public:
 //               have an x-coordinate of x.  Normal vector
 //               normal is than scaled to have a length of 1.0.
 //
-	void setNormalX (unsigned int normal, double x);
+	void setNormalX (Index normal, double x);
 
 //
 //  setNormalY
@@ -2273,7 +2502,7 @@ public:
 //               have an y-coordinate of y.  Normal vector
 //               normal is than scaled to have a length of 1.0.
 //
-	void setNormalY (unsigned int normal, double y);
+	void setNormalY (Index normal, double y);
 
 //
 //  setNormalZ
@@ -2293,7 +2522,7 @@ public:
 //               have an z-coordinate of z.  Normal vector
 //               normal is than scaled to have a length of 1.0.
 //
-	void setNormalZ (unsigned int normal, double z);
+	void setNormalZ (Index normal, double z);
 
 //
 //  setNormalVector
@@ -2313,7 +2542,7 @@ public:
 //               have a value of (x, y, z).  The new normal
 //               vector is scaled to have a length of 1.0.
 //
-	void setNormalVector (unsigned int normal,
+	void setNormalVector (Index normal,
 	                      double x, double y, double z);
 
 //
@@ -2332,7 +2561,7 @@ public:
 //               have a value of vector.  The new normal vector
 //               is scaled to have a length of 1.0.
 //
-	void setNormalVector (unsigned int normal,
+	void setNormalVector (Index normal,
 	                      const Vector3& vector);
 
 //
@@ -2395,7 +2624,7 @@ public:
 	void setPointSetVertexIndex (unsigned int mesh,
 	                             unsigned int point_set,
 	                             unsigned int vertex,
-	                             unsigned int index);
+	                             Index index);
 
 //
 //  setPolylineVertexIndex
@@ -2422,7 +2651,7 @@ public:
 	void setPolylineVertexIndex (unsigned int mesh,
 	                             unsigned int polyline,
 	                             unsigned int vertex,
-	                             unsigned int index);
+	                             Index index);
 
 //
 //  setPolylineVertexTextureCoordinates
@@ -2454,7 +2683,7 @@ public:
 	                          unsigned int mesh,
 	                          unsigned int polyline,
 	                          unsigned int vertex,
-	                          unsigned int texture_coordinates);
+	                          Index texture_coordinates);
 
 //
 //  setFaceVertexIndex
@@ -2480,7 +2709,7 @@ public:
 	void setFaceVertexIndex (unsigned int mesh,
 	                         unsigned int face,
 	                         unsigned int vertex,
-	                         unsigned int index);
+	                         Index index);
 
 //
 //  setFaceVertexTextureCoordinates
@@ -2511,7 +2740,7 @@ public:
 	                                    unsigned int mesh,
 	                                    unsigned int face,
 	                                    unsigned int vertex,
-	                                    unsigned int index);
+	                                    Index index);
 
 //
 //  setFaceVertexNormal
@@ -2540,7 +2769,7 @@ public:
 	void setFaceVertexNormal (unsigned int mesh,
 	                          unsigned int face,
 	                          unsigned int vertex,
-	                          unsigned int index);
+	                          Index index);
 
 //
 //  addMaterialLibary
@@ -2584,7 +2813,7 @@ public:
 //  Side Effect: A vertex at (x, y, z) is added to this
 //               ObjModel.
 //
-	unsigned int addVertex (double x, double y, double z);
+	Index addVertex (double x, double y, double z);
 
 //
 //  addVertex
@@ -2597,7 +2826,7 @@ public:
 //  Side Effect: A vertex at position is added to this
 //               ObjModel.
 //
-	unsigned int addVertex (const Vector3& position);
+	Index addVertex (const Vector3& position);
 
 //
 //  addTextureCoordinate
@@ -2611,7 +2840,7 @@ public:
 //  Side Effect: A texture coordinate pair of (u, v) is added to
 //               this ObjModel.
 //
-	unsigned int addTextureCoordinate (double u, double v);
+	Index addTextureCoordinate (double u, double v);
 
 //
 //  addTextureCoordinate
@@ -2624,7 +2853,7 @@ public:
 //  Side Effect: A texture coordinate of texture_coordinates is
 //               added to this ObjModel.
 //
-	unsigned int addTextureCoordinate (
+	Index addTextureCoordinate (
 	                    const Vector2& texture_coordinates);
 
 //
@@ -2640,9 +2869,10 @@ public:
 //  Returns: The index of the new normal vector.
 //  Side Effect: A normal vector of value (x, y, z) is added to
 //               this ObjModel.  The new normal vector is scaled
-//               to have a length of 1.0.
+//               to have a length of 1.0, unless it already has
+//               a length of 1.0 to within rounding error.
 //
-	unsigned int addNormal (double x, double y, double z);
+	Index addNormal (double x, double y, double z);
 
 //
 //  addNormal
@@ -2655,9 +2885,10 @@ public:
 //  Returns: The index of the new normal vector.
 //  Side Effect: A normal vector of size (x, y, z) is added to
 //               this ObjModel.  The new normal vector is scaled
-//               to have a length of 1.0.
+//               to have a length of 1.0, unless it already has
+//               a length of 1.0 to within rounding error.
 //
-	unsigned int addNormal (const Vector3& normal);
+	Index addNormal (const Vector3& normal);
 
 //
 //  addMesh
@@ -2682,8 +2913,8 @@ public:
 //    <1> mesh < getMeshCount()
 //  Returns: The index of the new point set.
 //  Side Effect: A new point set with no vertexes is added to
-//               mesh mesh of this ObjModel and this ObjModel is
-//               marked as invalid.
+//               mesh mesh of this ObjModel.  This ObjModel is
+//               invalid until a vertex is added to it.
 //
 	unsigned int addPointSet (unsigned int mesh);
 
@@ -2710,7 +2941,7 @@ public:
 //
 	unsigned int addPointSetVertex (unsigned int mesh,
 	                                unsigned int point_set,
-	                                unsigned int vertex);
+	                                Index vertex);
 
 //
 //  addPolyline
@@ -2723,8 +2954,8 @@ public:
 //    <1> mesh < getMeshCount()
 //  Returns: The index of the new polyline.
 //  Side Effect: A new polyline with no vertexes is added to
-//               mesh mesh of this ObjModel and this ObjModel is
-//               marked as invalid.
+//               mesh mesh of this ObjModel.  This ObjModel is
+//               invalid until 2 vertexes are added to it.
 //
 	unsigned int addPolyline (unsigned int mesh);
 
@@ -2757,8 +2988,8 @@ public:
 	unsigned int addPolylineVertex (
 	                      unsigned int mesh,
 	                      unsigned int polyline,
-	                      unsigned int vertex,
-	                      unsigned int texture_coordinates);
+	                      Index vertex,
+	                      Index texture_coordinates);
 
 //
 //  addFace
@@ -2771,8 +3002,8 @@ public:
 //    <1> mesh < getMeshCount()
 //  Returns: The index of the new face.
 //  Side Effect: A new face with no vertexes is added to mesh
-//               mesh of this ObjModel.  This ObjModel is marked
-//               as invalid.
+//               mesh of this ObjModel.  This ObjModel is
+//               invalid until 3 vertexes are added to it.
 //
 	unsigned int addFace (unsigned int mesh);
 
@@ -2807,9 +3038,9 @@ public:
 	unsigned int addFaceVertex (
 	                       unsigned int mesh,
 	                       unsigned int face,
-	                       unsigned int vertex,
-	                       unsigned int texture_coordinates,
-	                       unsigned int normal);
+	                       Index vertex,
+	                       Index texture_coordinates,
+	                       Index normal);
 
 /*
 //
@@ -3067,7 +3298,8 @@ public:
 //  Returns: N/A
 //  Side Effect: All vertexes in face face of mesh mesh of this
 //               ObjModel are removed.  The succeeding vertexes
-//               are renumbered and this ObjModel is marked as
+//               are renumbered.  If face face is left with
+//               fewer than 3 vertexes, this ObjModel is
 //               invalid.
 //
 	void removeFaceVertex (unsigned int mesh,
@@ -3087,8 +3319,8 @@ public:
 //    <2> face < getFaceCount(mesh)
 //  Returns: N/A
 //  Side Effect: All vertexes in face face of mesh mesh of this
-//               ObjModel are removed.  This ObjModel is marked
-//               as invalid.
+//               ObjModel are removed.  This ObjModel is invalid
+//               until 3 vertexes are added to it.
 //
 	void removeFaceVertexAll (unsigned int mesh,
 	                          unsigned int face);
@@ -3097,15 +3329,18 @@ public:
 //  validate
 //
 //  Purpose: To recalculate whether this ObjModel is valid.
-//           This function should be called once after modifying
-//           a model.  Do not call it after each change, it is
-//           too slow.
+//           This is only needed after vertexes, texture
+//           coordinates, or normals are removed, or an element
+//           is given an index that does not exist yet.  Other
+//           changes keep the validity up to date.  Do not call
+//           it after each change, it checks every element.
 //  Parameter(s): N/A
 //  Precondition(s): N/A
 //  Returns: N/A
 //  Side Effect: The validity of this model is recalculated.
 //               This will never result in a model marked as
-//               valid being marked as invalid.
+//               valid being marked as invalid.  The meshes are
+//               checked in parallel on the shared JobSystem.
 //
 	void validate ();
 
@@ -3122,15 +3357,15 @@ private:
 	{
 		TextureCoordinateAndNormal ();
 		TextureCoordinateAndNormal (
-		                        unsigned int texture_coordinate,
-		                        unsigned int normal);
+		                        Index texture_coordinate,
+		                        Index normal);
 		TextureCoordinateAndNormal (
-		            const TextureCoordinateAndNormal& original);
+		   const TextureCoordinateAndNormal& original) noexcept;
 		TextureCoordinateAndNormal& operator= (
-		            const TextureCoordinateAndNormal& original);
+		   const TextureCoordinateAndNormal& original) noexcept;
 
-		unsigned int m_texture_coordinate;
-		unsigned int m_normal;
+		Index m_texture_coordinate;
+		Index m_normal;
 	};
 
 	//
@@ -3145,6 +3380,21 @@ private:
 
 private:
 #ifndef OBJ_LIBRARY_SHADER_DISPLAY
+//
+//  drawImmediate
+//
+//  Purpose: To display this ObjModel with OpenGL graphics
+//           without using the DisplayList used by draw().
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isValid()
+//    <2> !Material::isMaterialActive()
+//  Returns: N/A
+//  Side Effect: This ObjModel is displayed with OpenGL
+//               graphics.
+//
+	void drawImmediate () const;
+
 //
 //  drawMeshMaterial
 //
@@ -3248,6 +3498,75 @@ private:
 //               displayed using the current Material, if any.
 //
 	void drawFaces (unsigned int mesh) const;
+
+//
+//  drawWithArrays
+//
+//  Purpose: To display this ObjModel with OpenGL graphics,
+//           drawing the faces from the vertex arrays.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isValid()
+//    <2> !Material::isMaterialActive()
+//  Returns: N/A
+//  Side Effect: The vertex arrays are built or updated if they
+//               are out of date.  This ObjModel is then
+//               displayed with OpenGL graphics.  If this
+//               ObjModel has too many draw vertexes for vertex
+//               arrays, it is drawn in immediate mode instead
+//               and the DisplayList is used from then on.
+//
+	void drawWithArrays () const;
+
+//
+//  drawFacesArrays
+//
+//  Purpose: To display all the faces in the specified mesh from
+//           the vertex arrays.
+//  Parameter(s):
+//    <1> mesh: Which mesh
+//  Precondition(s):
+//    <1> isValid()
+//    <2> mesh < getMeshCount()
+//    <3> mp_geometry->m_draw_arrays.m_is_built
+//  Returns: N/A
+//  Side Effect: The faces in mesh mesh in this ObjModel are
+//               displayed using the current Material, if any.
+//
+	void drawFacesArrays (unsigned int mesh) const;
+
+//
+//  buildDrawArrays
+//
+//  Purpose: To build the vertex arrays used to draw the faces
+//           of this ObjModel.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isValid()
+//  Returns: Whether the faces could be stored in vertex
+//           arrays.  This fails if there are more draw vertexes
+//           or indexes in a mesh than OpenGL can draw at once.
+//  Side Effect: If the faces fit, the vertex arrays for this
+//               ObjModel are built and marked as up to date.
+//               Otherwise, they are left empty.
+//
+	bool buildDrawArrays () const;
+
+//
+//  updateDrawArrays
+//
+//  Purpose: To update the parts of the vertex arrays used by
+//           the vertexes and normals that have changed.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isValid()
+//    <2> mp_geometry->m_draw_arrays.m_is_built
+//  Returns: N/A
+//  Side Effect: The draw vertexes that use a vertex or normal
+//               in the dirty ranges are updated, and the dirty
+//               ranges are emptied.
+//
+	void updateDrawArrays () const;
 #endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
 
 #ifdef OBJ_LIBRARY_SHADER_DISPLAY
@@ -3640,6 +3959,27 @@ private:
 	bool readFace (const std::string& str,
 	               std::ostream& r_logstream);
 
+//
+//  readBinary
+//
+//  Purpose: To add the contents of a binary model file to this
+//           ObjModel.
+//  Parameter(s):
+//    <1> r_input: The file to read from
+//    <2> filename: The name of the file, for error messages
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s): N/A
+//  Returns: Whether the whole file could be read.
+//  Side Effect: The material libraries, meshes, elements, and
+//               triangles in r_input are added to this
+//               ObjModel.  If the file is invalid, an error is
+//               written to r_logstream and reading stops part
+//               way through.
+//
+	bool readBinary (std::istream& r_input,
+	                 const std::string& filename,
+	                 std::ostream& r_logstream);
+
 //
 //  removeLastPointSet
 //
@@ -3652,8 +3992,7 @@ private:
 //    <2> getPointSetCount(mesh) >= 1
 //  Returns: N/A
 //  Side Effect: The most recently added point set is removed
-//               from mesh mesh of this ObjModel.  This ObjModel
-//               is marked as invalid.
+//               from mesh mesh of this ObjModel.
 //
 	void removeLastPointSet (unsigned int mesh);
 
@@ -3669,8 +4008,7 @@ private:
 //    <2> getPolylineCount(mesh) >= 1
 //  Returns: N/A
 //  Side Effect: The most recently added polyline is removed
-//               from mesh mesh of this ObjModel.  This ObjModel
-//               is marked as invalid.
+//               from mesh mesh of this ObjModel.
 //
 	void removeLastPolyline (unsigned int mesh);
 
@@ -3686,11 +4024,124 @@ private:
 //    <2> getFaceCount(mesh) >= 1
 //  Returns: N/A
 //  Side Effect: The most recently added face is removed from
-//               mesh mesh of this ObjModel.  This ObjModel is
-//               marked as invalid.
+//               mesh mesh of this ObjModel.
 //
 	void removeLastFace (unsigned int mesh);
 
+//
+//  beginGeometryChange
+//
+//  Purpose: To prepare the geometry of this ObjModel to be
+//           changed.  This function must be called before the
+//           geometry is changed.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If the geometry of this ObjModel is shared, it
+//               is replaced with a copy.  The DisplayList used
+//               by draw() is marked as out of date.
+//
+	void beginGeometryChange ();
+
+//
+//  beginVertexChange
+//
+//  Purpose: To prepare the position of the specified vertex to
+//           be changed.  This function must be called before
+//           the vertex is changed.
+//  Parameter(s):
+//    <1> vertex: Which vertex
+//  Precondition(s):
+//    <1> vertex < getVertexCount()
+//  Returns: N/A
+//  Side Effect: If the geometry of this ObjModel is shared, it
+//               is replaced with a copy.  The DisplayList used
+//               by draw() is marked as out of date, and vertex
+//               vertex is added to the dirty range of the
+//               vertex arrays.  If a draw cache has already
+//               been built, draw() switches to vertex arrays.
+//               Otherwise, the next draw() builds the
+//               DisplayList as usual.
+//
+	void beginVertexChange (Index vertex);
+
+//
+//  updateBoundingBox
+//
+//  Purpose: To ensure the stored bounding box is up to date.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If the bounding box stored with the geometry is
+//               out of date, it is calculated again.
+//
+	void updateBoundingBox () const;
+
+//
+//  beginNormalChange
+//
+//  Purpose: To prepare the specified normal vector to be
+//           changed.  This function must be called before the
+//           normal vector is changed.
+//  Parameter(s):
+//    <1> normal: Which normal vector
+//  Precondition(s):
+//    <1> normal < getNormalCount()
+//  Returns: N/A
+//  Side Effect: If the geometry of this ObjModel is shared, it
+//               is replaced with a copy.  The DisplayList used
+//               by draw() is marked as out of date, and normal
+//               normal is added to the dirty range of the
+//               vertex arrays.  draw() switches to vertex arrays
+//               as for beginVertexChange.
+//
+	void beginNormalChange (Index normal);
+
+//
+//  changeElementVertexCount
+//
+//  Purpose: To update the count of elements with too few
+//           vertexes after the vertexes of a point set,
+//           polyline, or face have changed.
+//  Parameter(s):
+//    <1> old_count: The number of vertexes before the change
+//    <2> new_count: The number of vertexes after the change
+//    <3> minimum: The fewest vertexes the element may have
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If the element changed from having too few
+//               vertexes to enough or back, the count of short
+//               elements is updated.  An element that is added
+//               or removed should be treated as having minimum
+//               vertexes when it does not exist.
+//
+	void changeElementVertexCount (unsigned int old_count,
+	                               unsigned int new_count,
+	                               unsigned int minimum);
+
+//
+//  removeMeshElements
+//
+//  Purpose: To update the count of elements with too few
+//           vertexes before the point sets, polylines, and
+//           faces in a mesh are removed.
+//  Parameter(s):
+//    <1> mesh: Which mesh
+//    <2> is_point_sets: Whether the point sets are removed
+//    <3> is_polylines: Whether the polylines are removed
+//    <4> is_faces: Whether the faces are removed
+//  Precondition(s):
+//    <1> mesh < getMeshCount()
+//  Returns: N/A
+//  Side Effect: The elements of the specified types in mesh
+//               mesh with too few vertexes are no longer
+//               counted.  The elements are not removed.
+//
+	void removeMeshElements (unsigned int mesh,
+	                         bool is_point_sets,
+	                         bool is_polylines,
+	                         bool is_faces);
+
 //
 //  invariant
 //
@@ -3725,8 +4176,12 @@ private:
 		                 std::ostream& r_logstream);
 		MaterialLibrary (
 		               const MaterialLibrary& original);
+		MaterialLibrary (
+		               MaterialLibrary&& original) noexcept;
 		MaterialLibrary& operator= (
 		               const MaterialLibrary& original);
+		MaterialLibrary& operator= (
+		               MaterialLibrary&& original) noexcept;
 
 		std::string m_file_name;
 		MtlLibrary* mp_mtl_library;
@@ -3741,7 +4196,7 @@ private:
 	//
 	struct PointSet
 	{
-		std::vector<unsigned int> mv_vertexes;
+		std::vector<Index> mv_vertexes;
 	};
 
 	//
@@ -3761,14 +4216,14 @@ private:
 	{
 		PolylineVertex ();
 		PolylineVertex (
-		               unsigned int vertex,
-		               unsigned int texture_coordinate);
-		PolylineVertex (const PolylineVertex& original);
+		               Index vertex,
+		               Index texture_coordinate);
+		PolylineVertex (const PolylineVertex& original) noexcept;
 		PolylineVertex& operator= (
-		                const PolylineVertex& original);
+		       const PolylineVertex& original) noexcept;
 
-		unsigned int m_vertex;
-		unsigned int m_texture_coordinate;
+		Index m_vertex;
+		Index m_texture_coordinate;
 	};
 
 	//
@@ -3802,16 +4257,16 @@ private:
 	struct FaceVertex
 	{
 		FaceVertex ();
-		FaceVertex (unsigned int vertex,
-		            unsigned int texture_coordinate,
-		            unsigned int normal);
-		FaceVertex (const FaceVertex& original);
+		FaceVertex (Index vertex,
+		            Index texture_coordinate,
+		            Index normal);
+		FaceVertex (const FaceVertex& original) noexcept;
 		FaceVertex& operator= (
-		                    const FaceVertex& original);
+		           const FaceVertex& original) noexcept;
 
-		unsigned int m_vertex;
-		unsigned int m_texture_coordinate;
-		unsigned int m_normal;
+		Index m_vertex;
+		Index m_texture_coordinate;
+		Index m_normal;
 	};
 
 	//
@@ -3843,7 +4298,9 @@ private:
 		Mesh (const std::string& material_name,
 		      Material* p_material);
 		Mesh (const Mesh& original);
+		Mesh (Mesh&& original) noexcept;
 		Mesh& operator= (const Mesh& original);
+		Mesh& operator= (Mesh&& original) noexcept;
 
 		std::string m_material_name;
 		Material* mp_material;
@@ -3853,17 +4310,154 @@ private:
 		bool m_all_triangles;
 	};
 
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+	//
+	//  DrawArrays
+	//
+	//  A record to store the faces of an ObjModel as OpenGL
+	//    vertex arrays.  Each unique vertex/texture coordinate/
+	//    normal combination is one draw vertex, and the faces
+	//    of each mesh are split into triangle fans indexing
+	//    them.  The draw vertexes that use each vertex and each
+	//    normal are listed, starting at the matching element of
+	//    mv_vertex_use_starts or mv_normal_use_starts, so a
+	//    changed vertex or normal only updates its own draw
+	//    vertexes.
+	//
+	//  The dirty ranges are the vertexes and normals that have
+	//    changed since the arrays were last updated.  They are
+	//    stored as pairs of a first index and one past the last
+	//    index.
+	//
+	struct DrawArrays
+	{
+		DrawArrays ();
+
+		bool m_is_built;
+		std::vector<Index> mv_vertexes;
+		std::vector<Index> mv_normals;
+		std::vector<float> mv_position_data;
+		std::vector<float> mv_normal_data;
+		std::vector<float> mv_texture_coordinate_data;
+		std::vector<std::vector<unsigned int> > mvv_mesh_indexes;
+		std::vector<bool> mv_mesh_is_normals;
+		std::vector<bool> mv_mesh_is_texture_coordinates;
+		std::vector<unsigned int> mv_vertex_use_starts;
+		std::vector<unsigned int> mv_vertex_uses;
+		std::vector<unsigned int> mv_normal_use_starts;
+		std::vector<unsigned int> mv_normal_uses;
+		std::vector<Index> mv_dirty_vertex_ranges;
+		std::vector<Index> mv_dirty_normal_ranges;
+	};
+#endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
+
+	//
+	//  Geometry
+	//
+	//  A record to store the material libraries, vertexes,
+	//    texture coordinates, normals, and meshes of an
+	//    ObjModel.  A Geometry may be shared by several
+	//    ObjModels that are copies of each other.
+	//
+	//  The Geometry also stores the DisplayList and vertex
+	//    arrays draw() uses, so all the ObjModels sharing it
+	//    share one cache.  The vertex arrays are used instead
+	//    of the DisplayList if m_is_draw_arrays_used is set.
+	//    A copy of a Geometry does not copy the cache.
+	//
+	//  The bounding box is calculated when it is first
+	//    requested.  The mutex protects it, because that may
+	//    happen on several threads at once.
+	//
+	struct Geometry
+	{
+		Geometry ();
+		Geometry (const Geometry& original);
+
+		std::vector<MaterialLibrary> mv_material_libraries;
+		std::vector<Vector3> mv_vertexes;
+		std::vector<Vector2> mv_texture_coordinates;
+		std::vector<Vector3> mv_normals;
+		std::vector<Mesh> mv_meshes;
+		std::mutex m_bounding_box_mutex;
+		Vector3 m_bounding_box_min;
+		Vector3 m_bounding_box_max;
+		bool m_is_bounding_box_current;
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+		DisplayList m_draw_list;
+		bool m_is_draw_list_current;
+		DrawArrays m_draw_arrays;
+		bool m_is_draw_arrays_used;
+#endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
+
+	private:
+		Geometry& operator= (const Geometry& original);
+	};
+
+//
+//  getEmptyGeometry
+//
+//  Purpose: To retrieve the Geometry shared by empty ObjModels.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: A pointer to a Geometry with no elements.  The
+//           Geometry is never changed, because it is always
+//           shared.
+//  Side Effect: N/A
+//
+	static const std::shared_ptr<Geometry>& getEmptyGeometry ();
+
+	//
+	//  ValidationRange
+	//
+	//  A record to represent part of a mesh checked by
+	//    validate().  Each ValidationRange covers a range of
+	//    the faces in its mesh, and the first one for each mesh
+	//    also covers the point sets and polylines.  The results
+	//    are stored in the record, so many ranges can be
+	//    checked at once.
+	//
+	struct ValidationRange
+	{
+		ValidationRange ();
+		ValidationRange (unsigned int mesh,
+		                 unsigned int face_begin,
+		                 unsigned int face_end);
+
+		unsigned int m_mesh;
+		unsigned int m_face_begin;
+		unsigned int m_face_end;
+		unsigned int m_short_element_count;
+		bool m_is_references_valid;
+		bool m_is_all_triangles;
+	};
+
+//
+//  validateRange
+//
+//  Purpose: To check part of a mesh for validate().
+//  Parameter(s):
+//    <1> r_range: The part of the mesh to check
+//  Precondition(s):
+//    <1> r_range.m_mesh < getMeshCount()
+//    <2> r_range.m_face_begin <= r_range.m_face_end
+//    <3> r_range.m_face_end <= getFaceCount(r_range.m_mesh)
+//  Returns: N/A
+//  Side Effect: The number of short elements in r_range is
+//               counted, and whether they all reference
+//               existing elements and whether its faces are
+//               all triangles are stored in r_range.
+//
+	void validateRange (ValidationRange& r_range) const;
+
 private:
-	std::vector<MaterialLibrary> mv_material_libraries;
-	std::vector<Vector3> mv_vertexes;
-	std::vector<Vector2> mv_texture_coordinates;
-	std::vector<Vector3> mv_normals;
-	std::vector<Mesh> mv_meshes;
+	std::shared_ptr<Geometry> mp_geometry;
 
 	std::string m_file_name;
 	std::string m_file_path;
 	bool m_file_load_success;
-	bool m_valid;
+	bool m_is_references_valid;
+	unsigned int m_short_element_count;
 };
 
 
@@ -0,0 +1,224 @@
+//
+//  ObjModelManager.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <mutex>
+#include <condition_variable>
+
+#include "ObjStringParsing.h"
+#include "ObjModel.h"
+#include "ObjModelManager.h"
+
+using namespace std;
+using namespace ObjLibrary;
+using namespace ObjLibrary::ObjStringParsing;
+using namespace ObjLibrary::ObjModelManager;
+namespace
+{
+	// a loaded model and the canonical name it is stored under
+	struct Entry
+	{
+		std::string m_name;
+		ObjModel* mp_model;
+	};
+
+	std::vector<Entry> gv_models;
+
+	// models are loaded without holding the mutex, so
+	//  different models can load at the same time
+	std::mutex g_mutex;
+	std::condition_variable g_loaded_condition;
+	std::vector<std::string> gv_loading;
+
+	//
+	//  findLoaded
+	//
+	//  Purpose: To find the model with the specified name.
+	//  Parameter(s):
+	//    <1> canonical: The canonical name of the model file
+	//  Precondition(s):
+	//    <1> g_mutex is locked by the calling thread
+	//  Returns: A pointer to the ObjModel with name canonical,
+	//           or NULL if there is none.
+	//  Side Effect: N/A
+	//
+	ObjModel* findLoaded (const std::string& canonical)
+	{
+		for(unsigned int i = 0; i < gv_models.size(); i++)
+			if(gv_models[i].m_name == canonical)
+				return gv_models[i].mp_model;
+		return NULL;
+	}
+
+	//
+	//  findLoading
+	//
+	//  Purpose: To find the model with the specified name in the
+	//           list of models being loaded.
+	//  Parameter(s):
+	//    <1> canonical: The canonical name of the model file
+	//  Precondition(s):
+	//    <1> g_mutex is locked by the calling thread
+	//  Returns: The index of canonical in gv_loading, or
+	//           gv_loading.size() if it is not there.
+	//  Side Effect: N/A
+	//
+	unsigned int findLoading (const std::string& canonical)
+	{
+		for(unsigned int i = 0; i < gv_loading.size(); i++)
+			if(gv_loading[i] == canonical)
+				return i;
+		return (unsigned int)(gv_loading.size());
+	}
+}
+
+
+
+string ObjModelManager :: getCanonicalName (const string& name)
+{
+	string lower = toLowercase(name);
+
+	vector<string> v_parts;
+	size_t start = 0;
+	while(start <= lower.size())
+	{
+		size_t end = lower.find_first_of("/\\", start);
+		if(end == string::npos)
+			end = lower.size();
+		string part = lower.substr(start, end - start);
+
+		if(part == "." || (part == "" && !v_parts.empty()))
+			;  // skip "./" and "//"
+		else if(part == ".." && !v_parts.empty() &&
+		        v_parts.back() != ".." && v_parts.back() != "")
+			v_parts.pop_back();
+		else
+			v_parts.push_back(part);
+		start = end + 1;
+	}
+
+	string canonical;
+	for(unsigned int i = 0; i < v_parts.size(); i++)
+	{
+		if(i > 0)
+			canonical += '/';
+		canonical += v_parts[i];
+	}
+	return canonical;
+}
+
+unsigned int ObjModelManager :: getCount ()
+{
+	lock_guard<mutex> lock(g_mutex);
+	return (unsigned int)(gv_models.size());
+}
+
+const ObjModel& ObjModelManager :: get (unsigned int index)
+{
+	lock_guard<mutex> lock(g_mutex);
+	assert(index < gv_models.size());
+	return *(gv_models[index].mp_model);
+}
+
+bool ObjModelManager :: isLoaded (const string& name)
+{
+	string canonical = getCanonicalName(name);
+
+	lock_guard<mutex> lock(g_mutex);
+	return findLoaded(canonical) != NULL;
+}
+
+const ObjModel& ObjModelManager :: get (const string& name)
+{
+	assert(name != "");
+
+	return get(name, cerr);
+}
+
+const ObjModel& ObjModelManager :: get (const string& name, const string& logfile)
+{
+	assert(name != "");
+	assert(logfile != "");
+
+	ofstream logstream(logfile.c_str());
+	const ObjModel* p_model = &(get(name, logstream));
+	logstream.close();
+
+	return *p_model;
+}
+
+const ObjModel& ObjModelManager :: get (const string& name, ostream& r_logstream)
+{
+	assert(name != "");
+
+	string canonical = getCanonicalName(name);
+
+	unique_lock<mutex> lock(g_mutex);
+	ObjModel* p_model = findLoaded(canonical);
+	while(p_model == NULL && findLoading(canonical) < gv_loading.size())
+	{
+		// another thread is loading this model
+		g_loaded_condition.wait(lock);
+		p_model = findLoaded(canonical);
+	}
+	if(p_model != NULL)
+		return *p_model;
+
+	gv_loading.push_back(canonical);
+	lock.unlock();
+	p_model = new ObjModel(name, r_logstream);
+	lock.lock();
+
+	gv_loading.erase(gv_loading.begin() + findLoading(canonical));
+	Entry entry;
+	entry.m_name = canonical;
+	entry.mp_model = p_model;
+	gv_models.push_back(entry);
+	g_loaded_condition.notify_all();
+	return *p_model;
+}
+
+const ObjModel& ObjModelManager :: add (const ObjModel& model)
+{
+	Entry entry;
+	entry.m_name = getCanonicalName(model.getFileNameWithPath());
+
+	lock_guard<mutex> lock(g_mutex);
+
+	// check under the same lock, so no other thread can load
+	//  this model between the check and the addition
+	assert(findLoaded(entry.m_name) == NULL);
+	assert(findLoading(entry.m_name) >= gv_loading.size());
+
+	entry.mp_model = new ObjModel(model);
+	gv_models.push_back(entry);
+	return *(entry.mp_model);
+}
+
+void ObjModelManager :: unloadAll ()
+{
+	lock_guard<mutex> lock(g_mutex);
+	for(unsigned int i = 0; i < gv_models.size(); i++)
+		delete gv_models[i].mp_model;
+	gv_models.clear();
+}
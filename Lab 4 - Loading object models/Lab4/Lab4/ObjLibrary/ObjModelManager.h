@@ -0,0 +1,185 @@
+//
+//  ObjModelManager.h
+//
+//  A global service to share loaded ObjModels.
+//
+//  Each OBJ file is only loaded once.  The manager keeps one
+//    ObjModel for each file, and callers copy it to place the
+//    model in the world.  The copies share the geometry of the
+//    stored model until they are changed, so placing the same
+//    model many times does not duplicate its geometry.
+//
+//  Models are identified by a canonical form of their file
+//    name.  It is in lowercase, with '/' as the separator, and
+//    with any "./" and "directory/../" parts removed.  Thus
+//    "Models/Crate.obj" and "./models\crate.obj" are the same
+//    model.
+//
+//  The functions in this module may be called from any thread.
+//    Different models can be loaded at the same time.  If two
+//    threads request the same model at once, it is only loaded
+//    once.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_OBJ_MODEL_MANAGER_H
+#define OBJ_LIBRARY_OBJ_MODEL_MANAGER_H
+
+#include <string>
+#include <iostream>
+
+
+
+namespace ObjLibrary
+{
+
+class ObjModel;
+
+
+
+//
+//  ObjModelManager
+//
+//  A global service to handle ObjModels.
+//
+namespace ObjModelManager
+{
+
+//
+//  getCanonicalName
+//
+//  Purpose: To determine the name a model file is stored under.
+//  Parameter(s):
+//    <1> name: The name of the model file
+//  Precondition(s): N/A
+//  Returns: name in lowercase, with all '\' characters replaced
+//           by '/' and all "./" and "directory/../" parts
+//           removed.  Leading "../" parts are kept.
+//  Side Effect: N/A
+//
+std::string getCanonicalName (const std::string& name);
+
+//
+//  getCount
+//
+//  Purpose: To deterine the number of models loaded.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of ObjModels loaded.
+//  Side Effect: N/A
+//
+unsigned int getCount ();
+
+//
+//  get
+//
+//  Purpose: To retrieve a reference to the model with the
+//           specified index.
+//  Parameter(s):
+//    <1> index: Which model
+//  Precondition(s):
+//    <1> index < getCount()
+//  Returns: A reference to the ObjModel with index index.
+//  Side Effect: N/A
+//
+const ObjModel& get (unsigned int index);
+
+//
+//  isLoaded
+//
+//  Purpose: To determine if a model has been loaded from the
+//           specified file.  Names are compared in their
+//           canonical form.
+//  Parameter(s):
+//    <1> name: The name of the model file
+//  Precondition(s): N/A
+//  Returns: Whether there is a model loaded from file name.
+//  Side Effect: N/A
+//
+bool isLoaded (const std::string& name);
+
+//
+//  get
+//
+//  Purpose: To retrieve a reference to the model loaded from
+//           the specified file.  Names are compared in their
+//           canonical form.
+//  Parameter(s):
+//    <1> name: The name of the model file
+//    <2> logfile: The file to write loading errors to
+//    <2> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> name != ""
+//    <2> logfile != ""
+//  Returns: A reference to the ObjModel loaded from file name.
+//           If there is no model loaded from file name, a new
+//           ObjModel is loaded from it and returned.  If the
+//           file cannot be loaded, the new ObjModel is empty.
+//           Copies of the returned ObjModel share its geometry.
+//  Side Effect: If the ObjModel has not been loaded, error
+//               messages may be generated.  If a logfile or
+//               logging stream is specified, any loading errors
+//               are written to that file or stream.  Otherwise,
+//               any loading errors are written to the standard
+//               error stream.  If the ObjModel has already been
+//               loaded, no error messages will be printed.
+//
+const ObjModel& get (const std::string& name);
+const ObjModel& get (const std::string& name,
+                     const std::string& logfile);
+const ObjModel& get (const std::string& name,
+                     std::ostream& r_logstream);
+
+//
+//  add
+//
+//  Purpose: To add the specified ObjModel to the model manager.
+//  Parameter(s):
+//    <1> model: The model
+//  Precondition(s):
+//    <1> !isLoaded(model.getFileNameWithPath())
+//  Returns: A reference to the ObjModel added.
+//  Side Effect: A copy of ObjModel model is added to the model
+//               manager under the name model was loaded from.
+//               The copy shares the geometry of model.
+//
+const ObjModel& add (const ObjModel& model);
+
+//
+//  unloadAll
+//
+//  Purpose: To remove all models from the model manager.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All models are removed from the model manager.
+//               Copies made from them are not affected, and
+//               keep their geometry until they are destroyed.
+//               The MtlLibraries they use are not removed from
+//               the material library manager.
+//
+void unloadAll ();
+
+
+
+};	// end of namespace ObjModelManager
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -211,5 +211,28 @@
 
 
 
+//
+//  By default, the vertexes, texture coordinates, and normals
+//    in an ObjModel are indexed with 32-bit unsigned integers,
+//    so a model can have at most about 4 billion of each.
+//    Some very large models, such as those produced by
+//    photogrammetry, have more than this.  For them, the
+//    ObjLibrary can use 64-bit indexes instead.  These use
+//    twice as much memory for every face vertex, so they
+//    should only be enabled when needed.
+//
+//  The index type is available as ObjModel::Index.  Faces,
+//    polylines, point sets, and meshes are still counted with
+//    unsigned ints.  Models drawn with vertex arrays still use
+//    32-bit OpenGL indexes, so a model with too many draw
+//    vertexes for them is drawn in immediate mode instead.
+//
+//  To enable 64-bit indexes, define the macro
+//    OBJ_LIBRARY_64_BIT_INDEXES.
+//
+//#define OBJ_LIBRARY_64_BIT_INDEXES
+
+
+
 
 #endif
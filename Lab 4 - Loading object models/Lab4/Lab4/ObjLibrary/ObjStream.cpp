@@ -0,0 +1,1145 @@
+//
+//  ObjStream.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cstring>	// for memchr, memcpy, memmove
+#include <climits>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+
+#include "ObjStringParsing.h"
+#include "Vector2.h"
+#include "Vector3.h"
+#include "Vector3Array.h"
+#include "Matrix44.h"
+#include "JobSystem.h"
+#include "ObjModel.h"
+#include "SpillBuffer.h"
+#include "ObjStream.h"
+
+using namespace std;
+using namespace ObjLibrary;
+using namespace ObjLibrary::ObjStringParsing;
+namespace
+{
+	//
+	//  WINDOW_SIZE
+	//
+	//  The number of bytes of the OBJ file read at once.  A
+	//    window grows only if a single line is longer than it.
+	//
+	const unsigned int WINDOW_SIZE = 16 << 20;
+
+	//
+	//  BLOCK_SIZE
+	//
+	//  The number of vertexes or normals transformed together by
+	//    one job.
+	//
+	const unsigned int BLOCK_SIZE = 16384;
+
+	//
+	//  SAVE_CHUNK_SIZE
+	//
+	//  The number of elements formatted together into one
+	//    buffer and written with a single call when saving.
+	//
+	const unsigned int SAVE_CHUNK_SIZE = 16384;
+
+	//
+	//  SAVE_CHUNKS_PER_THREAD
+	//
+	//  The number of chunks formatted by each thread before
+	//    they are written.  More than one balances the load.
+	//
+	const unsigned int SAVE_CHUNKS_PER_THREAD = 2;
+
+	//
+	//  COPY_BLOCK_SIZE
+	//
+	//  The largest number of bytes written with a single call
+	//    when copying a temporary file into a binary model.
+	//
+	const size_t COPY_BLOCK_SIZE = 64 << 20;
+
+	//
+	//  readDoubles
+	//
+	//  Purpose: To read a number of doubles from a line of an
+	//           OBJ file.
+	//  Parameter(s):
+	//    <1> p_current: A pointer to the first token
+	//    <2> p_end: A pointer to just past the end of the line
+	//    <3> count: The number of doubles to read
+	//    <4> a_values: The array to read into
+	//  Precondition(s):
+	//    <1> p_current != NULL
+	//    <2> p_end != NULL
+	//    <3> p_current <= p_end
+	//    <4> a_values != NULL
+	//  Returns: Whether there were at least count tokens.  Any
+	//           extra tokens are ignored.
+	//  Side Effect: The first count elements of a_values are set.
+	//
+	bool readDoubles (const char* p_current,
+	                  const char* p_end,
+	                  unsigned int count,
+	                  double a_values[])
+	{
+		assert(p_current != NULL);
+		assert(p_end != NULL);
+		assert(p_current <= p_end);
+		assert(a_values != NULL);
+
+		for(unsigned int i = 0; i < count; i++)
+		{
+			p_current = skipWhitespace(p_current, p_end);
+			if(p_current == p_end)
+				return false;
+			const char* p_token_end = skipToken(p_current, p_end);
+			a_values[i] = parseDouble(p_current, p_token_end);
+			p_current = p_token_end;
+		}
+		return true;
+	}
+
+	//
+	//  readIndex
+	//
+	//  Purpose: To read a vertex, texture coordinate, or normal
+	//           index from a face vertex in an OBJ file.
+	//  Parameter(s):
+	//    <1> rp_current: A pointer to the first character of
+	//                    the index
+	//    <2> p_end: A pointer to just past the end of the face
+	//               vertex
+	//    <3> count: The number of elements the index can refer
+	//               to
+	//    <4> r_index: The index to set
+	//  Precondition(s):
+	//    <1> rp_current != NULL
+	//    <2> p_end != NULL
+	//    <3> rp_current <= p_end
+	//  Returns: Whether a valid index was read.  Indexes past
+	//           the end of the list are allowed, but 0 and
+	//           negative indexes before the start of the list are
+	//           not.
+	//  Side Effect: If a valid index was read, r_index is set to
+	//               it, reduced to start at 0 instead of 1.
+	//               Negative indexes count back from the end of
+	//               the list.  rp_current is advanced past the
+	//               digits.
+	//
+	bool readIndex (const char*& rp_current,
+	                const char* p_end,
+	                unsigned long long count,
+	                unsigned long long& r_index)
+	{
+		assert(rp_current != NULL);
+		assert(p_end != NULL);
+		assert(rp_current <= p_end);
+
+		bool is_negative = false;
+		if(rp_current < p_end && *rp_current == '-')
+		{
+			is_negative = true;
+			rp_current++;
+		}
+		else if(rp_current < p_end && *rp_current == '+')
+			rp_current++;
+		if(rp_current == p_end || !isdigit((unsigned char)(*rp_current)))
+			return false;
+
+		unsigned long long value = 0;
+		for(; rp_current < p_end && isdigit((unsigned char)(*rp_current)); rp_current++)
+		{
+			if(value > (ULLONG_MAX - 9) / 10)
+				return false;
+			value = value * 10 + (*rp_current - '0');
+		}
+
+		if(value == 0)
+			return false;
+		if(is_negative)
+		{
+			if(value > count)
+				return false;
+			r_index = count - value;
+		}
+		else
+			r_index = value - 1;
+		return true;
+	}
+
+	//
+	//  forEachBlock
+	//
+	//  Purpose: To split a range of elements into blocks and
+	//           handle them on the shared JobSystem.
+	//  Parameter(s):
+	//    <1> count: The number of elements
+	//    <2> function: The function to call for each block
+	//  Precondition(s):
+	//    <1> function
+	//  Returns: N/A
+	//  Side Effect: function(begin, end) is called for ranges of
+	//               at most BLOCK_SIZE elements that cover
+	//               [0, count) without overlapping.  This function
+	//               returns once all the ranges are done.
+	//
+	void forEachBlock (unsigned long long count,
+	                   const function<void (unsigned long long, unsigned long long)>& function)
+	{
+		assert(function);
+
+		unsigned long long block_count = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+		assert(block_count <= UINT_MAX);
+		JobSystem& r_jobs = JobSystem::getShared();
+		r_jobs.parallelFor((unsigned int)(block_count), 1, r_jobs.getWorkerCount() + 1,
+			[count, &function] (unsigned int begin, unsigned int end)
+			{
+				for(unsigned int b = begin; b < end; b++)
+				{
+					unsigned long long first = (unsigned long long)(b) * BLOCK_SIZE;
+					function(first, min(count, first + BLOCK_SIZE));
+				}
+			});
+	}
+
+	//
+	//  writeChunks
+	//
+	//  Purpose: To format a list of elements as text and write
+	//           it to a file.
+	//  Parameter(s):
+	//    <1> r_output: The file to write to
+	//    <2> count: The number of elements
+	//    <3> rv_chunks: The buffers to format into
+	//    <4> format: The function to append the text for
+	//                elements [begin, end) to a string
+	//  Precondition(s):
+	//    <1> r_output.is_open()
+	//    <2> !rv_chunks.empty()
+	//    <3> format
+	//  Returns: N/A
+	//  Side Effect: The elements are formatted in chunks of
+	//               SAVE_CHUNK_SIZE, in batches of
+	//               rv_chunks.size() chunks split across the
+	//               shared JobSystem.  Each chunk is then written
+	//               to r_output with a single call, in order.
+	//
+	void writeChunks (ofstream& r_output,
+	                  unsigned long long count,
+	                  vector<string>& rv_chunks,
+	                  const function<void (string&, unsigned long long, unsigned long long)>& format)
+	{
+		assert(r_output.is_open());
+		assert(!rv_chunks.empty());
+		assert(format);
+
+		unsigned long long batch_size = rv_chunks.size() * SAVE_CHUNK_SIZE;
+		for(unsigned long long batch = 0; batch < count; batch += batch_size)
+		{
+			unsigned long long batch_end = min(count, batch + batch_size);
+			unsigned int chunk_count = (unsigned int)((batch_end - batch + SAVE_CHUNK_SIZE - 1) / SAVE_CHUNK_SIZE);
+			JobSystem::getShared().parallelFor(chunk_count, 1, chunk_count,
+				[&rv_chunks, &format, batch, batch_end] (unsigned int begin, unsigned int end)
+				{
+					for(unsigned int c = begin; c < end; c++)
+					{
+						unsigned long long first = batch + (unsigned long long)(c) * SAVE_CHUNK_SIZE;
+						rv_chunks[c].clear();
+						format(rv_chunks[c], first, min(batch_end, first + SAVE_CHUNK_SIZE));
+					}
+				});
+
+			for(unsigned int c = 0; c < chunk_count; c++)
+				r_output.write(rv_chunks[c].data(), rv_chunks[c].size());
+		}
+	}
+
+	//
+	//  writeBlocks
+	//
+	//  Purpose: To write a large array of bytes to a file.
+	//  Parameter(s):
+	//    <1> r_output: The file to write to
+	//    <2> p_data: A pointer to the bytes
+	//    <3> size: The number of bytes
+	//  Precondition(s):
+	//    <1> r_output.is_open()
+	//    <2> p_data != NULL || size == 0
+	//  Returns: N/A
+	//  Side Effect: The bytes are written to r_output in blocks
+	//               of at most COPY_BLOCK_SIZE bytes.
+	//
+	void writeBlocks (ofstream& r_output,
+	                  const char* p_data,
+	                  unsigned long long size)
+	{
+		assert(r_output.is_open());
+		assert(p_data != NULL || size == 0);
+
+		for(unsigned long long done = 0; done < size; )
+		{
+			size_t block = (size_t)(min<unsigned long long>(size - done, COPY_BLOCK_SIZE));
+			r_output.write(p_data + done, block);
+			done += block;
+		}
+	}
+
+	//
+	//  appendBinaryValue
+	//  appendBinaryString
+	//
+	//  Purpose: To append a value to the header of a binary
+	//           model file.
+	//  Parameter(s):
+	//    <1> r_header: The header being built
+	//    <2> value: The value to append
+	//    <2> str: The string to append
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: The bytes of value are appended to
+	//               r_header.  A string is stored as its length
+	//               followed by its characters.
+	//
+	template <typename T>
+	void appendBinaryValue (string& r_header, const T& value)
+	{
+		r_header.append((const char*)(&value), sizeof(T));
+	}
+	void appendBinaryString (string& r_header, const string& str)
+	{
+		appendBinaryValue(r_header, (unsigned int)(str.size()));
+		r_header += str;
+	}
+
+}  // end of anonymous namespace
+
+
+
+const unsigned long long ObjStream :: NO_ELEMENT = ~0ull;
+const char ObjStream :: BINARY_MAGIC[4] = { 'O', 'L', 'B', 'M' };
+const unsigned int ObjStream :: BINARY_VERSION = 1;
+
+
+
+ObjStream :: ObjStream ()
+		: m_file_name(),
+		  m_is_open(false),
+		  m_is_spill_valid(true),
+		  m_vertexes(),
+		  m_texture_coordinates(),
+		  m_normals(),
+		  m_triangles(),
+		  m_vertex_count(0),
+		  m_texture_coordinate_count(0),
+		  m_normal_count(0),
+		  m_triangle_count(0),
+		  mv_material_libraries(),
+		  mv_meshes(),
+		  mv_face_vertexes(),
+		  m_skipped_element_count(0),
+		  m_bounding_box_min(),
+		  m_bounding_box_max()
+{
+	assert(invariant());
+}
+
+ObjStream :: ~ObjStream ()
+{
+	close();
+}
+
+
+
+bool ObjStream :: isOpen () const
+{
+	return m_is_open;
+}
+
+const string& ObjStream :: getFileName () const
+{
+	assert(isOpen());
+
+	return m_file_name;
+}
+
+unsigned long long ObjStream :: getVertexCount () const
+{
+	return m_vertex_count;
+}
+
+unsigned long long ObjStream :: getTextureCoordinateCount () const
+{
+	return m_texture_coordinate_count;
+}
+
+unsigned long long ObjStream :: getNormalCount () const
+{
+	return m_normal_count;
+}
+
+unsigned long long ObjStream :: getTriangleCount () const
+{
+	return m_triangle_count;
+}
+
+Vector3 ObjStream :: getVertex (unsigned long long vertex) const
+{
+	assert(vertex < getVertexCount());
+
+	const double* p_vertex = getVertexData() + vertex * 3;
+	return Vector3(p_vertex[0], p_vertex[1], p_vertex[2]);
+}
+
+Vector2 ObjStream :: getTextureCoordinate (unsigned long long texture_coordinate) const
+{
+	assert(texture_coordinate < getTextureCoordinateCount());
+
+	const double* p_texture_coordinate = getTextureCoordinateData() + texture_coordinate * 2;
+	return Vector2(p_texture_coordinate[0], p_texture_coordinate[1]);
+}
+
+Vector3 ObjStream :: getNormal (unsigned long long normal) const
+{
+	assert(normal < getNormalCount());
+
+	const double* p_normal = getNormalData() + normal * 3;
+	return Vector3(p_normal[0], p_normal[1], p_normal[2]);
+}
+
+const ObjStream::Triangle& ObjStream :: getTriangle (unsigned long long triangle) const
+{
+	assert(triangle < getTriangleCount());
+
+	return getTriangleData()[triangle];
+}
+
+unsigned int ObjStream :: getMaterialLibraryCount () const
+{
+	return (unsigned int)(mv_material_libraries.size());
+}
+
+const string& ObjStream :: getMaterialLibraryName (unsigned int library) const
+{
+	assert(library < getMaterialLibraryCount());
+
+	return mv_material_libraries[library];
+}
+
+unsigned int ObjStream :: getMeshCount () const
+{
+	return (unsigned int)(mv_meshes.size());
+}
+
+const string& ObjStream :: getMeshMaterialName (unsigned int mesh) const
+{
+	assert(mesh < getMeshCount());
+
+	return mv_meshes[mesh].m_material_name;
+}
+
+unsigned long long ObjStream :: getMeshFirstTriangle (unsigned int mesh) const
+{
+	assert(mesh < getMeshCount());
+
+	return mv_meshes[mesh].m_first_triangle;
+}
+
+unsigned long long ObjStream :: getMeshTriangleCount (unsigned int mesh) const
+{
+	assert(mesh < getMeshCount());
+
+	if(mesh + 1 < mv_meshes.size())
+		return mv_meshes[mesh + 1].m_first_triangle - mv_meshes[mesh].m_first_triangle;
+	else
+		return m_triangle_count - mv_meshes[mesh].m_first_triangle;
+}
+
+const Vector3& ObjStream :: getBoundingBoxMin () const
+{
+	return m_bounding_box_min;
+}
+
+const Vector3& ObjStream :: getBoundingBoxMax () const
+{
+	return m_bounding_box_max;
+}
+
+
+
+bool ObjStream :: open (const string& filename)
+{
+	assert(filename != "");
+
+	return open(filename, filename, cerr);
+}
+
+bool ObjStream :: open (const string& filename,
+                        const string& spill_prefix,
+                        ostream& r_logstream)
+{
+	assert(filename != "");
+	assert(spill_prefix != "");
+
+	close();
+
+	ifstream input(filename.c_str(), ios::in | ios::binary);
+	if(!input.is_open())
+	{
+		r_logstream << "Error: File \"" << filename << "\" does not exist" << endl;
+
+		assert(invariant());
+		return false;
+	}
+
+	if(!m_vertexes           .create(spill_prefix + ".v.spill")  ||
+	   !m_texture_coordinates.create(spill_prefix + ".vt.spill") ||
+	   !m_normals            .create(spill_prefix + ".vn.spill") ||
+	   !m_triangles          .create(spill_prefix + ".f.spill"))
+	{
+		r_logstream << "Error: Cannot create temporary files \"" << spill_prefix << ".*.spill\"" << endl;
+		close();
+		return false;
+	}
+	m_file_name = filename;
+
+	//
+	//  The file is read one window at a time.  The end of a
+	//    window is usually in the middle of a line, so the
+	//    start of that line is moved to the beginning of the
+	//    window and the rest of it is read after it.
+	//
+
+	vector<char> v_window(WINDOW_SIZE);
+	size_t carried = 0;
+	unsigned int line_count = 0;
+	bool is_end = false;
+	while(!is_end && m_is_spill_valid)
+	{
+		if(carried == v_window.size())
+			v_window.resize(v_window.size() * 2);	// very long line
+
+		input.read(v_window.data() + carried, v_window.size() - carried);
+		size_t filled = carried + (size_t)(input.gcount());
+		is_end = !input;
+
+		const char* p_window_end = v_window.data() + filled;
+		const char* p_line = v_window.data();
+		while(p_line < p_window_end)
+		{
+			const char* p_line_end = (const char*)(memchr(p_line, '\n', p_window_end - p_line));
+			if(p_line_end == NULL)
+			{
+				if(!is_end)
+					break;	// finish this line in the next window
+				p_line_end = p_window_end;	// last line has no newline
+			}
+
+			line_count++;
+			if(!readLine(p_line, p_line_end))
+			{
+				r_logstream << "Line " << setw(6) << line_count << " of file \"" << filename
+				            << "\" is invalid: \"" << string(p_line, p_line_end) << "\"" << endl;
+			}
+
+			if(p_line_end == p_window_end)
+				p_line = p_window_end;
+			else
+				p_line = p_line_end + 1;
+		}
+
+		carried = p_window_end - p_line;
+		if(carried > 0)
+			memmove(v_window.data(), p_line, carried);
+	}
+
+	if(m_skipped_element_count > 0)
+		r_logstream << "In file \"" << filename << "\": skipped " << m_skipped_element_count << " point sets and polylines" << endl;
+
+	if(!m_is_spill_valid ||
+	   !m_vertexes.map() || !m_texture_coordinates.map() ||
+	   !m_normals.map()  || !m_triangles.map())
+	{
+		r_logstream << "Error: Cannot write or map temporary files \"" << spill_prefix << ".*.spill\"" << endl;
+		close();
+		return false;
+	}
+	m_is_open = true;
+
+	assert(invariant());
+	return true;
+}
+
+void ObjStream :: transform (const Matrix44& matrix)
+{
+	assert(isOpen());
+
+	double* p_vertexes = getVertexData();
+	forEachBlock(m_vertex_count, [p_vertexes, &matrix] (unsigned long long begin, unsigned long long end)
+	{
+		// the vertexes are copied to a Vector3Array so the
+		//   fast transformation functions can be used
+		unsigned int count = (unsigned int)(end - begin);
+		Vector3Array<double> points(count);
+		double* p_block = p_vertexes + begin * 3;
+		for(unsigned int i = 0; i < count; i++)
+			points.set(i, Vector3(p_block[i * 3], p_block[i * 3 + 1], p_block[i * 3 + 2]));
+
+		matrix.transformPoints(points, points);
+
+		const double* p_x = points.getArrayX();
+		const double* p_y = points.getArrayY();
+		const double* p_z = points.getArrayZ();
+		for(unsigned int i = 0; i < count; i++)
+		{
+			p_block[i * 3]     = p_x[i];
+			p_block[i * 3 + 1] = p_y[i];
+			p_block[i * 3 + 2] = p_z[i];
+		}
+	});
+
+	double* p_normals = getNormalData();
+	forEachBlock(m_normal_count, [p_normals, &matrix] (unsigned long long begin, unsigned long long end)
+	{
+		unsigned int count = (unsigned int)(end - begin);
+		Vector3Array<double> normals(count);
+		double* p_block = p_normals + begin * 3;
+		for(unsigned int i = 0; i < count; i++)
+			normals.set(i, Vector3(p_block[i * 3], p_block[i * 3 + 1], p_block[i * 3 + 2]));
+
+		matrix.transformNormals(normals, normals);
+
+		const double* p_x = normals.getArrayX();
+		const double* p_y = normals.getArrayY();
+		const double* p_z = normals.getArrayZ();
+		for(unsigned int i = 0; i < count; i++)
+		{
+			p_block[i * 3]     = p_x[i];
+			p_block[i * 3 + 1] = p_y[i];
+			p_block[i * 3 + 2] = p_z[i];
+		}
+	});
+
+	calculateBoundingBox();
+
+	assert(invariant());
+}
+
+bool ObjStream :: save (const string& filename) const
+{
+	assert(isOpen());
+	assert(filename != "");
+
+	ofstream output_file(filename.c_str(), ios::out | ios::binary);
+	if(!output_file.is_open())
+		return false;
+
+	output_file << "#" << endl;
+	output_file << "# " << m_file_name << endl;
+	output_file << "#" << endl;
+	if(m_vertex_count > 0)
+		output_file << "# " << m_vertex_count << " vertexes" << endl;
+	if(m_texture_coordinate_count > 0)
+		output_file << "# " << m_texture_coordinate_count << " texture coordinate pairs" << endl;
+	if(m_normal_count > 0)
+		output_file << "# " << m_normal_count << " vertex normals" << endl;
+	if(!mv_meshes.empty())
+	{
+		output_file << "# " << mv_meshes.size() << " meshes" << endl;
+		output_file << "#  " << m_triangle_count << " faces" << endl;
+	}
+	output_file << "#" << endl;
+	output_file << endl;
+	output_file << endl;
+	output_file << endl;
+
+	if(!mv_material_libraries.empty())
+	{
+		output_file << "# " << mv_material_libraries.size() << " material libraries" << endl;
+		output_file << "mtllib";
+		for(unsigned int m = 0; m < mv_material_libraries.size(); m++)
+			output_file << " " << mv_material_libraries[m];
+		output_file << endl;
+		output_file << endl;
+		output_file << endl;
+		output_file << endl;
+	}
+
+	vector<string> v_chunks(ObjModel::getSaveThreadCount() * SAVE_CHUNKS_PER_THREAD);
+
+	if(m_vertex_count > 0)
+	{
+		const double* p_vertexes = getVertexData();
+		output_file << "# " << m_vertex_count << " vertexes" << endl;
+		writeChunks(output_file, m_vertex_count, v_chunks,
+		            [p_vertexes] (string& r_text, unsigned long long begin, unsigned long long end)
+		{
+			for(unsigned long long v = begin; v < end; v++)
+			{
+				r_text += "v ";
+				appendDouble(r_text, p_vertexes[v * 3]);
+				r_text += ' ';
+				appendDouble(r_text, p_vertexes[v * 3 + 1]);
+				r_text += ' ';
+				appendDouble(r_text, p_vertexes[v * 3 + 2]);
+				r_text += '\n';
+			}
+		});
+		output_file << endl;
+		output_file << endl;
+		output_file << endl;
+	}
+
+	if(m_texture_coordinate_count > 0)
+	{
+		const double* p_texture_coordinates = getTextureCoordinateData();
+		output_file << "# " << m_texture_coordinate_count << " texture coordinates" << endl;
+		writeChunks(output_file, m_texture_coordinate_count, v_chunks,
+		            [p_texture_coordinates] (string& r_text, unsigned long long begin, unsigned long long end)
+		{
+			for(unsigned long long t = begin; t < end; t++)
+			{
+				r_text += "vt ";
+				appendDouble(r_text, p_texture_coordinates[t * 2]);
+				r_text += ' ';
+				appendDouble(r_text, p_texture_coordinates[t * 2 + 1]);
+				r_text += '\n';
+			}
+		});
+		output_file << endl;
+		output_file << endl;
+		output_file << endl;
+	}
+
+	if(m_normal_count > 0)
+	{
+		const double* p_normals = getNormalData();
+		output_file << "# " << m_normal_count << " normals" << endl;
+		writeChunks(output_file, m_normal_count, v_chunks,
+		            [p_normals] (string& r_text, unsigned long long begin, unsigned long long end)
+		{
+			for(unsigned long long n = begin; n < end; n++)
+			{
+				r_text += "vn ";
+				appendDouble(r_text, p_normals[n * 3]);
+				r_text += ' ';
+				appendDouble(r_text, p_normals[n * 3 + 1]);
+				r_text += ' ';
+				appendDouble(r_text, p_normals[n * 3 + 2]);
+				r_text += '\n';
+			}
+		});
+		output_file << endl;
+		output_file << endl;
+		output_file << endl;
+	}
+
+	const Triangle* p_triangles = getTriangleData();
+	for(unsigned int m = 0; m < mv_meshes.size(); m++)
+	{
+		output_file << "# Mesh " << m << endl;
+		if(mv_meshes[m].m_material_name != "")
+			output_file << "usemtl " << mv_meshes[m].m_material_name << endl;
+
+		unsigned long long first = getMeshFirstTriangle(m);
+		unsigned long long count = getMeshTriangleCount(m);
+		if(count > 0)
+		{
+			output_file << "# " << count << " faces" << endl;
+			writeChunks(output_file, count, v_chunks,
+			            [p_triangles, first] (string& r_text, unsigned long long begin, unsigned long long end)
+			{
+				for(unsigned long long f = first + begin; f < first + end; f++)
+				{
+					const Triangle& triangle = p_triangles[f];
+					r_text += 'f';
+					for(unsigned int i = 0; i < 3; i++)
+					{
+						r_text += ' ';
+						appendUnsigned(r_text, triangle.ma_vertexes[i] + 1);
+
+						if(triangle.ma_texture_coordinates[i] != NO_ELEMENT)
+						{
+							r_text += '/';
+							appendUnsigned(r_text, triangle.ma_texture_coordinates[i] + 1);
+
+							if(triangle.ma_normals[i] != NO_ELEMENT)
+							{
+								r_text += '/';
+								appendUnsigned(r_text, triangle.ma_normals[i] + 1);
+							}
+						}
+						else if(triangle.ma_normals[i] != NO_ELEMENT)
+						{
+							r_text += "//";
+							appendUnsigned(r_text, triangle.ma_normals[i] + 1);
+						}
+					}
+					r_text += '\n';
+				}
+			});
+		}
+		output_file << endl;
+	}
+
+	output_file << endl;
+	output_file << endl;
+	output_file << "# End of " << filename << endl;
+	output_file << endl;
+
+	return !output_file.fail();
+}
+
+bool ObjStream :: saveBinary (const string& filename) const
+{
+	assert(isOpen());
+	assert(filename != "");
+
+	ofstream output_file(filename.c_str(), ios::out | ios::binary);
+	if(!output_file.is_open())
+		return false;
+
+	BinaryHeader header;
+	memcpy(header.ma_magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+	header.m_version                  = BINARY_VERSION;
+	header.m_vertex_count             = m_vertex_count;
+	header.m_texture_coordinate_count = m_texture_coordinate_count;
+	header.m_normal_count             = m_normal_count;
+	header.m_triangle_count           = m_triangle_count;
+	header.m_material_library_count   = (unsigned int)(mv_material_libraries.size());
+	header.m_mesh_count               = (unsigned int)(mv_meshes.size());
+
+	string header_bytes;
+	appendBinaryValue(header_bytes, header);
+	for(unsigned int i = 0; i < mv_material_libraries.size(); i++)
+		appendBinaryString(header_bytes, mv_material_libraries[i]);
+	for(unsigned int m = 0; m < mv_meshes.size(); m++)
+	{
+		appendBinaryString(header_bytes, mv_meshes[m].m_material_name);
+		appendBinaryValue(header_bytes, getMeshFirstTriangle(m));
+		appendBinaryValue(header_bytes, getMeshTriangleCount(m));
+	}
+	header_bytes.resize((header_bytes.size() + BINARY_ALIGNMENT - 1) / BINARY_ALIGNMENT * BINARY_ALIGNMENT, '\0');
+	output_file.write(header_bytes.data(), header_bytes.size());
+
+	writeBlocks(output_file, m_vertexes           .getData(), m_vertexes           .getSize());
+	writeBlocks(output_file, m_texture_coordinates.getData(), m_texture_coordinates.getSize());
+	writeBlocks(output_file, m_normals            .getData(), m_normals            .getSize());
+	writeBlocks(output_file, m_triangles          .getData(), m_triangles          .getSize());
+
+	return !output_file.fail();
+}
+
+void ObjStream :: close ()
+{
+	m_vertexes.destroy();
+	m_texture_coordinates.destroy();
+	m_normals.destroy();
+	m_triangles.destroy();
+
+	m_file_name.clear();
+	m_is_open                  = false;
+	m_is_spill_valid           = true;
+	m_vertex_count             = 0;
+	m_texture_coordinate_count = 0;
+	m_normal_count             = 0;
+	m_triangle_count           = 0;
+	mv_material_libraries.clear();
+	mv_meshes.clear();
+	mv_face_vertexes.clear();
+	m_skipped_element_count    = 0;
+	m_bounding_box_min         = Vector3::ZERO;
+	m_bounding_box_max         = Vector3::ZERO;
+
+	assert(invariant());
+}
+
+
+
+bool ObjStream :: readLine (const char* p_line, const char* p_end)
+{
+	assert(p_line != NULL);
+	assert(p_end != NULL);
+	assert(p_line <= p_end);
+
+	const char* p_token = skipWhitespace(p_line, p_end);
+	if(p_token == p_end || *p_token == '#')
+		return true;	// skip blank lines and comments
+
+	const char* p_token_end = skipToken(p_token, p_end);
+	const char* p_rest      = skipWhitespace(p_token_end, p_end);
+
+	if(isTokenEqual(p_token, p_token_end, "v"))
+	{
+		double a_values[3];
+		if(!readDoubles(p_rest, p_end, 3, a_values))
+			return false;
+
+		Vector3 vertex(a_values[0], a_values[1], a_values[2]);
+		if(m_vertex_count == 0)
+		{
+			m_bounding_box_min = vertex;
+			m_bounding_box_max = vertex;
+		}
+		else
+		{
+			m_bounding_box_min = m_bounding_box_min.getMinComponents(vertex);
+			m_bounding_box_max = m_bounding_box_max.getMaxComponents(vertex);
+		}
+
+		if(!m_vertexes.append(a_values, sizeof(a_values)))
+			m_is_spill_valid = false;
+		m_vertex_count++;
+		return true;
+	}
+	else if(isTokenEqual(p_token, p_token_end, "vt"))
+	{
+		double a_values[2];
+		if(!readDoubles(p_rest, p_end, 2, a_values))
+			return false;
+
+		if(!m_texture_coordinates.append(a_values, sizeof(a_values)))
+			m_is_spill_valid = false;
+		m_texture_coordinate_count++;
+		return true;
+	}
+	else if(isTokenEqual(p_token, p_token_end, "vn"))
+	{
+		double a_values[3];
+		if(!readDoubles(p_rest, p_end, 3, a_values))
+			return false;
+
+		if(!m_normals.append(a_values, sizeof(a_values)))
+			m_is_spill_valid = false;
+		m_normal_count++;
+		return true;
+	}
+	else if(isTokenEqual(p_token, p_token_end, "f"))
+		return readFace(p_rest, p_end);
+	else if(isTokenEqual(p_token, p_token_end, "usemtl"))
+	{
+		Mesh mesh;
+		mesh.m_material_name.assign(p_rest, skipToken(p_rest, p_end));
+		mesh.m_first_triangle = m_triangle_count;
+		mv_meshes.push_back(mesh);
+		return true;
+	}
+	else if(isTokenEqual(p_token, p_token_end, "mtllib"))
+	{
+		if(p_rest == p_end)
+			return false;
+		while(p_rest < p_end)
+		{
+			const char* p_library_end = skipToken(p_rest, p_end);
+			mv_material_libraries.push_back(string(p_rest, p_library_end));
+			p_rest = skipWhitespace(p_library_end, p_end);
+		}
+		return true;
+	}
+	else if(isTokenEqual(p_token, p_token_end, "p") ||
+	        isTokenEqual(p_token, p_token_end, "l"))
+	{
+		m_skipped_element_count++;
+		return true;
+	}
+	else if(isTokenEqual(p_token, p_token_end, "g") ||
+	        isTokenEqual(p_token, p_token_end, "s") ||
+	        isTokenEqual(p_token, p_token_end, "o"))
+	{
+		return true;	// ignore groups, smoothing groups, and object names
+	}
+	else
+		return false;
+}
+
+bool ObjStream :: readFace (const char* p_current, const char* p_end)
+{
+	assert(p_current != NULL);
+	assert(p_end != NULL);
+	assert(p_current <= p_end);
+
+	mv_face_vertexes.clear();
+	for(p_current = skipWhitespace(p_current, p_end); p_current < p_end; p_current = skipWhitespace(p_current, p_end))
+	{
+		const char* p_token_end = skipToken(p_current, p_end);
+
+		FaceVertex face_vertex;
+		face_vertex.m_texture_coordinate = NO_ELEMENT;
+		face_vertex.m_normal             = NO_ELEMENT;
+		if(!readIndex(p_current, p_token_end, m_vertex_count, face_vertex.m_vertex))
+			return false;
+		if(p_current < p_token_end && *p_current == '/')
+		{
+			p_current++;
+			if(p_current < p_token_end && *p_current != '/' &&
+			   !readIndex(p_current, p_token_end, m_texture_coordinate_count, face_vertex.m_texture_coordinate))
+			{
+				return false;
+			}
+
+			if(p_current < p_token_end && *p_current == '/')
+			{
+				p_current++;
+				if(p_current < p_token_end &&
+				   !readIndex(p_current, p_token_end, m_normal_count, face_vertex.m_normal))
+				{
+					return false;
+				}
+			}
+		}
+		mv_face_vertexes.push_back(face_vertex);
+		p_current = p_token_end;
+	}
+
+	if(mv_face_vertexes.size() < 3)
+		return false;
+
+	if(mv_meshes.empty())
+	{
+		Mesh mesh;
+		mesh.m_first_triangle = m_triangle_count;
+		mv_meshes.push_back(mesh);
+	}
+
+	// fan out from the first vertex
+	for(unsigned int i = 2; i < mv_face_vertexes.size(); i++)
+	{
+		const FaceVertex* ap_corners[3] = { &mv_face_vertexes[0],
+		                                    &mv_face_vertexes[i - 1],
+		                                    &mv_face_vertexes[i] };
+		Triangle triangle;
+		for(unsigned int c = 0; c < 3; c++)
+		{
+			triangle.ma_vertexes[c]            = ap_corners[c]->m_vertex;
+			triangle.ma_texture_coordinates[c] = ap_corners[c]->m_texture_coordinate;
+			triangle.ma_normals[c]             = ap_corners[c]->m_normal;
+		}
+
+		if(!m_triangles.append(&triangle, sizeof(triangle)))
+			m_is_spill_valid = false;
+		m_triangle_count++;
+	}
+	return true;
+}
+
+void ObjStream :: calculateBoundingBox ()
+{
+	assert(isOpen());
+
+	if(m_vertex_count == 0)
+	{
+		m_bounding_box_min = Vector3::ZERO;
+		m_bounding_box_max = Vector3::ZERO;
+		return;
+	}
+
+	// each block finds its own bounding box and then adds it
+	//   to the total
+	const double* p_vertexes = getVertexData();
+	Vector3 bounding_box_min(getVertex(0));
+	Vector3 bounding_box_max(getVertex(0));
+	mutex total_mutex;
+	forEachBlock(m_vertex_count, [p_vertexes, &bounding_box_min, &bounding_box_max, &total_mutex]
+	                             (unsigned long long begin, unsigned long long end)
+	{
+		const double* p_block = p_vertexes + begin * 3;
+		Vector3 block_min(p_block[0], p_block[1], p_block[2]);
+		Vector3 block_max = block_min;
+		for(unsigned int i = 1; i < end - begin; i++)
+		{
+			Vector3 vertex(p_block[i * 3], p_block[i * 3 + 1], p_block[i * 3 + 2]);
+			block_min = block_min.getMinComponents(vertex);
+			block_max = block_max.getMaxComponents(vertex);
+		}
+
+		lock_guard<mutex> lock(total_mutex);
+		bounding_box_min = bounding_box_min.getMinComponents(block_min);
+		bounding_box_max = bounding_box_max.getMaxComponents(block_max);
+	});
+
+	m_bounding_box_min = bounding_box_min;
+	m_bounding_box_max = bounding_box_max;
+}
+
+const double* ObjStream :: getVertexData () const
+{
+	assert(isOpen());
+
+	return (const double*)(m_vertexes.getData());
+}
+
+double* ObjStream :: getVertexData ()
+{
+	assert(isOpen());
+
+	return (double*)(m_vertexes.getData());
+}
+
+const double* ObjStream :: getTextureCoordinateData () const
+{
+	assert(isOpen());
+
+	return (const double*)(m_texture_coordinates.getData());
+}
+
+const double* ObjStream :: getNormalData () const
+{
+	assert(isOpen());
+
+	return (const double*)(m_normals.getData());
+}
+
+double* ObjStream :: getNormalData ()
+{
+	assert(isOpen());
+
+	return (double*)(m_normals.getData());
+}
+
+const ObjStream::Triangle* ObjStream :: getTriangleData () const
+{
+	assert(isOpen());
+
+	return (const Triangle*)(m_triangles.getData());
+}
+
+bool ObjStream :: invariant () const
+{
+	if(m_is_open && m_file_name == "") return false;
+	if(m_is_open && !m_vertexes.isMapped()) return false;
+	if(m_is_open && !m_texture_coordinates.isMapped()) return false;
+	if(m_is_open && !m_normals.isMapped()) return false;
+	if(m_is_open && !m_triangles.isMapped()) return false;
+	if(m_vertexes.getSize() != m_vertex_count * 3 * sizeof(double) && m_is_spill_valid) return false;
+	if(m_texture_coordinates.getSize() != m_texture_coordinate_count * 2 * sizeof(double) && m_is_spill_valid) return false;
+	if(m_normals.getSize() != m_normal_count * 3 * sizeof(double) && m_is_spill_valid) return false;
+	if(m_triangles.getSize() != m_triangle_count * sizeof(Triangle) && m_is_spill_valid) return false;
+	for(unsigned int m = 1; m < mv_meshes.size(); m++)
+		if(mv_meshes[m].m_first_triangle < mv_meshes[m - 1].m_first_triangle) return false;
+	return true;
+}
@@ -0,0 +1,602 @@
+//
+//  ObjStream.h
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_OBJ_STREAM_H
+#define OBJ_LIBRARY_OBJ_STREAM_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "Vector2.h"
+#include "Vector3.h"
+#include "SpillBuffer.h"
+
+
+
+namespace ObjLibrary
+{
+
+class Matrix44;
+
+
+
+//
+//  ObjStream
+//
+//  A class to process an OBJ file that is too large to load
+//    into an ObjModel.  The file is read in fixed-size windows,
+//    so only a few megabytes of it are in memory at once.  The
+//    vertexes, texture coordinates, normals, and faces are
+//    written to temporary SpillBuffer files as they are read,
+//    and the SpillBuffers are then mapped into memory.  The
+//    operating system keeps only the parts being used in
+//    memory, so the model can be much larger than the available
+//    memory.
+//
+//  Faces are split into triangles as they are read, by fanning
+//    out from the first vertex of each face.  The triangles are
+//    divided into meshes by the materials they use.  Point sets
+//    and polylines are skipped.  The bounding box of the
+//    vertexes is calculated as the file is read.
+//
+//  An ObjStream can transform its vertexes and normals in
+//    place, and then save them as a triangulated OBJ file or as
+//    a binary model file.  A binary model file can be loaded
+//    much faster than an OBJ file, either into an ObjModel with
+//    the loadBinary function or by mapping it into memory.
+//    Its format is:
+//
+//    Header
+//      -> the magic number "OLBM" and the version
+//      -> the vertex, texture coordinate, normal, and triangle
+//         counts, as 64-bit integers
+//      -> the material library and mesh counts
+//      -> the material library names
+//      -> for each mesh, the material name, the first triangle,
+//         and the triangle count
+//      -> padding to a multiple of 8 bytes
+//    Vertexes, as 3 doubles each
+//    Texture coordinates, as 2 doubles each
+//    Normals, as 3 doubles each
+//    Triangles, as 9 64-bit integers each: the 3 vertex
+//      indexes, then the 3 texture coordinate indexes, then the
+//      3 normal indexes
+//
+//  Strings are stored as a 32-bit length followed by their
+//    characters.  Missing texture coordinate and normal indexes
+//    are stored as NO_ELEMENT.  Values are stored as they are
+//    in memory, so a binary model file can only be read on a
+//    computer with the same byte order as the one that wrote
+//    it.
+//
+//  The whole of each temporary file is mapped at once, so a
+//    very large model requires a 64-bit program.
+//
+class ObjStream
+{
+public:
+//
+//  NO_ELEMENT
+//
+//  A constant indicating that a triangle corner does not have
+//    a texture coordinate pair or normal.
+//
+	static const unsigned long long NO_ELEMENT;
+
+//
+//  BINARY_MAGIC
+//  BINARY_VERSION
+//  BINARY_ALIGNMENT
+//
+//  The first values in every binary model file, and the number
+//    of bytes the header is padded to a multiple of.  The
+//    version must be changed whenever the layout changes.
+//
+	static const char BINARY_MAGIC[4];
+	static const unsigned int BINARY_VERSION;
+	static const unsigned int BINARY_ALIGNMENT = 8;
+
+//
+//  BinaryHeader
+//
+//  A record to store the values at the start of a binary model
+//    file.  The material library names and mesh records follow
+//    it.
+//
+	struct BinaryHeader
+	{
+		char ma_magic[4];
+		unsigned int m_version;
+		unsigned long long m_vertex_count;
+		unsigned long long m_texture_coordinate_count;
+		unsigned long long m_normal_count;
+		unsigned long long m_triangle_count;
+		unsigned int m_material_library_count;
+		unsigned int m_mesh_count;
+	};
+
+//
+//  Triangle
+//
+//  A record to store the indexes of the vertexes, texture
+//    coordinate pairs, and normals at the corners of a
+//    triangle.  Indexes start at 0.
+//
+	struct Triangle
+	{
+		unsigned long long ma_vertexes[3];
+		unsigned long long ma_texture_coordinates[3];
+		unsigned long long ma_normals[3];
+	};
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new ObjStream that is not open.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new ObjStream is created.
+//
+	ObjStream ();
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy this ObjStream.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If this ObjStream is open, it is closed.
+//
+	~ObjStream ();
+
+//
+//  isOpen
+//
+//  Purpose: To determine if this ObjStream is open.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this ObjStream is open.
+//  Side Effect: N/A
+//
+	bool isOpen () const;
+
+//
+//  getFileName
+//
+//  Purpose: To determine the name of the OBJ file this
+//           ObjStream was opened from.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isOpen()
+//  Returns: The name of the OBJ file.
+//  Side Effect: N/A
+//
+	const std::string& getFileName () const;
+
+//
+//  getVertexCount
+//  getTextureCoordinateCount
+//  getNormalCount
+//  getTriangleCount
+//
+//  Purpose: To determine the number of vertexes, texture
+//           coordinate pairs, normals, or triangles in this
+//           ObjStream.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of elements of that type.  If this
+//           ObjStream is not open, 0 is returned.
+//  Side Effect: N/A
+//
+	unsigned long long getVertexCount () const;
+	unsigned long long getTextureCoordinateCount () const;
+	unsigned long long getNormalCount () const;
+	unsigned long long getTriangleCount () const;
+
+//
+//  getVertex
+//
+//  Purpose: To retrieve the position of the specified vertex.
+//  Parameter(s):
+//    <1> vertex: The index of the vertex
+//  Precondition(s):
+//    <1> vertex < getVertexCount()
+//  Returns: The position of vertex vertex.
+//  Side Effect: N/A
+//
+	Vector3 getVertex (unsigned long long vertex) const;
+
+//
+//  getTextureCoordinate
+//
+//  Purpose: To retrieve the specified texture coordinate pair.
+//  Parameter(s):
+//    <1> texture_coordinate: The index of the texture
+//                            coordinate pair
+//  Precondition(s):
+//    <1> texture_coordinate < getTextureCoordinateCount()
+//  Returns: Texture coordinate pair texture_coordinate.
+//  Side Effect: N/A
+//
+	Vector2 getTextureCoordinate (
+	                 unsigned long long texture_coordinate) const;
+
+//
+//  getNormal
+//
+//  Purpose: To retrieve the specified normal.
+//  Parameter(s):
+//    <1> normal: The index of the normal
+//  Precondition(s):
+//    <1> normal < getNormalCount()
+//  Returns: Normal normal.
+//  Side Effect: N/A
+//
+	Vector3 getNormal (unsigned long long normal) const;
+
+//
+//  getTriangle
+//
+//  Purpose: To retrieve the specified triangle.
+//  Parameter(s):
+//    <1> triangle: The index of the triangle
+//  Precondition(s):
+//    <1> triangle < getTriangleCount()
+//  Returns: The indexes for the corners of triangle triangle.
+//           The indexes are not checked when the file is read,
+//           so they may refer to elements that do not exist.
+//  Side Effect: N/A
+//
+	const Triangle& getTriangle (unsigned long long triangle) const;
+
+//
+//  getMaterialLibraryCount
+//
+//  Purpose: To determine the number of material libraries
+//           referenced by the OBJ file.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of material libraries.
+//  Side Effect: N/A
+//
+	unsigned int getMaterialLibraryCount () const;
+
+//
+//  getMaterialLibraryName
+//
+//  Purpose: To determine the name of the specified material
+//           library.
+//  Parameter(s):
+//    <1> library: The index of the material library
+//  Precondition(s):
+//    <1> library < getMaterialLibraryCount()
+//  Returns: The name of material library library, as it
+//           appears in the OBJ file.
+//  Side Effect: N/A
+//
+	const std::string& getMaterialLibraryName (
+	                                 unsigned int library) const;
+
+//
+//  getMeshCount
+//
+//  Purpose: To determine the number of meshes in this
+//           ObjStream.  A new mesh is started for each
+//           "usemtl" line in the OBJ file.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of meshes.
+//  Side Effect: N/A
+//
+	unsigned int getMeshCount () const;
+
+//
+//  getMeshMaterialName
+//
+//  Purpose: To determine the name of the material for the
+//           specified mesh.
+//  Parameter(s):
+//    <1> mesh: The index of the mesh
+//  Precondition(s):
+//    <1> mesh < getMeshCount()
+//  Returns: The name of the material for mesh mesh.  If the
+//           mesh has no material, "" is returned.
+//  Side Effect: N/A
+//
+	const std::string& getMeshMaterialName (unsigned int mesh) const;
+
+//
+//  getMeshFirstTriangle
+//  getMeshTriangleCount
+//
+//  Purpose: To determine which triangles are in the specified
+//           mesh.
+//  Parameter(s):
+//    <1> mesh: The index of the mesh
+//  Precondition(s):
+//    <1> mesh < getMeshCount()
+//  Returns: The index of the first triangle in mesh mesh, or
+//           the number of triangles in it.  The triangles in
+//           each mesh are consecutive.
+//  Side Effect: N/A
+//
+	unsigned long long getMeshFirstTriangle (unsigned int mesh) const;
+	unsigned long long getMeshTriangleCount (unsigned int mesh) const;
+
+//
+//  getBoundingBoxMin
+//  getBoundingBoxMax
+//
+//  Purpose: To determine the corners of the axis-aligned
+//           bounding box around the vertexes in this ObjStream.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The minimum or maximum corner of the bounding box.
+//           If there are no vertexes, the zero vector is
+//           returned.
+//  Side Effect: N/A
+//
+	const Vector3& getBoundingBoxMin () const;
+	const Vector3& getBoundingBoxMax () const;
+
+//
+//  open
+//
+//  Purpose: To read an OBJ file into this ObjStream.
+//  Parameter(s):
+//    <1> filename: The name of the OBJ file
+//    <2> spill_prefix: The start of the names of the temporary
+//                      files
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> filename != ""
+//    <2> spill_prefix != ""
+//  Returns: Whether the OBJ file could be read.  This is false
+//           if the file does not exist or the temporary files
+//           could not be written or mapped into memory.
+//  Side Effect: If this ObjStream is open, it is closed.  Then
+//               file filename is read in windows of a fixed
+//               size.  Temporary files with names starting with
+//               spill_prefix are created for the elements in
+//               it.  If spill_prefix is not specified, the name
+//               of the OBJ file is used.  Invalid lines are
+//               written to r_logstream, or to the standard
+//               error stream if it is not specified.
+//
+	bool open (const std::string& filename);
+	bool open (const std::string& filename,
+	           const std::string& spill_prefix,
+	           std::ostream& r_logstream);
+
+//
+//  transform
+//
+//  Purpose: To transform the vertexes and normals of this
+//           ObjStream by the specified matrix.
+//  Parameter(s):
+//    <1> matrix: The transformation matrix
+//  Precondition(s):
+//    <1> isOpen()
+//  Returns: N/A
+//  Side Effect: Each vertex is transformed as by
+//               Matrix44::getTransformedPoint and each normal
+//               as by Matrix44::getTransformedNormal.
+//               The elements are changed in place, split
+//               across the shared JobSystem.  The bounding box
+//               is recalculated.
+//
+	void transform (const Matrix44& matrix);
+
+//
+//  save
+//
+//  Purpose: To write this ObjStream to an OBJ file.
+//  Parameter(s):
+//    <1> filename: The name of the file to write
+//  Precondition(s):
+//    <1> isOpen()
+//    <2> filename != ""
+//  Returns: Whether the file could be written.
+//  Side Effect: This ObjStream is written to file filename in
+//               OBJ format, with every face as a triangle.  The
+//               elements are formatted in large buffers, in
+//               parallel, and each buffer is written at once.
+//
+	bool save (const std::string& filename) const;
+
+//
+//  saveBinary
+//
+//  Purpose: To write this ObjStream to a binary model file.
+//  Parameter(s):
+//    <1> filename: The name of the file to write
+//  Precondition(s):
+//    <1> isOpen()
+//    <2> filename != ""
+//  Returns: Whether the file could be written.
+//  Side Effect: This ObjStream is written to file filename in
+//               the binary model format described above.  The
+//               elements are copied straight from the temporary
+//               files.
+//
+	bool saveBinary (const std::string& filename) const;
+
+//
+//  close
+//
+//  Purpose: To close this ObjStream.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The temporary files are deleted and this
+//               ObjStream is set to be empty.  Any references
+//               returned by getTriangle become invalid.
+//
+	void close ();
+
+private:
+//
+//  Mesh
+//
+//  A record to store the material and first triangle of a
+//    mesh.
+//
+	struct Mesh
+	{
+		std::string m_material_name;
+		unsigned long long m_first_triangle;
+	};
+
+//
+//  FaceVertex
+//
+//  A record to store the indexes for one vertex of a face
+//    while it is being read.
+//
+	struct FaceVertex
+	{
+		unsigned long long m_vertex;
+		unsigned long long m_texture_coordinate;
+		unsigned long long m_normal;
+	};
+
+//
+//  Copy Constructor
+//  Assignment Operator
+//
+//  These functions have intentionally not been implemented
+//    because the temporary files can only be deleted once.
+//
+	ObjStream (const ObjStream& original);
+	ObjStream& operator= (const ObjStream& original);
+
+//
+//  readLine
+//
+//  Purpose: To process one line of the OBJ file.
+//  Parameter(s):
+//    <1> p_line: A pointer to the start of the line
+//    <2> p_end: A pointer to just past the end of the line
+//  Precondition(s):
+//    <1> p_line != NULL
+//    <2> p_end != NULL
+//    <3> p_line <= p_end
+//  Returns: Whether the line was valid.  Blank lines, comments,
+//           and lines that are skipped are valid.
+//  Side Effect: The elements on the line are added to the
+//               SpillBuffers.
+//
+	bool readLine (const char* p_line, const char* p_end);
+
+//
+//  readFace
+//
+//  Purpose: To read a face from a line of the OBJ file and
+//           split it into triangles.
+//  Parameter(s):
+//    <1> p_current: A pointer to the first token after the "f"
+//    <2> p_end: A pointer to just past the end of the line
+//  Precondition(s):
+//    <1> p_current != NULL
+//    <2> p_end != NULL
+//    <3> p_current <= p_end
+//  Returns: Whether the face was valid.
+//  Side Effect: If the face is valid, its triangles are added
+//               to the last mesh.  A mesh is started if there
+//               are none.
+//
+	bool readFace (const char* p_current, const char* p_end);
+
+//
+//  calculateBoundingBox
+//
+//  Purpose: To recalculate the bounding box from the vertexes.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isOpen()
+//  Returns: N/A
+//  Side Effect: The bounding box is set to enclose all the
+//               vertexes, split across the shared JobSystem.
+//
+	void calculateBoundingBox ();
+
+//
+//  getVertexData
+//  getTextureCoordinateData
+//  getNormalData
+//  getTriangleData
+//
+//  Purpose: To retrieve the mapped elements of a type.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isOpen()
+//  Returns: A pointer to the first element of the type, or
+//           NULL if there are none.
+//  Side Effect: N/A
+//
+	const double* getVertexData () const;
+	double* getVertexData ();
+	const double* getTextureCoordinateData () const;
+	const double* getNormalData () const;
+	double* getNormalData ();
+	const Triangle* getTriangleData () const;
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	std::string m_file_name;
+	bool m_is_open;
+	bool m_is_spill_valid;
+
+	SpillBuffer m_vertexes;
+	SpillBuffer m_texture_coordinates;
+	SpillBuffer m_normals;
+	SpillBuffer m_triangles;
+	unsigned long long m_vertex_count;
+	unsigned long long m_texture_coordinate_count;
+	unsigned long long m_normal_count;
+	unsigned long long m_triangle_count;
+
+	std::vector<std::string> mv_material_libraries;
+	std::vector<Mesh> mv_meshes;
+	std::vector<FaceVertex> mv_face_vertexes;
+	unsigned long long m_skipped_element_count;
+
+	Vector3 m_bounding_box_min;
+	Vector3 m_bounding_box_max;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -18,6 +18,11 @@
 //
 
 #include <cassert>
+#include <cmath>
+#include <cstdio>	// for snprintf
+#include <cstdlib>	// for strtod
+#include <cstring>	// for memcpy
+#include <cctype>
 #include <string>
 
 #include "ObjStringParsing.h"
@@ -25,6 +30,117 @@
 using namespace std;
 using namespace ObjLibrary;
 using namespace ObjLibrary::ObjStringParsing;
+namespace
+{
+	//
+	//  POWERS_OF_TEN
+	//
+	//  The powers of ten that can be stored exactly as doubles
+	//    and are used for the fast path of appendDouble.
+	//
+	const unsigned int POWER_OF_TEN_COUNT = 16;
+	const double POWERS_OF_TEN[POWER_OF_TEN_COUNT] =
+	{
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+		1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+	};
+
+	//
+	//  EXACT_INTEGER_MAX
+	//
+	//  The largest integer below which every integer can be
+	//    stored exactly in a double (2^53).
+	//
+	const double EXACT_INTEGER_MAX = 9007199254740992.0;
+
+	//
+	//  appendDigits
+	//
+	//  Purpose: To append the decimal digits of an integer to a
+	//           string, with a decimal point before the last
+	//           few digits.
+	//  Parameter(s):
+	//    <1> r_str: The string to append to
+	//    <2> value: The integer
+	//    <3> decimals: The number of digits to put after the
+	//                  decimal point
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: value / 10^decimals is appended to r_str.
+	//               If decimals is 0, no decimal point is
+	//               written.  Otherwise, at least one digit is
+	//               written before the decimal point.
+	//
+	void appendDigits (string& r_str,
+	                   unsigned long long value,
+	                   unsigned int decimals)
+	{
+		char a_buffer[32];
+		unsigned int length = 0;
+		do
+		{
+			a_buffer[length] = (char)('0' + value % 10);
+			length++;
+			value /= 10;
+		}
+		while(value != 0);
+		while(length <= decimals)
+		{
+			a_buffer[length] = '0';
+			length++;
+		}
+
+		for(unsigned int i = length; i > 0; i--)
+		{
+			if(i == decimals)
+				r_str += '.';
+			r_str += a_buffer[i - 1];
+		}
+	}
+
+
+	//
+	//  NUMBER_BUFFER_SIZE
+	//
+	//  The size of the buffer a number token is copied into so
+	//    it can be null-terminated.  Longer tokens are cut off,
+	//    which only drops digits that could not change the
+	//    value of a double.
+	//
+	const unsigned int NUMBER_BUFFER_SIZE = 64;
+
+	//
+	//  copyNumberToken
+	//
+	//  Purpose: To copy a number token to a null-terminated
+	//           buffer.
+	//  Parameter(s):
+	//    <1> p_token: A pointer to the start of the token
+	//    <2> p_token_end: A pointer to just past the end of the
+	//                     token
+	//    <3> a_buffer: The buffer to copy to
+	//  Precondition(s):
+	//    <1> p_token <= p_token_end
+	//    <2> a_buffer contains NUMBER_BUFFER_SIZE characters
+	//  Returns: N/A
+	//  Side Effect: The token, or as much of it as fits, is
+	//               copied into a_buffer and null-terminated.
+	//
+	void copyNumberToken (const char* p_token,
+	                      const char* p_token_end,
+	                      char* a_buffer)
+	{
+		assert(p_token <= p_token_end);
+		assert(a_buffer != NULL);
+
+		size_t length = p_token_end - p_token;
+		if(length >= NUMBER_BUFFER_SIZE)
+			length = NUMBER_BUFFER_SIZE - 1;
+		memcpy(a_buffer, p_token, length);
+		a_buffer[length] = '\0';
+	}
+
+}  // end of anonymous namespace
 
 
 
@@ -181,3 +297,130 @@ bool ObjStringParsing :: isValidPath (const std::string& path)
 		return true;
 	return false;
 }
+
+
+
+void ObjStringParsing :: appendUnsigned (std::string& r_str, unsigned int value)
+{
+	appendDigits(r_str, value, 0);
+}
+
+void ObjStringParsing :: appendUnsigned (std::string& r_str, unsigned long long value)
+{
+	appendDigits(r_str, value, 0);
+}
+
+void ObjStringParsing :: appendDouble (std::string& r_str, double value)
+{
+	if(value == 0.0)
+	{
+		r_str += signbit(value) ? "-0" : "0";
+		return;
+	}
+	if(!isfinite(value))
+	{
+		char a_buffer[32];
+		snprintf(a_buffer, sizeof(a_buffer), "%g", value);
+		r_str += a_buffer;
+		return;
+	}
+
+	// fast path: value is exactly the nearest double to some
+	//   integer divided by a power of ten, and both of those
+	//   are exact doubles, so reading the digits back rounds
+	//   to the same value as the division did
+	double magnitude = fabs(value);
+	for(unsigned int d = 0; d < POWER_OF_TEN_COUNT; d++)
+	{
+		double scaled = floor(magnitude * POWERS_OF_TEN[d] + 0.5);
+		if(scaled >= EXACT_INTEGER_MAX)
+			break;
+		if(scaled / POWERS_OF_TEN[d] == magnitude)
+		{
+			if(value < 0.0)
+				r_str += '-';
+			appendDigits(r_str, (unsigned long long)(scaled), d);
+			return;
+		}
+	}
+
+	// slow path: the shortest of 15, 16, or 17 significant
+	//   digits that reads back correctly
+	char a_buffer[32];
+	for(int precision = 15; precision < 17; precision++)
+	{
+		snprintf(a_buffer, sizeof(a_buffer), "%.*g", precision, value);
+		if(strtod(a_buffer, NULL) == value)
+		{
+			r_str += a_buffer;
+			return;
+		}
+	}
+	snprintf(a_buffer, sizeof(a_buffer), "%.17g", value);
+	r_str += a_buffer;
+}
+
+
+
+const char* ObjStringParsing :: skipWhitespace (const char* p_current,
+                                               const char* p_end)
+{
+	assert(p_current != NULL);
+	assert(p_end != NULL);
+	assert(p_current <= p_end);
+
+	while(p_current < p_end && isspace((unsigned char)(*p_current)))
+		p_current++;
+	return p_current;
+}
+
+const char* ObjStringParsing :: skipToken (const char* p_current,
+                                          const char* p_end)
+{
+	assert(p_current != NULL);
+	assert(p_end != NULL);
+	assert(p_current <= p_end);
+
+	while(p_current < p_end && !isspace((unsigned char)(*p_current)))
+		p_current++;
+	return p_current;
+}
+
+bool ObjStringParsing :: isTokenEqual (const char* p_token,
+                                       const char* p_token_end,
+                                       const char* a_str)
+{
+	assert(p_token != NULL);
+	assert(p_token_end != NULL);
+	assert(p_token <= p_token_end);
+	assert(a_str != NULL);
+
+	for(; p_token < p_token_end; p_token++, a_str++)
+		if(*a_str != *p_token)
+			return false;	// includes reaching the end of a_str
+	return *a_str == '\0';
+}
+
+double ObjStringParsing :: parseDouble (const char* p_token,
+                                        const char* p_token_end)
+{
+	assert(p_token != NULL);
+	assert(p_token_end != NULL);
+	assert(p_token <= p_token_end);
+
+	char a_buffer[NUMBER_BUFFER_SIZE];
+	copyNumberToken(p_token, p_token_end, a_buffer);
+	return atof(a_buffer);
+}
+
+int ObjStringParsing :: parseInt (const char* p_token,
+                                  const char* p_token_end)
+{
+	assert(p_token != NULL);
+	assert(p_token_end != NULL);
+	assert(p_token <= p_token_end);
+
+	char a_buffer[NUMBER_BUFFER_SIZE];
+	copyNumberToken(p_token, p_token_end, a_buffer);
+	return atoi(a_buffer);
+}
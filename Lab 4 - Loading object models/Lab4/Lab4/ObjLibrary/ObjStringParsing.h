@@ -198,6 +198,133 @@ bool startsWith (const std::string& str,
 //
 bool isValidPath (const std::string& path);
 
+
+
+//
+//  appendUnsigned
+//
+//  Purpose: To append the decimal form of an unsigned integer
+//           to a string.
+//  Parameter(s):
+//    <1> r_str: The string to append to
+//    <2> value: The value to append
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The digits of value are appended to r_str,
+//               with no leading zeros.
+//
+void appendUnsigned (std::string& r_str, unsigned int value);
+void appendUnsigned (std::string& r_str, unsigned long long value);
+
+//
+//  appendDouble
+//
+//  Purpose: To append the shortest decimal form of a double
+//           that reads back as exactly the same value.
+//  Parameter(s):
+//    <1> r_str: The string to append to
+//    <2> value: The value to append
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: value is appended to r_str with as few
+//               significant digits as possible such that atof
+//               or strtod returns exactly value again.  Values
+//               with 15 or fewer significant digits that are
+//               not too large or small are written without an
+//               exponent, as in "-0.125".  Infinite and NaN
+//               values are written as by printf.
+//
+void appendDouble (std::string& r_str, double value);
+
+
+
+//
+//  skipWhitespace
+//
+//  Purpose: To find the next non-whitespace character in a
+//           range of characters.
+//  Parameter(s):
+//    <1> p_current: A pointer to the first character to check
+//    <2> p_end: A pointer to just past the end of the range
+//  Precondition(s):
+//    <1> p_current != NULL
+//    <2> p_end != NULL
+//    <3> p_current <= p_end
+//  Returns: A pointer to the first character at or after
+//           p_current that is not whitespace.  If there is no
+//           such character, p_end is returned.
+//  Side Effect: N/A
+//
+const char* skipWhitespace (const char* p_current,
+                            const char* p_end);
+
+//
+//  skipToken
+//
+//  Purpose: To find the end of the token starting at the
+//           specified position in a range of characters.
+//  Parameter(s):
+//    <1> p_current: A pointer to the start of the token
+//    <2> p_end: A pointer to just past the end of the range
+//  Precondition(s):
+//    <1> p_current != NULL
+//    <2> p_end != NULL
+//    <3> p_current <= p_end
+//  Returns: A pointer to the first whitespace character at or
+//           after p_current.  If there is no such character,
+//           p_end is returned.
+//  Side Effect: N/A
+//
+const char* skipToken (const char* p_current,
+                       const char* p_end);
+
+//
+//  isTokenEqual
+//
+//  Purpose: To determine if a token in a range of characters
+//           is the specified string.
+//  Parameter(s):
+//    <1> p_token: A pointer to the start of the token
+//    <2> p_token_end: A pointer to just past the end of the
+//                     token
+//    <3> a_str: The string to compare to
+//  Precondition(s):
+//    <1> p_token != NULL
+//    <2> p_token_end != NULL
+//    <3> p_token <= p_token_end
+//    <4> a_str != NULL
+//  Returns: Whether the characters from p_token to p_token_end
+//           are exactly the characters in a_str.
+//  Side Effect: N/A
+//
+bool isTokenEqual (const char* p_token,
+                   const char* p_token_end,
+                   const char* a_str);
+
+//
+//  parseDouble
+//  parseInt
+//
+//  Purpose: To read a number from a token in a range of
+//           characters.  The range does not have to be
+//           null-terminated and no memory is allocated.
+//  Parameter(s):
+//    <1> p_token: A pointer to the start of the token
+//    <2> p_token_end: A pointer to just past the end of the
+//                     token
+//  Precondition(s):
+//    <1> p_token != NULL
+//    <2> p_token_end != NULL
+//    <3> p_token <= p_token_end
+//  Returns: The value read, as by atof or atoi.  If the token
+//           does not start with a number, 0 is returned.
+//  Side Effect: N/A
+//
+double parseDouble (const char* p_token,
+                    const char* p_token_end);
+int parseInt (const char* p_token,
+              const char* p_token_end);
+
 }  // end of namespace ObjStringParsing
 
 
@@ -0,0 +1,620 @@
+//
+//  OcclusionCuller.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include <vector>
+
+#include "Vector3.h"
+#include "Vector3Array.h"
+#include "Matrix44.h"
+#include "SimdKernels.h"
+#include "ObjModel.h"
+#include "JobSystem.h"
+#include "OcclusionCuller.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  MIN_ROWS_PER_THREAD
+	//
+	//  The smallest number of depth buffer rows worth giving to
+	//    another thread.
+	//
+	const unsigned int MIN_ROWS_PER_THREAD = 16;
+
+	//
+	//  MIN_BOXES_PER_THREAD
+	//
+	//  The smallest number of bounding boxes worth giving to
+	//    another thread.
+	//
+	const unsigned int MIN_BOXES_PER_THREAD = 256;
+
+	//
+	//  BOX_TRIANGLE_INDEXES
+	//
+	//  The corners of the 12 triangles of a box.  Corner c is at
+	//    the maximum X if (c & 1), the maximum Y if (c & 2), and
+	//    the maximum Z if (c & 4).
+	//
+	const unsigned int BOX_TRIANGLE_INDEXES[36] =
+	{
+		0, 2, 6,   0, 6, 4,  // -X
+		1, 5, 7,   1, 7, 3,  // +X
+		0, 4, 5,   0, 5, 1,  // -Y
+		2, 3, 7,   2, 7, 6,  // +Y
+		0, 1, 3,   0, 3, 2,  // -Z
+		4, 6, 7,   4, 7, 5,  // +Z
+	};
+
+	//
+	//  setBoxCorners
+	//
+	//  Purpose: To write the 8 corners of an axis-aligned box
+	//           into a Vector3Array.
+	//  Parameter(s):
+	//    <1> min_x
+	//    <2> min_y
+	//    <3> min_z
+	//    <4> max_x
+	//    <5> max_y
+	//    <6> max_z: The corners of the box
+	//    <7> r_corners: The Vector3Array to write to
+	//    <8> first: The index of the first corner to write
+	//  Precondition(s):
+	//    <1> first + 8 <= r_corners.getSize()
+	//  Returns: N/A
+	//  Side Effect: Elements first to first + 8 of r_corners are
+	//               set to the corners of the box, in the order
+	//               used by BOX_TRIANGLE_INDEXES.
+	//
+	void setBoxCorners (float min_x, float min_y, float min_z,
+	                    float max_x, float max_y, float max_z,
+	                    Vector3Array<float>& r_corners,
+	                    unsigned int first)
+	{
+		assert(first + 8 <= r_corners.getSize());
+
+		float* a_x = r_corners.getArrayX() + first;
+		float* a_y = r_corners.getArrayY() + first;
+		float* a_z = r_corners.getArrayZ() + first;
+		for(unsigned int c = 0; c < 8; c++)
+		{
+			a_x[c] = (c & 1) ? max_x : min_x;
+			a_y[c] = (c & 2) ? max_y : min_y;
+			a_z[c] = (c & 4) ? max_z : min_z;
+		}
+	}
+
+}  // end of anonymous namespace
+
+
+
+OcclusionCuller :: OcclusionCuller ()
+		: m_thread_count(JobSystem::getShared().getWorkerCount() + 1),
+		  m_view_projection(),
+		  m_is_rasterized(false),
+		  mv_triangles(),
+		  mvv_levels(),
+		  mv_level_widths(),
+		  mv_level_heights(),
+		  m_tested_count(0),
+		  m_occluded_count(0),
+		  m_outside_count(0)
+{
+	unsigned int width  = DEFAULT_WIDTH;
+	unsigned int height = DEFAULT_HEIGHT;
+	for(;;)
+	{
+		mv_level_widths.push_back(width);
+		mv_level_heights.push_back(height);
+		mvv_levels.push_back(vector<float>(width * height, 1.0f));
+		if(width == 1 && height == 1)
+			break;
+		width  = (width  + 1) / 2;
+		height = (height + 1) / 2;
+	}
+
+	assert(invariant());
+}
+
+OcclusionCuller :: OcclusionCuller (unsigned int width,
+                                    unsigned int height)
+		: m_thread_count(JobSystem::getShared().getWorkerCount() + 1),
+		  m_view_projection(),
+		  m_is_rasterized(false),
+		  mv_triangles(),
+		  mvv_levels(),
+		  mv_level_widths(),
+		  mv_level_heights(),
+		  m_tested_count(0),
+		  m_occluded_count(0),
+		  m_outside_count(0)
+{
+	assert(width >= 1);
+	assert(height >= 1);
+
+	for(;;)
+	{
+		mv_level_widths.push_back(width);
+		mv_level_heights.push_back(height);
+		mvv_levels.push_back(vector<float>(width * height, 1.0f));
+		if(width == 1 && height == 1)
+			break;
+		width  = (width  + 1) / 2;
+		height = (height + 1) / 2;
+	}
+
+	assert(invariant());
+}
+
+
+
+float OcclusionCuller :: getDepth (unsigned int level,
+                                   unsigned int x,
+                                   unsigned int y) const
+{
+	assert(level < getLevelCount());
+	assert(x < getLevelWidth(level));
+	assert(y < getLevelHeight(level));
+
+	return mvv_levels[level][y * mv_level_widths[level] + x];
+}
+
+bool OcclusionCuller :: isVisible (const Vector3& box_min,
+                                   const Vector3& box_max) const
+{
+	assert(isRasterized());
+	assert(box_min.x <= box_max.x);
+	assert(box_min.y <= box_max.y);
+	assert(box_min.z <= box_max.z);
+
+	Vector3Array<float> corners(8);
+	setBoxCorners((float)(box_min.x), (float)(box_min.y), (float)(box_min.z),
+	              (float)(box_max.x), (float)(box_max.y), (float)(box_max.z),
+	              corners, 0);
+	vector<float> v_corner_w;
+	m_view_projection.projectPoints(corners, corners, v_corner_w);
+
+	BoxResult result = testProjectedBox(corners, v_corner_w.data(), 0);
+	addStatistics(1, (result == BOX_OCCLUDED) ? 1 : 0,
+	                 (result == BOX_OUTSIDE)  ? 1 : 0);
+	return result == BOX_VISIBLE;
+}
+
+void OcclusionCuller :: testBoxes (const Vector3Array<float>& box_mins,
+                                   const Vector3Array<float>& box_maxes,
+                                   vector<unsigned char>& rv_visible) const
+{
+	assert(isRasterized());
+	assert(box_mins.getSize() == box_maxes.getSize());
+
+	unsigned int box_count = box_mins.getSize();
+	const float* a_min_x = box_mins.getArrayX();
+	const float* a_min_y = box_mins.getArrayY();
+	const float* a_min_z = box_mins.getArrayZ();
+	const float* a_max_x = box_maxes.getArrayX();
+	const float* a_max_y = box_maxes.getArrayY();
+	const float* a_max_z = box_maxes.getArrayZ();
+
+	Vector3Array<float> corners(box_count * 8);
+	for(unsigned int b = 0; b < box_count; b++)
+	{
+		setBoxCorners(a_min_x[b], a_min_y[b], a_min_z[b],
+		              a_max_x[b], a_max_y[b], a_max_z[b],
+		              corners, b * 8);
+	}
+	vector<float> v_corner_w;
+	m_view_projection.projectPoints(corners, corners, v_corner_w);
+
+	rv_visible.resize(box_count);
+	const float* a_corner_w = v_corner_w.data();
+	unsigned char* a_visible = rv_visible.data();
+	JobSystem::getShared().parallelFor(box_count, MIN_BOXES_PER_THREAD, m_thread_count,
+		[this, &corners, a_corner_w, a_visible] (unsigned int begin, unsigned int end)
+		{
+			unsigned int occluded = 0;
+			unsigned int outside  = 0;
+			for(unsigned int b = begin; b < end; b++)
+			{
+				BoxResult result = testProjectedBox(corners, a_corner_w, b * 8);
+				a_visible[b] = (result == BOX_VISIBLE) ? 1 : 0;
+				if(result == BOX_OCCLUDED)
+					occluded++;
+				else if(result == BOX_OUTSIDE)
+					outside++;
+			}
+			addStatistics(end - begin, occluded, outside);
+		});
+}
+
+
+
+void OcclusionCuller :: setThreadCount (unsigned int count)
+{
+	assert(count >= 1);
+
+	m_thread_count = count;
+}
+
+void OcclusionCuller :: beginFrame (const Matrix44& view_projection)
+{
+	m_view_projection = view_projection;
+	mv_triangles.clear();
+	for(unsigned int i = 0; i < mvv_levels.size(); i++)
+		fill(mvv_levels[i].begin(), mvv_levels[i].end(), 1.0f);
+	m_is_rasterized = false;
+	resetStatistics();
+
+	assert(invariant());
+}
+
+void OcclusionCuller :: addOccluder (const ObjModel& occluder,
+                                     const Matrix44& transform)
+{
+	assert(occluder.isValid());
+	assert(occluder.getVertexCount() <= UINT_MAX);
+
+	unsigned int vertex_count = (unsigned int)(occluder.getVertexCount());
+	Vector3Array<float> points(vertex_count);
+	for(unsigned int v = 0; v < vertex_count; v++)
+		points.set(v, occluder.getVertexPosition(v));
+	vector<float> v_clip_w;
+	(m_view_projection * transform).projectPoints(points, points, v_clip_w);
+
+	// split each face into a fan of triangles
+	vector<unsigned int> v_indexes;
+	for(unsigned int m = 0; m < occluder.getMeshCount(); m++)
+	{
+		unsigned int face_count = occluder.getFaceCount(m);
+		for(unsigned int f = 0; f < face_count; f++)
+		{
+			unsigned int face_vertex_count = occluder.getFaceVertexCount(m, f);
+			unsigned int first = (unsigned int)(occluder.getFaceVertexIndex(m, f, 0));
+			for(unsigned int v = 2; v < face_vertex_count; v++)
+			{
+				v_indexes.push_back(first);
+				v_indexes.push_back((unsigned int)(occluder.getFaceVertexIndex(m, f, v - 1)));
+				v_indexes.push_back((unsigned int)(occluder.getFaceVertexIndex(m, f, v)));
+			}
+		}
+	}
+
+	addTriangles(points, v_clip_w, v_indexes);
+	m_is_rasterized = false;
+
+	assert(invariant());
+}
+
+void OcclusionCuller :: addOccluderBox (const Vector3& box_min,
+                                        const Vector3& box_max)
+{
+	assert(box_min.x <= box_max.x);
+	assert(box_min.y <= box_max.y);
+	assert(box_min.z <= box_max.z);
+
+	Vector3Array<float> corners(8);
+	setBoxCorners((float)(box_min.x), (float)(box_min.y), (float)(box_min.z),
+	              (float)(box_max.x), (float)(box_max.y), (float)(box_max.z),
+	              corners, 0);
+	vector<float> v_clip_w;
+	m_view_projection.projectPoints(corners, corners, v_clip_w);
+
+	vector<unsigned int> v_indexes(BOX_TRIANGLE_INDEXES,
+	                               BOX_TRIANGLE_INDEXES + 36);
+	addTriangles(corners, v_clip_w, v_indexes);
+	m_is_rasterized = false;
+
+	assert(invariant());
+}
+
+void OcclusionCuller :: rasterize ()
+{
+	fill(mvv_levels[0].begin(), mvv_levels[0].end(), 1.0f);
+
+	JobSystem& r_jobs = JobSystem::getShared();
+	r_jobs.parallelFor(getHeight(), MIN_ROWS_PER_THREAD, m_thread_count,
+	                   [this] (unsigned int begin, unsigned int end)
+	                   { rasterizeRows(begin, end); });
+	for(unsigned int level = 1; level < getLevelCount(); level++)
+	{
+		r_jobs.parallelFor(mv_level_heights[level], MIN_ROWS_PER_THREAD, m_thread_count,
+		                   [this, level] (unsigned int begin, unsigned int end)
+		                   { buildLevelRows(level, begin, end); });
+	}
+	m_is_rasterized = true;
+
+	assert(invariant());
+}
+
+void OcclusionCuller :: resetStatistics ()
+{
+	m_tested_count   = 0;
+	m_occluded_count = 0;
+	m_outside_count  = 0;
+}
+
+
+
+void OcclusionCuller :: addTriangles (const Vector3Array<float>& clip_points,
+                                      const vector<float>& v_clip_w,
+                                      const vector<unsigned int>& v_indexes)
+{
+	assert(clip_points.getSize() == v_clip_w.size());
+	assert(v_indexes.size() % 3 == 0);
+
+	const float* a_x = clip_points.getArrayX();
+	const float* a_y = clip_points.getArrayY();
+	const float* a_z = clip_points.getArrayZ();
+	float width  = (float)(getWidth());
+	float height = (float)(getHeight());
+
+	for(unsigned int t = 0; t < v_indexes.size(); t += 3)
+	{
+		float a_window[TRIANGLE_FLOAT_COUNT];
+		bool is_in_front = true;
+		for(unsigned int k = 0; k < 3; k++)
+		{
+			unsigned int index = v_indexes[t + k];
+			assert(index < clip_points.getSize());
+
+			// GPU clipping would cut away anything in front of
+			//   the near plane, so it cannot hide anything
+			float w = v_clip_w[index];
+			if(w <= 0.0f || a_z[index] < -w)
+			{
+				is_in_front = false;
+				break;
+			}
+
+			float inverse_w = 1.0f / w;
+			a_window[k * 3 + 0] = (a_x[index] * inverse_w * 0.5f + 0.5f) * width;
+			a_window[k * 3 + 1] = (a_y[index] * inverse_w * 0.5f + 0.5f) * height;
+			a_window[k * 3 + 2] =  a_z[index] * inverse_w * 0.5f + 0.5f;
+		}
+		if(!is_in_front)
+			continue;
+
+		float area = (a_window[3] - a_window[0]) * (a_window[7] - a_window[1]) -
+		             (a_window[6] - a_window[0]) * (a_window[4] - a_window[1]);
+		if(area == 0.0f)
+			continue;
+
+		mv_triangles.insert(mv_triangles.end(), a_window,
+		                    a_window + TRIANGLE_FLOAT_COUNT);
+	}
+}
+
+void OcclusionCuller :: rasterizeRows (unsigned int begin,
+                                       unsigned int end)
+{
+	assert(begin <= end);
+	assert(end <= getHeight());
+
+	const SimdKernels::Table<float>& kernels = SimdKernels::getTable<float>();
+	unsigned int width = getWidth();
+	float* a_depth = mvv_levels[0].data();
+
+	for(unsigned int t = 0; t < mv_triangles.size(); t += TRIANGLE_FLOAT_COUNT)
+	{
+		const float* a_window = mv_triangles.data() + t;
+		double x0 = a_window[0];
+		double y0 = a_window[1];
+		double z0 = a_window[2];
+		double x1 = a_window[3];
+		double y1 = a_window[4];
+		double z1 = a_window[5];
+		double x2 = a_window[6];
+		double y2 = a_window[7];
+		double z2 = a_window[8];
+
+		// only texel centres inside the triangle are drawn
+		double min_row = ceil (min(min(y0, y1), y2) - 0.5);
+		double max_row = floor(max(max(y0, y1), y2) - 0.5);
+		min_row = max(min_row, (double)(begin));
+		max_row = min(max_row, (double)(end) - 1.0);
+		if(min_row > max_row)
+			continue;
+		double min_column = ceil (min(min(x0, x1), x2) - 0.5);
+		double max_column = floor(max(max(x0, x1), x2) - 0.5);
+		min_column = max(min_column, 0.0);
+		max_column = min(max_column, (double)(width) - 1.0);
+		if(min_column > max_column)
+			continue;
+
+		// edge functions, positive inside the triangle
+		double area = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+		if(area == 0.0)
+			continue;
+		double sign = (area > 0.0) ? 1.0 : -1.0;
+		double a_edge_a[3] = { sign * (y0 - y1), sign * (y1 - y2), sign * (y2 - y0) };
+		double a_edge_b[3] = { sign * (x1 - x0), sign * (x2 - x1), sign * (x0 - x2) };
+		double a_edge_c[3] = { sign * (x0 * y1 - x1 * y0),
+		                       sign * (x1 * y2 - x2 * y1),
+		                       sign * (x2 * y0 - x0 * y2) };
+
+		// top-left fill rule: a texel centre exactly on an edge
+		//  belongs to the triangle for which it is a left edge
+		//  (or a top edge, if horizontal), so a texel on an edge
+		//  shared by two triangles is drawn exactly once
+		float a_edge_bias[3];
+		for(unsigned int k = 0; k < 3; k++)
+		{
+			bool is_top_left = a_edge_a[k] > 0.0 || (a_edge_a[k] == 0.0 && a_edge_b[k] > 0.0);
+			a_edge_bias[k] = is_top_left ? FLT_MIN : 0.0f;
+		}
+
+		// depth is linear in window coordinates
+		double dzdx = ((z1 - z0) * (y2 - y0) - (z2 - z0) * (y1 - y0)) / area;
+		double dzdy = ((x1 - x0) * (z2 - z0) - (x2 - x0) * (z1 - z0)) / area;
+
+		unsigned int first_column = (unsigned int)(min_column);
+		unsigned int column_count = (unsigned int)(max_column) - first_column + 1;
+		double centre_x = min_column + 0.5;
+		for(unsigned int row = (unsigned int)(min_row); row <= (unsigned int)(max_row); row++)
+		{
+			double centre_y = row + 0.5;
+			float a_plane[11];
+			for(unsigned int k = 0; k < 3; k++)
+			{
+				a_plane[k]     = (float)(a_edge_a[k] * centre_x + a_edge_b[k] * centre_y + a_edge_c[k]);
+				a_plane[k + 3] = (float)(a_edge_a[k]);
+				a_plane[k + 8] = a_edge_bias[k];
+			}
+			a_plane[6] = (float)(z0 + dzdx * (centre_x - x0) + dzdy * (centre_y - y0));
+			a_plane[7] = (float)(dzdx);
+			kernels.rasterizeRow(column_count, a_plane,
+			                     a_depth + row * width + first_column);
+		}
+	}
+}
+
+void OcclusionCuller :: buildLevelRows (unsigned int level,
+                                        unsigned int begin,
+                                        unsigned int end)
+{
+	assert(level >= 1);
+	assert(level < getLevelCount());
+	assert(begin <= end);
+	assert(end <= getLevelHeight(level));
+
+	const vector<float>& v_below = mvv_levels[level - 1];
+	unsigned int below_width  = mv_level_widths [level - 1];
+	unsigned int below_height = mv_level_heights[level - 1];
+	vector<float>& rv_level = mvv_levels[level];
+	unsigned int width = mv_level_widths[level];
+
+	for(unsigned int y = begin; y < end; y++)
+	{
+		const float* a_row0 = v_below.data() + (y * 2) * below_width;
+		const float* a_row1 = v_below.data() + min(y * 2 + 1, below_height - 1) * below_width;
+		float* a_result = rv_level.data() + y * width;
+		for(unsigned int x = 0; x < width; x++)
+		{
+			unsigned int x0 = x * 2;
+			unsigned int x1 = min(x0 + 1, below_width - 1);
+			a_result[x] = max(max(a_row0[x0], a_row0[x1]),
+			                  max(a_row1[x0], a_row1[x1]));
+		}
+	}
+}
+
+OcclusionCuller::BoxResult OcclusionCuller :: testProjectedBox (
+                                     const Vector3Array<float>& corners,
+                                     const float* a_corner_w,
+                                     unsigned int first) const
+{
+	assert(isRasterized());
+	assert(a_corner_w != NULL);
+	assert(first + 8 <= corners.getSize());
+
+	const float* a_x = corners.getArrayX() + first;
+	const float* a_y = corners.getArrayY() + first;
+	const float* a_z = corners.getArrayZ() + first;
+	const float* a_w = a_corner_w + first;
+	float width  = (float)(getWidth());
+	float height = (float)(getHeight());
+
+	float min_x =  FLT_MAX;
+	float max_x = -FLT_MAX;
+	float min_y =  FLT_MAX;
+	float max_y = -FLT_MAX;
+	float min_z =  FLT_MAX;
+	for(unsigned int c = 0; c < 8; c++)
+	{
+		// boxes crossing the near plane are never hidden
+		if(a_w[c] <= 0.0f || a_z[c] < -a_w[c])
+			return BOX_VISIBLE;
+
+		float inverse_w = 1.0f / a_w[c];
+		float x = (a_x[c] * inverse_w * 0.5f + 0.5f) * width;
+		float y = (a_y[c] * inverse_w * 0.5f + 0.5f) * height;
+		float z =  a_z[c] * inverse_w * 0.5f + 0.5f;
+		min_x = min(min_x, x);
+		max_x = max(max_x, x);
+		min_y = min(min_y, y);
+		max_y = max(max_y, y);
+		min_z = min(min_z, z);
+	}
+
+	if(max_x <= 0.0f || min_x >= width ||
+	   max_y <= 0.0f || min_y >= height ||
+	   min_z > 1.0f)
+	{
+		return BOX_OUTSIDE;
+	}
+
+	unsigned int x0 = (unsigned int)(max(min_x, 0.0f));
+	unsigned int y0 = (unsigned int)(max(min_y, 0.0f));
+	unsigned int x1 = (unsigned int)(min(max_x, width  - 1.0f));
+	unsigned int y1 = (unsigned int)(min(max_y, height - 1.0f));
+
+	// choose the level where the box covers at most 2 x 2 texels
+	unsigned int level = 0;
+	while(level + 1 < getLevelCount() &&
+	      ((x1 >> level) - (x0 >> level) >= 2 ||
+	       (y1 >> level) - (y0 >> level) >= 2))
+	{
+		level++;
+	}
+
+	const vector<float>& v_level = mvv_levels[level];
+	unsigned int level_width = mv_level_widths[level];
+	float farthest = 0.0f;
+	for(unsigned int y = (y0 >> level); y <= (y1 >> level); y++)
+		for(unsigned int x = (x0 >> level); x <= (x1 >> level); x++)
+			farthest = max(farthest, v_level[y * level_width + x]);
+
+	if(min_z > farthest)
+		return BOX_OCCLUDED;
+	else
+		return BOX_VISIBLE;
+}
+
+void OcclusionCuller :: addStatistics (unsigned int tested,
+                                       unsigned int occluded,
+                                       unsigned int outside) const
+{
+	m_tested_count   += tested;
+	m_occluded_count += occluded;
+	m_outside_count  += outside;
+}
+
+bool OcclusionCuller :: invariant () const
+{
+	if(m_thread_count < 1) return false;
+	if(mv_triangles.size() % TRIANGLE_FLOAT_COUNT != 0) return false;
+	if(mvv_levels.empty()) return false;
+	if(mv_level_widths.size() != mvv_levels.size()) return false;
+	if(mv_level_heights.size() != mvv_levels.size()) return false;
+	for(unsigned int i = 0; i < mvv_levels.size(); i++)
+	{
+		if(mvv_levels[i].size() != mv_level_widths[i] * mv_level_heights[i])
+			return false;
+	}
+	if(mv_level_widths.back() != 1) return false;
+	if(mv_level_heights.back() != 1) return false;
+	return true;
+}
@@ -0,0 +1,588 @@
+//
+//  OcclusionCuller.h
+//
+//  A module to find models that are hidden behind other
+//    models, using a small depth buffer drawn on the CPU.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_OCCLUSION_CULLER_H
+#define OBJ_LIBRARY_OCCLUSION_CULLER_H
+
+#include <cassert>
+#include <atomic>
+#include <vector>
+
+#include "Vector3.h"
+#include "Vector3Array.h"
+#include "Matrix44.h"
+
+
+
+namespace ObjLibrary
+{
+
+class ObjModel;
+
+
+
+//
+//  OcclusionCuller
+//
+//  A class to determine which axis-aligned bounding boxes are
+//    hidden behind occluders.  An occluder is a simple
+//    stand-in for a large model, such as a few boxes for the
+//    walls of a building.  Each frame, the occluders are drawn
+//    into a small depth buffer on the CPU.  A hierarchical
+//    depth buffer (Hi-Z pyramid) is then built from it.  Each
+//    level of the pyramid is half the size of the level below
+//    and stores the farthest depth of the texels it covers.  A
+//    bounding box is hidden if its nearest point is farther
+//    than the farthest occluder depth over the whole area it
+//    covers on the screen, which takes at most 4 reads from the
+//    right level of the pyramid.
+//
+//  The test is conservative: a bounding box is only reported
+//    as hidden if it is hidden behind the occluders at the
+//    resolution of the depth buffer.  Occluders should therefore be no larger than the models
+//    they stand in for.  Occluder triangles that cross the near
+//    plane are not drawn, and bounding boxes that cross it are
+//    always reported as visible.  Bounding boxes that are
+//    completely outside the view are reported as hidden.
+//
+//  Occluders are drawn in horizontal bands, each on a worker
+//    of the shared JobSystem, with each row of a triangle drawn
+//    by the rasterizeRow kernel from SimdKernels.h.  The
+//    top-left fill rule is used, so a texel centre on an edge
+//    shared by two triangles is drawn by exactly one of them
+//    and closed meshes leave no gaps.  Bounding boxes are
+//    tested in parallel in the same way, with their corners
+//    projected by Matrix44::projectPoints.
+//
+//  Depths are window depths, from 0.0 at the near plane to 1.0
+//    at the far plane, as in the OpenGL depth buffer.  Row 0 is
+//    the bottom of the screen.  Typical use for each frame is:
+//
+//      culler.beginFrame(projection * view);
+//      culler.addOccluder(...);  // for each occluder
+//      culler.rasterize();
+//      culler.isVisible(...);    // or testBoxes
+//
+class OcclusionCuller
+{
+public:
+//
+//  DEFAULT_WIDTH
+//  DEFAULT_HEIGHT
+//
+//  The size of the depth buffer for the default constructor.
+//    A quarter of the screen size or less is normally enough.
+//
+	static const unsigned int DEFAULT_WIDTH  = 256;
+	static const unsigned int DEFAULT_HEIGHT = 128;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new OcclusionCuller with the default
+//           depth buffer size.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new OcclusionCuller is created with a depth
+//               buffer of DEFAULT_WIDTH x DEFAULT_HEIGHT.  The
+//               view-projection matrix is the identity matrix
+//               and there are no occluders.
+//
+	OcclusionCuller ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a new OcclusionCuller with the specified
+//           depth buffer size.
+//  Parameter(s):
+//    <1> width
+//    <2> height: The size of the depth buffer in texels
+//  Precondition(s):
+//    <1> width >= 1
+//    <2> height >= 1
+//  Returns: N/A
+//  Side Effect: A new OcclusionCuller is created with a depth
+//               buffer of width x height.  The view-projection
+//               matrix is the identity matrix and there are no
+//               occluders.
+//
+	OcclusionCuller (unsigned int width, unsigned int height);
+
+//
+//  getWidth
+//  getHeight
+//
+//  Purpose: To determine the size of the depth buffer.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The width or height of level 0 of the depth buffer
+//           in texels.
+//  Side Effect: N/A
+//
+	unsigned int getWidth () const
+	{ return mv_level_widths[0]; }
+	unsigned int getHeight () const
+	{ return mv_level_heights[0]; }
+
+//
+//  getLevelCount
+//
+//  Purpose: To determine the number of levels in the Hi-Z
+//           pyramid.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of levels, including level 0.  The last
+//           level is 1 x 1.
+//  Side Effect: N/A
+//
+	unsigned int getLevelCount () const
+	{ return (unsigned int)(mvv_levels.size()); }
+
+//
+//  getLevelWidth
+//  getLevelHeight
+//
+//  Purpose: To determine the size of a level of the Hi-Z
+//           pyramid.
+//  Parameter(s):
+//    <1> level: Which level
+//  Precondition(s):
+//    <1> level < getLevelCount()
+//  Returns: The width or height of level level in texels.
+//  Side Effect: N/A
+//
+	unsigned int getLevelWidth (unsigned int level) const
+	{
+		assert(level < getLevelCount());
+		return mv_level_widths[level];
+	}
+	unsigned int getLevelHeight (unsigned int level) const
+	{
+		assert(level < getLevelCount());
+		return mv_level_heights[level];
+	}
+
+//
+//  getDepth
+//
+//  Purpose: To determine the depth stored at a texel of the
+//           Hi-Z pyramid.
+//  Parameter(s):
+//    <1> level: Which level
+//    <2> x
+//    <3> y: The texel in level level
+//  Precondition(s):
+//    <1> level < getLevelCount()
+//    <2> x < getLevelWidth(level)
+//    <3> y < getLevelHeight(level)
+//  Returns: The farthest occluder depth in the area covered by
+//           the texel.  If rasterize has not been called since
+//           beginFrame, 1.0 is returned.
+//  Side Effect: N/A
+//
+	float getDepth (unsigned int level,
+	                unsigned int x, unsigned int y) const;
+
+//
+//  getViewProjection
+//
+//  Purpose: To retrieve the view-projection matrix for the
+//           current frame.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The matrix passed to beginFrame.
+//  Side Effect: N/A
+//
+	const Matrix44& getViewProjection () const
+	{ return m_view_projection; }
+
+//
+//  getOccluderTriangleCount
+//
+//  Purpose: To determine how many occluder triangles will be
+//           drawn into the depth buffer.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of triangles added since beginFrame,
+//           not counting those that were discarded because
+//           they cross the near plane or are seen edge-on.
+//  Side Effect: N/A
+//
+	unsigned int getOccluderTriangleCount () const
+	{ return (unsigned int)(mv_triangles.size() / TRIANGLE_FLOAT_COUNT); }
+
+//
+//  isRasterized
+//
+//  Purpose: To determine if the Hi-Z pyramid is up to date.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether rasterize has been called since the last
+//           call to beginFrame, addOccluder, or
+//           addOccluderBox.
+//  Side Effect: N/A
+//
+	bool isRasterized () const
+	{ return m_is_rasterized; }
+
+//
+//  getTestedCount
+//  getOccludedCount
+//  getOutsideCount
+//
+//  Purpose: To determine how many bounding boxes have been
+//           tested since beginFrame or resetStatistics was last
+//           called, how many of them were hidden behind
+//           occluders, and how many were outside the view.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of bounding boxes.  Boxes outside the
+//           view are not counted as occluded.
+//  Side Effect: N/A
+//
+	unsigned int getTestedCount () const
+	{ return m_tested_count; }
+	unsigned int getOccludedCount () const
+	{ return m_occluded_count; }
+	unsigned int getOutsideCount () const
+	{ return m_outside_count; }
+
+//
+//  getThreadCount
+//
+//  Purpose: To determine the maximum number of threads used by
+//           this OcclusionCuller.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The maximum number of threads.
+//  Side Effect: N/A
+//
+	unsigned int getThreadCount () const
+	{ return m_thread_count; }
+
+//
+//  isVisible
+//
+//  Purpose: To determine if an axis-aligned bounding box may
+//           be visible.
+//  Parameter(s):
+//    <1> box_min
+//    <2> box_max: The corners of the bounding box in world
+//                 coordinates
+//  Precondition(s):
+//    <1> isRasterized()
+//    <2> box_min.x <= box_max.x
+//    <3> box_min.y <= box_max.y
+//    <4> box_min.z <= box_max.z
+//  Returns: Whether the bounding box may be visible.  If false
+//           is returned, the bounding box is certainly hidden
+//           or outside the view.
+//  Side Effect: The statistics are updated.
+//
+	bool isVisible (const Vector3& box_min,
+	                const Vector3& box_max) const;
+
+//
+//  testBoxes
+//
+//  Purpose: To determine which of many axis-aligned bounding
+//           boxes may be visible.
+//  Parameter(s):
+//    <1> box_mins
+//    <2> box_maxes: The corners of the bounding boxes in world
+//                   coordinates
+//    <3> rv_visible: A vector to fill with the results
+//  Precondition(s):
+//    <1> isRasterized()
+//    <2> box_mins.getSize() == box_maxes.getSize()
+//  Returns: N/A
+//  Side Effect: rv_visible is resized to box_mins.getSize().
+//               Each element is set to 1 if the corresponding
+//               bounding box may be visible and to 0 if it is
+//               certainly hidden or outside the view.  The
+//               statistics are updated.
+//
+	void testBoxes (const Vector3Array<float>& box_mins,
+	                const Vector3Array<float>& box_maxes,
+	                std::vector<unsigned char>& rv_visible) const;
+
+//
+//  setThreadCount
+//
+//  Purpose: To change the maximum number of threads used by
+//           this OcclusionCuller.
+//  Parameter(s):
+//    <1> count: The maximum number of threads
+//  Precondition(s):
+//    <1> count >= 1
+//  Returns: N/A
+//  Side Effect: rasterize and testBoxes will use at most count
+//               threads, including the calling thread.  The
+//               default is one more than the number of workers
+//               in the shared JobSystem.
+//
+	void setThreadCount (unsigned int count);
+
+//
+//  beginFrame
+//
+//  Purpose: To start a new frame.
+//  Parameter(s):
+//    <1> view_projection: The view-projection matrix for the
+//                         new frame
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All occluders are removed, the depth buffer is
+//               cleared to 1.0, and the statistics are reset.
+//               Occluders and bounding boxes will be projected
+//               with view_projection.
+//
+	void beginFrame (const Matrix44& view_projection);
+
+//
+//  addOccluder
+//
+//  Purpose: To add the faces of an ObjModel as an occluder.
+//  Parameter(s):
+//    <1> occluder: The ObjModel to add
+//    <2> transform: The model matrix for occluder
+//  Precondition(s):
+//    <1> occluder.isValid()
+//    <2> occluder.getVertexCount() <= UINT_MAX
+//  Returns: N/A
+//  Side Effect: Each face of occluder is split into triangles,
+//               projected, and added to the occluders for this
+//               frame.  Point sets and polylines are ignored.
+//               The Hi-Z pyramid is out of date until rasterize
+//               is called.
+//
+	void addOccluder (const ObjModel& occluder,
+	                  const Matrix44& transform);
+
+//
+//  addOccluderBox
+//
+//  Purpose: To add an axis-aligned box as an occluder.
+//  Parameter(s):
+//    <1> box_min
+//    <2> box_max: The corners of the box in world coordinates
+//  Precondition(s):
+//    <1> box_min.x <= box_max.x
+//    <2> box_min.y <= box_max.y
+//    <3> box_min.z <= box_max.z
+//  Returns: N/A
+//  Side Effect: The 12 triangles of the box are projected and
+//               added to the occluders for this frame.  The
+//               Hi-Z pyramid is out of date until rasterize is
+//               called.
+//
+	void addOccluderBox (const Vector3& box_min,
+	                     const Vector3& box_max);
+
+//
+//  rasterize
+//
+//  Purpose: To draw the occluders into the depth buffer and
+//           build the Hi-Z pyramid.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The depth buffer is cleared to 1.0 and all
+//               occluders added since beginFrame are drawn into
+//               it.  The other levels of the Hi-Z pyramid are
+//               then recalculated.
+//
+	void rasterize ();
+
+//
+//  resetStatistics
+//
+//  Purpose: To reset the bounding box statistics.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The tested, occluded, and outside counts are
+//               set to 0.
+//
+	void resetStatistics ();
+
+private:
+	// x, y, z window coordinates for 3 vertexes
+	static const unsigned int TRIANGLE_FLOAT_COUNT = 9;
+
+	// result of testing one projected bounding box
+	enum BoxResult
+	{
+		BOX_VISIBLE,
+		BOX_OCCLUDED,
+		BOX_OUTSIDE
+	};
+
+//
+//  Copy Constructor
+//  Assignment Operator
+//
+//  These functions have intentionally not been implemented.
+//    The statistics are atomic and cannot be copied.
+//
+	OcclusionCuller (const OcclusionCuller& original);
+	OcclusionCuller& operator= (const OcclusionCuller& original);
+
+//
+//  addTriangles
+//
+//  Purpose: To add projected triangles to the occluders.
+//  Parameter(s):
+//    <1> clip_points: The X, Y, and Z clip coordinates of the
+//                     vertexes
+//    <2> v_clip_w: The W clip coordinates of the vertexes
+//    <3> v_indexes: The vertexes for the triangles, 3 per
+//                   triangle
+//  Precondition(s):
+//    <1> clip_points.getSize() == v_clip_w.size()
+//    <2> v_indexes.size() % 3 == 0
+//    <3> Every element of v_indexes is less than
+//        clip_points.getSize()
+//  Returns: N/A
+//  Side Effect: The triangles are converted to window
+//               coordinates and added to the occluders.
+//               Triangles that cross the near plane, or that
+//               cover no area, are discarded.
+//
+	void addTriangles (const Vector3Array<float>& clip_points,
+	                   const std::vector<float>& v_clip_w,
+	                   const std::vector<unsigned int>& v_indexes);
+
+//
+//  rasterizeRows
+//
+//  Purpose: To draw the occluders into some rows of the depth
+//           buffer.
+//  Parameter(s):
+//    <1> begin: The first row to draw
+//    <2> end: The row after the last to draw
+//  Precondition(s):
+//    <1> begin <= end
+//    <2> end <= getHeight()
+//  Returns: N/A
+//  Side Effect: Every occluder triangle is drawn into rows
+//               begin to end of level 0.  Each thread must
+//               be given different rows.
+//
+	void rasterizeRows (unsigned int begin, unsigned int end);
+
+//
+//  buildLevelRows
+//
+//  Purpose: To calculate some rows of a level of the Hi-Z
+//           pyramid from the level below.
+//  Parameter(s):
+//    <1> level: Which level
+//    <2> begin: The first row to calculate
+//    <3> end: The row after the last to calculate
+//  Precondition(s):
+//    <1> level >= 1
+//    <2> level < getLevelCount()
+//    <3> begin <= end
+//    <4> end <= getLevelHeight(level)
+//  Returns: N/A
+//  Side Effect: Each texel in rows begin to end of level level
+//               is set to the farthest depth of the texels it
+//               covers in level level - 1.
+//
+	void buildLevelRows (unsigned int level,
+	                     unsigned int begin, unsigned int end);
+
+//
+//  testProjectedBox
+//
+//  Purpose: To test a bounding box with projected corners.
+//  Parameter(s):
+//    <1> corners: The X, Y, and Z clip coordinates of the
+//                 corners
+//    <2> a_corner_w: The W clip coordinates of the corners
+//    <3> first: The index of the first corner in corners and
+//               a_corner_w
+//  Precondition(s):
+//    <1> isRasterized()
+//    <2> first + 8 <= corners.getSize()
+//  Returns: Whether the bounding box is visible, occluded, or
+//           outside the view.
+//  Side Effect: N/A
+//
+	BoxResult testProjectedBox (const Vector3Array<float>& corners,
+	                            const float* a_corner_w,
+	                            unsigned int first) const;
+
+//
+//  addStatistics
+//
+//  Purpose: To add to the bounding box statistics.
+//  Parameter(s):
+//    <1> tested
+//    <2> occluded
+//    <3> outside: The amounts to add
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The statistics are increased.
+//
+	void addStatistics (unsigned int tested,
+	                    unsigned int occluded,
+	                    unsigned int outside) const;
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	unsigned int m_thread_count;
+	Matrix44 m_view_projection;
+	bool m_is_rasterized;
+
+	// occluder triangles in window coordinates
+	std::vector<float> mv_triangles;
+
+	// Hi-Z pyramid, level 0 first, rows bottom to top
+	std::vector<std::vector<float> > mvv_levels;
+	std::vector<unsigned int> mv_level_widths;
+	std::vector<unsigned int> mv_level_heights;
+
+	mutable std::atomic<unsigned int> m_tested_count;
+	mutable std::atomic<unsigned int> m_occluded_count;
+	mutable std::atomic<unsigned int> m_outside_count;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
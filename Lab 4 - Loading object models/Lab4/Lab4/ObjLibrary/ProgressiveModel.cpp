@@ -0,0 +1,1483 @@
+//
+//  ProgressiveModel.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <climits>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <iostream>
+#include <fstream>
+#include <mutex>
+#include <condition_variable>
+
+#include "Vector2.h"
+#include "Vector3.h"
+#include "ObjModel.h"
+#include "JobSystem.h"
+#include "ProgressiveModel.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  PROGRESSIVE_MAGIC
+	//  PROGRESSIVE_VERSION
+	//
+	//  The magic number at the start of a progressive model
+	//    file and the version of the format written.
+	//
+	const char PROGRESSIVE_MAGIC[4] = { 'O', 'L', 'P', 'M' };
+	const unsigned int PROGRESSIVE_VERSION = 1;
+
+	//
+	//  FLAG_TEXTURE_COORDINATE
+	//  FLAG_NORMAL
+	//
+	//  The flags for whether a vertex in a progressive model file
+	//    has texture coordinates and a normal.
+	//
+	const unsigned long long FLAG_TEXTURE_COORDINATE = 0x1;
+	const unsigned long long FLAG_NORMAL             = 0x2;
+
+	//
+	//  SPLIT_BATCH_SIZE
+	//
+	//  The number of vertex splits read before they are added to
+	//    the queue together.
+	//
+	const unsigned int SPLIT_BATCH_SIZE = 256;
+
+	//
+	//  BASE_BLOCK_SIZE
+	//
+	//  The number of base vertexes or faces read together.
+	//
+	const unsigned int BASE_BLOCK_SIZE = 65536;
+
+	//
+	//  MIN_FOLD_COSINE
+	//
+	//  The smallest cosine allowed between the normals of a face
+	//    before and after an edge collapse.  Collapses that turn
+	//    a face further than this are rejected, so the
+	//    simplified mesh does not fold over itself.
+	//
+	const double MIN_FOLD_COSINE = 0.2;
+
+	//
+	//  FileHeader
+	//  VertexRecord
+	//  FaceRecord
+	//  CornerRecord
+	//  SplitRecord
+	//
+	//  The records in a progressive model file.  They are written
+	//    as they are in memory and have no padding.
+	//
+	struct FileHeader
+	{
+		char ma_magic[4];
+		unsigned int m_version;
+		unsigned int m_material_library_count;
+		unsigned int m_mesh_count;
+		unsigned long long m_base_vertex_count;
+		unsigned long long m_base_face_count;
+		unsigned long long m_split_count;
+	};
+
+	struct VertexRecord
+	{
+		double ma_position[3];
+		double ma_texture_coordinate[2];
+		double ma_normal[3];
+		unsigned long long m_flags;
+	};
+
+	struct FaceRecord
+	{
+		unsigned long long m_mesh;
+		unsigned long long ma_vertexes[3];
+	};
+
+	struct CornerRecord
+	{
+		unsigned int m_mesh;
+		unsigned int m_face;
+		unsigned int m_corner;
+	};
+
+	struct SplitRecord
+	{
+		VertexRecord m_vertex;
+		unsigned long long m_parent;
+		unsigned int m_corner_count;
+		unsigned int m_face_count;
+	};
+
+	//
+	//  readValue
+	//  writeValue
+	//  readString
+	//  writeString
+	//
+	//  Purpose: To read or write a value in a progressive model
+	//           file.
+	//  Parameter(s):
+	//    <1> r_input: The file to read from
+	//    <1> r_output: The file to write to
+	//    <2> r_value: The value to read into
+	//    <2> value: The value to write
+	//    <2> r_remaining: The number of bytes left in r_input
+	//    <2> str: The string to write
+	//    <3> r_str: The string to read into
+	//  Precondition(s): N/A
+	//  Returns: readValue and readString return whether there
+	//           were enough bytes left.
+	//  Side Effect: The value is read or written.  A string is
+	//               stored as its length followed by its
+	//               characters.  readString checks the length
+	//               against r_remaining before resizing r_str and
+	//               subtracts the bytes read from r_remaining.
+	//
+	template <typename T>
+	bool readValue (istream& r_input, T& r_value)
+	{
+		r_input.read((char*)(&r_value), sizeof(T));
+		return r_input.gcount() == (streamsize)(sizeof(T));
+	}
+	template <typename T>
+	void writeValue (ostream& r_output, const T& value)
+	{
+		r_output.write((const char*)(&value), sizeof(T));
+	}
+	bool readString (istream& r_input,
+	                 unsigned long long& r_remaining,
+	                 string& r_str)
+	{
+		unsigned int length;
+		if(r_remaining < sizeof(length) ||
+		   !readValue(r_input, length) ||
+		   length > r_remaining - sizeof(length))
+		{
+			return false;
+		}
+		r_remaining -= sizeof(length) + length;
+		r_str.resize(length);
+		if(length == 0)
+			return true;
+		r_input.read(&(r_str[0]), length);
+		return r_input.gcount() == (streamsize)(length);
+	}
+
+	//
+	//  getRemainingSize
+	//
+	//  Purpose: To determine how many bytes are left in a
+	//           progressive model file.
+	//  Parameter(s):
+	//    <1> r_input: The file
+	//    <2> r_remaining: The number of bytes left
+	//  Precondition(s): N/A
+	//  Returns: Whether the size could be determined.
+	//  Side Effect: If the size could be determined, r_remaining
+	//               is set to it.  The read position of r_input
+	//               is not changed.
+	//
+	bool getRemainingSize (istream& r_input,
+	                       unsigned long long& r_remaining)
+	{
+		streamoff start = r_input.tellg();
+		if(start < 0 || !r_input.seekg(0, ios::end))
+			return false;
+		streamoff end = r_input.tellg();
+		if(end < start || !r_input.seekg(start, ios::beg))
+			return false;
+
+		r_remaining = (unsigned long long)(end - start);
+		return true;
+	}
+	void writeString (ostream& r_output, const string& str)
+	{
+		writeValue(r_output, (unsigned int)(str.size()));
+		r_output.write(str.data(), str.size());
+	}
+
+	//
+	//  BuildVertex
+	//
+	//  A record to store a vertex of the model being simplified.
+	//    A vertex is a unique combination of a position, texture
+	//    coordinates, and normal.
+	//
+	struct BuildVertex
+	{
+		ObjModel::Index m_position;
+		ObjModel::Index m_texture_coordinates;
+		ObjModel::Index m_normal;
+
+		bool operator== (const BuildVertex& other) const
+		{
+			return m_position            == other.m_position &&
+			       m_texture_coordinates == other.m_texture_coordinates &&
+			       m_normal              == other.m_normal;
+		}
+	};
+
+	//
+	//  BuildVertexHash
+	//
+	//  A function object to hash a BuildVertex.
+	//
+	struct BuildVertexHash
+	{
+		size_t operator() (const BuildVertex& vertex) const
+		{
+			hash<unsigned long long> hasher;
+			size_t result = hasher(vertex.m_position);
+			result = result * 31 + hasher(vertex.m_texture_coordinates);
+			result = result * 31 + hasher(vertex.m_normal);
+			return result;
+		}
+	};
+
+	//
+	//  BuildTriangle
+	//
+	//  A record to store a triangle of the model being
+	//    simplified.
+	//
+	struct BuildTriangle
+	{
+		unsigned int m_mesh;
+		unsigned int ma_vertexes[3];
+		bool m_is_removed;
+	};
+
+	//
+	//  BuildEdge
+	//
+	//  A record to store one side of a triangle, with the lower
+	//    vertex first, so the triangles sharing it can be found by
+	//    sorting.
+	//
+	struct BuildEdge
+	{
+		unsigned int m_low;
+		unsigned int m_high;
+		unsigned int m_mesh;
+
+		bool operator< (const BuildEdge& other) const
+		{
+			if(m_low != other.m_low)
+				return m_low < other.m_low;
+			return m_high < other.m_high;
+		}
+	};
+
+	//
+	//  Collapse
+	//
+	//  A record to store an edge collapse.  Vertex m_from is
+	//    moved onto vertex m_to, the triangles in mv_removed are
+	//    removed, and the corners in mv_changed (as triangle * 3
+	//    + corner) are changed from m_from to m_to.
+	//
+	struct Collapse
+	{
+		unsigned int m_from;
+		unsigned int m_to;
+		vector<unsigned int> mv_removed;
+		vector<unsigned int> mv_changed;
+	};
+
+	//
+	//  CollapseCandidate
+	//
+	//  A record to store a possible edge collapse and its cost.
+	//    The stamps are the versions of the two vertexes when it
+	//    was calculated, so it can be ignored if either has
+	//    changed since.
+	//
+	struct CollapseCandidate
+	{
+		double m_cost;
+		unsigned int m_from;
+		unsigned int m_to;
+		unsigned int m_from_stamp;
+		unsigned int m_to_stamp;
+
+		bool operator> (const CollapseCandidate& other) const
+		{
+			return m_cost > other.m_cost;
+		}
+	};
+
+	//
+	//  Quadric
+	//
+	//  A record to store the sum of the squared distances to a
+	//    set of planes, as the upper half of a symmetric 4x4
+	//    matrix.
+	//
+	struct Quadric
+	{
+		double ma_values[10];
+
+		Quadric ()
+		{
+			for(unsigned int i = 0; i < 10; i++)
+				ma_values[i] = 0.0;
+		}
+
+		void addPlane (const Vector3& normal, double d, double weight)
+		{
+			double a = normal.x;
+			double b = normal.y;
+			double c = normal.z;
+			ma_values[0] += weight * a * a;
+			ma_values[1] += weight * a * b;
+			ma_values[2] += weight * a * c;
+			ma_values[3] += weight * a * d;
+			ma_values[4] += weight * b * b;
+			ma_values[5] += weight * b * c;
+			ma_values[6] += weight * b * d;
+			ma_values[7] += weight * c * c;
+			ma_values[8] += weight * c * d;
+			ma_values[9] += weight * d * d;
+		}
+
+		void add (const Quadric& other)
+		{
+			for(unsigned int i = 0; i < 10; i++)
+				ma_values[i] += other.ma_values[i];
+		}
+
+		double evaluate (const Vector3& p) const
+		{
+			const double* q = ma_values;
+			return       q[0] * p.x * p.x + 2 * q[1] * p.x * p.y + 2 * q[2] * p.x * p.z + 2 * q[3] * p.x
+			     +       q[4] * p.y * p.y + 2 * q[5] * p.y * p.z + 2 * q[6] * p.y
+			     +       q[7] * p.z * p.z + 2 * q[8] * p.z
+			     +       q[9];
+		}
+	};
+
+	//
+	//  makeVertexRecord
+	//
+	//  Purpose: To create the record for a vertex in a
+	//           progressive model file.
+	//  Parameter(s):
+	//    <1> model: The model the vertex is from
+	//    <2> vertex: The vertex
+	//  Precondition(s):
+	//    <1> vertex refers to elements that exist in model
+	//  Returns: The record for vertex vertex.
+	//  Side Effect: N/A
+	//
+	VertexRecord makeVertexRecord (const ObjModel& model,
+	                               const BuildVertex& vertex)
+	{
+		VertexRecord record;
+		memset(&record, 0, sizeof(record));
+
+		const Vector3& position = model.getVertexPosition(vertex.m_position);
+		record.ma_position[0] = position.x;
+		record.ma_position[1] = position.y;
+		record.ma_position[2] = position.z;
+		if(vertex.m_texture_coordinates != ObjModel::NO_TEXTURE_COORDINATES)
+		{
+			const Vector2& texture_coordinate = model.getTextureCoordinate(vertex.m_texture_coordinates);
+			record.ma_texture_coordinate[0] = texture_coordinate.x;
+			record.ma_texture_coordinate[1] = texture_coordinate.y;
+			record.m_flags |= FLAG_TEXTURE_COORDINATE;
+		}
+		if(vertex.m_normal != ObjModel::NO_NORMAL)
+		{
+			const Vector3& normal = model.getNormalVector(vertex.m_normal);
+			record.ma_normal[0] = normal.x;
+			record.ma_normal[1] = normal.y;
+			record.ma_normal[2] = normal.z;
+			record.m_flags |= FLAG_NORMAL;
+		}
+		return record;
+	}
+
+	//
+	//  Simplifier
+	//
+	//  A class to simplify a triangle mesh by collapsing edges.
+	//    It is only used by ProgressiveModel::build.
+	//
+	class Simplifier
+	{
+	public:
+		Simplifier (const vector<Vector3>& v_positions,
+		            vector<BuildTriangle>& rv_triangles,
+		            const vector<bool>& v_locked)
+				: mv_positions(v_positions),
+				  mv_triangles(rv_triangles),
+				  mv_locked(v_locked),
+				  mv_is_collapsed(v_positions.size(), false),
+				  mv_stamps(v_positions.size(), 0),
+				  mvv_vertex_triangles(v_positions.size()),
+				  mv_quadrics(v_positions.size())
+		{
+			assert(v_positions.size() == v_locked.size());
+
+			for(unsigned int t = 0; t < mv_triangles.size(); t++)
+			{
+				const BuildTriangle& triangle = mv_triangles[t];
+				for(unsigned int c = 0; c < 3; c++)
+					mvv_vertex_triangles[triangle.ma_vertexes[c]].push_back(t);
+
+				// weighted by area, so small triangles matter less
+				const Vector3& p0 = mv_positions[triangle.ma_vertexes[0]];
+				Vector3 normal = (mv_positions[triangle.ma_vertexes[1]] - p0).crossProduct(
+				                  mv_positions[triangle.ma_vertexes[2]] - p0);
+				double area = normal.getNorm() * 0.5;
+				if(area <= 0.0)
+					continue;
+				normal /= area * 2.0;
+				Quadric plane;
+				plane.addPlane(normal, -normal.dotProduct(p0), area);
+				for(unsigned int c = 0; c < 3; c++)
+					mv_quadrics[triangle.ma_vertexes[c]].add(plane);
+			}
+		}
+
+		void simplify (unsigned int target_triangle_count,
+		               vector<Collapse>& rv_collapses)
+		{
+			unsigned int triangle_count = (unsigned int)(mv_triangles.size());
+			for(unsigned int v = 0; v < mv_positions.size(); v++)
+				addCandidates(v);
+
+			while(triangle_count > target_triangle_count && !m_candidates.empty())
+			{
+				CollapseCandidate candidate = m_candidates.top();
+				m_candidates.pop();
+				if(mv_is_collapsed[candidate.m_from] ||
+				   mv_is_collapsed[candidate.m_to] ||
+				   mv_stamps[candidate.m_from] != candidate.m_from_stamp ||
+				   mv_stamps[candidate.m_to]   != candidate.m_to_stamp)
+					continue;
+
+				Collapse collapse;
+				if(!collapseEdge(candidate.m_from, candidate.m_to, collapse))
+					continue;
+				triangle_count -= (unsigned int)(collapse.mv_removed.size());
+				rv_collapses.push_back(collapse);
+
+				// only the costs of the edges at the remaining
+				//   vertex have changed, the others are checked
+				//   again when they are removed from the queue
+				mv_stamps[candidate.m_to]++;
+				addCandidates(candidate.m_to);
+			}
+		}
+
+		bool isCollapsed (unsigned int vertex) const
+		{
+			return mv_is_collapsed[vertex];
+		}
+
+	private:
+		void getTriangles (unsigned int vertex,
+		                   vector<unsigned int>& rv_triangles)
+		{
+			// removed triangles are dropped from the list here
+			vector<unsigned int>& rv_list = mvv_vertex_triangles[vertex];
+			unsigned int kept = 0;
+			for(unsigned int i = 0; i < rv_list.size(); i++)
+				if(!mv_triangles[rv_list[i]].m_is_removed)
+					rv_list[kept++] = rv_list[i];
+			rv_list.resize(kept);
+			rv_triangles = rv_list;
+		}
+
+		void getNeighbours (unsigned int vertex,
+		                    vector<unsigned int>& rv_neighbours)
+		{
+			vector<unsigned int> v_triangles;
+			getTriangles(vertex, v_triangles);
+			rv_neighbours.clear();
+			for(unsigned int i = 0; i < v_triangles.size(); i++)
+				for(unsigned int c = 0; c < 3; c++)
+				{
+					unsigned int other = mv_triangles[v_triangles[i]].ma_vertexes[c];
+					if(other != vertex)
+						rv_neighbours.push_back(other);
+				}
+			sort(rv_neighbours.begin(), rv_neighbours.end());
+			rv_neighbours.erase(unique(rv_neighbours.begin(), rv_neighbours.end()), rv_neighbours.end());
+		}
+
+		void addCandidates (unsigned int vertex)
+		{
+			if(mv_is_collapsed[vertex])
+				return;
+
+			vector<unsigned int> v_neighbours;
+			getNeighbours(vertex, v_neighbours);
+			for(unsigned int i = 0; i < v_neighbours.size(); i++)
+			{
+				unsigned int other = v_neighbours[i];
+				if(!mv_locked[vertex])
+					addCandidate(vertex, other);
+				if(!mv_locked[other])
+					addCandidate(other, vertex);
+			}
+		}
+
+		void addCandidate (unsigned int from, unsigned int to)
+		{
+			Quadric combined = mv_quadrics[from];
+			combined.add(mv_quadrics[to]);
+
+			CollapseCandidate candidate;
+			candidate.m_cost       = combined.evaluate(mv_positions[to]);
+			candidate.m_from       = from;
+			candidate.m_to         = to;
+			candidate.m_from_stamp = mv_stamps[from];
+			candidate.m_to_stamp   = mv_stamps[to];
+			m_candidates.push(candidate);
+		}
+
+		bool collapseEdge (unsigned int from,
+		                   unsigned int to,
+		                   Collapse& r_collapse)
+		{
+			assert(!mv_locked[from]);
+
+			vector<unsigned int> v_from_triangles;
+			getTriangles(from, v_from_triangles);
+
+			// from is not locked, so its edges each have 2
+			//   triangles and the one to to is shared by 2
+			vector<unsigned int> v_shared;
+			vector<unsigned int> v_opposite;
+			for(unsigned int i = 0; i < v_from_triangles.size(); i++)
+			{
+				const BuildTriangle& triangle = mv_triangles[v_from_triangles[i]];
+				for(unsigned int c = 0; c < 3; c++)
+					if(triangle.ma_vertexes[c] == to)
+					{
+						v_shared.push_back(v_from_triangles[i]);
+						for(unsigned int o = 0; o < 3; o++)
+							if(triangle.ma_vertexes[o] != from && triangle.ma_vertexes[o] != to)
+								v_opposite.push_back(triangle.ma_vertexes[o]);
+					}
+			}
+			if(v_shared.size() != 2 || v_opposite.size() != 2 || v_opposite[0] == v_opposite[1])
+				return false;
+
+			// link condition: the only vertexes next to both are
+			//   the ones opposite the edge
+			vector<unsigned int> v_from_neighbours;
+			vector<unsigned int> v_to_neighbours;
+			getNeighbours(from, v_from_neighbours);
+			getNeighbours(to,   v_to_neighbours);
+			vector<unsigned int> v_common;
+			set_intersection(v_from_neighbours.begin(), v_from_neighbours.end(),
+			                 v_to_neighbours.begin(),   v_to_neighbours.end(),
+			                 back_inserter(v_common));
+			if(v_common.size() != 2)
+				return false;
+
+			// the vertexes opposite must keep at least 3 triangles
+			for(unsigned int i = 0; i < v_opposite.size(); i++)
+			{
+				vector<unsigned int> v_triangles;
+				getTriangles(v_opposite[i], v_triangles);
+				if(v_triangles.size() <= 3)
+					return false;
+			}
+
+			// no triangle may flip or become degenerate
+			for(unsigned int i = 0; i < v_from_triangles.size(); i++)
+			{
+				unsigned int t = v_from_triangles[i];
+				if(find(v_shared.begin(), v_shared.end(), t) != v_shared.end())
+					continue;
+				const BuildTriangle& triangle = mv_triangles[t];
+				Vector3 a_before[3];
+				Vector3 a_after[3];
+				for(unsigned int c = 0; c < 3; c++)
+				{
+					a_before[c] = mv_positions[triangle.ma_vertexes[c]];
+					a_after[c]  = (triangle.ma_vertexes[c] == from) ? mv_positions[to] : a_before[c];
+				}
+				Vector3 before = (a_before[1] - a_before[0]).crossProduct(a_before[2] - a_before[0]);
+				Vector3 after  = (a_after [1] - a_after [0]).crossProduct(a_after [2] - a_after [0]);
+				double norms = before.getNorm() * after.getNorm();
+				if(norms <= 0.0 || before.dotProduct(after) < MIN_FOLD_COSINE * norms)
+					return false;
+			}
+
+			r_collapse.m_from = from;
+			r_collapse.m_to   = to;
+			for(unsigned int i = 0; i < v_from_triangles.size(); i++)
+			{
+				unsigned int t = v_from_triangles[i];
+				BuildTriangle& r_triangle = mv_triangles[t];
+				if(find(v_shared.begin(), v_shared.end(), t) != v_shared.end())
+				{
+					r_triangle.m_is_removed = true;
+					r_collapse.mv_removed.push_back(t);
+					continue;
+				}
+				for(unsigned int c = 0; c < 3; c++)
+					if(r_triangle.ma_vertexes[c] == from)
+					{
+						r_triangle.ma_vertexes[c] = to;
+						r_collapse.mv_changed.push_back(t * 3 + c);
+					}
+				mvv_vertex_triangles[to].push_back(t);
+			}
+
+			mv_quadrics[to].add(mv_quadrics[from]);
+			mv_is_collapsed[from] = true;
+			mvv_vertex_triangles[from].clear();
+			return true;
+		}
+
+	private:
+		const vector<Vector3>& mv_positions;
+		vector<BuildTriangle>& mv_triangles;
+		const vector<bool>& mv_locked;
+		vector<bool> mv_is_collapsed;
+		vector<unsigned int> mv_stamps;
+		vector<vector<unsigned int> > mvv_vertex_triangles;
+		vector<Quadric> mv_quadrics;
+		priority_queue<CollapseCandidate,
+		               vector<CollapseCandidate>,
+		               greater<CollapseCandidate> > m_candidates;
+	};
+
+	//
+	//  findLockedVertexes
+	//
+	//  Purpose: To determine which vertexes must not be moved by
+	//           simplification.
+	//  Parameter(s):
+	//    <1> v_vertexes: The vertexes
+	//    <2> v_triangles: The triangles
+	//    <3> position_count: The number of positions
+	//    <4> rv_locked: The vector to fill with whether each
+	//                   vertex is locked
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: rv_locked is set to whether each vertex is
+	//               locked.  A vertex is locked if it shares its
+	//               position with another vertex, is on a side
+	//               without exactly 2 triangles, is where two
+	//               meshes meet, is in a degenerate triangle, or
+	//               if the triangles around it do not form a
+	//               single consistently-wound fan.
+	//
+	void findLockedVertexes (const vector<BuildVertex>& v_vertexes,
+	                         const vector<BuildTriangle>& v_triangles,
+	                         ObjModel::Index position_count,
+	                         vector<bool>& rv_locked)
+	{
+		rv_locked.assign(v_vertexes.size(), false);
+
+		// seams where texture coordinates or normals change
+		vector<unsigned int> v_position_uses((size_t)(position_count), 0);
+		for(unsigned int v = 0; v < v_vertexes.size(); v++)
+			v_position_uses[(size_t)(v_vertexes[v].m_position)]++;
+		for(unsigned int v = 0; v < v_vertexes.size(); v++)
+			if(v_position_uses[(size_t)(v_vertexes[v].m_position)] > 1)
+				rv_locked[v] = true;
+
+		// borders, non-manifold sides, and material edges
+		vector<BuildEdge> v_edges;
+		v_edges.reserve(v_triangles.size() * 3);
+		for(unsigned int t = 0; t < v_triangles.size(); t++)
+		{
+			const BuildTriangle& triangle = v_triangles[t];
+			for(unsigned int c = 0; c < 3; c++)
+			{
+				unsigned int a = triangle.ma_vertexes[c];
+				unsigned int b = triangle.ma_vertexes[(c + 1) % 3];
+				if(a == b)
+				{
+					for(unsigned int k = 0; k < 3; k++)
+						rv_locked[triangle.ma_vertexes[k]] = true;
+					continue;
+				}
+				BuildEdge edge;
+				edge.m_low  = min(a, b);
+				edge.m_high = max(a, b);
+				edge.m_mesh = triangle.m_mesh;
+				v_edges.push_back(edge);
+			}
+		}
+		sort(v_edges.begin(), v_edges.end());
+		for(size_t i = 0; i < v_edges.size(); )
+		{
+			size_t end = i + 1;
+			while(end < v_edges.size() &&
+			      v_edges[end].m_low  == v_edges[i].m_low &&
+			      v_edges[end].m_high == v_edges[i].m_high)
+				end++;
+			if(end - i != 2 || v_edges[i].m_mesh != v_edges[i + 1].m_mesh)
+			{
+				rv_locked[v_edges[i].m_low]  = true;
+				rv_locked[v_edges[i].m_high] = true;
+			}
+			i = end;
+		}
+
+		// the triangles around each vertex must form one fan
+		vector<vector<unsigned int> > vv_vertex_triangles(v_vertexes.size());
+		for(unsigned int t = 0; t < v_triangles.size(); t++)
+			for(unsigned int c = 0; c < 3; c++)
+				vv_vertex_triangles[v_triangles[t].ma_vertexes[c]].push_back(t);
+		vector<pair<unsigned int, unsigned int> > v_links;
+		for(unsigned int v = 0; v < v_vertexes.size(); v++)
+		{
+			if(rv_locked[v])
+				continue;
+
+			// each triangle links the vertex after v to the one
+			//   before it
+			const vector<unsigned int>& v_around = vv_vertex_triangles[v];
+			v_links.clear();
+			for(unsigned int i = 0; i < v_around.size(); i++)
+			{
+				const BuildTriangle& triangle = v_triangles[v_around[i]];
+				for(unsigned int c = 0; c < 3; c++)
+					if(triangle.ma_vertexes[c] == v)
+						v_links.push_back(make_pair(triangle.ma_vertexes[(c + 1) % 3],
+						                            triangle.ma_vertexes[(c + 2) % 3]));
+			}
+			sort(v_links.begin(), v_links.end());
+
+			bool is_fan = v_links.size() >= 3;
+			for(unsigned int i = 1; i < v_links.size() && is_fan; i++)
+				if(v_links[i].first == v_links[i - 1].first)
+					is_fan = false;
+			unsigned int steps = 0;
+			unsigned int current = is_fan ? v_links[0].first : 0;
+			while(is_fan)
+			{
+				vector<pair<unsigned int, unsigned int> >::const_iterator it =
+				        lower_bound(v_links.begin(), v_links.end(), make_pair(current, 0u));
+				if(it == v_links.end() || it->first != current)
+					is_fan = false;
+				else
+				{
+					current = it->second;
+					steps++;
+					if(current == v_links[0].first || steps > v_links.size())
+						break;
+				}
+			}
+			if(!is_fan || steps != v_links.size())
+				rv_locked[v] = true;
+		}
+	}
+
+}  // end of anonymous namespace
+
+
+
+ProgressiveModel :: ProgressiveModel ()
+		: m_model(),
+		  mv_texture_coordinate_indexes(),
+		  mv_normal_indexes(),
+		  m_input(),
+		  mv_read_face_counts(),
+		  m_read_vertex_count(0),
+		  m_queue(),
+		  m_log(),
+		  m_is_open(false),
+		  m_is_reading(false),
+		  m_is_failed(false),
+		  m_is_stopping(false),
+		  m_split_count(0),
+		  m_loaded_count(0),
+		  m_applied_count(0),
+		  m_target_count(ULLONG_MAX)
+{
+}
+
+ProgressiveModel :: ~ProgressiveModel ()
+{
+	close();
+}
+
+
+
+bool ProgressiveModel :: isOpen () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_is_open;
+}
+
+const ObjModel& ProgressiveModel :: getModel () const
+{
+	return m_model;
+}
+
+unsigned long long ProgressiveModel :: getSplitCount () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_split_count;
+}
+
+unsigned long long ProgressiveModel :: getLoadedSplitCount () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_loaded_count;
+}
+
+unsigned long long ProgressiveModel :: getAppliedSplitCount () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_applied_count;
+}
+
+unsigned long long ProgressiveModel :: getTargetSplitCount () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_target_count;
+}
+
+bool ProgressiveModel :: isLoading () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_is_reading;
+}
+
+bool ProgressiveModel :: isFullyLoaded () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_is_open && m_applied_count == m_split_count;
+}
+
+bool ProgressiveModel :: isFailed () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_is_failed;
+}
+
+string ProgressiveModel :: getLog () const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_log;
+}
+
+
+
+bool ProgressiveModel :: open (const string& filename)
+{
+	assert(filename != "");
+
+	return open(filename, cerr);
+}
+
+bool ProgressiveModel :: open (const string& filename,
+                               ostream& r_logstream)
+{
+	assert(filename != "");
+
+	close();
+	m_model.setFileNameWithPath(filename);
+
+	m_input.open(filename.c_str(), ios::in | ios::binary);
+	if(!m_input.is_open())
+	{
+		r_logstream << "Error: File \"" << filename << "\" does not exist" << endl;
+		close();
+		return false;
+	}
+
+	// every count in the header is checked against the file
+	//  size before anything is allocated for it
+	unsigned long long remaining;
+	if(!getRemainingSize(m_input, remaining))
+	{
+		r_logstream << "Error: File \"" << filename << "\" cannot be read" << endl;
+		close();
+		return false;
+	}
+
+	FileHeader header;
+	if(!readValue(m_input, header) ||
+	   memcmp(header.ma_magic, PROGRESSIVE_MAGIC, sizeof(PROGRESSIVE_MAGIC)) != 0 ||
+	   header.m_version != PROGRESSIVE_VERSION)
+	{
+		r_logstream << "Error: File \"" << filename << "\" is not a progressive model file" << endl;
+		close();
+		return false;
+	}
+
+	// the largest index is reserved for NO_NORMAL and
+	//   NO_TEXTURE_COORDINATES
+	if(header.m_base_vertex_count >= ObjModel::NO_NORMAL ||
+	   header.m_split_count >= ObjModel::NO_NORMAL - header.m_base_vertex_count)
+	{
+		r_logstream << "Error: File \"" << filename << "\" has too many vertexes for ObjModel::Index" << endl;
+		close();
+		return false;
+	}
+
+	// each name takes at least its length, and the base mesh
+	//  must fit after them
+	remaining -= sizeof(header);
+	unsigned long long name_count = (unsigned long long)(header.m_material_library_count) + header.m_mesh_count;
+	bool is_complete = name_count <= remaining / sizeof(unsigned int);
+	vector<string> v_libraries;
+	vector<string> v_mesh_materials;
+	if(is_complete)
+	{
+		v_libraries.resize(header.m_material_library_count);
+		v_mesh_materials.resize(header.m_mesh_count);
+	}
+	for(unsigned int i = 0; i < v_libraries.size() && is_complete; i++)
+		is_complete = readString(m_input, remaining, v_libraries[i]);
+	for(unsigned int m = 0; m < v_mesh_materials.size() && is_complete; m++)
+		is_complete = readString(m_input, remaining, v_mesh_materials[m]);
+	if(is_complete &&
+	   (header.m_base_vertex_count > remaining / sizeof(VertexRecord) ||
+	    header.m_base_face_count > (remaining - header.m_base_vertex_count * sizeof(VertexRecord)) / sizeof(FaceRecord)))
+	{
+		is_complete = false;
+	}
+	if(!is_complete)
+	{
+		r_logstream << "Error: File \"" << filename << "\" is truncated" << endl;
+		close();
+		return false;
+	}
+
+	for(unsigned int i = 0; i < v_libraries.size(); i++)
+		if(v_libraries[i] != "")
+			m_model.addMaterialLibrary(v_libraries[i], r_logstream);
+	for(unsigned int m = 0; m < v_mesh_materials.size(); m++)
+	{
+		unsigned int mesh = m_model.addMesh();
+		if(v_mesh_materials[m] != "")
+			m_model.setMeshMaterial(mesh, v_mesh_materials[m]);
+	}
+	mv_read_face_counts.assign(header.m_mesh_count, 0);
+
+	// base vertexes
+	vector<VertexRecord> v_vertex_buffer;
+	for(unsigned long long done = 0; done < header.m_base_vertex_count && is_complete; )
+	{
+		size_t block = (size_t)(min<unsigned long long>(header.m_base_vertex_count - done, BASE_BLOCK_SIZE));
+		v_vertex_buffer.resize(block);
+		m_input.read((char*)(v_vertex_buffer.data()), block * sizeof(VertexRecord));
+		if(m_input.gcount() != (streamsize)(block * sizeof(VertexRecord)))
+		{
+			is_complete = false;
+			break;
+		}
+		for(size_t i = 0; i < block; i++)
+		{
+			const VertexRecord& record = v_vertex_buffer[i];
+			m_model.addVertex(record.ma_position[0], record.ma_position[1], record.ma_position[2]);
+			if(record.m_flags & FLAG_TEXTURE_COORDINATE)
+				mv_texture_coordinate_indexes.push_back(m_model.addTextureCoordinate(record.ma_texture_coordinate[0],
+				                                                                     record.ma_texture_coordinate[1]));
+			else
+				mv_texture_coordinate_indexes.push_back(ObjModel::NO_TEXTURE_COORDINATES);
+			if(record.m_flags & FLAG_NORMAL)
+				mv_normal_indexes.push_back(m_model.addNormal(record.ma_normal[0], record.ma_normal[1], record.ma_normal[2]));
+			else
+				mv_normal_indexes.push_back(ObjModel::NO_NORMAL);
+		}
+		done += block;
+	}
+
+	// base faces
+	vector<FaceRecord> v_face_buffer;
+	bool is_valid = true;
+	for(unsigned long long done = 0; done < header.m_base_face_count && is_complete && is_valid; )
+	{
+		size_t block = (size_t)(min<unsigned long long>(header.m_base_face_count - done, BASE_BLOCK_SIZE));
+		v_face_buffer.resize(block);
+		m_input.read((char*)(v_face_buffer.data()), block * sizeof(FaceRecord));
+		if(m_input.gcount() != (streamsize)(block * sizeof(FaceRecord)))
+		{
+			is_complete = false;
+			break;
+		}
+		for(size_t i = 0; i < block; i++)
+		{
+			const FaceRecord& record = v_face_buffer[i];
+			if(record.m_mesh >= header.m_mesh_count ||
+			   mv_read_face_counts[(size_t)(record.m_mesh)] == UINT_MAX ||
+			   record.ma_vertexes[0] >= header.m_base_vertex_count ||
+			   record.ma_vertexes[1] >= header.m_base_vertex_count ||
+			   record.ma_vertexes[2] >= header.m_base_vertex_count)
+			{
+				is_valid = false;
+				break;
+			}
+
+			unsigned int mesh = (unsigned int)(record.m_mesh);
+			unsigned int face = m_model.addFace(mesh);
+			for(unsigned int c = 0; c < 3; c++)
+			{
+				ObjModel::Index vertex = (ObjModel::Index)(record.ma_vertexes[c]);
+				m_model.addFaceVertex(mesh, face, vertex, mv_texture_coordinate_indexes[vertex], mv_normal_indexes[vertex]);
+			}
+			mv_read_face_counts[mesh]++;
+		}
+		done += block;
+	}
+	if(!is_complete || !is_valid)
+	{
+		if(!is_complete)
+			r_logstream << "Error: File \"" << filename << "\" is truncated" << endl;
+		else
+			r_logstream << "Error: File \"" << filename << "\" has an invalid base face" << endl;
+		close();
+		return false;
+	}
+	m_read_vertex_count = header.m_base_vertex_count;
+
+	lock_guard<mutex> lock(m_mutex);
+	m_is_open     = true;
+	m_split_count = header.m_split_count;
+	startReading();
+	return true;
+}
+
+void ProgressiveModel :: close ()
+{
+	{
+		unique_lock<mutex> lock(m_mutex);
+		m_is_stopping = true;
+		while(m_is_reading)
+			m_changed_condition.wait(lock);
+		m_is_stopping = false;
+
+		m_queue.clear();
+		m_log.clear();
+		m_is_open       = false;
+		m_is_failed     = false;
+		m_split_count   = 0;
+		m_loaded_count  = 0;
+		m_applied_count = 0;
+	}
+
+	// the job has finished, so nothing else uses these
+	m_input.close();
+	m_input.clear();
+	mv_read_face_counts.clear();
+	m_read_vertex_count = 0;
+	m_model.makeEmpty();
+	mv_texture_coordinate_indexes.clear();
+	mv_normal_indexes.clear();
+}
+
+void ProgressiveModel :: setTargetSplitCount (unsigned long long count)
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_target_count = count;
+	startReading();
+}
+
+unsigned int ProgressiveModel :: update (unsigned int max_count)
+{
+	vector<Split> v_splits;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		unsigned int count = max_count;
+		if(count > m_queue.size())
+			count = (unsigned int)(m_queue.size());
+		for(unsigned int i = 0; i < count; i++)
+			v_splits.push_back(move(m_queue[i]));
+		m_queue.erase(m_queue.begin(), m_queue.begin() + count);
+	}
+
+	// the job only reads the file, so the model can be changed
+	//   without the lock
+	for(unsigned int i = 0; i < v_splits.size(); i++)
+		applySplit(v_splits[i]);
+
+	if(!v_splits.empty())
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_applied_count += v_splits.size();
+	}
+	return (unsigned int)(v_splits.size());
+}
+
+bool ProgressiveModel :: build (const ObjModel& model,
+                                const string& filename,
+                                unsigned int base_face_count)
+{
+	assert(model.isValid());
+	assert(filename != "");
+
+	return build(model, filename, base_face_count, cerr);
+}
+
+bool ProgressiveModel :: build (const ObjModel& model,
+                                const string& filename,
+                                unsigned int base_face_count,
+                                ostream& r_logstream)
+{
+	assert(model.isValid());
+	assert(filename != "");
+
+	//
+	//  Split the faces into triangles and find the unique
+	//    vertexes they use.
+	//
+
+	vector<BuildVertex> v_vertexes;
+	vector<BuildTriangle> v_triangles;
+	unordered_map<BuildVertex, unsigned int, BuildVertexHash> vertex_ids;
+	v_triangles.reserve(model.getFaceCountTotal());
+
+	for(unsigned int m = 0; m < model.getMeshCount(); m++)
+		for(unsigned int f = 0; f < model.getFaceCount(m); f++)
+		{
+			unsigned int corner_count = model.getFaceVertexCount(m, f);
+			unsigned int a_fan[3] = { 0, 0, 0 };
+			for(unsigned int c = 0; c < corner_count; c++)
+			{
+				BuildVertex vertex;
+				vertex.m_position            = model.getFaceVertexIndex(m, f, c);
+				vertex.m_texture_coordinates = model.getFaceVertexTextureCoordinates(m, f, c);
+				vertex.m_normal              = model.getFaceVertexNormal(m, f, c);
+
+				unordered_map<BuildVertex, unsigned int, BuildVertexHash>::const_iterator it = vertex_ids.find(vertex);
+				unsigned int id;
+				if(it != vertex_ids.end())
+					id = it->second;
+				else
+				{
+					id = (unsigned int)(v_vertexes.size());
+					vertex_ids[vertex] = id;
+					v_vertexes.push_back(vertex);
+				}
+
+				// fan out from the first vertex
+				if(c == 0)
+					a_fan[0] = id;
+				else
+				{
+					a_fan[1] = a_fan[2];
+					a_fan[2] = id;
+				}
+				if(c >= 2)
+				{
+					BuildTriangle triangle;
+					triangle.m_mesh = m;
+					triangle.ma_vertexes[0] = a_fan[0];
+					triangle.ma_vertexes[1] = a_fan[1];
+					triangle.ma_vertexes[2] = a_fan[2];
+					triangle.m_is_removed = false;
+					v_triangles.push_back(triangle);
+				}
+			}
+		}
+	vertex_ids.clear();
+
+	//
+	//  Simplify the triangles.
+	//
+
+	vector<Vector3> v_positions(v_vertexes.size());
+	for(unsigned int v = 0; v < v_vertexes.size(); v++)
+		v_positions[v] = model.getVertexPosition(v_vertexes[v].m_position);
+	vector<bool> v_locked;
+	findLockedVertexes(v_vertexes, v_triangles, model.getVertexCount(), v_locked);
+
+	vector<Collapse> v_collapses;
+	Simplifier simplifier(v_positions, v_triangles, v_locked);
+	simplifier.simplify(base_face_count, v_collapses);
+
+	//
+	//  Number the vertexes and faces in the order they will be
+	//    added when the file is read.
+	//
+
+	vector<unsigned long long> v_file_vertexes(v_vertexes.size(), 0);
+	unsigned long long base_vertex_count = 0;
+	for(unsigned int v = 0; v < v_vertexes.size(); v++)
+		if(!simplifier.isCollapsed(v))
+			v_file_vertexes[v] = base_vertex_count++;
+	unsigned long long next_vertex = base_vertex_count;
+	for(size_t k = v_collapses.size(); k > 0; k--)
+		v_file_vertexes[v_collapses[k - 1].m_from] = next_vertex++;
+
+	vector<unsigned int> v_file_faces(v_triangles.size(), 0);
+	vector<unsigned int> v_mesh_face_counts(model.getMeshCount(), 0);
+	unsigned long long base_face_total = 0;
+	for(unsigned int t = 0; t < v_triangles.size(); t++)
+		if(!v_triangles[t].m_is_removed)
+		{
+			v_file_faces[t] = v_mesh_face_counts[v_triangles[t].m_mesh]++;
+			base_face_total++;
+		}
+	for(size_t k = v_collapses.size(); k > 0; k--)
+	{
+		const vector<unsigned int>& v_removed = v_collapses[k - 1].mv_removed;
+		for(unsigned int i = 0; i < v_removed.size(); i++)
+			v_file_faces[v_removed[i]] = v_mesh_face_counts[v_triangles[v_removed[i]].m_mesh]++;
+	}
+
+	//
+	//  Write the file.
+	//
+
+	ofstream output(filename.c_str(), ios::out | ios::binary | ios::trunc);
+	if(!output.is_open())
+	{
+		r_logstream << "Error: Could not create file \"" << filename << "\"" << endl;
+		return false;
+	}
+
+	FileHeader header;
+	memcpy(header.ma_magic, PROGRESSIVE_MAGIC, sizeof(PROGRESSIVE_MAGIC));
+	header.m_version                = PROGRESSIVE_VERSION;
+	header.m_material_library_count = model.getMaterialLibraryCount();
+	header.m_mesh_count             = model.getMeshCount();
+	header.m_base_vertex_count      = base_vertex_count;
+	header.m_base_face_count        = base_face_total;
+	header.m_split_count            = v_collapses.size();
+	writeValue(output, header);
+
+	for(unsigned int i = 0; i < model.getMaterialLibraryCount(); i++)
+		writeString(output, model.getMaterialLibraryName(i));
+	for(unsigned int m = 0; m < model.getMeshCount(); m++)
+		writeString(output, model.isMeshMaterial(m) ? model.getMeshMaterialName(m) : string());
+
+	for(unsigned int v = 0; v < v_vertexes.size(); v++)
+		if(!simplifier.isCollapsed(v))
+			writeValue(output, makeVertexRecord(model, v_vertexes[v]));
+
+	for(unsigned int t = 0; t < v_triangles.size(); t++)
+		if(!v_triangles[t].m_is_removed)
+		{
+			FaceRecord record;
+			record.m_mesh = v_triangles[t].m_mesh;
+			for(unsigned int c = 0; c < 3; c++)
+				record.ma_vertexes[c] = v_file_vertexes[v_triangles[t].ma_vertexes[c]];
+			writeValue(output, record);
+		}
+
+	// removed triangles are not changed again, so they still
+	//   have the corners they had when they were removed
+	for(size_t k = v_collapses.size(); k > 0; k--)
+	{
+		const Collapse& collapse = v_collapses[k - 1];
+
+		SplitRecord split;
+		split.m_vertex       = makeVertexRecord(model, v_vertexes[collapse.m_from]);
+		split.m_parent       = v_file_vertexes[collapse.m_to];
+		split.m_corner_count = (unsigned int)(collapse.mv_changed.size());
+		split.m_face_count   = (unsigned int)(collapse.mv_removed.size());
+		writeValue(output, split);
+
+		for(unsigned int i = 0; i < collapse.mv_changed.size(); i++)
+		{
+			unsigned int t = collapse.mv_changed[i] / 3;
+			CornerRecord corner;
+			corner.m_mesh   = v_triangles[t].m_mesh;
+			corner.m_face   = v_file_faces[t];
+			corner.m_corner = collapse.mv_changed[i] % 3;
+			writeValue(output, corner);
+		}
+		for(unsigned int i = 0; i < collapse.mv_removed.size(); i++)
+		{
+			const BuildTriangle& triangle = v_triangles[collapse.mv_removed[i]];
+			FaceRecord record;
+			record.m_mesh = triangle.m_mesh;
+			for(unsigned int c = 0; c < 3; c++)
+				record.ma_vertexes[c] = v_file_vertexes[triangle.ma_vertexes[c]];
+			writeValue(output, record);
+		}
+	}
+
+	output.close();
+	if(output.fail())
+	{
+		r_logstream << "Error: Could not write file \"" << filename << "\"" << endl;
+		return false;
+	}
+	return true;
+}
+
+
+
+void ProgressiveModel :: readSplits ()
+{
+	for(;;)
+	{
+		unsigned long long batch;
+		{
+			lock_guard<mutex> lock(m_mutex);
+			assert(m_is_reading);
+
+			unsigned long long limit = min(m_target_count, m_split_count);
+			if(m_is_stopping || m_loaded_count >= limit)
+			{
+				m_is_reading = false;
+				m_changed_condition.notify_all();
+				return;
+			}
+			batch = min<unsigned long long>(limit - m_loaded_count, SPLIT_BATCH_SIZE);
+		}
+
+		vector<Split> v_splits;
+		bool is_valid = true;
+		for(unsigned long long s = 0; s < batch && is_valid; s++)
+		{
+			SplitRecord record;
+			if(!readValue(m_input, record) || record.m_parent >= m_read_vertex_count)
+			{
+				is_valid = false;
+				break;
+			}
+
+			Split split;
+			for(unsigned int i = 0; i < 3; i++)
+				split.ma_position[i] = record.m_vertex.ma_position[i];
+			for(unsigned int i = 0; i < 2; i++)
+				split.ma_texture_coordinate[i] = record.m_vertex.ma_texture_coordinate[i];
+			for(unsigned int i = 0; i < 3; i++)
+				split.ma_normal[i] = record.m_vertex.ma_normal[i];
+			split.m_is_texture_coordinate = (record.m_vertex.m_flags & FLAG_TEXTURE_COORDINATE) != 0;
+			split.m_is_normal             = (record.m_vertex.m_flags & FLAG_NORMAL) != 0;
+
+			// the corners must refer to faces that already exist
+			for(unsigned int i = 0; i < record.m_corner_count && is_valid; i++)
+			{
+				CornerRecord corner;
+				if(!readValue(m_input, corner) ||
+				   corner.m_mesh >= mv_read_face_counts.size() ||
+				   corner.m_face >= mv_read_face_counts[corner.m_mesh] ||
+				   corner.m_corner >= 3)
+				{
+					is_valid = false;
+					break;
+				}
+				split.mv_corners.push_back(corner.m_mesh);
+				split.mv_corners.push_back(corner.m_face);
+				split.mv_corners.push_back(corner.m_corner);
+			}
+
+			// the faces may also use the new vertex
+			for(unsigned int i = 0; i < record.m_face_count && is_valid; i++)
+			{
+				FaceRecord face;
+				if(!readValue(m_input, face) ||
+				   face.m_mesh >= mv_read_face_counts.size() ||
+				   mv_read_face_counts[(size_t)(face.m_mesh)] == UINT_MAX ||
+				   face.ma_vertexes[0] > m_read_vertex_count ||
+				   face.ma_vertexes[1] > m_read_vertex_count ||
+				   face.ma_vertexes[2] > m_read_vertex_count)
+				{
+					is_valid = false;
+					break;
+				}
+				mv_read_face_counts[(size_t)(face.m_mesh)]++;
+				split.mv_faces.push_back(face.m_mesh);
+				for(unsigned int c = 0; c < 3; c++)
+					split.mv_faces.push_back(face.ma_vertexes[c]);
+			}
+
+			if(is_valid)
+			{
+				m_read_vertex_count++;
+				v_splits.push_back(move(split));
+			}
+		}
+
+		lock_guard<mutex> lock(m_mutex);
+		for(unsigned int i = 0; i < v_splits.size(); i++)
+			m_queue.push_back(move(v_splits[i]));
+		m_loaded_count += v_splits.size();
+		if(!is_valid)
+		{
+			m_log += "Error: Vertex split #" + to_string(m_loaded_count) + " is truncated or invalid\n";
+			m_is_failed  = true;
+			m_is_reading = false;
+			m_changed_condition.notify_all();
+			return;
+		}
+	}
+}
+
+void ProgressiveModel :: startReading ()
+{
+	if(!m_is_open || m_is_reading || m_is_failed)
+		return;
+	if(m_loaded_count >= m_target_count || m_loaded_count >= m_split_count)
+		return;
+
+	m_is_reading = true;
+	JobSystem::getShared().add([this] () { readSplits(); },
+	                           JobSystem::PRIORITY_LOW);
+}
+
+void ProgressiveModel :: applySplit (const Split& split)
+{
+	ObjModel::Index vertex = m_model.addVertex(split.ma_position[0], split.ma_position[1], split.ma_position[2]);
+	assert(vertex == mv_texture_coordinate_indexes.size());
+	if(split.m_is_texture_coordinate)
+		mv_texture_coordinate_indexes.push_back(m_model.addTextureCoordinate(split.ma_texture_coordinate[0],
+		                                                                     split.ma_texture_coordinate[1]));
+	else
+		mv_texture_coordinate_indexes.push_back(ObjModel::NO_TEXTURE_COORDINATES);
+	if(split.m_is_normal)
+		mv_normal_indexes.push_back(m_model.addNormal(split.ma_normal[0], split.ma_normal[1], split.ma_normal[2]));
+	else
+		mv_normal_indexes.push_back(ObjModel::NO_NORMAL);
+
+	for(unsigned int i = 0; i < split.mv_corners.size(); i += 3)
+	{
+		unsigned int mesh   = split.mv_corners[i];
+		unsigned int face   = split.mv_corners[i + 1];
+		unsigned int corner = split.mv_corners[i + 2];
+		m_model.setFaceVertexIndex(mesh, face, corner, vertex);
+		m_model.setFaceVertexTextureCoordinates(mesh, face, corner, mv_texture_coordinate_indexes[vertex]);
+		m_model.setFaceVertexNormal(mesh, face, corner, mv_normal_indexes[vertex]);
+	}
+
+	for(unsigned int i = 0; i < split.mv_faces.size(); i += 4)
+	{
+		unsigned int mesh = (unsigned int)(split.mv_faces[i]);
+		unsigned int face = m_model.addFace(mesh);
+		for(unsigned int c = 0; c < 3; c++)
+		{
+			ObjModel::Index corner_vertex = (ObjModel::Index)(split.mv_faces[i + 1 + c]);
+			m_model.addFaceVertex(mesh, face, corner_vertex, mv_texture_coordinate_indexes[corner_vertex], mv_normal_indexes[corner_vertex]);
+		}
+	}
+}
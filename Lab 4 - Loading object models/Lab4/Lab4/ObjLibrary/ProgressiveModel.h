@@ -0,0 +1,472 @@
+//
+//  ProgressiveModel.h
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_PROGRESSIVE_MODEL_H
+#define OBJ_LIBRARY_PROGRESSIVE_MODEL_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <iostream>
+#include <fstream>
+#include <mutex>
+#include <condition_variable>
+
+#include "ObjModel.h"
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  ProgressiveModel
+//
+//  A class to display a large model before it has finished
+//    loading.  A progressive model file stores a coarse base
+//    mesh followed by a list of vertex splits.  Each vertex
+//    split adds one vertex and the faces around it, and moves
+//    some corners of existing faces to the new vertex.  Applying
+//    all the splits in order gives back the original model.
+//
+//  A progressive model file is made from an ObjModel by the
+//    build function.  It simplifies the model by collapsing
+//    edges one at a time, choosing the collapse that changes
+//    the shape the least each time, measured with quadric
+//    error metrics.  Each collapse moves one vertex onto a
+//    neighbour, so no new positions are created.  The collapses
+//    are then written in reverse order as the vertex splits.
+//    Vertexes on the border of the model, on a seam where the
+//    texture coordinates or normals change, or where meshes
+//    with different materials meet are never collapsed, so
+//    the coarse mesh keeps its outline and has no cracks.
+//    Point sets and polylines are not stored, and faces are
+//    split into triangles.
+//
+//  The open function reads only the base mesh, so the coarse
+//    model can be displayed immediately.  The vertex splits
+//    are then read by a job on the shared JobSystem and queued
+//    until update is called to apply them to the model.  The
+//    number of splits read can be limited with
+//    setTargetSplitCount.  A model seen from far away can thus
+//    be displayed without ever reading most of the file.
+//
+//  The model is only changed by update, so getModel and update
+//    must be called from the same thread, normally the one with
+//    the OpenGL context.  The other functions may be called
+//    from any thread, but a ProgressiveModel must not be
+//    destroyed or opened again while another thread is using
+//    it.
+//
+//  The format of a progressive model file is:
+//
+//    Header
+//      -> the magic number "OLPM" and the version
+//      -> the material library and mesh counts
+//      -> the base vertex, base face, and vertex split counts,
+//         as 64-bit integers
+//      -> the material library names
+//      -> the mesh material names
+//    Base vertexes
+//    Base faces
+//    Vertex splits, each as:
+//      -> the new vertex
+//      -> the vertex it was split from
+//      -> the changed corner and new face counts
+//      -> the changed corners
+//      -> the new faces
+//
+//  Each vertex is stored with its position, its texture
+//    coordinates, its normal, and flags for which of the last
+//    two it has.  Vertexes are numbered in the order they are
+//    added, base vertexes first.  Faces are stored as a mesh
+//    and 3 vertexes and are numbered within their mesh in the
+//    order they are added.  A changed corner is stored as a
+//    mesh, a face, and a corner within the face, all of which
+//    must already exist.
+//
+class ProgressiveModel
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new ProgressiveModel without a file.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new ProgressiveModel is created.  Its model
+//               is empty.
+//
+	ProgressiveModel ();
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy this ProgressiveModel.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Any vertex splits still being read are
+//               abandoned.  This function waits until the job
+//               reading them has finished.
+//
+	~ProgressiveModel ();
+
+//
+//  isOpen
+//
+//  Purpose: To determine if this ProgressiveModel has a file
+//           open.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether a progressive model file has been opened
+//           successfully.
+//  Side Effect: N/A
+//
+	bool isOpen () const;
+
+//
+//  getModel
+//
+//  Purpose: To retrieve the model at its current level of
+//           detail.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The model with the base mesh and all the vertex
+//           splits applied so far.  This model changes each
+//           time update applies a vertex split.
+//  Side Effect: N/A
+//
+	const ObjModel& getModel () const;
+
+//
+//  getSplitCount
+//
+//  Purpose: To determine the number of vertex splits in the
+//           file for this ProgressiveModel.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of vertex splits in the file.  If no
+//           file is open, 0 is returned.
+//  Side Effect: N/A
+//
+	unsigned long long getSplitCount () const;
+
+//
+//  getLoadedSplitCount
+//
+//  Purpose: To determine the number of vertex splits that have
+//           been read from the file.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of vertex splits read, including those
+//           that have been applied.
+//  Side Effect: N/A
+//
+	unsigned long long getLoadedSplitCount () const;
+
+//
+//  getAppliedSplitCount
+//
+//  Purpose: To determine the number of vertex splits that have
+//           been applied to the model.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of vertex splits applied.
+//  Side Effect: N/A
+//
+	unsigned long long getAppliedSplitCount () const;
+
+//
+//  getTargetSplitCount
+//
+//  Purpose: To determine the number of vertex splits that will
+//           be read from the file.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of vertex splits to read.
+//  Side Effect: N/A
+//
+	unsigned long long getTargetSplitCount () const;
+
+//
+//  isLoading
+//
+//  Purpose: To determine if vertex splits are being read from
+//           the file.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the job reading vertex splits is running.
+//  Side Effect: N/A
+//
+	bool isLoading () const;
+
+//
+//  isFullyLoaded
+//
+//  Purpose: To determine if this ProgressiveModel is displaying
+//           the full detail of its file.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether a file is open and all the vertex splits
+//           in it have been applied.
+//  Side Effect: N/A
+//
+	bool isFullyLoaded () const;
+
+//
+//  isFailed
+//
+//  Purpose: To determine if the vertex splits could not all be
+//           read.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether an error was found while reading the
+//           vertex splits.  If so, no more will be read.
+//  Side Effect: N/A
+//
+	bool isFailed () const;
+
+//
+//  getLog
+//
+//  Purpose: To retrieve the errors found while reading the
+//           vertex splits.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The errors found by the job reading the vertex
+//           splits.  Errors in the base mesh are written to the
+//           stream passed to open instead.
+//  Side Effect: N/A
+//
+	std::string getLog () const;
+
+//
+//  open
+//
+//  Purpose: To open a progressive model file.
+//  Parameter(s):
+//    <1> filename: The name of the file
+//    <2> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: Whether the header and the base mesh could be read.
+//  Side Effect: If this ProgressiveModel already had a file
+//               open, it is closed.  Then the header and the
+//               base mesh are read from file filename into the
+//               model.  The material libraries are also loaded.
+//               If getTargetSplitCount() > 0, a job is added to
+//               the shared JobSystem to read the vertex splits.
+//               Any loading errors are written to r_logstream.
+//
+	bool open (const std::string& filename);
+	bool open (const std::string& filename,
+	           std::ostream& r_logstream);
+
+//
+//  close
+//
+//  Purpose: To close the file for this ProgressiveModel.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Any vertex splits still being read are
+//               abandoned and this function waits until the job
+//               reading them has finished.  The file is closed
+//               and the model is made empty.
+//
+	void close ();
+
+//
+//  setTargetSplitCount
+//
+//  Purpose: To change the number of vertex splits that will be
+//           read from the file.
+//  Parameter(s):
+//    <1> count: The number of vertex splits to read
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The target is set to count.  If a file is open
+//               and fewer than count vertex splits have been
+//               read, a job is added to read more if there is
+//               not one already.  If more than count splits
+//               have already been read, nothing happens to them;
+//               a ProgressiveModel only becomes more detailed.
+//               The default target is all the vertex splits.
+//
+	void setTargetSplitCount (unsigned long long count);
+
+//
+//  update
+//
+//  Purpose: To apply the vertex splits that have been read to
+//           the model.
+//  Parameter(s):
+//    <1> max_count: The largest number of vertex splits to
+//                   apply
+//  Precondition(s): N/A
+//  Returns: The number of vertex splits applied.
+//  Side Effect: Up to max_count of the vertex splits that have
+//               been read are applied to the model, in order.
+//               This function must be called from the thread
+//               that uses the model.
+//
+	unsigned int update (unsigned int max_count);
+
+//
+//  build
+//
+//  Purpose: To create a progressive model file from a model.
+//  Parameter(s):
+//    <1> model: The model to simplify
+//    <2> filename: The name of the file to create
+//    <3> base_face_count: The number of faces to try to
+//                         simplify the base mesh to
+//    <4> r_logstream: The stream to write errors to
+//  Precondition(s):
+//    <1> model.isValid()
+//    <2> filename != ""
+//  Returns: Whether the file could be written.
+//  Side Effect: The faces of model are split into triangles and
+//               simplified until there are at most
+//               base_face_count or no more edges can be safely
+//               collapsed.  The simplified model and the vertex
+//               splits to restore the original are written to
+//               file filename.  Any errors are written to
+//               r_logstream.
+//
+	static bool build (const ObjModel& model,
+	                   const std::string& filename,
+	                   unsigned int base_face_count);
+	static bool build (const ObjModel& model,
+	                   const std::string& filename,
+	                   unsigned int base_face_count,
+	                   std::ostream& r_logstream);
+
+private:
+//
+//  Split
+//
+//  A record to store a vertex split that has been read but not
+//    applied.  The corners are stored as a mesh, a face, and a
+//    corner each, and the faces as a mesh and 3 vertexes each.
+//
+	struct Split
+	{
+		double ma_position[3];
+		double ma_texture_coordinate[2];
+		double ma_normal[3];
+		bool m_is_texture_coordinate;
+		bool m_is_normal;
+		std::vector<unsigned int> mv_corners;
+		std::vector<unsigned long long> mv_faces;
+	};
+
+//
+//  Helper Function: readSplits
+//
+//  Purpose: To read vertex splits from the file until the
+//           target is reached.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> m_is_reading
+//  Returns: N/A
+//  Side Effect: Vertex splits are read from m_input and added
+//               to the queue in batches.  Each one is checked
+//               against the faces and vertexes that will exist
+//               when it is applied.  If one is invalid, an error
+//               is added to the log and no more are read.  When
+//               the target is reached, m_is_reading is set to
+//               false and the job ends.
+//
+	void readSplits ();
+
+//
+//  Helper Function: startReading
+//
+//  Purpose: To add a job to read vertex splits if one is needed.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> m_mutex is locked by this thread
+//  Returns: N/A
+//  Side Effect: If a file is open, fewer vertex splits have
+//               been read than the target, no errors have been
+//               found, and there is no job reading, a job is
+//               added to the shared JobSystem with PRIORITY_LOW
+//               to read them.
+//
+	void startReading ();
+
+//
+//  Helper Function: applySplit
+//
+//  Purpose: To apply a vertex split to the model.
+//  Parameter(s):
+//    <1> split: The vertex split
+//  Precondition(s):
+//    <1> split is the next vertex split in the file
+//  Returns: N/A
+//  Side Effect: The vertex in split is added to the model, the
+//               corners in split are changed to refer to it,
+//               and the faces in split are added.
+//
+	void applySplit (const Split& split);
+
+//
+//  Copy Constructor
+//  Assignment Operator
+//
+//  These functions have intentionally not been implemented
+//    because the job reading vertex splits refers to the
+//    ProgressiveModel that added it.
+//
+	ProgressiveModel (const ProgressiveModel& original);
+	ProgressiveModel& operator= (const ProgressiveModel& original);
+
+private:
+	// only used by the thread calling update
+	ObjModel m_model;
+	std::vector<ObjModel::Index> mv_texture_coordinate_indexes;
+	std::vector<ObjModel::Index> mv_normal_indexes;
+
+	// only used by the job reading vertex splits
+	std::ifstream m_input;
+	std::vector<unsigned int> mv_read_face_counts;
+	unsigned long long m_read_vertex_count;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_changed_condition;
+	std::deque<Split> m_queue;
+	std::string m_log;
+	bool m_is_open;
+	bool m_is_reading;
+	bool m_is_failed;
+	bool m_is_stopping;
+	unsigned long long m_split_count;
+	unsigned long long m_loaded_count;
+	unsigned long long m_applied_count;
+	unsigned long long m_target_count;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -0,0 +1,125 @@
+//
+//  Quaternion.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+#include "Vector3.h"
+#include "Matrix44.h"
+#include "Quaternion.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  SLERP_LINEAR_THRESHOLD
+	//
+	//  If the dot product of two Quaternions is above this
+	//    value, getSlerp falls back to getNlerp.  The angle is
+	//    then so small that the results are the same, and
+	//    dividing by its sine would lose precision.
+	//
+	const double SLERP_LINEAR_THRESHOLD = 0.9995;
+}
+
+
+
+Quaternion Quaternion :: getNlerp (const Quaternion& a,
+                                   const Quaternion& b,
+                                   double fraction)
+{
+	assert(a.isNormal());
+	assert(b.isNormal());
+
+	// use -b if it is closer, to take the shortest path
+	double b_factor = (a.dotProduct(b) < 0.0) ? -fraction : fraction;
+	double a_factor = 1.0 - fraction;
+
+	Quaternion result(a.w * a_factor + b.w * b_factor,
+	                  a.x * a_factor + b.x * b_factor,
+	                  a.y * a_factor + b.y * b_factor,
+	                  a.z * a_factor + b.z * b_factor);
+
+	// only happens for opposite rotations at fraction 0.5
+	if(result.getNormSquared() == 0.0)
+		return a;
+	return result.getNormalized();
+}
+
+Quaternion Quaternion :: getSlerp (const Quaternion& a,
+                                   const Quaternion& b,
+                                   double fraction)
+{
+	assert(a.isNormal());
+	assert(b.isNormal());
+
+	double cos_angle = a.dotProduct(b);
+	double sign = 1.0;
+	if(cos_angle < 0.0)
+	{
+		cos_angle = -cos_angle;
+		sign = -1.0;
+	}
+
+	if(cos_angle > SLERP_LINEAR_THRESHOLD)
+		return getNlerp(a, b, fraction);
+
+	double angle     = acos(cos_angle);
+	double sin_angle = sin(angle);
+	double a_factor  = sin((1.0 - fraction) * angle) / sin_angle;
+	double b_factor  = sin(fraction * angle) / sin_angle * sign;
+
+	return Quaternion(a.w * a_factor + b.w * b_factor,
+	                  a.x * a_factor + b.x * b_factor,
+	                  a.y * a_factor + b.y * b_factor,
+	                  a.z * a_factor + b.z * b_factor);
+}
+
+
+
+Matrix44 Quaternion :: getMatrix () const
+{
+	assert(isNormal());
+
+	double xx = x * x;
+	double yy = y * y;
+	double zz = z * z;
+	double xy = x * y;
+	double xz = x * z;
+	double yz = y * z;
+	double wx = w * x;
+	double wy = w * y;
+	double wz = w * z;
+
+	return Matrix44(Vector3(1.0 - 2.0 * (yy + zz),       2.0 * (xy + wz),       2.0 * (xz - wy)),
+	                Vector3(      2.0 * (xy - wz), 1.0 - 2.0 * (xx + zz),       2.0 * (yz + wx)),
+	                Vector3(      2.0 * (xz + wy),       2.0 * (yz - wx), 1.0 - 2.0 * (xx + yy)),
+	                Vector3::ZERO);
+}
+
+
+
+ostream& ObjLibrary :: operator<< (ostream& r_os, const Quaternion& quaternion)
+{
+	r_os << "(" << quaternion.w << ", " << quaternion.x
+	     << ", " << quaternion.y << ", " << quaternion.z << ")";
+	return r_os;
+}
@@ -0,0 +1,399 @@
+//
+//  Quaternion.h
+//
+//  A module to represent rotations as quaternions.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_QUATERNION_H
+#define OBJ_LIBRARY_QUATERNION_H
+
+#include <cassert>
+#include <cmath>
+#include <cfloat>
+#include <iostream>
+
+#include "Vector3.h"
+
+
+
+namespace ObjLibrary
+{
+
+class Matrix44;
+
+
+
+//
+//  Quaternion
+//
+//  A class to store a quaternion (w, x, y, z).  Quaternions of
+//    norm 1 represent rotations.  Unlike rotation matrices,
+//    they can be interpolated smoothly, which makes them
+//    useful for animation.
+//
+//  A rotation of angle a around a normalized axis (ax, ay, az)
+//    is represented by the quaternion
+//      (cos(a/2), ax sin(a/2), ay sin(a/2), az sin(a/2)).
+//    The quaternions q and -q represent the same rotation.
+//
+//  Quaternions are combined like Matrix44s: the rotation
+//    q1 * q2 applies q2 first and then q1.
+//
+class Quaternion
+{
+public:
+//
+//  w
+//  x
+//  y
+//  z
+//
+//  The elements of the Quaternion.  w is the real (scalar)
+//    part.  These values can be queried and changed freely.
+//
+	double w;
+	double x;
+	double y;
+	double z;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new Quaternion representing no
+//           rotation.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new Quaternion is created with value
+//               (1, 0, 0, 0).
+//
+	Quaternion ()
+			: w(1.0), x(0.0), y(0.0), z(0.0)
+	{ }
+
+//
+//  Element Constructor
+//
+//  Purpose: To create a new Quaternion with the specified
+//           elements.
+//  Parameter(s):
+//    <1> W
+//    <2> X
+//    <3> Y
+//    <4> Z: The elements of the Quaternion
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new Quaternion is created with value
+//               (W, X, Y, Z).
+//
+	Quaternion (double W, double X, double Y, double Z)
+			: w(W), x(X), y(Y), z(Z)
+	{ }
+
+//
+//  getRotationArbitrary
+//
+//  Purpose: To create a Quaternion representing a rotation
+//           around an arbitrary axis.
+//  Parameter(s):
+//    <1> axis: The axis to rotate around
+//    <2> radians: The angle to rotate by
+//  Precondition(s):
+//    <1> axis.isFinite()
+//    <2> !axis.isZero()
+//  Returns: A Quaternion of norm 1 that rotates radians
+//           radians around axis, in the same direction as
+//           Vector3::rotateArbitrary.
+//  Side Effect: N/A
+//
+	static Quaternion getRotationArbitrary (const Vector3& axis,
+	                                        double radians)
+	{
+		assert(axis.isFinite());
+		assert(!axis.isZero());
+
+		Vector3 scaled = axis.getNormalized() * sin(radians * 0.5);
+		return Quaternion(cos(radians * 0.5), scaled.x, scaled.y, scaled.z);
+	}
+
+//
+//  getNlerp
+//
+//  Purpose: To interpolate between two Quaternions using
+//           normalized linear interpolation.
+//  Parameter(s):
+//    <1> a: The Quaternion for fraction 0.0
+//    <2> b: The Quaternion for fraction 1.0
+//    <3> fraction: How far to interpolate
+//  Precondition(s):
+//    <1> a.isNormal()
+//    <2> b.isNormal()
+//  Returns: The normalized linear interpolation between a and
+//           the one of b and -b closest to a.  This follows
+//           the shortest path between the rotations, but not
+//           at constant speed.  It is much faster than getSlerp
+//           and is very close to it when a and b are similar.
+//  Side Effect: N/A
+//
+	static Quaternion getNlerp (const Quaternion& a,
+	                            const Quaternion& b,
+	                            double fraction);
+
+//
+//  getSlerp
+//
+//  Purpose: To interpolate between two Quaternions using
+//           spherical linear interpolation.
+//  Parameter(s):
+//    <1> a: The Quaternion for fraction 0.0
+//    <2> b: The Quaternion for fraction 1.0
+//    <3> fraction: How far to interpolate
+//  Precondition(s):
+//    <1> a.isNormal()
+//    <2> b.isNormal()
+//  Returns: The spherical linear interpolation between a and
+//           the one of b and -b closest to a.  This rotates
+//           along the shortest path at constant speed.
+//  Side Effect: N/A
+//
+	static Quaternion getSlerp (const Quaternion& a,
+	                            const Quaternion& b,
+	                            double fraction);
+
+public:
+//
+//  isFinite
+//
+//  Purpose: To determine if all elements of this Quaternion
+//           are finite numbers.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether w, x, y, and z are all finite.
+//  Side Effect: N/A
+//
+	bool isFinite () const
+	{
+		// NaN fails every comparison
+		return w <= DBL_MAX && w >= -DBL_MAX &&
+		       x <= DBL_MAX && x >= -DBL_MAX &&
+		       y <= DBL_MAX && y >= -DBL_MAX &&
+		       z <= DBL_MAX && z >= -DBL_MAX;
+	}
+
+//
+//  getNormSquared
+//
+//  Purpose: To determine the square of the norm of this
+//           Quaternion.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: w * w + x * x + y * y + z * z.
+//  Side Effect: N/A
+//
+	double getNormSquared () const
+	{ return w * w + x * x + y * y + z * z; }
+
+//
+//  getNorm
+//
+//  Purpose: To determine the norm of this Quaternion.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The norm of this Quaternion.
+//  Side Effect: N/A
+//
+	double getNorm () const
+	{ return sqrt(getNormSquared()); }
+
+//
+//  isNormal
+//
+//  Purpose: To determine if this Quaternion has a norm of 1.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this Quaternion has a norm of 1.0 within
+//           VECTOR3_NORM_TOLERANCE.
+//  Side Effect: N/A
+//
+	bool isNormal () const
+	{
+		double norm_squared = getNormSquared();
+		return norm_squared > VECTOR3_ONE_MINUS_NORM_TOLERANCE_SQUARED &&
+		       norm_squared < VECTOR3_NORM_TOLERANCE_PLUS_ONE_SQUARED;
+	}
+
+//
+//  dotProduct
+//
+//  Purpose: To calculate the 4D dot product of this Quaternion
+//           and another.
+//  Parameter(s):
+//    <1> other: The other Quaternion
+//  Precondition(s): N/A
+//  Returns: The dot product.  For Quaternions of norm 1, this
+//           is the cosine of half the angle between the
+//           rotations.
+//  Side Effect: N/A
+//
+	double dotProduct (const Quaternion& other) const
+	{ return w * other.w + x * other.x + y * other.y + z * other.z; }
+
+//
+//  getNormalized
+//
+//  Purpose: To create a copy of this Quaternion with a norm
+//           of 1.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> getNormSquared() > 0.0
+//  Returns: This Quaternion divided by its norm.
+//  Side Effect: N/A
+//
+	Quaternion getNormalized () const
+	{
+		assert(getNormSquared() > 0.0);
+
+		double factor = 1.0 / getNorm();
+		return Quaternion(w * factor, x * factor, y * factor, z * factor);
+	}
+
+//
+//  getConjugate
+//
+//  Purpose: To calculate the conjugate of this Quaternion.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: (w, -x, -y, -z).  For a Quaternion of norm 1, this
+//           is the inverse rotation.
+//  Side Effect: N/A
+//
+	Quaternion getConjugate () const
+	{ return Quaternion(w, -x, -y, -z); }
+
+//
+//  getRotated
+//
+//  Purpose: To rotate a Vector3 by this Quaternion.
+//  Parameter(s):
+//    <1> vector: The Vector3 to rotate
+//  Precondition(s):
+//    <1> isNormal()
+//    <2> vector.isFinite()
+//  Returns: vector rotated by this Quaternion.
+//  Side Effect: N/A
+//
+	Vector3 getRotated (const Vector3& vector) const
+	{
+		assert(isNormal());
+		assert(vector.isFinite());
+
+		// v' = v + 2w(q x v) + 2(q x (q x v)), where q = (x, y, z)
+		Vector3 q(x, y, z);
+		Vector3 t = q.crossProduct(vector) * 2.0;
+		return vector + t * w + q.crossProduct(t);
+	}
+
+//
+//  getMatrix
+//
+//  Purpose: To create the rotation matrix for this Quaternion.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isNormal()
+//  Returns: A Matrix44 that performs the same rotation as this
+//           Quaternion.
+//  Side Effect: N/A
+//
+	Matrix44 getMatrix () const;
+
+//
+//  Multiplication Operator
+//
+//  Purpose: To combine this Quaternion with another.
+//  Parameter(s):
+//    <1> right: The Quaternion to apply first
+//  Precondition(s): N/A
+//  Returns: The Hamilton product of this Quaternion and right.
+//  Side Effect: N/A
+//
+	Quaternion operator* (const Quaternion& right) const
+	{
+		return Quaternion(w * right.w - x * right.x - y * right.y - z * right.z,
+		                  w * right.x + x * right.w + y * right.z - z * right.y,
+		                  w * right.y - x * right.z + y * right.w + z * right.x,
+		                  w * right.z + x * right.y - y * right.x + z * right.w);
+	}
+
+//
+//  normalize
+//
+//  Purpose: To change this Quaternion to have a norm of 1.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> getNormSquared() > 0.0
+//  Returns: N/A
+//  Side Effect: This Quaternion is divided by its norm.
+//
+	void normalize ()
+	{
+		assert(getNormSquared() > 0.0);
+
+		*this = getNormalized();
+	}
+
+//
+//  Multiplication Assignment Operator
+//
+//  Purpose: To combine this Quaternion with another.
+//  Parameter(s):
+//    <1> right: The Quaternion to apply first
+//  Precondition(s): N/A
+//  Returns: A reference to this Quaternion.
+//  Side Effect: This Quaternion is set to the product of this
+//               Quaternion and right.
+//
+	Quaternion& operator*= (const Quaternion& right)
+	{
+		*this = *this * right;
+		return *this;
+	}
+};
+
+
+
+//
+//  Stream Insertion Operator
+//
+//  Purpose: To print the specified Quaternion to the specified
+//           output stream.
+//  Parameter(s):
+//    <1> r_os: The output stream
+//    <2> quaternion: The Quaternion
+//  Precondition(s): N/A
+//  Returns: A reference to r_os.
+//  Side Effect: quaternion is printed to r_os.
+//
+std::ostream& operator<< (std::ostream& r_os,
+                          const Quaternion& quaternion);
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -0,0 +1,467 @@
+//
+//  SceneGraph.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <algorithm>
+#include <vector>
+
+#include "Matrix44.h"
+#include "Vector3.h"
+#include "Vector3Array.h"
+#include "ObjModel.h"
+#include "OcclusionCuller.h"
+#include "SceneGraph.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  DepthLess
+	//
+	//  A function object to compare node indexes by depth, for
+	//    sorting.
+	//
+	struct DepthLess
+	{
+		const vector<unsigned int>& mv_depths;
+
+		DepthLess (const vector<unsigned int>& v_depths)
+				: mv_depths(v_depths)
+		{ }
+
+		bool operator() (unsigned int a, unsigned int b) const
+		{ return mv_depths[a] < mv_depths[b]; }
+	};
+}
+
+
+
+const unsigned int SceneGraph :: NO_NODE;
+
+
+
+SceneGraph :: SceneGraph ()
+		: m_dirty_count(0),
+		  m_is_depth_sorted(true)
+{
+	assert(invariant());
+}
+
+
+
+bool SceneGraph :: isNode (unsigned int node) const
+{
+	return node < mv_handle_indexes.size() &&
+	       mv_handle_indexes[node] != NO_NODE;
+}
+
+unsigned int SceneGraph :: getParent (unsigned int node) const
+{
+	assert(isNode(node));
+
+	unsigned int parent = mv_parents[getIndex(node)];
+	if(parent == NO_NODE)
+		return NO_NODE;
+	return mv_handles[parent];
+}
+
+unsigned int SceneGraph :: getDepth (unsigned int node) const
+{
+	assert(isNode(node));
+
+	return mv_depths[getIndex(node)];
+}
+
+const Matrix44& SceneGraph :: getLocalTransform (unsigned int node) const
+{
+	assert(isNode(node));
+
+	return mv_local_transforms[getIndex(node)];
+}
+
+const Matrix44& SceneGraph :: getWorldTransform (unsigned int node) const
+{
+	assert(isNode(node));
+
+	return mv_world_transforms[getIndex(node)];
+}
+
+const ObjModel* SceneGraph :: getModel (unsigned int node) const
+{
+	assert(isNode(node));
+
+	return mv_models[getIndex(node)];
+}
+
+void SceneGraph :: draw (const Matrix44& view) const
+{
+	assert(!isDirty());
+
+	for(unsigned int i = 0; i < mv_models.size(); i++)
+	{
+		if(mv_models[i] == NULL)
+			continue;
+
+		(view * mv_world_transforms[i]).loadToOpenGL();
+		mv_models[i]->draw();
+	}
+
+	view.loadToOpenGL();
+}
+
+void SceneGraph :: draw (const Matrix44& view,
+                         const OcclusionCuller& culler) const
+{
+	assert(!isDirty());
+	assert(culler.isRasterized());
+
+	// world bounding boxes, only for nodes with models
+	vector<unsigned int> v_indexes;
+	Vector3Array<float> box_mins;
+	Vector3Array<float> box_maxes;
+	for(unsigned int i = 0; i < mv_models.size(); i++)
+	{
+		if(mv_models[i] == NULL)
+			continue;
+
+		const Matrix44& world = mv_world_transforms[i];
+		Vector3 model_min = mv_models[i]->getBoundingBoxMin();
+		Vector3 model_max = mv_models[i]->getBoundingBoxMax();
+		Vector3 world_min = world.getTransformedPoint(model_min);
+		Vector3 world_max = world_min;
+		for(unsigned int c = 1; c < 8; c++)
+		{
+			Vector3 corner((c & 1) ? model_max.x : model_min.x,
+			               (c & 2) ? model_max.y : model_min.y,
+			               (c & 4) ? model_max.z : model_min.z);
+			Vector3 transformed = world.getTransformedPoint(corner);
+			world_min.x = min(world_min.x, transformed.x);
+			world_min.y = min(world_min.y, transformed.y);
+			world_min.z = min(world_min.z, transformed.z);
+			world_max.x = max(world_max.x, transformed.x);
+			world_max.y = max(world_max.y, transformed.y);
+			world_max.z = max(world_max.z, transformed.z);
+		}
+
+		v_indexes.push_back(i);
+		box_mins.pushBack(world_min);
+		box_maxes.pushBack(world_max);
+	}
+
+	vector<unsigned char> v_visible;
+	culler.testBoxes(box_mins, box_maxes, v_visible);
+
+	for(unsigned int b = 0; b < v_indexes.size(); b++)
+	{
+		if(!v_visible[b])
+			continue;
+
+		unsigned int i = v_indexes[b];
+		(view * mv_world_transforms[i]).loadToOpenGL();
+		mv_models[i]->draw();
+	}
+
+	view.loadToOpenGL();
+}
+
+
+
+unsigned int SceneGraph :: addNode (unsigned int parent,
+                                    const Matrix44& local,
+                                    const ObjModel* p_model)
+{
+	assert(parent == NO_NODE || isNode(parent));
+
+	unsigned int handle;
+	if(mv_free_handles.empty())
+	{
+		handle = (unsigned int)(mv_handle_indexes.size());
+		mv_handle_indexes.push_back(NO_NODE);
+	}
+	else
+	{
+		handle = mv_free_handles.back();
+		mv_free_handles.pop_back();
+	}
+
+	// adding at the end keeps parents before children
+	unsigned int index = getNodeCount();
+	unsigned int parent_index = (parent == NO_NODE) ? NO_NODE : getIndex(parent);
+	unsigned int depth = (parent == NO_NODE) ? 0 : mv_depths[parent_index] + 1;
+	if(index > 0 && depth < mv_depths.back())
+		m_is_depth_sorted = false;
+
+	mv_handle_indexes[handle] = index;
+	mv_handles.push_back(handle);
+	mv_parents.push_back(parent_index);
+	mv_depths.push_back(depth);
+	mv_local_transforms.push_back(local);
+	mv_world_transforms.push_back(local);
+	mv_models.push_back(p_model);
+	mv_dirty.push_back(0);
+	markDirty(index);
+
+	assert(invariant());
+	return handle;
+}
+
+void SceneGraph :: setLocalTransform (unsigned int node,
+                                      const Matrix44& local)
+{
+	assert(isNode(node));
+
+	unsigned int index = getIndex(node);
+	mv_local_transforms[index] = local;
+	markDirty(index);
+}
+
+void SceneGraph :: setModel (unsigned int node, const ObjModel* p_model)
+{
+	assert(isNode(node));
+
+	mv_models[getIndex(node)] = p_model;
+}
+
+void SceneGraph :: setParent (unsigned int node, unsigned int parent)
+{
+	assert(isNode(node));
+	assert(parent == NO_NODE || isNode(parent));
+
+	unsigned int index = getIndex(node);
+	unsigned int parent_index = (parent == NO_NODE) ? NO_NODE : getIndex(parent);
+
+#ifndef NDEBUG
+	// check that parent is not in the subtree
+	for(unsigned int i = parent_index; i != NO_NODE; i = mv_parents[i])
+		assert(i != index);
+#endif
+
+	mv_parents[index] = parent_index;
+	markDirty(index);
+
+	// the parent may now come after the child
+	sortByDepth();
+
+	assert(invariant());
+}
+
+void SceneGraph :: removeNode (unsigned int node)
+{
+	assert(isNode(node));
+
+	unsigned int first = getIndex(node);
+	unsigned int count = getNodeCount();
+
+	// parents come first, so one pass finds all descendants
+	vector<unsigned char> v_removed(count, 0);
+	v_removed[first] = 1;
+	for(unsigned int i = first + 1; i < count; i++)
+		if(mv_parents[i] != NO_NODE && v_removed[mv_parents[i]])
+			v_removed[i] = 1;
+
+	vector<unsigned int> v_new_indexes(count, NO_NODE);
+	unsigned int kept = 0;
+	for(unsigned int i = 0; i < count; i++)
+	{
+		if(v_removed[i])
+		{
+			mv_handle_indexes[mv_handles[i]] = NO_NODE;
+			mv_free_handles.push_back(mv_handles[i]);
+			if(mv_dirty[i])
+				m_dirty_count--;
+			continue;
+		}
+
+		v_new_indexes[i] = kept;
+		mv_handles[kept]          = mv_handles[i];
+		mv_parents[kept]          = (mv_parents[i] == NO_NODE) ? NO_NODE : v_new_indexes[mv_parents[i]];
+		mv_depths[kept]           = mv_depths[i];
+		mv_local_transforms[kept] = mv_local_transforms[i];
+		mv_world_transforms[kept] = mv_world_transforms[i];
+		mv_models[kept]           = mv_models[i];
+		mv_dirty[kept]            = mv_dirty[i];
+		mv_handle_indexes[mv_handles[kept]] = kept;
+		kept++;
+	}
+
+	mv_handles.resize(kept);
+	mv_parents.resize(kept);
+	mv_depths.resize(kept);
+	mv_local_transforms.resize(kept);
+	mv_world_transforms.resize(kept);
+	mv_models.resize(kept);
+	mv_dirty.resize(kept);
+
+	assert(invariant());
+}
+
+void SceneGraph :: clear ()
+{
+	mv_handles.clear();
+	mv_parents.clear();
+	mv_depths.clear();
+	mv_local_transforms.clear();
+	mv_world_transforms.clear();
+	mv_models.clear();
+	mv_dirty.clear();
+	mv_handle_indexes.clear();
+	mv_free_handles.clear();
+	m_dirty_count = 0;
+	m_is_depth_sorted = true;
+
+	assert(invariant());
+}
+
+void SceneGraph :: update ()
+{
+	if(!m_is_depth_sorted)
+		sortByDepth();
+	if(m_dirty_count == 0)
+		return;
+
+	unsigned int count = getNodeCount();
+	for(unsigned int i = 0; i < count; i++)
+	{
+		unsigned int parent = mv_parents[i];
+		if(parent == NO_NODE)
+		{
+			if(mv_dirty[i])
+				mv_world_transforms[i] = mv_local_transforms[i];
+		}
+		else
+		{
+			// parents come first, so their flags are final
+			if(mv_dirty[parent])
+				mv_dirty[i] = 1;
+			if(mv_dirty[i])
+				mv_world_transforms[i] = mv_world_transforms[parent] * mv_local_transforms[i];
+		}
+	}
+
+	fill(mv_dirty.begin(), mv_dirty.end(), (unsigned char)(0));
+	m_dirty_count = 0;
+
+	assert(invariant());
+}
+
+
+
+unsigned int SceneGraph :: getIndex (unsigned int node) const
+{
+	assert(isNode(node));
+
+	return mv_handle_indexes[node];
+}
+
+void SceneGraph :: markDirty (unsigned int index)
+{
+	assert(index < getNodeCount());
+
+	if(!mv_dirty[index])
+	{
+		mv_dirty[index] = 1;
+		m_dirty_count++;
+	}
+}
+
+void SceneGraph :: sortByDepth ()
+{
+	unsigned int count = getNodeCount();
+
+	// the order may be wrong, so follow each parent chain
+	vector<unsigned int> v_depths(count, NO_NODE);
+	vector<unsigned int> v_chain;
+	for(unsigned int i = 0; i < count; i++)
+	{
+		unsigned int current = i;
+		while(current != NO_NODE && v_depths[current] == NO_NODE)
+		{
+			v_chain.push_back(current);
+			current = mv_parents[current];
+		}
+
+		unsigned int depth = (current == NO_NODE) ? 0 : v_depths[current] + 1;
+		while(!v_chain.empty())
+		{
+			v_depths[v_chain.back()] = depth;
+			v_chain.pop_back();
+			depth++;
+		}
+	}
+
+	vector<unsigned int> v_order(count);
+	for(unsigned int i = 0; i < count; i++)
+		v_order[i] = i;
+	stable_sort(v_order.begin(), v_order.end(), DepthLess(v_depths));
+
+	vector<unsigned int> v_new_indexes(count);
+	for(unsigned int i = 0; i < count; i++)
+		v_new_indexes[v_order[i]] = i;
+
+	vector<unsigned int>    v_handles(count);
+	vector<unsigned int>    v_parents(count);
+	vector<Matrix44>        v_local_transforms(count);
+	vector<Matrix44>        v_world_transforms(count);
+	vector<const ObjModel*> v_models(count);
+	vector<unsigned char>   v_dirty(count);
+	for(unsigned int i = 0; i < count; i++)
+	{
+		unsigned int old = v_order[i];
+		v_handles[i]          = mv_handles[old];
+		v_parents[i]          = (mv_parents[old] == NO_NODE) ? NO_NODE : v_new_indexes[mv_parents[old]];
+		v_local_transforms[i] = mv_local_transforms[old];
+		v_world_transforms[i] = mv_world_transforms[old];
+		v_models[i]           = mv_models[old];
+		v_dirty[i]            = mv_dirty[old];
+		mv_handle_indexes[v_handles[i]] = i;
+		mv_depths[i]          = v_depths[old];
+	}
+
+	mv_handles.swap(v_handles);
+	mv_parents.swap(v_parents);
+	mv_local_transforms.swap(v_local_transforms);
+	mv_world_transforms.swap(v_world_transforms);
+	mv_models.swap(v_models);
+	mv_dirty.swap(v_dirty);
+	m_is_depth_sorted = true;
+}
+
+bool SceneGraph :: invariant () const
+{
+	unsigned int count = getNodeCount();
+	if(mv_parents.size()          != count) return false;
+	if(mv_depths.size()           != count) return false;
+	if(mv_local_transforms.size() != count) return false;
+	if(mv_world_transforms.size() != count) return false;
+	if(mv_models.size()           != count) return false;
+	if(mv_dirty.size()            != count) return false;
+	if(mv_handle_indexes.size() != count + mv_free_handles.size()) return false;
+
+	unsigned int dirty_count = 0;
+	for(unsigned int i = 0; i < count; i++)
+	{
+		if(mv_parents[i] != NO_NODE && mv_parents[i] >= i) return false;
+		if(mv_handle_indexes[mv_handles[i]] != i) return false;
+		if(mv_dirty[i])
+			dirty_count++;
+	}
+	if(dirty_count != m_dirty_count) return false;
+	return true;
+}
@@ -0,0 +1,420 @@
+//
+//  SceneGraph.h
+//
+//  A module to store a hierarchy of transformed models.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_SCENE_GRAPH_H
+#define OBJ_LIBRARY_SCENE_GRAPH_H
+
+#include <vector>
+
+#include "Matrix44.h"
+
+
+
+namespace ObjLibrary
+{
+
+class ObjModel;
+class OcclusionCuller;
+
+
+
+//
+//  SceneGraph
+//
+//  A class to store a hierarchy of nodes.  Each node has a
+//    parent (or none), a local transform relative to its
+//    parent, a world transform, and optionally an ObjModel to
+//    draw.  The world transform of a node is the world
+//    transform of its parent times its local transform.
+//
+//  The world transforms are cached.  Changing a local
+//    transform marks the node as dirty, and update recomputes
+//    the world transforms for the dirty nodes and their
+//    descendants only.  If nothing is dirty, update does
+//    nothing.
+//
+//  The nodes are stored in flat arrays in which every parent
+//    comes before its children.  update and draw are then
+//    single passes through the arrays in order.  New nodes are
+//    added at the end, and the arrays are sorted by depth again
+//    by the next update or when a node is moved to a different
+//    parent.
+//
+//  Nodes are identified by handles, which stay the same when
+//    the nodes are reordered.  A handle is reused after its
+//    node is removed.
+//
+//  The SceneGraph does not own the ObjModels.  They must not
+//    be destroyed while nodes refer to them.
+//
+class SceneGraph
+{
+public:
+//
+//  NO_NODE
+//
+//  A handle value that does not refer to any node.  It is used
+//    as the parent of root nodes.
+//
+	static const unsigned int NO_NODE = 0xFFFFFFFF;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new, empty SceneGraph.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new SceneGraph is created with no nodes.
+//
+	SceneGraph ();
+
+//
+//  getNodeCount
+//
+//  Purpose: To determine the number of nodes.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of nodes in this SceneGraph.
+//  Side Effect: N/A
+//
+	unsigned int getNodeCount () const
+	{ return (unsigned int)(mv_handles.size()); }
+
+//
+//  isNode
+//
+//  Purpose: To determine if a handle refers to a node.
+//  Parameter(s):
+//    <1> node: The handle
+//  Precondition(s): N/A
+//  Returns: Whether node refers to a node in this SceneGraph.
+//  Side Effect: N/A
+//
+	bool isNode (unsigned int node) const;
+
+//
+//  isDirty
+//
+//  Purpose: To determine if any world transforms are out of
+//           date.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether any local transform has changed since the
+//           last call to update.
+//  Side Effect: N/A
+//
+	bool isDirty () const
+	{ return m_dirty_count > 0; }
+
+//
+//  getParent
+//
+//  Purpose: To determine the parent of a node.
+//  Parameter(s):
+//    <1> node: The node
+//  Precondition(s):
+//    <1> isNode(node)
+//  Returns: The parent of node node, or NO_NODE if it is a
+//           root node.
+//  Side Effect: N/A
+//
+	unsigned int getParent (unsigned int node) const;
+
+//
+//  getDepth
+//
+//  Purpose: To determine the depth of a node.
+//  Parameter(s):
+//    <1> node: The node
+//  Precondition(s):
+//    <1> isNode(node)
+//  Returns: The number of ancestors of node node.  Root nodes
+//           have depth 0.
+//  Side Effect: N/A
+//
+	unsigned int getDepth (unsigned int node) const;
+
+//
+//  getLocalTransform
+//
+//  Purpose: To retrieve the local transform of a node.
+//  Parameter(s):
+//    <1> node: The node
+//  Precondition(s):
+//    <1> isNode(node)
+//  Returns: The transform of node node relative to its parent.
+//  Side Effect: N/A
+//
+	const Matrix44& getLocalTransform (unsigned int node) const;
+
+//
+//  getWorldTransform
+//
+//  Purpose: To retrieve the world transform of a node.
+//  Parameter(s):
+//    <1> node: The node
+//  Precondition(s):
+//    <1> isNode(node)
+//  Returns: The transform of node node relative to the world,
+//           as of the last call to update.
+//  Side Effect: N/A
+//
+	const Matrix44& getWorldTransform (unsigned int node) const;
+
+//
+//  getModel
+//
+//  Purpose: To retrieve the ObjModel for a node.
+//  Parameter(s):
+//    <1> node: The node
+//  Precondition(s):
+//    <1> isNode(node)
+//  Returns: The ObjModel drawn at node node, or NULL if there
+//           is none.
+//  Side Effect: N/A
+//
+	const ObjModel* getModel (unsigned int node) const;
+
+//
+//  draw
+//
+//  Purpose: To display all the nodes with ObjModels.
+//  Parameter(s):
+//    <1> view: The camera (view) transform
+//  Precondition(s):
+//    <1> !isDirty()
+//    <2> The ObjModels are valid
+//  Returns: N/A
+//  Side Effect: Each ObjModel is drawn with the OpenGL
+//               modelview matrix set to view times the world
+//               transform of its node.  Afterwards, the
+//               modelview matrix is set to view.
+//
+	void draw (const Matrix44& view) const;
+
+//
+//  draw
+//
+//  Purpose: To display the nodes with ObjModels that are not
+//           hidden behind occluders.
+//  Parameter(s):
+//    <1> view: The camera (view) transform
+//    <2> culler: The OcclusionCuller to test the nodes with
+//  Precondition(s):
+//    <1> !isDirty()
+//    <2> The ObjModels are valid
+//    <3> culler.isRasterized()
+//    <4> culler.getViewProjection() is the projection matrix
+//        times view
+//  Returns: N/A
+//  Side Effect: The world bounding box of each ObjModel is
+//               tested against culler in a single batch.  The
+//               ObjModels that may be visible are then drawn
+//               as for the other draw function.  Afterwards,
+//               the modelview matrix is set to view.
+//
+	void draw (const Matrix44& view,
+	           const OcclusionCuller& culler) const;
+
+//
+//  addNode
+//
+//  Purpose: To add a node.
+//  Parameter(s):
+//    <1> parent: The parent for the new node
+//    <2> local: The transform relative to the parent
+//    <3> p_model: The ObjModel to draw at the new node
+//  Precondition(s):
+//    <1> parent == NO_NODE || isNode(parent)
+//  Returns: The handle for the new node.
+//  Side Effect: A new node is added as a child of parent, or as
+//               a root node if parent is NO_NODE.  If p_model
+//               is NULL, nothing is drawn for the node.
+//
+	unsigned int addNode (unsigned int parent,
+	                      const Matrix44& local,
+	                      const ObjModel* p_model = NULL);
+
+//
+//  setLocalTransform
+//
+//  Purpose: To change the local transform of a node.
+//  Parameter(s):
+//    <1> node: The node
+//    <2> local: The new transform relative to the parent
+//  Precondition(s):
+//    <1> isNode(node)
+//  Returns: N/A
+//  Side Effect: Node node is set to have local transform local
+//               and is marked as dirty.
+//
+	void setLocalTransform (unsigned int node,
+	                        const Matrix44& local);
+
+//
+//  setModel
+//
+//  Purpose: To change the ObjModel for a node.
+//  Parameter(s):
+//    <1> node: The node
+//    <2> p_model: The ObjModel to draw
+//  Precondition(s):
+//    <1> isNode(node)
+//  Returns: N/A
+//  Side Effect: Node node is set to draw p_model.  If p_model
+//               is NULL, nothing is drawn for node node.
+//
+	void setModel (unsigned int node, const ObjModel* p_model);
+
+//
+//  setParent
+//
+//  Purpose: To move a node to a different parent.
+//  Parameter(s):
+//    <1> node: The node
+//    <2> parent: The new parent
+//  Precondition(s):
+//    <1> isNode(node)
+//    <2> parent == NO_NODE || isNode(parent)
+//    <3> parent is not node or a descendant of node
+//  Returns: N/A
+//  Side Effect: Node node and its descendants are moved to be a
+//               child of parent.  The local transform is not
+//               changed, so the world transform will be.  The
+//               nodes are reordered by depth.
+//
+	void setParent (unsigned int node, unsigned int parent);
+
+//
+//  removeNode
+//
+//  Purpose: To remove a node and all its descendants.
+//  Parameter(s):
+//    <1> node: The node
+//  Precondition(s):
+//    <1> isNode(node)
+//  Returns: N/A
+//  Side Effect: Node node and its descendants are removed.
+//               Their handles become invalid.
+//
+	void removeNode (unsigned int node);
+
+//
+//  clear
+//
+//  Purpose: To remove all nodes.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All nodes are removed.
+//
+	void clear ();
+
+//
+//  update
+//
+//  Purpose: To recalculate the out-of-date world transforms.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If nodes have been added, the nodes are sorted
+//               by depth.  The world transform is recalculated
+//               for each dirty node and its descendants.  No
+//               nodes are dirty afterwards.
+//
+	void update ();
+
+private:
+//
+//  getIndex
+//
+//  Purpose: To find where a node is stored.
+//  Parameter(s):
+//    <1> node: The node
+//  Precondition(s):
+//    <1> isNode(node)
+//  Returns: The index of node node in the node arrays.
+//  Side Effect: N/A
+//
+	unsigned int getIndex (unsigned int node) const;
+
+//
+//  markDirty
+//
+//  Purpose: To mark a node as dirty.
+//  Parameter(s):
+//    <1> index: The index of the node
+//  Precondition(s):
+//    <1> index < getNodeCount()
+//  Returns: N/A
+//  Side Effect: The node at index index is marked as dirty.
+//
+	void markDirty (unsigned int index);
+
+//
+//  sortByDepth
+//
+//  Purpose: To reorder the nodes so that all parents come
+//           before their children.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The depths are recalculated and the node arrays
+//               are sorted by depth.  Nodes of the same depth
+//               stay in the same order.
+//
+	void sortByDepth ();
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	// the node arrays, with parents before children
+	std::vector<unsigned int> mv_handles;
+	std::vector<unsigned int> mv_parents;  // indexes, not handles
+	std::vector<unsigned int> mv_depths;
+	std::vector<Matrix44> mv_local_transforms;
+	std::vector<Matrix44> mv_world_transforms;
+	std::vector<const ObjModel*> mv_models;
+	std::vector<unsigned char> mv_dirty;
+
+	// index for each handle, or NO_NODE if the handle is free
+	std::vector<unsigned int> mv_handle_indexes;
+	std::vector<unsigned int> mv_free_handles;
+	unsigned int m_dirty_count;
+	bool m_is_depth_sorted;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -0,0 +1,162 @@
+//
+//  Script.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <functional>
+#include <vector>
+
+#include "Vector3.h"
+#include "Script.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+const unsigned int Script :: EASE_LINEAR;
+const unsigned int Script :: EASE_IN;
+const unsigned int Script :: EASE_OUT;
+const unsigned int Script :: EASE_IN_OUT;
+const unsigned int Script :: EASE_COUNT;
+const unsigned int Script :: STEP_WAIT;
+const unsigned int Script :: STEP_TWEEN_DOUBLE;
+const unsigned int Script :: STEP_TWEEN_VECTOR3;
+const unsigned int Script :: STEP_CALL;
+
+
+
+double Script :: getEased (double fraction, unsigned int easing)
+{
+	assert(fraction >= 0.0);
+	assert(fraction <= 1.0);
+	assert(easing < EASE_COUNT);
+
+	switch(easing)
+	{
+	case EASE_IN:
+		return fraction * fraction;
+	case EASE_OUT:
+		return fraction * (2.0 - fraction);
+	case EASE_IN_OUT:
+		return fraction * fraction * (3.0 - 2.0 * fraction);
+	default:
+		return fraction;
+	}
+}
+
+
+
+Script :: Script ()
+		: m_is_repeating(false)
+{
+}
+
+bool Script :: isTimed () const
+{
+	for(unsigned int i = 0; i < mv_steps.size(); i++)
+		if(mv_steps[i].m_type != STEP_CALL && mv_steps[i].m_seconds > 0.0)
+			return true;
+	return false;
+}
+
+Script& Script :: wait (double seconds)
+{
+	assert(seconds >= 0.0);
+
+	Step step;
+	step.m_type           = STEP_WAIT;
+	step.m_seconds        = seconds;
+	step.m_easing         = EASE_LINEAR;
+	step.mp_double        = NULL;
+	step.m_double_target  = 0.0;
+	step.mp_vector3       = NULL;
+	mv_steps.push_back(step);
+	return *this;
+}
+
+Script& Script :: tween (double* p_value,
+                         double target,
+                         double seconds,
+                         unsigned int easing)
+{
+	assert(p_value != NULL);
+	assert(seconds >= 0.0);
+	assert(easing < EASE_COUNT);
+
+	Step step;
+	step.m_type           = STEP_TWEEN_DOUBLE;
+	step.m_seconds        = seconds;
+	step.m_easing         = easing;
+	step.mp_double        = p_value;
+	step.m_double_target  = target;
+	step.mp_vector3       = NULL;
+	mv_steps.push_back(step);
+	return *this;
+}
+
+Script& Script :: tween (Vector3* p_value,
+                         const Vector3& target,
+                         double seconds,
+                         unsigned int easing)
+{
+	assert(p_value != NULL);
+	assert(seconds >= 0.0);
+	assert(easing < EASE_COUNT);
+
+	Step step;
+	step.m_type           = STEP_TWEEN_VECTOR3;
+	step.m_seconds        = seconds;
+	step.m_easing         = easing;
+	step.mp_double        = NULL;
+	step.m_double_target  = 0.0;
+	step.mp_vector3       = p_value;
+	step.m_vector3_target = target;
+	mv_steps.push_back(step);
+	return *this;
+}
+
+Script& Script :: call (const function<void ()>& function)
+{
+	assert(function);
+
+	Step step;
+	step.m_type           = STEP_CALL;
+	step.m_seconds        = 0.0;
+	step.m_easing         = EASE_LINEAR;
+	step.mp_double        = NULL;
+	step.m_double_target  = 0.0;
+	step.mp_vector3       = NULL;
+	step.m_function       = function;
+	mv_steps.push_back(step);
+	return *this;
+}
+
+Script& Script :: repeat ()
+{
+	assert(isTimed());
+
+	m_is_repeating = true;
+	return *this;
+}
+
+void Script :: clear ()
+{
+	mv_steps.clear();
+	m_is_repeating = false;
+}
@@ -0,0 +1,283 @@
+//
+//  Script.h
+//
+//  A module to describe a timed sequence of actions.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_SCRIPT_H
+#define OBJ_LIBRARY_SCRIPT_H
+
+#include <vector>
+#include <functional>
+
+#include "Vector3.h"
+
+
+
+namespace ObjLibrary
+{
+
+class ScriptScheduler;
+
+
+
+//
+//  Script
+//
+//  A class to describe a sequence of steps to run over time.
+//    A Script does nothing by itself; it is run by passing it
+//    to ScriptScheduler::start.  The steps are:
+//      <1> wait: Do nothing for a number of seconds
+//      <2> tween: Change a value smoothly from whatever it is
+//          when the step starts to a target value over a
+//          number of seconds
+//      <3> call: Call a function
+//    Each step starts when the previous one ends.  A Script
+//    can be set to repeat from the first step after the last
+//    one ends.
+//
+//  The functions that add steps return a reference to the
+//    Script, so they can be chained:
+//
+//      Script blink;
+//      blink.tween(&brightness, 1.0, 0.5)
+//           .wait(2.0)
+//           .tween(&brightness, 0.0, 0.5)
+//           .repeat();
+//
+//  A ScriptScheduler only does work for a running Script when
+//    one of its steps starts or ends, or while it is tweening.
+//    A Script that is waiting costs nothing per frame.
+//
+class Script
+{
+public:
+//
+//  EASE_LINEAR
+//  EASE_IN
+//  EASE_OUT
+//  EASE_IN_OUT
+//
+//  Constants to indicate how a tween moves between its start
+//    and end values.  EASE_LINEAR moves at a constant speed,
+//    EASE_IN starts slowly, EASE_OUT ends slowly, and
+//    EASE_IN_OUT starts and ends slowly.
+//
+	static const unsigned int EASE_LINEAR = 0;
+	static const unsigned int EASE_IN     = 1;
+	static const unsigned int EASE_OUT    = 2;
+	static const unsigned int EASE_IN_OUT = 3;
+	static const unsigned int EASE_COUNT  = 4;
+
+//
+//  getEased
+//
+//  Purpose: To apply an easing curve to a fraction.
+//  Parameter(s):
+//    <1> fraction: The fraction of the tween time that has
+//                  passed
+//    <2> easing: The easing curve
+//  Precondition(s):
+//    <1> fraction >= 0.0
+//    <2> fraction <= 1.0
+//    <3> easing < EASE_COUNT
+//  Returns: How far the tween value should be from its start
+//           value to its end value, from 0.0 to 1.0.
+//  Side Effect: N/A
+//
+	static double getEased (double fraction, unsigned int easing);
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new Script with no steps.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new, empty Script is created.  It does not
+//               repeat.
+//
+	Script ();
+
+//
+//  getStepCount
+//
+//  Purpose: To determine the number of steps in this Script.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of steps.
+//  Side Effect: N/A
+//
+	unsigned int getStepCount () const
+	{ return (unsigned int)(mv_steps.size()); }
+
+//
+//  isRepeating
+//
+//  Purpose: To determine if this Script repeats.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this Script starts over after its last
+//           step.
+//  Side Effect: N/A
+//
+	bool isRepeating () const
+	{ return m_is_repeating; }
+
+//
+//  isTimed
+//
+//  Purpose: To determine if this Script takes any time to run.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this Script contains a wait or tween step
+//           with a duration greater than 0.0.  A repeating
+//           Script must be timed, or it would never finish a
+//           frame.
+//  Side Effect: N/A
+//
+	bool isTimed () const;
+
+//
+//  wait
+//
+//  Purpose: To add a step that waits.
+//  Parameter(s):
+//    <1> seconds: How long to wait
+//  Precondition(s):
+//    <1> seconds >= 0.0
+//  Returns: A reference to this Script.
+//  Side Effect: A wait step is added to the end of this Script.
+//
+	Script& wait (double seconds);
+
+//
+//  tween
+//
+//  Purpose: To add a step that changes a value smoothly.
+//  Parameter(s):
+//    <1> p_value: A pointer to the value to change
+//    <2> target: The value to end at
+//    <3> seconds: How long the change takes
+//    <4> easing: The easing curve to use
+//  Precondition(s):
+//    <1> p_value != NULL
+//    <2> seconds >= 0.0
+//    <3> easing < EASE_COUNT
+//    <4> p_value must remain valid while a ScriptScheduler is
+//        running this Script
+//  Returns: A reference to this Script.
+//  Side Effect: A tween step is added to the end of this
+//               Script.  When the step starts, *p_value is
+//               remembered.  It is then set every update until
+//               it reaches target.
+//
+	Script& tween (double* p_value,
+	               double target,
+	               double seconds,
+	               unsigned int easing = EASE_LINEAR);
+	Script& tween (Vector3* p_value,
+	               const Vector3& target,
+	               double seconds,
+	               unsigned int easing = EASE_LINEAR);
+
+//
+//  call
+//
+//  Purpose: To add a step that calls a function.
+//  Parameter(s):
+//    <1> function: The function to call
+//  Precondition(s):
+//    <1> function
+//  Returns: A reference to this Script.
+//  Side Effect: A call step is added to the end of this Script.
+//               function may start or stop Scripts, including
+//               the one calling it.
+//
+	Script& call (const std::function<void ()>& function);
+
+//
+//  repeat
+//
+//  Purpose: To make this Script repeat forever.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isTimed()
+//  Returns: A reference to this Script.
+//  Side Effect: This Script is set to start over after its last
+//               step.  It will run until it is stopped.
+//
+	Script& repeat ();
+
+//
+//  clear
+//
+//  Purpose: To remove all steps from this Script.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This Script is set to have no steps and not to
+//               repeat.  Running copies are not affected.
+//
+	void clear ();
+
+private:
+//
+//  STEP_WAIT
+//  STEP_TWEEN_DOUBLE
+//  STEP_TWEEN_VECTOR3
+//  STEP_CALL
+//
+//  Constants for the type of each step.
+//
+	static const unsigned int STEP_WAIT          = 0;
+	static const unsigned int STEP_TWEEN_DOUBLE  = 1;
+	static const unsigned int STEP_TWEEN_VECTOR3 = 2;
+	static const unsigned int STEP_CALL          = 3;
+
+//
+//  Step
+//
+//  A record to store one step.  Only the fields for the type
+//    of step are used.
+//
+	struct Step
+	{
+		unsigned int m_type;
+		double m_seconds;
+		unsigned int m_easing;
+		double* mp_double;
+		double m_double_target;
+		Vector3* mp_vector3;
+		Vector3 m_vector3_target;
+		std::function<void ()> m_function;
+	};
+
+	friend class ScriptScheduler;
+
+private:
+	std::vector<Step> mv_steps;
+	bool m_is_repeating;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
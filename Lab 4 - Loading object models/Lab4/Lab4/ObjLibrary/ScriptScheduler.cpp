@@ -0,0 +1,285 @@
+//
+//  ScriptScheduler.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Vector3.h"
+#include "Script.h"
+#include "ScriptScheduler.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+const unsigned int ScriptScheduler :: NO_SCRIPT;
+
+
+
+ScriptScheduler :: ScriptScheduler ()
+		: m_time(0.0),
+		  m_next_handle(NO_SCRIPT + 1),
+		  m_running_count(0)
+{
+}
+
+
+
+bool ScriptScheduler :: isRunning (unsigned int handle) const
+{
+	return findSlot(handle) < mv_running.size();
+}
+
+
+
+unsigned int ScriptScheduler :: start (const Script& script)
+{
+	assert(!script.isRepeating() || script.isTimed());
+
+	unsigned int slot;
+	if(mv_free_slots.empty())
+	{
+		slot = (unsigned int)(mv_running.size());
+		mv_running.push_back(Running());
+	}
+	else
+	{
+		slot = mv_free_slots.back();
+		mv_free_slots.pop_back();
+	}
+
+	unsigned int handle = m_next_handle;
+	m_next_handle++;
+	if(m_next_handle == NO_SCRIPT)
+		m_next_handle++;
+
+	Running& r_running = mv_running[slot];
+	r_running.m_handle     = handle;
+	r_running.mp_script    = make_shared<Script>(script);
+	r_running.m_step       = 0;
+	r_running.m_step_start = m_time;
+	m_handle_slots[handle] = slot;
+	m_running_count++;
+
+	resume(slot, m_time);
+	return handle;
+}
+
+void ScriptScheduler :: stop (unsigned int handle)
+{
+	unsigned int slot = findSlot(handle);
+	if(slot < mv_running.size())
+		release(slot);
+}
+
+void ScriptScheduler :: stopAll ()
+{
+	for(unsigned int i = 0; i < mv_running.size(); i++)
+		if(mv_running[i].m_handle != NO_SCRIPT)
+			release(i);
+
+	mv_wakes.clear();
+	mv_tweens.clear();
+	assert(m_running_count == 0);
+}
+
+void ScriptScheduler :: update (double seconds)
+{
+	assert(seconds >= 0.0);
+
+	m_time += seconds;
+
+	// a tween that ends may start a short wait, and the reverse
+	do
+	{
+		while(!mv_wakes.empty() && mv_wakes.front().m_time <= m_time)
+		{
+			pop_heap(mv_wakes.begin(), mv_wakes.end());
+			Wake wake = mv_wakes.back();
+			mv_wakes.pop_back();
+
+			// skip Scripts that were stopped
+			if(mv_running[wake.m_slot].m_handle == wake.m_handle)
+				resume(wake.m_slot, wake.m_time);
+		}
+
+		updateTweens();
+	}
+	while(!mv_wakes.empty() && mv_wakes.front().m_time <= m_time);
+}
+
+
+
+unsigned int ScriptScheduler :: findSlot (unsigned int handle) const
+{
+	unordered_map<unsigned int, unsigned int>::const_iterator it = m_handle_slots.find(handle);
+	if(it == m_handle_slots.end())
+		return (unsigned int)(mv_running.size());
+	return it->second;
+}
+
+void ScriptScheduler :: resume (unsigned int slot, double time)
+{
+	assert(slot < mv_running.size());
+	assert(mv_running[slot].m_handle != NO_SCRIPT);
+
+	unsigned int handle = mv_running[slot].m_handle;
+
+	// keep the Script alive in case a call step stops it
+	shared_ptr<const Script> p_script = mv_running[slot].mp_script;
+	const vector<Script::Step>& v_steps = p_script->mv_steps;
+
+	for(;;)
+	{
+		// a call step may add to mv_running, so look it up each time
+		Running& r_running = mv_running[slot];
+
+		if(r_running.m_step >= v_steps.size())
+		{
+			if(!p_script->isRepeating() || v_steps.empty())
+			{
+				release(slot);
+				return;
+			}
+			r_running.m_step = 0;
+		}
+
+		const Script::Step& step = v_steps[r_running.m_step];
+		r_running.m_step_start = time;
+
+		switch(step.m_type)
+		{
+		case Script::STEP_WAIT:
+			r_running.m_step++;
+			if(step.m_seconds > 0.0)
+			{
+				Wake wake;
+				wake.m_time   = time + step.m_seconds;
+				wake.m_slot   = slot;
+				wake.m_handle = handle;
+				mv_wakes.push_back(wake);
+				push_heap(mv_wakes.begin(), mv_wakes.end());
+				return;
+			}
+			break;
+
+		case Script::STEP_TWEEN_DOUBLE:
+		case Script::STEP_TWEEN_VECTOR3:
+			if(step.m_type == Script::STEP_TWEEN_DOUBLE)
+				r_running.m_double_start = *step.mp_double;
+			else
+				r_running.m_vector3_start = *step.mp_vector3;
+
+			if(step.m_seconds > 0.0)
+			{
+				Tween tween;
+				tween.m_slot   = slot;
+				tween.m_handle = handle;
+				mv_tweens.push_back(tween);
+				return;
+			}
+
+			if(step.m_type == Script::STEP_TWEEN_DOUBLE)
+				*step.mp_double = step.m_double_target;
+			else
+				*step.mp_vector3 = step.m_vector3_target;
+			r_running.m_step++;
+			break;
+
+		case Script::STEP_CALL:
+			r_running.m_step++;
+			step.m_function();
+
+			// the function may have stopped this Script
+			if(mv_running[slot].m_handle != handle)
+				return;
+			break;
+
+		default:
+			assert(false);
+			break;
+		}
+	}
+}
+
+void ScriptScheduler :: updateTweens ()
+{
+	unsigned int i = 0;
+	while(i < mv_tweens.size())
+	{
+		Tween tween = mv_tweens[i];
+		if(mv_running[tween.m_slot].m_handle != tween.m_handle)
+		{
+			// Script was stopped
+			mv_tweens[i] = mv_tweens.back();
+			mv_tweens.pop_back();
+			continue;
+		}
+
+		Running& r_running = mv_running[tween.m_slot];
+		const Script::Step& step = r_running.mp_script->mv_steps[r_running.m_step];
+		double end = r_running.m_step_start + step.m_seconds;
+
+		if(m_time >= end)
+		{
+			if(step.m_type == Script::STEP_TWEEN_DOUBLE)
+				*step.mp_double = step.m_double_target;
+			else
+				*step.mp_vector3 = step.m_vector3_target;
+
+			// remove before resuming, which may add another tween
+			mv_tweens[i] = mv_tweens.back();
+			mv_tweens.pop_back();
+			r_running.m_step++;
+			resume(tween.m_slot, end);
+			continue;
+		}
+
+		double eased = Script::getEased((m_time - r_running.m_step_start) / step.m_seconds,
+		                                step.m_easing);
+		if(step.m_type == Script::STEP_TWEEN_DOUBLE)
+		{
+			*step.mp_double = r_running.m_double_start +
+			                  (step.m_double_target - r_running.m_double_start) * eased;
+		}
+		else
+		{
+			*step.mp_vector3 = r_running.m_vector3_start +
+			                   (step.m_vector3_target - r_running.m_vector3_start) * eased;
+		}
+		i++;
+	}
+}
+
+void ScriptScheduler :: release (unsigned int slot)
+{
+	assert(slot < mv_running.size());
+	assert(mv_running[slot].m_handle != NO_SCRIPT);
+
+	m_handle_slots.erase(mv_running[slot].m_handle);
+	mv_running[slot].m_handle = NO_SCRIPT;
+	mv_running[slot].mp_script.reset();
+	mv_free_slots.push_back(slot);
+	assert(m_running_count > 0);
+	m_running_count--;
+}
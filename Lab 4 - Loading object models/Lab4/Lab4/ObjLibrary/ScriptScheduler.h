@@ -0,0 +1,310 @@
+//
+//  ScriptScheduler.h
+//
+//  A module to run many Scripts over time.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_SCRIPT_SCHEDULER_H
+#define OBJ_LIBRARY_SCRIPT_SCHEDULER_H
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#include "Vector3.h"
+#include "Script.h"
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  ScriptScheduler
+//
+//  A class to run Scripts as the frame loop advances time.
+//    Scripts are suspended between steps instead of being
+//    checked every frame:
+//      <1> A Script that is waiting is stored in a priority
+//          queue ordered by the time it wakes up.  Each update
+//          only removes the Scripts that are due.
+//      <2> A Script that is tweening is stored in a list of
+//          active tweens, which are updated every frame.
+//      <3> Call steps are run as soon as they are reached.
+//    Everything runs on the thread that calls update.
+//
+//  Times are carried over exactly between steps: if a wait
+//    ends part-way through a frame, the next step starts at
+//    the time the wait ended, not at the end of the frame.  So
+//    Scripts do not drift, no matter how long the frames are.
+//
+//  Each Script started is identified by a handle, which is
+//    never reused.  Handles can be used to stop a Script or
+//    check if it is still running.
+//
+class ScriptScheduler
+{
+public:
+//
+//  NO_SCRIPT
+//
+//  A handle value that never refers to a running Script.
+//
+	static const unsigned int NO_SCRIPT = 0;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new ScriptScheduler.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new ScriptScheduler is created with no
+//               running Scripts and a time of 0.0.
+//
+	ScriptScheduler ();
+
+//
+//  getTime
+//
+//  Purpose: To determine the current time.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The total of all times passed to update.
+//  Side Effect: N/A
+//
+	double getTime () const
+	{ return m_time; }
+
+//
+//  getRunningCount
+//
+//  Purpose: To determine how many Scripts are running.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of Scripts that have been started and
+//           have not finished or been stopped.
+//  Side Effect: N/A
+//
+	unsigned int getRunningCount () const
+	{ return m_running_count; }
+
+//
+//  getTweenCount
+//
+//  Purpose: To determine how many Scripts are tweening.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of active tweens.  These are the only
+//           Scripts that cost time every update.
+//  Side Effect: N/A
+//
+	unsigned int getTweenCount () const
+	{ return (unsigned int)(mv_tweens.size()); }
+
+//
+//  isRunning
+//
+//  Purpose: To determine if a Script is still running.
+//  Parameter(s):
+//    <1> handle: The handle returned by start
+//  Precondition(s): N/A
+//  Returns: Whether the Script with handle handle is running.
+//  Side Effect: N/A
+//
+	bool isRunning (unsigned int handle) const;
+
+//
+//  start
+//
+//  Purpose: To start running a Script.
+//  Parameter(s):
+//    <1> script: The Script to run
+//  Precondition(s):
+//    <1> !script.isRepeating() || script.isTimed()
+//  Returns: A handle for the running Script.  This is never
+//           NO_SCRIPT.
+//  Side Effect: A copy of script is started at the current
+//               time.  Steps are run until the first one that
+//               takes time, so a Script containing only call
+//               steps finishes before this function returns.
+//
+	unsigned int start (const Script& script);
+
+//
+//  stop
+//
+//  Purpose: To stop a running Script.
+//  Parameter(s):
+//    <1> handle: The handle returned by start
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If the Script with handle handle is running,
+//               it is stopped.  Any value it was tweening is
+//               left where it is.  Otherwise, there is no
+//               effect.
+//
+	void stop (unsigned int handle);
+
+//
+//  stopAll
+//
+//  Purpose: To stop all running Scripts.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All running Scripts are stopped.
+//
+	void stopAll ();
+
+//
+//  update
+//
+//  Purpose: To advance time for all running Scripts.
+//  Parameter(s):
+//    <1> seconds: The time since the last update
+//  Precondition(s):
+//    <1> seconds >= 0.0
+//  Returns: N/A
+//  Side Effect: The time is increased by seconds.  Waits that
+//               end are resumed, tweened values are updated,
+//               and any steps reached are run.
+//
+	void update (double seconds);
+
+private:
+//
+//  Running
+//
+//  A record to store the state of a running Script.  m_handle
+//    is NO_SCRIPT if the record is not in use.  The Script is
+//    shared so that a call step can safely start or stop
+//    Scripts while it is running.
+//
+	struct Running
+	{
+		unsigned int m_handle;
+		std::shared_ptr<const Script> mp_script;
+		unsigned int m_step;
+		double m_step_start;
+		double m_double_start;
+		Vector3 m_vector3_start;
+	};
+
+//
+//  Wake
+//
+//  A record to store when a waiting Script should resume.
+//    These are kept in a heap with the earliest at the top.
+//
+	struct Wake
+	{
+		double m_time;
+		unsigned int m_slot;
+		unsigned int m_handle;
+
+		bool operator< (const Wake& other) const
+		{ return m_time > other.m_time; }
+	};
+
+//
+//  Tween
+//
+//  A record to identify a Script that is tweening.
+//
+	struct Tween
+	{
+		unsigned int m_slot;
+		unsigned int m_handle;
+	};
+
+//
+//  findSlot
+//
+//  Purpose: To find the record for a running Script.
+//  Parameter(s):
+//    <1> handle: The handle for the Script
+//  Precondition(s): N/A
+//  Returns: The index in mv_running of the Script with handle
+//           handle, or mv_running.size() if it is not running.
+//  Side Effect: N/A
+//
+	unsigned int findSlot (unsigned int handle) const;
+
+//
+//  resume
+//
+//  Purpose: To run the steps of a Script until one takes time.
+//  Parameter(s):
+//    <1> slot: The index of the Script in mv_running
+//    <2> time: The time the current step starts
+//  Precondition(s):
+//    <1> slot < mv_running.size()
+//    <2> mv_running[slot].m_handle != NO_SCRIPT
+//  Returns: N/A
+//  Side Effect: Steps are run starting with the current step.
+//               If a wait or tween is reached, the Script is
+//               suspended.  If the Script ends, it is removed.
+//
+	void resume (unsigned int slot, double time);
+
+//
+//  updateTweens
+//
+//  Purpose: To update all active tweens to the current time.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The tweened values are set.  Tweens that end
+//               are removed and their Scripts resumed.
+//
+	void updateTweens ();
+
+//
+//  release
+//
+//  Purpose: To mark a record in mv_running as unused.
+//  Parameter(s):
+//    <1> slot: The index of the record
+//  Precondition(s):
+//    <1> slot < mv_running.size()
+//    <2> mv_running[slot].m_handle != NO_SCRIPT
+//  Returns: N/A
+//  Side Effect: The Script in slot slot is no longer running.
+//               Any entries for it in the wake heap or tween
+//               list are ignored and removed later.
+//
+	void release (unsigned int slot);
+
+private:
+	double m_time;
+	unsigned int m_next_handle;
+	unsigned int m_running_count;
+	std::vector<Running> mv_running;
+	std::vector<unsigned int> mv_free_slots;
+	std::unordered_map<unsigned int, unsigned int> m_handle_slots;
+	std::vector<Wake> mv_wakes;
+	std::vector<Tween> mv_tweens;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -0,0 +1,195 @@
+//
+//  SimdKernels.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+
+#include "SimdKernels.h"
+#include "SimdKernelsGeneric.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+  #define OBJ_LIBRARY_SIMD_X86
+  #ifdef _MSC_VER
+    #include <intrin.h>		// for __cpuid and _xgetbv
+  #endif
+#endif
+
+using namespace std;
+using namespace ObjLibrary;
+using namespace ObjLibrary::SimdKernels;
+namespace
+{
+	const char* LEVEL_NAMES[LEVEL_COUNT] =
+	{
+		"Scalar",
+		"SSE2",
+		"AVX",
+	};
+
+	//
+	//  detectLevel
+	//
+	//  Purpose: To query the processor for the best instruction
+	//           set level it supports.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The best level supported.
+	//  Side Effect: N/A
+	//
+	unsigned int detectLevel ()
+	{
+#ifdef OBJ_LIBRARY_SIMD_X86
+  #ifdef _MSC_VER
+		int a_registers[4];  // EAX, EBX, ECX, EDX
+		__cpuid(a_registers, 1);
+
+		bool is_sse2    = (a_registers[3] & (1 << 26)) != 0;
+		bool is_osxsave = (a_registers[2] & (1 << 27)) != 0;
+		bool is_avx     = (a_registers[2] & (1 << 28)) != 0;
+
+		// the operating system must also save the AVX registers
+		if(is_avx && is_osxsave && (_xgetbv(0) & 0x6) == 0x6)
+			return LEVEL_AVX;
+		if(is_sse2)
+			return LEVEL_SSE2;
+  #else
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("avx"))
+			return LEVEL_AVX;
+		if(__builtin_cpu_supports("sse2"))
+			return LEVEL_SSE2;
+  #endif
+#endif
+		return LEVEL_SCALAR;
+	}
+
+	//
+	//  Tables
+	//
+	//  A record of the current kernel tables and the level they
+	//    were created for.
+	//
+	struct Tables
+	{
+		unsigned int m_supported_level;
+		unsigned int m_level;
+		Table<float>  m_float;
+		Table<double> m_double;
+	};
+
+	void initializeTables (Tables& r_tables, unsigned int level)
+	{
+		assert(level < LEVEL_COUNT);
+
+		switch(level)
+		{
+		case LEVEL_AVX:
+			initializeTableAvx(r_tables.m_float);
+			initializeTableAvx(r_tables.m_double);
+			break;
+		case LEVEL_SSE2:
+			initializeTableSse2(r_tables.m_float);
+			initializeTableSse2(r_tables.m_double);
+			break;
+		default:
+			initializeTableScalar(r_tables.m_float);
+			initializeTableScalar(r_tables.m_double);
+			break;
+		}
+		r_tables.m_level = level;
+	}
+
+	//
+	//  getTables
+	//
+	//  Purpose: To retrieve the current kernel tables.
+	//  Parameter(s): N/A
+	//  Precondition(s): N/A
+	//  Returns: The kernel tables.
+	//  Side Effect: The first time this function is called,
+	//               the processor is queried and the tables
+	//               are initialized.  This is thread-safe in
+	//               C++11.
+	//
+	Tables& getTables ()
+	{
+		struct Initializer
+		{
+			Tables m_tables;
+
+			Initializer ()
+			{
+				m_tables.m_supported_level = detectLevel();
+				initializeTables(m_tables, m_tables.m_supported_level);
+			}
+		};
+
+		static Initializer initializer;
+		return initializer.m_tables;
+	}
+}
+
+
+
+unsigned int SimdKernels :: getSupportedLevel ()
+{
+	return getTables().m_supported_level;
+}
+
+unsigned int SimdKernels :: getLevel ()
+{
+	return getTables().m_level;
+}
+
+const char* SimdKernels :: getLevelName (unsigned int level)
+{
+	assert(level < LEVEL_COUNT);
+
+	return LEVEL_NAMES[level];
+}
+
+void SimdKernels :: setLevel (unsigned int level)
+{
+	assert(level <= getSupportedLevel());
+
+	initializeTables(getTables(), level);
+}
+
+template <>
+const Table<float>& SimdKernels :: getTable<float> ()
+{
+	return getTables().m_float;
+}
+
+template <>
+const Table<double>& SimdKernels :: getTable<double> ()
+{
+	return getTables().m_double;
+}
+
+
+
+void SimdKernels :: initializeTableScalar (Table<float>& r_table)
+{
+	fillTable<PackScalar<float> >(r_table);
+}
+
+void SimdKernels :: initializeTableScalar (Table<double>& r_table)
+{
+	fillTable<PackScalar<double> >(r_table);
+}
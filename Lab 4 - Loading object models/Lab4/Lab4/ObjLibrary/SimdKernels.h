@@ -0,0 +1,318 @@
+//
+//  SimdKernels.h
+//
+//  A module to select and run vectorized loops over arrays of
+//    floating point values.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_SIMD_KERNELS_H
+#define OBJ_LIBRARY_SIMD_KERNELS_H
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  SimdKernels
+//
+//  A namespace to contain the tables of functions used by the
+//    structure-of-arrays classes such as Vector3Array.  Each
+//    function runs one simple operation across whole arrays of
+//    float or double values.
+//
+//  There are three implementations of each function: a scalar
+//    one that works everywhere, one using SSE2 instructions,
+//    and one using AVX instructions.  The best one supported
+//    by the current processor is chosen the first time a table
+//    is requested.  The SSE2 and AVX versions are only compiled
+//    for x86 and x64 processors.
+//
+//  In all the functions, the result arrays may be the same as
+//    the input arrays, but they may not otherwise overlap.
+//    The arrays do not need to be aligned.
+//
+namespace SimdKernels
+{
+
+//
+//  LEVEL_SCALAR
+//
+//  A constant indicating the plain C++ functions.
+//
+const unsigned int LEVEL_SCALAR = 0;
+
+//
+//  LEVEL_SSE2
+//
+//  A constant indicating the functions that use SSE2
+//    instructions (4 floats or 2 doubles at a time).
+//
+const unsigned int LEVEL_SSE2 = 1;
+
+//
+//  LEVEL_AVX
+//
+//  A constant indicating the functions that use AVX
+//    instructions (8 floats or 4 doubles at a time).
+//
+const unsigned int LEVEL_AVX = 2;
+
+//
+//  LEVEL_COUNT
+//
+//  The number of instruction set levels.
+//
+const unsigned int LEVEL_COUNT = 3;
+
+
+
+//
+//  Table
+//
+//  A record of the kernel functions for one element type.  In
+//    each function, the first parameter is the number of
+//    elements in each array.  A 2D or 3D vector is passed as
+//    one array per component.
+//
+//  add: a_result[i] = a_a[i] + a_b[i]
+//  addScalar: a_result[i] = a_a[i] + s
+//  multiplyScalar: a_result[i] = a_a[i] * s
+//  multiplyAdd: a_result[i] = a_a[i] + a_b[i] * s
+//  lerp: a_result[i] = a_a[i] + (a_b[i] - a_a[i]) * a_t[i]
+//  minMax: r_min = min(a_a[i]), r_max = max(a_a[i]); count > 0
+//  dotProduct2/3: a_result[i] = dot(a[i], b[i])
+//  crossProduct3: result[i] = cross(a[i], b[i])
+//  normalize2/3/4: result[i] = a[i] / |a[i]|, or a[i] if it
+//                  is the zero vector
+//  distanceSquared2/3: a_result[i] = |a[i] - point|^2
+//  matrixProduct2/3: result[i] = M * a[i], where M is a
+//                    row-major 2x2 or 3x3 matrix
+//  affineProduct3: result[i] = M * (a[i], 1), where M is a
+//                  row-major 3x4 matrix
+//  matrixMultiply4: a_result = a_left * a_right, where all
+//                   three are column-major 4x4 matrices (as
+//                   used by OpenGL); a_result may not be
+//                   either of the other matrices
+//  projectiveProduct3: (rx, ry, rz, rw)[i] = M * (a[i], 1),
+//                      where M is a row-major 4x4 matrix
+//  rasterizeRow: with e_k = a_plane[k] + i * a_plane[k + 3]
+//                for k < 3 and z = a_plane[6] + i * a_plane[7],
+//                a_depth[i] = min(a_depth[i], z) wherever all
+//                three e_k + a_plane[k + 8] > 0; used to draw
+//                one row of a triangle into a depth buffer.
+//                The bias a_plane[k + 8] is added after e_k is
+//                calculated, so a bias of the smallest positive
+//                normal value makes the test e_k >= 0, as for
+//                the top and left edges under the top-left
+//                fill rule.
+//  distanceStep3: with d = |a[i] - a_point|^2, r_steps[i] = 1
+//                 where d > a_high[i], -1 where d < a_low[i],
+//                 and 0 elsewhere; used to choose levels of
+//                 detail
+//
+template <typename T>
+struct Table
+{
+	void (*add) (unsigned int count,
+	             const T* a_a, const T* a_b, T* a_result);
+	void (*addScalar) (unsigned int count,
+	                   const T* a_a, T s, T* a_result);
+	void (*multiplyScalar) (unsigned int count,
+	                        const T* a_a, T s, T* a_result);
+	void (*multiplyAdd) (unsigned int count,
+	                     const T* a_a, const T* a_b, T s,
+	                     T* a_result);
+	void (*lerp) (unsigned int count,
+	              const T* a_a, const T* a_b, const T* a_t,
+	              T* a_result);
+	void (*minMax) (unsigned int count,
+	                const T* a_a, T& r_min, T& r_max);
+
+	void (*dotProduct2) (unsigned int count,
+	                     const T* a_ax, const T* a_ay,
+	                     const T* a_bx, const T* a_by,
+	                     T* a_result);
+	void (*dotProduct3) (unsigned int count,
+	                     const T* a_ax, const T* a_ay, const T* a_az,
+	                     const T* a_bx, const T* a_by, const T* a_bz,
+	                     T* a_result);
+	void (*crossProduct3) (unsigned int count,
+	                       const T* a_ax, const T* a_ay, const T* a_az,
+	                       const T* a_bx, const T* a_by, const T* a_bz,
+	                       T* a_rx, T* a_ry, T* a_rz);
+	void (*normalize2) (unsigned int count,
+	                    const T* a_ax, const T* a_ay,
+	                    T* a_rx, T* a_ry);
+	void (*normalize3) (unsigned int count,
+	                    const T* a_ax, const T* a_ay, const T* a_az,
+	                    T* a_rx, T* a_ry, T* a_rz);
+	void (*normalize4) (unsigned int count,
+	                    const T* a_aw, const T* a_ax, const T* a_ay, const T* a_az,
+	                    T* a_rw, T* a_rx, T* a_ry, T* a_rz);
+	void (*distanceSquared2) (unsigned int count,
+	                          const T* a_ax, const T* a_ay,
+	                          T px, T py,
+	                          T* a_result);
+	void (*distanceSquared3) (unsigned int count,
+	                          const T* a_ax, const T* a_ay, const T* a_az,
+	                          T px, T py, T pz,
+	                          T* a_result);
+	void (*matrixProduct2) (unsigned int count,
+	                        const T a_matrix[4],
+	                        const T* a_ax, const T* a_ay,
+	                        T* a_rx, T* a_ry);
+	void (*matrixProduct3) (unsigned int count,
+	                        const T a_matrix[9],
+	                        const T* a_ax, const T* a_ay, const T* a_az,
+	                        T* a_rx, T* a_ry, T* a_rz);
+	void (*affineProduct3) (unsigned int count,
+	                        const T a_matrix[12],
+	                        const T* a_ax, const T* a_ay, const T* a_az,
+	                        T* a_rx, T* a_ry, T* a_rz);
+	void (*matrixMultiply4) (const T a_left[16],
+	                         const T a_right[16],
+	                         T a_result[16]);
+	void (*projectiveProduct3) (unsigned int count,
+	                            const T a_matrix[16],
+	                            const T* a_ax, const T* a_ay, const T* a_az,
+	                            T* a_rx, T* a_ry, T* a_rz, T* a_rw);
+	void (*rasterizeRow) (unsigned int count,
+	                      const T a_plane[11],
+	                      T* a_depth);
+	void (*distanceStep3) (unsigned int count,
+	                       const T a_point[3],
+	                       const T* a_ax, const T* a_ay, const T* a_az,
+	                       const T* a_low, const T* a_high,
+	                       T* a_steps);
+};
+
+
+
+//
+//  getSupportedLevel
+//
+//  Purpose: To determine the best instruction set level
+//           supported by both this build and the current
+//           processor.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The best supported level.  This is one of
+//           LEVEL_SCALAR, LEVEL_SSE2, or LEVEL_AVX.
+//  Side Effect: The first time this function is called, the
+//               processor features are queried.
+//
+unsigned int getSupportedLevel ();
+
+//
+//  getLevel
+//
+//  Purpose: To determine which instruction set level is
+//           currently used for the kernel tables.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The current level.  Unless setLevel has been
+//           called, this is the same as getSupportedLevel().
+//  Side Effect: N/A
+//
+unsigned int getLevel ();
+
+//
+//  getLevelName
+//
+//  Purpose: To determine the name of the specified instruction
+//           set level.
+//  Parameter(s):
+//    <1> level: The level
+//  Precondition(s):
+//    <1> level < LEVEL_COUNT
+//  Returns: The name of level, such as "SSE2".
+//  Side Effect: N/A
+//
+const char* getLevelName (unsigned int level);
+
+//
+//  setLevel
+//
+//  Purpose: To change which instruction set level is used for
+//           the kernel tables.  This is intended for comparing
+//           the levels against each other.
+//  Parameter(s):
+//    <1> level: The new level
+//  Precondition(s):
+//    <1> level <= getSupportedLevel()
+//  Returns: N/A
+//  Side Effect: The kernel tables are switched to the versions
+//               for level level.  This function must not be
+//               called while another thread is using the
+//               kernels.
+//
+void setLevel (unsigned int level);
+
+//
+//  getTable
+//
+//  Purpose: To retrieve the kernel table for the current
+//           instruction set level.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The kernel table for type T at the current level.
+//           Only float and double are supported.
+//  Side Effect: N/A
+//
+template <typename T>
+const Table<T>& getTable ();
+
+template <>
+const Table<float>& getTable<float> ();
+
+template <>
+const Table<double>& getTable<double> ();
+
+
+
+//
+//  initializeTableScalar
+//  initializeTableSse2
+//  initializeTableAvx
+//
+//  Purpose: To fill in a kernel table with the functions for
+//           a specific instruction set level.  These functions
+//           are used internally by getTable and setLevel.
+//  Parameter(s):
+//    <1> r_table: The table to fill in
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All the function pointers in r_table are set.
+//               If the instruction set is not available in
+//               this build, the scalar functions are used.
+//
+void initializeTableScalar (Table<float>& r_table);
+void initializeTableScalar (Table<double>& r_table);
+void initializeTableSse2 (Table<float>& r_table);
+void initializeTableSse2 (Table<double>& r_table);
+void initializeTableAvx (Table<float>& r_table);
+void initializeTableAvx (Table<double>& r_table);
+
+}  // end of namespace SimdKernels
+
+}  // end of namespace ObjLibrary
+
+
+
+#endif
@@ -0,0 +1,180 @@
+//
+//  SimdKernelsAvx.cpp
+//
+//  The AVX versions of the SimdKernels functions.  These are
+//    only used if SimdKernels::getSupportedLevel() reports
+//    that the processor supports AVX.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+//
+//  All the standard headers must be #included before AVX is
+//    enabled.  Otherwise, inline functions from them could be
+//    compiled with AVX instructions and then shared with the
+//    rest of the program.
+//
+
+#include <cmath>
+
+#include "SimdKernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+  #if defined(_MSC_VER)
+    // Visual C++ allows AVX intrinsics without any special flags
+    #define OBJ_LIBRARY_SIMD_AVX
+    #include <immintrin.h>
+  #elif defined(__clang__)
+    #define OBJ_LIBRARY_SIMD_AVX
+    #include <immintrin.h>
+    #pragma clang attribute push (__attribute__((target("avx"))), apply_to = function)
+  #elif defined(__GNUC__)
+    #define OBJ_LIBRARY_SIMD_AVX
+    #include <immintrin.h>
+    #pragma GCC push_options
+    #pragma GCC target("avx")
+  #endif
+#endif
+
+#include "SimdKernelsGeneric.h"
+
+using namespace std;
+using namespace ObjLibrary;
+using namespace ObjLibrary::SimdKernels;
+namespace
+{
+#ifdef OBJ_LIBRARY_SIMD_AVX
+	struct PackAvxFloat
+	{
+		typedef float Scalar;
+		typedef __m256 Type;
+		static const unsigned int WIDTH = 8;
+
+		static inline Type load (const float* a_values)  { return _mm256_loadu_ps(a_values); }
+		static inline void store (float* a_values, Type v) { _mm256_storeu_ps(a_values, v); }
+		static inline Type set1 (float value)            { return _mm256_set1_ps(value); }
+		static inline Type add (Type a, Type b)           { return _mm256_add_ps(a, b); }
+		static inline Type sub (Type a, Type b)           { return _mm256_sub_ps(a, b); }
+		static inline Type mul (Type a, Type b)           { return _mm256_mul_ps(a, b); }
+		static inline Type div (Type a, Type b)           { return _mm256_div_ps(a, b); }
+		static inline Type sqrt (Type a)                  { return _mm256_sqrt_ps(a); }
+		static inline Type min (Type a, Type b)           { return _mm256_min_ps(a, b); }
+		static inline Type max (Type a, Type b)           { return _mm256_max_ps(a, b); }
+
+		static inline Type selectPositive (Type t, Type a, Type b)
+		{
+			Type mask = _mm256_cmp_ps(t, _mm256_setzero_ps(), _CMP_GT_OQ);
+			return _mm256_blendv_ps(b, a, mask);
+		}
+
+		static inline float reduceMin (Type v)
+		{
+			float a_values[WIDTH];
+			_mm256_storeu_ps(a_values, v);
+			float result = a_values[0];
+			for(unsigned int i = 1; i < WIDTH; i++)
+				if(a_values[i] < result)
+					result = a_values[i];
+			return result;
+		}
+
+		static inline float reduceMax (Type v)
+		{
+			float a_values[WIDTH];
+			_mm256_storeu_ps(a_values, v);
+			float result = a_values[0];
+			for(unsigned int i = 1; i < WIDTH; i++)
+				if(a_values[i] > result)
+					result = a_values[i];
+			return result;
+		}
+	};
+
+	struct PackAvxDouble
+	{
+		typedef double Scalar;
+		typedef __m256d Type;
+		static const unsigned int WIDTH = 4;
+
+		static inline Type load (const double* a_values)  { return _mm256_loadu_pd(a_values); }
+		static inline void store (double* a_values, Type v) { _mm256_storeu_pd(a_values, v); }
+		static inline Type set1 (double value)            { return _mm256_set1_pd(value); }
+		static inline Type add (Type a, Type b)            { return _mm256_add_pd(a, b); }
+		static inline Type sub (Type a, Type b)            { return _mm256_sub_pd(a, b); }
+		static inline Type mul (Type a, Type b)            { return _mm256_mul_pd(a, b); }
+		static inline Type div (Type a, Type b)            { return _mm256_div_pd(a, b); }
+		static inline Type sqrt (Type a)                   { return _mm256_sqrt_pd(a); }
+		static inline Type min (Type a, Type b)            { return _mm256_min_pd(a, b); }
+		static inline Type max (Type a, Type b)            { return _mm256_max_pd(a, b); }
+
+		static inline Type selectPositive (Type t, Type a, Type b)
+		{
+			Type mask = _mm256_cmp_pd(t, _mm256_setzero_pd(), _CMP_GT_OQ);
+			return _mm256_blendv_pd(b, a, mask);
+		}
+
+		static inline double reduceMin (Type v)
+		{
+			double a_values[WIDTH];
+			_mm256_storeu_pd(a_values, v);
+			double result = a_values[0];
+			for(unsigned int i = 1; i < WIDTH; i++)
+				if(a_values[i] < result)
+					result = a_values[i];
+			return result;
+		}
+
+		static inline double reduceMax (Type v)
+		{
+			double a_values[WIDTH];
+			_mm256_storeu_pd(a_values, v);
+			double result = a_values[0];
+			for(unsigned int i = 1; i < WIDTH; i++)
+				if(a_values[i] > result)
+					result = a_values[i];
+			return result;
+		}
+	};
+#endif
+}
+
+
+
+void SimdKernels :: initializeTableAvx (Table<float>& r_table)
+{
+#ifdef OBJ_LIBRARY_SIMD_AVX
+	fillTable<PackAvxFloat>(r_table);
+#else
+	initializeTableSse2(r_table);
+#endif
+}
+
+void SimdKernels :: initializeTableAvx (Table<double>& r_table)
+{
+#ifdef OBJ_LIBRARY_SIMD_AVX
+	fillTable<PackAvxDouble>(r_table);
+#else
+	initializeTableSse2(r_table);
+#endif
+}
+
+#if defined(OBJ_LIBRARY_SIMD_AVX) && !defined(_MSC_VER)
+  #ifdef __clang__
+    #pragma clang attribute pop
+  #else
+    #pragma GCC pop_options
+  #endif
+#endif
@@ -0,0 +1,918 @@
+//
+//  SimdKernelsGeneric.h
+//
+//  The kernel functions for SimdKernels, written once in terms
+//    of a "pack" type.  This file is only intended to be
+//    #included by SimdKernels.cpp, SimdKernelsSse2.cpp, and
+//    SimdKernelsAvx.cpp.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_SIMD_KERNELS_GENERIC_H
+#define OBJ_LIBRARY_SIMD_KERNELS_GENERIC_H
+
+//
+//  Everything here is in an anonymous namespace so that each
+//    file that #includes it gets its own copy.  This matters
+//    for SimdKernelsAvx.cpp, which is compiled with AVX
+//    instructions enabled.  If these functions could be
+//    shared between files, the linker might choose the AVX
+//    version for a processor that does not support it.
+//
+//  A pack type P must provide:
+//    typedef Scalar: The element type (float or double)
+//    typedef Type: The register type
+//    WIDTH: The number of elements in a Type
+//    load, store, set1, add, sub, mul, div, sqrt, min, max
+//    selectPositive(t, a, b): a where t > 0, b elsewhere
+//    reduceMin, reduceMax: The smallest/largest element
+//
+//  Each kernel is split into a vector part and a scalar
+//    remainder.  The remainder uses PackScalar, which has a
+//    WIDTH of 1.  This way, the element calculations are only
+//    written once.
+//
+
+#include <cmath>
+
+#include "SimdKernels.h"
+
+
+
+namespace ObjLibrary
+{
+namespace SimdKernels
+{
+namespace
+{
+
+	//
+	//  PackScalar
+	//
+	//  A pack type that holds a single element.  It is used for
+	//    the scalar kernels and for the end of each array.
+	//
+	template <typename T>
+	struct PackScalar
+	{
+		typedef T Scalar;
+		typedef T Type;
+		static const unsigned int WIDTH = 1;
+
+		static inline Type load (const T* a_values)   { return *a_values; }
+		static inline void store (T* a_values, Type v) { *a_values = v; }
+		static inline Type set1 (T value)             { return value; }
+		static inline Type add (Type a, Type b)        { return a + b; }
+		static inline Type sub (Type a, Type b)        { return a - b; }
+		static inline Type mul (Type a, Type b)        { return a * b; }
+		static inline Type div (Type a, Type b)        { return a / b; }
+		static inline Type sqrt (Type a)               { return std::sqrt(a); }
+		static inline Type min (Type a, Type b)        { return (b < a) ? b : a; }
+		static inline Type max (Type a, Type b)        { return (b > a) ? b : a; }
+		static inline Type selectPositive (Type t, Type a, Type b)
+		                                               { return (t > 0) ? a : b; }
+		static inline T reduceMin (Type v)             { return v; }
+		static inline T reduceMax (Type v)             { return v; }
+	};
+
+
+
+	//
+	//  The range functions process elements [begin, end).  The
+	//    length of the range must be a multiple of P::WIDTH.
+	//
+
+	template <class P>
+	inline void addRange (unsigned int begin, unsigned int end,
+	                      const typename P::Scalar* a_a,
+	                      const typename P::Scalar* a_b,
+	                      typename P::Scalar* a_result)
+	{
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+			P::store(a_result + i, P::add(P::load(a_a + i), P::load(a_b + i)));
+	}
+
+	template <class P>
+	inline void addScalarRange (unsigned int begin, unsigned int end,
+	                            const typename P::Scalar* a_a,
+	                            typename P::Scalar s,
+	                            typename P::Scalar* a_result)
+	{
+		typename P::Type sv = P::set1(s);
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+			P::store(a_result + i, P::add(P::load(a_a + i), sv));
+	}
+
+	template <class P>
+	inline void multiplyScalarRange (unsigned int begin, unsigned int end,
+	                                 const typename P::Scalar* a_a,
+	                                 typename P::Scalar s,
+	                                 typename P::Scalar* a_result)
+	{
+		typename P::Type sv = P::set1(s);
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+			P::store(a_result + i, P::mul(P::load(a_a + i), sv));
+	}
+
+	template <class P>
+	inline void multiplyAddRange (unsigned int begin, unsigned int end,
+	                              const typename P::Scalar* a_a,
+	                              const typename P::Scalar* a_b,
+	                              typename P::Scalar s,
+	                              typename P::Scalar* a_result)
+	{
+		typename P::Type sv = P::set1(s);
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+			P::store(a_result + i, P::add(P::load(a_a + i),
+			                              P::mul(P::load(a_b + i), sv)));
+	}
+
+	template <class P>
+	inline void lerpRange (unsigned int begin, unsigned int end,
+	                       const typename P::Scalar* a_a,
+	                       const typename P::Scalar* a_b,
+	                       const typename P::Scalar* a_t,
+	                       typename P::Scalar* a_result)
+	{
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+		{
+			typename P::Type a = P::load(a_a + i);
+			typename P::Type b = P::load(a_b + i);
+			P::store(a_result + i, P::add(a, P::mul(P::sub(b, a), P::load(a_t + i))));
+		}
+	}
+
+	template <class P>
+	inline void dotProduct2Range (unsigned int begin, unsigned int end,
+	                              const typename P::Scalar* a_ax,
+	                              const typename P::Scalar* a_ay,
+	                              const typename P::Scalar* a_bx,
+	                              const typename P::Scalar* a_by,
+	                              typename P::Scalar* a_result)
+	{
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+		{
+			typename P::Type xx = P::mul(P::load(a_ax + i), P::load(a_bx + i));
+			typename P::Type yy = P::mul(P::load(a_ay + i), P::load(a_by + i));
+			P::store(a_result + i, P::add(xx, yy));
+		}
+	}
+
+	template <class P>
+	inline void dotProduct3Range (unsigned int begin, unsigned int end,
+	                              const typename P::Scalar* a_ax,
+	                              const typename P::Scalar* a_ay,
+	                              const typename P::Scalar* a_az,
+	                              const typename P::Scalar* a_bx,
+	                              const typename P::Scalar* a_by,
+	                              const typename P::Scalar* a_bz,
+	                              typename P::Scalar* a_result)
+	{
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+		{
+			typename P::Type xx = P::mul(P::load(a_ax + i), P::load(a_bx + i));
+			typename P::Type yy = P::mul(P::load(a_ay + i), P::load(a_by + i));
+			typename P::Type zz = P::mul(P::load(a_az + i), P::load(a_bz + i));
+			P::store(a_result + i, P::add(P::add(xx, yy), zz));
+		}
+	}
+
+	template <class P>
+	inline void crossProduct3Range (unsigned int begin, unsigned int end,
+	                                const typename P::Scalar* a_ax,
+	                                const typename P::Scalar* a_ay,
+	                                const typename P::Scalar* a_az,
+	                                const typename P::Scalar* a_bx,
+	                                const typename P::Scalar* a_by,
+	                                const typename P::Scalar* a_bz,
+	                                typename P::Scalar* a_rx,
+	                                typename P::Scalar* a_ry,
+	                                typename P::Scalar* a_rz)
+	{
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+		{
+			typename P::Type ax = P::load(a_ax + i);
+			typename P::Type ay = P::load(a_ay + i);
+			typename P::Type az = P::load(a_az + i);
+			typename P::Type bx = P::load(a_bx + i);
+			typename P::Type by = P::load(a_by + i);
+			typename P::Type bz = P::load(a_bz + i);
+
+			// all loads happen first in case the result is an input
+			P::store(a_rx + i, P::sub(P::mul(ay, bz), P::mul(az, by)));
+			P::store(a_ry + i, P::sub(P::mul(az, bx), P::mul(ax, bz)));
+			P::store(a_rz + i, P::sub(P::mul(ax, by), P::mul(ay, bx)));
+		}
+	}
+
+	template <class P>
+	inline void normalize2Range (unsigned int begin, unsigned int end,
+	                             const typename P::Scalar* a_ax,
+	                             const typename P::Scalar* a_ay,
+	                             typename P::Scalar* a_rx,
+	                             typename P::Scalar* a_ry)
+	{
+		typename P::Type one = P::set1(1);
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+		{
+			typename P::Type x = P::load(a_ax + i);
+			typename P::Type y = P::load(a_ay + i);
+			typename P::Type norm_squared = P::add(P::mul(x, x), P::mul(y, y));
+
+			// zero vectors are scaled by 1 (left unchanged)
+			typename P::Type factor = P::selectPositive(norm_squared,
+			                                            P::div(one, P::sqrt(norm_squared)),
+			                                            one);
+			P::store(a_rx + i, P::mul(x, factor));
+			P::store(a_ry + i, P::mul(y, factor));
+		}
+	}
+
+	template <class P>
+	inline void normalize3Range (unsigned int begin, unsigned int end,
+	                             const typename P::Scalar* a_ax,
+	                             const typename P::Scalar* a_ay,
+	                             const typename P::Scalar* a_az,
+	                             typename P::Scalar* a_rx,
+	                             typename P::Scalar* a_ry,
+	                             typename P::Scalar* a_rz)
+	{
+		typename P::Type one = P::set1(1);
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+		{
+			typename P::Type x = P::load(a_ax + i);
+			typename P::Type y = P::load(a_ay + i);
+			typename P::Type z = P::load(a_az + i);
+			typename P::Type norm_squared = P::add(P::add(P::mul(x, x), P::mul(y, y)),
+			                                       P::mul(z, z));
+
+			// zero vectors are scaled by 1 (left unchanged)
+			typename P::Type factor = P::selectPositive(norm_squared,
+			                                            P::div(one, P::sqrt(norm_squared)),
+			                                            one);
+			P::store(a_rx + i, P::mul(x, factor));
+			P::store(a_ry + i, P::mul(y, factor));
+			P::store(a_rz + i, P::mul(z, factor));
+		}
+	}
+
+	template <class P>
+	inline void normalize4Range (unsigned int begin, unsigned int end,
+	                             const typename P::Scalar* a_aw,
+	                             const typename P::Scalar* a_ax,
+	                             const typename P::Scalar* a_ay,
+	                             const typename P::Scalar* a_az,
+	                             typename P::Scalar* a_rw,
+	                             typename P::Scalar* a_rx,
+	                             typename P::Scalar* a_ry,
+	                             typename P::Scalar* a_rz)
+	{
+		typename P::Type one = P::set1(1);
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+		{
+			typename P::Type w = P::load(a_aw + i);
+			typename P::Type x = P::load(a_ax + i);
+			typename P::Type y = P::load(a_ay + i);
+			typename P::Type z = P::load(a_az + i);
+			typename P::Type norm_squared = P::add(P::add(P::mul(w, w), P::mul(x, x)),
+			                                       P::add(P::mul(y, y), P::mul(z, z)));
+
+			// zero vectors are scaled by 1 (left unchanged)
+			typename P::Type factor = P::selectPositive(norm_squared,
+			                                            P::div(one, P::sqrt(norm_squared)),
+			                                            one);
+			P::store(a_rw + i, P::mul(w, factor));
+			P::store(a_rx + i, P::mul(x, factor));
+			P::store(a_ry + i, P::mul(y, factor));
+			P::store(a_rz + i, P::mul(z, factor));
+		}
+	}
+
+	template <class P>
+	inline void distanceSquared2Range (unsigned int begin, unsigned int end,
+	                                   const typename P::Scalar* a_ax,
+	                                   const typename P::Scalar* a_ay,
+	                                   typename P::Scalar px,
+	                                   typename P::Scalar py,
+	                                   typename P::Scalar* a_result)
+	{
+		typename P::Type pxv = P::set1(px);
+		typename P::Type pyv = P::set1(py);
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+		{
+			typename P::Type dx = P::sub(P::load(a_ax + i), pxv);
+			typename P::Type dy = P::sub(P::load(a_ay + i), pyv);
+			P::store(a_result + i, P::add(P::mul(dx, dx), P::mul(dy, dy)));
+		}
+	}
+
+	template <class P>
+	inline void distanceSquared3Range (unsigned int begin, unsigned int end,
+	                                   const typename P::Scalar* a_ax,
+	                                   const typename P::Scalar* a_ay,
+	                                   const typename P::Scalar* a_az,
+	                                   typename P::Scalar px,
+	                                   typename P::Scalar py,
+	                                   typename P::Scalar pz,
+	                                   typename P::Scalar* a_result)
+	{
+		typename P::Type pxv = P::set1(px);
+		typename P::Type pyv = P::set1(py);
+		typename P::Type pzv = P::set1(pz);
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+		{
+			typename P::Type dx = P::sub(P::load(a_ax + i), pxv);
+			typename P::Type dy = P::sub(P::load(a_ay + i), pyv);
+			typename P::Type dz = P::sub(P::load(a_az + i), pzv);
+			P::store(a_result + i, P::add(P::add(P::mul(dx, dx), P::mul(dy, dy)),
+			                              P::mul(dz, dz)));
+		}
+	}
+
+	template <class P>
+	inline void matrixProduct2Range (unsigned int begin, unsigned int end,
+	                                 const typename P::Scalar a_matrix[4],
+	                                 const typename P::Scalar* a_ax,
+	                                 const typename P::Scalar* a_ay,
+	                                 typename P::Scalar* a_rx,
+	                                 typename P::Scalar* a_ry)
+	{
+		typename P::Type m11 = P::set1(a_matrix[0]);
+		typename P::Type m12 = P::set1(a_matrix[1]);
+		typename P::Type m21 = P::set1(a_matrix[2]);
+		typename P::Type m22 = P::set1(a_matrix[3]);
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+		{
+			typename P::Type x = P::load(a_ax + i);
+			typename P::Type y = P::load(a_ay + i);
+			P::store(a_rx + i, P::add(P::mul(m11, x), P::mul(m12, y)));
+			P::store(a_ry + i, P::add(P::mul(m21, x), P::mul(m22, y)));
+		}
+	}
+
+	template <class P>
+	inline void matrixProduct3Range (unsigned int begin, unsigned int end,
+	                                 const typename P::Scalar a_matrix[9],
+	                                 const typename P::Scalar* a_ax,
+	                                 const typename P::Scalar* a_ay,
+	                                 const typename P::Scalar* a_az,
+	                                 typename P::Scalar* a_rx,
+	                                 typename P::Scalar* a_ry,
+	                                 typename P::Scalar* a_rz)
+	{
+		typename P::Type m[9];
+		for(unsigned int e = 0; e < 9; e++)
+			m[e] = P::set1(a_matrix[e]);
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+		{
+			typename P::Type x = P::load(a_ax + i);
+			typename P::Type y = P::load(a_ay + i);
+			typename P::Type z = P::load(a_az + i);
+			P::store(a_rx + i, P::add(P::add(P::mul(m[0], x), P::mul(m[1], y)), P::mul(m[2], z)));
+			P::store(a_ry + i, P::add(P::add(P::mul(m[3], x), P::mul(m[4], y)), P::mul(m[5], z)));
+			P::store(a_rz + i, P::add(P::add(P::mul(m[6], x), P::mul(m[7], y)), P::mul(m[8], z)));
+		}
+	}
+
+
+	template <class P>
+	inline void affineProduct3Range (unsigned int begin, unsigned int end,
+	                                 const typename P::Scalar a_matrix[12],
+	                                 const typename P::Scalar* a_ax,
+	                                 const typename P::Scalar* a_ay,
+	                                 const typename P::Scalar* a_az,
+	                                 typename P::Scalar* a_rx,
+	                                 typename P::Scalar* a_ry,
+	                                 typename P::Scalar* a_rz)
+	{
+		typename P::Type m[12];
+		for(unsigned int e = 0; e < 12; e++)
+			m[e] = P::set1(a_matrix[e]);
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+		{
+			typename P::Type x = P::load(a_ax + i);
+			typename P::Type y = P::load(a_ay + i);
+			typename P::Type z = P::load(a_az + i);
+			P::store(a_rx + i, P::add(P::add(P::mul(m[0], x), P::mul(m[1], y)), P::add(P::mul(m[ 2], z), m[ 3])));
+			P::store(a_ry + i, P::add(P::add(P::mul(m[4], x), P::mul(m[5], y)), P::add(P::mul(m[ 6], z), m[ 7])));
+			P::store(a_rz + i, P::add(P::add(P::mul(m[8], x), P::mul(m[9], y)), P::add(P::mul(m[10], z), m[11])));
+		}
+	}
+
+	template <class P>
+	inline void projectiveProduct3Range (unsigned int begin, unsigned int end,
+	                                     const typename P::Scalar a_matrix[16],
+	                                     const typename P::Scalar* a_ax,
+	                                     const typename P::Scalar* a_ay,
+	                                     const typename P::Scalar* a_az,
+	                                     typename P::Scalar* a_rx,
+	                                     typename P::Scalar* a_ry,
+	                                     typename P::Scalar* a_rz,
+	                                     typename P::Scalar* a_rw)
+	{
+		typename P::Type m[16];
+		for(unsigned int e = 0; e < 16; e++)
+			m[e] = P::set1(a_matrix[e]);
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+		{
+			typename P::Type x = P::load(a_ax + i);
+			typename P::Type y = P::load(a_ay + i);
+			typename P::Type z = P::load(a_az + i);
+			P::store(a_rx + i, P::add(P::add(P::mul(m[ 0], x), P::mul(m[ 1], y)), P::add(P::mul(m[ 2], z), m[ 3])));
+			P::store(a_ry + i, P::add(P::add(P::mul(m[ 4], x), P::mul(m[ 5], y)), P::add(P::mul(m[ 6], z), m[ 7])));
+			P::store(a_rz + i, P::add(P::add(P::mul(m[ 8], x), P::mul(m[ 9], y)), P::add(P::mul(m[10], z), m[11])));
+			P::store(a_rw + i, P::add(P::add(P::mul(m[12], x), P::mul(m[13], y)), P::add(P::mul(m[14], z), m[15])));
+		}
+	}
+
+	template <class P>
+	inline void rasterizeRowRange (unsigned int begin, unsigned int end,
+	                               const typename P::Scalar a_plane[11],
+	                               typename P::Scalar* a_depth)
+	{
+		typedef typename P::Scalar T;
+
+		// the offset of each element in a pack
+		static const T A_LANES[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+		typename P::Type lanes = P::load(A_LANES);
+		typename P::Type m[11];
+		for(unsigned int e = 0; e < 11; e++)
+			m[e] = P::set1(a_plane[e]);
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+		{
+			// the bias is added last so it is not rounded away
+			typename P::Type x  = P::add(P::set1((T)(i)), lanes);
+			typename P::Type e0 = P::add(P::add(m[0], P::mul(x, m[3])), m[8]);
+			typename P::Type e1 = P::add(P::add(m[1], P::mul(x, m[4])), m[9]);
+			typename P::Type e2 = P::add(P::add(m[2], P::mul(x, m[5])), m[10]);
+			typename P::Type z  = P::add(m[6], P::mul(x, m[7]));
+			typename P::Type inside = P::min(P::min(e0, e1), e2);
+			typename P::Type depth  = P::load(a_depth + i);
+			P::store(a_depth + i, P::selectPositive(inside, P::min(depth, z), depth));
+		}
+	}
+
+	template <class P>
+	inline void distanceStep3Range (unsigned int begin, unsigned int end,
+	                                const typename P::Scalar a_point[3],
+	                                const typename P::Scalar* a_ax,
+	                                const typename P::Scalar* a_ay,
+	                                const typename P::Scalar* a_az,
+	                                const typename P::Scalar* a_low,
+	                                const typename P::Scalar* a_high,
+	                                typename P::Scalar* a_steps)
+	{
+		typedef typename P::Scalar T;
+
+		typename P::Type px   = P::set1(a_point[0]);
+		typename P::Type py   = P::set1(a_point[1]);
+		typename P::Type pz   = P::set1(a_point[2]);
+		typename P::Type zero = P::set1((T)(0));
+		typename P::Type up   = P::set1((T)(1));
+		typename P::Type down = P::set1((T)(-1));
+		for(unsigned int i = begin; i < end; i += P::WIDTH)
+		{
+			typename P::Type dx = P::sub(P::load(a_ax + i), px);
+			typename P::Type dy = P::sub(P::load(a_ay + i), py);
+			typename P::Type dz = P::sub(P::load(a_az + i), pz);
+			typename P::Type d  = P::add(P::add(P::mul(dx, dx), P::mul(dy, dy)), P::mul(dz, dz));
+			typename P::Type step_up   = P::selectPositive(P::sub(d, P::load(a_high + i)), up, zero);
+			typename P::Type step_down = P::selectPositive(P::sub(P::load(a_low + i), d), down, zero);
+			P::store(a_steps + i, P::add(step_up, step_down));
+		}
+	}
+
+
+
+	//
+	//  MatrixPack
+	//
+	//  A helper to choose the pack type for 4x4 matrix
+	//    multiplication.  A matrix column only holds 4 values,
+	//    so wider pack types use the scalar version instead.
+	//
+	template <class P, bool IS_TOO_WIDE>
+	struct MatrixPack
+	{
+		typedef P Type;
+	};
+
+	template <class P>
+	struct MatrixPack<P, true>
+	{
+		typedef PackScalar<typename P::Scalar> Type;
+	};
+
+
+
+	//
+	//  The kernels themselves run the vector part of the range
+	//    and then the scalar remainder.
+	//
+
+	template <class P>
+	inline unsigned int getSplit (unsigned int count)
+	{
+		return count - count % P::WIDTH;
+	}
+
+	template <class P>
+	void kernelAdd (unsigned int count,
+	                const typename P::Scalar* a_a,
+	                const typename P::Scalar* a_b,
+	                typename P::Scalar* a_result)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		addRange<P>(0, split, a_a, a_b, a_result);
+		addRange<S>(split, count, a_a, a_b, a_result);
+	}
+
+	template <class P>
+	void kernelAddScalar (unsigned int count,
+	                      const typename P::Scalar* a_a,
+	                      typename P::Scalar s,
+	                      typename P::Scalar* a_result)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		addScalarRange<P>(0, split, a_a, s, a_result);
+		addScalarRange<S>(split, count, a_a, s, a_result);
+	}
+
+	template <class P>
+	void kernelMultiplyScalar (unsigned int count,
+	                           const typename P::Scalar* a_a,
+	                           typename P::Scalar s,
+	                           typename P::Scalar* a_result)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		multiplyScalarRange<P>(0, split, a_a, s, a_result);
+		multiplyScalarRange<S>(split, count, a_a, s, a_result);
+	}
+
+	template <class P>
+	void kernelMultiplyAdd (unsigned int count,
+	                        const typename P::Scalar* a_a,
+	                        const typename P::Scalar* a_b,
+	                        typename P::Scalar s,
+	                        typename P::Scalar* a_result)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		multiplyAddRange<P>(0, split, a_a, a_b, s, a_result);
+		multiplyAddRange<S>(split, count, a_a, a_b, s, a_result);
+	}
+
+	template <class P>
+	void kernelLerp (unsigned int count,
+	                 const typename P::Scalar* a_a,
+	                 const typename P::Scalar* a_b,
+	                 const typename P::Scalar* a_t,
+	                 typename P::Scalar* a_result)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		lerpRange<P>(0, split, a_a, a_b, a_t, a_result);
+		lerpRange<S>(split, count, a_a, a_b, a_t, a_result);
+	}
+
+	template <class P>
+	void kernelMinMax (unsigned int count,
+	                   const typename P::Scalar* a_a,
+	                   typename P::Scalar& r_min,
+	                   typename P::Scalar& r_max)
+	{
+		typedef typename P::Scalar T;
+		typedef PackScalar<T> S;
+
+		unsigned int split = getSplit<P>(count);
+		T min_value = a_a[0];
+		T max_value = a_a[0];
+
+		if(split > 0)
+		{
+			typename P::Type min_pack = P::load(a_a);
+			typename P::Type max_pack = min_pack;
+			for(unsigned int i = P::WIDTH; i < split; i += P::WIDTH)
+			{
+				typename P::Type v = P::load(a_a + i);
+				min_pack = P::min(min_pack, v);
+				max_pack = P::max(max_pack, v);
+			}
+			min_value = P::reduceMin(min_pack);
+			max_value = P::reduceMax(max_pack);
+		}
+		for(unsigned int i = split; i < count; i++)
+		{
+			min_value = S::min(min_value, a_a[i]);
+			max_value = S::max(max_value, a_a[i]);
+		}
+
+		r_min = min_value;
+		r_max = max_value;
+	}
+
+	template <class P>
+	void kernelDotProduct2 (unsigned int count,
+	                        const typename P::Scalar* a_ax,
+	                        const typename P::Scalar* a_ay,
+	                        const typename P::Scalar* a_bx,
+	                        const typename P::Scalar* a_by,
+	                        typename P::Scalar* a_result)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		dotProduct2Range<P>(0, split, a_ax, a_ay, a_bx, a_by, a_result);
+		dotProduct2Range<S>(split, count, a_ax, a_ay, a_bx, a_by, a_result);
+	}
+
+	template <class P>
+	void kernelDotProduct3 (unsigned int count,
+	                        const typename P::Scalar* a_ax,
+	                        const typename P::Scalar* a_ay,
+	                        const typename P::Scalar* a_az,
+	                        const typename P::Scalar* a_bx,
+	                        const typename P::Scalar* a_by,
+	                        const typename P::Scalar* a_bz,
+	                        typename P::Scalar* a_result)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		dotProduct3Range<P>(0, split, a_ax, a_ay, a_az, a_bx, a_by, a_bz, a_result);
+		dotProduct3Range<S>(split, count, a_ax, a_ay, a_az, a_bx, a_by, a_bz, a_result);
+	}
+
+	template <class P>
+	void kernelCrossProduct3 (unsigned int count,
+	                          const typename P::Scalar* a_ax,
+	                          const typename P::Scalar* a_ay,
+	                          const typename P::Scalar* a_az,
+	                          const typename P::Scalar* a_bx,
+	                          const typename P::Scalar* a_by,
+	                          const typename P::Scalar* a_bz,
+	                          typename P::Scalar* a_rx,
+	                          typename P::Scalar* a_ry,
+	                          typename P::Scalar* a_rz)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		crossProduct3Range<P>(0, split, a_ax, a_ay, a_az, a_bx, a_by, a_bz, a_rx, a_ry, a_rz);
+		crossProduct3Range<S>(split, count, a_ax, a_ay, a_az, a_bx, a_by, a_bz, a_rx, a_ry, a_rz);
+	}
+
+	template <class P>
+	void kernelNormalize2 (unsigned int count,
+	                       const typename P::Scalar* a_ax,
+	                       const typename P::Scalar* a_ay,
+	                       typename P::Scalar* a_rx,
+	                       typename P::Scalar* a_ry)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		normalize2Range<P>(0, split, a_ax, a_ay, a_rx, a_ry);
+		normalize2Range<S>(split, count, a_ax, a_ay, a_rx, a_ry);
+	}
+
+	template <class P>
+	void kernelNormalize3 (unsigned int count,
+	                       const typename P::Scalar* a_ax,
+	                       const typename P::Scalar* a_ay,
+	                       const typename P::Scalar* a_az,
+	                       typename P::Scalar* a_rx,
+	                       typename P::Scalar* a_ry,
+	                       typename P::Scalar* a_rz)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		normalize3Range<P>(0, split, a_ax, a_ay, a_az, a_rx, a_ry, a_rz);
+		normalize3Range<S>(split, count, a_ax, a_ay, a_az, a_rx, a_ry, a_rz);
+	}
+
+	template <class P>
+	void kernelNormalize4 (unsigned int count,
+	                       const typename P::Scalar* a_aw,
+	                       const typename P::Scalar* a_ax,
+	                       const typename P::Scalar* a_ay,
+	                       const typename P::Scalar* a_az,
+	                       typename P::Scalar* a_rw,
+	                       typename P::Scalar* a_rx,
+	                       typename P::Scalar* a_ry,
+	                       typename P::Scalar* a_rz)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		normalize4Range<P>(0, split, a_aw, a_ax, a_ay, a_az, a_rw, a_rx, a_ry, a_rz);
+		normalize4Range<S>(split, count, a_aw, a_ax, a_ay, a_az, a_rw, a_rx, a_ry, a_rz);
+	}
+
+	template <class P>
+	void kernelDistanceSquared2 (unsigned int count,
+	                             const typename P::Scalar* a_ax,
+	                             const typename P::Scalar* a_ay,
+	                             typename P::Scalar px,
+	                             typename P::Scalar py,
+	                             typename P::Scalar* a_result)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		distanceSquared2Range<P>(0, split, a_ax, a_ay, px, py, a_result);
+		distanceSquared2Range<S>(split, count, a_ax, a_ay, px, py, a_result);
+	}
+
+	template <class P>
+	void kernelDistanceSquared3 (unsigned int count,
+	                             const typename P::Scalar* a_ax,
+	                             const typename P::Scalar* a_ay,
+	                             const typename P::Scalar* a_az,
+	                             typename P::Scalar px,
+	                             typename P::Scalar py,
+	                             typename P::Scalar pz,
+	                             typename P::Scalar* a_result)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		distanceSquared3Range<P>(0, split, a_ax, a_ay, a_az, px, py, pz, a_result);
+		distanceSquared3Range<S>(split, count, a_ax, a_ay, a_az, px, py, pz, a_result);
+	}
+
+	template <class P>
+	void kernelMatrixProduct2 (unsigned int count,
+	                           const typename P::Scalar a_matrix[4],
+	                           const typename P::Scalar* a_ax,
+	                           const typename P::Scalar* a_ay,
+	                           typename P::Scalar* a_rx,
+	                           typename P::Scalar* a_ry)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		matrixProduct2Range<P>(0, split, a_matrix, a_ax, a_ay, a_rx, a_ry);
+		matrixProduct2Range<S>(split, count, a_matrix, a_ax, a_ay, a_rx, a_ry);
+	}
+
+	template <class P>
+	void kernelMatrixProduct3 (unsigned int count,
+	                           const typename P::Scalar a_matrix[9],
+	                           const typename P::Scalar* a_ax,
+	                           const typename P::Scalar* a_ay,
+	                           const typename P::Scalar* a_az,
+	                           typename P::Scalar* a_rx,
+	                           typename P::Scalar* a_ry,
+	                           typename P::Scalar* a_rz)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		matrixProduct3Range<P>(0, split, a_matrix, a_ax, a_ay, a_az, a_rx, a_ry, a_rz);
+		matrixProduct3Range<S>(split, count, a_matrix, a_ax, a_ay, a_az, a_rx, a_ry, a_rz);
+	}
+
+
+	template <class P>
+	void kernelAffineProduct3 (unsigned int count,
+	                           const typename P::Scalar a_matrix[12],
+	                           const typename P::Scalar* a_ax,
+	                           const typename P::Scalar* a_ay,
+	                           const typename P::Scalar* a_az,
+	                           typename P::Scalar* a_rx,
+	                           typename P::Scalar* a_ry,
+	                           typename P::Scalar* a_rz)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		affineProduct3Range<P>(0, split, a_matrix, a_ax, a_ay, a_az, a_rx, a_ry, a_rz);
+		affineProduct3Range<S>(split, count, a_matrix, a_ax, a_ay, a_az, a_rx, a_ry, a_rz);
+	}
+
+	template <class P>
+	void kernelProjectiveProduct3 (unsigned int count,
+	                               const typename P::Scalar a_matrix[16],
+	                               const typename P::Scalar* a_ax,
+	                               const typename P::Scalar* a_ay,
+	                               const typename P::Scalar* a_az,
+	                               typename P::Scalar* a_rx,
+	                               typename P::Scalar* a_ry,
+	                               typename P::Scalar* a_rz,
+	                               typename P::Scalar* a_rw)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		projectiveProduct3Range<P>(0, split, a_matrix, a_ax, a_ay, a_az, a_rx, a_ry, a_rz, a_rw);
+		projectiveProduct3Range<S>(split, count, a_matrix, a_ax, a_ay, a_az, a_rx, a_ry, a_rz, a_rw);
+	}
+
+	template <class P>
+	void kernelRasterizeRow (unsigned int count,
+	                         const typename P::Scalar a_plane[11],
+	                         typename P::Scalar* a_depth)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		rasterizeRowRange<P>(0, split, a_plane, a_depth);
+		rasterizeRowRange<S>(split, count, a_plane, a_depth);
+	}
+
+	template <class P>
+	void kernelDistanceStep3 (unsigned int count,
+	                          const typename P::Scalar a_point[3],
+	                          const typename P::Scalar* a_ax,
+	                          const typename P::Scalar* a_ay,
+	                          const typename P::Scalar* a_az,
+	                          const typename P::Scalar* a_low,
+	                          const typename P::Scalar* a_high,
+	                          typename P::Scalar* a_steps)
+	{
+		typedef PackScalar<typename P::Scalar> S;
+		unsigned int split = getSplit<P>(count);
+		distanceStep3Range<P>(0, split, a_point, a_ax, a_ay, a_az, a_low, a_high, a_steps);
+		distanceStep3Range<S>(split, count, a_point, a_ax, a_ay, a_az, a_low, a_high, a_steps);
+	}
+
+	template <class P>
+	void kernelMatrixMultiply4 (const typename P::Scalar a_left[16],
+	                            const typename P::Scalar a_right[16],
+	                            typename P::Scalar a_result[16])
+	{
+		typedef typename MatrixPack<P, (P::WIDTH > 4)>::Type M;
+
+		// each result column is a linear combination of the left columns
+		for(unsigned int r = 0; r < 4; r += M::WIDTH)
+		{
+			typename M::Type c0 = M::load(a_left +  0 + r);
+			typename M::Type c1 = M::load(a_left +  4 + r);
+			typename M::Type c2 = M::load(a_left +  8 + r);
+			typename M::Type c3 = M::load(a_left + 12 + r);
+			for(unsigned int c = 0; c < 4; c++)
+			{
+				const typename P::Scalar* a_column = a_right + c * 4;
+				typename M::Type sum01 = M::add(M::mul(c0, M::set1(a_column[0])),
+				                                M::mul(c1, M::set1(a_column[1])));
+				typename M::Type sum23 = M::add(M::mul(c2, M::set1(a_column[2])),
+				                                M::mul(c3, M::set1(a_column[3])));
+				M::store(a_result + c * 4 + r, M::add(sum01, sum23));
+			}
+		}
+	}
+
+
+
+	//
+	//  fillTable
+	//
+	//  Purpose: To fill in a kernel table with the kernels for
+	//           pack type P.
+	//  Parameter(s):
+	//    <1> r_table: The table to fill in
+	//  Precondition(s): N/A
+	//  Returns: N/A
+	//  Side Effect: All the function pointers in r_table are
+	//               set.
+	//
+	template <class P>
+	void fillTable (Table<typename P::Scalar>& r_table)
+	{
+		r_table.add              = &kernelAdd<P>;
+		r_table.addScalar        = &kernelAddScalar<P>;
+		r_table.multiplyScalar   = &kernelMultiplyScalar<P>;
+		r_table.multiplyAdd      = &kernelMultiplyAdd<P>;
+		r_table.lerp             = &kernelLerp<P>;
+		r_table.minMax           = &kernelMinMax<P>;
+		r_table.dotProduct2      = &kernelDotProduct2<P>;
+		r_table.dotProduct3      = &kernelDotProduct3<P>;
+		r_table.crossProduct3    = &kernelCrossProduct3<P>;
+		r_table.normalize2       = &kernelNormalize2<P>;
+		r_table.normalize3       = &kernelNormalize3<P>;
+		r_table.normalize4       = &kernelNormalize4<P>;
+		r_table.distanceSquared2 = &kernelDistanceSquared2<P>;
+		r_table.distanceSquared3 = &kernelDistanceSquared3<P>;
+		r_table.matrixProduct2   = &kernelMatrixProduct2<P>;
+		r_table.matrixProduct3   = &kernelMatrixProduct3<P>;
+		r_table.affineProduct3   = &kernelAffineProduct3<P>;
+		r_table.matrixMultiply4  = &kernelMatrixMultiply4<P>;
+		r_table.projectiveProduct3 = &kernelProjectiveProduct3<P>;
+		r_table.rasterizeRow       = &kernelRasterizeRow<P>;
+		r_table.distanceStep3      = &kernelDistanceStep3<P>;
+	}
+
+}  // end of anonymous namespace
+}  // end of namespace SimdKernels
+}  // end of namespace ObjLibrary
+
+
+
+#endif
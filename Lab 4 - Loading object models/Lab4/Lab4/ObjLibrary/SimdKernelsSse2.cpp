@@ -0,0 +1,142 @@
+//
+//  SimdKernelsSse2.cpp
+//
+//  The SSE2 versions of the SimdKernels functions.  SSE2 is
+//    available on every x64 processor.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include "SimdKernels.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define OBJ_LIBRARY_SIMD_SSE2
+  #include <emmintrin.h>
+#endif
+
+#include "SimdKernelsGeneric.h"
+
+using namespace std;
+using namespace ObjLibrary;
+using namespace ObjLibrary::SimdKernels;
+namespace
+{
+#ifdef OBJ_LIBRARY_SIMD_SSE2
+	struct PackSse2Float
+	{
+		typedef float Scalar;
+		typedef __m128 Type;
+		static const unsigned int WIDTH = 4;
+
+		static inline Type load (const float* a_values)  { return _mm_loadu_ps(a_values); }
+		static inline void store (float* a_values, Type v) { _mm_storeu_ps(a_values, v); }
+		static inline Type set1 (float value)            { return _mm_set1_ps(value); }
+		static inline Type add (Type a, Type b)           { return _mm_add_ps(a, b); }
+		static inline Type sub (Type a, Type b)           { return _mm_sub_ps(a, b); }
+		static inline Type mul (Type a, Type b)           { return _mm_mul_ps(a, b); }
+		static inline Type div (Type a, Type b)           { return _mm_div_ps(a, b); }
+		static inline Type sqrt (Type a)                  { return _mm_sqrt_ps(a); }
+		static inline Type min (Type a, Type b)           { return _mm_min_ps(a, b); }
+		static inline Type max (Type a, Type b)           { return _mm_max_ps(a, b); }
+
+		static inline Type selectPositive (Type t, Type a, Type b)
+		{
+			Type mask = _mm_cmpgt_ps(t, _mm_setzero_ps());
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+		}
+
+		static inline float reduceMin (Type v)
+		{
+			float a_values[WIDTH];
+			_mm_storeu_ps(a_values, v);
+			float result = a_values[0];
+			for(unsigned int i = 1; i < WIDTH; i++)
+				if(a_values[i] < result)
+					result = a_values[i];
+			return result;
+		}
+
+		static inline float reduceMax (Type v)
+		{
+			float a_values[WIDTH];
+			_mm_storeu_ps(a_values, v);
+			float result = a_values[0];
+			for(unsigned int i = 1; i < WIDTH; i++)
+				if(a_values[i] > result)
+					result = a_values[i];
+			return result;
+		}
+	};
+
+	struct PackSse2Double
+	{
+		typedef double Scalar;
+		typedef __m128d Type;
+		static const unsigned int WIDTH = 2;
+
+		static inline Type load (const double* a_values)  { return _mm_loadu_pd(a_values); }
+		static inline void store (double* a_values, Type v) { _mm_storeu_pd(a_values, v); }
+		static inline Type set1 (double value)            { return _mm_set1_pd(value); }
+		static inline Type add (Type a, Type b)            { return _mm_add_pd(a, b); }
+		static inline Type sub (Type a, Type b)            { return _mm_sub_pd(a, b); }
+		static inline Type mul (Type a, Type b)            { return _mm_mul_pd(a, b); }
+		static inline Type div (Type a, Type b)            { return _mm_div_pd(a, b); }
+		static inline Type sqrt (Type a)                   { return _mm_sqrt_pd(a); }
+		static inline Type min (Type a, Type b)            { return _mm_min_pd(a, b); }
+		static inline Type max (Type a, Type b)            { return _mm_max_pd(a, b); }
+
+		static inline Type selectPositive (Type t, Type a, Type b)
+		{
+			Type mask = _mm_cmpgt_pd(t, _mm_setzero_pd());
+			return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+		}
+
+		static inline double reduceMin (Type v)
+		{
+			double a_values[WIDTH];
+			_mm_storeu_pd(a_values, v);
+			return (a_values[1] < a_values[0]) ? a_values[1] : a_values[0];
+		}
+
+		static inline double reduceMax (Type v)
+		{
+			double a_values[WIDTH];
+			_mm_storeu_pd(a_values, v);
+			return (a_values[1] > a_values[0]) ? a_values[1] : a_values[0];
+		}
+	};
+#endif
+}
+
+
+
+void SimdKernels :: initializeTableSse2 (Table<float>& r_table)
+{
+#ifdef OBJ_LIBRARY_SIMD_SSE2
+	fillTable<PackSse2Float>(r_table);
+#else
+	initializeTableScalar(r_table);
+#endif
+}
+
+void SimdKernels :: initializeTableSse2 (Table<double>& r_table)
+{
+#ifdef OBJ_LIBRARY_SIMD_SSE2
+	fillTable<PackSse2Double>(r_table);
+#else
+	initializeTableScalar(r_table);
+#endif
+}
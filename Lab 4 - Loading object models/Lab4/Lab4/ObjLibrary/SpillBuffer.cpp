@@ -0,0 +1,315 @@
+//
+//  SpillBuffer.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cstdio>	// for remove
+#include <cstdint>	// for SIZE_MAX
+#include <string>
+#include <vector>
+#include <fstream>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#elif __WIN32__
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else	// Posix
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#include "SpillBuffer.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	//
+	//  WRITE_BUFFER_SIZE
+	//
+	//  The size of the buffer used to append to a temporary
+	//    file, in bytes.
+	//
+	const unsigned int WRITE_BUFFER_SIZE = 1 << 20;
+
+	//
+	//  mapFileWritable
+	//  unmapFileWritable
+	//
+	//  Purpose: To map a file into memory for reading and
+	//           writing, or to unmap it.
+	//  Parameter(s):
+	//    <1> filename: The name of the file
+	//    <2> size: The size of the file
+	//    <3> rp_data: A pointer to set to the mapped memory
+	//    <1> p_data: The mapped memory
+	//    <2> size: The size of the mapped memory
+	//  Precondition(s):
+	//    <1> size > 0
+	//    <2> p_data was returned by mapFileWritable with size
+	//        size
+	//  Returns: mapFileWritable returns whether file filename
+	//           could be mapped.
+	//  Side Effect: mapFileWritable sets rp_data.  No file
+	//               handles are left open.  unmapFileWritable
+	//               unmaps the memory.  Changes to the memory are
+	//               written back to the file.
+	//
+#if defined(_WIN32) || defined(__WIN32__)
+	bool mapFileWritable (const string& filename,
+	                      size_t size,
+	                      char*& rp_data)
+	{
+		assert(size > 0);
+
+		HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, 0,
+		                          NULL, OPEN_EXISTING, FILE_ATTRIBUTE_TEMPORARY, NULL);
+		if(file == INVALID_HANDLE_VALUE)
+			return false;
+
+		// the view keeps the mapping open after the handles
+		//   are closed
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, 0, 0, NULL);
+		CloseHandle(file);
+		if(mapping == NULL)
+			return false;
+		void* p_view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+		CloseHandle(mapping);
+		if(p_view == NULL)
+			return false;
+
+		rp_data = (char*)(p_view);
+		return true;
+	}
+
+	void unmapFileWritable (char* p_data, size_t size)
+	{
+		assert(p_data != NULL);
+
+		UnmapViewOfFile(p_data);
+	}
+#else	// Posix
+	bool mapFileWritable (const string& filename,
+	                      size_t size,
+	                      char*& rp_data)
+	{
+		assert(size > 0);
+
+		int file = ::open(filename.c_str(), O_RDWR);
+		if(file < 0)
+			return false;
+
+		// the mapping stays valid after the file is closed
+		void* p_map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+		::close(file);
+		if(p_map == MAP_FAILED)
+			return false;
+
+		rp_data = (char*)(p_map);
+		return true;
+	}
+
+	void unmapFileWritable (char* p_data, size_t size)
+	{
+		assert(p_data != NULL);
+
+		munmap(p_data, size);
+	}
+#endif
+
+}  // end of anonymous namespace
+
+
+
+SpillBuffer :: SpillBuffer ()
+		: m_file_name(),
+		  m_output(),
+		  mv_pending(),
+		  m_size(0),
+		  m_is_mapped(false),
+		  mp_data(NULL)
+{
+	assert(invariant());
+}
+
+SpillBuffer :: ~SpillBuffer ()
+{
+	destroy();
+}
+
+
+
+bool SpillBuffer :: isCreated () const
+{
+	return m_file_name != "";
+}
+
+bool SpillBuffer :: isMapped () const
+{
+	return m_is_mapped;
+}
+
+const string& SpillBuffer :: getFileName () const
+{
+	assert(isCreated());
+
+	return m_file_name;
+}
+
+unsigned long long SpillBuffer :: getSize () const
+{
+	return m_size;
+}
+
+const char* SpillBuffer :: getData () const
+{
+	assert(isMapped());
+
+	return mp_data;
+}
+
+char* SpillBuffer :: getData ()
+{
+	assert(isMapped());
+
+	return mp_data;
+}
+
+
+
+bool SpillBuffer :: create (const string& filename)
+{
+	assert(filename != "");
+
+	destroy();
+
+	m_output.open(filename.c_str(), ios::out | ios::binary | ios::trunc);
+	if(!m_output.is_open())
+	{
+		assert(invariant());
+		return false;
+	}
+	m_file_name = filename;
+
+	assert(invariant());
+	return true;
+}
+
+bool SpillBuffer :: append (const void* p_data, size_t size)
+{
+	assert(isCreated());
+	assert(!isMapped());
+	assert(p_data != NULL);
+
+	// small appends are collected so they can be written
+	//   together
+	if(mv_pending.size() + size > WRITE_BUFFER_SIZE && !flushPending())
+		return false;
+	if(size >= WRITE_BUFFER_SIZE)
+	{
+		m_output.write((const char*)(p_data), size);
+		if(!m_output)
+			return false;
+	}
+	else
+	{
+		const char* p_bytes = (const char*)(p_data);
+		mv_pending.insert(mv_pending.end(), p_bytes, p_bytes + size);
+	}
+
+	m_size += size;
+
+	assert(invariant());
+	return true;
+}
+
+bool SpillBuffer :: map ()
+{
+	assert(isCreated());
+	assert(!isMapped());
+
+	if(!flushPending())
+		return false;
+	m_output.close();
+	if(m_output.fail())
+		return false;
+
+	if(m_size > 0)
+	{
+		// the whole file must fit in the address space
+		if(m_size > (unsigned long long)(SIZE_MAX))
+			return false;
+		if(!mapFileWritable(m_file_name, (size_t)(m_size), mp_data))
+			return false;
+	}
+	m_is_mapped = true;
+
+	assert(invariant());
+	return true;
+}
+
+void SpillBuffer :: destroy ()
+{
+	if(mp_data != NULL)
+		unmapFileWritable(mp_data, (size_t)(m_size));
+	if(m_output.is_open())
+		m_output.close();
+	if(m_file_name != "")
+		remove(m_file_name.c_str());
+
+	m_output.clear();
+	mv_pending.clear();
+	m_file_name.clear();
+	m_size      = 0;
+	m_is_mapped = false;
+	mp_data     = NULL;
+
+	assert(invariant());
+}
+
+
+
+bool SpillBuffer :: flushPending ()
+{
+	assert(m_output.is_open());
+
+	if(!mv_pending.empty())
+	{
+		m_output.write(mv_pending.data(), mv_pending.size());
+		mv_pending.clear();
+	}
+	return !m_output.fail();
+}
+
+bool SpillBuffer :: invariant () const
+{
+	if(m_file_name == "" && m_size != 0) return false;
+	if(m_file_name == "" && m_is_mapped) return false;
+	if(m_is_mapped && m_output.is_open()) return false;
+	if(m_is_mapped && !mv_pending.empty()) return false;
+	if(!m_is_mapped && mp_data != NULL) return false;
+	if(m_is_mapped && (mp_data != NULL) != (m_size > 0)) return false;
+	return true;
+}
@@ -0,0 +1,253 @@
+//
+//  SpillBuffer.h
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_SPILL_BUFFER_H
+#define OBJ_LIBRARY_SPILL_BUFFER_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  SpillBuffer
+//
+//  A class to represent an array of bytes that is stored in a
+//    temporary file instead of in memory.  A SpillBuffer is
+//    filled by appending to the file through a small write
+//    buffer.  Once it is full, the file is mapped into memory
+//    for reading and writing, so the operating system can page
+//    the contents in and out as they are used.  This allows
+//    arrays much larger than the available memory to be
+//    processed, as long as they fit in the address space.
+//
+//  The temporary file is deleted when the SpillBuffer is
+//    destroyed.
+//
+class SpillBuffer
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new SpillBuffer without a file.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new SpillBuffer is created.
+//
+	SpillBuffer ();
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy this SpillBuffer.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The temporary file, if any, is unmapped and
+//               deleted.
+//
+	~SpillBuffer ();
+
+//
+//  isCreated
+//
+//  Purpose: To determine if this SpillBuffer has a temporary
+//           file.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this SpillBuffer has a temporary file.
+//  Side Effect: N/A
+//
+	bool isCreated () const;
+
+//
+//  isMapped
+//
+//  Purpose: To determine if this SpillBuffer has been mapped
+//           into memory.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this SpillBuffer has been mapped.
+//  Side Effect: N/A
+//
+	bool isMapped () const;
+
+//
+//  getFileName
+//
+//  Purpose: To determine the name of the temporary file for
+//           this SpillBuffer.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isCreated()
+//  Returns: The name of the temporary file.
+//  Side Effect: N/A
+//
+	const std::string& getFileName () const;
+
+//
+//  getSize
+//
+//  Purpose: To determine the number of bytes in this
+//           SpillBuffer.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of bytes appended to this SpillBuffer.
+//  Side Effect: N/A
+//
+	unsigned long long getSize () const;
+
+//
+//  getData
+//
+//  Purpose: To retrieve the contents of this SpillBuffer.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isMapped()
+//  Returns: A pointer to the first byte of this SpillBuffer in
+//           memory.  If getSize() == 0, NULL is returned.  The
+//           pointer remains valid until this SpillBuffer is
+//           destroyed.
+//  Side Effect: N/A
+//
+	const char* getData () const;
+	char* getData ();
+
+//
+//  create
+//
+//  Purpose: To create the temporary file for this SpillBuffer.
+//  Parameter(s):
+//    <1> filename: The name of the temporary file
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: Whether the file could be created.
+//  Side Effect: If this SpillBuffer has a temporary file, it is
+//               destroyed.  Then file filename is created,
+//               replacing any existing file with that name.
+//
+	bool create (const std::string& filename);
+
+//
+//  append
+//
+//  Purpose: To add bytes to the end of this SpillBuffer.
+//  Parameter(s):
+//    <1> p_data: A pointer to the bytes to add
+//    <2> size: The number of bytes to add
+//  Precondition(s):
+//    <1> isCreated()
+//    <2> !isMapped()
+//    <3> p_data != NULL
+//  Returns: Whether the bytes could be written.
+//  Side Effect: size bytes from p_data are added to the
+//               temporary file.
+//
+	bool append (const void* p_data, size_t size);
+
+//
+//  map
+//
+//  Purpose: To map this SpillBuffer into memory.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isCreated()
+//    <2> !isMapped()
+//  Returns: Whether the temporary file could be mapped.  This
+//           is false if the disk was full or the file is too
+//           large for the address space.
+//  Side Effect: All the bytes appended are written to the
+//               temporary file, which is then mapped into
+//               memory for reading and writing.  Changes made
+//               through getData are written back to the file
+//               by the operating system as needed.  Nothing
+//               more can be appended.
+//
+	bool map ();
+
+//
+//  destroy
+//
+//  Purpose: To remove the temporary file for this
+//           SpillBuffer.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If this SpillBuffer has a temporary file, it is
+//               unmapped, closed, and deleted.  Any pointers
+//               returned by getData become invalid.
+//
+	void destroy ();
+
+private:
+//
+//  Copy Constructor
+//  Assignment Operator
+//
+//  These functions have intentionally not been implemented
+//    because the temporary file can only be deleted once.
+//
+	SpillBuffer (const SpillBuffer& original);
+	SpillBuffer& operator= (const SpillBuffer& original);
+
+//
+//  flushPending
+//
+//  Purpose: To write the bytes waiting to be appended to the
+//           temporary file.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> m_output.is_open()
+//  Returns: Whether all the bytes could be written.
+//  Side Effect: The pending bytes are written to the
+//               temporary file and removed from mv_pending.
+//
+	bool flushPending ();
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	std::string m_file_name;
+	std::ofstream m_output;
+	std::vector<char> mv_pending;
+	unsigned long long m_size;
+	bool m_is_mapped;
+	char* mp_data;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
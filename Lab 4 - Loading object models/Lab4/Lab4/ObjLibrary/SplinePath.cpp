@@ -0,0 +1,408 @@
+//
+//  SplinePath.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "Vector3.h"
+#include "Vector3Array.h"
+#include "ObjModel.h"
+#include "SplinePath.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+const unsigned int SplinePath :: TYPE_CATMULL_ROM;
+const unsigned int SplinePath :: TYPE_BEZIER;
+const unsigned int SplinePath :: SAMPLES_PER_SEGMENT;
+
+
+
+bool SplinePath :: isControlPointCountValid (unsigned int count,
+                                             unsigned int type,
+                                             bool is_closed)
+{
+	assert(type == TYPE_CATMULL_ROM || type == TYPE_BEZIER);
+
+	if(type == TYPE_CATMULL_ROM)
+		return count >= 2;
+
+	if(is_closed)
+		return count >= 3 && count % 3 == 0;
+	else
+		return count >= 4 && count % 3 == 1;
+}
+
+
+
+SplinePath :: SplinePath ()
+		: m_type(TYPE_CATMULL_ROM),
+		  m_is_closed(false)
+{
+	assert(!isInitialized());
+}
+
+SplinePath :: SplinePath (const vector<Vector3>& control_points,
+                          unsigned int type,
+                          bool is_closed)
+		: m_type(TYPE_CATMULL_ROM),
+		  m_is_closed(false)
+{
+	assert(type == TYPE_CATMULL_ROM || type == TYPE_BEZIER);
+	assert(isControlPointCountValid((unsigned int)(control_points.size()), type, is_closed));
+
+	init(control_points, type, is_closed);
+
+	assert(isInitialized());
+}
+
+
+
+unsigned int SplinePath :: getType () const
+{
+	assert(isInitialized());
+
+	return m_type;
+}
+
+bool SplinePath :: isClosed () const
+{
+	assert(isInitialized());
+
+	return m_is_closed;
+}
+
+unsigned int SplinePath :: getControlPointCount () const
+{
+	assert(isInitialized());
+
+	return (unsigned int)(mv_control_points.size());
+}
+
+const Vector3& SplinePath :: getControlPoint (unsigned int index) const
+{
+	assert(isInitialized());
+	assert(index < getControlPointCount());
+
+	return mv_control_points[index];
+}
+
+unsigned int SplinePath :: getSegmentCount () const
+{
+	assert(isInitialized());
+
+	return (unsigned int)(mv_coefficients.size() / 4);
+}
+
+double SplinePath :: getLength () const
+{
+	assert(isInitialized());
+	assert(!mv_sample_distances.empty());
+
+	return mv_sample_distances.back();
+}
+
+Vector3 SplinePath :: getPoint (double parameter) const
+{
+	assert(isInitialized());
+
+	double t;
+	unsigned int segment = getSegmentAndFraction(parameter, t);
+	const Vector3* a_coefficients = &(mv_coefficients[segment * 4]);
+
+	return a_coefficients[0] +
+	       (a_coefficients[1] + (a_coefficients[2] + a_coefficients[3] * t) * t) * t;
+}
+
+Vector3 SplinePath :: getTangent (double parameter) const
+{
+	assert(isInitialized());
+
+	double t;
+	unsigned int segment = getSegmentAndFraction(parameter, t);
+	const Vector3* a_coefficients = &(mv_coefficients[segment * 4]);
+
+	return a_coefficients[1] +
+	       (a_coefficients[2] * 2.0 + a_coefficients[3] * (3.0 * t)) * t;
+}
+
+double SplinePath :: getParameterAtDistance (double distance) const
+{
+	assert(isInitialized());
+
+	double length = getLength();
+	if(length <= 0.0)
+		return 0.0;
+
+	if(m_is_closed)
+	{
+		distance = fmod(distance, length);
+		if(distance < 0.0)
+			distance += length;
+	}
+
+	// written this way so NaN goes to the start
+	if(!(distance > 0.0))
+		return 0.0;
+	if(distance >= length)
+		return getSegmentCount();
+
+	// find the sample from the table, then step forward if needed
+	unsigned int bucket_count = (unsigned int)(mv_distance_samples.size());
+	unsigned int bucket = (unsigned int)(distance / length * bucket_count);
+	if(bucket >= bucket_count)
+		bucket = bucket_count - 1;
+
+	unsigned int sample = mv_distance_samples[bucket];
+	unsigned int last_sample = (unsigned int)(mv_sample_distances.size()) - 1;
+	while(sample + 1 < last_sample && mv_sample_distances[sample + 1] <= distance)
+		sample++;
+	assert(sample < last_sample);
+
+	double start = mv_sample_distances[sample];
+	double span  = mv_sample_distances[sample + 1] - start;
+	double fraction = (span > 0.0) ? (distance - start) / span : 0.0;
+	if(fraction > 1.0)
+		fraction = 1.0;
+
+	return (sample + fraction) / SAMPLES_PER_SEGMENT;
+}
+
+Vector3 SplinePath :: getPointAtDistance (double distance) const
+{
+	assert(isInitialized());
+
+	return getPoint(getParameterAtDistance(distance));
+}
+
+Vector3 SplinePath :: getTangentAtDistance (double distance) const
+{
+	assert(isInitialized());
+
+	return getTangent(getParameterAtDistance(distance)).getNormalizedSafe();
+}
+
+template <typename T>
+void SplinePath :: getPointsAtDistances (const vector<double>& distances,
+                                         Vector3Array<T>& r_points) const
+{
+	assert(isInitialized());
+
+	unsigned int count = (unsigned int)(distances.size());
+	r_points.resize(count);
+	if(count == 0)
+		return;
+
+	T* a_x = r_points.getArrayX();
+	T* a_y = r_points.getArrayY();
+	T* a_z = r_points.getArrayZ();
+
+	for(unsigned int i = 0; i < count; i++)
+	{
+		Vector3 point = getPointAtDistance(distances[i]);
+		a_x[i] = (T)(point.x);
+		a_y[i] = (T)(point.y);
+		a_z[i] = (T)(point.z);
+	}
+}
+
+
+
+void SplinePath :: init (const vector<Vector3>& control_points,
+                         unsigned int type,
+                         bool is_closed)
+{
+	assert(type == TYPE_CATMULL_ROM || type == TYPE_BEZIER);
+	assert(isControlPointCountValid((unsigned int)(control_points.size()), type, is_closed));
+
+	mv_control_points = control_points;
+	m_type = type;
+	m_is_closed = is_closed;
+
+	calculateCoefficients();
+	calculateTables();
+
+	assert(isInitialized());
+}
+
+void SplinePath :: initFromPolyline (const ObjModel& model,
+                                     unsigned int mesh,
+                                     unsigned int polyline,
+                                     unsigned int type,
+                                     bool is_closed)
+{
+	assert(model.isValid());
+	assert(mesh < model.getMeshCount());
+	assert(polyline < model.getPolylineCount(mesh));
+	assert(type == TYPE_CATMULL_ROM || type == TYPE_BEZIER);
+	assert(isControlPointCountValid(model.getPolylineVertexCount(mesh, polyline), type, is_closed));
+
+	vector<Vector3> control_points;
+	for(unsigned int v = 0; v < model.getPolylineVertexCount(mesh, polyline); v++)
+	{
+		ObjModel::Index vertex = model.getPolylineVertexIndex(mesh, polyline, v);
+		control_points.push_back(model.getVertexPosition(vertex));
+	}
+
+	init(control_points, type, is_closed);
+}
+
+
+
+unsigned int SplinePath :: getSegmentAndFraction (double parameter,
+                                                  double& r_fraction) const
+{
+	assert(isInitialized());
+
+	unsigned int segment_count = getSegmentCount();
+	assert(segment_count >= 1);
+
+	if(m_is_closed)
+	{
+		parameter = fmod(parameter, (double)(segment_count));
+		if(parameter < 0.0)
+			parameter += segment_count;
+	}
+
+	if(!(parameter > 0.0))
+	{
+		r_fraction = 0.0;
+		return 0;
+	}
+	if(parameter >= segment_count)
+	{
+		r_fraction = 1.0;
+		return segment_count - 1;
+	}
+
+	unsigned int segment = (unsigned int)(parameter);
+	if(segment >= segment_count)
+		segment = segment_count - 1;
+	r_fraction = parameter - segment;
+	return segment;
+}
+
+void SplinePath :: calculateCoefficients ()
+{
+	unsigned int point_count = (unsigned int)(mv_control_points.size());
+	assert(isControlPointCountValid(point_count, m_type, m_is_closed));
+
+	mv_coefficients.clear();
+
+	if(m_type == TYPE_CATMULL_ROM)
+	{
+		unsigned int segment_count = m_is_closed ? point_count : point_count - 1;
+		for(unsigned int s = 0; s < segment_count; s++)
+		{
+			Vector3 p1 = mv_control_points[s];
+			Vector3 p2 = mv_control_points[(s + 1) % point_count];
+			Vector3 p0;
+			Vector3 p3;
+
+			// open paths reflect the neighbouring point at the ends
+			if(s > 0 || m_is_closed)
+				p0 = mv_control_points[(s + point_count - 1) % point_count];
+			else
+				p0 = p1 * 2.0 - p2;
+			if(s + 2 < point_count || m_is_closed)
+				p3 = mv_control_points[(s + 2) % point_count];
+			else
+				p3 = p2 * 2.0 - p1;
+
+			mv_coefficients.push_back(p1);
+			mv_coefficients.push_back((p2 - p0) * 0.5);
+			mv_coefficients.push_back((p0 * 2.0 - p1 * 5.0 + p2 * 4.0 - p3) * 0.5);
+			mv_coefficients.push_back((p1 * 3.0 - p0 - p2 * 3.0 + p3) * 0.5);
+		}
+	}
+	else
+	{
+		assert(m_type == TYPE_BEZIER);
+
+		unsigned int segment_count = m_is_closed ? point_count / 3 : (point_count - 1) / 3;
+		for(unsigned int s = 0; s < segment_count; s++)
+		{
+			const Vector3& q0 = mv_control_points[s * 3];
+			const Vector3& q1 = mv_control_points[s * 3 + 1];
+			const Vector3& q2 = mv_control_points[s * 3 + 2];
+			const Vector3& q3 = mv_control_points[(s * 3 + 3) % point_count];
+
+			mv_coefficients.push_back(q0);
+			mv_coefficients.push_back((q1 - q0) * 3.0);
+			mv_coefficients.push_back((q0 - q1 * 2.0 + q2) * 3.0);
+			mv_coefficients.push_back(q1 * 3.0 - q0 - q2 * 3.0 + q3);
+		}
+	}
+
+	assert(mv_coefficients.size() >= 4);
+	assert(mv_coefficients.size() % 4 == 0);
+}
+
+void SplinePath :: calculateTables ()
+{
+	assert(mv_coefficients.size() >= 4);
+
+	unsigned int segment_count = (unsigned int)(mv_coefficients.size() / 4);
+	unsigned int sample_count  = segment_count * SAMPLES_PER_SEGMENT;
+
+	mv_sample_distances.resize(sample_count + 1);
+	mv_sample_distances[0] = 0.0;
+
+	Vector3 previous = mv_coefficients[0];
+	for(unsigned int s = 0; s < segment_count; s++)
+	{
+		const Vector3* a_coefficients = &(mv_coefficients[s * 4]);
+		for(unsigned int i = 1; i <= SAMPLES_PER_SEGMENT; i++)
+		{
+			double t = (double)(i) / SAMPLES_PER_SEGMENT;
+			Vector3 current = a_coefficients[0] +
+			                  (a_coefficients[1] + (a_coefficients[2] + a_coefficients[3] * t) * t) * t;
+
+			unsigned int sample = s * SAMPLES_PER_SEGMENT + i;
+			mv_sample_distances[sample] = mv_sample_distances[sample - 1] +
+			                              previous.getDistance(current);
+			previous = current;
+		}
+	}
+
+	// one bucket per sample, so each bucket has about one sample
+	double length = mv_sample_distances.back();
+	mv_distance_samples.resize(sample_count);
+	unsigned int sample = 0;
+	for(unsigned int b = 0; b < sample_count; b++)
+	{
+		double distance = length * b / sample_count;
+		while(sample + 1 < sample_count && mv_sample_distances[sample + 1] <= distance)
+			sample++;
+		mv_distance_samples[b] = sample;
+	}
+}
+
+
+
+//
+//  The batch functions are only available for the same types
+//    as Vector3Array.
+//
+
+template void SplinePath :: getPointsAtDistances<float>  (const vector<double>&, Vector3Array<float>&)  const;
+template void SplinePath :: getPointsAtDistances<double> (const vector<double>&, Vector3Array<double>&) const;
@@ -0,0 +1,454 @@
+//
+//  SplinePath.h
+//
+//  A module to represent smooth paths through space.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_SPLINE_PATH_H
+#define OBJ_LIBRARY_SPLINE_PATH_H
+
+#include <vector>
+
+#include "Vector3.h"
+#include "Vector3Array.h"
+
+
+
+namespace ObjLibrary
+{
+
+class ObjModel;
+
+
+
+//
+//  SplinePath
+//
+//  A class to represent a smooth path made of cubic curve
+//    segments.  There are two kinds of path:
+//      <1> Catmull-Rom: The path passes through every control
+//          point.  There is one segment between each pair of
+//          adjacent control points.
+//      <2> Bezier: The control points are grouped as
+//          (start, handle, handle, end, handle, handle, end,
+//          ...).  The path passes through the start and end
+//          points and is pulled towards the handles.
+//    A path can be open or closed.  A closed path connects its
+//    last control point back to its first.
+//
+//  A path can be evaluated in two ways.  A parameter value
+//    from 0 to getSegmentCount() selects a segment and a
+//    position within it, but equal changes in the parameter
+//    do not give equal distances along the path.  A distance
+//    from 0 to getLength() gives constant-speed movement.
+//
+//  When a path is initialized, each segment is sampled at
+//    SAMPLES_PER_SEGMENT points and a table of the distance
+//    along the path to each sample is built.  A second table
+//    maps evenly-spaced distances to samples.  Converting a
+//    distance to a parameter is therefore a table lookup plus
+//    (usually) one or two comparisons, with no root-finding.
+//    Between samples, the distance is interpolated linearly,
+//    so the error is very small for smooth paths.
+//
+class SplinePath
+{
+public:
+//
+//  TYPE_CATMULL_ROM
+//
+//  A constant indicating a Catmull-Rom spline path.
+//
+	static const unsigned int TYPE_CATMULL_ROM = 0;
+
+//
+//  TYPE_BEZIER
+//
+//  A constant indicating a path of cubic Bezier curves.
+//
+	static const unsigned int TYPE_BEZIER = 1;
+
+//
+//  SAMPLES_PER_SEGMENT
+//
+//  The number of samples taken along each segment to build
+//    the arc-length tables.
+//
+	static const unsigned int SAMPLES_PER_SEGMENT = 32;
+
+public:
+//
+//  isControlPointCountValid
+//
+//  Purpose: To determine if the specified number of control
+//           points is valid for a path.
+//  Parameter(s):
+//    <1> count: The number of control points
+//    <2> type: The type of path
+//    <3> is_closed: Whether the path is closed
+//  Precondition(s):
+//    <1> type == TYPE_CATMULL_ROM || type == TYPE_BEZIER
+//  Returns: Whether a path of type type with count control
+//           points is possible.  A Catmull-Rom path needs at
+//           least 2 control points.  An open Bezier path
+//           needs 3n + 1 control points and a closed one needs
+//           3n, for some n >= 1.
+//  Side Effect: N/A
+//
+	static bool isControlPointCountValid (unsigned int count,
+	                                      unsigned int type,
+	                                      bool is_closed);
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new SplinePath with no control points.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new, uninitialized SplinePath is created.
+//
+	SplinePath ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a new SplinePath through the specified
+//           control points.
+//  Parameter(s):
+//    <1> control_points: The control points
+//    <2> type: The type of path
+//    <3> is_closed: Whether the path is closed
+//  Precondition(s):
+//    <1> type == TYPE_CATMULL_ROM || type == TYPE_BEZIER
+//    <2> isControlPointCountValid(control_points.size(), type,
+//                                 is_closed)
+//    <3> control_points[i].isFinite() for all i
+//  Returns: N/A
+//  Side Effect: A new SplinePath is created with the specified
+//               control points.
+//
+	SplinePath (const std::vector<Vector3>& control_points,
+	            unsigned int type,
+	            bool is_closed);
+
+//
+//  isInitialized
+//
+//  Purpose: To determine if this SplinePath has control
+//           points.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this SplinePath has been initialized.
+//  Side Effect: N/A
+//
+	bool isInitialized () const
+	{ return !mv_control_points.empty(); }
+
+//
+//  getType
+//
+//  Purpose: To determine the type of this SplinePath.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: TYPE_CATMULL_ROM or TYPE_BEZIER.
+//  Side Effect: N/A
+//
+	unsigned int getType () const;
+
+//
+//  isClosed
+//
+//  Purpose: To determine if this SplinePath is closed.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: Whether this SplinePath returns to its start.
+//  Side Effect: N/A
+//
+	bool isClosed () const;
+
+//
+//  getControlPointCount
+//
+//  Purpose: To determine the number of control points.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: The number of control points.
+//  Side Effect: N/A
+//
+	unsigned int getControlPointCount () const;
+
+//
+//  getControlPoint
+//
+//  Purpose: To retrieve a control point.
+//  Parameter(s):
+//    <1> index: Which control point
+//  Precondition(s):
+//    <1> isInitialized()
+//    <2> index < getControlPointCount()
+//  Returns: Control point index.
+//  Side Effect: N/A
+//
+	const Vector3& getControlPoint (unsigned int index) const;
+
+//
+//  getSegmentCount
+//
+//  Purpose: To determine the number of curve segments.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: The number of segments.
+//  Side Effect: N/A
+//
+	unsigned int getSegmentCount () const;
+
+//
+//  getLength
+//
+//  Purpose: To determine the length of this SplinePath.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: The length of the path, as measured by the
+//           samples.
+//  Side Effect: N/A
+//
+	double getLength () const;
+
+//
+//  getPoint
+//
+//  Purpose: To determine the position at the specified
+//           parameter value.
+//  Parameter(s):
+//    <1> parameter: The parameter value
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: The position on the path.  The integer part of
+//           parameter selects the segment and the fractional
+//           part the position within it.  Values outside
+//           [0, getSegmentCount()] are clamped, or wrapped if
+//           the path is closed.
+//  Side Effect: N/A
+//
+	Vector3 getPoint (double parameter) const;
+
+//
+//  getTangent
+//
+//  Purpose: To determine the direction of this SplinePath at
+//           the specified parameter value.
+//  Parameter(s):
+//    <1> parameter: The parameter value
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: The derivative of the path with respect to the
+//           parameter, as for getPoint.  This is not
+//           normalized and may be the zero vector.
+//  Side Effect: N/A
+//
+	Vector3 getTangent (double parameter) const;
+
+//
+//  getParameterAtDistance
+//
+//  Purpose: To determine the parameter value at the specified
+//           distance along this SplinePath.
+//  Parameter(s):
+//    <1> distance: The distance from the start
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: The parameter value.  distance is clamped to
+//           [0, getLength()], or wrapped if the path is
+//           closed.
+//  Side Effect: N/A
+//
+	double getParameterAtDistance (double distance) const;
+
+//
+//  getPointAtDistance
+//
+//  Purpose: To determine the position at the specified
+//           distance along this SplinePath.
+//  Parameter(s):
+//    <1> distance: The distance from the start
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: getPoint(getParameterAtDistance(distance)).
+//  Side Effect: N/A
+//
+	Vector3 getPointAtDistance (double distance) const;
+
+//
+//  getTangentAtDistance
+//
+//  Purpose: To determine the direction of travel at the
+//           specified distance along this SplinePath.
+//  Parameter(s):
+//    <1> distance: The distance from the start
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: The normalized tangent at distance distance.  If
+//           the tangent is the zero vector, the zero vector is
+//           returned.
+//  Side Effect: N/A
+//
+	Vector3 getTangentAtDistance (double distance) const;
+
+//
+//  getPointsAtDistances
+//
+//  Purpose: To determine the positions at many distances
+//           along this SplinePath at once.
+//  Parameter(s):
+//    <1> distances: The distances from the start
+//    <2> r_points: A Vector3Array to fill with the positions
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: r_points is resized to distances.size() and
+//               element i is set to
+//               getPointAtDistance(distances[i]).
+//
+	template <typename T>
+	void getPointsAtDistances (const std::vector<double>& distances,
+	                           Vector3Array<T>& r_points) const;
+
+//
+//  init
+//
+//  Purpose: To set the control points for this SplinePath.
+//  Parameter(s):
+//    <1> control_points: The control points
+//    <2> type: The type of path
+//    <3> is_closed: Whether the path is closed
+//  Precondition(s):
+//    <1> type == TYPE_CATMULL_ROM || type == TYPE_BEZIER
+//    <2> isControlPointCountValid(control_points.size(), type,
+//                                 is_closed)
+//    <3> control_points[i].isFinite() for all i
+//  Returns: N/A
+//  Side Effect: This SplinePath is set to have the specified
+//               control points.  The arc-length tables are
+//               recalculated.
+//
+	void init (const std::vector<Vector3>& control_points,
+	           unsigned int type,
+	           bool is_closed);
+
+//
+//  initFromPolyline
+//
+//  Purpose: To set the control points for this SplinePath to
+//           the vertexes of a polyline in an ObjModel.
+//  Parameter(s):
+//    <1> model: The ObjModel
+//    <2> mesh: The mesh containing the polyline
+//    <3> polyline: Which polyline in mesh mesh
+//    <4> type: The type of path
+//    <5> is_closed: Whether the path is closed
+//  Precondition(s):
+//    <1> model.isValid()
+//    <2> mesh < model.getMeshCount()
+//    <3> polyline < model.getPolylineCount(mesh)
+//    <4> type == TYPE_CATMULL_ROM || type == TYPE_BEZIER
+//    <5> isControlPointCountValid(
+//            model.getPolylineVertexCount(mesh, polyline),
+//            type, is_closed)
+//  Returns: N/A
+//  Side Effect: This SplinePath is set to have the positions
+//               of the polyline vertexes as its control points.
+//               model is not referenced after this function
+//               returns.
+//
+	void initFromPolyline (const ObjModel& model,
+	                       unsigned int mesh,
+	                       unsigned int polyline,
+	                       unsigned int type,
+	                       bool is_closed);
+
+private:
+//
+//  getSegmentAndFraction
+//
+//  Purpose: To split a parameter value into a segment and a
+//           position within it.
+//  Parameter(s):
+//    <1> parameter: The parameter value
+//    <2> r_fraction: A reference to set to the position
+//                    within the segment
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: The segment, after clamping or wrapping parameter.
+//  Side Effect: r_fraction is set to a value in [0, 1].
+//
+	unsigned int getSegmentAndFraction (double parameter,
+	                                    double& r_fraction) const;
+
+//
+//  calculateCoefficients
+//
+//  Purpose: To calculate the polynomial for each segment.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> mv_control_points is set
+//  Returns: N/A
+//  Side Effect: mv_coefficients is set to contain 4 Vector3s
+//               (a, b, c, d) for each segment, such that the
+//               segment is a + bt + ct^2 + dt^3 for t in
+//               [0, 1].
+//
+	void calculateCoefficients ();
+
+//
+//  calculateTables
+//
+//  Purpose: To calculate the arc-length tables.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> mv_coefficients is set
+//  Returns: N/A
+//  Side Effect: mv_sample_distances and mv_distance_samples are
+//               recalculated.
+//
+	void calculateTables ();
+
+private:
+	std::vector<Vector3> mv_control_points;
+	unsigned int m_type;
+	bool m_is_closed;
+
+	std::vector<Vector3> mv_coefficients;
+
+	// distance to each sample, starting with 0.0
+	std::vector<double> mv_sample_distances;
+	// for evenly-spaced distances, the last sample before it
+	std::vector<unsigned int> mv_distance_samples;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -0,0 +1,137 @@
+//
+//  SystemScheduler.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "EntityRegistry.h"
+#include "JobSystem.h"
+#include "SystemScheduler.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+SystemScheduler :: SystemScheduler ()
+		: m_phase_count(0),
+		  m_thread_count(JobSystem::getShared().getWorkerCount() + 1)
+{
+}
+
+
+
+const string& SystemScheduler :: getSystemName (unsigned int system) const
+{
+	assert(system < getSystemCount());
+
+	return mv_systems[system].m_name;
+}
+
+unsigned int SystemScheduler :: getSystemPhase (unsigned int system) const
+{
+	assert(system < getSystemCount());
+
+	return mv_systems[system].m_phase;
+}
+
+
+
+unsigned int SystemScheduler :: addSystem (const string& name,
+                                           unsigned int reads,
+                                           unsigned int writes,
+                                           const SystemFunction& function)
+{
+	assert(function);
+
+	System system;
+	system.m_name     = name;
+	system.m_reads    = reads;
+	system.m_writes   = writes;
+	system.m_function = function;
+	system.m_phase    = 0;
+
+	for(unsigned int i = 0; i < mv_systems.size(); i++)
+	{
+		const System& earlier = mv_systems[i];
+		if(earlier.m_phase >= system.m_phase &&
+		   isConflict(earlier.m_reads, earlier.m_writes, reads, writes))
+		{
+			system.m_phase = earlier.m_phase + 1;
+		}
+	}
+
+	if(system.m_phase >= m_phase_count)
+		m_phase_count = system.m_phase + 1;
+	mv_systems.push_back(system);
+	return (unsigned int)(mv_systems.size() - 1);
+}
+
+void SystemScheduler :: setThreadCount (unsigned int thread_count)
+{
+	assert(thread_count >= 1);
+
+	m_thread_count = thread_count;
+}
+
+void SystemScheduler :: run (EntityRegistry& r_registry, double seconds)
+{
+	JobSystem& r_jobs = JobSystem::getShared();
+	vector<unsigned int> v_jobs;
+	for(unsigned int p = 0; p < m_phase_count; p++)
+	{
+		// add the other systems in the phase as jobs and run
+		//  the last one here
+		const System* p_last = NULL;
+		for(unsigned int i = 0; i < mv_systems.size(); i++)
+		{
+			if(mv_systems[i].m_phase != p)
+				continue;
+
+			if(p_last != NULL)
+			{
+				if(v_jobs.size() + 1 < m_thread_count)
+				{
+					const SystemFunction& function = p_last->m_function;
+					v_jobs.push_back(r_jobs.add([&function, &r_registry, seconds] ()
+					                            { function(r_registry, seconds); },
+					                            JobSystem::PRIORITY_HIGH));
+				}
+				else
+					p_last->m_function(r_registry, seconds);
+			}
+			p_last = &(mv_systems[i]);
+		}
+
+		if(p_last != NULL)
+			p_last->m_function(r_registry, seconds);
+
+		for(unsigned int j = 0; j < v_jobs.size(); j++)
+			r_jobs.wait(v_jobs[j]);
+		v_jobs.clear();
+	}
+}
+
+void SystemScheduler :: clear ()
+{
+	mv_systems.clear();
+	m_phase_count = 0;
+}
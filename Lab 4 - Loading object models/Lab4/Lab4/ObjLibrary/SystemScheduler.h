@@ -0,0 +1,265 @@
+//
+//  SystemScheduler.h
+//
+//  A module to run systems on an EntityRegistry in parallel.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_SYSTEM_SCHEDULER_H
+#define OBJ_LIBRARY_SYSTEM_SCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <functional>
+
+
+
+namespace ObjLibrary
+{
+
+class EntityRegistry;
+
+
+
+//
+//  SystemScheduler
+//
+//  A class to run a list of systems on an EntityRegistry each
+//    frame.  A system is a function that loops over some of the
+//    component pools.  Each system declares which component
+//    types it reads and which it writes, using the COMPONENT_*
+//    bits in EntityRegistry.
+//
+//  Two systems conflict if either writes a component type the
+//    other reads or writes.  The systems are divided into
+//    phases, which are run one after another.  The systems in
+//    a phase do not conflict with each other, so they are run
+//    at the same time as jobs on the shared JobSystem.  Each
+//    system is placed in the earliest phase after every earlier
+//    system it conflicts with, so systems that conflict always
+//    run in the order they were added.
+//
+//  Systems must not create or destroy entities or add or remove
+//    components, because other systems may be reading the pools
+//    at the same time.  Structural changes should be made
+//    between calls to run.
+//
+class SystemScheduler
+{
+public:
+//
+//  SystemFunction
+//
+//  The type of a system.  The parameters are the EntityRegistry
+//    and the time since the last frame, in seconds.
+//
+	typedef std::function<void (EntityRegistry&, double)> SystemFunction;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new SystemScheduler with no systems.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new SystemScheduler is created.  It will use
+//               the calling thread and all the workers of the
+//               shared JobSystem.
+//
+	SystemScheduler ();
+
+//
+//  getSystemCount
+//
+//  Purpose: To determine the number of systems.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of systems that have been added.
+//  Side Effect: N/A
+//
+	unsigned int getSystemCount () const
+	{ return (unsigned int)(mv_systems.size()); }
+
+//
+//  getSystemName
+//
+//  Purpose: To determine the name of a system.
+//  Parameter(s):
+//    <1> system: Which system
+//  Precondition(s):
+//    <1> system < getSystemCount()
+//  Returns: The name system system was added with.
+//  Side Effect: N/A
+//
+	const std::string& getSystemName (unsigned int system) const;
+
+//
+//  getPhaseCount
+//
+//  Purpose: To determine how many phases the systems are run
+//           in.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of phases.  If no systems conflict, this
+//           is 1 (or 0 if there are no systems).
+//  Side Effect: N/A
+//
+	unsigned int getPhaseCount () const
+	{ return m_phase_count; }
+
+//
+//  getSystemPhase
+//
+//  Purpose: To determine which phase a system is run in.
+//  Parameter(s):
+//    <1> system: Which system
+//  Precondition(s):
+//    <1> system < getSystemCount()
+//  Returns: The phase system system is run in.
+//  Side Effect: N/A
+//
+	unsigned int getSystemPhase (unsigned int system) const;
+
+//
+//  getThreadCount
+//
+//  Purpose: To determine the maximum number of threads used.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The maximum number of systems run at once.
+//  Side Effect: N/A
+//
+	unsigned int getThreadCount () const
+	{ return m_thread_count; }
+
+//
+//  isConflict
+//
+//  Purpose: To determine if two systems may not run at the same
+//           time.
+//  Parameter(s):
+//    <1> reads1
+//    <2> writes1: The component types read and written by the
+//                 first system
+//    <3> reads2
+//    <4> writes2: The component types read and written by the
+//                 second system
+//  Precondition(s): N/A
+//  Returns: Whether either system writes a component type that
+//           the other reads or writes.
+//  Side Effect: N/A
+//
+	static bool isConflict (unsigned int reads1,
+	                        unsigned int writes1,
+	                        unsigned int reads2,
+	                        unsigned int writes2)
+	{
+		return (writes1 & (reads2 | writes2)) != 0 ||
+		       (writes2 & reads1) != 0;
+	}
+
+//
+//  addSystem
+//
+//  Purpose: To add a system.
+//  Parameter(s):
+//    <1> name: The name of the system
+//    <2> reads: The component types the system reads
+//    <3> writes: The component types the system writes
+//    <4> function: The system function
+//  Precondition(s):
+//    <1> function
+//  Returns: The index of the new system.
+//  Side Effect: A new system is added after all existing
+//               systems.  It is placed in the earliest phase
+//               after every system it conflicts with.
+//
+	unsigned int addSystem (const std::string& name,
+	                        unsigned int reads,
+	                        unsigned int writes,
+	                        const SystemFunction& function);
+
+//
+//  setThreadCount
+//
+//  Purpose: To change the maximum number of threads used.
+//  Parameter(s):
+//    <1> thread_count: The maximum number of systems to run
+//                      at once
+//  Precondition(s):
+//    <1> thread_count >= 1
+//  Returns: N/A
+//  Side Effect: At most thread_count systems will be run at the
+//               same time.  If thread_count is 1, the systems
+//               are run in order on the calling thread.
+//
+	void setThreadCount (unsigned int thread_count);
+
+//
+//  run
+//
+//  Purpose: To run all the systems once.
+//  Parameter(s):
+//    <1> r_registry: The EntityRegistry to run the systems on
+//    <2> seconds: The time since the last frame
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Each system is called with r_registry and
+//               seconds.  The systems in each phase are run in
+//               parallel.  This function returns once all the
+//               systems are done.
+//
+	void run (EntityRegistry& r_registry, double seconds);
+
+//
+//  clear
+//
+//  Purpose: To remove all systems.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All systems are removed.
+//
+	void clear ();
+
+private:
+//
+//  System
+//
+//  A record to store a system and where it is run.
+//
+	struct System
+	{
+		std::string m_name;
+		unsigned int m_reads;
+		unsigned int m_writes;
+		SystemFunction m_function;
+		unsigned int m_phase;
+	};
+
+private:
+	std::vector<System> mv_systems;
+	unsigned int m_phase_count;
+	unsigned int m_thread_count;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
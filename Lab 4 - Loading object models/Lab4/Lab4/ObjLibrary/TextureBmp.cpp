@@ -30,6 +30,7 @@
 //    when using this class without the ObjLibrary.
 //
 
+#include "AssetFile.h"
 #include "TextureBmp.h"
 
 // needs to be after #including TextureBmp.h so macro is defined
@@ -62,7 +63,7 @@ namespace
 	//  Side Effect: The next 2/4 bytes are removed from
 	//		 r_input_file.
 	//
-	unsigned int read2Bytes (ifstream& r_input_file)
+	unsigned int read2Bytes (istream& r_input_file)
 	{
 		unsigned int b1 = r_input_file.get();
 		unsigned int b2 = r_input_file.get();
@@ -70,7 +71,7 @@ namespace
 		return  b1 |
 		       (b2 << 8);
 	}
-	unsigned int read4Bytes (ifstream& r_input_file)
+	unsigned int read4Bytes (istream& r_input_file)
 	{
 		unsigned int b1 = r_input_file.get();
 		unsigned int b2 = r_input_file.get();
@@ -782,6 +783,14 @@ TextureBmp :: TextureBmp (const TextureBmp& original)
 	assert(invariant());
 }
 
+TextureBmp :: TextureBmp (TextureBmp&& original) noexcept
+{
+	md_texture = NULL;
+	take(original);
+
+	assert(invariant());
+}
+
 TextureBmp& TextureBmp :: operator= (const TextureBmp& original)
 {
 	if(&original != this)
@@ -794,6 +803,18 @@ TextureBmp& TextureBmp :: operator= (const TextureBmp& original)
 	return *this;
 }
 
+TextureBmp& TextureBmp :: operator= (TextureBmp&& original) noexcept
+{
+	if(&original != this)
+	{
+		destroy();
+		take(original);
+	}
+
+	assert(invariant());
+	return *this;
+}
+
 TextureBmp :: ~TextureBmp ()
 {
 	destroy();
@@ -1086,10 +1107,9 @@ void TextureBmp :: load (const string& filename, ostream& r_logstream)
 	m_is_bad = false;
 
 	// Open the input file.
-	ifstream input_file(filename.c_str(), ios::in | ios::binary);
-	if(!input_file.is_open())
+	AssetFile asset_file(filename, true);
+	if(!asset_file.isOpen())
 	{
-		input_file.close();
 		r_logstream << "Error: File \"" << filename << "\" does not exist" << endl;
 		md_texture = NULL;
 		createDefault();
@@ -1098,6 +1118,7 @@ void TextureBmp :: load (const string& filename, ostream& r_logstream)
 		assert(invariant());
 		return;
 	}
+	istream& input_file = asset_file.getStream();
 
 	//  Header, 14 bytes.
 	//    16 bits FileType;        Magic number: "BM",
@@ -1109,7 +1130,6 @@ void TextureBmp :: load (const string& filename, ostream& r_logstream)
 	// Check to make sure this is a BMP file
 	if(input_file.get() != 'B' || input_file.get() != 'M')
 	{
-		input_file.close();
 		r_logstream << "Error: File \"" << filename << "\" is not a bmp" << endl;
 		md_texture = NULL;
 		createDefault();
@@ -1161,7 +1181,6 @@ void TextureBmp :: load (const string& filename, ostream& r_logstream)
 	}
 	else
 	{
-		input_file.close();
 		r_logstream << "Error: File \"" << filename << "\" is not 24-bit or 32-bit" << endl;
 		md_texture = NULL;
 		createDefault();
@@ -1180,8 +1199,6 @@ void TextureBmp :: load (const string& filename, ostream& r_logstream)
 	// read actual bitmap
 	input_file.read ( (char*)(md_texture), m_array_size);
 
-	input_file.close();
-
 	// reorder pixel colour components
 	for(unsigned int y = 0; y < m_height; y++)
 		for(unsigned int x = 0; x < m_width; x++)
@@ -1510,11 +1527,34 @@ void TextureBmp :: copy (const TextureBmp& original)
 	assert(invariant());
 }
 
-void TextureBmp :: destroy ()
+void TextureBmp :: take (TextureBmp& r_original) noexcept
 {
-	assert(md_texture != NULL);
+	assert(md_texture == NULL);
+
+	m_is_bad = r_original.m_is_bad;
+	m_width = r_original.m_width;
+	m_height = r_original.m_height;
+	m_is_alpha = r_original.m_is_alpha;
+	m_bytes_per_row = r_original.m_bytes_per_row;
+	m_array_size = r_original.m_array_size;
+	md_texture = r_original.md_texture;
+
+	r_original.m_is_bad = true;
+	r_original.m_width = 0;
+	r_original.m_height = 0;
+	r_original.m_is_alpha = false;
+	r_original.m_bytes_per_row = 0;
+	r_original.m_array_size = 0;
+	r_original.md_texture = NULL;
+
+	assert(invariant());
+	assert(r_original.invariant());
+}
 
-	delete md_texture;
+void TextureBmp :: destroy ()
+{
+	// md_texture is NULL if this TextureBmp was moved from
+	delete[] md_texture;
 	md_texture = NULL;
 
 	assert(md_texture == NULL);
@@ -1522,9 +1562,18 @@ void TextureBmp :: destroy ()
 
 bool TextureBmp :: invariant () const
 {
-	if(md_texture == NULL) return false;
-	if(m_width <= 0) return false;
-	if(m_height <= 0) return false;
+	if(md_texture == NULL)
+	{
+		// moved from
+		if(!m_is_bad) return false;
+		if(m_width != 0) return false;
+		if(m_height != 0) return false;
+	}
+	else
+	{
+		if(m_width <= 0) return false;
+		if(m_height <= 0) return false;
+	}
 	if(!m_is_alpha && m_bytes_per_row != getBytesPerRowNoAlpha(m_width)) return false;
 	if( m_is_alpha && m_bytes_per_row !=   getBytesPerRowAlpha(m_width)) return false;
 	if(m_array_size != m_bytes_per_row * m_height) return false;
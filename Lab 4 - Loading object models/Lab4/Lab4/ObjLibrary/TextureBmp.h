@@ -56,10 +56,15 @@ namespace ObjLibrary
 //    1 +--------+ 1
 //      0        1
 //
+//  A TextureBmp that has been moved from has no image.  It is
+//    bad and has a width and height of 0.  It should only be
+//    assigned to or destroyed.
+//
 //  Class Invariant:
-//    <1> md_texture != NULL
-//    <2> m_width > 0
-//    <3> m_height > 0
+//    <1> md_texture != NULL ||
+//        (m_is_bad && m_width == 0 && m_height == 0)
+//    <2> md_texture == NULL || m_width > 0
+//    <3> md_texture == NULL || m_height > 0
 //    <4> m_is_alpha ||
 //        m_bytes_per_row == getBytesPerRowNoAlpha(m_width)
 //    <5> !m_is_alpha ||
@@ -578,6 +583,21 @@ public:
 //
 	TextureBmp (const TextureBmp& original);
 
+//
+//  Move Constructor
+//
+//  Purpose: To create a TextureBmp by taking the image of
+//           another TextureBmp.
+//  Parameter(s):
+//    <1> original: The TextureBmp to move
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new TextureBmp is created with the image
+//               original had.  The pixels are not copied.
+//               original is left with no image.
+//
+	TextureBmp (TextureBmp&& original) noexcept;
+
 //
 //  Assignment Operator
 //
@@ -592,6 +612,22 @@ public:
 //
 	TextureBmp& operator= (const TextureBmp& original);
 
+//
+//  Move Assignment Operator
+//
+//  Purpose: To transform this TextureBmp to have the image of
+//           another.
+//  Parameter(s):
+//    <1> original: The TextureBmp to move
+//  Precondition(s): N/A
+//  Returns: A reference to this TextureBmp
+//  Side Effect: The image in this TextureBmp is freed, and this
+//               TextureBmp is given the image original had.
+//               The pixels are not copied.  original is left
+//               with no image.
+//
+	TextureBmp& operator= (TextureBmp&& original) noexcept;
+
 //
 //  Deconstructor
 //
@@ -1032,14 +1068,29 @@ private:
 //
 	void copy (const TextureBmp& original);
 
+//
+//  Helper Function: take
+//
+//  Purpose: To move the image from another TextureBmp into
+//           this TextureBmp.
+//  Parameter(s):
+//    <1> r_original: The TextureBmp to move from
+//  Precondition(s):
+//    <1> md_texture == NULL
+//  Returns: N/A
+//  Side Effect: All values from r_original are copied to this
+//               TextureBmp, including the pointer to the
+//               pixels.  r_original is left with no image.
+//
+	void take (TextureBmp& r_original) noexcept;
+
 //
 //  Helper Function: destroy
 //
 //  Purpose: To free all dynamically allocated memory for this
 //           TextureBmp.
 //  Parameter(s): N/A
-//  Precondition(s):
-//    <1> md_texture != NULL
+//  Precondition(s): N/A
 //  Returns: N/A
 //  Side Effect: All dynamically allocated memory is freed.
 //               md_texture is set to NULL.
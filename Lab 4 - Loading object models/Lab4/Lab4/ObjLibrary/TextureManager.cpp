@@ -272,6 +272,39 @@ unsigned int TextureManager :: add (const Texture& texture, const string& name)
 	return texture_count;
 }
 
+unsigned int TextureManager :: add (const TextureBmp& texture_bmp,
+                                    const string& name)
+{
+	assert(!texture_bmp.isBad());
+	assert(!isLoaded(name));
+
+	// same parameters as load(name, r_logstream)
+#ifdef OBJ_LIBRARY_LINEAR_TEXTURE_INTERPOLATION
+	return add(texture_bmp.addToOpenGL(GL_REPEAT, GL_REPEAT, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR), name);
+#else
+	return add(texture_bmp.addToOpenGL(GL_REPEAT, GL_REPEAT, GL_NEAREST, GL_NEAREST_MIPMAP_NEAREST), name);
+#endif
+}
+
+unsigned int TextureManager :: replace (const TextureBmp& texture_bmp,
+                                        const string& name)
+{
+	assert(!texture_bmp.isBad());
+	assert(isLoaded(name));
+
+	unsigned int index = getIndex(name);
+	assert(index < gvp_textures.size());
+	assert(gvp_textures[index] != NULL);
+
+	// same parameters as load(name, r_logstream)
+#ifdef OBJ_LIBRARY_LINEAR_TEXTURE_INTERPOLATION
+	gvp_textures[index]->m_texture.set(texture_bmp.addToOpenGL(GL_REPEAT, GL_REPEAT, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR));
+#else
+	gvp_textures[index]->m_texture.set(texture_bmp.addToOpenGL(GL_REPEAT, GL_REPEAT, GL_NEAREST, GL_NEAREST_MIPMAP_NEAREST));
+#endif
+	return index;
+}
+
 
 
 unsigned int TextureManager :: load (const char* a_name)
@@ -32,6 +32,7 @@ namespace ObjLibrary
 
 class Vector3;
 class Texture;
+class TextureBmp;
 
 
 
@@ -371,6 +372,53 @@ unsigned int add (const Texture& texture,
 unsigned int add (const Texture& texture,
                   const std::string& name);
 
+//
+//  add
+//
+//  Purpose: To add the image in the specified TextureBmp to
+//           the texture manager with the specified name.  This
+//           function can be used to add an image that was
+//           loaded on another thread.
+//  Parameter(s):
+//    <1> texture_bmp: The TextureBmp
+//    <2> name: The name of the texture
+//  Precondition(s):
+//    <1> !texture_bmp.isBad()
+//    <2> !isLoaded(name)
+//  Returns: The index that the texture was added at.
+//  Side Effect: The image in texture_bmp is added to video
+//               memory with the same parameters load uses by
+//               default.  It is then added to the texture
+//               manager under the name name.
+//
+unsigned int add (const TextureBmp& texture_bmp,
+                  const std::string& name);
+
+//
+//  replace
+//
+//  Purpose: To replace the image for a texture that has
+//           already been loaded.
+//  Parameter(s):
+//    <1> texture_bmp: The TextureBmp with the new image
+//    <2> name: The name of the texture
+//  Precondition(s):
+//    <1> !texture_bmp.isBad()
+//    <2> isLoaded(name)
+//  Returns: The index of the texture.
+//  Side Effect: The image in texture_bmp is added to video
+//               memory with the same parameters load uses by
+//               default, and the texture with name name is
+//               changed to refer to it.  References to the
+//               texture returned by get remain valid and refer
+//               to the new image.  If nothing else refers to
+//               the old image, it is removed from video memory.
+//               Display lists that were recorded with the old
+//               image must be recorded again.
+//
+unsigned int replace (const TextureBmp& texture_bmp,
+                      const std::string& name);
+
 //
 //  load
 //
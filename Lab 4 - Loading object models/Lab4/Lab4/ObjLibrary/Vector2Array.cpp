@@ -0,0 +1,282 @@
+//
+//  Vector2Array.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "Vector2.h"
+#include "SimdKernels.h"
+#include "Vector2Array.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+template <typename T>
+Vector2Array<T> :: Vector2Array ()
+		: mv_x(),
+		  mv_y()
+{
+}
+
+template <typename T>
+Vector2Array<T> :: Vector2Array (unsigned int size)
+		: mv_x(size, 0),
+		  mv_y(size, 0)
+{
+}
+
+template <typename T>
+Vector2Array<T> :: Vector2Array (const vector<Vector2>& vectors)
+		: mv_x(vectors.size()),
+		  mv_y(vectors.size())
+{
+	for(unsigned int i = 0; i < vectors.size(); i++)
+		set(i, vectors[i]);
+}
+
+
+
+template <typename T>
+void Vector2Array<T> :: getAll (vector<Vector2>& r_vectors) const
+{
+	unsigned int size = getSize();
+	r_vectors.resize(size);
+	for(unsigned int i = 0; i < size; i++)
+		r_vectors[i].set(mv_x[i], mv_y[i]);
+}
+
+template <typename T>
+Vector2 Vector2Array<T> :: getMinComponents () const
+{
+	assert(!isEmpty());
+
+	Vector2 min_components;
+	Vector2 max_components;
+	getMinMaxComponents(min_components, max_components);
+	return min_components;
+}
+
+template <typename T>
+Vector2 Vector2Array<T> :: getMaxComponents () const
+{
+	assert(!isEmpty());
+
+	Vector2 min_components;
+	Vector2 max_components;
+	getMinMaxComponents(min_components, max_components);
+	return max_components;
+}
+
+template <typename T>
+void Vector2Array<T> :: getMinMaxComponents (Vector2& r_min, Vector2& r_max) const
+{
+	assert(!isEmpty());
+
+	const SimdKernels::Table<T>& kernels = SimdKernels::getTable<T>();
+	unsigned int size = getSize();
+	T min_x, max_x;
+	T min_y, max_y;
+
+	kernels.minMax(size, getArrayX(), min_x, max_x);
+	kernels.minMax(size, getArrayY(), min_y, max_y);
+
+	r_min.set(min_x, min_y);
+	r_max.set(max_x, max_y);
+}
+
+template <typename T>
+void Vector2Array<T> :: dotProduct (const Vector2Array<T>& other,
+                                    vector<T>& r_results) const
+{
+	assert(other.getSize() == getSize());
+
+	unsigned int size = getSize();
+	r_results.resize(size);
+	if(size == 0)
+		return;
+
+	SimdKernels::getTable<T>().dotProduct2(size,
+	                                       getArrayX(), getArrayY(),
+	                                       other.getArrayX(), other.getArrayY(),
+	                                       &(r_results[0]));
+}
+
+template <typename T>
+void Vector2Array<T> :: getDistanceSquared (const Vector2& point,
+                                            vector<T>& r_results) const
+{
+	assert(point.isFinite());
+
+	unsigned int size = getSize();
+	r_results.resize(size);
+	if(size == 0)
+		return;
+
+	SimdKernels::getTable<T>().distanceSquared2(size,
+	                                            getArrayX(), getArrayY(),
+	                                            (T)(point.x), (T)(point.y),
+	                                            &(r_results[0]));
+}
+
+
+
+template <typename T>
+void Vector2Array<T> :: setAll (const Vector2& vector)
+{
+	mv_x.assign(mv_x.size(), (T)(vector.x));
+	mv_y.assign(mv_y.size(), (T)(vector.y));
+}
+
+template <typename T>
+void Vector2Array<T> :: resize (unsigned int size)
+{
+	mv_x.resize(size, 0);
+	mv_y.resize(size, 0);
+}
+
+template <typename T>
+void Vector2Array<T> :: reserve (unsigned int size)
+{
+	mv_x.reserve(size);
+	mv_y.reserve(size);
+}
+
+template <typename T>
+void Vector2Array<T> :: clear ()
+{
+	mv_x.clear();
+	mv_y.clear();
+}
+
+template <typename T>
+void Vector2Array<T> :: add (const Vector2Array<T>& other)
+{
+	assert(other.getSize() == getSize());
+
+	if(isEmpty())
+		return;
+
+	const SimdKernels::Table<T>& kernels = SimdKernels::getTable<T>();
+	unsigned int size = getSize();
+	kernels.add(size, getArrayX(), other.getArrayX(), getArrayX());
+	kernels.add(size, getArrayY(), other.getArrayY(), getArrayY());
+}
+
+template <typename T>
+void Vector2Array<T> :: add (const Vector2& vector)
+{
+	assert(vector.isFinite());
+
+	if(isEmpty())
+		return;
+
+	const SimdKernels::Table<T>& kernels = SimdKernels::getTable<T>();
+	unsigned int size = getSize();
+	kernels.addScalar(size, getArrayX(), (T)(vector.x), getArrayX());
+	kernels.addScalar(size, getArrayY(), (T)(vector.y), getArrayY());
+}
+
+template <typename T>
+void Vector2Array<T> :: subtract (const Vector2Array<T>& other)
+{
+	assert(other.getSize() == getSize());
+
+	addScaled(other, -1.0);
+}
+
+template <typename T>
+void Vector2Array<T> :: addScaled (const Vector2Array<T>& other, double factor)
+{
+	assert(other.getSize() == getSize());
+
+	if(isEmpty())
+		return;
+
+	const SimdKernels::Table<T>& kernels = SimdKernels::getTable<T>();
+	unsigned int size = getSize();
+	kernels.multiplyAdd(size, getArrayX(), other.getArrayX(), (T)(factor), getArrayX());
+	kernels.multiplyAdd(size, getArrayY(), other.getArrayY(), (T)(factor), getArrayY());
+}
+
+template <typename T>
+void Vector2Array<T> :: scale (double factor)
+{
+	if(isEmpty())
+		return;
+
+	const SimdKernels::Table<T>& kernels = SimdKernels::getTable<T>();
+	unsigned int size = getSize();
+	kernels.multiplyScalar(size, getArrayX(), (T)(factor), getArrayX());
+	kernels.multiplyScalar(size, getArrayY(), (T)(factor), getArrayY());
+}
+
+template <typename T>
+void Vector2Array<T> :: normalize ()
+{
+	if(isEmpty())
+		return;
+
+	SimdKernels::getTable<T>().normalize2(getSize(),
+	                                      getArrayX(), getArrayY(),
+	                                      getArrayX(), getArrayY());
+}
+
+template <typename T>
+void Vector2Array<T> :: rotate (double radians)
+{
+	double sin_angle = sin(radians);
+	double cos_angle = cos(radians);
+
+	matrixProductRows(Vector2(cos_angle, -sin_angle),
+	                  Vector2(sin_angle,  cos_angle));
+}
+
+template <typename T>
+void Vector2Array<T> :: matrixProductRows (const Vector2& r1,
+                                           const Vector2& r2)
+{
+	assert(r1.isFinite());
+	assert(r2.isFinite());
+
+	if(isEmpty())
+		return;
+
+	T a_matrix[4] =
+	{
+		(T)(r1.x), (T)(r1.y),
+		(T)(r2.x), (T)(r2.y),
+	};
+
+	SimdKernels::getTable<T>().matrixProduct2(getSize(), a_matrix,
+	                                          getArrayX(), getArrayY(),
+	                                          getArrayX(), getArrayY());
+}
+
+
+
+//
+//  Only these two versions exist, because the SIMD kernels
+//    only support these types.
+//
+
+template class ObjLibrary::Vector2Array<float>;
+template class ObjLibrary::Vector2Array<double>;
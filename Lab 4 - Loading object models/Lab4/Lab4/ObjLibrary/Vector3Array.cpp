@@ -0,0 +1,339 @@
+//
+//  Vector3Array.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "Vector3.h"
+#include "SimdKernels.h"
+#include "Vector3Array.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+template <typename T>
+Vector3Array<T> :: Vector3Array ()
+		: mv_x(),
+		  mv_y(),
+		  mv_z()
+{
+}
+
+template <typename T>
+Vector3Array<T> :: Vector3Array (unsigned int size)
+		: mv_x(size, 0),
+		  mv_y(size, 0),
+		  mv_z(size, 0)
+{
+}
+
+template <typename T>
+Vector3Array<T> :: Vector3Array (const vector<Vector3>& vectors)
+		: mv_x(vectors.size()),
+		  mv_y(vectors.size()),
+		  mv_z(vectors.size())
+{
+	for(unsigned int i = 0; i < vectors.size(); i++)
+		set(i, vectors[i]);
+}
+
+
+
+template <typename T>
+void Vector3Array<T> :: getAll (vector<Vector3>& r_vectors) const
+{
+	unsigned int size = getSize();
+	r_vectors.resize(size);
+	for(unsigned int i = 0; i < size; i++)
+		r_vectors[i].set(mv_x[i], mv_y[i], mv_z[i]);
+}
+
+template <typename T>
+Vector3 Vector3Array<T> :: getMinComponents () const
+{
+	assert(!isEmpty());
+
+	Vector3 min_components;
+	Vector3 max_components;
+	getMinMaxComponents(min_components, max_components);
+	return min_components;
+}
+
+template <typename T>
+Vector3 Vector3Array<T> :: getMaxComponents () const
+{
+	assert(!isEmpty());
+
+	Vector3 min_components;
+	Vector3 max_components;
+	getMinMaxComponents(min_components, max_components);
+	return max_components;
+}
+
+template <typename T>
+void Vector3Array<T> :: getMinMaxComponents (Vector3& r_min, Vector3& r_max) const
+{
+	assert(!isEmpty());
+
+	const SimdKernels::Table<T>& kernels = SimdKernels::getTable<T>();
+	unsigned int size = getSize();
+	T min_x, max_x;
+	T min_y, max_y;
+	T min_z, max_z;
+
+	kernels.minMax(size, getArrayX(), min_x, max_x);
+	kernels.minMax(size, getArrayY(), min_y, max_y);
+	kernels.minMax(size, getArrayZ(), min_z, max_z);
+
+	r_min.set(min_x, min_y, min_z);
+	r_max.set(max_x, max_y, max_z);
+}
+
+template <typename T>
+void Vector3Array<T> :: dotProduct (const Vector3Array<T>& other,
+                                    vector<T>& r_results) const
+{
+	assert(other.getSize() == getSize());
+
+	unsigned int size = getSize();
+	r_results.resize(size);
+	if(size == 0)
+		return;
+
+	SimdKernels::getTable<T>().dotProduct3(size,
+	                                       getArrayX(), getArrayY(), getArrayZ(),
+	                                       other.getArrayX(), other.getArrayY(), other.getArrayZ(),
+	                                       &(r_results[0]));
+}
+
+template <typename T>
+void Vector3Array<T> :: crossProduct (const Vector3Array<T>& other,
+                                      Vector3Array<T>& r_results) const
+{
+	assert(other.getSize() == getSize());
+
+	unsigned int size = getSize();
+	r_results.resize(size);
+	if(size == 0)
+		return;
+
+	SimdKernels::getTable<T>().crossProduct3(size,
+	                                         getArrayX(), getArrayY(), getArrayZ(),
+	                                         other.getArrayX(), other.getArrayY(), other.getArrayZ(),
+	                                         r_results.getArrayX(), r_results.getArrayY(), r_results.getArrayZ());
+}
+
+template <typename T>
+void Vector3Array<T> :: getDistanceSquared (const Vector3& point,
+                                            vector<T>& r_results) const
+{
+	assert(point.isFinite());
+
+	unsigned int size = getSize();
+	r_results.resize(size);
+	if(size == 0)
+		return;
+
+	SimdKernels::getTable<T>().distanceSquared3(size,
+	                                            getArrayX(), getArrayY(), getArrayZ(),
+	                                            (T)(point.x), (T)(point.y), (T)(point.z),
+	                                            &(r_results[0]));
+}
+
+
+
+template <typename T>
+void Vector3Array<T> :: setAll (const Vector3& vector)
+{
+	mv_x.assign(mv_x.size(), (T)(vector.x));
+	mv_y.assign(mv_y.size(), (T)(vector.y));
+	mv_z.assign(mv_z.size(), (T)(vector.z));
+}
+
+template <typename T>
+void Vector3Array<T> :: resize (unsigned int size)
+{
+	mv_x.resize(size, 0);
+	mv_y.resize(size, 0);
+	mv_z.resize(size, 0);
+}
+
+template <typename T>
+void Vector3Array<T> :: reserve (unsigned int size)
+{
+	mv_x.reserve(size);
+	mv_y.reserve(size);
+	mv_z.reserve(size);
+}
+
+template <typename T>
+void Vector3Array<T> :: clear ()
+{
+	mv_x.clear();
+	mv_y.clear();
+	mv_z.clear();
+}
+
+template <typename T>
+void Vector3Array<T> :: add (const Vector3Array<T>& other)
+{
+	assert(other.getSize() == getSize());
+
+	if(isEmpty())
+		return;
+
+	const SimdKernels::Table<T>& kernels = SimdKernels::getTable<T>();
+	unsigned int size = getSize();
+	kernels.add(size, getArrayX(), other.getArrayX(), getArrayX());
+	kernels.add(size, getArrayY(), other.getArrayY(), getArrayY());
+	kernels.add(size, getArrayZ(), other.getArrayZ(), getArrayZ());
+}
+
+template <typename T>
+void Vector3Array<T> :: add (const Vector3& vector)
+{
+	assert(vector.isFinite());
+
+	if(isEmpty())
+		return;
+
+	const SimdKernels::Table<T>& kernels = SimdKernels::getTable<T>();
+	unsigned int size = getSize();
+	kernels.addScalar(size, getArrayX(), (T)(vector.x), getArrayX());
+	kernels.addScalar(size, getArrayY(), (T)(vector.y), getArrayY());
+	kernels.addScalar(size, getArrayZ(), (T)(vector.z), getArrayZ());
+}
+
+template <typename T>
+void Vector3Array<T> :: subtract (const Vector3Array<T>& other)
+{
+	assert(other.getSize() == getSize());
+
+	addScaled(other, -1.0);
+}
+
+template <typename T>
+void Vector3Array<T> :: addScaled (const Vector3Array<T>& other, double factor)
+{
+	assert(other.getSize() == getSize());
+
+	if(isEmpty())
+		return;
+
+	const SimdKernels::Table<T>& kernels = SimdKernels::getTable<T>();
+	unsigned int size = getSize();
+	kernels.multiplyAdd(size, getArrayX(), other.getArrayX(), (T)(factor), getArrayX());
+	kernels.multiplyAdd(size, getArrayY(), other.getArrayY(), (T)(factor), getArrayY());
+	kernels.multiplyAdd(size, getArrayZ(), other.getArrayZ(), (T)(factor), getArrayZ());
+}
+
+template <typename T>
+void Vector3Array<T> :: scale (double factor)
+{
+	if(isEmpty())
+		return;
+
+	const SimdKernels::Table<T>& kernels = SimdKernels::getTable<T>();
+	unsigned int size = getSize();
+	kernels.multiplyScalar(size, getArrayX(), (T)(factor), getArrayX());
+	kernels.multiplyScalar(size, getArrayY(), (T)(factor), getArrayY());
+	kernels.multiplyScalar(size, getArrayZ(), (T)(factor), getArrayZ());
+}
+
+template <typename T>
+void Vector3Array<T> :: normalize ()
+{
+	if(isEmpty())
+		return;
+
+	SimdKernels::getTable<T>().normalize3(getSize(),
+	                                      getArrayX(), getArrayY(), getArrayZ(),
+	                                      getArrayX(), getArrayY(), getArrayZ());
+}
+
+template <typename T>
+void Vector3Array<T> :: rotateArbitrary (const Vector3& axis, double radians)
+{
+	assert(axis.isFinite());
+	assert(!axis.isZero());
+
+	rotateArbitraryNormal(axis.getNormalized(), radians);
+}
+
+template <typename T>
+void Vector3Array<T> :: rotateArbitraryNormal (const Vector3& axis, double radians)
+{
+	assert(axis.isFinite());
+	assert(axis.isNormal());
+
+	// same matrix as Vector3::rotateArbitraryNormal, calculated once
+	//  www2.cs.uregina.ca/~anima/408/Notes/ObjectModels/Rotation.htm
+	//  M = A_hat + (I - A_hat) * cos + A_star * sin
+
+	double c = cos(radians);
+	double s = sin(radians);
+
+	double aa = axis.x * axis.x;
+	double bb = axis.y * axis.y;
+	double cc = axis.z * axis.z;
+	double ab = axis.x * axis.y;
+	double ac = axis.x * axis.z;
+	double bc = axis.y * axis.z;
+
+	matrixProductRows(Vector3(aa + (1.0 - aa) * c,  ab -        ab * c - axis.z * s,  ac -        ac * c + axis.y * s),
+	                  Vector3(ab -        ab * c + axis.z * s,  bb + (1.0 - bb) * c,  bc -        bc * c - axis.x * s),
+	                  Vector3(ac -        ac * c - axis.y * s,  bc -        bc * c + axis.x * s,  cc + (1.0 - cc) * c));
+}
+
+template <typename T>
+void Vector3Array<T> :: matrixProductRows (const Vector3& r1,
+                                           const Vector3& r2,
+                                           const Vector3& r3)
+{
+	assert(r1.isFinite());
+	assert(r2.isFinite());
+	assert(r3.isFinite());
+
+	if(isEmpty())
+		return;
+
+	T a_matrix[9] =
+	{
+		(T)(r1.x), (T)(r1.y), (T)(r1.z),
+		(T)(r2.x), (T)(r2.y), (T)(r2.z),
+		(T)(r3.x), (T)(r3.y), (T)(r3.z),
+	};
+
+	SimdKernels::getTable<T>().matrixProduct3(getSize(), a_matrix,
+	                                          getArrayX(), getArrayY(), getArrayZ(),
+	                                          getArrayX(), getArrayY(), getArrayZ());
+}
+
+
+
+//
+//  Only these two versions exist, because the SIMD kernels
+//    only support these types.
+//
+
+template class ObjLibrary::Vector3Array<float>;
+template class ObjLibrary::Vector3Array<double>;
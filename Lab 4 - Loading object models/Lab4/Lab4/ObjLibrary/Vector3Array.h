@@ -0,0 +1,537 @@
+//
+//  Vector3Array.h
+//
+//  A module to store many Vector3s as a structure of arrays.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2016.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_VECTOR3_ARRAY_H
+#define OBJ_LIBRARY_VECTOR3_ARRAY_H
+
+#include <vector>
+
+#include "Vector3.h"
+
+
+
+namespace ObjLibrary
+{
+
+//
+//  Vector3Array
+//
+//  A class template to store a sequence of 3D vectors with the
+//    X, Y, and Z components in seperate arrays.  The batch
+//    functions apply the same operation to every element and
+//    use the SIMD kernels in SimdKernels.h, so they are much
+//    faster than looping over a std::vector<Vector3>.
+//
+//  T is the element type.  Only Vector3Array<float> and
+//    Vector3Array<double> are available.  Elements are passed
+//    in and out as Vector3s (which use doubles), so the float
+//    version loses precision when values are stored.
+//
+//  Unlike Vector3, the batch functions do not require their
+//    elements to be finite.  Any element that is not finite
+//    will just produce a non-finite result.
+//
+template <typename T>
+class Vector3Array
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new Vector3Array with no elements.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new Vector3Array is created.
+//
+	Vector3Array ();
+
+//
+//  Size Constructor
+//
+//  Purpose: To create a new Vector3Array containing the
+//           specified number of zero vectors.
+//  Parameter(s):
+//    <1> size: The number of elements
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new Vector3Array is created with size
+//               elements, each (0, 0, 0).
+//
+	explicit Vector3Array (unsigned int size);
+
+//
+//  Vector Constructor
+//
+//  Purpose: To create a new Vector3Array containing copies of
+//           the specified Vector3s.
+//  Parameter(s):
+//    <1> vectors: The Vector3s to copy
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new Vector3Array is created with the same
+//               elements as vectors.
+//
+	explicit Vector3Array (const std::vector<Vector3>& vectors);
+
+//
+//  getSize
+//
+//  Purpose: To determine the number of elements in this
+//           Vector3Array.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of elements.
+//  Side Effect: N/A
+//
+	unsigned int getSize () const
+	{ return (unsigned int)(mv_x.size()); }
+
+//
+//  isEmpty
+//
+//  Purpose: To determine if this Vector3Array has no elements.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this Vector3Array is empty.
+//  Side Effect: N/A
+//
+	bool isEmpty () const
+	{ return mv_x.empty(); }
+
+//
+//  get
+//
+//  Purpose: To retrieve the specified element.
+//  Parameter(s):
+//    <1> index: Which element
+//  Precondition(s):
+//    <1> index < getSize()
+//  Returns: Element index as a Vector3.
+//  Side Effect: N/A
+//
+	Vector3 get (unsigned int index) const
+	{
+		assert(index < getSize());
+		return Vector3(mv_x[index], mv_y[index], mv_z[index]);
+	}
+
+//
+//  getAll
+//
+//  Purpose: To copy all the elements into a std::vector of
+//           Vector3s.
+//  Parameter(s):
+//    <1> r_vectors: The vector to fill
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: r_vectors is set to contain the same elements
+//               as this Vector3Array.
+//
+	void getAll (std::vector<Vector3>& r_vectors) const;
+
+//
+//  getArrayX
+//  getArrayY
+//  getArrayZ
+//
+//  Purpose: To retrieve the underlying array for one component
+//           of the elements.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: A pointer to getSize() values.  If this
+//           Vector3Array is empty, the pointer may be NULL.
+//           The pointer is invalidated by any function that
+//           changes the size.
+//  Side Effect: N/A
+//
+	const T* getArrayX () const
+	{ return mv_x.empty() ? NULL : &(mv_x[0]); }
+	const T* getArrayY () const
+	{ return mv_y.empty() ? NULL : &(mv_y[0]); }
+	const T* getArrayZ () const
+	{ return mv_z.empty() ? NULL : &(mv_z[0]); }
+
+//
+//  getMinComponents
+//
+//  Purpose: To determine the smallest value of each component
+//           across all the elements.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> !isEmpty()
+//  Returns: A Vector3 containing the smallest X, Y, and Z
+//           values.  These may come from different elements.
+//  Side Effect: N/A
+//
+	Vector3 getMinComponents () const;
+
+//
+//  getMaxComponents
+//
+//  Purpose: To determine the largest value of each component
+//           across all the elements.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> !isEmpty()
+//  Returns: A Vector3 containing the largest X, Y, and Z
+//           values.  These may come from different elements.
+//  Side Effect: N/A
+//
+	Vector3 getMaxComponents () const;
+
+//
+//  getMinMaxComponents
+//
+//  Purpose: To determine the smallest and largest values of
+//           each component across all the elements.  This is
+//           the axis-aligned bounding box of the elements.
+//  Parameter(s):
+//    <1> r_min: A reference to the Vector3 to set to the
+//               smallest components
+//    <2> r_max: A reference to the Vector3 to set to the
+//               largest components
+//  Precondition(s):
+//    <1> !isEmpty()
+//  Returns: N/A
+//  Side Effect: r_min and r_max are set to the smallest and
+//               largest components.  This is faster than
+//               calling getMinComponents and getMaxComponents
+//               seperately.
+//
+	void getMinMaxComponents (Vector3& r_min, Vector3& r_max) const;
+
+//
+//  dotProduct
+//
+//  Purpose: To calculate the dot product of each element of
+//           this Vector3Array with the corresponding element
+//           of another.
+//  Parameter(s):
+//    <1> other: The other Vector3Array
+//    <2> r_results: A reference to the vector to fill
+//  Precondition(s):
+//    <1> other.getSize() == getSize()
+//  Returns: N/A
+//  Side Effect: r_results is resized to getSize() and element
+//               i is set to the dot product of element i of
+//               this Vector3Array and element i of other.
+//
+	void dotProduct (const Vector3Array<T>& other,
+	                 std::vector<T>& r_results) const;
+
+//
+//  crossProduct
+//
+//  Purpose: To calculate the cross product of each element of
+//           this Vector3Array with the corresponding element
+//           of another.
+//  Parameter(s):
+//    <1> other: The other Vector3Array
+//    <2> r_results: A reference to the Vector3Array to fill
+//  Precondition(s):
+//    <1> other.getSize() == getSize()
+//  Returns: N/A
+//  Side Effect: r_results is resized to getSize() and element
+//               i is set to the cross product of element i of
+//               this Vector3Array and element i of other.
+//               r_results may be this Vector3Array or other.
+//
+	void crossProduct (const Vector3Array<T>& other,
+	                   Vector3Array<T>& r_results) const;
+
+//
+//  getDistanceSquared
+//
+//  Purpose: To calculate the square of the distance from each
+//           element to the specified point.
+//  Parameter(s):
+//    <1> point: The point to measure to
+//    <2> r_results: A reference to the vector to fill
+//  Precondition(s):
+//    <1> point.isFinite()
+//  Returns: N/A
+//  Side Effect: r_results is resized to getSize() and element
+//               i is set to the square of the distance from
+//               element i to point.
+//
+	void getDistanceSquared (const Vector3& point,
+	                         std::vector<T>& r_results) const;
+
+//
+//  set
+//
+//  Purpose: To change the specified element.
+//  Parameter(s):
+//    <1> index: Which element
+//    <2> vector: The new value
+//  Precondition(s):
+//    <1> index < getSize()
+//  Returns: N/A
+//  Side Effect: Element index is set to vector.
+//
+	void set (unsigned int index, const Vector3& vector)
+	{
+		assert(index < getSize());
+		mv_x[index] = (T)(vector.x);
+		mv_y[index] = (T)(vector.y);
+		mv_z[index] = (T)(vector.z);
+	}
+
+//
+//  setAll
+//
+//  Purpose: To change every element to the same value.
+//  Parameter(s):
+//    <1> vector: The new value
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Every element is set to vector.
+//
+	void setAll (const Vector3& vector);
+
+//
+//  getArrayX
+//  getArrayY
+//  getArrayZ
+//
+//  Purpose: To retrieve a modifiable pointer to the underlying
+//           array for one component of the elements.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: A pointer to getSize() values.  If this
+//           Vector3Array is empty, the pointer may be NULL.
+//           The pointer is invalidated by any function that
+//           changes the size.
+//  Side Effect: N/A
+//
+	T* getArrayX ()
+	{ return mv_x.empty() ? NULL : &(mv_x[0]); }
+	T* getArrayY ()
+	{ return mv_y.empty() ? NULL : &(mv_y[0]); }
+	T* getArrayZ ()
+	{ return mv_z.empty() ? NULL : &(mv_z[0]); }
+
+//
+//  resize
+//
+//  Purpose: To change the number of elements.
+//  Parameter(s):
+//    <1> size: The new number of elements
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This Vector3Array is resized to contain size
+//               elements.  Any new elements are zero vectors.
+//
+	void resize (unsigned int size);
+
+//
+//  reserve
+//
+//  Purpose: To reserve space for the specified number of
+//           elements.
+//  Parameter(s):
+//    <1> size: The number of elements to reserve space for
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Memory is allocated for size elements.
+//
+	void reserve (unsigned int size);
+
+//
+//  clear
+//
+//  Purpose: To remove all elements.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This Vector3Array is set to be empty.
+//
+	void clear ();
+
+//
+//  pushBack
+//
+//  Purpose: To add an element to the end of this Vector3Array.
+//  Parameter(s):
+//    <1> vector: The element to add
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: vector is added as a new last element.
+//
+	void pushBack (const Vector3& vector)
+	{
+		mv_x.push_back((T)(vector.x));
+		mv_y.push_back((T)(vector.y));
+		mv_z.push_back((T)(vector.z));
+	}
+
+//
+//  add
+//
+//  Purpose: To add another Vector3Array to this one, element by
+//           element.
+//  Parameter(s):
+//    <1> other: The Vector3Array to add
+//  Precondition(s):
+//    <1> other.getSize() == getSize()
+//  Returns: N/A
+//  Side Effect: Element i of other is added to element i of
+//               this Vector3Array.
+//
+	void add (const Vector3Array<T>& other);
+
+//
+//  add
+//
+//  Purpose: To add the same Vector3 to every element.
+//  Parameter(s):
+//    <1> vector: The Vector3 to add
+//  Precondition(s):
+//    <1> vector.isFinite()
+//  Returns: N/A
+//  Side Effect: vector is added to every element.
+//
+	void add (const Vector3& vector);
+
+//
+//  subtract
+//
+//  Purpose: To subtract another Vector3Array from this one,
+//           element by element.
+//  Parameter(s):
+//    <1> other: The Vector3Array to subtract
+//  Precondition(s):
+//    <1> other.getSize() == getSize()
+//  Returns: N/A
+//  Side Effect: Element i of other is subtracted from element i
+//               of this Vector3Array.
+//
+	void subtract (const Vector3Array<T>& other);
+
+//
+//  addScaled
+//
+//  Purpose: To add a multiple of another Vector3Array to this
+//           one, element by element.  This is useful for
+//           integrating positions from velocities.
+//  Parameter(s):
+//    <1> other: The Vector3Array to add
+//    <2> factor: The factor to multiply other by
+//  Precondition(s):
+//    <1> other.getSize() == getSize()
+//  Returns: N/A
+//  Side Effect: Element i of other multiplied by factor is
+//               added to element i of this Vector3Array.
+//
+	void addScaled (const Vector3Array<T>& other, double factor);
+
+//
+//  scale
+//
+//  Purpose: To multiply every element by a constant.
+//  Parameter(s):
+//    <1> factor: The factor to multiply by
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Every element is multiplied by factor.
+//
+	void scale (double factor);
+
+//
+//  normalize
+//
+//  Purpose: To change every element to have a norm of 1.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Every element is set to have a norm of 1.0
+//               while keeping its direction.  Any zero
+//               vectors are left unchanged.
+//
+	void normalize ();
+
+//
+//  rotateArbitrary
+//
+//  Purpose: To rotate every element around an arbitrary axis.
+//  Parameter(s):
+//    <1> axis: The axis to rotate around
+//    <2> radians: The angle to rotate by
+//  Precondition(s):
+//    <1> axis.isFinite()
+//    <2> !axis.isZero()
+//  Returns: N/A
+//  Side Effect: Every element is rotated radians radians
+//               around axis, as Vector3::rotateArbitrary does.
+//
+	void rotateArbitrary (const Vector3& axis, double radians);
+
+//
+//  rotateArbitraryNormal
+//
+//  Purpose: To rotate every element around an arbitrary axis
+//           of norm 1.
+//  Parameter(s):
+//    <1> axis: The axis to rotate around
+//    <2> radians: The angle to rotate by
+//  Precondition(s):
+//    <1> axis.isFinite()
+//    <2> axis.isNormal()
+//  Returns: N/A
+//  Side Effect: Every element is rotated radians radians
+//               around axis.
+//
+	void rotateArbitraryNormal (const Vector3& axis, double radians);
+
+//
+//  matrixProductRows
+//
+//  Purpose: To multiply every element by a 3x3 matrix
+//           specified as rows.
+//  Parameter(s):
+//    <1> r1
+//    <2> r2
+//    <3> r3: The rows of the matrix
+//  Precondition(s):
+//    <1> r1.isFinite()
+//    <2> r2.isFinite()
+//    <3> r3.isFinite()
+//  Returns: N/A
+//  Side Effect: Every element is replaced by the product of
+//               the matrix and that element, as
+//               Vector3::getMatrixProductRows does.
+//
+	void matrixProductRows (const Vector3& r1,
+	                        const Vector3& r2,
+	                        const Vector3& r3);
+
+private:
+	std::vector<T> mv_x;
+	std::vector<T> mv_y;
+	std::vector<T> mv_z;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
@@ -10,7 +10,15 @@
 #include "GetGlut.h"
 #include "Sleep.h"
 #include "ObjLibrary/ObjModel.h"
-#include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/Matrix44.h"
+#include "ObjLibrary/Script.h"
+#include "ObjLibrary/ScriptScheduler.h"
+#include "ObjLibrary/SceneGraph.h"
+#include "ObjLibrary/EntityRegistry.h"
+#include "ObjLibrary/SystemScheduler.h"
+#include "ObjLibrary/EntitySystems.h"
+#include "ObjLibrary/AssetLoader.h"
+#include "ObjLibrary/AssetWatcher.h"
 
 using namespace std;
 using namespace ObjLibrary;
@@ -25,8 +33,13 @@ void display ();
 // add your global variables here
 ObjModel spiky;
 ObjModel bucket;
-DisplayList bucket_list;
 ObjModel skybox;
+ScriptScheduler scripts;
+SceneGraph scene;
+EntityRegistry entities;
+SystemScheduler systems;
+AssetWatcher watcher;
+double cube_angle = 0.25 * 3.14159265358979;
 
 
 
@@ -53,10 +66,59 @@ int main (int argc, char* argv[])
 void init ()
 {
 	initDisplay();
-	spiky.load("Spiky.obj");
-	bucket.load("firebucket.obj");
-	skybox.load("Skybox.obj");
-	bucket_list = bucket.getDisplayList();
+
+	// load the models and their textures in parallel
+	AssetLoader loader;
+	unsigned int spiky_model  = loader.addModel("Spiky.obj");
+	unsigned int bucket_model = loader.addModel("firebucket.obj");
+	unsigned int skybox_model = loader.addModel("Skybox.obj");
+	loader.finish();
+	for(unsigned int i = 0; i < loader.getModelCount(); i++)
+		cerr << loader.getLog(i);
+	spiky  = loader.getModel(spiky_model);
+	bucket = loader.getModel(bucket_model);
+	skybox = loader.getModel(skybox_model);
+
+	// reload the models when they are edited
+	watcher.watchModel(spiky, "Spiky.obj");
+	watcher.watchModel(bucket, "firebucket.obj");
+	watcher.watchModel(skybox, "Skybox.obj");
+
+	// rock the cube back and forth
+	Script rock;
+	rock.tween(&cube_angle, 0.75 * 3.14159265358979, 1.5, Script::EASE_IN_OUT)
+	    .wait(0.5)
+	    .tween(&cube_angle, 0.25 * 3.14159265358979, 1.5, Script::EASE_IN_OUT)
+	    .wait(0.5)
+	    .repeat();
+	scripts.start(rock);
+
+	// a row of spikys and a row of buckets
+	unsigned int spiky_row  = scene.addNode(SceneGraph::NO_NODE,
+	                                        Matrix44::getTranslation(Vector3( 1.0, 0.0, 0.0)));
+	unsigned int bucket_row = scene.addNode(SceneGraph::NO_NODE,
+	                                        Matrix44::getTranslation(Vector3(-1.0, 0.0, 0.0)));
+	Matrix44 spiky_scale  = Matrix44::getScale(0.45);
+	Matrix44 bucket_scale = Matrix44::getScale(0.005);
+	for (int i = 0; i < 50; i++) {
+		scene.addNode(spiky_row,
+		              Matrix44::getTranslation(Vector3( i, 0, 0)) * spiky_scale,
+		              &spiky);
+		scene.addNode(bucket_row,
+		              Matrix44::getTranslation(Vector3(-i, 0, 0)) * bucket_scale,
+		              &bucket);
+	}
+
+	// a fountain of particles above the cube
+	unsigned int fountain = entities.createEntity();
+	entities.add(fountain, TransformComponent(Vector3(0.0, 0.5, 0.0)));
+	ParticleEmitterComponent emitter;
+	emitter.m_rate    = 200.0;
+	emitter.m_speed   = 1.5;
+	emitter.m_spread  = 0.25;
+	emitter.m_gravity = Vector3(0.0, -2.0, 0.0);
+	entities.add(fountain, emitter);
+	EntitySystems::addUpdateSystems(systems);
 }
 
 void initDisplay ()
@@ -83,7 +145,10 @@ void keyboard (unsigned char key, int x, int y)
 void update ()
 {
 	// update your variables here
-	
+	scripts.update(1.0 / 60.0);
+	systems.run(entities, 1.0 / 60.0);
+	watcher.update(1.0 / 60.0);
+
 	sleep(1.0 / 60.0);
 	glutPostRedisplay();
 }
@@ -104,13 +169,14 @@ void display ()
 {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	glLoadIdentity();
-	gluLookAt(2.0, 1.0, 4.0,
-	          0.0, 0.0, 0.0,
-	          0.0, 1.0, 0.0);
+	Vector3 camera_position(2.0, 1.0, 4.0);
+	Matrix44 view = Matrix44::getLookAt(camera_position,
+	                                    Vector3::ZERO,
+	                                    Vector3::UNIT_Y_PLUS);
+	view.loadToOpenGL();
 	glPushMatrix();
-		glTranslated(2.0, 1.0, 4.0);
-		glScaled(600.0, 600.0, 600.0);
+		(Matrix44::getTranslation(camera_position) *
+		 Matrix44::getScale(600.0)).applyToOpenGL();
 		glDepthMask(GL_FALSE);
 		skybox.draw();
 		glDepthMask(GL_TRUE);
@@ -132,29 +198,23 @@ void display ()
 	// draw a purple wireframe cube
 	glColor3d(1.0, 0.0, 1.0);
 	glPushMatrix();
-		glTranslated(0.0, 0.0, 0.0);
-		glRotated(45, 0.0, 1.0, 0.0);
-		glScaled(1.0, 1.0, 1.0);
+		Matrix44::getRotationArbitrary(Vector3::UNIT_Y_PLUS, cube_angle).applyToOpenGL();
 		glutWireCube(1.0);
 	glPopMatrix();
 
+	// draw the particles
+	glColor3d(1.0, 1.0, 0.0);
+	EntitySystems::drawParticles(entities, view);
+
 	// Draw the loaded model
 	// glColor3d(1.0, 0.0, 0.0);
 	// spiky.draw();
 
-	// Loop and create multiple spikys
-	for (int i = 0; i < 50; i++) {
-		glPushMatrix();
-			glTranslatef(1.0 + i, 0, 0);
-			glScaled(0.45, 0.45, 0.45);
-			spiky.draw();
-		glPopMatrix();
-		glPushMatrix();
-			glTranslatef(-1.0 + -i, 0, 0);
-			glScaled(0.005, 0.005, 0.005);
-			bucket.draw();
-		glPopMatrix();
-	}
+	// Draw the rows of spikys and buckets
+	//  The world transforms are only recalculated when a node
+	//    changes, so this is usually just the draw calls.
+	scene.update();
+	scene.draw(view);
 
 	glutSwapBuffers();
 }
@@ -0,0 +1,46 @@
+//
+//  mainPackTool.cpp
+//
+//  Builds an AssetArchive from all the files in a folder.  The
+//    archive can then be mounted with AssetFileSystem::mount
+//    so the ObjLibrary loaders read from it instead of disk.
+//
+//  Usage: PackTool <folder> <archive>
+//    folder:  The folder to archive, including all the folders
+//             in it.  File paths in the archive are relative to
+//             this folder.
+//    archive: The name of the archive file to create
+//
+
+#include <string>
+#include <iostream>
+
+#include "../Lab4/ObjLibrary/AssetArchive.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+int main (int argc, char* argv[])
+{
+	if(argc != 3 || string(argv[2]) == "")
+	{
+		cerr << "Usage: " << argv[0] << " <folder> <archive>" << endl;
+		return 1;
+	}
+
+	string folder = argv[1];
+	string archive_filename = argv[2];
+
+	cout << "Archiving \"" << folder << "\" to \"" << archive_filename << "\"" << endl;
+	unsigned int file_count = AssetArchive::build(folder, archive_filename, cout);
+	if(file_count == 0)
+	{
+		cerr << "Error: No files archived" << endl;
+		return 1;
+	}
+
+	cout << file_count << " files archived" << endl;
+	return 0;
+}